@@ -0,0 +1,664 @@
+/*
+ * Depth stage accuracy/throughput bench (host build).
+ *
+ * 解析的な面(sphere / plane / saddle / step)の p,q を描画し，Thread3 の深度ソルバを
+ * ファームと同じコードのまま PC 上で回して，正解との誤差と1フレームの時間を CSV で出す．
+ *
+ *   fc128 : PQ128 の int16 p/q 平面 → fc128_solve_z_from_pq()(FC_FFT_N / FC128_FIXED_POINT はビルド時)
+ *   mg    : 8bit p/q 勾配マップ → reconstruct_depth_multigrid()
+ *   row   : 8bit p/q 勾配マップ → reconstruct_depth_simple_direct()(行ごとの積分)
+ *   fc128_vs_f32 : FC128_FIXED_POINT=1 のビルドだけ．固定小数点の Z を同じ入力の float FC の Z と比べる
+ *   synth : synth_frame の Lambert 球(CAM_SYNTH_ENABLE と同じ UYVY)をフレームとして HyperRAM へ置き，
+ *           pq128_compute_and_store() → fc128_solve_z_from_pq() を通した Z を
+ *           synth_frame_depth_truth() と比べる(画像から深度までの経路全体．surface 列は synth_sphere)
+ *
+ * 静的関数を呼ぶため main_thread3_entry.c をこのファイルに取り込む(ビルドは script/depth_bench.sh)．
+ *
+ * 誤差の定義:
+ *   ソルバの出力は定数(と p/q の量子化スケール)の分だけ不定なので，正解へ最小二乗で
+ *   gain/offset を合わせてから比較する．値は正解の peak-to-peak で割った相対値．
+ *   rmse_border は外周 --border 画素の帯，rmse_interior はその内側．
+ */
+#include "main_thread3_entry.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench_host.h"
+#include "synth_frame.h"
+
+/*
+ * 面ごとに最大勾配をこの振幅へ合わせて量子化する(--pq16-peak / --pq8-peak で変更)．
+ * int16: 16 付近．PQ128_NORM_SCALE(256)まで上げると Z_hat の低域が FFT の sanitize
+ *        (|v| >= 2^21 を 0 にする)に掛かり，FC の結果が崩れる(--log で [SAN] が出る)．
+ * 8bit : Sobel/8 の勾配マップ相当．行積分は ±200 で飽和するので小さめ．
+ */
+static float s_pq16_peak = 16.0f;
+static float s_pq8_peak = 16.0f;
+
+typedef enum
+{
+    SURF_SPHERE = 0,
+    SURF_PLANE,
+    SURF_SADDLE,
+    SURF_STEP,
+    SURF_COUNT
+} surface_t;
+
+static const char *const s_surface_names[SURF_COUNT] = {"sphere", "plane", "saddle", "step"};
+
+typedef struct
+{
+    int w;
+    int h;
+    float *z;  // 正解(w*h)
+    float *p;  // dz/dx [1/px]
+    float *q;  // dz/dy [1/px]
+} surface_grid_t;
+
+typedef struct
+{
+    double rmse;
+    double rmse_border;
+    double rmse_interior;
+    double max_abs;
+    double gain;
+} depth_error_t;
+
+/* 正規化座標 (u,v)(短辺が [-1,1])での高さと勾配 */
+static void surface_eval(surface_t s, float u, float v, float *z, float *zu, float *zv)
+{
+    switch (s)
+    {
+    case SURF_SPHERE:
+    {
+        /* 半径 1 の球を r=0.8 で切った球冠．縁で z=0 に繋がり，勾配は有限(最大 4/3) */
+        const float r2 = u * u + v * v;
+        if (r2 >= 0.64f)
+        {
+            *z = 0.0f;
+            *zu = 0.0f;
+            *zv = 0.0f;
+            return;
+        }
+        const float h = sqrtf(1.0f - r2);
+        *z = h - 0.6f;
+        *zu = -u / h;
+        *zv = -v / h;
+        return;
+    }
+    case SURF_PLANE:
+        *z = 0.4f * u + 0.25f * v;
+        *zu = 0.4f;
+        *zv = 0.25f;
+        return;
+    case SURF_SADDLE:
+        *z = 0.5f * (u * u - v * v);
+        *zu = u;
+        *zv = -v;
+        return;
+    case SURF_STEP:
+    default:
+        /* 勾配は段の1画素にだけ立つ(下で前進差分から作る) */
+        *z = (u >= 0.0f) ? 0.5f : 0.0f;
+        *zu = 0.0f;
+        *zv = 0.0f;
+        return;
+    }
+}
+
+static bool surface_grid_make(surface_grid_t *g, surface_t s, int w, int h)
+{
+    const size_t n = (size_t)w * (size_t)h;
+    g->w = w;
+    g->h = h;
+    g->z = malloc(n * sizeof(float));
+    g->p = malloc(n * sizeof(float));
+    g->q = malloc(n * sizeof(float));
+    if (!g->z || !g->p || !g->q)
+    {
+        return false;
+    }
+
+    const float px = 2.0f / (float)((w < h) ? w : h); // 1画素の正規化長
+    for (int y = 0; y < h; y++)
+    {
+        const float v = ((float)y + 0.5f - 0.5f * (float)h) * px;
+        for (int x = 0; x < w; x++)
+        {
+            const float u = ((float)x + 0.5f - 0.5f * (float)w) * px;
+            float z, zu, zv;
+            surface_eval(s, u, v, &z, &zu, &zv);
+            g->z[y * w + x] = z;
+            g->p[y * w + x] = zu * px;
+            g->q[y * w + x] = zv * px;
+        }
+    }
+
+    if (s == SURF_STEP)
+    {
+        for (int y = 0; y < h; y++)
+        {
+            for (int x = 0; x < w; x++)
+            {
+                const float *zr = &g->z[y * w];
+                g->p[y * w + x] = (x + 1 < w) ? (zr[x + 1] - zr[x]) : 0.0f;
+                g->q[y * w + x] = 0.0f;
+            }
+        }
+    }
+    return true;
+}
+
+static void surface_grid_free(surface_grid_t *g)
+{
+    free(g->z);
+    free(g->p);
+    free(g->q);
+}
+
+static float surface_grid_peak_grad(const surface_grid_t *g)
+{
+    float m = 0.0f;
+    for (int i = 0; i < g->w * g->h; i++)
+    {
+        m = fmaxf(m, fmaxf(fabsf(g->p[i]), fabsf(g->q[i])));
+    }
+    return (m > 0.0f) ? m : 1.0f;
+}
+
+/* est を gain/offset で truth に合わせたあとの誤差(truth の peak-to-peak で正規化) */
+static depth_error_t depth_error(const float *truth, const float *est, int w, int h, int border)
+{
+    const int n = w * h;
+    double st = 0.0, se = 0.0, see = 0.0, set = 0.0;
+    float tmin = truth[0], tmax = truth[0];
+    for (int i = 0; i < n; i++)
+    {
+        st += truth[i];
+        se += est[i];
+        see += (double)est[i] * est[i];
+        set += (double)est[i] * truth[i];
+        tmin = fminf(tmin, truth[i]);
+        tmax = fmaxf(tmax, truth[i]);
+    }
+    const double mt = st / n;
+    const double me = se / n;
+    const double var_e = see / n - me * me;
+    const double gain = (var_e > 1.0e-20) ? ((set / n - me * mt) / var_e) : 0.0;
+    const double range = ((tmax - tmin) > 1.0e-12f) ? (double)(tmax - tmin) : 1.0;
+
+    double s_all = 0.0, s_border = 0.0, s_inner = 0.0, max_abs = 0.0;
+    int n_border = 0, n_inner = 0;
+    for (int y = 0; y < h; y++)
+    {
+        for (int x = 0; x < w; x++)
+        {
+            const int i = y * w + x;
+            const double d = (mt + gain * (est[i] - me)) - truth[i];
+            const double d2 = d * d;
+            s_all += d2;
+            if ((x < border) || (y < border) || (x >= w - border) || (y >= h - border))
+            {
+                s_border += d2;
+                n_border++;
+            }
+            else
+            {
+                s_inner += d2;
+                n_inner++;
+            }
+            max_abs = fmax(max_abs, fabs(d));
+        }
+    }
+
+    depth_error_t e;
+    e.rmse = sqrt(s_all / n) / range;
+    e.rmse_border = (n_border > 0) ? (sqrt(s_border / n_border) / range) : 0.0;
+    e.rmse_interior = (n_inner > 0) ? (sqrt(s_inner / n_inner) / range) : 0.0;
+    e.max_abs = max_abs / range;
+    e.gain = gain;
+    return e;
+}
+
+static void print_row(const char *solver, int fft_n, const char *surface, int w, int h, const depth_error_t *e,
+                      double us_per_frame, int iters)
+{
+    printf("%s,%d,%s,%d,%d,%.6f,%.6f,%.6f,%.6f,%.6g,%.1f,%d\n",
+           solver, fft_n, surface, w, h,
+           e->rmse, e->rmse_border, e->rmse_interior, e->max_abs, e->gain,
+           us_per_frame, iters);
+    fflush(stdout);
+}
+
+/* ---- fc128 ---- */
+
+/* p/q を int16 に量子化して PQ128 の p/q 平面へ書く */
+static void bench_write_pq16(const surface_grid_t *g, uint32_t base)
+{
+    const int n = g->w;
+    const float k = s_pq16_peak / surface_grid_peak_grad(g);
+    int16_t row_p[FC_RESULT_N];
+    int16_t row_q[FC_RESULT_N];
+    for (int y = 0; y < n; y++)
+    {
+        for (int x = 0; x < n; x++)
+        {
+            row_p[x] = (int16_t)lrintf(g->p[y * n + x] * k);
+            row_q[x] = (int16_t)lrintf(g->q[y * n + x] * k);
+        }
+        const uint32_t off = (uint32_t)y * (uint32_t)n * (uint32_t)sizeof(int16_t);
+        (void)hyperram_b_write(row_p, (void *)(uintptr_t)(base + PQ128_P_OFFSET + off), (uint32_t)sizeof(row_p));
+        (void)hyperram_b_write(row_q, (void *)(uintptr_t)(base + PQ128_Q_OFFSET + off), (uint32_t)sizeof(row_q));
+    }
+}
+
+/* FC128_Z_REAL の FC_RESULT_N クロップを読む */
+static void bench_read_fc_z(uint32_t base, float *z)
+{
+    const int n = FC_RESULT_N;
+    for (int y = 0; y < n; y++)
+    {
+        const uint32_t off = (uint32_t)((FC_PAD_Y0 + y) * FC_FFT_N + FC_PAD_X0) * (uint32_t)sizeof(float);
+        (void)hyperram_b_read(&z[y * n], (void *)(uintptr_t)(base + FC128_Z_REAL + off), (uint32_t)n * (uint32_t)sizeof(float));
+    }
+}
+
+static void bench_fc128(surface_t s, int iters, int border)
+{
+    const uint32_t base = video_frame_align_u32((uint32_t)VIDEO_FRAME_BASE_OFFSET_DEFAULT);
+    const int n = FC_RESULT_N;
+    surface_grid_t g;
+    if (!surface_grid_make(&g, s, n, n))
+    {
+        surface_grid_free(&g);
+        return;
+    }
+    bench_write_pq16(&g, base);
+
+    fc128_solve_stamps_t st;
+    if (!fc128_solve_z_from_pq(base, &st)) // plan 作成を計測から外す
+    {
+        fprintf(stderr, "fc128: no FFT plan for N=%d\n", (int)FC_FFT_N);
+        surface_grid_free(&g);
+        return;
+    }
+    const uint64_t t0 = bench_now_ns();
+    for (int i = 0; i < iters; i++)
+    {
+        fc128_solve_z_from_pq(base, &st);
+    }
+    const double us = (double)(bench_now_ns() - t0) / 1000.0 / (double)iters;
+
+    float *z = malloc((size_t)n * (size_t)n * sizeof(float));
+    bench_read_fc_z(base, z);
+
+    const depth_error_t e = depth_error(g.z, z, n, n, border);
+    print_row(FC128_FIXED_POINT ? "fc128_fx" : "fc128", FC_FFT_N, s_surface_names[s], n, n, &e, us, iters);
+    free(z);
+    surface_grid_free(&g);
+}
+
+#if FC128_FIXED_POINT
+/*
+ * 固定小数点 FC を同じ p/q の float FC と比べる(fc128_vs_f32 行)．
+ * FC128_FIXED_VERIFY_PERIOD の実機ログと同じく gain/offset は合わせない生の差で，
+ * rmse / max_abs は float 側の peak-to-peak に対する比．gain 列は rms(差) / rms(float)．
+ * 時間は固定小数点側の1回分．
+ */
+static void bench_fc128_vs_float(surface_t s, int iters, int border)
+{
+    const uint32_t base = video_frame_align_u32((uint32_t)VIDEO_FRAME_BASE_OFFSET_DEFAULT);
+    const int n = FC_RESULT_N;
+    surface_grid_t g;
+    if (!surface_grid_make(&g, s, n, n))
+    {
+        surface_grid_free(&g);
+        return;
+    }
+    bench_write_pq16(&g, base);
+
+    fc128_solve_stamps_t st;
+    if (!fc128_solve_z_from_pq_float(base, &st))
+    {
+        fprintf(stderr, "fc128: no FFT plan for N=%d\n", (int)FC_FFT_N);
+        surface_grid_free(&g);
+        return;
+    }
+    float *zf = malloc((size_t)n * (size_t)n * sizeof(float));
+    float *zx = malloc((size_t)n * (size_t)n * sizeof(float));
+    bench_read_fc_z(base, zf);
+
+    const uint64_t t0 = bench_now_ns();
+    for (int i = 0; i < iters; i++)
+    {
+        fc128_solve_z_from_pq_fixed(base, (uint32_t)FC128_Z_REAL, &st);
+    }
+    const double us = (double)(bench_now_ns() - t0) / 1000.0 / (double)iters;
+    bench_read_fc_z(base, zx);
+
+    float zmin = zf[0], zmax = zf[0];
+    double sref = 0.0, s_all = 0.0, s_border = 0.0, s_inner = 0.0, max_abs = 0.0;
+    int n_border = 0, n_inner = 0;
+    for (int y = 0; y < n; y++)
+    {
+        for (int x = 0; x < n; x++)
+        {
+            const int i = y * n + x;
+            const double d = (double)zx[i] - (double)zf[i];
+            zmin = fminf(zmin, zf[i]);
+            zmax = fmaxf(zmax, zf[i]);
+            sref += (double)zf[i] * zf[i];
+            s_all += d * d;
+            if ((x < border) || (y < border) || (x >= n - border) || (y >= n - border))
+            {
+                s_border += d * d;
+                n_border++;
+            }
+            else
+            {
+                s_inner += d * d;
+                n_inner++;
+            }
+            max_abs = fmax(max_abs, fabs(d));
+        }
+    }
+    const double range = ((zmax - zmin) > 1.0e-12f) ? (double)(zmax - zmin) : 1.0;
+    const double cnt = (double)n * (double)n;
+
+    depth_error_t e;
+    e.rmse = sqrt(s_all / cnt) / range;
+    e.rmse_border = (n_border > 0) ? (sqrt(s_border / n_border) / range) : 0.0;
+    e.rmse_interior = (n_inner > 0) ? (sqrt(s_inner / n_inner) / range) : 0.0;
+    e.max_abs = max_abs / range;
+    e.gain = (sref > 0.0) ? sqrt(s_all / sref) : 0.0;
+    print_row("fc128_vs_f32", FC_FFT_N, s_surface_names[s], n, n, &e, us, iters);
+    free(zx);
+    free(zf);
+    surface_grid_free(&g);
+}
+#endif
+
+/* ---- synth_frame の球(画像 → PQ128 → FC) ---- */
+
+/*
+ * Thread0 の合成フレームと同じく synth_frame_render() の UYVY をフレーム位置へ書き，
+ * Thread3 と同じ順に p/q と Z を作る．正解は synth_frame_depth_truth() を PQ128 の格子
+ * (PQ128_X0/Y0 から PQ128_SAMPLE_STRIDE_X/Y 間隔，枠外は 0)で拾う．
+ * 時間は p/q + FC の1フレーム分．
+ */
+static void bench_synth(int iters, int border)
+{
+    const uint32_t base = video_frame_align_u32((uint32_t)VIDEO_FRAME_BASE_OFFSET_DEFAULT);
+    const uint32_t w = (uint32_t)FRAME_WIDTH;
+    const uint32_t h = (uint32_t)FRAME_HEIGHT;
+    const int n = FC_RESULT_N;
+
+    synth_frame_set_pattern(SYNTH_PATTERN_SPHERE);
+    uint8_t *uyvy = malloc((size_t)w * (size_t)h * 2U);
+    uint8_t *truth_u8 = malloc((size_t)w * (size_t)h);
+    float *truth = malloc((size_t)n * (size_t)n * sizeof(float));
+    float *z = malloc((size_t)n * (size_t)n * sizeof(float));
+    if (!uyvy || !truth_u8 || !truth || !z)
+    {
+        free(uyvy);
+        free(truth_u8);
+        free(truth);
+        free(z);
+        return;
+    }
+    synth_frame_render(uyvy, w, h, 0U);
+    (void)hyperram_b_write(uyvy, (void *)(uintptr_t)base, w * h * 2U);
+    (void)synth_frame_depth_truth(truth_u8, w, h, 0U);
+
+    for (int y = 0; y < n; y++)
+    {
+        const int sy = PQ128_Y0 + y * PQ128_SAMPLE_STRIDE_Y;
+        for (int x = 0; x < n; x++)
+        {
+            const int sx = PQ128_X0 + x * PQ128_SAMPLE_STRIDE_X;
+            const bool in = (sx >= 0) && (sy >= 0) && (sx < (int)w) && (sy < (int)h);
+            truth[y * n + x] = in ? (float)truth_u8[(uint32_t)sy * w + (uint32_t)sx] : 0.0f;
+        }
+    }
+
+    fc128_solve_stamps_t st;
+    pq128_compute_and_store(base, 1U);
+    if (!fc128_solve_z_from_pq(base, &st))
+    {
+        fprintf(stderr, "fc128: no FFT plan for N=%d\n", (int)FC_FFT_N);
+    }
+    else
+    {
+        const uint64_t t0 = bench_now_ns();
+        for (int i = 0; i < iters; i++)
+        {
+            pq128_compute_and_store(base, (uint32_t)i + 2U);
+            fc128_solve_z_from_pq(base, &st);
+        }
+        const double us = (double)(bench_now_ns() - t0) / 1000.0 / (double)iters;
+        bench_read_fc_z(base, z);
+
+        const depth_error_t e = depth_error(truth, z, n, n, border);
+        print_row(FC128_FIXED_POINT ? "fc128_fx" : "fc128", FC_FFT_N, "synth_sphere", n, n, &e, us, iters);
+    }
+    free(uyvy);
+    free(truth_u8);
+    free(truth);
+    free(z);
+}
+
+/* ---- 8bit 勾配マップ(mg / row) ---- */
+
+static void bench_write_gradient_u8(const surface_grid_t *g)
+{
+    const float k = s_pq8_peak / surface_grid_peak_grad(g);
+    uint8_t row[FRAME_WIDTH_MAX * 2];
+    for (int y = 0; y < g->h; y++)
+    {
+        for (int x = 0; x < g->w; x++)
+        {
+            /* byte0 = q, byte1 = p(どちらも +127 オフセット) */
+            const long p = lrintf(g->p[y * g->w + x] * k) + 127;
+            const long q = lrintf(g->q[y * g->w + x] * k) + 127;
+            row[x * 2 + 0] = (uint8_t)((q < 0) ? 0 : ((q > 255) ? 255 : q));
+            row[x * 2 + 1] = (uint8_t)((p < 0) ? 0 : ((p > 255) ? 255 : p));
+        }
+        (void)hyperram_b_write(row, (void *)(uintptr_t)(GRADIENT_OFFSET + (uint32_t)y * (uint32_t)g->w * 2U), (uint32_t)g->w * 2U);
+    }
+}
+
+static void bench_mg(surface_t s, int iters, int border)
+{
+    const int w = FRAME_WIDTH;
+    const int h = FRAME_HEIGHT;
+    surface_grid_t g;
+    if (!surface_grid_make(&g, s, w, h))
+    {
+        surface_grid_free(&g);
+        return;
+    }
+    bench_write_gradient_u8(&g);
+
+    const uint64_t t0 = bench_now_ns();
+    for (int i = 0; i < iters; i++)
+    {
+        reconstruct_depth_multigrid();
+    }
+    const double us = (double)(bench_now_ns() - t0) / 1000.0 / (double)iters;
+
+    float *z = malloc((size_t)w * (size_t)h * sizeof(float));
+    (void)hyperram_b_read(z, (void *)(uintptr_t)g_mg_levels[0].z_offset, (uint32_t)(w * h) * (uint32_t)sizeof(float));
+
+    const depth_error_t e = depth_error(g.z, z, w, h, border);
+    print_row("mg", 0, s_surface_names[s], w, h, &e, us, iters);
+    free(z);
+    surface_grid_free(&g);
+}
+
+static void bench_row(surface_t s, int iters, int border)
+{
+    const int w = FRAME_WIDTH;
+    const int h = FRAME_HEIGHT;
+    surface_grid_t g;
+    if (!surface_grid_make(&g, s, w, h))
+    {
+        surface_grid_free(&g);
+        return;
+    }
+    bench_write_gradient_u8(&g);
+
+    uint8_t *d = malloc((size_t)w * (size_t)h);
+    const uint64_t t0 = bench_now_ns();
+    for (int i = 0; i < iters; i++)
+    {
+        for (int y = 0; y < h; y++)
+        {
+            reconstruct_depth_simple_direct(GRADIENT_OFFSET + (uint32_t)y * (uint32_t)w * 2U, &d[y * w]);
+        }
+    }
+    const double us = (double)(bench_now_ns() - t0) / 1000.0 / (double)iters;
+
+    float *z = malloc((size_t)w * (size_t)h * sizeof(float));
+    for (int i = 0; i < w * h; i++)
+    {
+        z[i] = (float)d[i];
+    }
+
+    const depth_error_t e = depth_error(g.z, z, w, h, border);
+    print_row("row", 0, s_surface_names[s], w, h, &e, us, iters);
+    free(z);
+    free(d);
+    surface_grid_free(&g);
+}
+
+/* ---- main ---- */
+
+static void usage(const char *argv0)
+{
+    fprintf(stderr,
+            "Usage: %s [--solver fc128|fc128_vs_f32|synth|mg|row|all] [--surface sphere|plane|saddle|step|all]\n"
+            "          [--iters N] [--border PX] [--pq16-peak V] [--pq8-peak V] [--no-header] [--log]\n",
+            argv0);
+}
+
+int main(int argc, char **argv)
+{
+    const char *solver = "all";
+    const char *surface = "all";
+    int iters = 20;
+    int border = 8;
+    bool header = true;
+    bool log = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "--solver") == 0) && (i + 1 < argc))
+        {
+            solver = argv[++i];
+        }
+        else if ((strcmp(argv[i], "--surface") == 0) && (i + 1 < argc))
+        {
+            surface = argv[++i];
+        }
+        else if ((strcmp(argv[i], "--iters") == 0) && (i + 1 < argc))
+        {
+            iters = atoi(argv[++i]);
+        }
+        else if ((strcmp(argv[i], "--pq16-peak") == 0) && (i + 1 < argc))
+        {
+            s_pq16_peak = (float)atof(argv[++i]);
+        }
+        else if ((strcmp(argv[i], "--pq8-peak") == 0) && (i + 1 < argc))
+        {
+            s_pq8_peak = (float)atof(argv[++i]);
+        }
+        else if ((strcmp(argv[i], "--border") == 0) && (i + 1 < argc))
+        {
+            border = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--no-header") == 0)
+        {
+            header = false;
+        }
+        else if (strcmp(argv[i], "--log") == 0)
+        {
+            log = true;
+        }
+        else
+        {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (iters < 1)
+    {
+        iters = 1;
+    }
+
+    const bool all_solvers = (strcmp(solver, "all") == 0);
+    const bool run_fc = all_solvers || (strcmp(solver, "fc128") == 0);
+    const bool run_mg = all_solvers || (strcmp(solver, "mg") == 0);
+    const bool run_row = all_solvers || (strcmp(solver, "row") == 0);
+    const bool run_vs_float = (strcmp(solver, "fc128_vs_f32") == 0);
+    const bool run_synth = (strcmp(solver, "synth") == 0);
+    if (run_vs_float && !FC128_FIXED_POINT)
+    {
+        fprintf(stderr, "--solver fc128_vs_f32 needs a FC128_FIXED_POINT=1 build\n");
+        return 2;
+    }
+    if (!run_fc && !run_mg && !run_row && !run_vs_float && !run_synth)
+    {
+        usage(argv[0]);
+        return 2;
+    }
+
+    bench_host_init(log);
+    s_frame = video_frame_desc_make(320U, 240U, (uint32_t)CAM_MODE_QVGA);
+
+    if (header)
+    {
+        printf("solver,fft_n,surface,w,h,rmse,rmse_border,rmse_interior,max_abs,gain,us_per_frame,iters\n");
+    }
+
+    if (run_synth)
+    {
+        /* 面の指定によらず1行(synth_frame の球) */
+        bench_synth(iters, border);
+        return 0;
+    }
+
+    int matched = 0;
+    for (int s = 0; s < (int)SURF_COUNT; s++)
+    {
+        if ((strcmp(surface, "all") != 0) && (strcmp(surface, s_surface_names[s]) != 0))
+        {
+            continue;
+        }
+        matched++;
+        if (run_fc)
+        {
+            bench_fc128((surface_t)s, iters, border);
+        }
+#if FC128_FIXED_POINT
+        if (run_vs_float)
+        {
+            bench_fc128_vs_float((surface_t)s, iters, border);
+        }
+#endif
+        if (run_mg)
+        {
+            bench_mg((surface_t)s, iters, border);
+        }
+        if (run_row)
+        {
+            bench_row((surface_t)s, iters, border);
+        }
+    }
+    if (matched == 0)
+    {
+        usage(argv[0]);
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,407 @@
+/*
+ * HLAC/LDA golden-vector check against the MATLAB reference (host build).
+ *
+ * matlab/export_hlac_golden.m が書いた golden.csv と画像(PGM)を読み，ファームと同じ C 実装
+ *   hlac25_compute_from_u8_hyperram()      (kind=full)
+ *   hlac25_compute_from_u8_hyperram_roi()  (kind=roi)
+ *   hlac_lda_predict_ex()                  (label >= 0 の行)
+ * の結果を許容誤差つきで比べる．あわせて1画像/1ROI/1推論あたりの時間を出す．
+ *
+ * MVE 経路は -D__ARM_FEATURE_MVE=1 と bench/host/arm_mve.h(組み込み関数のエミュレーション)で
+ * ビルドした別バイナリで同じ golden を通す(script/hlac_golden.sh が両方作る)．
+ *
+ * golden.csv(1行目はヘッダ):
+ *   file,kind,x0,y0,w,h,label,score,prob,f01,...,f25
+ *   - file : csv からの相対パス(P5 PGM，8bit)
+ *   - kind : full | roi(x0,y0 は 0 始まり．full は 0,0,幅,高さ)
+ *   - label: MATLAB の LDA 予測(0 始まり)．モデル無しでエクスポートしたときは -1
+ *   - score/prob: 最大スコアとその softmax 確率
+ *
+ * LDA は MATLAB の特徴量を入力にしても評価する(lda_on_golden)．HLAC の誤差と LDA の誤差を分けるため．
+ * ファーム側のモデルは src/hlac_lda_model.c に焼き込まれたものなので，golden は同じ学習結果から作ること．
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "bench_host.h"
+#include "hlac_lda_infer.h"
+
+#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE > 0)
+#define HLAC_GOLDEN_PATH "mve-emu"
+#else
+#define HLAC_GOLDEN_PATH "scalar"
+#endif
+
+/* 画像を置く HyperRAM オフセット(フレームスロットと重ならない所) */
+#define HLAC_GOLDEN_IMG_ADDR (0x00100000U)
+#define HLAC_GOLDEN_IMG_MAX (HLAC_MAX_IMAGE_W * 1024U)
+
+/* 相対誤差の分母の下限(0 近傍の特徴量で相対誤差が発散しないように) */
+#define HLAC_GOLDEN_FEAT_FLOOR (1.0e-6)
+
+typedef struct
+{
+    char file[256];
+    char kind[8];
+    uint32_t x0, y0, w, h;
+    int label;
+    double score;
+    double prob;
+    double f[25];
+} golden_row_t;
+
+typedef struct
+{
+    char path[512];
+    uint32_t w;
+    uint32_t h;
+} loaded_image_t;
+
+static double s_tol = 1.0e-4;       // 特徴量の相対誤差
+static double s_score_tol = 1.0e-3; // スコア/確率の誤差(max(1,|golden|) に対する比)
+static int s_iters = 20;
+static bool s_verbose = false;
+
+static void path_join(char *out, size_t out_len, const char *csv_path, const char *file)
+{
+    const char *slash = strrchr(csv_path, '/');
+    if ((file[0] == '/') || !slash)
+    {
+        snprintf(out, out_len, "%s", file);
+        return;
+    }
+    snprintf(out, out_len, "%.*s/%s", (int)(slash - csv_path), csv_path, file);
+}
+
+static int pgm_skip_ws(FILE *f)
+{
+    int c = fgetc(f);
+    while ((c == ' ') || (c == '\t') || (c == '\r') || (c == '\n') || (c == '#'))
+    {
+        if (c == '#')
+        {
+            while ((c != '\n') && (c != EOF))
+            {
+                c = fgetc(f);
+            }
+        }
+        c = fgetc(f);
+    }
+    return c;
+}
+
+static bool pgm_read_uint(FILE *f, uint32_t *out)
+{
+    int c = pgm_skip_ws(f);
+    if ((c < '0') || (c > '9'))
+    {
+        return false;
+    }
+    uint32_t v = 0U;
+    while ((c >= '0') && (c <= '9'))
+    {
+        v = v * 10U + (uint32_t)(c - '0');
+        c = fgetc(f);
+    }
+    *out = v; // 区切りの空白1文字は読み捨てた
+    return true;
+}
+
+/* P5(8bit)を HyperRAM の HLAC_GOLDEN_IMG_ADDR へ行優先で置く */
+static bool load_pgm_to_hyperram(const char *path, loaded_image_t *img)
+{
+    if (strcmp(img->path, path) == 0)
+    {
+        return true;
+    }
+
+    FILE *f = fopen(path, "rb");
+    if (!f)
+    {
+        fprintf(stderr, "cannot open %s\n", path);
+        return false;
+    }
+
+    uint32_t w = 0U, h = 0U, maxval = 0U;
+    bool ok = (fgetc(f) == 'P') && (fgetc(f) == '5') &&
+              pgm_read_uint(f, &w) && pgm_read_uint(f, &h) && pgm_read_uint(f, &maxval);
+    if (!ok || (maxval != 255U) || (w == 0U) || (h == 0U) || (w > HLAC_MAX_IMAGE_W) || ((w * h) > HLAC_GOLDEN_IMG_MAX))
+    {
+        fprintf(stderr, "%s: need an 8-bit P5 PGM up to %u px wide\n", path, (unsigned)HLAC_MAX_IMAGE_W);
+        fclose(f);
+        return false;
+    }
+
+    uint8_t *dst = bench_hyperram() + HLAC_GOLDEN_IMG_ADDR;
+    ok = (fread(dst, 1U, (size_t)w * h, f) == ((size_t)w * h));
+    fclose(f);
+    if (!ok)
+    {
+        fprintf(stderr, "%s: short read\n", path);
+        return false;
+    }
+
+    snprintf(img->path, sizeof(img->path), "%s", path);
+    img->w = w;
+    img->h = h;
+    return true;
+}
+
+static bool parse_row(char *line, golden_row_t *r)
+{
+    char *save = NULL;
+    char *tok[34];
+    int n = 0;
+    for (char *t = strtok_r(line, ",\r\n", &save); (t != NULL) && (n < 34); t = strtok_r(NULL, ",\r\n", &save))
+    {
+        tok[n++] = t;
+    }
+    if (n != 34)
+    {
+        return false;
+    }
+
+    snprintf(r->file, sizeof(r->file), "%s", tok[0]);
+    snprintf(r->kind, sizeof(r->kind), "%s", tok[1]);
+    r->x0 = (uint32_t)strtoul(tok[2], NULL, 10);
+    r->y0 = (uint32_t)strtoul(tok[3], NULL, 10);
+    r->w = (uint32_t)strtoul(tok[4], NULL, 10);
+    r->h = (uint32_t)strtoul(tok[5], NULL, 10);
+    r->label = atoi(tok[6]);
+    r->score = strtod(tok[7], NULL);
+    r->prob = strtod(tok[8], NULL);
+    for (int i = 0; i < 25; i++)
+    {
+        r->f[i] = strtod(tok[9 + i], NULL);
+    }
+    return true;
+}
+
+static double feat_max_rel_err(const float *c, const double *g, int *argmax)
+{
+    double worst = 0.0;
+    *argmax = 0;
+    for (int i = 0; i < 25; i++)
+    {
+        const double e = fabs((double)c[i] - g[i]) / fmax(fabs(g[i]), HLAC_GOLDEN_FEAT_FLOOR);
+        if (e > worst)
+        {
+            worst = e;
+            *argmax = i;
+        }
+    }
+    return worst;
+}
+
+static bool score_close(double c, double g)
+{
+    return fabs(c - g) <= s_score_tol * fmax(1.0, fabs(g));
+}
+
+static void compute_row(const golden_row_t *r, const loaded_image_t *img, float out25[25])
+{
+    if (strcmp(r->kind, "full") == 0)
+    {
+        hlac25_compute_from_u8_hyperram(HLAC_GOLDEN_IMG_ADDR, img->w, img->h, out25);
+    }
+    else
+    {
+        hlac25_compute_from_u8_hyperram_roi(HLAC_GOLDEN_IMG_ADDR, img->w, r->x0, r->y0, r->w, r->h, out25);
+    }
+}
+
+typedef struct
+{
+    uint64_t ns;
+    uint32_t n;
+} timing_t;
+
+static double timing_us(const timing_t *t)
+{
+    return (t->n > 0U) ? ((double)t->ns / 1000.0 / (double)t->n) : 0.0;
+}
+
+static void usage(const char *argv0)
+{
+    fprintf(stderr,
+            "Usage: %s golden.csv [--tol REL] [--score-tol REL] [--iters N] [--verbose]\n",
+            argv0);
+}
+
+int main(int argc, char **argv)
+{
+    const char *csv_path = NULL;
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "--tol") == 0) && (i + 1 < argc))
+        {
+            s_tol = atof(argv[++i]);
+        }
+        else if ((strcmp(argv[i], "--score-tol") == 0) && (i + 1 < argc))
+        {
+            s_score_tol = atof(argv[++i]);
+        }
+        else if ((strcmp(argv[i], "--iters") == 0) && (i + 1 < argc))
+        {
+            s_iters = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--verbose") == 0)
+        {
+            s_verbose = true;
+        }
+        else if ((argv[i][0] != '-') && !csv_path)
+        {
+            csv_path = argv[i];
+        }
+        else
+        {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (!csv_path)
+    {
+        usage(argv[0]);
+        return 2;
+    }
+    if (s_iters < 1)
+    {
+        s_iters = 1;
+    }
+
+    FILE *f = fopen(csv_path, "r");
+    if (!f)
+    {
+        fprintf(stderr, "cannot open %s\n", csv_path);
+        return 2;
+    }
+
+    bench_host_init(false);
+
+    static char line[4096];
+    loaded_image_t img = {{0}, 0U, 0U};
+    timing_t t_full = {0U, 0U}, t_roi = {0U, 0U}, t_lda = {0U, 0U};
+    uint32_t rows = 0U, feat_fail = 0U, lda_rows = 0U, lda_fail = 0U, lda_golden_fail = 0U, skipped = 0U;
+    double worst_full = 0.0, worst_roi = 0.0;
+
+    (void)fgets(line, sizeof(line), f); // ヘッダ
+    uint32_t line_no = 1U;
+    while (fgets(line, sizeof(line), f))
+    {
+        line_no++;
+        golden_row_t r;
+        if (!parse_row(line, &r))
+        {
+            if (line[0] != '\n')
+            {
+                fprintf(stderr, "%s:%u: malformed row\n", csv_path, (unsigned)line_no);
+                skipped++;
+            }
+            continue;
+        }
+
+        char path[512];
+        path_join(path, sizeof(path), csv_path, r.file);
+        if (!load_pgm_to_hyperram(path, &img))
+        {
+            skipped++;
+            continue;
+        }
+        const bool is_full = (strcmp(r.kind, "full") == 0);
+        if (!is_full && (((r.x0 + r.w) > img.w) || ((r.y0 + r.h) > img.h)))
+        {
+            fprintf(stderr, "%s:%u: ROI outside %ux%u\n", csv_path, (unsigned)line_no, (unsigned)img.w, (unsigned)img.h);
+            skipped++;
+            continue;
+        }
+        rows++;
+
+        /* HLAC */
+        float feats[25];
+        const uint64_t t0 = bench_now_ns();
+        for (int it = 0; it < s_iters; it++)
+        {
+            compute_row(&r, &img, feats);
+        }
+        timing_t *t = is_full ? &t_full : &t_roi;
+        t->ns += bench_now_ns() - t0;
+        t->n += (uint32_t)s_iters;
+
+        int worst_i = 0;
+        const double err = feat_max_rel_err(feats, r.f, &worst_i);
+        if (is_full)
+        {
+            worst_full = fmax(worst_full, err);
+        }
+        else
+        {
+            worst_roi = fmax(worst_roi, err);
+        }
+        if (err > s_tol)
+        {
+            feat_fail++;
+            fprintf(stderr, "FAIL feat %s %s (%u,%u %ux%u): f%02d c=%.9g golden=%.9g rel=%.3g\n",
+                    r.file, r.kind, (unsigned)r.x0, (unsigned)r.y0, (unsigned)r.w, (unsigned)r.h,
+                    worst_i + 1, (double)feats[worst_i], r.f[worst_i], err);
+        }
+        else if (s_verbose)
+        {
+            fprintf(stderr, "ok   feat %s %s (%u,%u %ux%u): rel=%.3g\n",
+                    r.file, r.kind, (unsigned)r.x0, (unsigned)r.y0, (unsigned)r.w, (unsigned)r.h, err);
+        }
+
+        if (r.label < 0)
+        {
+            continue;
+        }
+        lda_rows++;
+
+        /* LDA: C の特徴量から(ファームと同じ入力) */
+        float score = 0.0f, prob = 0.0f;
+        const uint64_t t1 = bench_now_ns();
+        int label = -1;
+        for (int it = 0; it < s_iters; it++)
+        {
+            label = hlac_lda_predict_ex(feats, &score, &prob, 1);
+        }
+        t_lda.ns += bench_now_ns() - t1;
+        t_lda.n += (uint32_t)s_iters;
+        if ((label != r.label) || !score_close(score, r.score) || !score_close(prob, r.prob))
+        {
+            lda_fail++;
+            fprintf(stderr, "FAIL lda  %s %s (%u,%u): label c=%d golden=%d score c=%.6g golden=%.6g prob c=%.4f golden=%.4f\n",
+                    r.file, r.kind, (unsigned)r.x0, (unsigned)r.y0, label, r.label, (double)score, r.score, (double)prob, r.prob);
+        }
+
+        /* LDA: MATLAB の特徴量から(HLAC の誤差を除いて LDA だけを見る) */
+        float gf[25];
+        for (int i = 0; i < 25; i++)
+        {
+            gf[i] = (float)r.f[i];
+        }
+        label = hlac_lda_predict_ex(gf, &score, &prob, 1);
+        if ((label != r.label) || !score_close(score, r.score) || !score_close(prob, r.prob))
+        {
+            lda_golden_fail++;
+            fprintf(stderr, "FAIL lda_on_golden %s %s (%u,%u): label c=%d golden=%d score c=%.6g golden=%.6g\n",
+                    r.file, r.kind, (unsigned)r.x0, (unsigned)r.y0, label, r.label, (double)score, r.score);
+        }
+    }
+    fclose(f);
+
+    printf("path,rows,feat_fail,feat_max_rel_full,feat_max_rel_roi,lda_rows,lda_fail,lda_on_golden_fail,skipped,"
+           "us_full,us_roi,us_lda,iters\n");
+    printf("%s,%u,%u,%.3g,%.3g,%u,%u,%u,%u,%.1f,%.1f,%.3f,%d\n",
+           HLAC_GOLDEN_PATH, (unsigned)rows, (unsigned)feat_fail, worst_full, worst_roi,
+           (unsigned)lda_rows, (unsigned)lda_fail, (unsigned)lda_golden_fail, (unsigned)skipped,
+           timing_us(&t_full), timing_us(&t_roi), timing_us(&t_lda), s_iters);
+
+    if (rows == 0U)
+    {
+        fprintf(stderr, "no usable rows in %s\n", csv_path);
+        return 1;
+    }
+    return ((feat_fail | lda_fail | lda_golden_fail | skipped) != 0U) ? 1 : 0;
+}
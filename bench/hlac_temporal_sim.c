@@ -0,0 +1,270 @@
+/*
+ * HLAC motor decision rules on a synthetic prediction stream (host build).
+ *
+ * 正解クラスが --segment フレームごとに切り替わる列を作り，各フレームの LDA 出力(softmax
+ * 確率ベクトル)を乱数で合成して，モータへの判定の出し方を比べる．
+ *
+ *   temporal : src/hlac_temporal.c(HLAC_TEMPORAL_ENABLE の値によらず直接呼ぶ．DECAY などはビルド時の -D で変える)
+ *   count K  : 同じ予測が K 回続いたら post して数え直す(MOTOR_PRED_STABLE_COUNT の規則)
+ *
+ * フレームの合成:
+ *   --noise の確率でピークが正解以外のクラス(一様)になる．ピークの確率 conf は
+ *     --confidence equal : 正解/誤りとも U(0.40, 0.90)
+ *     --confidence lower : 正解 U(0.45, 0.95)，誤り U(0.30, 0.65)(誤認識は確信度が低めという仮定)
+ *   残りの 1 - conf は他のクラスに等分する．1フレーム = 1ブロック．
+ *   count 規則の MOTOR_PRED_MIN_BEST_SCORE / HLAC_INFER_MIN_BEST_PROB の足切りは入れない．
+ *
+ * 指標(CSV):
+ *   false_per_frame : 正解と違うクラスの post / 全フレーム
+ *   mean_latency    : 区間の先頭から最初の正しい post までのフレーム数(1 = 先頭フレームで判定)．
+ *                     区間内に出なかったら区間長として数え，missed にも数える
+ *
+ * ビルドと実行は script/hlac_temporal_sim.sh．
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hlac_temporal.h"
+
+typedef struct
+{
+    uint64_t frames;
+    uint64_t posts;
+    uint64_t false_posts;
+    uint64_t segments;
+    uint64_t latency_sum;
+    uint64_t missed;
+} sim_result_t;
+
+typedef struct
+{
+    uint32_t frames;
+    uint32_t segment;
+    uint32_t classes;
+    float noise;
+    bool lower_conf; // 誤ったフレームは確信度が低い
+    uint32_t seed;
+} sim_config_t;
+
+static uint32_t s_rng;
+
+/* xorshift32: 環境によらず同じ列にする(rand() は libc ごとに違う) */
+static uint32_t sim_rand(void)
+{
+    uint32_t x = s_rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    s_rng = x;
+    return x;
+}
+
+static float sim_uniform(float lo, float hi)
+{
+    return lo + (hi - lo) * ((float)(sim_rand() >> 8) * (1.0f / 16777216.0f));
+}
+
+static uint32_t sim_other_class(uint32_t c, uint32_t classes)
+{
+    return (c + 1U + (sim_rand() % (classes - 1U))) % classes;
+}
+
+/* count_k == 0 のとき hlac_temporal，それ以外は K 回連続一致の規則 */
+static sim_result_t sim_run(const sim_config_t *cfg, uint32_t count_k)
+{
+    sim_result_t r;
+    memset(&r, 0, sizeof(r));
+    s_rng = (cfg->seed != 0U) ? cfg->seed : 1U; // 規則どうしで同じ列を使う
+
+    hlac_temporal_t t;
+    hlac_temporal_init(&t, cfg->classes);
+    int stable_pred = -1;
+    uint32_t stable_count = 0U;
+
+    uint32_t truth = 0U;
+    uint32_t seg_start = 0U;
+    bool got = true;
+    for (uint32_t f = 0U; f < cfg->frames; f++)
+    {
+        if ((f % cfg->segment) == 0U)
+        {
+            if (!got)
+            {
+                r.latency_sum += cfg->segment;
+                r.missed++;
+            }
+            truth = sim_other_class(truth, cfg->classes);
+            seg_start = f;
+            got = false;
+            r.segments++;
+        }
+
+        const bool wrong = (sim_uniform(0.0f, 1.0f) < cfg->noise);
+        const uint32_t peak = wrong ? sim_other_class(truth, cfg->classes) : truth;
+        float conf;
+        if (!cfg->lower_conf)
+        {
+            conf = sim_uniform(0.40f, 0.90f);
+        }
+        else
+        {
+            conf = wrong ? sim_uniform(0.30f, 0.65f) : sim_uniform(0.45f, 0.95f);
+        }
+        float probs[HLAC_MAX_CLASSES] = {0};
+        for (uint32_t c = 0U; c < cfg->classes; c++)
+        {
+            probs[c] = (1.0f - conf) / (float)(cfg->classes - 1U);
+        }
+        probs[peak] = conf;
+
+        int post = -1;
+        if (count_k == 0U)
+        {
+            hlac_temporal_add(&t, probs);
+            post = hlac_temporal_end_frame(&t);
+        }
+        else
+        {
+            if ((int)peak == stable_pred)
+            {
+                stable_count++;
+            }
+            else
+            {
+                stable_pred = (int)peak;
+                stable_count = 1U;
+            }
+            if (stable_count >= count_k)
+            {
+                post = (int)peak;
+                stable_count = 0U;
+            }
+        }
+
+        if (post >= 0)
+        {
+            r.posts++;
+            if ((uint32_t)post != truth)
+            {
+                r.false_posts++;
+            }
+            else if (!got)
+            {
+                got = true;
+                r.latency_sum += (uint64_t)(f - seg_start + 1U);
+            }
+        }
+    }
+    if (!got)
+    {
+        r.latency_sum += cfg->segment;
+        r.missed++;
+    }
+    r.frames = cfg->frames;
+    return r;
+}
+
+static void print_row(const char *rule, uint32_t k, const sim_config_t *cfg, const sim_result_t *r)
+{
+    printf("%s,%u,%.3f,%s,%u,%llu,%llu,%.5f,%.4f,%.2f,%llu\n",
+           rule, (unsigned)k, (double)cfg->noise, cfg->lower_conf ? "lower" : "equal", (unsigned)cfg->frames,
+           (unsigned long long)r->posts, (unsigned long long)r->false_posts,
+           (r->frames > 0U) ? ((double)r->false_posts / (double)r->frames) : 0.0,
+           (r->posts > 0U) ? ((double)r->false_posts / (double)r->posts) : 0.0,
+           (r->segments > 0U) ? ((double)r->latency_sum / (double)r->segments) : 0.0,
+           (unsigned long long)r->missed);
+}
+
+static void usage(const char *argv0)
+{
+    fprintf(stderr,
+            "Usage: %s [--frames N] [--segment N] [--classes N] [--noise P] [--confidence equal|lower]\n"
+            "          [--count-k K1,K2,...] [--seed N] [--no-header]\n",
+            argv0);
+}
+
+int main(int argc, char **argv)
+{
+    sim_config_t cfg = {200000U, 30U, 4U, 0.2f, true, 7U};
+    const char *count_list = "2,3,4";
+    bool header = true;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "--frames") == 0) && (i + 1 < argc))
+        {
+            cfg.frames = (uint32_t)strtoul(argv[++i], NULL, 10);
+        }
+        else if ((strcmp(argv[i], "--segment") == 0) && (i + 1 < argc))
+        {
+            cfg.segment = (uint32_t)strtoul(argv[++i], NULL, 10);
+        }
+        else if ((strcmp(argv[i], "--classes") == 0) && (i + 1 < argc))
+        {
+            cfg.classes = (uint32_t)strtoul(argv[++i], NULL, 10);
+        }
+        else if ((strcmp(argv[i], "--noise") == 0) && (i + 1 < argc))
+        {
+            cfg.noise = (float)atof(argv[++i]);
+        }
+        else if ((strcmp(argv[i], "--confidence") == 0) && (i + 1 < argc))
+        {
+            const char *v = argv[++i];
+            if ((strcmp(v, "equal") != 0) && (strcmp(v, "lower") != 0))
+            {
+                usage(argv[0]);
+                return 2;
+            }
+            cfg.lower_conf = (strcmp(v, "lower") == 0);
+        }
+        else if ((strcmp(argv[i], "--count-k") == 0) && (i + 1 < argc))
+        {
+            count_list = argv[++i];
+        }
+        else if ((strcmp(argv[i], "--seed") == 0) && (i + 1 < argc))
+        {
+            cfg.seed = (uint32_t)strtoul(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--no-header") == 0)
+        {
+            header = false;
+        }
+        else
+        {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if ((cfg.classes < 2U) || (cfg.classes > HLAC_MAX_CLASSES) || (cfg.segment == 0U) || (cfg.frames == 0U))
+    {
+        fprintf(stderr, "need 2..%u classes and non-zero --segment / --frames\n", (unsigned)HLAC_MAX_CLASSES);
+        return 2;
+    }
+
+    if (header)
+    {
+        printf("rule,k,noise,confidence,frames,posts,false_posts,false_per_frame,false_per_post,mean_latency,missed\n");
+    }
+
+    sim_result_t r = sim_run(&cfg, 0U);
+    print_row("temporal", 0U, &cfg, &r);
+
+    const char *p = count_list;
+    while (*p != '\0')
+    {
+        char *end = NULL;
+        const unsigned long k = strtoul(p, &end, 10);
+        if ((end == p) || (k == 0UL))
+        {
+            fprintf(stderr, "bad --count-k list: %s\n", count_list);
+            return 2;
+        }
+        r = sim_run(&cfg, (uint32_t)k);
+        print_row("count", (uint32_t)k, &cfg, &r);
+        p = (*end == ',') ? (end + 1) : end;
+    }
+    return 0;
+}
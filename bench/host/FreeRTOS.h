@@ -0,0 +1,27 @@
+#pragma once
+
+/* Host build shim: FreeRTOS subset (bench only; single thread, no scheduler). */
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint32_t TickType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef void *TaskHandle_t;
+typedef void *SemaphoreHandle_t;
+typedef void *QueueHandle_t;
+
+#define pdFALSE (0)
+#define pdTRUE (1)
+#define pdPASS (1)
+#define pdFAIL (0)
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFFUL)
+#define configTICK_RATE_HZ (1000U)
+#define portTICK_PERIOD_MS (1U)
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define configASSERT(x) ((void)(x))
+#define portYIELD() ((void)0)
+#define taskYIELD() ((void)0)
+#define taskENTER_CRITICAL() ((void)0)
+#define taskEXIT_CRITICAL() ((void)0)
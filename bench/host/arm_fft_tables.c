@@ -0,0 +1,239 @@
+/*
+ * FFT tables of CMSIS-DSP arm_common_tables.c for host benches.
+ *
+ * arm_common_tables.c is not part of this checkout (the FSP pack ships it), but
+ * arm_const_structs.c and the CFFT kernels need its twiddle / bit-reversal tables.
+ * Every table used by them is defined by a formula, so the host build fills them
+ * once at load time instead of carrying the 1.5MB source.
+ *
+ * - twiddleCoef_N (f32/f64): N 複素数 cos/sin(2*pi*i/N)
+ * - twiddleCoef_N_q31/_q15: 3N/4 複素数，round(x * 2^31 / 2^15) を飽和
+ * - twiddleCoef_rfft_N: N/2 複素数 (sin, cos)
+ * - realCoefA/B Q31/Q15: arm_rfft_q31/q15 の分割係数(n=4096)
+ * - armBitRevIndexTable_fixed_N / F64_N: 2進ビット反転の入れ替えペア(radix-4/2 系)
+ * - armBitRevIndexTableN (f32): radix-8 の出力順から戻す入れ替え列．
+ *   r0 = N / 8^k (1, 2, 4) のとき，位置 s*(N/r0) + p に周波数 r0 * rev8(p) + s が入る．
+ * 値は要素 i に対して 8*i(arm_bitreversal_* が >> 2 して実部の添字にする)．
+ * 長さは arm_common_tables.h の *_TABLE_LENGTH と一致する(最小の入れ替え数)．
+ *
+ * arm_common_tables.h は const で宣言しているので，型の衝突を避けるためここでは include しない．
+ */
+
+#include <math.h>
+#include <stdint.h>
+
+#define FFT_TABLE_PI (3.14159265358979323846)
+
+#define FFT_TABLES_FOR_SIZE(N)                                                                                 \
+    float twiddleCoef_##N[2 * (N)];                                                                            \
+    uint64_t twiddleCoefF64_##N[2 * (N)];                                                                      \
+    int32_t twiddleCoef_##N##_q31[3 * (N) / 2];                                                                \
+    int16_t twiddleCoef_##N##_q15[3 * (N) / 2];                                                                \
+    uint16_t armBitRevIndexTable##N[2 * (N)];                                                                  \
+    uint16_t armBitRevIndexTable_fixed_##N[2 * (N)];                                                           \
+    uint16_t armBitRevIndexTableF64_##N[2 * (N)];
+
+#define FFT_RFFT_TABLES_FOR_SIZE(N)   \
+    float twiddleCoef_rfft_##N[(N)]; \
+    uint64_t twiddleCoefF64_rfft_##N[(N)];
+
+FFT_TABLES_FOR_SIZE(16)
+FFT_TABLES_FOR_SIZE(32)
+FFT_TABLES_FOR_SIZE(64)
+FFT_TABLES_FOR_SIZE(128)
+FFT_TABLES_FOR_SIZE(256)
+FFT_TABLES_FOR_SIZE(512)
+FFT_TABLES_FOR_SIZE(1024)
+FFT_TABLES_FOR_SIZE(2048)
+FFT_TABLES_FOR_SIZE(4096)
+
+FFT_RFFT_TABLES_FOR_SIZE(32)
+FFT_RFFT_TABLES_FOR_SIZE(64)
+FFT_RFFT_TABLES_FOR_SIZE(128)
+FFT_RFFT_TABLES_FOR_SIZE(256)
+FFT_RFFT_TABLES_FOR_SIZE(512)
+FFT_RFFT_TABLES_FOR_SIZE(1024)
+FFT_RFFT_TABLES_FOR_SIZE(2048)
+FFT_RFFT_TABLES_FOR_SIZE(4096)
+
+#define FFT_REAL_COEF_N (4096)
+
+int32_t realCoefAQ31[2 * FFT_REAL_COEF_N];
+int32_t realCoefBQ31[2 * FFT_REAL_COEF_N];
+int16_t realCoefAQ15[2 * FFT_REAL_COEF_N];
+int16_t realCoefBQ15[2 * FFT_REAL_COEF_N];
+
+typedef struct
+{
+    uint32_t n;
+    float *tw_f32;
+    uint64_t *tw_f64;
+    int32_t *tw_q31;
+    int16_t *tw_q15;
+    uint16_t *br_f32;
+    uint16_t *br_fixed;
+    uint16_t *br_f64;
+    float *rfft_f32; // n >= 32 のみ
+    uint64_t *rfft_f64;
+} fft_table_set_t;
+
+#define FFT_TABLE_SET(N, RF32, RF64)                                                                 \
+    {                                                                                                \
+        (N), twiddleCoef_##N, twiddleCoefF64_##N, twiddleCoef_##N##_q31, twiddleCoef_##N##_q15,     \
+            armBitRevIndexTable##N, armBitRevIndexTable_fixed_##N, armBitRevIndexTableF64_##N, RF32, RF64 \
+    }
+
+static const fft_table_set_t s_sets[] = {
+    FFT_TABLE_SET(16, (float *)0, (uint64_t *)0),
+    FFT_TABLE_SET(32, twiddleCoef_rfft_32, twiddleCoefF64_rfft_32),
+    FFT_TABLE_SET(64, twiddleCoef_rfft_64, twiddleCoefF64_rfft_64),
+    FFT_TABLE_SET(128, twiddleCoef_rfft_128, twiddleCoefF64_rfft_128),
+    FFT_TABLE_SET(256, twiddleCoef_rfft_256, twiddleCoefF64_rfft_256),
+    FFT_TABLE_SET(512, twiddleCoef_rfft_512, twiddleCoefF64_rfft_512),
+    FFT_TABLE_SET(1024, twiddleCoef_rfft_1024, twiddleCoefF64_rfft_1024),
+    FFT_TABLE_SET(2048, twiddleCoef_rfft_2048, twiddleCoefF64_rfft_2048),
+    FFT_TABLE_SET(4096, twiddleCoef_rfft_4096, twiddleCoefF64_rfft_4096),
+};
+
+static uint64_t fft_f64_bits(double x)
+{
+    union
+    {
+        double d;
+        uint64_t u;
+    } v;
+    v.d = x;
+    return v.u;
+}
+
+static int32_t fft_q31(double x)
+{
+    const double v = round(x * 2147483648.0);
+    return (v >= 2147483647.0) ? INT32_MAX : ((v <= -2147483648.0) ? INT32_MIN : (int32_t)v);
+}
+
+static int16_t fft_q15(double x)
+{
+    const double v = round(x * 32768.0);
+    return (v >= 32767.0) ? INT16_MAX : ((v <= -32768.0) ? INT16_MIN : (int16_t)v);
+}
+
+static uint32_t fft_digit_rev(uint32_t x, uint32_t n, uint32_t radix)
+{
+    uint32_t r = 0U;
+    for (uint32_t m = n; m > 1U; m /= radix)
+    {
+        r = r * radix + (x % radix);
+        x /= radix;
+    }
+    return r;
+}
+
+/*
+ * perm[pos] = その位置に入っている周波数．先頭から順に正しい要素を入れ替えで持ってくる
+ * (巡回ごとに長さ - 1 回 = 最小)．arm_bitreversal_* は表の順に入れ替えるので順序も込みで有効．
+ */
+static void fft_swaps_from_perm(uint16_t *perm, uint16_t *where, uint32_t n, uint16_t *table)
+{
+    uint32_t len = 0U;
+    for (uint32_t i = 0U; i < n; i++)
+    {
+        where[perm[i]] = (uint16_t)i;
+    }
+    for (uint32_t i = 0U; i < n; i++)
+    {
+        if (perm[i] == i)
+        {
+            continue;
+        }
+        const uint16_t j = where[i];
+        const uint16_t moved = perm[i];
+        perm[j] = moved;
+        where[moved] = j;
+        perm[i] = (uint16_t)i;
+        where[i] = (uint16_t)i;
+        table[len++] = (uint16_t)(8U * i);
+        table[len++] = (uint16_t)(8U * j);
+    }
+}
+
+static void fft_fill_set(const fft_table_set_t *t)
+{
+    static uint16_t perm[4096];
+    static uint16_t where[4096];
+    const uint32_t n = t->n;
+
+    for (uint32_t i = 0U; i < n; i++)
+    {
+        const double a = 2.0 * FFT_TABLE_PI * (double)i / (double)n;
+        t->tw_f32[2U * i] = (float)cos(a);
+        t->tw_f32[2U * i + 1U] = (float)sin(a);
+        t->tw_f64[2U * i] = fft_f64_bits(cos(a));
+        t->tw_f64[2U * i + 1U] = fft_f64_bits(sin(a));
+        if (i < 3U * n / 4U)
+        {
+            t->tw_q31[2U * i] = fft_q31(cos(a));
+            t->tw_q31[2U * i + 1U] = fft_q31(sin(a));
+            t->tw_q15[2U * i] = fft_q15(cos(a));
+            t->tw_q15[2U * i + 1U] = fft_q15(sin(a));
+        }
+        if ((t->rfft_f32 != 0) && (i < n / 2U))
+        {
+            /* i * exp(-j*a): 実部 sin，虚部 cos */
+            t->rfft_f32[2U * i] = (float)sin(a);
+            t->rfft_f32[2U * i + 1U] = (float)cos(a);
+            t->rfft_f64[2U * i] = fft_f64_bits(sin(a));
+            t->rfft_f64[2U * i + 1U] = fft_f64_bits(cos(a));
+        }
+    }
+
+    /* radix-4/2 系(q31/q15/f64): 2進ビット反転 */
+    for (uint32_t i = 0U; i < n; i++)
+    {
+        perm[i] = (uint16_t)fft_digit_rev(i, n, 2U);
+    }
+    fft_swaps_from_perm(perm, where, n, t->br_fixed);
+    for (uint32_t i = 0U; i < n; i++)
+    {
+        perm[i] = (uint16_t)fft_digit_rev(i, n, 2U);
+    }
+    fft_swaps_from_perm(perm, where, n, t->br_f64);
+
+    /* f32 radix-8(+ 先頭の radix-2 / radix-4 段) */
+    uint32_t r0 = n;
+    while (r0 >= 8U)
+    {
+        r0 /= 8U;
+    }
+    const uint32_t m = n / r0;
+    for (uint32_t i = 0U; i < n; i++)
+    {
+        perm[i] = (uint16_t)(r0 * fft_digit_rev(i % m, m, 8U) + i / m);
+    }
+    fft_swaps_from_perm(perm, where, n, t->br_f32);
+}
+
+__attribute__((constructor)) static void fft_tables_init(void)
+{
+    for (uint32_t k = 0U; k < (uint32_t)(sizeof(s_sets) / sizeof(s_sets[0])); k++)
+    {
+        fft_fill_set(&s_sets[k]);
+    }
+
+    for (uint32_t i = 0U; i < (uint32_t)FFT_REAL_COEF_N; i++)
+    {
+        const double a = 2.0 * FFT_TABLE_PI / (double)(2 * FFT_REAL_COEF_N) * (double)i;
+        const double ar = 0.5 * (1.0 - sin(a));
+        const double ai = 0.5 * (-1.0 * cos(a));
+        const double br = 0.5 * (1.0 + sin(a));
+        const double bi = 0.5 * (1.0 * cos(a));
+        realCoefAQ31[2U * i] = fft_q31(ar);
+        realCoefAQ31[2U * i + 1U] = fft_q31(ai);
+        realCoefBQ31[2U * i] = fft_q31(br);
+        realCoefBQ31[2U * i + 1U] = fft_q31(bi);
+        realCoefAQ15[2U * i] = fft_q15(ar);
+        realCoefAQ15[2U * i + 1U] = fft_q15(ai);
+        realCoefBQ15[2U * i] = fft_q15(br);
+        realCoefBQ15[2U * i + 1U] = fft_q15(bi);
+    }
+}
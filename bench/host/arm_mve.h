@@ -0,0 +1,123 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Host emulation of the Helium (MVE) intrinsics used by src/hlac_lda_infer.c.
+ *
+ * -D__ARM_FEATURE_MVE=1 でコンパイルしたファイルだけがこれを取り込む．
+ * レーンの並び・幅の拡張(bottom=偶数レーン / top=奇数レーン)・乗算の桁あふれ(mod 2^n)は
+ * 実機と同じにしてあるので，MVE 経路の数値はそのまま検証できる．速度は実機の参考にならない．
+ * 足りない組み込み関数はコンパイルエラーになるので，必要になったらここへ足す．
+ */
+
+typedef struct
+{
+    uint8_t v[16];
+} uint8x16_t;
+
+typedef struct
+{
+    uint16_t v[8];
+} uint16x8_t;
+
+typedef struct
+{
+    uint32_t v[4];
+} uint32x4_t;
+
+static inline uint8x16_t vld1q_u8(const uint8_t *p)
+{
+    uint8x16_t r;
+    memcpy(r.v, p, sizeof(r.v));
+    return r;
+}
+
+static inline void vst1q_u16(uint16_t *p, uint16x8_t a)
+{
+    memcpy(p, a.v, sizeof(a.v));
+}
+
+static inline uint16x8_t vmovlbq_u8(uint8x16_t a)
+{
+    uint16x8_t r;
+    for (int i = 0; i < 8; i++)
+    {
+        r.v[i] = a.v[2 * i];
+    }
+    return r;
+}
+
+static inline uint16x8_t vmovltq_u8(uint8x16_t a)
+{
+    uint16x8_t r;
+    for (int i = 0; i < 8; i++)
+    {
+        r.v[i] = a.v[2 * i + 1];
+    }
+    return r;
+}
+
+static inline uint32x4_t vmovlbq_u16(uint16x8_t a)
+{
+    uint32x4_t r;
+    for (int i = 0; i < 4; i++)
+    {
+        r.v[i] = a.v[2 * i];
+    }
+    return r;
+}
+
+static inline uint32x4_t vmovltq_u16(uint16x8_t a)
+{
+    uint32x4_t r;
+    for (int i = 0; i < 4; i++)
+    {
+        r.v[i] = a.v[2 * i + 1];
+    }
+    return r;
+}
+
+static inline uint16x8_t vmulq_u16(uint16x8_t a, uint16x8_t b)
+{
+    uint16x8_t r;
+    for (int i = 0; i < 8; i++)
+    {
+        r.v[i] = (uint16_t)((uint32_t)a.v[i] * (uint32_t)b.v[i]);
+    }
+    return r;
+}
+
+static inline uint32x4_t vmulq_u32(uint32x4_t a, uint32x4_t b)
+{
+    uint32x4_t r;
+    for (int i = 0; i < 4; i++)
+    {
+        r.v[i] = a.v[i] * b.v[i];
+    }
+    return r;
+}
+
+static inline uint32_t vaddvq_u16(uint16x8_t a)
+{
+    uint32_t s = 0U;
+    for (int i = 0; i < 8; i++)
+    {
+        s += a.v[i];
+    }
+    return s;
+}
+
+static inline uint32_t vaddvq_u32(uint32x4_t a)
+{
+    uint32_t s = 0U;
+    for (int i = 0; i < 4; i++)
+    {
+        s += a.v[i];
+    }
+    return s;
+}
+
+/* 多重定義版(arm_mve.h の polymorphic 名) */
+#define vaddvq(a) _Generic((a), uint16x8_t: vaddvq_u16, uint32x4_t: vaddvq_u32)(a)
@@ -0,0 +1,193 @@
+#include "bench_host.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "hal_data.h"
+#include "hyperram_integ.h"
+#include "video_frame_buffer.h"
+#include "xprintf.h"
+#include "latency_trace.h"
+#include "motor_control.h"
+
+uint32_t SystemCoreClock = 360000000UL; /* RA8E1 CPUCLK */
+
+bench_core_debug_t g_bench_core_debug;
+static bench_dwt_t s_dwt;
+
+/* Thread0 が公開するフレーム(ベンチでは固定) */
+volatile uint32_t g_video_frame_base_offset = (uint32_t)VIDEO_FRAME_BASE_OFFSET_DEFAULT;
+volatile uint32_t g_video_frame_seq = 0;
+volatile video_frame_desc_t g_video_frame_desc = {0U};
+volatile uint32_t g_video_frame_pub_gen = 0;
+
+static uint8_t s_hyperram[HYPERRAM_SIZE];
+
+static void bench_putc_stderr(int c)
+{
+    fputc(c, stderr);
+}
+
+static void bench_putc_null(int c)
+{
+    (void)c;
+}
+
+void bench_host_init(bool firmware_log)
+{
+    xdev_out(firmware_log ? bench_putc_stderr : bench_putc_null);
+}
+
+uint8_t *bench_hyperram(void)
+{
+    return s_hyperram;
+}
+
+uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+bench_dwt_t *bench_dwt(void)
+{
+    s_dwt.CYCCNT = (uint32_t)((bench_now_ns() * (uint64_t)(SystemCoreClock / 1000000UL)) / 1000ULL);
+    return &s_dwt;
+}
+
+/* ---- HyperRAM ---- */
+
+static fsp_err_t bench_hyperram_range(uintptr_t offset, uint32_t length)
+{
+    if ((offset > (uintptr_t)HYPERRAM_SIZE) || (length > ((uint32_t)HYPERRAM_SIZE - (uint32_t)offset)))
+    {
+        fprintf(stderr, "[bench] HyperRAM access out of range: 0x%08lx + %u\n", (unsigned long)offset, (unsigned)length);
+        return FSP_ERR_INVALID_ARGUMENT;
+    }
+    return FSP_SUCCESS;
+}
+
+fsp_err_t hyperram_b_write(const void *p_src, void *p_dest, uint32_t total_length)
+{
+    const uintptr_t off = (uintptr_t)p_dest;
+    fsp_err_t err = bench_hyperram_range(off, total_length);
+    if (FSP_SUCCESS == err)
+    {
+        memcpy(&s_hyperram[off], p_src, total_length);
+    }
+    return err;
+}
+
+fsp_err_t hyperram_b_read(void *p_dest, const void *p_src, uint32_t total_length)
+{
+    const uintptr_t off = (uintptr_t)p_src;
+    fsp_err_t err = bench_hyperram_range(off, total_length);
+    if (FSP_SUCCESS == err)
+    {
+        memcpy(p_dest, &s_hyperram[off], total_length);
+    }
+    return err;
+}
+
+fsp_err_t hyperram_b_write_timed(const void *p_src, void *p_dest, uint32_t total_length, TickType_t wait_ticks)
+{
+    (void)wait_ticks;
+    return hyperram_b_write(p_src, p_dest, total_length);
+}
+
+fsp_err_t hyperram_b_read_timed(void *p_dest, const void *p_src, uint32_t total_length, TickType_t wait_ticks)
+{
+    (void)wait_ticks;
+    return hyperram_b_read(p_dest, p_src, total_length);
+}
+
+void hyperram_write_verify_counters_reset(void)
+{
+}
+
+void hyperram_write_verify_counters_get(uint32_t *p_mismatch_chunks, uint32_t *p_retries, uint32_t *p_failed_chunks)
+{
+    *p_mismatch_chunks = 0U;
+    *p_retries = 0U;
+    *p_failed_chunks = 0U;
+}
+
+void hyperram_write_verify_detail_get(uint32_t *p_chunks_mismatched, uint32_t *p_retry_ok_chunks,
+                                      uint32_t *p_safe_fallback_used_chunks)
+{
+    *p_chunks_mismatched = 0U;
+    *p_retry_ok_chunks = 0U;
+    *p_safe_fallback_used_chunks = 0U;
+}
+
+uint32_t hyperram_write_verify_is_enabled(void)
+{
+    return 0U;
+}
+
+uint32_t hyperram_write_verify_retries(void)
+{
+    return 0U;
+}
+
+void hyperram_register_caller(hyperram_caller_t caller)
+{
+    (void)caller;
+}
+
+/* ---- FreeRTOS ---- */
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(bench_now_ns() / 1000000ULL);
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    (void)ticks;
+}
+
+void vTaskDelayUntil(TickType_t *prev, TickType_t inc)
+{
+    *prev += inc;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return (TaskHandle_t)0;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t wait)
+{
+    (void)clear_on_exit;
+    (void)wait;
+    return 0U;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *woken)
+{
+    (void)task;
+    if (woken)
+    {
+        *woken = pdFALSE;
+    }
+}
+
+/* ---- Thread3 から呼ばれる他スレッドのモジュール(ベンチでは何もしない) ---- */
+
+#if LATENCY_TRACE_ENABLE
+void latency_trace_stamp_at(uint32_t frame_seq, latency_stage_t stage, uint32_t cyc)
+{
+    (void)frame_seq;
+    (void)stage;
+    (void)cyc;
+}
+#endif
+
+void motor_control_post_pred_frame(int pred, uint32_t frame_seq)
+{
+    (void)pred;
+    (void)frame_seq;
+}
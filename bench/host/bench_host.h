@@ -0,0 +1,20 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Host runtime for benches that compile firmware sources on a PC.
+ *
+ * - HyperRAM は 8MB の配列(hyperram_b_read/write は memcpy)．OSPI の帯域は含まない．
+ * - DWT->CYCCNT はホストの単調時計を SystemCoreClock で換算した値．
+ * - FreeRTOS の tick/遅延はスケジューラ無しの最小実装．
+ * - ファームのログ(xprintf)は既定で捨てる．bench_host_init(true) で stderr へ．
+ */
+
+void bench_host_init(bool firmware_log);
+
+/* HyperRAM 配列の先頭(オフセット 0) */
+uint8_t *bench_hyperram(void);
+
+uint64_t bench_now_ns(void);
@@ -0,0 +1,66 @@
+#pragma once
+
+/* Host build shim: FSP/CMSIS core subset (bench only). */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef int fsp_err_t;
+#define FSP_SUCCESS (0)
+#define FSP_ERR_ASSERTION (1)
+#define FSP_ERR_TIMEOUT (10)
+#define FSP_ERR_IN_USE (12)
+#define FSP_ERR_INVALID_ARGUMENT (3)
+
+#define FSP_PARAMETER_NOT_USED(p) (void)(p)
+#define FSP_HEADER
+#define FSP_FOOTER
+#define BSP_ALIGN_VARIABLE(x) __attribute__((aligned(x)))
+#define BSP_PLACE_IN_SECTION(x)
+
+/* DWT->CYCCNT は bench_host.c がホストの単調時計から作る */
+typedef struct
+{
+    uint32_t CTRL;
+    volatile uint32_t CYCCNT;
+} bench_dwt_t;
+
+typedef struct
+{
+    uint32_t DEMCR;
+} bench_core_debug_t;
+
+extern bench_dwt_t *bench_dwt(void);
+extern bench_core_debug_t g_bench_core_debug;
+
+#define DWT (bench_dwt())
+#define CoreDebug (&g_bench_core_debug)
+#define DWT_CTRL_CYCCNTENA_Msk (1UL)
+#define CoreDebug_DEMCR_TRCENA_Msk (1UL << 24)
+
+extern uint32_t SystemCoreClock;
+
+#define __DSB() __sync_synchronize()
+#define __DMB() __sync_synchronize()
+#define __ISB() __sync_synchronize()
+#define __NOP() ((void)0)
+
+static inline void SCB_CleanDCache(void) {}
+static inline void SCB_InvalidateDCache(void) {}
+static inline void SCB_DisableDCache(void) {}
+static inline void SCB_EnableDCache(void) {}
+static inline void SCB_CleanDCache_by_Addr(volatile void *addr, int32_t size)
+{
+    (void)addr;
+    (void)size;
+}
+static inline void SCB_InvalidateDCache_by_Addr(volatile void *addr, int32_t size)
+{
+    (void)addr;
+    (void)size;
+}
+
+static inline uint32_t __get_IPSR(void)
+{
+    return 0U; /* always thread mode */
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+/*
+ * Host build shim for the FSP headers (bench only).
+ * Just enough of the types/macros for the Thread3 sources to compile on a PC.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "bsp_api.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "r_ospi_b.h"
+#include "r_ceu.h"
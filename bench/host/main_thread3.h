@@ -0,0 +1,4 @@
+#pragma once
+/* Host build shim (bench only). */
+#include "hal_data.h"
+void main_thread3_entry(void *pvParameters);
@@ -0,0 +1,14 @@
+#pragma once
+/* Host build shim (bench only). */
+
+typedef struct
+{
+    uint32_t event;
+    void const *p_context;
+} capture_callback_args_t;
+
+typedef struct
+{
+    uint32_t event;
+    void const *p_context;
+} i2c_master_callback_args_t;
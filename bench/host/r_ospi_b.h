@@ -0,0 +1,27 @@
+#pragma once
+
+/* Host build shim (bench only): OSPI types named in hyperram_integ.h. */
+
+#include <stdint.h>
+
+typedef struct
+{
+    uint32_t address;
+    uint32_t data;
+} spi_flash_direct_transfer_t;
+
+typedef enum
+{
+    SPI_FLASH_DIRECT_TRANSFER_DIR_READ = 0,
+    SPI_FLASH_DIRECT_TRANSFER_DIR_WRITE = 1,
+} spi_flash_direct_transfer_dir_t;
+
+typedef struct
+{
+    uint32_t unused;
+} ospi_b_xspi_command_set_t;
+
+typedef struct
+{
+    uint32_t unused;
+} R_XSPI0_Type;
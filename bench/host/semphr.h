@@ -0,0 +1,11 @@
+#pragma once
+
+/* Host build shim (bench only): mutexes always succeed. */
+
+#include "FreeRTOS.h"
+
+#define xSemaphoreCreateMutex() ((SemaphoreHandle_t)1)
+#define xSemaphoreCreateMutexStatic(b) ((void)(b), (SemaphoreHandle_t)1)
+#define xSemaphoreTake(s, t) ((void)(s), (void)(t), pdTRUE)
+#define xSemaphoreGive(s) ((void)(s), pdTRUE)
+typedef int StaticSemaphore_t;
@@ -0,0 +1,13 @@
+#pragma once
+
+/* Host build shim (bench only). */
+
+#include "FreeRTOS.h"
+
+TickType_t xTaskGetTickCount(void);
+void vTaskDelay(TickType_t ticks);
+void vTaskDelayUntil(TickType_t *prev, TickType_t inc);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t wait);
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *woken);
+#define xTaskNotifyGive(t) ((void)(t), pdPASS)
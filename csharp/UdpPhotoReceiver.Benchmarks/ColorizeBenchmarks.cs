@@ -0,0 +1,69 @@
+using BenchmarkDotNet.Attributes;
+using UdpPhotoReceiver.Core;
+
+namespace UdpPhotoReceiver.Benchmarks;
+
+/// <summary>
+/// Depth -> BGR24 heatmap with a non-identity range (the viewer default), per frame size.
+/// Baseline is the previous per-pixel remap + 3-byte LUT loop.
+/// </summary>
+[MemoryDiagnoser]
+public class ColorizeBenchmarks
+{
+    [Params("320x240", "640x480", "1280x960")]
+    public string Size = "320x240";
+
+    private const byte RangeMin = 150;
+    private const byte RangeMax = 255;
+
+    private int _width;
+    private int _height;
+    private byte[] _depth = Array.Empty<byte>();
+    private byte[] _bgr = Array.Empty<byte>();
+    private byte[] _jet = Array.Empty<byte>();
+    private DepthColorizer _parallel = null!;
+    private DepthColorizer _singleThread = null!;
+
+    [GlobalSetup]
+    public void Setup()
+    {
+        string[] wh = Size.Split('x');
+        _width = int.Parse(wh[0]);
+        _height = int.Parse(wh[1]);
+
+        _depth = new byte[_width * _height];
+        var rng = new Random(1);
+        rng.NextBytes(_depth);
+
+        _bgr = new byte[_width * _height * 3];
+        _jet = JetColormap.CreateBgrLut256();
+        _parallel = new DepthColorizer();
+        _singleThread = new DepthColorizer { ParallelThresholdPixels = int.MaxValue };
+    }
+
+    [Benchmark(Baseline = true)]
+    public void ScalarRemap()
+    {
+        Span<byte> dst = _bgr;
+        int i = 0;
+        for (int y = 0; y < _height; y++)
+        {
+            Span<byte> row = dst.Slice(y * _width * 3, _width * 3);
+            for (int x = 0; x < _width; x++)
+            {
+                int lut = DepthColorizer.RemapToByteRange(_depth[i++], RangeMin, RangeMax) * 3;
+                row[x * 3 + 0] = _jet[lut + 0];
+                row[x * 3 + 1] = _jet[lut + 1];
+                row[x * 3 + 2] = _jet[lut + 2];
+            }
+        }
+    }
+
+    [Benchmark]
+    public bool CompositeLut() =>
+        _singleThread.RenderBgr24(_depth, _width, _height, _bgr, _width * 3, RenderMode.Heatmap, RangeMin, RangeMax);
+
+    [Benchmark]
+    public bool CompositeLutParallel() =>
+        _parallel.RenderBgr24(_depth, _width, _height, _bgr, _width * 3, RenderMode.Heatmap, RangeMin, RangeMax);
+}
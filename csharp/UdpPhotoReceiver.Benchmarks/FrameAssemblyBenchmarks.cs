@@ -0,0 +1,59 @@
+using BenchmarkDotNet.Attributes;
+using UdpPhotoReceiver.Core;
+
+namespace UdpPhotoReceiver.Benchmarks;
+
+/// <summary>
+/// One 320x240 depth frame (150 datagrams) through the receiver's datagram path, socket excluded.
+/// The "Allocated" column is the acceptance check: it must read "-" (0 B) per frame.
+/// </summary>
+[MemoryDiagnoser]
+public class FrameAssemblyBenchmarks
+{
+    [Params(0, 2)]
+    public int LossPercent;
+
+    private byte[][] _datagrams = Array.Empty<byte[]>();
+    private UdpFrameReceiver _receiver = null!;
+    private long _frames;
+
+    [GlobalSetup]
+    public void Setup()
+    {
+        var frame = new byte[FrameGeometry.DefaultWidth * FrameGeometry.DefaultHeight];
+        for (int i = 0; i < frame.Length; i++)
+        {
+            frame[i] = (byte)(i * 31);
+        }
+
+        // Deterministic loss pattern; chunk 0 is kept so every invocation is one frame.
+        _datagrams = FramePacketizer.Packetize(frame)
+            .Where((_, i) => i == 0 || (i * 37) % 100 >= LossPercent)
+            .ToArray();
+
+        _receiver = new UdpFrameReceiver(
+            localPort: 0,
+            onFrame: f =>
+            {
+                _frames++;
+                f.Dispose();
+            },
+            frameTimeout: TimeSpan.FromSeconds(10));
+    }
+
+    [Benchmark]
+    public long AssembleFrame()
+    {
+        foreach (byte[] d in _datagrams)
+        {
+            _receiver.ProcessDatagram(d);
+        }
+        return _frames;
+    }
+
+    [GlobalCleanup]
+    public void Cleanup()
+    {
+        _receiver.Dispose();
+    }
+}
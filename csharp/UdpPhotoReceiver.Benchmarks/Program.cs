@@ -0,0 +1,11 @@
+using BenchmarkDotNet.Running;
+
+namespace UdpPhotoReceiver.Benchmarks;
+
+static class Program
+{
+    static void Main(string[] args)
+    {
+        BenchmarkSwitcher.FromAssembly(typeof(Program).Assembly).Run(args);
+    }
+}
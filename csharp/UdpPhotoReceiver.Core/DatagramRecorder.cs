@@ -0,0 +1,100 @@
+using System.Buffers.Binary;
+using System.Diagnostics;
+using System.Net;
+using System.Net.Sockets;
+
+namespace UdpPhotoReceiver.Core;
+
+/// <summary>
+/// Writes every received datagram to a classic pcap file (nanosecond timestamps, LINKTYPE_RAW),
+/// so a capture opens in Wireshark/tcpdump and replays through <see cref="DatagramReplayer"/>.
+/// IPv4/UDP headers are synthesized from the sender address and the local port; the local
+/// address is written as 0.0.0.0 and the UDP checksum as 0 (not computed).
+///
+/// Called from the receive thread only; no allocation per datagram.
+/// </summary>
+public sealed class DatagramRecorder : IDisposable
+{
+    private const int IpHeaderBytes = 20;
+    private const int UdpHeaderBytes = 8;
+    private const int RecordHeaderBytes = 16;
+
+    private readonly FileStream _file;
+    private readonly long _startUnixNs;
+    private readonly long _startTicks;
+    private ushort _ipId;
+
+    public DatagramRecorder(string path)
+    {
+        _file = new FileStream(path, FileMode.Create, FileAccess.Write, FileShare.Read, bufferSize: 1024 * 1024);
+
+        Span<byte> hdr = stackalloc byte[PcapFormat.GlobalHeaderBytes];
+        BinaryPrimitives.WriteUInt32LittleEndian(hdr, PcapFormat.MagicNanoseconds);
+        BinaryPrimitives.WriteUInt16LittleEndian(hdr.Slice(4), 2);
+        BinaryPrimitives.WriteUInt16LittleEndian(hdr.Slice(6), 4);
+        BinaryPrimitives.WriteInt32LittleEndian(hdr.Slice(8), 0);
+        BinaryPrimitives.WriteUInt32LittleEndian(hdr.Slice(12), 0);
+        BinaryPrimitives.WriteUInt32LittleEndian(hdr.Slice(16), PcapFormat.SnapLength);
+        BinaryPrimitives.WriteUInt32LittleEndian(hdr.Slice(20), PcapFormat.LinkTypeRaw);
+        _file.Write(hdr);
+
+        _startUnixNs = (DateTime.UtcNow - DateTime.UnixEpoch).Ticks * 100;
+        _startTicks = Stopwatch.GetTimestamp();
+    }
+
+    public long Datagrams { get; private set; }
+
+    /// <param name="from">IPv4 sender as filled in by ReceiveFromAsync.</param>
+    /// <param name="localPort">UDP destination port written to the capture.</param>
+    public void Record(ReadOnlySpan<byte> datagram, SocketAddress from, int localPort)
+    {
+        int captured = Math.Min(datagram.Length, PcapFormat.SnapLength - IpHeaderBytes - UdpHeaderBytes);
+        int ipLength = IpHeaderBytes + UdpHeaderBytes + datagram.Length;
+
+        long ns = _startUnixNs + Stopwatch.GetElapsedTime(_startTicks).Ticks * 100;
+
+        Span<byte> hdr = stackalloc byte[RecordHeaderBytes + IpHeaderBytes + UdpHeaderBytes];
+        BinaryPrimitives.WriteUInt32LittleEndian(hdr, (uint)(ns / 1_000_000_000));
+        BinaryPrimitives.WriteUInt32LittleEndian(hdr.Slice(4), (uint)(ns % 1_000_000_000));
+        BinaryPrimitives.WriteUInt32LittleEndian(hdr.Slice(8), (uint)(IpHeaderBytes + UdpHeaderBytes + captured));
+        BinaryPrimitives.WriteUInt32LittleEndian(hdr.Slice(12), (uint)ipLength);
+
+        Span<byte> ip = hdr.Slice(RecordHeaderBytes, IpHeaderBytes);
+        ip.Clear();
+        ip[0] = 0x45;
+        BinaryPrimitives.WriteUInt16BigEndian(ip.Slice(2), (ushort)ipLength);
+        BinaryPrimitives.WriteUInt16BigEndian(ip.Slice(4), _ipId++);
+        ip[8] = 64;
+        ip[9] = (byte)ProtocolType.Udp;
+        if (from.Family == AddressFamily.InterNetwork)
+        {
+            // SocketAddress (IPv4): family(2) port(2, BE) addr(4)
+            ip[12] = from[4];
+            ip[13] = from[5];
+            ip[14] = from[6];
+            ip[15] = from[7];
+        }
+        BinaryPrimitives.WriteUInt16BigEndian(ip.Slice(10), PcapFormat.Ipv4HeaderChecksum(ip));
+
+        Span<byte> udp = hdr.Slice(RecordHeaderBytes + IpHeaderBytes, UdpHeaderBytes);
+        udp[0] = from.Family == AddressFamily.InterNetwork ? from[2] : (byte)0;
+        udp[1] = from.Family == AddressFamily.InterNetwork ? from[3] : (byte)0;
+        BinaryPrimitives.WriteUInt16BigEndian(udp.Slice(2), (ushort)localPort);
+        BinaryPrimitives.WriteUInt16BigEndian(udp.Slice(4), (ushort)(UdpHeaderBytes + datagram.Length));
+        BinaryPrimitives.WriteUInt16BigEndian(udp.Slice(6), 0);
+
+        _file.Write(hdr);
+        _file.Write(datagram.Slice(0, captured));
+        Datagrams++;
+    }
+
+    public void Flush()
+    {
+        _file.Flush();
+    }
+
+    public void Dispose()
+    {
+        _file.Dispose();
+    }
+}
@@ -0,0 +1,201 @@
+using System.Buffers.Binary;
+using System.Net;
+
+namespace UdpPhotoReceiver.Core;
+
+/// <summary>
+/// One UDP datagram from a capture. <see cref="TimestampNs"/> is Unix time in nanoseconds.
+/// </summary>
+public readonly record struct RecordedDatagram(long TimestampNs, IPEndPoint Source, int DestinationPort, byte[] Payload);
+
+/// <summary>
+/// Reads IPv4/UDP datagrams back out of a pcap file: our own recordings
+/// (<see cref="DatagramRecorder"/>) as well as tcpdump/Wireshark captures
+/// (Ethernet, raw IP, Linux cooked v1/v2, BSD loopback; µs or ns timestamps, either byte order).
+/// Other traffic, IP fragments and truncated packets are skipped.
+/// </summary>
+public static class DatagramRecording
+{
+    /// <param name="destinationPort">Only datagrams to this UDP port (null = all).</param>
+    public static IEnumerable<RecordedDatagram> Read(string path, int? destinationPort = null)
+    {
+        using var file = new FileStream(path, FileMode.Open, FileAccess.Read, FileShare.Read, bufferSize: 1024 * 1024);
+
+        var global = new byte[PcapFormat.GlobalHeaderBytes];
+        file.ReadExactly(global);
+
+        uint magic = BinaryPrimitives.ReadUInt32LittleEndian(global);
+        bool bigEndian;
+        bool nanoseconds;
+        switch (magic)
+        {
+            case PcapFormat.MagicMicroseconds: bigEndian = false; nanoseconds = false; break;
+            case PcapFormat.MagicNanoseconds: bigEndian = false; nanoseconds = true; break;
+            case 0xD4C3B2A1: bigEndian = true; nanoseconds = false; break;
+            case 0x4D3CB2A1: bigEndian = true; nanoseconds = true; break;
+            default: throw new InvalidDataException($"{path}: not a pcap file (magic 0x{magic:X8}; pcapng is not supported)");
+        }
+
+        uint linkType = ReadU32(global.AsSpan(20), bigEndian) & 0xFFFF;
+
+        var recordHeader = new byte[16];
+        byte[] packet = new byte[PcapFormat.SnapLength];
+        while (file.ReadAtLeast(recordHeader, recordHeader.Length, throwOnEndOfStream: false) == recordHeader.Length)
+        {
+            long sec = ReadU32(recordHeader, bigEndian);
+            long frac = ReadU32(recordHeader.AsSpan(4), bigEndian);
+            int inclLen = (int)ReadU32(recordHeader.AsSpan(8), bigEndian);
+            if (inclLen < 0 || inclLen > 256 * 1024)
+            {
+                throw new InvalidDataException($"{path}: corrupt record length {inclLen}");
+            }
+            if (packet.Length < inclLen)
+            {
+                packet = new byte[inclLen];
+            }
+            if (file.ReadAtLeast(packet.AsSpan(0, inclLen), inclLen, throwOnEndOfStream: false) < inclLen)
+            {
+                yield break; // capture cut off mid-record
+            }
+
+            if (!TryParseUdp(packet.AsSpan(0, inclLen), linkType, out IPEndPoint? source, out int dstPort, out int payloadOffset, out int payloadLength))
+            {
+                continue;
+            }
+            if (destinationPort.HasValue && dstPort != destinationPort.Value)
+            {
+                continue;
+            }
+
+            long ns = sec * 1_000_000_000 + (nanoseconds ? frac : frac * 1000);
+            yield return new RecordedDatagram(ns, source!, dstPort, packet.AsSpan(payloadOffset, payloadLength).ToArray());
+        }
+    }
+
+    private static bool TryParseUdp(ReadOnlySpan<byte> pkt, uint linkType, out IPEndPoint? source, out int dstPort,
+        out int payloadOffset, out int payloadLength)
+    {
+        source = null;
+        dstPort = 0;
+        payloadOffset = 0;
+        payloadLength = 0;
+
+        int ip;
+        switch (linkType)
+        {
+            case PcapFormat.LinkTypeEthernet:
+            {
+                if (pkt.Length < 14)
+                {
+                    return false;
+                }
+                int etherType = BinaryPrimitives.ReadUInt16BigEndian(pkt.Slice(12));
+                ip = 14;
+                if (etherType == 0x8100 && pkt.Length >= 18)
+                {
+                    etherType = BinaryPrimitives.ReadUInt16BigEndian(pkt.Slice(16));
+                    ip = 18;
+                }
+                if (etherType != 0x0800)
+                {
+                    return false;
+                }
+                break;
+            }
+            case PcapFormat.LinkTypeRaw:
+            case PcapFormat.LinkTypeIpv4:
+                ip = 0;
+                break;
+            case PcapFormat.LinkTypeLinuxSll:
+                if (pkt.Length < 16 || BinaryPrimitives.ReadUInt16BigEndian(pkt.Slice(14)) != 0x0800)
+                {
+                    return false;
+                }
+                ip = 16;
+                break;
+            case PcapFormat.LinkTypeLinuxSll2:
+                if (pkt.Length < 20 || BinaryPrimitives.ReadUInt16BigEndian(pkt) != 0x0800)
+                {
+                    return false;
+                }
+                ip = 20;
+                break;
+            case PcapFormat.LinkTypeNull:
+                // 4-byte address family in the capturing host's byte order; AF_INET is 2 everywhere.
+                if (pkt.Length < 4 || (pkt[0] != 2 && pkt[3] != 2))
+                {
+                    return false;
+                }
+                ip = 4;
+                break;
+            default:
+                return false;
+        }
+
+        ReadOnlySpan<byte> v4 = pkt.Slice(ip);
+        if (v4.Length < 20 || (v4[0] >> 4) != 4 || v4[9] != 17)
+        {
+            return false;
+        }
+        int ihl = (v4[0] & 0x0F) * 4;
+        int totalLength = BinaryPrimitives.ReadUInt16BigEndian(v4.Slice(2));
+        if ((BinaryPrimitives.ReadUInt16BigEndian(v4.Slice(6)) & 0x3FFF) != 0)
+        {
+            return false; // fragment (MF set or non-zero offset)
+        }
+        if (ihl < 20 || v4.Length < ihl + 8)
+        {
+            return false;
+        }
+
+        ReadOnlySpan<byte> udp = v4.Slice(ihl);
+        int udpLength = BinaryPrimitives.ReadUInt16BigEndian(udp.Slice(4));
+        int available = Math.Min(v4.Length, totalLength) - ihl;
+        if (udpLength < 8 || udpLength > available)
+        {
+            return false; // truncated by snaplen
+        }
+
+        source = new IPEndPoint(new IPAddress(v4.Slice(12, 4)), BinaryPrimitives.ReadUInt16BigEndian(udp));
+        dstPort = BinaryPrimitives.ReadUInt16BigEndian(udp.Slice(2));
+        payloadOffset = ip + ihl + 8;
+        payloadLength = udpLength - 8;
+        return true;
+    }
+
+    private static uint ReadU32(ReadOnlySpan<byte> b, bool bigEndian) =>
+        bigEndian ? BinaryPrimitives.ReadUInt32BigEndian(b) : BinaryPrimitives.ReadUInt32LittleEndian(b);
+}
+
+internal static class PcapFormat
+{
+    public const int GlobalHeaderBytes = 24;
+    public const int SnapLength = 65535;
+
+    public const uint MagicMicroseconds = 0xA1B2C3D4;
+    public const uint MagicNanoseconds = 0xA1B23C4D;
+
+    public const uint LinkTypeNull = 0;
+    public const uint LinkTypeEthernet = 1;
+    public const uint LinkTypeRaw = 101;
+    public const uint LinkTypeLinuxSll = 113;
+    public const uint LinkTypeIpv4 = 228;
+    public const uint LinkTypeLinuxSll2 = 276;
+
+    public static ushort Ipv4HeaderChecksum(ReadOnlySpan<byte> header)
+    {
+        uint sum = 0;
+        for (int i = 0; i + 1 < header.Length; i += 2)
+        {
+            if (i != 10)
+            {
+                sum += BinaryPrimitives.ReadUInt16BigEndian(header.Slice(i));
+            }
+        }
+        while ((sum >> 16) != 0)
+        {
+            sum = (sum & 0xFFFF) + (sum >> 16);
+        }
+        return (ushort)~sum;
+    }
+}
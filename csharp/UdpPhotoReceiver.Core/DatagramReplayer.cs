@@ -0,0 +1,76 @@
+using System.Diagnostics;
+using System.Net;
+using System.Net.Sockets;
+
+namespace UdpPhotoReceiver.Core;
+
+/// <summary>
+/// Plays a recording back with its original inter-arrival times scaled by a speed factor:
+/// 1 = real time, N = N times faster, <see cref="MaxSpeed"/> = as fast as the sink accepts.
+/// </summary>
+public static class DatagramReplayer
+{
+    public const double MaxSpeed = double.PositiveInfinity;
+
+    // Below this, Task.Delay overshoots (timer resolution); spin instead.
+    private static readonly TimeSpan SpinThreshold = TimeSpan.FromMilliseconds(2);
+
+    /// <summary>
+    /// Hands each datagram to <paramref name="sink"/> on schedule. Returns the number replayed.
+    /// At <see cref="MaxSpeed"/> this never yields, so feeding
+    /// <see cref="UdpFrameReceiver.ProcessDatagram"/> gives the same frames on every run.
+    /// </summary>
+    public static async Task<long> ReplayAsync(IEnumerable<RecordedDatagram> datagrams, Action<RecordedDatagram> sink,
+        double speed, CancellationToken cancellationToken = default)
+    {
+        if (!(speed > 0))
+        {
+            throw new ArgumentOutOfRangeException(nameof(speed), speed, "speed must be > 0");
+        }
+
+        long count = 0;
+        long firstNs = 0;
+        long startTicks = Stopwatch.GetTimestamp();
+
+        foreach (RecordedDatagram d in datagrams)
+        {
+            cancellationToken.ThrowIfCancellationRequested();
+
+            if (count == 0)
+            {
+                firstNs = d.TimestampNs;
+                startTicks = Stopwatch.GetTimestamp();
+            }
+            else if (!double.IsPositiveInfinity(speed))
+            {
+                var due = TimeSpan.FromTicks((long)((d.TimestampNs - firstNs) / 100 / speed));
+                TimeSpan wait = due - Stopwatch.GetElapsedTime(startTicks);
+                if (wait > SpinThreshold)
+                {
+                    await Task.Delay(wait - SpinThreshold, cancellationToken).ConfigureAwait(false);
+                }
+                while (Stopwatch.GetElapsedTime(startTicks) < due)
+                {
+                    Thread.SpinWait(20);
+                }
+            }
+
+            sink(d);
+            count++;
+        }
+        return count;
+    }
+
+    /// <summary>
+    /// Re-sends a recording to <paramref name="target"/> (load-testing another receiver).
+    /// </summary>
+    public static async Task<long> SendAsync(IEnumerable<RecordedDatagram> datagrams, IPEndPoint target,
+        double speed, CancellationToken cancellationToken = default)
+    {
+        using var socket = new Socket(target.AddressFamily, SocketType.Dgram, ProtocolType.Udp);
+        socket.SendBufferSize = 4 * 1024 * 1024;
+        socket.Connect(target);
+
+        return await ReplayAsync(datagrams, d => socket.Send(d.Payload), speed, cancellationToken).ConfigureAwait(false);
+    }
+}
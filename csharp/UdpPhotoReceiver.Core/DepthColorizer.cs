@@ -0,0 +1,200 @@
+using System.Runtime.CompilerServices;
+using System.Runtime.Intrinsics;
+using System.Runtime.Intrinsics.X86;
+
+namespace UdpPhotoReceiver.Core;
+
+/// <summary>
+/// 8-bit depth frame -> 24bpp BGR. Platform-neutral (no System.Drawing), so the
+/// WinForms viewer and headless tools share the same pixel path.
+///
+/// Range remap and colormap are folded into one 256-entry composite LUT (BGR0 per entry),
+/// rebuilt only when mode or range changes, so a pixel is one table lookup. With AVX2 the
+/// lookup is a 8-wide gather; large frames are split into row bands rendered in parallel.
+/// </summary>
+public sealed class DepthColorizer
+{
+    private readonly byte[] _bgrLut;
+
+    // depth -> B | G << 8 | R << 16 (little-endian: stores as B,G,R,x)
+    private readonly uint[] _composite = new uint[256];
+    private bool _compositeValid;
+    private RenderMode _compositeMode;
+    private byte _compositeMin;
+    private byte _compositeMax;
+
+    public DepthColorizer()
+    {
+        _bgrLut = JetColormap.CreateBgrLut256();
+    }
+
+    /// <summary>
+    /// Frames with at least this many pixels are rendered with one task per row band.
+    /// Set to <see cref="int.MaxValue"/> to always stay on the calling thread.
+    /// </summary>
+    public int ParallelThresholdPixels { get; set; } = 640 * 480;
+
+    /// <summary>
+    /// Writes width*height BGR pixels into <paramref name="dst"/> (row pitch <paramref name="dstStride"/> bytes).
+    /// Returns false if either buffer is too small.
+    /// </summary>
+    public unsafe bool RenderBgr24(ReadOnlySpan<byte> frameData, int width, int height, Span<byte> dst, int dstStride,
+        RenderMode mode, byte rangeMin, byte rangeMax)
+    {
+        int expected = width * height;
+        if (width <= 0 || height <= 0 || frameData.Length < expected)
+        {
+            return false;
+        }
+        if (dstStride < width * 3 || dst.Length < (height - 1) * dstStride + width * 3)
+        {
+            return false;
+        }
+
+        if (rangeMax <= rangeMin)
+        {
+            // Avoid divide-by-zero and undefined behavior; treat as identity.
+            rangeMin = 0;
+            rangeMax = 255;
+        }
+        EnsureComposite(mode, rangeMin, rangeMax);
+
+        fixed (byte* src = frameData)
+        fixed (byte* dstBase = dst)
+        fixed (uint* lut = _composite)
+        {
+            int bands = expected >= ParallelThresholdPixels ? Math.Min(Environment.ProcessorCount, height / 16) : 1;
+            if (bands <= 1)
+            {
+                RenderRows(src, dstBase, lut, width, dstStride, 0, height);
+                return true;
+            }
+
+            // Pointers cannot be captured by the lambda directly; the buffers stay pinned
+            // until Parallel.For returns.
+            nint s = (nint)src;
+            nint d = (nint)dstBase;
+            nint l = (nint)lut;
+            Parallel.For(0, bands, b =>
+            {
+                int y0 = (int)((long)height * b / bands);
+                int y1 = (int)((long)height * (b + 1) / bands);
+                RenderRows((byte*)s, (byte*)d, (uint*)l, width, dstStride, y0, y1);
+            });
+        }
+        return true;
+    }
+
+    public static byte RemapToByteRange(byte value, byte rangeMin, byte rangeMax)
+    {
+        if (rangeMin == 0 && rangeMax == 255)
+        {
+            return value;
+        }
+
+        if (value <= rangeMin)
+        {
+            return 0;
+        }
+        if (value >= rangeMax)
+        {
+            return 255;
+        }
+
+        int v = value;
+        int min = rangeMin;
+        int max = rangeMax;
+        int scaled = (v - min) * 255 / (max - min);
+        if (scaled < 0)
+        {
+            scaled = 0;
+        }
+        else if (scaled > 255)
+        {
+            scaled = 255;
+        }
+        return (byte)scaled;
+    }
+
+    private void EnsureComposite(RenderMode mode, byte rangeMin, byte rangeMax)
+    {
+        if (_compositeValid && _compositeMode == mode && _compositeMin == rangeMin && _compositeMax == rangeMax)
+        {
+            return;
+        }
+
+        for (int i = 0; i < 256; i++)
+        {
+            byte d = RemapToByteRange((byte)i, rangeMin, rangeMax);
+            uint b, g, r;
+            if (mode == RenderMode.Grayscale)
+            {
+                b = g = r = d;
+            }
+            else
+            {
+                int lut = d * 3;
+                b = _bgrLut[lut + 0];
+                g = _bgrLut[lut + 1];
+                r = _bgrLut[lut + 2];
+            }
+            _composite[i] = b | (g << 8) | (r << 16);
+        }
+
+        _compositeMode = mode;
+        _compositeMin = rangeMin;
+        _compositeMax = rangeMax;
+        _compositeValid = true;
+    }
+
+    private static unsafe void RenderRows(byte* src, byte* dst, uint* lut, int width, int dstStride, int y0, int y1)
+    {
+        for (int y = y0; y < y1; y++)
+        {
+            byte* s = src + (long)y * width;
+            byte* d = dst + (long)y * dstStride;
+
+            int x = Avx2.IsSupported ? RenderRowAvx2(s, d, lut, width) : 0;
+
+            // 4-byte stores overlap by one; the spare byte is overwritten by the next pixel.
+            for (; x < width - 1; x++)
+            {
+                Unsafe.WriteUnaligned(d + x * 3, lut[s[x]]);
+            }
+            if (x < width)
+            {
+                uint c = lut[s[x]];
+                byte* p = d + x * 3;
+                p[0] = (byte)c;
+                p[1] = (byte)(c >> 8);
+                p[2] = (byte)(c >> 16);
+            }
+        }
+    }
+
+    /// <summary>
+    /// 8 pixels per step: zero-extend 8 depths to int32, gather their BGR0 entries, drop the
+    /// pad bytes per 128-bit lane, store 12 + 12 bytes. Returns the first pixel not written.
+    /// </summary>
+    private static unsafe int RenderRowAvx2(byte* src, byte* dst, uint* lut, int width)
+    {
+        Vector256<byte> pack = Vector256.Create(
+            (byte)0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 0x80, 0x80, 0x80, 0x80,
+            0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, 0x80, 0x80, 0x80, 0x80);
+
+        int x = 0;
+        // Each 16-byte store spills 4 bytes past its 12 pixels' worth, so stop while the
+        // spill still lands inside the row (the tail loop rewrites it).
+        for (; x + 10 <= width; x += 8)
+        {
+            Vector256<int> idx = Avx2.ConvertToVector256Int32(src + x);
+            Vector256<byte> bgr0 = Avx2.GatherVector256((int*)lut, idx, 4).AsByte();
+            Vector256<byte> bgr = Avx2.Shuffle(bgr0, pack);
+
+            byte* d = dst + x * 3;
+            bgr.GetLower().Store(d);
+            bgr.GetUpper().Store(d + 12);
+        }
+        return x;
+    }
+}
@@ -0,0 +1,135 @@
+using System.Diagnostics;
+
+namespace UdpPhotoReceiver.Core;
+
+/// <summary>
+/// Reassembles one frame. Each payload is copied once, at its chunk_offset, straight into a
+/// pooled frame buffer; received chunks are tracked in a bitmap. Nothing is allocated per
+/// frame once the pool and the bitmap have grown to the stream's frame size.
+/// </summary>
+public sealed class FrameAssembler
+{
+    private readonly FramePool _pool;
+    private FrameLease? _frame;
+    private ulong[] _bitmap = Array.Empty<ulong>();
+    private int _totalChunks;
+    private int _totalSize;
+    private int _receivedCount;
+    private readonly Stopwatch _frameStopwatch = new();
+
+    public FrameAssembler()
+        : this(FramePool.Shared)
+    {
+    }
+
+    public FrameAssembler(FramePool pool)
+    {
+        _pool = pool;
+    }
+
+    public bool InProgress => _frame is not null;
+
+    public bool IsComplete => _frame is not null && _receivedCount == _totalChunks;
+
+    public bool HasAnyChunk => _frame is not null && _receivedCount > 0;
+
+    public TimeSpan Elapsed => _frameStopwatch.Elapsed;
+    public int TotalChunks => _totalChunks;
+    public int ReceivedChunks => _receivedCount;
+    public int TotalSize => _totalSize;
+
+    /// <summary>
+    /// Frame sequence this slot is assembling (set by the caller, see <see cref="ReassemblyWindow"/>).
+    /// </summary>
+    public uint Sequence { get; private set; }
+
+    public void StartNew(int totalChunks, int totalSize, uint sequence = 0)
+    {
+        Reset();
+        if (totalChunks <= 0 || totalSize <= 0)
+        {
+            return;
+        }
+
+        int words = (totalChunks + 63) >> 6;
+        if (_bitmap.Length < words)
+        {
+            _bitmap = new ulong[words];
+        }
+        else
+        {
+            Array.Clear(_bitmap, 0, words);
+        }
+
+        _totalChunks = totalChunks;
+        _totalSize = totalSize;
+        Sequence = sequence;
+        _frame = _pool.Rent(totalSize);
+        // Chunks that never arrive must read as zero. Offsets come from the sender, so clear
+        // up front rather than guessing gap positions later (a memset, not a copy).
+        _frame.Span.Clear();
+        _frameStopwatch.Restart();
+    }
+
+    /// <summary>
+    /// Copies <paramref name="chunkData"/> to <paramref name="chunkOffset"/> in the frame.
+    /// Returns false for duplicates and out-of-range chunks.
+    /// </summary>
+    public bool AddChunk(int chunkIndex, int chunkOffset, ReadOnlySpan<byte> chunkData)
+    {
+        if (_frame is null)
+        {
+            return false;
+        }
+        if (chunkIndex < 0 || chunkIndex >= _totalChunks)
+        {
+            return false;
+        }
+        if (chunkOffset < 0 || chunkOffset >= _totalSize || chunkData.Length == 0)
+        {
+            return false;
+        }
+
+        ref ulong word = ref _bitmap[chunkIndex >> 6];
+        ulong bit = 1UL << (chunkIndex & 63);
+        if ((word & bit) != 0)
+        {
+            return false;
+        }
+
+        int copyLen = Math.Min(chunkData.Length, _totalSize - chunkOffset);
+        chunkData.Slice(0, copyLen).CopyTo(_frame.Span.Slice(chunkOffset));
+        word |= bit;
+        _receivedCount++;
+        return true;
+    }
+
+    /// <summary>
+    /// Hands the frame buffer to the caller (who must Dispose it) and resets the assembler.
+    /// The received-chunk bitmap travels with it (<see cref="FrameLease.ChunkMask"/>).
+    /// </summary>
+    public FrameLease? Detach()
+    {
+        FrameLease? frame = _frame;
+        if (frame is null)
+        {
+            return null;
+        }
+
+        frame.SetChunkMask(_bitmap.AsSpan(0, (_totalChunks + 63) >> 6));
+
+        _frame = null;
+        Reset();
+        return frame;
+    }
+
+    public void Reset()
+    {
+        _frame?.Dispose();
+        _frame = null;
+        _totalChunks = 0;
+        _totalSize = 0;
+        _receivedCount = 0;
+        _frameStopwatch.Reset();
+    }
+}
@@ -0,0 +1,64 @@
+namespace UdpPhotoReceiver.Core;
+
+public static class FrameGeometry
+{
+    public const int DefaultWidth = 320;
+    public const int DefaultHeight = 240;
+
+    /// <summary>
+    /// The stream header carries only total_size; guess width/height from it.
+    /// </summary>
+    public static (int width, int height) InferFromTotalSize(int totalSize, int defaultW = DefaultWidth, int defaultH = DefaultHeight)
+    {
+        if (totalSize <= 0)
+        {
+            return (defaultW, defaultH);
+        }
+
+        // Known cases used in this repo/tooling.
+        if (totalSize == 320 * 240)
+        {
+            return (320, 240);
+        }
+        if (totalSize == 256 * 128)
+        {
+            return (256, 128);
+        }
+        if (totalSize == 256 * 256)
+        {
+            return (256, 256);
+        }
+        if (totalSize == 128 * 128)
+        {
+            return (128, 128);
+        }
+
+        // Fallback: try common widths.
+        if (totalSize % 320 == 0)
+        {
+            int h = totalSize / 320;
+            if (h >= 1 && h <= 240)
+            {
+                return (320, h);
+            }
+        }
+        if (totalSize % 256 == 0)
+        {
+            int h = totalSize / 256;
+            if (h >= 1 && h <= 512)
+            {
+                return (256, h);
+            }
+        }
+        if (totalSize % 128 == 0)
+        {
+            int h = totalSize / 128;
+            if (h >= 1 && h <= 512)
+            {
+                return (128, h);
+            }
+        }
+
+        return (defaultW, defaultH);
+    }
+}
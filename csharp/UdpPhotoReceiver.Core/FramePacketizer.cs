@@ -0,0 +1,41 @@
+namespace UdpPhotoReceiver.Core;
+
+/// <summary>
+/// Splits a frame into datagrams the same way the firmware sender does
+/// (benchmarks, synthetic streams, loopback checks).
+/// </summary>
+public static class FramePacketizer
+{
+    public const int DefaultChunkSize = 512;
+
+    /// <param name="frameSeq">null = v1 header (no frame_seq), otherwise v2 header.</param>
+    public static byte[][] Packetize(ReadOnlySpan<byte> frame, int chunkSize = DefaultChunkSize, uint? frameSeq = null)
+    {
+        ArgumentOutOfRangeException.ThrowIfNegativeOrZero(chunkSize);
+        ArgumentOutOfRangeException.ThrowIfGreaterThan(chunkSize, ushort.MaxValue);
+
+        int totalChunks = (frame.Length + chunkSize - 1) / chunkSize;
+        var datagrams = new byte[totalChunks][];
+        for (int i = 0; i < totalChunks; i++)
+        {
+            int offset = i * chunkSize;
+            int size = Math.Min(chunkSize, frame.Length - offset);
+            var header = new PhotoChunkHeader(
+                TotalSize: (uint)frame.Length,
+                ChunkIndex: (uint)i,
+                TotalChunks: (uint)totalChunks,
+                ChunkOffset: (uint)offset,
+                ChunkDataSize: (ushort)size,
+                Checksum: 0,
+                HasFrameSeq: frameSeq.HasValue,
+                FrameSeq: frameSeq.GetValueOrDefault());
+
+            var datagram = new byte[header.SizeBytes + size];
+            header.WriteTo(datagram);
+            frame.Slice(offset, size).CopyTo(datagram.AsSpan(header.SizeBytes));
+
+            datagrams[i] = datagram;
+        }
+        return datagrams;
+    }
+}
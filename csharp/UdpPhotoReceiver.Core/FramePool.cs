@@ -0,0 +1,129 @@
+using System.Buffers;
+
+namespace UdpPhotoReceiver.Core;
+
+/// <summary>
+/// Frame buffers (ArrayPool) plus their <see cref="IMemoryOwner{T}"/> wrappers, both recycled,
+/// so handing a frame to a consumer costs no GC allocation once warmed up.
+/// </summary>
+public sealed class FramePool
+{
+    public static FramePool Shared { get; } = new();
+
+    // Leases parked for reuse; beyond this they are left to the GC.
+    private const int MaxIdleLeases = 32;
+
+    private readonly ArrayPool<byte> _arrays;
+    private readonly Stack<FrameLease> _idle = new(MaxIdleLeases);
+    private readonly object _lock = new();
+
+    public FramePool()
+        : this(ArrayPool<byte>.Shared)
+    {
+    }
+
+    public FramePool(ArrayPool<byte> arrays)
+    {
+        _arrays = arrays;
+    }
+
+    /// <summary>
+    /// Rents a buffer of at least <paramref name="length"/> bytes. Contents are undefined.
+    /// </summary>
+    public FrameLease Rent(int length)
+    {
+        FrameLease? lease = null;
+        lock (_lock)
+        {
+            _idle.TryPop(out lease);
+        }
+        lease ??= new FrameLease(this);
+        lease.Attach(_arrays.Rent(length), length);
+        return lease;
+    }
+
+    internal void Return(FrameLease lease, byte[] array)
+    {
+        _arrays.Return(array);
+        lock (_lock)
+        {
+            if (_idle.Count < MaxIdleLeases)
+            {
+                _idle.Push(lease);
+            }
+        }
+    }
+}
+
+/// <summary>
+/// One pooled frame buffer. Dispose exactly once when done; the memory (and this object)
+/// is reused afterwards, so do not keep <see cref="Memory"/> past Dispose.
+/// </summary>
+public sealed class FrameLease : IMemoryOwner<byte>
+{
+    private readonly FramePool _pool;
+    private byte[]? _array;
+    private int _length;
+    private ulong[] _mask = Array.Empty<ulong>();
+    private int _maskWords;
+
+    internal FrameLease(FramePool pool)
+    {
+        _pool = pool;
+    }
+
+    public int Length => _length;
+
+    public Memory<byte> Memory
+    {
+        get
+        {
+            ObjectDisposedException.ThrowIf(_array is null, this);
+            return _array.AsMemory(0, _length);
+        }
+    }
+
+    public Span<byte> Span
+    {
+        get
+        {
+            ObjectDisposedException.ThrowIf(_array is null, this);
+            return _array.AsSpan(0, _length);
+        }
+    }
+
+    /// <summary>
+    /// Bit i set = chunk i arrived (LSB first within each word). Valid until Dispose.
+    /// </summary>
+    public ReadOnlySpan<ulong> ChunkMask => _mask.AsSpan(0, _maskWords);
+
+    internal void Attach(byte[] array, int length)
+    {
+        _array = array;
+        _length = length;
+        _maskWords = 0;
+    }
+
+    internal void SetChunkMask(ReadOnlySpan<ulong> mask)
+    {
+        if (_mask.Length < mask.Length)
+        {
+            _mask = new ulong[mask.Length];
+        }
+        mask.CopyTo(_mask);
+        _maskWords = mask.Length;
+    }
+
+    public void Dispose()
+    {
+        byte[]? array = _array;
+        if (array is null)
+        {
+            return;
+        }
+        _array = null;
+        _length = 0;
+        _maskWords = 0;
+        _pool.Return(this, array);
+    }
+}
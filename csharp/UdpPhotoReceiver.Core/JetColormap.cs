@@ -1,6 +1,4 @@
-using System.Drawing;
-
-namespace UdpPhotoReceiver;
+namespace UdpPhotoReceiver.Core;
 
 public static class JetColormap
 {
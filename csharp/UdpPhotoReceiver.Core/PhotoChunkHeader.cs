@@ -0,0 +1,97 @@
+using System.Buffers.Binary;
+
+namespace UdpPhotoReceiver.Core;
+
+/// <summary>
+/// Chunk header sent by the firmware (udp_photo_header_t in main_thread1_entry.c), little-endian.
+/// v1: 24 bytes, magic 0x12345678. v2 (UDP_PHOTO_HEADER_SEQ=1): 28 bytes, magic 0x12345679,
+/// with frame_seq after chunk_offset.
+/// </summary>
+public readonly record struct PhotoChunkHeader(
+    uint TotalSize,
+    uint ChunkIndex,
+    uint TotalChunks,
+    uint ChunkOffset,
+    ushort ChunkDataSize,
+    ushort Checksum,
+    bool HasFrameSeq = false,
+    uint FrameSeq = 0)
+{
+    public const uint MagicV1 = 0x12345678;
+    public const uint MagicV2 = 0x12345679;
+    public const int SizeBytesV1 = 24;
+    public const int SizeBytesV2 = 28;
+
+    public int SizeBytes => HasFrameSeq ? SizeBytesV2 : SizeBytesV1;
+
+    /// <summary>
+    /// Parses the header; false if the datagram is too short or the magic does not match.
+    /// </summary>
+    public static bool TryRead(ReadOnlySpan<byte> datagram, out PhotoChunkHeader header)
+    {
+        header = default;
+        if (datagram.Length < SizeBytesV1)
+        {
+            return false;
+        }
+
+        uint magic = BinaryPrimitives.ReadUInt32LittleEndian(datagram);
+        bool v2 = magic == MagicV2;
+        if (!v2 && magic != MagicV1)
+        {
+            return false;
+        }
+        if (v2 && datagram.Length < SizeBytesV2)
+        {
+            return false;
+        }
+
+        int tail = v2 ? 24 : 20; // chunk_data_size, checksum
+        header = new PhotoChunkHeader(
+            TotalSize: BinaryPrimitives.ReadUInt32LittleEndian(datagram.Slice(4, 4)),
+            ChunkIndex: BinaryPrimitives.ReadUInt32LittleEndian(datagram.Slice(8, 4)),
+            TotalChunks: BinaryPrimitives.ReadUInt32LittleEndian(datagram.Slice(12, 4)),
+            ChunkOffset: BinaryPrimitives.ReadUInt32LittleEndian(datagram.Slice(16, 4)),
+            ChunkDataSize: BinaryPrimitives.ReadUInt16LittleEndian(datagram.Slice(tail, 2)),
+            Checksum: BinaryPrimitives.ReadUInt16LittleEndian(datagram.Slice(tail + 2, 2)),
+            HasFrameSeq: v2,
+            FrameSeq: v2 ? BinaryPrimitives.ReadUInt32LittleEndian(datagram.Slice(20, 4)) : 0);
+        return true;
+    }
+
+    /// <summary>
+    /// Writes <see cref="SizeBytes"/> bytes (checksum recomputed, as calc_header_checksum does).
+    /// </summary>
+    public void WriteTo(Span<byte> dst)
+    {
+        int tail = HasFrameSeq ? 24 : 20;
+        BinaryPrimitives.WriteUInt32LittleEndian(dst, HasFrameSeq ? MagicV2 : MagicV1);
+        BinaryPrimitives.WriteUInt32LittleEndian(dst.Slice(4, 4), TotalSize);
+        BinaryPrimitives.WriteUInt32LittleEndian(dst.Slice(8, 4), ChunkIndex);
+        BinaryPrimitives.WriteUInt32LittleEndian(dst.Slice(12, 4), TotalChunks);
+        BinaryPrimitives.WriteUInt32LittleEndian(dst.Slice(16, 4), ChunkOffset);
+        if (HasFrameSeq)
+        {
+            BinaryPrimitives.WriteUInt32LittleEndian(dst.Slice(20, 4), FrameSeq);
+        }
+        BinaryPrimitives.WriteUInt16LittleEndian(dst.Slice(tail, 2), ChunkDataSize);
+        BinaryPrimitives.WriteUInt16LittleEndian(dst.Slice(tail + 2, 2), ComputeChecksum(dst.Slice(0, SizeBytes)));
+    }
+
+    /// <summary>
+    /// One's-complement sum of every half-word except the trailing checksum.
+    /// </summary>
+    public static ushort ComputeChecksum(ReadOnlySpan<byte> header)
+    {
+        uint sum = 0;
+        for (int i = 0; i < header.Length - 2; i += 2)
+        {
+            sum += BinaryPrimitives.ReadUInt16LittleEndian(header.Slice(i, 2));
+        }
+        while ((sum >> 16) != 0)
+        {
+            sum = (sum & 0xFFFF) + (sum >> 16);
+        }
+        return (ushort)~sum;
+    }
+}
@@ -0,0 +1,211 @@
+namespace UdpPhotoReceiver.Core;
+
+/// <summary>
+/// Reassembles up to N frames at once, keyed by frame sequence, and emits them strictly in
+/// sequence order. A frame goes out when it is complete (and no older frame is still in flight),
+/// when its deadline passes, or when a newer frame needs its slot. Chunks for frames already
+/// emitted are dropped as late; sequences that never showed a single chunk are counted as lost.
+///
+/// v1 headers carry no frame_seq: chunk 0 opens the next sequence, which reproduces the old
+/// single-frame behaviour.
+/// </summary>
+public sealed class ReassemblyWindow
+{
+    public const int DefaultCapacity = 4;
+
+    // A sequence this far behind the emit cursor means the sender restarted, not a late chunk.
+    private const int RestartGap = 64;
+
+    private readonly FrameAssembler[] _slots;
+    private readonly TimeSpan _deadline;
+    private readonly ReceiverStatistics _stats;
+    private readonly Action<ReceivedFrame> _emit;
+
+    private bool _started;
+    private uint _nextSeq; // lowest sequence that may still be emitted
+    private uint _legacySeq;
+
+    public ReassemblyWindow(int capacity, TimeSpan deadline, FramePool pool, ReceiverStatistics stats, Action<ReceivedFrame> emit)
+    {
+        ArgumentOutOfRangeException.ThrowIfNegativeOrZero(capacity);
+        _slots = new FrameAssembler[capacity];
+        for (int i = 0; i < capacity; i++)
+        {
+            _slots[i] = new FrameAssembler(pool);
+        }
+        _deadline = deadline;
+        _stats = stats;
+        _emit = emit;
+    }
+
+    public int Capacity => _slots.Length;
+
+    /// <summary>
+    /// Adds one chunk; may emit any number of frames. Returns false if the chunk was not used
+    /// (late, duplicate, out of range).
+    /// </summary>
+    public bool Add(in PhotoChunkHeader hdr, ReadOnlySpan<byte> payload)
+    {
+        uint seq;
+        if (hdr.HasFrameSeq)
+        {
+            seq = hdr.FrameSeq;
+        }
+        else
+        {
+            if (hdr.ChunkIndex == 0)
+            {
+                _legacySeq++;
+            }
+            seq = _legacySeq;
+        }
+
+        if (_started && SeqDiff(seq, _nextSeq) < 0)
+        {
+            if (SeqDiff(seq, _nextSeq) > -RestartGap)
+            {
+                _stats.OnLateChunk();
+                return false;
+            }
+            Flush();
+            _started = false;
+        }
+
+        FrameAssembler? slot = Find(seq);
+        if (slot is null)
+        {
+            slot = OpenSlot(seq, (int)hdr.TotalChunks, (int)hdr.TotalSize);
+            if (slot is null)
+            {
+                _stats.OnLateChunk();
+                return false;
+            }
+        }
+
+        bool added = slot.AddChunk((int)hdr.ChunkIndex, (int)hdr.ChunkOffset, payload);
+        Drain();
+        return added;
+    }
+
+    /// <summary>
+    /// Emits frames whose turn has come or whose deadline has passed. Call periodically
+    /// (the receiver calls it per datagram).
+    /// </summary>
+    public void Drain()
+    {
+        while (true)
+        {
+            FrameAssembler? oldest = Oldest();
+            if (oldest is null || !(oldest.IsComplete || oldest.Elapsed > _deadline))
+            {
+                return;
+            }
+            Emit(oldest);
+        }
+    }
+
+    /// <summary>
+    /// Emits everything still in flight, oldest first.
+    /// </summary>
+    public void Flush()
+    {
+        for (FrameAssembler? s = Oldest(); s is not null; s = Oldest())
+        {
+            Emit(s);
+        }
+    }
+
+    private FrameAssembler? OpenSlot(uint seq, int totalChunks, int totalSize)
+    {
+        while (true)
+        {
+            FrameAssembler? oldest = Oldest();
+            FrameAssembler? free = FreeSlot();
+            if (oldest is null)
+            {
+                break;
+            }
+
+            int ahead = SeqDiff(seq, oldest.Sequence);
+            if (free is not null && ahead < _slots.Length)
+            {
+                break;
+            }
+            if (ahead < 0)
+            {
+                // Older than everything in flight and no room: placing it would break order.
+                return null;
+            }
+            Emit(oldest);
+        }
+
+        FrameAssembler slot = FreeSlot()!;
+        slot.StartNew(totalChunks, totalSize, seq);
+        return slot.InProgress ? slot : null;
+    }
+
+    private void Emit(FrameAssembler slot)
+    {
+        if (!slot.HasAnyChunk)
+        {
+            slot.Reset();
+            return;
+        }
+
+        uint seq = slot.Sequence;
+        if (_started && SeqDiff(seq, _nextSeq) > 0)
+        {
+            _stats.OnFramesLost(SeqDiff(seq, _nextSeq));
+        }
+        _nextSeq = seq + 1;
+        _started = true;
+
+        int totalChunks = slot.TotalChunks;
+        int receivedChunks = slot.ReceivedChunks;
+        TimeSpan elapsed = slot.Elapsed;
+        FrameLease lease = slot.Detach()!;
+
+        var frame = new ReceivedFrame(lease, seq, totalChunks, receivedChunks, elapsed);
+        _stats.OnFrame(frame);
+        _emit(frame);
+    }
+
+    private FrameAssembler? Find(uint seq)
+    {
+        foreach (FrameAssembler s in _slots)
+        {
+            if (s.InProgress && s.Sequence == seq)
+            {
+                return s;
+            }
+        }
+        return null;
+    }
+
+    private FrameAssembler? FreeSlot()
+    {
+        foreach (FrameAssembler s in _slots)
+        {
+            if (!s.InProgress)
+            {
+                return s;
+            }
+        }
+        return null;
+    }
+
+    private FrameAssembler? Oldest()
+    {
+        FrameAssembler? oldest = null;
+        foreach (FrameAssembler s in _slots)
+        {
+            if (s.InProgress && (oldest is null || SeqDiff(s.Sequence, oldest.Sequence) < 0))
+            {
+                oldest = s;
+            }
+        }
+        return oldest;
+    }
+
+    private static int SeqDiff(uint a, uint b) => (int)(a - b);
+}
@@ -0,0 +1,30 @@
+namespace UdpPhotoReceiver.Core;
+
+/// <summary>
+/// One reconstructed frame. Missing chunks are left zero-filled in <see cref="Data"/> and
+/// cleared in <see cref="ChunkMask"/>.
+/// The buffer is pooled: the consumer owns it and must <see cref="Dispose"/> it exactly once
+/// (after which <see cref="Data"/> must not be touched).
+/// </summary>
+/// <param name="AssemblyTime">First chunk received -> frame handed out.</param>
+public readonly record struct ReceivedFrame(
+    FrameLease Lease,
+    uint Sequence,
+    int TotalChunks,
+    int ReceivedChunks,
+    TimeSpan AssemblyTime) : IDisposable
+{
+    public ReadOnlyMemory<byte> Data => Lease.Memory;
+    public bool IsComplete => ReceivedChunks == TotalChunks;
+    public int MissingChunks => TotalChunks - ReceivedChunks;
+
+    /// <summary>
+    /// Bit i set = chunk i arrived (LSB first). Valid until Dispose.
+    /// </summary>
+    public ReadOnlySpan<ulong> ChunkMask => Lease.ChunkMask;
+
+    public bool IsChunkReceived(int chunkIndex) =>
+        (uint)chunkIndex < (uint)TotalChunks && (ChunkMask[chunkIndex >> 6] & (1UL << (chunkIndex & 63))) != 0;
+
+    public void Dispose() => Lease.Dispose();
+}
@@ -0,0 +1,156 @@
+using System.Diagnostics;
+
+namespace UdpPhotoReceiver.Core;
+
+/// <summary>
+/// Counters updated by the receive loop and sampled by another thread
+/// (status bar / console once per second). <see cref="TakeWindow"/> returns the
+/// delta since the previous call.
+/// </summary>
+public sealed class ReceiverStatistics
+{
+    private long _datagrams;
+    private long _bytes;
+    private long _rejected;
+    private long _framesComplete;
+    private long _framesPartial;
+    private long _chunksExpected;
+    private long _chunksReceived;
+    private long _framesLost;
+    private long _lateChunks;
+
+    // Per-window latency samples; past the cap only the max is kept (no growth, no allocation).
+    private const int MaxLatencySamples = 4096;
+
+    private readonly object _latencyLock = new();
+    private List<double> _latencyMs = new(MaxLatencySamples);
+    private List<double> _latencySpare = new(MaxLatencySamples);
+    private double _latencyMaxMs = double.NaN;
+
+    private readonly Stopwatch _window = Stopwatch.StartNew();
+
+    internal void OnDatagram(int bytes, bool accepted)
+    {
+        Interlocked.Increment(ref _datagrams);
+        Interlocked.Add(ref _bytes, bytes);
+        if (!accepted)
+        {
+            Interlocked.Increment(ref _rejected);
+        }
+    }
+
+    internal void OnFramesLost(int count)
+    {
+        Interlocked.Add(ref _framesLost, count);
+    }
+
+    internal void OnLateChunk()
+    {
+        Interlocked.Increment(ref _lateChunks);
+    }
+
+    internal void OnFrame(in ReceivedFrame frame)
+    {
+        if (frame.IsComplete)
+        {
+            Interlocked.Increment(ref _framesComplete);
+        }
+        else
+        {
+            Interlocked.Increment(ref _framesPartial);
+        }
+        Interlocked.Add(ref _chunksExpected, frame.TotalChunks);
+        Interlocked.Add(ref _chunksReceived, frame.ReceivedChunks);
+        double ms = frame.AssemblyTime.TotalMilliseconds;
+        lock (_latencyLock)
+        {
+            if (_latencyMs.Count < MaxLatencySamples)
+            {
+                _latencyMs.Add(ms);
+            }
+            if (double.IsNaN(_latencyMaxMs) || ms > _latencyMaxMs)
+            {
+                _latencyMaxMs = ms;
+            }
+        }
+    }
+
+    public StatsWindow TakeWindow()
+    {
+        List<double> latency;
+        double latencyMax;
+        lock (_latencyLock)
+        {
+            latency = _latencyMs;
+            _latencyMs = _latencySpare;
+            latencyMax = _latencyMaxMs;
+            _latencyMaxMs = double.NaN;
+        }
+
+        double seconds = _window.Elapsed.TotalSeconds;
+        _window.Restart();
+
+        latency.Sort();
+        var window = new StatsWindow(
+            Seconds: seconds,
+            Datagrams: Interlocked.Exchange(ref _datagrams, 0),
+            Bytes: Interlocked.Exchange(ref _bytes, 0),
+            Rejected: Interlocked.Exchange(ref _rejected, 0),
+            FramesComplete: Interlocked.Exchange(ref _framesComplete, 0),
+            FramesPartial: Interlocked.Exchange(ref _framesPartial, 0),
+            ChunksExpected: Interlocked.Exchange(ref _chunksExpected, 0),
+            ChunksReceived: Interlocked.Exchange(ref _chunksReceived, 0),
+            FramesLost: Interlocked.Exchange(ref _framesLost, 0),
+            LateChunks: Interlocked.Exchange(ref _lateChunks, 0),
+            LatencyP50Ms: Percentile(latency, 0.50),
+            LatencyP99Ms: Percentile(latency, 0.99),
+            LatencyMaxMs: latencyMax);
+
+        latency.Clear();
+        _latencySpare = latency;
+        return window;
+    }
+
+    private static double Percentile(List<double> sorted, double p)
+    {
+        if (sorted.Count == 0)
+        {
+            return double.NaN;
+        }
+        int idx = (int)Math.Ceiling(p * sorted.Count) - 1;
+        return sorted[Math.Clamp(idx, 0, sorted.Count - 1)];
+    }
+}
+
+/// <summary>
+/// One sampling window. Latency is host-side assembly time (first chunk -> frame out);
+/// device-side stages are in the firmware latency trace.
+/// </summary>
+public readonly record struct StatsWindow(
+    double Seconds,
+    long Datagrams,
+    long Bytes,
+    long Rejected,
+    long FramesComplete,
+    long FramesPartial,
+    long ChunksExpected,
+    long ChunksReceived,
+    long FramesLost,
+    long LateChunks,
+    double LatencyP50Ms,
+    double LatencyP99Ms,
+    double LatencyMaxMs)
+{
+    public long Frames => FramesComplete + FramesPartial;
+    public double FramesPerSecond => Seconds > 0 ? Frames / Seconds : 0;
+    public double MegabitsPerSecond => Seconds > 0 ? Bytes * 8.0 / 1e6 / Seconds : 0;
+    public double ChunkLossPercent => ChunksExpected > 0 ? 100.0 * (ChunksExpected - ChunksReceived) / ChunksExpected : 0;
+
+    public override string ToString() =>
+        $"{FramesPerSecond,6:F2} fps {MegabitsPerSecond,7:F2} Mbit/s " +
+        $"frames {FramesComplete}/{Frames} loss {ChunkLossPercent,5:F2}% " +
+        $"asm p50 {LatencyP50Ms:F1} p99 {LatencyP99Ms:F1} max {LatencyMaxMs:F1} ms" +
+        (FramesLost > 0 ? $" lost-frames {FramesLost}" : string.Empty) +
+        (LateChunks > 0 ? $" late {LateChunks}" : string.Empty) +
+        (Rejected > 0 ? $" rejected {Rejected}" : string.Empty);
+}
@@ -1,4 +1,4 @@
-namespace UdpPhotoReceiver;
+namespace UdpPhotoReceiver.Core;
 
 public enum RenderMode
 {
@@ -0,0 +1,112 @@
+using System.Net;
+using System.Net.Sockets;
+
+namespace UdpPhotoReceiver.Core;
+
+public sealed class UdpFrameReceiver : IDisposable
+{
+    private const int MaxDatagramBytes = 64 * 1024;
+
+    private readonly int _localPort;
+
+    private Socket? _socket;
+    private readonly ReassemblyWindow _window;
+
+    // One pinned receive buffer for every datagram; payloads are copied out of it exactly once.
+    private readonly byte[] _rxBuffer = GC.AllocateUninitializedArray<byte>(MaxDatagramBytes, pinned: true);
+
+    public ReceiverStatistics Statistics { get; } = new();
+
+    /// <summary>
+    /// When set (before <see cref="RunAsync"/>), every datagram read from the socket is also
+    /// written to this pcap recorder. The receiver does not dispose it.
+    /// </summary>
+    public DatagramRecorder? Recorder { get; set; }
+
+    /// <param name="onFrame">
+    /// Called on the receive thread, in frame-sequence order. The callee owns the frame and must
+    /// Dispose it (possibly later, on another thread).
+    /// </param>
+    /// <param name="frameTimeout">Per-frame deadline, measured from its first chunk.</param>
+    /// <param name="windowFrames">Frames reassembled concurrently (1 = old single-frame behaviour).</param>
+    public UdpFrameReceiver(int localPort, Action<ReceivedFrame> onFrame, TimeSpan frameTimeout,
+        int windowFrames = ReassemblyWindow.DefaultCapacity, FramePool? pool = null)
+    {
+        _localPort = localPort;
+        _window = new ReassemblyWindow(windowFrames, frameTimeout, pool ?? FramePool.Shared, Statistics, onFrame);
+    }
+
+    public async Task RunAsync(CancellationToken cancellationToken)
+    {
+        _socket = new Socket(AddressFamily.InterNetwork, SocketType.Dgram, ProtocolType.Udp);
+        _socket.ReceiveBufferSize = 4 * 1024 * 1024;
+        _socket.Bind(new IPEndPoint(IPAddress.Any, _localPort));
+
+        // Reused for every receive: the SocketAddress overload does not allocate an EndPoint.
+        var from = new SocketAddress(AddressFamily.InterNetwork);
+        Memory<byte> rx = _rxBuffer;
+
+        while (!cancellationToken.IsCancellationRequested)
+        {
+            int n = await _socket.ReceiveFromAsync(rx, SocketFlags.None, from, cancellationToken).ConfigureAwait(false);
+            Recorder?.Record(_rxBuffer.AsSpan(0, n), from, _localPort);
+            ProcessDatagram(_rxBuffer.AsSpan(0, n));
+        }
+    }
+
+    /// <summary>
+    /// Feeds one datagram through the same path as <see cref="RunAsync"/> (benchmarks, or
+    /// <see cref="DatagramReplayer"/> for offline replay of a recording).
+    /// Not thread-safe; do not call while RunAsync is running.
+    /// </summary>
+    public bool ProcessDatagram(ReadOnlySpan<byte> datagram)
+    {
+        // Deadlines are checked on arrival; with no traffic at all, Flush() drains the rest.
+        _window.Drain();
+
+        bool accepted = Assemble(datagram);
+        Statistics.OnDatagram(datagram.Length, accepted);
+        return accepted;
+    }
+
+    /// <summary>
+    /// Emits every frame still in flight (end of stream / shutdown). Same threading rule as
+    /// <see cref="ProcessDatagram"/>.
+    /// </summary>
+    public void Flush()
+    {
+        _window.Flush();
+    }
+
+    private bool Assemble(ReadOnlySpan<byte> datagram)
+    {
+        if (!PhotoChunkHeader.TryRead(datagram, out PhotoChunkHeader hdr))
+        {
+            return false;
+        }
+
+        if (hdr.TotalChunks == 0 || hdr.TotalSize == 0 || hdr.TotalSize > int.MaxValue || hdr.TotalChunks > int.MaxValue)
+        {
+            return false;
+        }
+        if (hdr.ChunkIndex >= hdr.TotalChunks || hdr.ChunkOffset >= hdr.TotalSize)
+        {
+            return false;
+        }
+
+        int payloadAvailable = datagram.Length - hdr.SizeBytes;
+        int actualSize = Math.Min((int)hdr.ChunkDataSize, payloadAvailable);
+        if (actualSize <= 0)
+        {
+            return false;
+        }
+
+        return _window.Add(hdr, datagram.Slice(hdr.SizeBytes, actualSize));
+    }
+
+    public void Dispose()
+    {
+        _socket?.Dispose();
+        _socket = null;
+    }
+}
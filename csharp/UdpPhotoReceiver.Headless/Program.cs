@@ -0,0 +1,378 @@
+using System.Diagnostics;
+using System.Globalization;
+using System.Net;
+using System.Text;
+using System.Threading.Channels;
+using UdpPhotoReceiver.Core;
+
+namespace UdpPhotoReceiver.Headless;
+
+/// <summary>
+/// Headless receiver: UDP -> frames -> files / stdout, with per-second stats on stderr.
+/// Can also record the raw datagrams to pcap, replay a recording into the receiver offline,
+/// or re-send it to a UDP port as a load generator.
+/// </summary>
+static class Program
+{
+    private sealed class Options
+    {
+        public int Port = 9000;
+        public string? Out;            // directory, "-" = stdout, null = discard
+        public bool Pgm = true;        // directory output: .pgm (P5) or .raw
+        public bool SkipPartial;
+        public long MaxFrames;         // 0 = unlimited
+        public TimeSpan FrameTimeout = TimeSpan.FromSeconds(1);
+        public int WindowFrames = ReassemblyWindow.DefaultCapacity;
+        public bool Quiet;
+        public string? Record;         // pcap of every datagram received
+        public string? Replay;         // pcap fed to the receiver instead of the socket
+        public IPEndPoint? SendTo;     // with --replay: re-send instead of receiving
+        public double? Speed;          // replay speed; null = default for the mode
+    }
+
+    // Writer falls behind -> drop frames here instead of stalling the socket.
+    private const int WriteQueueFrames = 64;
+
+    static async Task<int> Main(string[] args)
+    {
+        Options? opt = ParseArgs(args);
+        if (opt is null)
+        {
+            PrintUsage();
+            return 2;
+        }
+
+        using var cts = new CancellationTokenSource();
+        Console.CancelKeyPress += (_, e) =>
+        {
+            e.Cancel = true;
+            cts.Cancel();
+        };
+
+        if (opt.SendTo is not null)
+        {
+            return await SendRecordingAsync(opt, cts.Token).ConfigureAwait(false);
+        }
+
+        if (opt.Out is not null && opt.Out != "-")
+        {
+            Directory.CreateDirectory(opt.Out);
+        }
+
+        var queue = Channel.CreateBounded<ReceivedFrame>(new BoundedChannelOptions(WriteQueueFrames)
+        {
+            SingleReader = true,
+            SingleWriter = true,
+            // Wait mode so TryWrite reports a full queue (DropWrite would swallow the frame
+            // without giving the lease back).
+            FullMode = BoundedChannelFullMode.Wait,
+        });
+        long queued = 0;
+        long dropped = 0;
+
+        using var receiver = new UdpFrameReceiver(
+            localPort: opt.Port,
+            onFrame: frame =>
+            {
+                if (opt.SkipPartial && !frame.IsComplete)
+                {
+                    frame.Dispose();
+                    return;
+                }
+                if (opt.MaxFrames > 0 && Interlocked.Read(ref queued) >= opt.MaxFrames)
+                {
+                    frame.Dispose();
+                    return;
+                }
+                // Offline replay: hold the replay back instead of dropping, so output is reproducible.
+                bool enqueued = queue.Writer.TryWrite(frame);
+                while (!enqueued && opt.Replay is not null && queue.Writer.WaitToWriteAsync().AsTask().GetAwaiter().GetResult())
+                {
+                    enqueued = queue.Writer.TryWrite(frame);
+                }
+                if (enqueued)
+                {
+                    if (Interlocked.Increment(ref queued) == opt.MaxFrames)
+                    {
+                        queue.Writer.TryComplete();
+                    }
+                }
+                else
+                {
+                    frame.Dispose();
+                    Interlocked.Increment(ref dropped);
+                }
+            },
+            frameTimeout: opt.FrameTimeout,
+            windowFrames: opt.WindowFrames);
+
+        using DatagramRecorder? recorder = opt.Record is not null ? new DatagramRecorder(opt.Record) : null;
+        receiver.Recorder = recorder;
+
+        Console.Error.WriteLine(opt.Replay is not null
+            ? $"Replaying {opt.Replay} (port {opt.Port}, {DescribeSpeed(opt.Speed ?? DatagramReplayer.MaxSpeed)}) -> {DescribeOutput(opt)}"
+            : $"Listening on UDP port {opt.Port} -> {DescribeOutput(opt)}");
+
+        Task receiveTask = Task.Run(async () =>
+        {
+            try
+            {
+                if (opt.Replay is not null)
+                {
+                    long n = await DatagramReplayer.ReplayAsync(
+                        DatagramRecording.Read(opt.Replay, opt.Port),
+                        d => receiver.ProcessDatagram(d.Payload),
+                        opt.Speed ?? DatagramReplayer.MaxSpeed,
+                        cts.Token).ConfigureAwait(false);
+                    Console.Error.WriteLine($"{n} datagrams replayed");
+                }
+                else
+                {
+                    await receiver.RunAsync(cts.Token).ConfigureAwait(false);
+                }
+            }
+            catch (OperationCanceledException)
+            {
+                // expected on shutdown
+            }
+            finally
+            {
+                receiver.Flush();
+                queue.Writer.TryComplete();
+            }
+        });
+
+        Task statsTask = Task.Run(async () =>
+        {
+            using var timer = new PeriodicTimer(TimeSpan.FromSeconds(1));
+            try
+            {
+                while (await timer.WaitForNextTickAsync(cts.Token).ConfigureAwait(false))
+                {
+                    StatsWindow w = receiver.Statistics.TakeWindow();
+                    if (!opt.Quiet)
+                    {
+                        long d = Interlocked.Exchange(ref dropped, 0);
+                        Console.Error.WriteLine(d > 0 ? $"{w} write-drop {d}" : w.ToString());
+                    }
+                }
+            }
+            catch (OperationCanceledException)
+            {
+                // expected on shutdown
+            }
+        });
+
+        long written = await WriteFramesAsync(queue.Reader, opt).ConfigureAwait(false);
+
+        cts.Cancel();
+        await Task.WhenAll(receiveTask, statsTask).ConfigureAwait(false);
+
+        Console.Error.WriteLine(recorder is not null
+            ? $"{written} frames written, {recorder.Datagrams} datagrams recorded to {opt.Record}"
+            : $"{written} frames written");
+        return 0;
+    }
+
+    private static async Task<int> SendRecordingAsync(Options opt, CancellationToken cancellationToken)
+    {
+        double speed = opt.Speed ?? 1.0;
+        Console.Error.WriteLine($"Sending {opt.Replay} -> {opt.SendTo} ({DescribeSpeed(speed)})");
+
+        long startTicks = Stopwatch.GetTimestamp();
+        long n = 0;
+        try
+        {
+            n = await DatagramReplayer.SendAsync(DatagramRecording.Read(opt.Replay!), opt.SendTo!, speed, cancellationToken)
+                .ConfigureAwait(false);
+        }
+        catch (OperationCanceledException)
+        {
+            // Ctrl+C
+        }
+        double sec = Stopwatch.GetElapsedTime(startTicks).TotalSeconds;
+        Console.Error.WriteLine($"{n} datagrams sent in {sec:F2} s");
+        return 0;
+    }
+
+    private static string DescribeSpeed(double speed) =>
+        double.IsPositiveInfinity(speed) ? "max speed" : $"{speed:G}x";
+
+    private static async Task<long> WriteFramesAsync(ChannelReader<ReceivedFrame> reader, Options opt)
+    {
+        Stream? stdout = opt.Out == "-" ? Console.OpenStandardOutput() : null;
+        long seq = 0;
+
+        await foreach (ReceivedFrame frame in reader.ReadAllAsync().ConfigureAwait(false))
+        {
+            try
+            {
+                if (stdout is not null)
+                {
+                    await stdout.WriteAsync(frame.Data).ConfigureAwait(false);
+                    await stdout.FlushAsync().ConfigureAwait(false);
+                }
+                else if (opt.Out is not null)
+                {
+                    await WriteFrameFileAsync(opt.Out, seq, frame, opt.Pgm).ConfigureAwait(false);
+                }
+                seq++;
+            }
+            finally
+            {
+                frame.Dispose();
+            }
+        }
+
+        stdout?.Dispose();
+        return seq;
+    }
+
+    private static async Task WriteFrameFileAsync(string dir, long seq, ReceivedFrame frame, bool pgm)
+    {
+        (int w, int h) = FrameGeometry.InferFromTotalSize(frame.Data.Length);
+        bool asPgm = pgm && (w * h == frame.Data.Length);
+        string suffix = frame.IsComplete ? string.Empty : $"_missing{frame.MissingChunks}";
+        string name = asPgm
+            ? $"frame_{seq:D6}{suffix}.pgm"
+            : $"frame_{seq:D6}_{frame.Data.Length}B{suffix}.raw";
+
+        await using var fs = new FileStream(Path.Combine(dir, name), FileMode.Create, FileAccess.Write, FileShare.Read,
+            bufferSize: 64 * 1024, useAsync: true);
+        if (asPgm)
+        {
+            byte[] header = Encoding.ASCII.GetBytes($"P5\n{w} {h}\n255\n");
+            await fs.WriteAsync(header).ConfigureAwait(false);
+        }
+        await fs.WriteAsync(frame.Data).ConfigureAwait(false);
+    }
+
+    private static string DescribeOutput(Options opt) =>
+        opt.Out switch
+        {
+            null => "discard (stats only)",
+            "-" => "stdout (raw)",
+            _ => $"{opt.Out} ({(opt.Pgm ? "pgm" : "raw")})",
+        };
+
+    private static Options? ParseArgs(string[] args)
+    {
+        var opt = new Options();
+        for (int i = 0; i < args.Length; i++)
+        {
+            string a = args[i];
+            string? Next() => (i + 1 < args.Length) ? args[++i] : null;
+
+            switch (a)
+            {
+                case "--port":
+                    if (!int.TryParse(Next(), NumberStyles.Integer, CultureInfo.InvariantCulture, out opt.Port))
+                    {
+                        return null;
+                    }
+                    break;
+                case "--out":
+                    opt.Out = Next();
+                    if (opt.Out is null)
+                    {
+                        return null;
+                    }
+                    break;
+                case "--raw":
+                    opt.Pgm = false;
+                    break;
+                case "--complete-only":
+                    opt.SkipPartial = true;
+                    break;
+                case "--frames":
+                    if (!long.TryParse(Next(), NumberStyles.Integer, CultureInfo.InvariantCulture, out opt.MaxFrames))
+                    {
+                        return null;
+                    }
+                    break;
+                case "--timeout-ms":
+                    if (!int.TryParse(Next(), NumberStyles.Integer, CultureInfo.InvariantCulture, out int ms) || ms <= 0)
+                    {
+                        return null;
+                    }
+                    opt.FrameTimeout = TimeSpan.FromMilliseconds(ms);
+                    break;
+                case "--window":
+                    if (!int.TryParse(Next(), NumberStyles.Integer, CultureInfo.InvariantCulture, out opt.WindowFrames) || opt.WindowFrames <= 0)
+                    {
+                        return null;
+                    }
+                    break;
+                case "--quiet":
+                    opt.Quiet = true;
+                    break;
+                case "--record":
+                    opt.Record = Next();
+                    if (opt.Record is null)
+                    {
+                        return null;
+                    }
+                    break;
+                case "--replay":
+                    opt.Replay = Next();
+                    if (opt.Replay is null)
+                    {
+                        return null;
+                    }
+                    break;
+                case "--send":
+                    if (!IPEndPoint.TryParse(Next() ?? string.Empty, out opt.SendTo) || opt.SendTo.Port == 0)
+                    {
+                        return null;
+                    }
+                    break;
+                case "--speed":
+                {
+                    string? v = Next()?.TrimEnd('x');
+                    if (v == "max")
+                    {
+                        opt.Speed = DatagramReplayer.MaxSpeed;
+                    }
+                    else if (double.TryParse(v, NumberStyles.Float, CultureInfo.InvariantCulture, out double speed) && speed > 0)
+                    {
+                        opt.Speed = speed;
+                    }
+                    else
+                    {
+                        return null;
+                    }
+                    break;
+                }
+                default:
+                    return null;
+            }
+        }
+        if (opt.SendTo is not null && opt.Replay is null)
+        {
+            return null;
+        }
+        if (opt.Record is not null && opt.Replay is not null)
+        {
+            return null;
+        }
+        return opt;
+    }
+
+    private static void PrintUsage()
+    {
+        Console.Error.WriteLine(
+            "usage: UdpPhotoReceiver.Headless [--port 9000] [--out <dir>|-] [--raw] [--complete-only]\n" +
+            "                                 [--frames N] [--timeout-ms 1000] [--window 4] [--quiet]\n" +
+            "                                 [--record cap.pcap | --replay cap.pcap [--speed max|1|N] [--send host:port]]\n" +
+            "  --out <dir>      write frame_NNNNNN.pgm (8-bit, size inferred) or .raw\n" +
+            "  --out -          write raw frames back-to-back to stdout\n" +
+            "  (no --out)       receive and print stats only\n" +
+            "  --window N       frames reassembled at once (reordering tolerance), emitted in order\n" +
+            "  --timeout-ms N   per-frame deadline from its first chunk\n" +
+            "  --record f       also write every received datagram to pcap file f\n" +
+            "  --replay f       feed pcap file f (datagrams to --port) to the receiver instead of the socket;\n" +
+            "                   default --speed max (same frames on every run)\n" +
+            "  --send h:p       with --replay: re-send f to UDP h:p instead (default --speed 1)\n" +
+            "stats go to stderr once per second.");
+    }
+}
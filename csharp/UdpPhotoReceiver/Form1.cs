@@ -1,5 +1,6 @@
 using System.Diagnostics;
 using System.Windows.Forms;
+using UdpPhotoReceiver.Core;
 
 namespace UdpPhotoReceiver;
 
@@ -65,7 +66,7 @@ public partial class Form1 : Form
         _receiver = new UdpFrameReceiver(
             localPort: 9000,
             onFrame: OnFrame,
-            frameTimeout: TimeSpan.FromSeconds(10));
+            frameTimeout: TimeSpan.FromSeconds(1));
 
         Shown += (_, _) => Start();
     }
@@ -102,14 +103,14 @@ public partial class Form1 : Form
         }, _cts.Token);
     }
 
-    private void OnFrame(ReadOnlyMemory<byte> frameData)
+    private void OnFrame(ReceivedFrame frame)
     {
         try
         {
             byte rangeMin = (byte)Math.Clamp(_heatmapMin, 0, 255);
             byte rangeMax = (byte)Math.Clamp(_heatmapMax, 0, 255);
 
-            (int w, int h) = InferFrameDimsFromTotalSize(frameData.Length, defaultW: 320, defaultH: 240);
+            (int w, int h) = FrameGeometry.InferFromTotalSize(frame.Data.Length);
 
             lock (_renderLock)
             {
@@ -119,7 +120,7 @@ public partial class Form1 : Form
                     _renderer = new DepthRenderer(width: w, height: h);
                 }
 
-                _renderer.RenderIntoBitmap(frameData.Span, _mode, rangeMin, rangeMax);
+                _renderer.RenderIntoBitmap(frame.Data.Span, _mode, rangeMin, rangeMax);
             }
 
             BeginInvoke(() =>
@@ -134,7 +135,8 @@ public partial class Form1 : Form
                 if (nowMs - _lastStatsMs >= 1000)
                 {
                     var fps = _framesDisplayed / Math.Max(1e-6, _stopwatch.Elapsed.TotalSeconds);
-                    toolStripStatusLabel.Text = $"Frames: {_framesDisplayed} ({fps:F2} fps)";
+                    StatsWindow stats = _receiver.Statistics.TakeWindow();
+                    toolStripStatusLabel.Text = $"Frames: {_framesDisplayed} ({fps:F2} fps)  loss {stats.ChunkLossPercent:F2}%  asm p99 {stats.LatencyP99Ms:F1} ms";
                     _lastStatsMs = nowMs;
                 }
             });
@@ -143,59 +145,10 @@ public partial class Form1 : Form
         {
             // keep receiving even if a bad frame arrives
         }
-    }
-
-    private static (int width, int height) InferFrameDimsFromTotalSize(int totalSize, int defaultW, int defaultH)
-    {
-        if (totalSize <= 0)
-        {
-            return (defaultW, defaultH);
-        }
-
-        // Known cases used in this repo/tooling.
-        if (totalSize == 320 * 240)
-        {
-            return (320, 240);
-        }
-        if (totalSize == 256 * 128)
-        {
-            return (256, 128);
-        }
-        if (totalSize == 256 * 256)
-        {
-            return (256, 256);
-        }
-        if (totalSize == 128 * 128)
-        {
-            return (128, 128);
-        }
-
-        // Fallback: try common widths.
-        if (totalSize % 320 == 0)
+        finally
         {
-            int h = totalSize / 320;
-            if (h >= 1 && h <= 240)
-            {
-                return (320, h);
-            }
+            // Pixels are in the bitmap now; the pooled buffer goes back for the next frame.
+            frame.Dispose();
         }
-        if (totalSize % 256 == 0)
-        {
-            int h = totalSize / 256;
-            if (h >= 1 && h <= 512)
-            {
-                return (256, h);
-            }
-        }
-        if (totalSize % 128 == 0)
-        {
-            int h = totalSize / 128;
-            if (h >= 1 && h <= 512)
-            {
-                return (128, h);
-            }
-        }
-
-        return (defaultW, defaultH);
     }
 }
@@ -0,0 +1,152 @@
+function golden_csv = export_hlac_golden(images, out_dir, lda_model, grid)
+%EXPORT_HLAC_GOLDEN Write golden HLAC/LDA vectors for the firmware C path.
+%
+% bench/hlac_golden.c (script/hlac_golden.sh) reads the output and compares
+% hlac25_compute_from_u8_hyperram / _roi and hlac_lda_predict_ex against it.
+%
+% Inputs:
+%   images    - folder name, cell array of file names, or cell array / single
+%               uint8 image(s). RGB is converted to gray. Width <= 320
+%               (HLAC_MAX_IMAGE_W). Use the image the firmware feeds to HLAC
+%               (e.g. |P|+|Q|); no Sobel is applied here (use_sobel=false).
+%   out_dir   - output folder (default: 'hlac_golden')
+%   lda_model - struct with W, b, feature_mean, feature_std (lda_model.mat from
+%               train_lda_classifier.m). [] skips the LDA columns (label=-1).
+%               Must be the same training run that generated src/hlac_lda_model.c.
+%   grid      - [cols rows] of ROI blocks (default [4 4] = HLAC_BLOCK_COLS/ROWS).
+%               Block size is floor(w/cols) x floor(h/rows), same as Thread3.
+%
+% Output files:
+%   out_dir/imgNNN.pgm   - 8-bit images
+%   out_dir/golden.csv   - file,kind,x0,y0,w,h,label,score,prob,f01..f25
+%
+% Usage examples:
+%   cd matlab
+%   S = load('lda_model/lda_model.mat');
+%   export_hlac_golden('dataset/test', 'hlac_golden', S.lda_model)
+%   export_hlac_golden({uint8(peaks(128) * 20 + 128)}, 'hlac_golden', [])
+%   % then on the PC:  ./script/hlac_golden.sh matlab/hlac_golden/golden.csv
+%
+
+if nargin < 2 || isempty(out_dir)
+    out_dir = 'hlac_golden';
+end
+if nargin < 3
+    lda_model = [];
+end
+if nargin < 4 || isempty(grid)
+    grid = [4 4];
+end
+
+max_w = 320; % HLAC_MAX_IMAGE_W
+
+images = local_collect_images(images);
+if isempty(images)
+    error('export_hlac_golden: no images');
+end
+
+if ~exist(out_dir, 'dir')
+    mkdir(out_dir);
+end
+
+use_lda = ~isempty(lda_model);
+if use_lda
+    W = double(lda_model.W);
+    b = double(lda_model.b(:));
+    mu = zeros(size(W, 1), 1);
+    sigma = ones(size(W, 1), 1);
+    if isfield(lda_model, 'feature_mean')
+        mu = double(lda_model.feature_mean(:));
+    end
+    if isfield(lda_model, 'feature_std')
+        sigma = double(lda_model.feature_std(:));
+    end
+    sigma(sigma < 1e-12) = 1; % ファームと同じ
+end
+
+golden_csv = fullfile(out_dir, 'golden.csv');
+fid = fopen(golden_csv, 'w');
+if fid < 0
+    error('export_hlac_golden: cannot open %s', golden_csv);
+end
+cleanup = onCleanup(@() fclose(fid));
+
+fprintf(fid, 'file,kind,x0,y0,w,h,label,score,prob');
+fprintf(fid, ',f%02d', 1:25);
+fprintf(fid, '\n');
+
+rows = 0;
+for k = 1:numel(images)
+    img = images{k};
+    if ischar(img) || isstring(img)
+        img = imread(img);
+    end
+    if ndims(img) == 3
+        img = rgb2gray(img);
+    end
+    img = im2uint8(img);
+
+    [h, w] = size(img);
+    if w > max_w
+        error('export_hlac_golden: image %d is %d px wide (max %d)', k, w, max_w);
+    end
+
+    name = sprintf('img%03d.pgm', k);
+    imwrite(img, fullfile(out_dir, name));
+
+    % 全体
+    f = extract_hlac_features(img, 2, false);
+    write_row(name, 'full', 0, 0, w, h, f);
+
+    % ROI(ブロックの外は 0 パディング)
+    bw = floor(w / grid(1));
+    bh = floor(h / grid(2));
+    if bw >= 1 && bh >= 1
+        for br = 0:(grid(2) - 1)
+            for bc = 0:(grid(1) - 1)
+                x0 = bc * bw;
+                y0 = br * bh;
+                f = extract_hlac_features(img((y0 + 1):(y0 + bh), (x0 + 1):(x0 + bw)), 2, false);
+                write_row(name, 'roi', x0, y0, bw, bh, f);
+            end
+        end
+    end
+end
+
+fprintf('Wrote %d rows (%d images) to %s\n', rows, numel(images), golden_csv);
+
+    function write_row(name, kind, x0, y0, bw, bh, f)
+        label = -1;
+        best = 0;
+        prob = 0;
+        if use_lda
+            z = (f(:) - mu) ./ sigma;
+            scores = W.' * z + b;
+            [best, idx] = max(scores);
+            label = idx - 1;
+            prob = 1 / sum(exp(scores - best));
+        end
+        fprintf(fid, '%s,%s,%d,%d,%d,%d,%d,%.9g,%.9g', name, kind, x0, y0, bw, bh, label, best, prob);
+        fprintf(fid, ',%.12g', f);
+        fprintf(fid, '\n');
+        rows = rows + 1;
+    end
+
+end
+
+function list = local_collect_images(images)
+if ischar(images) || isstring(images)
+    images = char(images);
+    if exist(images, 'dir')
+        files = [dir(fullfile(images, '*.png')); dir(fullfile(images, '*.jpg')); ...
+                 dir(fullfile(images, '*.bmp')); dir(fullfile(images, '*.pgm'))];
+        list = cellfun(@(n) fullfile(images, n), sort({files.name}), 'UniformOutput', false);
+    else
+        list = {images};
+    end
+elseif iscell(images)
+    list = images;
+else
+    list = {images};
+end
+end
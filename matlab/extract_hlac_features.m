@@ -260,18 +260,19 @@ for p = 1:numel(keys_sorted)
     end
 end
 
+% D4 で同値類にまとめると 8 種類にしかならない．ファーム(hlac25_init_pairs_once)は
+% その場合に先頭20ペア (1,1),(1,2),...,(3,7) を使うので，同じ特徴量になるよう合わせる
+if size(pair_idx, 1) ~= 20
+    pair_idx = pairs_all(1:20, :);
+end
+end
+
 function tf = local_str_lt(a, b)
 % True if string/char a is lexicographically smaller than b.
 ab = sort({a, b});
 tf = strcmp(ab{1}, a);
 end
 
-% Expect 20 patterns
-if size(pair_idx, 1) ~= 20
-    error('HLAC 2nd-order patterns expected 20, got %d. Please verify D4 reduction.', size(pair_idx, 1));
-end
-end
-
 function tf = local_lex_gt(a, b)
 % True if a is lexicographically greater than b.
 tf = (a(1) > b(1)) || (a(1) == b(1) && a(2) > b(2));
@@ -101,16 +101,12 @@ end
 function [stats, total_saved] = capture_loop(udp_obj, ax, fig, save_dir, class_names, stats, rejected_subdir)
     % メインキャプチャループ
     
-    header_size = 24;
-
     % このプロジェクトの送信データ想定(udp_photo_receiver.m と同じ)
     frame_width = 320;
     frame_height = 240;
     
-    % フレーム管理変数
-    packets = {};
-    total_chunks = 0;
-    total_size = 0;
+    % フレーム管理変数(複数フレーム並行で組み立て，frame_seq 順に出す)
+    win = reassembly_window('new', 4, 1.0);
     current_frame = [];
 
     % 保存品質管理
@@ -128,11 +124,6 @@ function [stats, total_saved] = capture_loop(udp_obj, ax, fig, save_dir, class_n
     last_status_time = tic;
     received_frames = 0;
 
-    % UDPは順序入れ替わり得るため，受信済みチャンク数で完了判定する
-    received_mask = [];
-    received_count = 0;
-    frame_completed = false;
-    
     fprintf('UDPパケット受信待機中...\n');
     
     while ishandle(fig)
@@ -160,76 +151,17 @@ function [stats, total_saved] = capture_loop(udp_obj, ax, fig, save_dir, class_n
                     last_status_time = tic;
                 end
                 
-                if length(data) >= header_size
-                    % ヘッダー解析
-                    header_bytes = data(1:header_size);
-                    magic_number = typecast(header_bytes(1:4), 'uint32');
-                    
-                    if magic_number == uint32(hex2dec('12345678'))
-                        total_size_val = typecast(header_bytes(5:8), 'uint32');
-                        chunk_index_val = typecast(header_bytes(9:12), 'uint32');
-                        total_chunks_val = typecast(header_bytes(13:16), 'uint32');
-                        chunk_offset_val = typecast(header_bytes(17:20), 'uint32'); %#ok<NASGU>
-                        chunk_data_size_val = typecast(header_bytes(21:22), 'uint16');
-                        
-                        chunk_data = data(header_size+1:end);
-                        
-                        % 新しいフレーム開始
-                        if chunk_index_val == 0
-                            current_frame_id = current_frame_id + 1;
-
-                            % 前のフレームを完成させる
-                            if ~isempty(packets) && ~frame_completed
-                                [current_frame, last_missing_chunks] = reconstruct_depth_frame(packets, total_chunks, total_size, frame_width, frame_height);
-                                last_frame_id = current_frame_id - 1;
-                                if ~isempty(current_frame)
-                                    img_handle = display_frame(current_frame, ax, img_handle);
-                                    received_frames = received_frames + 1;
-                                    if received_frames == 1
-                                        fprintf('✓ 最初のフレームを表示しました！\n');
-                                    end
-                                end
-                            end
-                            
-                            % 新フレーム初期化
-                            total_chunks = double(total_chunks_val);
-                            total_size = double(total_size_val);
-                            packets = cell(total_chunks, 1);
-                            received_mask = false(total_chunks, 1);
-                            received_count = 0;
-                            frame_completed = false;
-                        end
-                        
-                        % パケット格納
-                        chunk_idx = double(chunk_index_val) + 1;
-                        if chunk_idx <= total_chunks && chunk_idx > 0
-                            actual_size = min(double(chunk_data_size_val), length(chunk_data));
-                            if actual_size > 0
-                                if isempty(packets{chunk_idx})
-                                    packets{chunk_idx} = chunk_data(1:actual_size);
-                                    received_mask(chunk_idx) = true;
-                                    received_count = received_count + 1;
-                                end
-                            end
-                        end
-
-                        % 全チャンク受信でフレーム完成(順序入れ替わりに対応)
-                        if ~frame_completed && ~isempty(packets) && received_count == total_chunks
-                            [current_frame, last_missing_chunks] = reconstruct_depth_frame(packets, total_chunks, total_size, frame_width, frame_height);
-                            last_frame_id = current_frame_id;
-                            if ~isempty(current_frame)
-                                img_handle = display_frame(current_frame, ax, img_handle);
-                                received_frames = received_frames + 1;
-                                if received_frames == 1
-                                    fprintf('✓ 最初のフレームを表示しました！\n');
-                                end
-                            end
-                            frame_completed = true;
-                        end
-                    end
+                [hdr, chunk_data] = parse_photo_chunk(data);
+                if hdr.valid
+                    [win, frames] = reassembly_window('add', win, hdr, chunk_data);
+                    show_frames(frames);
                 end
             end
             
+            % 受信が途切れても期限切れのフレームは出す
+            [win, frames] = reassembly_window('drain', win);
+            show_frames(frames);
+            
             % キーボード入力チェック
             if ishandle(fig)
                 key = get(fig, 'UserData');
@@ -285,44 +217,44 @@ function [stats, total_saved] = capture_loop(udp_obj, ax, fig, save_dir, class_n
             pause(0.1);
         end
     end
+
+    function show_frames(frames)
+        % reassembly_window から出たフレーム(frame_seq 順)を表示
+        for fi = 1:numel(frames)
+            current_frame_id = frames(fi).seq;
+            [current_frame, last_missing_chunks] = reconstruct_depth_frame(frames(fi), frame_width, frame_height);
+            last_frame_id = current_frame_id;
+            if ~isempty(current_frame)
+                img_handle = display_frame(current_frame, ax, img_handle);
+                received_frames = received_frames + 1;
+                if received_frames == 1
+                    fprintf('✓ 最初のフレームを表示しました！\n');
+                end
+            end
+        end
+    end
 end
 
-function [frame, missing_count] = reconstruct_depth_frame(packets, total_chunks, total_size, width, height)
-    % パケットから 8bit depth map (width x height) を復元
-    % udp_photo_receiver.m の reconstruct_frame_ultra_fast + extract_depth_map と同等の考え方
+function [frame, missing_count] = reconstruct_depth_frame(win_frame, width, height)
+    % reassembly_window の出力から 8bit depth map (width x height) を作る
+    % 欠損チャンクは 0 埋め済み(表示・保存を優先)
 
     frame = [];
-    missing_count = 0;
+    missing_count = win_frame.missing;
 
     try
-        total_size = double(total_size);
+        total_size = double(win_frame.total_size);
         if total_size <= 0
             return;
         end
 
-        % 欠損があってもゼロ埋めで復元する(表示・保存を優先)
-        frame_data = zeros(total_size, 1, 'uint8');
-
-        for i = 1:total_chunks
-            if ~isempty(packets{i})
-                chunk_data = packets{i};
-                start_pos = (i-1) * 512 + 1;
-                end_pos = min(start_pos + length(chunk_data) - 1, total_size);
-                if start_pos <= total_size && end_pos >= start_pos
-                    frame_data(start_pos:end_pos) = chunk_data(1:(end_pos-start_pos+1));
-                end
-            else
-                missing_count = missing_count + 1;
-            end
-        end
-
         [width, height] = infer_frame_dims_from_total_size(total_size, width, height);
         expected_pixels = width * height;
         if total_size < expected_pixels
             return;
         end
 
-        depth_raw = frame_data(1:expected_pixels);
+        depth_raw = win_frame.data(1:expected_pixels);
         frame = reshape(depth_raw, [width, height])';
 
     catch ME
@@ -16,6 +16,8 @@ function hlac_udp_inference(varargin)
 %   'frame_width'            (default 320)
 %   'frame_height'           (default 240)
 %   'max_missing_chunks'     (default 5)  % infer only if missing<=this
+%   'reassembly_window'      (default 4)  % frames reassembled concurrently (by frame_seq)
+%   'frame_deadline_sec'     (default 1.0) % emit a frame with missing chunks after this
 %   'infer_on_rejected'      (default false) % if true, infer even when missing>threshold
 %   'use_sobel'              (default false) % must match training
 %   'hlac_order'             (default 2)    % 1 or 2
@@ -41,6 +43,8 @@ p.addParameter('model_dir', 'lda_model');
 p.addParameter('frame_width', 320);
 p.addParameter('frame_height', 240);
 p.addParameter('max_missing_chunks', 5);
+p.addParameter('reassembly_window', 4);
+p.addParameter('frame_deadline_sec', 1.0);
 p.addParameter('infer_on_rejected', false);
 p.addParameter('use_sobel', false);
 p.addParameter('hlac_order', 2);
@@ -101,16 +105,9 @@ try
     ax = axes('Parent', fig);
     img_handle = [];
 
-    header_size = 24;
-    magic = uint32(hex2dec('12345678'));
-
-    packets = {};
-    total_chunks = 0;
-    total_size = 0;
+    % 複数フレーム並行で組み立て，frame_seq 順に出す (reassembly_window.m)
+    win = reassembly_window('new', opt.reassembly_window, opt.frame_deadline_sec);
     frame_id = 0;
-    received_mask = [];
-    received_count = 0;
-    frame_completed = false;
     last_status = tic;
     pkt_count = 0;
     infer_count = 0;
@@ -134,67 +131,24 @@ try
             pkt_count = pkt_count + 1;
 
             if toc(last_status) > 5
-                fprintf('recv: packets=%d, frame_id=%d\n', pkt_count, frame_id);
+                fprintf('recv: packets=%d, frame_id=%d, lost=%d, late=%d\n', ...
+                    pkt_count, frame_id, win.lost_frames, win.late_chunks);
                 last_status = tic;
             end
 
-            if length(data) < header_size
-                continue;
-            end
-
-            header_bytes = data(1:header_size);
-            magic_number = typecast(header_bytes(1:4), 'uint32');
-            if magic_number ~= magic
+            [hdr, chunk_data] = parse_photo_chunk(data);
+            if ~hdr.valid
                 continue;
             end
 
-            total_size_val = double(typecast(header_bytes(5:8), 'uint32'));
-            chunk_index_val = double(typecast(header_bytes(9:12), 'uint32'));
-            total_chunks_val = double(typecast(header_bytes(13:16), 'uint32'));
-            %#ok<NASGU> chunk_offset_val = typecast(header_bytes(17:20), 'uint32');
-            chunk_data_size_val = double(typecast(header_bytes(21:22), 'uint16'));
-
-            chunk_data = data(header_size+1:end);
-
-            if chunk_index_val == 0
-                % finalize previous
-                if ~isempty(packets) && ~frame_completed
-                    [frame, missing] = reconstruct_depth_frame(packets, total_chunks, total_size, opt.frame_width, opt.frame_height);
-                    if ~isempty(frame)
-                        run_infer_and_show(frame, missing, frame_id);
-                    end
-                end
-
-                frame_id = frame_id + 1;
-                total_chunks = total_chunks_val;
-                total_size = total_size_val;
-                packets = cell(total_chunks, 1);
-                received_mask = false(total_chunks, 1);
-                received_count = 0;
-                frame_completed = false;
-            end
-
-            chunk_idx = chunk_index_val + 1;
-            if chunk_idx >= 1 && chunk_idx <= total_chunks
-                actual_size = min(chunk_data_size_val, length(chunk_data));
-                if actual_size > 0
-                    if isempty(packets{chunk_idx})
-                        packets{chunk_idx} = chunk_data(1:actual_size);
-                        received_mask(chunk_idx) = true;
-                        received_count = received_count + 1;
-                    end
-                end
-            end
-
-            if ~frame_completed && ~isempty(packets) && received_count == total_chunks
-                [frame, missing] = reconstruct_depth_frame(packets, total_chunks, total_size, opt.frame_width, opt.frame_height);
-                if ~isempty(frame)
-                    run_infer_and_show(frame, missing, frame_id);
-                end
-                frame_completed = true;
-            end
+            [win, frames] = reassembly_window('add', win, hdr, chunk_data);
+            show_frames(frames);
         end
 
+        % 受信が途切れても期限切れのフレームは出す
+        [win, frames] = reassembly_window('drain', win);
+        show_frames(frames);
+
         % key handling
         key = '';
         if isappdata(fig, 'last_key')
@@ -216,6 +170,16 @@ if ~isempty(udp_obj)
     release(udp_obj);
 end
 
+    function show_frames(frames)
+        for fi = 1:numel(frames)
+            frame_id = frames(fi).seq;
+            [frame, missing] = reconstruct_depth_frame(frames(fi), opt.frame_width, opt.frame_height);
+            if ~isempty(frame)
+                run_infer_and_show(frame, missing, frame_id);
+            end
+        end
+    end
+
     function run_infer_and_show(frame, missing, cur_frame_id)
         do_infer = (missing <= opt.max_missing_chunks) || opt.infer_on_rejected;
         scores = [];
@@ -644,40 +608,25 @@ else
 end
 end
 
-function [frame, missing_count] = reconstruct_depth_frame(packets, total_chunks, total_size, width, height)
-% Reconstruct 8-bit depth frame from chunk list (zero-fill missing).
+function [frame, missing_count] = reconstruct_depth_frame(win_frame, width, height)
+% Reshape one reassembled frame (reassembly_window output, missing chunks already zero-filled).
 
 frame = [];
-missing_count = 0;
+missing_count = win_frame.missing;
 
 try
-    total_size = double(total_size);
+    total_size = double(win_frame.total_size);
     if total_size <= 0
         return;
     end
 
-    frame_data = zeros(total_size, 1, 'uint8');
-
-    for i = 1:total_chunks
-        if ~isempty(packets{i})
-            chunk_data = packets{i};
-            start_pos = (i-1) * 512 + 1;
-            end_pos = min(start_pos + length(chunk_data) - 1, total_size);
-            if start_pos <= total_size && end_pos >= start_pos
-                frame_data(start_pos:end_pos) = chunk_data(1:(end_pos-start_pos+1));
-            end
-        else
-            missing_count = missing_count + 1;
-        end
-    end
-
     [width, height] = infer_frame_dims_from_total_size(total_size, width, height);
     expected_pixels = width * height;
     if total_size < expected_pixels
         return;
     end
 
-    depth_raw = frame_data(1:expected_pixels);
+    depth_raw = win_frame.data(1:expected_pixels);
     frame = reshape(depth_raw, [width, height])';
 
 catch
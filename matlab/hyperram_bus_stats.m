@@ -0,0 +1,165 @@
+function snaps = hyperram_bus_stats(duration_s, remote_ip)
+    % RA8E1 HyperRAM の呼び出し元ごとの帯域・ミューテックス競合("HRM1" パケット)を表示
+    %
+    % 使い方:
+    %   hyperram_bus_stats()                        % UDP 9000 で 30 秒受信
+    %   hyperram_bus_stats(120)                     % 120 秒
+    %   hyperram_bus_stats(60, '192.168.1.100')     % 先に "PROF RESET" を送ってから受信
+    %
+    % ファームは映像ストリーム中に HYPERRAM_STATS_UDP_PERIOD_MS(既定 1 秒)ごとに送る．
+    % 値は起動(または PROF RESET)からの累積なので，レートは隣り合うパケットの差から出す．
+    %   hold: ミューテックスを握っていた時間(転送 + write verify) = バスの占有
+    %   wait: ミューテックス待ち(タイムアウトで諦めた分も含む)
+    % 戻り値 snaps: struct 配列 .uptime_ms .cpu_hz .stats [caller x 14]
+    %   列: read_tx, write_tx, read_bytes, write_bytes, wait_cyc, hold_cyc,
+    %       max_wait_cyc, max_hold_cyc, timeouts, wv_retries(64bit 値は結合済み，12列目以降は 32bit)
+    %
+    % UDP: udp_photo_receiver と同じポートを使うので同時には動かさないこと．
+
+    if nargin < 1 || isempty(duration_s)
+        duration_s = 30;
+    end
+    if nargin < 2
+        remote_ip = '';
+    end
+
+    % src/hyperram_integ.h の hyperram_caller_t と同じ順
+    caller_names = {'other', 'capture (T0)', 'compute (T3)', 'stream (tcpip)'};
+
+    if ~isempty(remote_ip)
+        sender = dsp.UDPSender('RemoteIPAddress', remote_ip, 'RemoteIPPort', 9000);
+        setup(sender);
+        step(sender, uint8('PROF RESET').');
+        release(sender);
+        fprintf('Sent PROF RESET to %s\n', remote_ip);
+    end
+
+    snaps = receive_udp(duration_s);
+    if numel(snaps) < 2
+        fprintf('Need at least 2 packets (got %d).\n', numel(snaps));
+        return;
+    end
+    for k = numel(caller_names) + 1:size(snaps(end).stats, 1)
+        caller_names{k} = sprintf('caller%d', k - 1);
+    end
+
+    print_summary(caller_names, snaps);
+    plot_timeline(caller_names, snaps);
+end
+
+function snaps = receive_udp(duration_s)
+    udp_port = 9000;
+    magic = uint32(hex2dec('314D5248')); % "HRM1"
+    header_size = 16;                     % uint32*3 + uint16*2
+
+    udp_obj = dsp.UDPReceiver( ...
+        'LocalIPPort', udp_port, ...
+        'MessageDataType', 'uint8', ...
+        'MaximumMessageLength', 1500);
+    setup(udp_obj);
+    cleanup = onCleanup(@() release(udp_obj));
+
+    fprintf('Waiting for HyperRAM stats on port %d (%d s)...\n', udp_port, duration_s);
+    snaps = struct('uptime_ms', {}, 'cpu_hz', {}, 'stats', {});
+    t0 = tic;
+    while toc(t0) < duration_s
+        data = udp_obj();
+        if numel(data) < header_size
+            pause(0.001);
+            continue;
+        end
+        data = uint8(data(:)).';
+        if typecast(data(1:4), 'uint32') ~= magic
+            continue; % 映像チャンク / 他のテレメトリ
+        end
+        hdr = double(typecast(data(5:12), 'uint32'));
+        caller_count = double(typecast(data(13:14), 'uint16'));
+        word_count = double(typecast(data(15:16), 'uint16'));
+        body = double(typecast(data(header_size + 1:end), 'uint32'));
+        if word_count < 14 || numel(body) < caller_count * word_count
+            continue;
+        end
+        w = reshape(body(1:caller_count * word_count), word_count, caller_count).';
+        stats = [w(:, 1), w(:, 2), ...
+                 w(:, 3) + w(:, 4) * 2^32, w(:, 5) + w(:, 6) * 2^32, ...
+                 w(:, 7) + w(:, 8) * 2^32, w(:, 9) + w(:, 10) * 2^32, ...
+                 w(:, 11:14)];
+        snaps(end + 1) = struct('uptime_ms', hdr(2), 'cpu_hz', hdr(1), 'stats', stats); %#ok<AGROW>
+    end
+    clear cleanup;
+end
+
+function print_summary(caller_names, snaps)
+    first = snaps(1);
+    last = snaps(end);
+    hz = last.cpu_hz;
+    dt = (last.uptime_ms - first.uptime_ms) / 1000;
+    d = last.stats - first.stats;
+    d(:, 1:2) = mod(d(:, 1:2), 2^32);   % 32bit 回数は周回
+    d(:, 9:10) = mod(d(:, 9:10), 2^32);
+    tx = d(:, 1) + d(:, 2);
+
+    fprintf('\n%d packets over %.1f s\n', numel(snaps), dt);
+    fprintf('%-16s %8s %8s %8s %7s %7s %10s %10s %9s %8s\n', 'caller', 'rd MB/s', 'wr MB/s', 'tx/s', ...
+            'hold%', 'wait%', 'wait/tx us', 'maxwait us', 'timeout/s', 'wv retry');
+    for c = 1:numel(caller_names)
+        mean_wait = NaN;
+        if tx(c) > 0
+            mean_wait = d(c, 5) / tx(c) * 1e6 / hz;
+        end
+        fprintf('%-16s %8.2f %8.2f %8.0f %7.2f %7.2f %10.2f %10.1f %9.2f %8d\n', caller_names{c}, ...
+                d(c, 3) / dt / 1e6, d(c, 4) / dt / 1e6, tx(c) / dt, ...
+                100 * d(c, 6) / (dt * hz), 100 * d(c, 5) / (dt * hz), mean_wait, ...
+                last.stats(c, 7) * 1e6 / hz, d(c, 9) / dt, d(c, 10));
+    end
+    fprintf('%-16s %8.2f %8.2f %8.0f %7.2f\n', 'total', sum(d(:, 3)) / dt / 1e6, sum(d(:, 4)) / dt / 1e6, ...
+            sum(tx) / dt, 100 * sum(d(:, 6)) / (dt * hz));
+    fprintf('(maxwait is the maximum since boot / PROF RESET)\n');
+end
+
+function plot_timeline(caller_names, snaps)
+    fig = figure('Name', 'RA8E1 HyperRAM bus by caller', 'NumberTitle', 'off');
+    t = [snaps.uptime_ms] / 1000;
+    dt = diff(t(:));
+    hz = snaps(end).cpu_hz;
+    n = numel(snaps);
+    num_callers = numel(caller_names);
+
+    hold_share = zeros(n - 1, num_callers);
+    wait_share = zeros(n - 1, num_callers);
+    mbps = zeros(n - 1, num_callers);
+    timeouts = zeros(n - 1, num_callers);
+    for k = 2:n
+        d = snaps(k).stats - snaps(k - 1).stats;
+        hold_share(k - 1, :) = 100 * d(:, 6).' / (dt(k - 1) * hz);
+        wait_share(k - 1, :) = 100 * d(:, 5).' / (dt(k - 1) * hz);
+        mbps(k - 1, :) = (d(:, 3) + d(:, 4)).' / dt(k - 1) / 1e6;
+        timeouts(k - 1, :) = mod(d(:, 9), 2^32).' / dt(k - 1);
+    end
+    tk = t(2:end);
+
+    ax = subplot(2, 2, 1, 'Parent', fig);
+    area(ax, tk, hold_share);
+    ylabel(ax, 'bus held [%]');
+    title(ax, 'Mutex hold (bus occupancy)');
+    legend(ax, caller_names, 'Location', 'best', 'Interpreter', 'none');
+    grid(ax, 'on');
+
+    ax = subplot(2, 2, 2, 'Parent', fig);
+    plot(ax, tk, wait_share, '.-');
+    ylabel(ax, 'waiting [%]');
+    title(ax, 'Mutex wait');
+    grid(ax, 'on');
+
+    ax = subplot(2, 2, 3, 'Parent', fig);
+    plot(ax, tk, mbps, '.-');
+    ylabel(ax, 'MB/s (read + write)');
+    xlabel(ax, 'uptime [s]');
+    grid(ax, 'on');
+
+    ax = subplot(2, 2, 4, 'Parent', fig);
+    plot(ax, tk, timeouts, '.-');
+    ylabel(ax, 'FSP\_ERR\_TIMEOUT / s');
+    xlabel(ax, 'uptime [s]');
+    grid(ax, 'on');
+end
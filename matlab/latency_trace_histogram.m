@@ -0,0 +1,157 @@
+function lat_us = latency_trace_histogram(source, num_records)
+    % RA8E1 遅延トレース(latency_trace.c)の stage 別ヒストグラム
+    %
+    % 使い方:
+    %   latency_trace_histogram()                   % UDP 9000 から 500 フレーム分受信
+    %   latency_trace_histogram('udp', 2000)        % UDP で 2000 フレーム
+    %   latency_trace_histogram('teraterm.log')     % CDC ログ("[LAT] ..." 行)を解析
+    %
+    % 値は各フレームの CEU FRAME_END からの経過時間 [us]．未到達の stage は NaN．
+    % 戻り値 lat_us: [N x 8] (列順は stage_names と同じ)
+    %
+    % UDP: udp_photo_receiver と同じポートを使うので同時には動かさないこと．
+    %      映像チャンクは magic が異なるので読み捨てる．
+
+    if nargin < 1 || isempty(source)
+        source = 'udp';
+    end
+    if nargin < 2 || isempty(num_records)
+        num_records = 500;
+    end
+
+    stage_names = {'HyperRAM publish', 'PQ done', 'HLAC done', 'LDA decision', ...
+                   'motor post', 'GPT applied', 'UDP first', 'UDP last'};
+    num_stages = numel(stage_names);
+
+    if strcmpi(source, 'udp')
+        [seq, lat_us] = receive_udp(num_records, num_stages);
+    else
+        [seq, lat_us] = parse_cdc_log(source, num_stages);
+    end
+
+    if isempty(seq)
+        fprintf('No latency records.\n');
+        return;
+    end
+
+    % 重複(再送)を除いて seq 順に並べる
+    [seq, idx] = unique(seq);
+    lat_us = lat_us(idx, :);
+    fprintf('%d frames (seq %u..%u, %d missing)\n', numel(seq), seq(1), seq(end), ...
+            double(seq(end) - seq(1) + 1) - numel(seq));
+
+    print_summary(stage_names, lat_us);
+    plot_histograms(stage_names, lat_us);
+end
+
+function [seq, lat_us] = receive_udp(num_records, num_stages)
+    udp_port = 9000;
+    magic = uint32(hex2dec('4C545231')); % "LTR1"
+    header_size = 12;                     % uint32*2 + uint16*2
+
+    udp_obj = dsp.UDPReceiver( ...
+        'LocalIPPort', udp_port, ...
+        'MessageDataType', 'uint8', ...
+        'MaximumMessageLength', 1024);
+    setup(udp_obj);
+    cleanup = onCleanup(@() release(udp_obj));
+
+    fprintf('Waiting for latency trace packets on port %d...\n', udp_port);
+    seq = zeros(0, 1, 'uint32');
+    lat_us = zeros(0, num_stages);
+    t0 = tic;
+    while numel(seq) < num_records && toc(t0) < 600
+        data = udp_obj();
+        if numel(data) < header_size
+            pause(0.001);
+            continue;
+        end
+        if typecast(uint8(data(1:4)), 'uint32') ~= magic
+            continue; % 映像チャンク
+        end
+        cpu_hz = double(typecast(uint8(data(5:8)), 'uint32'));
+        stage_count = double(typecast(uint8(data(9:10)), 'uint16'));
+        record_count = double(typecast(uint8(data(11:12)), 'uint16'));
+        rec_words = 1 + stage_count;
+        body = typecast(uint8(data(header_size + 1:end)), 'uint32');
+        if numel(body) < record_count * rec_words || stage_count < num_stages + 1 || cpu_hz <= 0
+            continue;
+        end
+        recs = reshape(body(1:record_count * rec_words), rec_words, record_count).';
+        for r = 1:record_count
+            cyc = double(recs(r, 2:end));
+            row = nan(1, num_stages);
+            if cyc(1) ~= 0
+                for s = 1:num_stages
+                    if cyc(s + 1) ~= 0
+                        d = mod(cyc(s + 1) - cyc(1), 2^32); % CYCCNT の周回を考慮
+                        row(s) = d * 1e6 / cpu_hz;
+                    end
+                end
+            end
+            seq(end + 1, 1) = recs(r, 1); %#ok<AGROW>
+            lat_us(end + 1, :) = row; %#ok<AGROW>
+        end
+        if mod(numel(seq), 50) < record_count
+            fprintf('  %d / %d frames\n', numel(seq), num_records);
+        end
+    end
+    clear cleanup;
+end
+
+function [seq, lat_us] = parse_cdc_log(filename, num_stages)
+    % "[LAT] seq,pub,pq,hlac,lda,post,gpt,udp0,udp1" (us, -1 = 未到達)
+    txt = fileread(filename);
+    lines = regexp(txt, '\[LAT\]\s*([-0-9,]+)', 'tokens');
+    seq = zeros(numel(lines), 1, 'uint32');
+    lat_us = nan(numel(lines), num_stages);
+    n = 0;
+    for i = 1:numel(lines)
+        v = sscanf(lines{i}{1}, '%ld,').';
+        if numel(v) ~= num_stages + 1
+            continue; % 途中で切れた行
+        end
+        n = n + 1;
+        seq(n) = uint32(v(1));
+        row = v(2:end);
+        row(row < 0) = NaN;
+        lat_us(n, :) = row;
+    end
+    seq = seq(1:n);
+    lat_us = lat_us(1:n, :);
+end
+
+function print_summary(stage_names, lat_us)
+    fprintf('%-18s %6s %9s %9s %9s %9s\n', 'stage', 'n', 'p50[ms]', 'p95[ms]', 'p99[ms]', 'max[ms]');
+    for s = 1:numel(stage_names)
+        v = lat_us(~isnan(lat_us(:, s)), s) / 1000;
+        if isempty(v)
+            fprintf('%-18s %6d %9s %9s %9s %9s\n', stage_names{s}, 0, '-', '-', '-', '-');
+            continue;
+        end
+        fprintf('%-18s %6d %9.2f %9.2f %9.2f %9.2f\n', stage_names{s}, numel(v), ...
+                prctile(v, 50), prctile(v, 95), prctile(v, 99), max(v));
+    end
+end
+
+function plot_histograms(stage_names, lat_us)
+    fig = figure('Name', 'RA8E1 latency from CEU FRAME_END', 'NumberTitle', 'off');
+    num_stages = numel(stage_names);
+    cols = 4;
+    rows = ceil(num_stages / cols);
+    for s = 1:num_stages
+        ax = subplot(rows, cols, s, 'Parent', fig);
+        v = lat_us(~isnan(lat_us(:, s)), s) / 1000;
+        if isempty(v)
+            title(ax, sprintf('%s (no data)', stage_names{s}));
+            continue;
+        end
+        histogram(ax, v, 40);
+        hold(ax, 'on');
+        xline(ax, prctile(v, 50), 'g-', 'p50');
+        xline(ax, prctile(v, 99), 'r-', 'p99');
+        hold(ax, 'off');
+        title(ax, sprintf('%s (n=%d)', stage_names{s}, numel(v)));
+        xlabel(ax, 'ms');
+    end
+end
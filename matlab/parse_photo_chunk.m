@@ -0,0 +1,63 @@
+function [hdr, payload] = parse_photo_chunk(data)
+% RA8E1 映像チャンク(udp_photo_header_t)のヘッダー解析
+%
+% 対応ヘッダー(リトルエンディアン):
+%   v1: 24 bytes, magic 0x12345678
+%       magic, total_size, chunk_index, total_chunks, chunk_offset (uint32) + chunk_data_size, checksum (uint16)
+%   v2: 28 bytes, magic 0x12345679 (ファームの UDP_PHOTO_HEADER_SEQ=1)
+%       chunk_offset の後に frame_seq (uint32) が入る
+%
+% 出力:
+%   hdr.valid        false なら映像チャンクではない(他の値は未設定)
+%   hdr.header_size  24 / 28
+%   hdr.has_seq      v2 なら true
+%   hdr.frame_seq    v2 のフレーム番号(v1 は 0)
+%   hdr.total_size, hdr.chunk_index, hdr.total_chunks, hdr.chunk_offset, hdr.chunk_data_size (double)
+%   payload          チャンクデータ(chunk_data_size で切り詰め済み, uint8 列ベクトル)
+
+hdr = struct('valid', false);
+payload = zeros(0, 1, 'uint8');
+
+data = uint8(data(:));
+if numel(data) < 24
+    return;
+end
+
+magic = typecast(data(1:4), 'uint32');
+if magic == uint32(hex2dec('12345679'))
+    hs = 28;
+    has_seq = true;
+elseif magic == uint32(hex2dec('12345678'))
+    hs = 24;
+    has_seq = false;
+else
+    return;
+end
+if numel(data) < hs
+    return;
+end
+
+hdr.header_size = hs;
+hdr.has_seq = has_seq;
+hdr.total_size = double(typecast(data(5:8), 'uint32'));
+hdr.chunk_index = double(typecast(data(9:12), 'uint32'));
+hdr.total_chunks = double(typecast(data(13:16), 'uint32'));
+hdr.chunk_offset = double(typecast(data(17:20), 'uint32'));
+if has_seq
+    hdr.frame_seq = double(typecast(data(21:24), 'uint32'));
+else
+    hdr.frame_seq = 0;
+end
+hdr.chunk_data_size = double(typecast(data(hs-3:hs-2), 'uint16'));
+
+if hdr.total_size <= 0 || hdr.total_chunks <= 0 || hdr.chunk_index >= hdr.total_chunks
+    return;
+end
+
+n = min(hdr.chunk_data_size, numel(data) - hs);
+if n <= 0
+    return;
+end
+payload = data(hs+1:hs+n);
+hdr.valid = true;
+end
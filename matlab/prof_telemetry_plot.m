@@ -0,0 +1,232 @@
+function snaps = prof_telemetry_plot(duration_s, remote_ip)
+    % RA8E1 プロファイラ(prof.c)の "PRF1" テレメトリを受信して表示
+    %
+    % 使い方:
+    %   prof_telemetry_plot()                       % UDP 9000 で 30 秒受信
+    %   prof_telemetry_plot(120)                    % 120 秒
+    %   prof_telemetry_plot(60, '192.168.1.100')    % 先に "PROF RESET" を送ってから受信
+    %
+    % ファームは映像ストリーム中に PROF_UDP_PERIOD_MS(既定 1 秒)ごとにスナップショットを送る．
+    % 値は起動(または PROF RESET)からの累積なので，区間ごとの値は隣り合うスナップショットの差．
+    % 戻り値 snaps: 受信できたスナップショットの struct 配列
+    %   .seq .uptime_ms .cpu_hz .counters [1 x C] .count/.min/.max/.sum [1 x S] .hist [S x B]
+    %
+    % UDP: udp_photo_receiver と同じポートを使うので同時には動かさないこと．
+    %      映像チャンクと LTR1 パケットは magic が異なるので読み捨てる．
+
+    if nargin < 1 || isempty(duration_s)
+        duration_s = 30;
+    end
+    if nargin < 2
+        remote_ip = '';
+    end
+
+    % src/prof.h の enum と同じ順
+    span_names = {'pq128.row', 'pq128.tile', 'hyperram.read', 'hyperram.write', ...
+                  'hyperram.wait', 'fft.rows', 'fft.xpose', 'fft.cols', ...
+                  'fc.build', 'fc.fft', 'fc.zhat', 'fc.ifft', 'fc.export', ...
+                  'hlac', 'lda', 'udp.chunk'};
+    counter_names = {'hyperram.read_bytes', 'hyperram.write_bytes', 'hyperram.timeouts', ...
+                     'udp.chunks', 'udp.bytes', 'udp.reschedules', 'udp.send_errors'};
+
+    if ~isempty(remote_ip)
+        send_reset(remote_ip);
+    end
+
+    [snaps, hist_shift] = receive_udp(duration_s);
+    if numel(snaps) < 2
+        fprintf('Need at least 2 complete snapshots (got %d).\n', numel(snaps));
+        return;
+    end
+
+    span_names = pad_names(span_names, numel(snaps(end).count), 'span');
+    counter_names = pad_names(counter_names, numel(snaps(end).counters), 'counter');
+
+    print_summary(span_names, counter_names, snaps, hist_shift);
+    plot_histograms(span_names, snaps(end), hist_shift);
+    plot_timeline(span_names, counter_names, snaps);
+end
+
+function send_reset(remote_ip)
+    sender = dsp.UDPSender('RemoteIPAddress', remote_ip, 'RemoteIPPort', 9000);
+    setup(sender);
+    step(sender, uint8('PROF RESET').');
+    release(sender);
+    fprintf('Sent PROF RESET to %s\n', remote_ip);
+end
+
+function [snaps, hist_shift] = receive_udp(duration_s)
+    udp_port = 9000;
+    magic = uint32(hex2dec('31465250')); % "PRF1"
+    header_size = 24;                     % uint32*4 + uint8*6 + uint16
+
+    udp_obj = dsp.UDPReceiver( ...
+        'LocalIPPort', udp_port, ...
+        'MessageDataType', 'uint8', ...
+        'MaximumMessageLength', 1500);
+    setup(udp_obj);
+    cleanup = onCleanup(@() release(udp_obj));
+
+    fprintf('Waiting for profiler snapshots on port %d (%d s)...\n', udp_port, duration_s);
+    snaps = struct('seq', {}, 'uptime_ms', {}, 'cpu_hz', {}, 'counters', {}, ...
+                   'count', {}, 'min', {}, 'max', {}, 'sum', {}, 'hist', {});
+    hist_shift = 8;
+    cur = [];
+    got = [];
+    t0 = tic;
+    while toc(t0) < duration_s
+        data = udp_obj();
+        if numel(data) < header_size
+            pause(0.001);
+            continue;
+        end
+        data = uint8(data(:)).';
+        if typecast(data(1:4), 'uint32') ~= magic
+            continue; % 映像チャンク / 遅延トレース
+        end
+        hdr = double(typecast(data(5:16), 'uint32'));
+        span_count = double(data(17));
+        first_span = double(data(18));
+        n_spans = double(data(19));
+        counter_count = double(data(20));
+        buckets = double(data(21));
+        hist_shift = double(data(22));
+        rec_words = 5 + buckets;
+        body = double(typecast(data(header_size + 1:end), 'uint32'));
+        if numel(body) < counter_count + n_spans * rec_words || first_span + n_spans > span_count
+            continue;
+        end
+
+        seq = hdr(2);
+        if isempty(cur) || cur.seq ~= seq
+            cur = struct('seq', seq, 'uptime_ms', hdr(3), 'cpu_hz', hdr(1), ...
+                         'counters', zeros(1, counter_count), ...
+                         'count', zeros(1, span_count), 'min', zeros(1, span_count), ...
+                         'max', zeros(1, span_count), 'sum', zeros(1, span_count), ...
+                         'hist', zeros(span_count, buckets));
+            got = false(1, span_count);
+        end
+        cur.counters = body(1:counter_count);
+        recs = reshape(body(counter_count + 1:counter_count + n_spans * rec_words), rec_words, n_spans).';
+        idx = first_span + (1:n_spans);
+        cur.count(idx) = recs(:, 1).';
+        cur.min(idx) = recs(:, 2).';
+        cur.max(idx) = recs(:, 3).';
+        cur.sum(idx) = (recs(:, 4) + recs(:, 5) * 2^32).';
+        cur.hist(idx, :) = recs(:, 6:end);
+        got(idx) = true;
+
+        if all(got)
+            snaps(end + 1) = cur; %#ok<AGROW>
+            got(:) = false;
+            fprintf('  snapshot %u (uptime %.1f s)\n', seq, cur.uptime_ms / 1000);
+        end
+    end
+    clear cleanup;
+end
+
+function names = pad_names(names, n, prefix)
+    % ファーム側で項目が増えていても表示できるように
+    for k = numel(names) + 1:n
+        names{k} = sprintf('%s%d', prefix, k - 1);
+    end
+    names = names(1:n);
+end
+
+function us = hist_percentile_us(hist_row, max_cyc, hist_shift, cpu_hz, p)
+    % bucket 0 = [0, 2^shift)，bucket k = [2^(k+shift-1), 2^(k+shift))．バケット上端で近似
+    total = sum(hist_row);
+    if total == 0
+        us = NaN;
+        return;
+    end
+    k = find(cumsum(hist_row) >= p * total, 1) - 1;
+    upper = min(2^(k + hist_shift), max_cyc);
+    us = upper * 1e6 / cpu_hz;
+end
+
+function print_summary(span_names, counter_names, snaps, hist_shift)
+    first = snaps(1);
+    last = snaps(end);
+    hz = last.cpu_hz;
+    dt = (last.uptime_ms - first.uptime_ms) / 1000;
+    fprintf('\n%d snapshots over %.1f s (cumulative stats since boot / PROF RESET)\n', numel(snaps), dt);
+    fprintf('%-16s %9s %8s %10s %10s %10s %10s %10s\n', 'span', 'count', 'rate/s', ...
+            'mean[us]', 'min[us]', 'p50[us]', 'p99[us]', 'max[us]');
+    for s = 1:numel(span_names)
+        n = last.count(s);
+        if n == 0
+            fprintf('%-16s %9d %8s %10s %10s %10s %10s %10s\n', span_names{s}, 0, '-', '-', '-', '-', '-', '-');
+            continue;
+        end
+        rate = (n - first.count(s)) / max(dt, eps);
+        fprintf('%-16s %9d %8.1f %10.1f %10.1f %10.1f %10.1f %10.1f\n', span_names{s}, n, rate, ...
+                last.sum(s) / n * 1e6 / hz, last.min(s) * 1e6 / hz, ...
+                hist_percentile_us(last.hist(s, :), last.max(s), hist_shift, hz, 0.50), ...
+                hist_percentile_us(last.hist(s, :), last.max(s), hist_shift, hz, 0.99), ...
+                last.max(s) * 1e6 / hz);
+    end
+    fprintf('\n%-22s %14s %14s\n', 'counter', 'total', 'rate/s');
+    for c = 1:numel(counter_names)
+        d = mod(last.counters(c) - first.counters(c), 2^32); % 32bit で周回
+        fprintf('%-22s %14d %14.1f\n', counter_names{c}, last.counters(c), d / max(dt, eps));
+    end
+end
+
+function plot_histograms(span_names, snap, hist_shift)
+    fig = figure('Name', 'RA8E1 profiler: cycle histograms', 'NumberTitle', 'off');
+    num_spans = numel(span_names);
+    buckets = size(snap.hist, 2);
+    lower_cyc = [0, 2.^(hist_shift + (0:buckets - 2))];
+    cols = 4;
+    rows = ceil(num_spans / cols);
+    for s = 1:num_spans
+        ax = subplot(rows, cols, s, 'Parent', fig);
+        if snap.count(s) == 0
+            title(ax, sprintf('%s (no data)', span_names{s}));
+            continue;
+        end
+        used = find(snap.hist(s, :) > 0);
+        k = used(1):used(end);
+        bar(ax, k, snap.hist(s, k), 1);
+        ticks = k(1:max(1, ceil(numel(k) / 4)):end);
+        set(ax, 'XTick', ticks, 'XTickLabel', ...
+            arrayfun(@(b) sprintf('%.3g', lower_cyc(b) * 1e6 / snap.cpu_hz), ticks, 'UniformOutput', false));
+        title(ax, sprintf('%s (n=%d)', span_names{s}, snap.count(s)));
+        xlabel(ax, 'us (bucket lower edge)');
+    end
+end
+
+function plot_timeline(span_names, counter_names, snaps)
+    fig = figure('Name', 'RA8E1 profiler: per-interval', 'NumberTitle', 'off');
+    t = [snaps.uptime_ms] / 1000;
+    dt = diff(t);
+    hz = snaps(end).cpu_hz;
+
+    count = vertcat(snaps.count);
+    total = vertcat(snaps.sum);
+    dn = diff(count, 1, 1);
+    busy = diff(total, 1, 1) / hz ./ dt(:); % 1 秒あたりの区間時間 = 占有率
+
+    ax = subplot(2, 1, 1, 'Parent', fig);
+    active = find(any(dn > 0, 1));
+    plot(ax, t(2:end), 100 * busy(:, active), '.-');
+    legend(ax, span_names(active), 'Location', 'eastoutside', 'Interpreter', 'none');
+    ylabel(ax, 'busy [%]');
+    title(ax, 'Time in span per interval (nested spans overlap)');
+    grid(ax, 'on');
+
+    ax = subplot(2, 1, 2, 'Parent', fig);
+    ctr = vertcat(snaps.counters);
+    rate = mod(diff(ctr, 1, 1), 2^32) ./ dt(:);
+    bytes = contains(counter_names, 'bytes');
+    yyaxis(ax, 'left');
+    plot(ax, t(2:end), rate(:, bytes) / 1e6, '.-');
+    ylabel(ax, 'MB/s');
+    yyaxis(ax, 'right');
+    plot(ax, t(2:end), rate(:, ~bytes), 'x-');
+    ylabel(ax, 'events/s');
+    legend(ax, [counter_names(bytes), counter_names(~bytes)], 'Location', 'eastoutside', 'Interpreter', 'none');
+    xlabel(ax, 'uptime [s]');
+    grid(ax, 'on');
+end
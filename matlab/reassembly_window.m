@@ -0,0 +1,221 @@
+function varargout = reassembly_window(cmd, varargin)
+% 複数フレーム並行の再構成ウィンドウ(C# の ReassemblyWindow と同じ規則)
+%
+% 使い方:
+%   win = reassembly_window('new', capacity, deadline_sec)       % 既定 4, 1.0
+%   [win, frames] = reassembly_window('add', win, hdr, payload)  % hdr/payload は parse_photo_chunk の出力
+%   [win, frames] = reassembly_window('drain', win)              % 完成済み/期限切れを出す
+%   [win, frames] = reassembly_window('flush', win)              % 組み立て中を全部出す
+%
+% - フレーム番号(v2 ヘッダーの frame_seq)ごとに最大 capacity フレームを並行して組み立てる．
+%   chunk 0 が遅れて/欠けて届いても，前後のフレームは壊れない．
+% - 出力は必ず frame_seq 昇順．完成したフレームでも，それより古い組み立て中のフレームが
+%   出るまで待つ．各フレームは最初のチャンクから deadline_sec で打ち切って欠けありで出す．
+%   ウィンドウが一杯のまま新しいフレームが来たときも，最古を欠けありで出す．
+% - 出力済みフレームへのチャンクは遅着として捨てる(win.late_chunks)．
+%   1 チャンクも届かなかったフレーム番号は win.lost_frames に数える．
+% - v1 ヘッダー(frame_seq なし)は chunk 0 を次のフレームとみなす(従来と同じ挙動)．
+%
+% frames: 構造体配列(0 個以上)
+%   .seq, .total_size, .total_chunks
+%   .data     uint8 [total_size x 1]，欠けたチャンクは 0
+%   .mask     logical [total_chunks x 1]，届いたチャンクが true
+%   .missing  欠けチャンク数
+%   .elapsed  最初のチャンクから出力までの秒数
+
+switch cmd
+    case 'new'
+        capacity = 4;
+        deadline_sec = 1.0;
+        if numel(varargin) >= 1 && ~isempty(varargin{1})
+            capacity = varargin{1};
+        end
+        if numel(varargin) >= 2 && ~isempty(varargin{2})
+            deadline_sec = varargin{2};
+        end
+        win.slots = repmat(empty_slot(), max(1, round(capacity)), 1);
+        win.deadline_sec = deadline_sec;
+        win.started = false;
+        win.next_seq = 0;    % まだ出力できる最小のフレーム番号
+        win.legacy_seq = 0;  % v1 ヘッダー用
+        win.late_chunks = 0;
+        win.lost_frames = 0;
+        varargout = {win};
+    case 'add'
+        [win, frames] = window_add(varargin{1}, varargin{2}, varargin{3});
+        varargout = {win, frames};
+    case 'drain'
+        [win, frames] = window_drain(varargin{1});
+        varargout = {win, frames};
+    case 'flush'
+        [win, frames] = window_flush(varargin{1});
+        varargout = {win, frames};
+    otherwise
+        error('reassembly_window: unknown command "%s"', cmd);
+end
+end
+
+function [win, frames] = window_add(win, hdr, payload)
+% 送信元の再起動とみなす遅れ(これ以上古いフレーム番号は遅着ではない)
+restart_gap = 64;
+
+frames = empty_frames();
+if ~hdr.valid
+    return;
+end
+
+if hdr.has_seq
+    seq = hdr.frame_seq;
+else
+    if hdr.chunk_index == 0
+        win.legacy_seq = mod(win.legacy_seq + 1, 2^32);
+    end
+    seq = win.legacy_seq;
+end
+
+if win.started
+    d = seq_diff(seq, win.next_seq);
+    if d < 0
+        if d > -restart_gap
+            win.late_chunks = win.late_chunks + 1;
+            return;
+        end
+        [win, frames] = window_flush(win);
+        win.started = false;
+    end
+end
+
+k = find_slot(win, seq);
+if isempty(k)
+    [win, k, out] = open_slot(win, seq, hdr.total_chunks, hdr.total_size);
+    frames = [frames; out];
+    if isempty(k)
+        win.late_chunks = win.late_chunks + 1;
+        return;
+    end
+end
+
+idx = hdr.chunk_index + 1;
+off = hdr.chunk_offset;
+if idx <= win.slots(k).total_chunks && ~win.slots(k).mask(idx) && off < win.slots(k).total_size
+    n = min(numel(payload), win.slots(k).total_size - off);
+    win.slots(k).data(off+1:off+n) = payload(1:n);
+    win.slots(k).mask(idx) = true;
+    win.slots(k).count = win.slots(k).count + 1;
+end
+
+[win, out] = window_drain(win);
+frames = [frames; out];
+end
+
+function [win, frames] = window_drain(win)
+frames = empty_frames();
+while true
+    o = oldest_slot(win);
+    if isempty(o)
+        return;
+    end
+    s = win.slots(o);
+    if s.count < s.total_chunks && toc(s.t0) <= win.deadline_sec
+        return;
+    end
+    [win, fr] = emit_slot(win, o);
+    frames = [frames; fr]; %#ok<AGROW>
+end
+end
+
+function [win, frames] = window_flush(win)
+frames = empty_frames();
+o = oldest_slot(win);
+while ~isempty(o)
+    [win, fr] = emit_slot(win, o);
+    frames = [frames; fr]; %#ok<AGROW>
+    o = oldest_slot(win);
+end
+end
+
+function [win, k, frames] = open_slot(win, seq, total_chunks, total_size)
+frames = empty_frames();
+k = [];
+capacity = numel(win.slots);
+while true
+    o = oldest_slot(win);
+    f = free_slot(win);
+    if isempty(o)
+        break;
+    end
+    ahead = seq_diff(seq, win.slots(o).seq);
+    if ~isempty(f) && ahead < capacity
+        break;
+    end
+    if ahead < 0
+        return; % 組み立て中のどれよりも古く，空きもない: 入れると順序が崩れる
+    end
+    [win, fr] = emit_slot(win, o);
+    frames = [frames; fr]; %#ok<AGROW>
+end
+
+k = free_slot(win);
+win.slots(k).active = true;
+win.slots(k).seq = seq;
+win.slots(k).total_size = total_size;
+win.slots(k).total_chunks = total_chunks;
+win.slots(k).data = zeros(total_size, 1, 'uint8');
+win.slots(k).mask = false(total_chunks, 1);
+win.slots(k).count = 0;
+win.slots(k).t0 = tic;
+end
+
+function [win, fr] = emit_slot(win, k)
+fr = empty_frames();
+s = win.slots(k);
+win.slots(k) = empty_slot();
+if s.count == 0
+    return;
+end
+
+if win.started
+    d = seq_diff(s.seq, win.next_seq);
+    if d > 0
+        win.lost_frames = win.lost_frames + d;
+    end
+end
+win.next_seq = mod(s.seq + 1, 2^32);
+win.started = true;
+
+fr = struct('seq', s.seq, 'total_size', s.total_size, 'total_chunks', s.total_chunks, ...
+    'data', s.data, 'mask', s.mask, 'missing', s.total_chunks - s.count, 'elapsed', toc(s.t0));
+end
+
+function k = find_slot(win, seq)
+k = find([win.slots.active] & [win.slots.seq] == seq, 1);
+end
+
+function k = free_slot(win)
+k = find(~[win.slots.active], 1);
+end
+
+function k = oldest_slot(win)
+k = [];
+for i = 1:numel(win.slots)
+    if win.slots(i).active && (isempty(k) || seq_diff(win.slots(i).seq, win.slots(k).seq) < 0)
+        k = i;
+    end
+end
+end
+
+function d = seq_diff(a, b)
+% uint32 の周回を考慮した a - b
+d = mod(a - b + 2^31, 2^32) - 2^31;
+end
+
+function s = empty_slot()
+s = struct('active', false, 'seq', 0, 'total_size', 0, 'total_chunks', 0, ...
+    'data', zeros(0, 1, 'uint8'), 'mask', false(0, 1), 'count', 0, 't0', uint64(0));
+end
+
+function f = empty_frames()
+f = struct('seq', {}, 'total_size', {}, 'total_chunks', {}, 'data', {}, 'mask', {}, ...
+    'missing', {}, 'elapsed', {});
+f = f(:);
+end
@@ -0,0 +1,139 @@
+function send_synth_frame(img, remote_ip, remote_port, select_pattern)
+%SEND_SYNTH_FRAME Upload a grayscale image to the board's synthetic frame source.
+%
+% Requires firmware built with CAM_SYNTH_ENABLE=1. The board replaces camera
+% capture with this image (nearest-neighbour scaled to SYNTH_FRAME_W x H) and
+% pushes it through the normal depth / HLAC / UDP pipeline.
+%
+% Usage examples:
+%   cd matlab
+%   send_synth_frame('scene.png', '192.168.0.10')
+%   send_synth_frame(uint8(peaks(256) * 20 + 128), '192.168.0.10', 9000)
+%   send_synth_frame(img, ip, 9000, false)   % upload only, keep current pattern
+%
+% Patterns can also be switched by hand with a text datagram:
+%   "SYNTH gradient" / "SYNTH sphere" / "SYNTH checker" / "SYNTH upload"
+%
+% Upload packet format (little-endian):
+%   u8[4] "SYNF"
+%   u16   width
+%   u16   height
+%   u32   offset   (byte position in the row-major Y8 image)
+%   u8[]  payload
+% width*height must not exceed SYNTH_UPLOAD_MAX_BYTES (default 320*256) and
+% width must not exceed SYNTH_UPLOAD_MAX_W (default 320).
+%
+
+if nargin < 2 || isempty(remote_ip)
+    error('send_synth_frame: remote_ip (board address) is required');
+end
+if nargin < 3 || isempty(remote_port)
+    remote_port = 9000;
+end
+if nargin < 4 || isempty(select_pattern)
+    select_pattern = true;
+end
+
+if ischar(img) || isstring(img)
+    img = imread(img);
+end
+if ndims(img) == 3
+    img = rgb2gray(img);
+end
+img = im2uint8(img);
+
+[h, w] = size(img);
+if w * h > 320 * 256
+    error('send_synth_frame: %dx%d exceeds SYNTH_UPLOAD_MAX_BYTES (320*256)', w, h);
+end
+if w > 320
+    error('send_synth_frame: width %d exceeds SYNTH_UPLOAD_MAX_W (320)', w);
+end
+
+total_size = w * h;
+chunk_payload_max = 1024;
+payload = reshape(img.', [], 1); % row-major
+
+fprintf('Uploading %dx%d (%d bytes) to %s:%d\n', w, h, total_size, remote_ip, remote_port);
+
+use_udpport = exist('udpport', 'file') == 2;
+
+udp_obj = [];
+dsp_sender = [];
+try
+    if use_udpport
+        udp_obj = udpport('datagram', 'IPV4');
+    else
+        dsp_sender = dsp.UDPSender('RemoteIPAddress', remote_ip, 'RemoteIPPort', remote_port);
+        setup(dsp_sender);
+    end
+
+    for byte0 = 0:chunk_payload_max:(total_size - 1)
+        byte1 = min(byte0 + chunk_payload_max, total_size);
+        datagram = [ ...
+            uint8('SYNF').'; ...
+            u16le(w); ...
+            u16le(h); ...
+            u32le(byte0); ...
+            payload((byte0 + 1):byte1) ...
+        ];
+        send_datagram(datagram);
+        pause(0.002); % lwIP の pbuf プールを溢れさせない
+    end
+
+    if select_pattern
+        send_datagram(uint8('SYNTH upload').');
+    end
+
+    fprintf('Done.\n');
+
+catch ME
+    fprintf('Send failed: %s\n', ME.message);
+end
+
+try
+    if ~isempty(dsp_sender)
+        release(dsp_sender);
+    end
+catch
+end
+
+try
+    if ~isempty(udp_obj)
+        clear udp_obj;
+    end
+catch
+end
+
+    function send_datagram(datagram)
+        if use_udpport
+            write(udp_obj, datagram, 'uint8', remote_ip, remote_port);
+        else
+            step(dsp_sender, datagram);
+        end
+    end
+
+end
+
+function bytes = u32le(v)
+bytes = typecast(uint32(v), 'uint8');
+if ~is_little_endian()
+    bytes = flipud(bytes(:));
+else
+    bytes = bytes(:);
+end
+end
+
+function bytes = u16le(v)
+bytes = typecast(uint16(v), 'uint8');
+if ~is_little_endian()
+    bytes = flipud(bytes(:));
+else
+    bytes = bytes(:);
+end
+end
+
+function tf = is_little_endian()
+[~, ~, endian] = computer;
+tf = (endian == 'L');
+end
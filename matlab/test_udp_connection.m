@@ -56,24 +56,28 @@ function test_udp_connection()
                             dec2hex(typecast(data(1:min(4,end)), 'uint8')));
                 end
                 
-                % ヘッダー解析
+                % ヘッダー解析(v1: 24 bytes / v2: 28 bytes, frame_seq 付き)
+                [hdr, ~] = parse_photo_chunk(data);
                 if length(data) >= 24
                     magic = typecast(data(1:4), 'uint32');
                     
-                    if magic == uint32(hex2dec('12345678'))
+                    if hdr.valid
                         valid_packets = valid_packets + 1;
                         
-                        total_size = typecast(data(5:8), 'uint32');
-                        chunk_idx = typecast(data(9:12), 'uint32');
-                        total_chunks = typecast(data(13:16), 'uint32');
-                        frame_num = typecast(data(17:20), 'uint32');
+                        total_size = hdr.total_size;
+                        chunk_idx = hdr.chunk_index;
+                        total_chunks = hdr.total_chunks;
+                        frame_num = hdr.frame_seq;
                         
-                        % 新しいフレーム
-                        if chunk_idx == 0 && frame_num ~= last_frame_num
+                        % 新しいフレーム(v1 はフレーム番号が無いので chunk 0 ごとに数える)
+                        if chunk_idx == 0 && (~hdr.has_seq || frame_num ~= last_frame_num)
                             frame_count = frame_count + 1;
+                            if ~hdr.has_seq
+                                frame_num = frame_count;
+                            end
                             last_frame_num = frame_num;
                             
-                            fprintf('\nフレーム #%d:\n', frame_num);
+                            fprintf('\nフレーム #%d (header v%d):\n', frame_num, 1 + hdr.has_seq);
                             fprintf('  総サイズ: %d bytes\n', total_size);
                             fprintf('  チャンク数: %d\n', total_chunks);
                             fprintf('  期待パケット数: %d\n', total_chunks);
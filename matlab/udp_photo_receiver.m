@@ -41,37 +41,29 @@ function receive_video_stream(udp_obj, ax)
     
     fprintf('Starting video stream reception...\n');
     
-    % ヘッダー構造体定義 (C構造体に対応)
-    header_size = 24; % uint32*5 + uint16*2 = 24 bytes
-    
-    % フレーム管理変数
-    current_frame_num = 0;
-    packets = {};
-    total_chunks = 0;
-    total_size = 0;
+    % 複数フレーム並行の再構成ウィンドウ (reassembly_window.m)
+    % v2 ヘッダーは frame_seq で，v1 ヘッダーは chunk 0 でフレームを区切る
+    window_frames = 4;          % 同時に組み立てるフレーム数
+    frame_deadline_sec = 1;     % 欠けありで打ち切るまでの時間
+    win = reassembly_window('new', window_frames, frame_deadline_sec);
     
     % 画像ハンドル管理(グローバルに管理)
     img_handle = [];
     
     % タイムアウト・統計設定
-    frame_start_time = tic;
-    frame_timeout_sec = 10;     % フレームタイムアウト10秒
     total_timeout_sec = inf;    % 無制限受信(Ctrl+Cまたはウィンドウを閉じるまで)
     total_start_time = tic;
     
     % 統計情報
-    frames_received = 0;
+    frames_received = 0;        % 全チャンク揃ったフレーム
     frames_displayed = 0;
     last_stats_time = tic;
-
-    received_mask = [];
-    received_count = 0;
-    frame_completed = false;
     
     while toc(total_start_time) < total_timeout_sec
         try
             % 高速パケット連続受信(バッファ蓄積対応)
             packet_count = 0;
+            frames = [];
             while packet_count < 10  % 最大10パケット連続処理
                 data = udp_obj();
                 if isempty(data)
@@ -79,74 +71,29 @@ function receive_video_stream(udp_obj, ax)
                 end
                 packet_count = packet_count + 1;
                 
-                if length(data) >= header_size
-                    % 高速ヘッダー解析(関数コール削減)
-                    header_bytes = data(1:header_size);
-                    magic_number = typecast(header_bytes(1:4), 'uint32');
-                    
-                    % マジックナンバーチェック
-                    if magic_number == uint32(hex2dec('12345678'))
-                        total_size_val = typecast(header_bytes(5:8), 'uint32');
-                        chunk_index_val = typecast(header_bytes(9:12), 'uint32');
-                        total_chunks_val = typecast(header_bytes(13:16), 'uint32');
-                        chunk_data_size_val = typecast(header_bytes(21:22), 'uint16');
-                        
-                        chunk_data = data(header_size+1:end);
-                        
-                        % 新しいフレーム開始チェック
-                        if chunk_index_val == 0
-                            % 前のフレーム処理(完了チェック省略で高速化)
-                            if ~isempty(packets) && ~frame_completed
-                                img_handle = process_complete_frame_fast(packets, total_chunks, total_size, ax, img_handle);
-                                frames_displayed = frames_displayed + 1;
-                            end
-                            
-                            % 新フレーム初期化
-                            current_frame_num = current_frame_num + 1;
-                            total_chunks = double(total_chunks_val);
-                            total_size = double(total_size_val);
-                            packets = cell(total_chunks, 1);
-                            received_mask = false(total_chunks, 1);
-                            received_count = 0;
-                            frame_completed = false;
-                            frame_start_time = tic;
-                        end
-                        
-                        % パケット保存(境界チェック最小化)
-                        chunk_idx = double(chunk_index_val) + 1;
-                        if chunk_idx <= total_chunks && chunk_idx > 0
-                            actual_size = min(double(chunk_data_size_val), length(chunk_data));
-                            if actual_size > 0
-                                if isempty(packets{chunk_idx})
-                                    packets{chunk_idx} = chunk_data(1:actual_size);
-                                    received_mask(chunk_idx) = true;
-                                    received_count = received_count + 1;
-                                end
-                            end
-                        end
-
-                        % フレーム完了チェック(全チャンク受信で判定)
-                        if ~frame_completed && ~isempty(packets) && received_count == total_chunks
-                            img_handle = process_complete_frame_fast(packets, total_chunks, total_size, ax, img_handle);
-                            frames_received = frames_received + 1;
-                            frames_displayed = frames_displayed + 1;
-                            frame_completed = true;
-                        end
-                    end
+                [hdr, chunk_data] = parse_photo_chunk(data);
+                if hdr.valid
+                    [win, out] = reassembly_window('add', win, hdr, chunk_data);
+                    frames = [frames; out]; %#ok<AGROW>
                 end
             end
             
-            % フレームタイムアウトチェック
-            if ~isempty(packets) && toc(frame_start_time) > frame_timeout_sec
-                fprintf('Frame timeout after %.1f seconds\n', toc(frame_start_time));
-                packets = {};  % フレームを破棄
-                frame_start_time = tic;
+            % 期限切れフレームの払い出し(受信が途切れても出す)
+            [win, out] = reassembly_window('drain', win);
+            frames = [frames; out];
+            
+            % 出てきたフレームは frame_seq 順．表示は最新の1枚だけ
+            if ~isempty(frames)
+                frames_received = frames_received + sum([frames.missing] == 0);
+                img_handle = process_complete_frame_fast(frames(end), ax, img_handle);
+                frames_displayed = frames_displayed + 1;
             end
             
             % 統計表示(10秒ごと＋簡略化)
             if toc(last_stats_time) > 10
                 fps = frames_displayed/toc(total_start_time);
-                fprintf('Frames: %d (%.2f fps)\n', frames_displayed, fps);
+                fprintf('Frames: %d (%.2f fps), complete %d, lost %d, late chunks %d\n', ...
+                    frames_displayed, fps, frames_received, win.lost_frames, win.late_chunks);
                 last_stats_time = tic;
             end
             
@@ -168,27 +115,11 @@ function receive_video_stream(udp_obj, ax)
     fprintf('Video reception ended. Total frames: %d\n', frames_displayed);
 end
 
-function is_complete = check_frame_complete(packets)
-    % フレーム完了チェック
-    if isempty(packets)
-        is_complete = false;
-        return;
-    end
-    
-    % 全パケットが受信済みかチェック
-    is_complete = true;
-    for i = 1:length(packets)
-        if isempty(packets{i})
-            is_complete = false;
-            break;
-        end
-    end
-end
-
-function img_handle = process_complete_frame_fast(packets, total_chunks, total_size, ax, img_handle)
+function img_handle = process_complete_frame_fast(frame, ax, img_handle)
     % 高速フレーム処理(深度マップ表示)
-    % フレームデータ復元(高速版)
-    frame_data = reconstruct_frame_ultra_fast(packets, total_chunks, total_size);
+    % frame は reassembly_window の出力(欠けチャンクは 0 埋め済み)
+    frame_data = frame.data;
+    total_size = frame.total_size;
     
     % 深度マップを可視化(8bit grayscale; sender may use variable payload size)
     [w, h] = infer_frame_dims_from_total_size(total_size, 320, 240);
@@ -239,23 +170,6 @@ function [w, h] = infer_frame_dims_from_total_size(total_size, w0, h0)
     end
 end
 
-function frame_data = reconstruct_frame_ultra_fast(packets, total_chunks, total_size)
-    % 元の安全なフレーム復元(速度重視版)
-    
-    frame_data = zeros(total_size, 1, 'uint8');
-    
-    for i = 1:total_chunks
-        if ~isempty(packets{i})
-            chunk_data = packets{i};
-            start_pos = (i-1) * 512 + 1;
-            end_pos = start_pos + length(chunk_data) - 1;
-            if end_pos <= total_size
-                frame_data(start_pos:end_pos) = chunk_data;
-            end
-        end
-    end
-end
-
 function header = parse_header(header_bytes)
     % バイナリヘッダーを解析
     
@@ -268,15 +182,21 @@ function header = parse_header(header_bytes)
     header.chunk_index = typecast(header_bytes(9:12), 'uint32');
     header.total_chunks = typecast(header_bytes(13:16), 'uint32');
     header.chunk_offset = typecast(header_bytes(17:20), 'uint32');
-    header.chunk_data_size = typecast(header_bytes(21:22), 'uint16');
-    header.checksum = typecast(header_bytes(23:24), 'uint16');
+    hs = photo_header_size(header.magic_number);
+    if hs == 28
+        header.frame_seq = typecast(header_bytes(21:24), 'uint32');
+    end
+    header.chunk_data_size = typecast(header_bytes(hs-3:hs-2), 'uint16');
+    header.checksum = typecast(header_bytes(hs-1:hs), 'uint16');
 end
 
 function is_valid = verify_checksum(header_bytes)
     % ヘッダーチェックサム検証
     
     % チェックサムフィールドを除いてチェックサム計算
-    data_for_checksum = header_bytes(1:22); % 最後の2バイト(checksum)を除く
+    header_bytes = uint8(header_bytes(:));
+    hs = photo_header_size(typecast(header_bytes(1:4), 'uint32'));
+    data_for_checksum = header_bytes(1:hs-2); % 最後の2バイト(checksum)を除く
     
     % uint16配列に変換
     if mod(length(data_for_checksum), 2) ~= 0
@@ -297,10 +217,19 @@ function is_valid = verify_checksum(header_bytes)
     calculated_checksum = uint16(bitxor(uint16(sum_val), uint16(hex2dec('FFFF'))));
     
     % 受信したチェックサムと比較
-    received_checksum = typecast(header_bytes(23:24), 'uint16');
+    received_checksum = typecast(header_bytes(hs-1:hs), 'uint16');
     is_valid = (calculated_checksum == received_checksum);
 end
 
+function hs = photo_header_size(magic_number)
+    % v2 (frame_seq 付き) は 28 bytes, v1 は 24 bytes
+    if magic_number == uint32(hex2dec('12345679'))
+        hs = 28;
+    else
+        hs = 24;
+    end
+end
+
 function rgb_image = yuv422_to_rgb_fast(yuv_data, width, height)
     % 高速YUV422→RGB変換(ベクトル化処理)
     
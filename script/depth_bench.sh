@@ -0,0 +1,194 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+usage() {
+  cat <<'EOF'
+Usage:
+  ./script/depth_bench.sh [options]
+
+Builds bench/depth_bench.c for the host (Thread3 depth solvers unchanged, HyperRAM/FreeRTOS
+shimmed by bench/host) and prints one CSV covering:
+  fc128  x FC_FFT_N {128,256} x FC128_FIXED_POINT {0,1}
+  fc128_vs_f32 (FC128_FIXED_POINT=1 builds): fixed-point Z against the float FC Z, no fit
+  fc128 synth_sphere: src/synth_frame.c sphere frame -> PQ128 -> FC, against synth_frame_depth_truth()
+  mg, row (once; they do not depend on the FC build flags)
+
+Options:
+  -B, --build-dir <dir>     Object/binary dir (default: build/depth_bench)
+  -o, --out <path>          Also write the CSV here (default: stdout only)
+  --iters <n>               Solver runs per measurement (default: 20)
+  --surface <name>          sphere|plane|saddle|step|all (default: all)
+  --fft-n <list>            FC_FFT_N values, comma separated (default: 128,256)
+  --fixed <list>            FC128_FIXED_POINT values, comma separated (default: 0,1)
+  --cc <compiler>           Host C compiler (default: $CC or cc)
+  --cflags <flags>          Extra compiler flags (e.g. "-march=native")
+  -h, --help                Show this help
+
+Examples:
+  ./script/depth_bench.sh
+  ./script/depth_bench.sh --surface sphere --iters 100 -o depth_bench.csv
+  ./script/depth_bench.sh --fft-n 256 --fixed 0
+EOF
+}
+
+# Defaults
+build_dir=""
+out_path=""
+iters=20
+surface="all"
+fft_n_list="128,256"
+fixed_list="0,1"
+cc_bin="${CC:-cc}"
+extra_cflags=""
+
+# Parse args
+while [[ $# -gt 0 ]]; do
+  case "$1" in
+    -B|--build-dir)
+      build_dir="${2:-}"; shift 2;;
+    -o|--out)
+      out_path="${2:-}"; shift 2;;
+    --iters)
+      iters="${2:-}"; shift 2;;
+    --surface)
+      surface="${2:-}"; shift 2;;
+    --fft-n)
+      fft_n_list="${2:-}"; shift 2;;
+    --fixed)
+      fixed_list="${2:-}"; shift 2;;
+    --cc)
+      cc_bin="${2:-}"; shift 2;;
+    --cflags)
+      extra_cflags="${2:-}"; shift 2;;
+    -h|--help)
+      usage; exit 0;;
+    *)
+      echo "Unknown option: $1" >&2
+      usage
+      exit 2
+      ;;
+  esac
+done
+
+repo_root="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+cd "$repo_root"
+
+if [[ -z "$build_dir" ]]; then
+  build_dir="build/depth_bench"
+fi
+mkdir -p "$build_dir"
+
+cmsis="ra/arm/CMSIS-DSP"
+
+# FFT kernels used by fft_depth_test.c (f32 CFFT / q31 CFFT for the fixed-point FC).
+cmsis_srcs=(
+  "$cmsis/Source/TransformFunctions/arm_cfft_f32.c"
+  "$cmsis/Source/TransformFunctions/arm_cfft_init_f32.c"
+  "$cmsis/Source/TransformFunctions/arm_cfft_radix8_f32.c"
+  "$cmsis/Source/TransformFunctions/arm_cfft_q31.c"
+  "$cmsis/Source/TransformFunctions/arm_cfft_init_q31.c"
+  "$cmsis/Source/TransformFunctions/arm_cfft_radix4_q31.c"
+  "$cmsis/Source/TransformFunctions/arm_bitreversal.c"
+  "$cmsis/Source/TransformFunctions/arm_bitreversal2.c"
+  "$cmsis/Source/CommonTables/arm_const_structs.c"
+  # arm_common_tables.c の FFT 表(このチェックアウトには無いのでロード時に生成)
+  "bench/host/arm_fft_tables.c"
+)
+
+for f in "${cmsis_srcs[@]}"; do
+  if [[ ! -f "$f" ]]; then
+    echo "Missing $f" >&2
+    echo "The FSP pack normally ships CMSIS-DSP sources under $cmsis; restore them (e.g. regenerate with e2 studio/RASC) and retry." >&2
+    exit 1
+  fi
+done
+
+firmware_srcs=(
+  "bench/host/bench_host.c"
+  "src/fft_depth_test.c"
+  "src/hlac_lda_infer.c"
+  "src/hlac_lda_model.c"
+  "src/hlac_temporal.c"
+  "src/binlog.c"
+  "src/prof.c"
+  "src/synth_frame.c"
+  "src/xprintf/src/xprintf.c"
+)
+
+# __GNUC_PYTHON__: CMSIS-DSP の汎用 C 実装(ホスト用)を選ぶ
+# -Wno-int-to-pointer-cast: ファームは HyperRAM のオフセット(uint32_t)を (void *) にして
+#   hyperram_b_read/write へ渡す．32bit のターゲットでは正確で，64bit ホストでだけ警告になる
+cflags=(
+  -std=gnu11 -O2 -Wall -Wextra -Wno-int-to-pointer-cast
+  -D__GNUC_PYTHON__
+  -Ibench/host -Isrc -Isrc/xprintf/src
+  "-I$cmsis/Include" "-I$cmsis/PrivateInclude"
+)
+# shellcheck disable=SC2206
+cflags+=($extra_cflags)
+
+# CMSIS は FC の設定に依存しないので1回だけ作る
+cmsis_lib="$build_dir/libcmsis_fft.a"
+if [[ ! -f "$cmsis_lib" ]]; then
+  objs=()
+  for f in "${cmsis_srcs[@]}"; do
+    o="$build_dir/$(basename "${f%.c}").o"
+    "$cc_bin" "${cflags[@]}" -c "$f" -o "$o"
+    objs+=("$o")
+  done
+  ar rcs "$cmsis_lib" "${objs[@]}"
+fi
+
+build_variant() {
+  local fft_n="$1" fixed="$2" exe="$3"
+  "$cc_bin" "${cflags[@]}" -DFC_FFT_N="$fft_n" -DFC128_FIXED_POINT="$fixed" \
+    bench/depth_bench.c "${firmware_srcs[@]}" "$cmsis_lib" -lm -o "$exe"
+}
+
+emit() {
+  if [[ -n "$out_path" ]]; then
+    tee -a "$out_path"
+  else
+    cat
+  fi
+}
+
+if [[ -n "$out_path" ]]; then
+  : >"$out_path"
+fi
+
+header=1
+run() {
+  local exe="$1"; shift
+  if [[ $header -eq 1 ]]; then
+    "$exe" --surface "$surface" --iters "$iters" "$@" | emit
+    header=0
+  else
+    "$exe" --surface "$surface" --iters "$iters" --no-header "$@" | emit
+  fi
+}
+
+IFS=',' read -r -a fft_ns <<<"$fft_n_list"
+IFS=',' read -r -a fixeds <<<"$fixed_list"
+
+first_exe=""
+for n in "${fft_ns[@]}"; do
+  for fx in "${fixeds[@]}"; do
+    exe="$build_dir/depth_bench_n${n}_fx${fx}"
+    echo "build FC_FFT_N=$n FC128_FIXED_POINT=$fx" >&2
+    build_variant "$n" "$fx" "$exe"
+    run "$exe" --solver fc128
+    run "$exe" --solver synth
+    if [[ "$fx" == "1" ]]; then
+      run "$exe" --solver fc128_vs_f32
+    fi
+    if [[ -z "$first_exe" ]]; then
+      first_exe="$exe"
+    fi
+  done
+done
+
+if [[ -n "$first_exe" ]]; then
+  run "$first_exe" --solver mg
+  run "$first_exe" --solver row
+fi
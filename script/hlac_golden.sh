@@ -0,0 +1,148 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+usage() {
+  cat <<'EOF'
+Usage:
+  ./script/hlac_golden.sh [options] <golden.csv>
+
+Builds bench/hlac_golden.c twice for the host and runs both on the same golden file:
+  scalar   src/hlac_lda_infer.c as built for a core without Helium
+  mve-emu  same source with __ARM_FEATURE_MVE=1, intrinsics emulated by bench/host/arm_mve.h
+The golden file comes from matlab/export_hlac_golden.m. Exit status is non-zero if
+either path is out of tolerance.
+
+Options:
+  -B, --build-dir <dir>     Object/binary dir (default: build/hlac_golden)
+  --tol <rel>               Feature relative tolerance (default: 1e-4)
+  --score-tol <rel>         LDA score/prob tolerance (default: 1e-3)
+  --iters <n>               Repetitions per row for timing (default: 20)
+  --path <scalar|mve|all>   Which build(s) to run (default: all)
+  --cc <compiler>           Host C compiler (default: $CC or cc)
+  --cflags <flags>          Extra compiler flags (e.g. "-march=native")
+  -v, --verbose             Print every row
+  -h, --help                Show this help
+
+Examples:
+  ./script/hlac_golden.sh matlab/hlac_golden/golden.csv
+  ./script/hlac_golden.sh --path mve --tol 1e-5 matlab/hlac_golden/golden.csv
+EOF
+}
+
+# Defaults
+build_dir=""
+golden=""
+tol="1e-4"
+score_tol="1e-3"
+iters=20
+which_path="all"
+cc_bin="${CC:-cc}"
+extra_cflags=""
+verbose=0
+
+# Parse args
+while [[ $# -gt 0 ]]; do
+  case "$1" in
+    -B|--build-dir)
+      build_dir="${2:-}"; shift 2;;
+    --tol)
+      tol="${2:-}"; shift 2;;
+    --score-tol)
+      score_tol="${2:-}"; shift 2;;
+    --iters)
+      iters="${2:-}"; shift 2;;
+    --path)
+      which_path="${2:-}"; shift 2;;
+    --cc)
+      cc_bin="${2:-}"; shift 2;;
+    --cflags)
+      extra_cflags="${2:-}"; shift 2;;
+    -v|--verbose)
+      verbose=1; shift;;
+    -h|--help)
+      usage; exit 0;;
+    -*)
+      echo "Unknown option: $1" >&2
+      usage
+      exit 2
+      ;;
+    *)
+      golden="$1"; shift;;
+  esac
+done
+
+if [[ -z "$golden" ]]; then
+  usage
+  exit 2
+fi
+if [[ ! -f "$golden" ]]; then
+  echo "Golden file not found: $golden" >&2
+  exit 2
+fi
+golden="$(cd "$(dirname "$golden")" && pwd)/$(basename "$golden")"
+
+repo_root="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+cd "$repo_root"
+
+if [[ -z "$build_dir" ]]; then
+  build_dir="build/hlac_golden"
+fi
+mkdir -p "$build_dir"
+
+srcs=(
+  "bench/hlac_golden.c"
+  "bench/host/bench_host.c"
+  "src/hlac_lda_infer.c"
+  "src/hlac_lda_model.c"
+  "src/xprintf/src/xprintf.c"
+)
+
+cflags=(
+  -std=gnu11 -O2 -Wall -Wextra
+  -Ibench/host -Isrc -Isrc/xprintf/src
+)
+# shellcheck disable=SC2206
+cflags+=($extra_cflags)
+
+run_args=(--tol "$tol" --score-tol "$score_tol" --iters "$iters")
+if [[ $verbose -eq 1 ]]; then
+  run_args+=(--verbose)
+fi
+
+paths=()
+case "$which_path" in
+  scalar) paths=(scalar);;
+  mve) paths=(mve);;
+  all) paths=(scalar mve);;
+  *)
+    echo "Unknown path: $which_path" >&2
+    exit 2
+    ;;
+esac
+
+status=0
+header=1
+for p in "${paths[@]}"; do
+  exe="$build_dir/hlac_golden_$p"
+  if [[ "$p" == "mve" ]]; then
+    "$cc_bin" "${cflags[@]}" -D__ARM_FEATURE_MVE=1 "${srcs[@]}" -lm -o "$exe"
+  else
+    "$cc_bin" "${cflags[@]}" "${srcs[@]}" -lm -o "$exe"
+  fi
+
+  set +e
+  out="$("$exe" "$golden" "${run_args[@]}")"
+  rc=$?
+  set -e
+  if [[ $header -eq 1 ]]; then
+    echo "$out"
+    header=0
+  else
+    echo "$out" | tail -n +2
+  fi
+  if [[ $rc -ne 0 ]]; then
+    status=1
+  fi
+done
+
+exit $status
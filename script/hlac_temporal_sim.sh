@@ -0,0 +1,99 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+usage() {
+  cat <<'EOF'
+Usage:
+  ./script/hlac_temporal_sim.sh [options]
+
+Builds bench/hlac_temporal_sim.c with src/hlac_temporal.c for the host and compares the
+temporal decision rule against the K-in-a-row count rule on a synthetic prediction stream.
+Prints one CSV (false commands per frame, mean decision latency in frames) for both
+confidence models unless --confidence is given.
+
+Options:
+  -B, --build-dir <dir>     Object/binary dir (default: build/hlac_temporal_sim)
+  --frames <n>              Simulated frames (default: 200000)
+  --segment <n>             Frames per true-class segment (default: 30)
+  --classes <n>             Number of classes (default: 4)
+  --noise <p>               Probability that a frame's peak is a wrong class (default: 0.2)
+  --confidence <m>          equal|lower|all (default: all)
+  --count-k <list>          Count-rule K values, comma separated (default: 2,3,4)
+  --seed <n>                Random seed (default: 7)
+  --cc <compiler>           Host C compiler (default: $CC or cc)
+  --cflags <flags>          Extra compiler flags (e.g. "-DHLAC_TEMPORAL_DECAY=0.6f")
+  -h, --help                Show this help
+
+Examples:
+  ./script/hlac_temporal_sim.sh
+  ./script/hlac_temporal_sim.sh --noise 0.3 --confidence equal
+  ./script/hlac_temporal_sim.sh --cflags "-DHLAC_TEMPORAL_MARGIN=2.5f"
+EOF
+}
+
+# Defaults
+build_dir=""
+confidence="all"
+cc_bin="${CC:-cc}"
+extra_cflags=""
+sim_args=()
+
+# Parse args
+while [[ $# -gt 0 ]]; do
+  case "$1" in
+    -B|--build-dir)
+      build_dir="${2:-}"; shift 2;;
+    --frames|--segment|--classes|--noise|--count-k|--seed)
+      sim_args+=("$1" "${2:-}"); shift 2;;
+    --confidence)
+      confidence="${2:-}"; shift 2;;
+    --cc)
+      cc_bin="${2:-}"; shift 2;;
+    --cflags)
+      extra_cflags="${2:-}"; shift 2;;
+    -h|--help)
+      usage; exit 0;;
+    *)
+      echo "Unknown option: $1" >&2
+      usage
+      exit 2
+      ;;
+  esac
+done
+
+repo_root="$(cd "$(dirname "${BASH_SOURCE[0]}")/.." && pwd)"
+cd "$repo_root"
+
+if [[ -z "$build_dir" ]]; then
+  build_dir="build/hlac_temporal_sim"
+fi
+mkdir -p "$build_dir"
+
+cflags=(
+  -std=gnu11 -O2 -Wall -Wextra
+  -Isrc
+)
+# shellcheck disable=SC2206
+cflags+=($extra_cflags)
+
+exe="$build_dir/hlac_temporal_sim"
+"$cc_bin" "${cflags[@]}" bench/hlac_temporal_sim.c src/hlac_temporal.c -lm -o "$exe"
+
+case "$confidence" in
+  equal|lower) confs=("$confidence");;
+  all) confs=(lower equal);;
+  *)
+    echo "Unknown confidence model: $confidence" >&2
+    exit 2
+    ;;
+esac
+
+header=1
+for c in "${confs[@]}"; do
+  if [[ $header -eq 1 ]]; then
+    "$exe" --confidence "$c" "${sim_args[@]}"
+    header=0
+  else
+    "$exe" --confidence "$c" --no-header "${sim_args[@]}"
+  fi
+done
@@ -0,0 +1,428 @@
+#include "binlog.h"
+#include "hal_data.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#if BINLOG_ENABLE
+
+extern uint32_t SystemCoreClock;
+
+typedef struct
+{
+    TaskHandle_t owner;
+    const char *name;
+    volatile uint32_t head; // 生産者(owner)のみ更新
+    volatile uint32_t tail; // 消費者(Thread2)のみ更新
+    binlog_record_t rec[BINLOG_RING_RECORDS];
+} binlog_ring_t;
+
+static binlog_ring_t s_rings[BINLOG_MAX_THREADS];
+static volatile uint32_t s_dropped = 0U;
+
+/* 1行の最大長(これを超える分は切り捨て) */
+#ifndef BINLOG_LINE_MAX
+#define BINLOG_LINE_MAX (160U)
+#endif
+
+bool binlog_register_thread(const char *name)
+{
+    const TaskHandle_t me = xTaskGetCurrentTaskHandle();
+    bool ok = false;
+
+    /* Timestamps come from the DWT cycle counter (enable without resetting). */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    taskENTER_CRITICAL();
+    for (uint32_t i = 0U; i < (uint32_t)BINLOG_MAX_THREADS; i++)
+    {
+        if ((s_rings[i].owner == me) || (s_rings[i].owner == NULL))
+        {
+            s_rings[i].name = name;
+            s_rings[i].owner = me;
+            ok = true;
+            break;
+        }
+    }
+    taskEXIT_CRITICAL();
+    return ok;
+}
+
+void binlog_write(const char *fmt, uint32_t nargs, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3)
+{
+    const uint32_t cyc = DWT->CYCCNT;
+
+    binlog_ring_t *ring = NULL;
+    if (__get_IPSR() == 0U)
+    {
+        const TaskHandle_t me = xTaskGetCurrentTaskHandle();
+        for (uint32_t i = 0U; i < (uint32_t)BINLOG_MAX_THREADS; i++)
+        {
+            if (s_rings[i].owner == me)
+            {
+                ring = &s_rings[i];
+                break;
+            }
+        }
+    }
+
+    if (ring == NULL)
+    {
+        s_dropped++; // ISR / 未登録スレッド(カウンタは概数でよい)
+        return;
+    }
+
+    const uint32_t head = ring->head;
+    if ((head - ring->tail) >= (uint32_t)BINLOG_RING_RECORDS)
+    {
+        s_dropped++;
+        return;
+    }
+
+    binlog_record_t *r = &ring->rec[head & (BINLOG_RING_RECORDS - 1U)];
+    r->fmt = fmt;
+    r->cyc = cyc;
+    r->nargs = nargs;
+    r->args[0] = a0;
+    r->args[1] = a1;
+    r->args[2] = a2;
+    r->args[3] = a3;
+    __DMB();
+    ring->head = head + 1U;
+}
+
+uint32_t binlog_dropped(void)
+{
+    return s_dropped;
+}
+
+/* ---- Thread2 側: 書式化 ---- */
+
+typedef struct
+{
+    char *buf;
+    uint32_t len;
+    uint32_t cap;
+} binlog_out_t;
+
+static void binlog_putc(binlog_out_t *o, char c)
+{
+    if ((o->len + 1U) < o->cap)
+    {
+        o->buf[o->len++] = c;
+    }
+}
+
+static void binlog_puts_padded(binlog_out_t *o, const char *s, uint32_t n, uint32_t width, bool left, char pad)
+{
+    if (!left)
+    {
+        for (uint32_t i = n; i < width; i++)
+        {
+            binlog_putc(o, pad);
+        }
+    }
+    for (uint32_t i = 0U; i < n; i++)
+    {
+        binlog_putc(o, s[i]);
+    }
+    if (left)
+    {
+        for (uint32_t i = n; i < width; i++)
+        {
+            binlog_putc(o, ' ');
+        }
+    }
+}
+
+/* 符号なし整数を base 進で tmp の末尾から書く．戻り値は先頭位置． */
+static char *binlog_utoa(char *end, uint32_t v, uint32_t base, bool upper)
+{
+    const char *digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    char *p = end;
+    do
+    {
+        *--p = digits[v % base];
+        v /= base;
+    } while (v != 0U);
+    return p;
+}
+
+static void binlog_put_int(binlog_out_t *o, uint32_t arg, char conv, uint32_t width, bool left, bool zero)
+{
+    char tmp[12];
+    char *end = &tmp[sizeof(tmp)];
+    bool neg = false;
+    uint32_t v = arg;
+
+    if ((conv == 'd') || (conv == 'i'))
+    {
+        const int32_t s = (int32_t)arg;
+        if (s < 0)
+        {
+            neg = true;
+            v = (uint32_t)(-(s + 1)) + 1U;
+        }
+    }
+    const uint32_t base = ((conv == 'x') || (conv == 'X')) ? 16U : 10U;
+    char *p = binlog_utoa(end, v, base, conv == 'X');
+    uint32_t n = (uint32_t)(end - p);
+
+    if (neg && zero && !left)
+    {
+        binlog_putc(o, '-');
+        binlog_puts_padded(o, p, n, (width > 0U) ? (width - 1U) : 0U, false, '0');
+        return;
+    }
+    if (neg)
+    {
+        *--p = '-';
+        n++;
+    }
+    binlog_puts_padded(o, p, n, width, left, (zero && !left) ? '0' : ' ');
+}
+
+static void binlog_put_float(binlog_out_t *o, uint32_t bits, char conv, uint32_t width, int prec, bool left)
+{
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    char tmp[32];
+    uint32_t n = 0U;
+
+    if (prec < 0)
+    {
+        prec = 6;
+    }
+    if (prec > 9)
+    {
+        prec = 9;
+    }
+
+    if (f != f)
+    {
+        memcpy(tmp, "nan", 3U);
+        n = 3U;
+    }
+    else
+    {
+        double v = (double)f;
+        if (v < 0.0)
+        {
+            tmp[n++] = '-';
+            v = -v;
+        }
+        int exp10 = 0;
+        if ((conv == 'e') || (conv == 'E'))
+        {
+            while ((v >= 10.0) && (exp10 < 99))
+            {
+                v /= 10.0;
+                exp10++;
+            }
+            while ((v > 0.0) && (v < 1.0) && (exp10 > -99))
+            {
+                v *= 10.0;
+                exp10--;
+            }
+        }
+        if (v >= 4294967295.0)
+        {
+            memcpy(&tmp[n], "inf", 3U);
+            n += 3U;
+        }
+        else
+        {
+            uint32_t scale = 1U;
+            for (int i = 0; i < prec; i++)
+            {
+                scale *= 10U;
+            }
+            double r = v * (double)scale + 0.5;
+            uint32_t ip = (uint32_t)v;
+            uint32_t fp = (uint32_t)(r - (double)ip * (double)scale);
+            if (fp >= scale)
+            {
+                ip++;
+                fp -= scale;
+            }
+            char num[12];
+            char *p = binlog_utoa(&num[sizeof(num)], ip, 10U, false);
+            while (p < &num[sizeof(num)])
+            {
+                tmp[n++] = *p++;
+            }
+            if (prec > 0)
+            {
+                tmp[n++] = '.';
+                char *q = binlog_utoa(&num[sizeof(num)], fp, 10U, false);
+                for (int i = (int)(&num[sizeof(num)] - q); i < prec; i++)
+                {
+                    tmp[n++] = '0';
+                }
+                while (q < &num[sizeof(num)])
+                {
+                    tmp[n++] = *q++;
+                }
+            }
+            if ((conv == 'e') || (conv == 'E'))
+            {
+                tmp[n++] = conv;
+                tmp[n++] = (exp10 < 0) ? '-' : '+';
+                const int ae = (exp10 < 0) ? -exp10 : exp10;
+                tmp[n++] = (char)('0' + (ae / 10));
+                tmp[n++] = (char)('0' + (ae % 10));
+            }
+        }
+    }
+    binlog_puts_padded(o, tmp, n, width, left, ' ');
+}
+
+static uint32_t binlog_format(const binlog_ring_t *ring, const binlog_record_t *r, char *buf, uint32_t cap)
+{
+    binlog_out_t o = {buf, 0U, cap};
+
+    /* 先頭: 経過時間(ms)とスレッド名 */
+    const uint32_t hz_khz = SystemCoreClock / 1000U;
+    const uint32_t us = (hz_khz > 0U) ? (uint32_t)(((uint64_t)r->cyc * 1000ULL) / hz_khz) : 0U;
+    binlog_put_int(&o, us / 1000U, 'u', 0U, false, false);
+    binlog_putc(&o, '.');
+    binlog_put_int(&o, us % 1000U, 'u', 3U, false, true);
+    binlog_putc(&o, ' ');
+    for (const char *s = ring->name; (s != NULL) && (*s != '\0'); s++)
+    {
+        binlog_putc(&o, *s);
+    }
+    binlog_putc(&o, ' ');
+
+    uint32_t ai = 0U;
+    for (const char *f = r->fmt; *f != '\0'; f++)
+    {
+        if (*f != '%')
+        {
+            binlog_putc(&o, *f);
+            continue;
+        }
+        f++;
+        if (*f == '%')
+        {
+            binlog_putc(&o, '%');
+            continue;
+        }
+
+        bool left = false;
+        bool zero = false;
+        uint32_t width = 0U;
+        int prec = -1;
+        for (; (*f == '-') || (*f == '0'); f++)
+        {
+            left = left || (*f == '-');
+            zero = zero || (*f == '0');
+        }
+        for (; (*f >= '0') && (*f <= '9'); f++)
+        {
+            width = width * 10U + (uint32_t)(*f - '0');
+        }
+        if (*f == '.')
+        {
+            prec = 0;
+            for (f++; (*f >= '0') && (*f <= '9'); f++)
+            {
+                prec = prec * 10 + (*f - '0');
+            }
+        }
+        while ((*f == 'l') || (*f == 'h'))
+        {
+            f++;
+        }
+        if (*f == '\0')
+        {
+            break;
+        }
+
+        const uint32_t arg = (ai < r->nargs) ? r->args[ai] : 0U;
+        ai++;
+        switch (*f)
+        {
+        case 'd':
+        case 'i':
+        case 'u':
+        case 'x':
+        case 'X':
+            binlog_put_int(&o, arg, *f, width, left, zero);
+            break;
+        case 'c':
+        {
+            const char c = (char)arg;
+            binlog_puts_padded(&o, &c, 1U, width, left, ' ');
+            break;
+        }
+        case 's':
+        {
+            const char *s = (const char *)arg;
+            if (s == NULL)
+            {
+                s = "(null)";
+            }
+            binlog_puts_padded(&o, s, (uint32_t)strlen(s), width, left, ' ');
+            break;
+        }
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+            binlog_put_float(&o, arg, *f, width, prec, left);
+            break;
+        default:
+            binlog_putc(&o, '?');
+            break;
+        }
+    }
+    buf[o.len] = '\0';
+    return o.len;
+}
+
+uint32_t binlog_drain(void (*out)(const char *line, uint32_t len), uint32_t max_records)
+{
+    char line[BINLOG_LINE_MAX];
+    uint32_t done = 0U;
+
+    while (done < max_records)
+    {
+        /* 各リング先頭のうち最も古いものを選ぶ(スレッド間の順序を保つ) */
+        binlog_ring_t *best = NULL;
+        uint32_t best_cyc = 0U;
+        for (uint32_t i = 0U; i < (uint32_t)BINLOG_MAX_THREADS; i++)
+        {
+            binlog_ring_t *ring = &s_rings[i];
+            if (ring->head == ring->tail)
+            {
+                continue;
+            }
+            const uint32_t cyc = ring->rec[ring->tail & (BINLOG_RING_RECORDS - 1U)].cyc;
+            if ((best == NULL) || ((int32_t)(cyc - best_cyc) < 0))
+            {
+                best = ring;
+                best_cyc = cyc;
+            }
+        }
+        if (best == NULL)
+        {
+            break;
+        }
+
+        __DMB();
+        const uint32_t tail = best->tail;
+        const uint32_t len = binlog_format(best, &best->rec[tail & (BINLOG_RING_RECORDS - 1U)], line, (uint32_t)sizeof(line));
+        __DMB();
+        best->tail = tail + 1U;
+
+        if (out != NULL)
+        {
+            out(line, len);
+        }
+        done++;
+    }
+    return done;
+}
+
+#endif
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/*
+ * Deferred-formatting binary logger.
+ *
+ * - ホットパスは (書式ポインタ, DWT タイムスタンプ, 引数<=4) の固定長レコードを
+ *   自スレッド専用のリング(単一生産者/単一消費者)に書くだけ(数十サイクル)．
+ * - 書式化は Thread2 が USB CDC へ出す直前に行う(binlog_drain)．1レコード=1行なので
+ *   xprintf のような行の混在(tear)は起きない．
+ * - 書式は xprintf のサブセット: %d %i %u %x %X %c %s %f %e %% と幅/0埋め/精度/l．
+ *   %s は文字列リテラル(寿命の長い文字列)のみ．float は BINLOG_F() で渡す．
+ * - binlog_register_thread() していないスレッドや ISR からの呼び出しは捨てて数える．
+ * - リングが満杯なら新しいレコードを捨てる(待たない)．
+ */
+
+#ifndef BINLOG_ENABLE
+#define BINLOG_ENABLE (1)
+#endif
+
+/* 登録できるスレッド数(=リング数) */
+#ifndef BINLOG_MAX_THREADS
+#define BINLOG_MAX_THREADS (4U)
+#endif
+
+/* 1リングあたりのレコード数(power of two) */
+#ifndef BINLOG_RING_RECORDS
+#define BINLOG_RING_RECORDS (64U)
+#endif
+
+#define BINLOG_MAX_ARGS (4U)
+
+#if (BINLOG_RING_RECORDS & (BINLOG_RING_RECORDS - 1U))
+#error BINLOG_RING_RECORDS must be power-of-two.
+#endif
+
+typedef struct
+{
+    const char *fmt; // 書式(フラッシュ上のリテラル)
+    uint32_t cyc;    // DWT->CYCCNT
+    uint32_t nargs;
+    uint32_t args[BINLOG_MAX_ARGS];
+} binlog_record_t;
+
+static inline uint32_t binlog_f32_bits(float v)
+{
+    uint32_t u;
+    memcpy(&u, &v, sizeof(u));
+    return u;
+}
+
+#define BINLOG_F(v) binlog_f32_bits((float)(v))
+#define BINLOG_A(v) ((uint32_t)(v))
+
+#if BINLOG_ENABLE
+
+/* 呼び出したタスクにリングを割り当てる(スレッド起動直後に1回)．失敗で false． */
+bool binlog_register_thread(const char *name);
+
+void binlog_write(const char *fmt, uint32_t nargs, uint32_t a0, uint32_t a1, uint32_t a2, uint32_t a3);
+
+/* Thread2: 溜まったレコードを時刻順に書式化して out() へ1行ずつ渡す．戻り値は処理件数． */
+uint32_t binlog_drain(void (*out)(const char *line, uint32_t len), uint32_t max_records);
+
+/* 捨てたレコード数(満杯/未登録) */
+uint32_t binlog_dropped(void);
+
+#define BINLOG0(fmt) binlog_write((fmt), 0U, 0U, 0U, 0U, 0U)
+#define BINLOG1(fmt, a) binlog_write((fmt), 1U, BINLOG_A(a), 0U, 0U, 0U)
+#define BINLOG2(fmt, a, b) binlog_write((fmt), 2U, BINLOG_A(a), BINLOG_A(b), 0U, 0U)
+#define BINLOG3(fmt, a, b, c) binlog_write((fmt), 3U, BINLOG_A(a), BINLOG_A(b), BINLOG_A(c), 0U)
+#define BINLOG4(fmt, a, b, c, d) binlog_write((fmt), 4U, BINLOG_A(a), BINLOG_A(b), BINLOG_A(c), BINLOG_A(d))
+
+#else
+
+static inline bool binlog_register_thread(const char *name)
+{
+    (void)name;
+    return false;
+}
+
+static inline uint32_t binlog_drain(void (*out)(const char *line, uint32_t len), uint32_t max_records)
+{
+    (void)out;
+    (void)max_records;
+    return 0U;
+}
+
+static inline uint32_t binlog_dropped(void)
+{
+    return 0U;
+}
+
+#define BINLOG0(fmt) ((void)0)
+#define BINLOG1(fmt, a) ((void)(a))
+#define BINLOG2(fmt, a, b) ((void)(a), (void)(b))
+#define BINLOG3(fmt, a, b, c) ((void)(a), (void)(b), (void)(c))
+#define BINLOG4(fmt, a, b, c, d) ((void)(a), (void)(b), (void)(c), (void)(d))
+
+#endif
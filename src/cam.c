@@ -4,11 +4,154 @@
 #include "xprintf.h"
 #include "sccb_if.h"
 #include "cam.h"
+#include "hyperram_integ.h"
+#include "video_frame_buffer.h"
+#include "latency_trace.h"
+
+#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE > 0)
+#include <arm_mve.h>
+#define USE_HELIUM_MVE 1
+#else
+#define USE_HELIUM_MVE 0
+#endif
 volatile bool g_ceu_capture_error;
 volatile bool g_ceu_capture_complete;
 uint32_t g_flag1;
 
-uint8_t g_image_qvga_sram[VGA_WIDTH * VGA_HEIGHT * BYTE_PER_PIXEL] BSP_ALIGN_VARIABLE(8);
+uint8_t g_image_qvga_sram[CAM_FRAME_BYTES] BSP_ALIGN_VARIABLE(8);
+#if CAM_PINGPONG_ENABLE
+uint8_t g_image_qvga_sram_b[CAM_FRAME_BYTES] BSP_ALIGN_VARIABLE(8);
+#endif
+
+/* FRAME_END/エラー時に通知するタスク(NULL=通知なし) */
+static TaskHandle_t volatile s_cam_notify_task = NULL;
+/* 直近の FRAME_END 割り込み時刻(DWT) */
+static volatile uint32_t s_frame_end_cyc = 0U;
+
+/*
+ * モードごとの OV5642 レジスタ(sccb_write_table の差分書き込み)．
+ * 窓位置は初期表(HS=0x0150, VS=0x0008, 1280x960 の全画角)からの相対で，中央を切り出す．
+ * スケーラ入力(0x5682-0x5687)は窓サイズ(V は -4)に合わせる．
+ * VTS(0x380e/0f)を詰めるとフレームレートが上がる．値は実機で要調整．
+ */
+typedef struct
+{
+    const char *name;
+    uint16_t width;
+    uint16_t height;
+    const cam_reg_value_t *regs;
+} cam_mode_info_t;
+
+static const cam_reg_value_t s_ov5642_qvga[] = {
+    {0x30, 0x08, 0x42}, // standby(切替中の半端なフレームを出さない)
+    {0x38, 0x00, 0x01}, {0x38, 0x01, 0x50}, // HS = 0x0150
+    {0x38, 0x02, 0x00}, {0x38, 0x03, 0x08}, // VS = 0x0008
+    {0x38, 0x04, 0x05}, {0x38, 0x05, 0x00}, // HW = 1280
+    {0x38, 0x06, 0x03}, {0x38, 0x07, 0xc0}, // VH = 960
+    {0x56, 0x82, 0x05}, {0x56, 0x83, 0x00},
+    {0x56, 0x86, 0x03}, {0x56, 0x87, 0xbc},
+    {0x38, 0x08, 0x01}, {0x38, 0x09, 0x40}, // out 320
+    {0x38, 0x0a, 0x00}, {0x38, 0x0b, 0xf0}, // out 240
+    {0x38, 0x0e, 0x03}, {0x38, 0x0f, 0xe8}, // VTS = 1000
+    {0x30, 0x08, 0x02}, // streaming
+    SCCB_TBL_END,
+};
+
+static const cam_reg_value_t s_ov5642_win256[] = {
+    {0x30, 0x08, 0x42},
+    {0x38, 0x00, 0x02}, {0x38, 0x01, 0xd0}, // HS = 0x0150 + (1280-512)/2
+    {0x38, 0x02, 0x00}, {0x38, 0x03, 0xe8}, // VS = 0x0008 + (960-512)/2
+    {0x38, 0x04, 0x02}, {0x38, 0x05, 0x00}, // HW = 512
+    {0x38, 0x06, 0x02}, {0x38, 0x07, 0x00}, // VH = 512
+    {0x56, 0x82, 0x02}, {0x56, 0x83, 0x00},
+    {0x56, 0x86, 0x01}, {0x56, 0x87, 0xfc},
+    {0x38, 0x08, 0x01}, {0x38, 0x09, 0x00}, // out 256
+    {0x38, 0x0a, 0x01}, {0x38, 0x0b, 0x00}, // out 256
+    {0x38, 0x0e, 0x02}, {0x38, 0x0f, 0x58}, // VTS = 600
+    {0x30, 0x08, 0x02},
+    SCCB_TBL_END,
+};
+
+static const cam_reg_value_t s_ov5642_center[] = {
+    {0x30, 0x08, 0x42},
+    {0x38, 0x00, 0x02}, {0x38, 0x01, 0x90}, // HS = 0x0150 + (1280-640)/2
+    {0x38, 0x02, 0x00}, {0x38, 0x03, 0xf8}, // VS = 0x0008 + (960-480)/2
+    {0x38, 0x04, 0x02}, {0x38, 0x05, 0x80}, // HW = 640
+    {0x38, 0x06, 0x01}, {0x38, 0x07, 0xe0}, // VH = 480
+    {0x56, 0x82, 0x02}, {0x56, 0x83, 0x80},
+    {0x56, 0x86, 0x01}, {0x56, 0x87, 0xdc},
+    {0x38, 0x08, 0x01}, {0x38, 0x09, 0x40}, // out 320
+    {0x38, 0x0a, 0x00}, {0x38, 0x0b, 0xf0}, // out 240
+    {0x38, 0x0e, 0x03}, {0x38, 0x0f, 0xe8}, // VTS = 1000
+    {0x30, 0x08, 0x02},
+    SCCB_TBL_END,
+};
+
+static const cam_mode_info_t s_cam_modes[CAM_MODE_COUNT] = {
+    [CAM_MODE_QVGA] = {"qvga", 320U, 240U, s_ov5642_qvga},
+    [CAM_MODE_WIN256] = {"win256", 256U, 256U, s_ov5642_win256},
+    [CAM_MODE_CENTER] = {"center", 320U, 240U, s_ov5642_center},
+};
+
+static camera_dev_t s_cam_dev = DEV_NONE; // モード表は OV5642 のみ
+static cam_mode_t s_cam_mode = CAM_MODE_QVGA;
+static video_frame_desc_t s_cam_desc;
+static volatile int32_t s_cam_mode_request = -1; // -1 = 要求なし
+
+static void cam_notify_from_isr(TaskHandle_t task)
+{
+    if (task != NULL)
+    {
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(task, &woken);
+        portYIELD_FROM_ISR(woken);
+    }
+}
+
+#if CAM_BAND_STREAM_ENABLE
+static TaskHandle_t volatile s_band_task = NULL;
+static cam_band_frame_t s_band_frame;
+static bool s_band_valid = false;
+static const uint8_t *s_band_prev_buffer = NULL; // gen-1 のバッファ
+static uint32_t s_band_prev_height = 0U;         // gen-1 の行数(モード切替をまたぐ場合がある)
+static volatile uint32_t s_band_hd = 0U;         // VD 以降の HD 数
+static volatile uint32_t s_band_lines = 0U;      // 着地済み行数(現 gen)
+
+static void cam_band_on_events_isr(uint32_t event)
+{
+    const uint32_t before = s_band_lines;
+    const uint32_t height = (uint32_t)s_band_frame.desc.height;
+    uint32_t lines = before;
+
+    if (event & CEU_EVENT_VD)
+    {
+        s_band_hd = 0U;
+        lines = 0U;
+    }
+    if (event & CEU_EVENT_HD)
+    {
+        const uint32_t hd = s_band_hd + 1U;
+        s_band_hd = hd;
+        /* 最終行は FRAME_END で確定させる */
+        lines = (hd > (uint32_t)CAM_BAND_HD_LAG) ? (hd - (uint32_t)CAM_BAND_HD_LAG) : 0U;
+        if (lines > (height - 1U))
+        {
+            lines = height - 1U;
+        }
+    }
+    if (event & CEU_EVENT_FRAME_END)
+    {
+        lines = height;
+    }
+
+    s_band_lines = lines;
+    if ((lines / (uint32_t)CAM_BAND_LINES) != (before / (uint32_t)CAM_BAND_LINES) ||
+        ((lines == height) && (before != lines)))
+    {
+        cam_notify_from_isr(s_band_task);
+    }
+}
+#endif
 
 // callback function
 void g_ceu0_user_callback(capture_callback_args_t *p_args)
@@ -19,10 +162,14 @@ void g_ceu0_user_callback(capture_callback_args_t *p_args)
     {
         /* Error processing should occur first. Application should not process complete event if error occurred. */
         g_ceu_capture_error = true;
+        cam_notify_from_isr(s_cam_notify_task);
         // g_flag1 = 3;
     }
     else
     {
+#if CAM_BAND_STREAM_ENABLE
+        cam_band_on_events_isr((uint32_t)p_args->event);
+#endif
         if (p_args->event & CEU_EVENT_VD)
         {
             // g_flag1 = 1;
@@ -32,41 +179,423 @@ void g_ceu0_user_callback(capture_callback_args_t *p_args)
         {
             // g_flag1 = 2;
             /* Capture is complete and no error has occurred */
+            s_frame_end_cyc = latency_trace_now();
             g_ceu_capture_complete = true;
+            cam_notify_from_isr(s_cam_notify_task);
         }
     }
 }
 
+/* 生成コードの設定をコピーして取り込みサイズ(と帯モードの HD 割り込み)だけ差し替えて Open(ra_gen は編集しない) */
+static fsp_err_t cam_ceu_open(uint32_t width, uint32_t height)
+{
+    static capture_cfg_t s_ceu_cfg;
+    static ceu_extended_cfg_t s_ceu_ext_cfg;
+    s_ceu_cfg = g_ceu0_cfg;
+    s_ceu_ext_cfg = *(const ceu_extended_cfg_t *)g_ceu0_cfg.p_extend;
+#if CAM_BAND_STREAM_ENABLE
+    s_ceu_ext_cfg.interrupts_enabled |= R_CEU_CEIER_HDIE_Msk;
+#endif
+    s_ceu_cfg.p_extend = &s_ceu_ext_cfg;
+    s_ceu_cfg.x_capture_pixels = (uint16_t)width;
+    s_ceu_cfg.y_capture_pixels = (uint16_t)height;
+    return R_CEU_Open(&g_ceu0_ctrl, &s_ceu_cfg);
+}
+
 void cam_init(camera_dev_t cam)
 {
 
     // Init XCLK of DVP(24MHz)
     cam_clk_init();
-    // init I2C and PWM
+    // init I2C and PWM(初期表は QVGA)
     sccb_init(cam);
     R_BSP_SoftwareDelay(10U, BSP_DELAY_UNITS_MILLISECONDS);
     g_flag1 = 0;
-    R_CEU_Open(&g_ceu0_ctrl, &g_ceu0_cfg);
+
+    s_cam_dev = cam;
+    s_cam_mode = CAM_MODE_QVGA;
+    s_cam_desc = video_frame_desc_make(s_cam_modes[CAM_MODE_QVGA].width, s_cam_modes[CAM_MODE_QVGA].height,
+                                       (uint32_t)CAM_MODE_QVGA);
+    if ((CAM_MODE_DEFAULT != CAM_MODE_QVGA) && (cam == DEV_OV5642) && (sccb_write_table(s_cam_modes[CAM_MODE_DEFAULT].regs, true) >= 0))
+    {
+        s_cam_mode = CAM_MODE_DEFAULT;
+        s_cam_desc = video_frame_desc_make(s_cam_modes[CAM_MODE_DEFAULT].width,
+                                           s_cam_modes[CAM_MODE_DEFAULT].height, (uint32_t)CAM_MODE_DEFAULT);
+    }
+    (void)cam_ceu_open(s_cam_desc.width, s_cam_desc.height);
 }
 
-void cam_capture(void)
+/* 切り替え失敗時: 直前のモード(s_cam_mode / s_cam_desc)に戻して CEU を開き直す(閉じたままだと取り込みが止まる) */
+static void cam_restore_mode(void)
 {
-    fsp_err_t err = FSP_SUCCESS;
+    const cam_mode_info_t *prev = &s_cam_modes[s_cam_mode];
+    if (sccb_write_table(prev->regs, true) < 0)
+    {
+        xprintf("[Camera] mode %s: SCCB restore failed\n", prev->name);
+    }
+    if (FSP_SUCCESS != cam_ceu_open(s_cam_desc.width, s_cam_desc.height))
+    {
+        xprintf("[Camera] mode %s: CEU reopen failed\n", prev->name);
+    }
+}
+
+bool cam_set_mode(cam_mode_t mode)
+{
+    if ((uint32_t)mode >= (uint32_t)CAM_MODE_COUNT)
+    {
+        return false;
+    }
+
+    const cam_mode_info_t *m = &s_cam_modes[mode];
+    if (s_cam_dev != DEV_OV5642)
+    {
+        xprintf("[Camera] mode switching is only supported on OV5642\n");
+        return false;
+    }
+    if (((uint32_t)m->width > VIDEO_FRAME_MAX_W) || ((uint32_t)m->height > VIDEO_FRAME_MAX_H) ||
+        (((uint32_t)m->width * (uint32_t)m->height) > VIDEO_FRAME_MAX_PIXELS) || ((m->width % 16U) != 0U) ||
+        ((VIDEO_FRAME_FORMAT == VIDEO_FRAME_FMT_Y8_DECIM) &&
+         (((m->width % (uint32_t)VIDEO_FRAME_DECIM_X) != 0U) || ((m->height % (uint32_t)VIDEO_FRAME_DECIM_Y) != 0U))))
+    {
+        xprintf("[Camera] mode %s does not fit the frame buffers\n", m->name);
+        return false;
+    }
+
+    const TickType_t t0 = xTaskGetTickCount();
+    (void)R_CEU_Close(&g_ceu0_ctrl);
+    const int32_t n = sccb_write_table(m->regs, true);
+    if (n < 0)
+    {
+        xprintf("[Camera] mode %s: SCCB write failed\n", m->name);
+        cam_restore_mode();
+        return false;
+    }
+    if (FSP_SUCCESS != cam_ceu_open(m->width, m->height))
+    {
+        xprintf("[Camera] mode %s: CEU open failed\n", m->name);
+        cam_restore_mode();
+        return false;
+    }
+    s_cam_mode = mode;
+    s_cam_desc = video_frame_desc_make(m->width, m->height, (uint32_t)mode);
+    xprintf("[Camera] mode %s %dx%d (%d regs, %dms)\n", m->name, (int)m->width, (int)m->height, (int)n,
+            (int)((xTaskGetTickCount() - t0) * portTICK_PERIOD_MS));
+    return true;
+}
+
+void cam_request_mode(cam_mode_t mode)
+{
+    if ((uint32_t)mode < (uint32_t)CAM_MODE_COUNT)
+    {
+        s_cam_mode_request = (int32_t)mode;
+    }
+}
+
+bool cam_apply_pending_mode(void)
+{
+    const int32_t req = s_cam_mode_request;
+    if (req < 0)
+    {
+        return false;
+    }
+    s_cam_mode_request = -1;
+    if ((cam_mode_t)req == s_cam_mode)
+    {
+        return false;
+    }
+    return cam_set_mode((cam_mode_t)req);
+}
+
+cam_mode_t cam_get_mode(void)
+{
+    return s_cam_mode;
+}
+
+const video_frame_desc_t *cam_frame_desc(void)
+{
+    return &s_cam_desc;
+}
+
+cam_mode_t cam_mode_from_name(const char *name)
+{
+    for (uint32_t i = 0U; i < (uint32_t)CAM_MODE_COUNT; i++)
+    {
+        const char *a = s_cam_modes[i].name;
+        const char *b = name;
+        while ((*a != '\0') && (*a == (char)(((*b >= 'A') && (*b <= 'Z')) ? (*b + ('a' - 'A')) : *b)))
+        {
+            a++;
+            b++;
+        }
+        if ((*a == '\0') && ((*b == '\0') || (*b == ' ') || (*b == '\r') || (*b == '\n')))
+        {
+            return (cam_mode_t)i;
+        }
+    }
+    return CAM_MODE_COUNT;
+}
+
+const char *cam_mode_name(cam_mode_t mode)
+{
+    return ((uint32_t)mode < (uint32_t)CAM_MODE_COUNT) ? s_cam_modes[mode].name : "?";
+}
+
+void cam_capture_notify_set(TaskHandle_t task)
+{
+    s_cam_notify_task = task;
+}
 
+fsp_err_t cam_capture_start(uint8_t *p_buffer)
+{
     g_ceu_capture_error = false;
     g_ceu_capture_complete = false;
 
-    memset(g_image_qvga_sram, 0, VGA_WIDTH * VGA_HEIGHT * BYTE_PER_PIXEL);
+    /* 前フレームの取り残し通知を捨てる(完了判定はフラグで行う) */
+    if (s_cam_notify_task != NULL)
+    {
+        (void)ulTaskNotifyTake(pdTRUE, 0);
+    }
+
     // R_BSP_MODULE_START(FSP_IP_CEC, 0);
-    err = R_CEU_CaptureStart(&g_ceu0_ctrl, g_image_qvga_sram);
-    assert(FSP_SUCCESS == err);
+    return R_CEU_CaptureStart(&g_ceu0_ctrl, p_buffer);
+}
 
-    // xprintf("[Camera Capture] Start.\n");
+fsp_err_t cam_capture_restart(uint8_t *p_buffer)
+{
+    /* FRAME_END もエラーも来ていない = CEU はまだ取り込み中．CaptureStart は FSP_ERR_IN_USE になるので開き直す */
+    const bool in_flight = !g_ceu_capture_complete && !g_ceu_capture_error;
+    if (in_flight)
+    {
+        (void)R_CEU_Close(&g_ceu0_ctrl);
+        const fsp_err_t err = cam_ceu_open(s_cam_desc.width, s_cam_desc.height);
+        if (FSP_SUCCESS != err)
+        {
+            return err;
+        }
+    }
+
+    fsp_err_t err = cam_capture_start(p_buffer);
+    if ((FSP_ERR_IN_USE == err) && !in_flight)
+    {
+        (void)R_CEU_Close(&g_ceu0_ctrl);
+        err = cam_ceu_open(s_cam_desc.width, s_cam_desc.height);
+        if (FSP_SUCCESS == err)
+        {
+            err = cam_capture_start(p_buffer);
+        }
+    }
+    return err;
+}
+
+uint32_t cam_frame_end_cycles(void)
+{
+    return s_frame_end_cyc;
+}
+
+bool cam_capture_wait(TickType_t timeout)
+{
+    if (s_cam_notify_task != NULL)
+    {
+        while (!g_ceu_capture_complete && !g_ceu_capture_error)
+        {
+            if (ulTaskNotifyTake(pdTRUE, timeout) == 0U)
+            {
+                break; /* timeout */
+            }
+        }
+    }
+    else
+    {
+        while (!g_ceu_capture_complete /* && !g_ceu_capture_error */)
+        {
+            /* Wait for capture to complete. */
+        }
+    }
+
+    return g_ceu_capture_complete && !g_ceu_capture_error;
+}
+
+#if CAM_BAND_STREAM_ENABLE
+void cam_band_notify_set(TaskHandle_t task)
+{
+    s_band_task = task;
+}
+
+void cam_band_frame_begin(const uint8_t *p_buffer, uint32_t hyperram_base, uint32_t frame_seq)
+{
+    taskENTER_CRITICAL();
+    s_band_prev_buffer = s_band_valid ? s_band_frame.p_buffer : NULL;
+    s_band_prev_height = (uint32_t)s_band_frame.desc.height;
+    s_band_frame.p_buffer = p_buffer;
+    s_band_frame.hyperram_base = hyperram_base;
+    s_band_frame.frame_seq = frame_seq;
+    s_band_frame.desc = s_cam_desc;
+    s_band_frame.gen++;
+    s_band_valid = true;
+    s_band_hd = 0U;
+    s_band_lines = 0U;
+    taskEXIT_CRITICAL();
+
+    TaskHandle_t task = s_band_task;
+    if (task != NULL)
+    {
+        xTaskNotifyGive(task);
+    }
+}
+
+bool cam_band_frame_get(cam_band_frame_t *p_frame)
+{
+    bool valid;
+    taskENTER_CRITICAL();
+    valid = s_band_valid;
+    *p_frame = s_band_frame;
+    taskEXIT_CRITICAL();
+    return valid;
+}
+
+int32_t cam_band_lines_ready(uint32_t gen)
+{
+    int32_t lines = -1;
+    taskENTER_CRITICAL();
+    if (gen == s_band_frame.gen)
+    {
+        lines = (int32_t)s_band_lines;
+    }
+    else if (((uint32_t)(s_band_frame.gen - gen) == 1U) && (s_band_prev_buffer != s_band_frame.p_buffer))
+    {
+        /* 直前フレーム：取り込みは完了済みで，バッファはまだ上書きされていない */
+        lines = (int32_t)s_band_prev_height;
+    }
+    taskEXIT_CRITICAL();
+    return lines;
+}
+#endif
+
+#if (VIDEO_FRAME_FORMAT != VIDEO_FRAME_FMT_UYVY)
+/* Y/クロマ変換を帯単位でまとめて書き出す(HyperRAM 書き込み回数を抑える) */
+#ifndef CAM_STORE_BAND_ROWS
+#define CAM_STORE_BAND_ROWS (16)
+#endif
 
-    while (!g_ceu_capture_complete /* && !g_ceu_capture_error */)
+/*
+ * UYVY 1行 -> Y(SWAP_Y + 4px並べ替え)．
+ * 4px [U0 Y0 V0 Y1 U1 Y2 V1 Y3] -> [Y3 Y2 Y1 Y0]：奇数バイトを32bit単位で反転したものと同じ．
+ */
+static void cam_uyvy_to_y_line(const uint8_t *uyvy, uint8_t *y_out, uint32_t width)
+{
+    uint32_t x = 0U;
+#if USE_HELIUM_MVE
+    for (; (x + 15U) < width; x += 16U)
+    {
+        const uint8x16x2_t v = vld2q_u8(&uyvy[x * 2U]);
+        vst1q_u8(&y_out[x], vrev32q_u8(v.val[1]));
+    }
+#endif
+    for (; (x + 3U) < width; x += 4U)
     {
-        /* Wait for capture to complete. */
+        const uint8_t *p = &uyvy[x * 2U];
+        y_out[x + 0U] = p[7];
+        y_out[x + 1U] = p[5];
+        y_out[x + 2U] = p[3];
+        y_out[x + 3U] = p[1];
     }
+}
+
+#if (VIDEO_FRAME_FORMAT == VIDEO_FRAME_FMT_Y8) && VIDEO_FRAME_STORE_CHROMA
+static inline uint8_t cam_chroma_mag_u8(int u, int v)
+{
+    int du = u - 128;
+    int dv = v - 128;
+    int c = ((du < 0) ? -du : du) + ((dv < 0) ? -dv : dv);
+    return (uint8_t)((c > 255) ? 255 : c);
+}
+
+/* UYVY 1行 -> クロマ強度(画素ペアごと，Y と同じ4px並べ替え後の順) */
+static void cam_uyvy_to_c_half_line(const uint8_t *uyvy, uint8_t *c_out, uint32_t c_w)
+{
+    for (uint32_t k = 0U; (k + 1U) < c_w; k += 2U)
+    {
+        const uint8_t *p = &uyvy[k * 4U];
+        c_out[k + 0U] = cam_chroma_mag_u8((int)p[4], (int)p[6]);
+        c_out[k + 1U] = cam_chroma_mag_u8((int)p[0], (int)p[2]);
+    }
+}
+#endif
+#endif
+
+fsp_err_t cam_store_frame_hyperram(const uint8_t *p_uyvy, uint32_t hyperram_base, const video_frame_desc_t *desc)
+{
+    const uint32_t w = (uint32_t)desc->width;
+    const uint32_t h = (uint32_t)desc->height;
+#if (VIDEO_FRAME_FORMAT == VIDEO_FRAME_FMT_UYVY)
+    (void)w;
+    (void)h;
+    return hyperram_b_write(p_uyvy, (void *)hyperram_base, video_frame_stored_bytes(desc));
+#elif (VIDEO_FRAME_FORMAT == VIDEO_FRAME_FMT_Y8)
+    static uint8_t s_y_band[CAM_STORE_BAND_ROWS * VIDEO_FRAME_MAX_W];
+#if VIDEO_FRAME_STORE_CHROMA
+    static uint8_t s_c_band[CAM_STORE_BAND_ROWS * (VIDEO_FRAME_MAX_W / 2U)];
+    const uint32_t c_w = video_frame_c_width(desc);
+    const uint32_t c_off = video_frame_c_offset(desc);
+#endif
+    fsp_err_t err = FSP_SUCCESS;
+    for (uint32_t y0 = 0U; (y0 < h) && (FSP_SUCCESS == err); y0 += CAM_STORE_BAND_ROWS)
+    {
+        const uint32_t n = ((h - y0) < CAM_STORE_BAND_ROWS) ? (h - y0) : (uint32_t)CAM_STORE_BAND_ROWS;
+        for (uint32_t r = 0U; r < n; r++)
+        {
+            const uint8_t *src = &p_uyvy[(y0 + r) * w * 2U];
+            cam_uyvy_to_y_line(src, &s_y_band[r * w], w);
+#if VIDEO_FRAME_STORE_CHROMA
+            cam_uyvy_to_c_half_line(src, &s_c_band[r * c_w], c_w);
+#endif
+        }
+        err = hyperram_b_write(s_y_band, (void *)(hyperram_base + VIDEO_FRAME_Y_OFFSET + y0 * w), n * w);
+#if VIDEO_FRAME_STORE_CHROMA
+        if (FSP_SUCCESS == err)
+        {
+            err = hyperram_b_write(s_c_band, (void *)(hyperram_base + c_off + y0 * c_w), n * c_w);
+        }
+#endif
+    }
+    return err;
+#else /* VIDEO_FRAME_FMT_Y8_DECIM */
+    static uint8_t s_d_band[CAM_STORE_BAND_ROWS * (VIDEO_FRAME_MAX_W / (uint32_t)VIDEO_FRAME_DECIM_X)];
+    uint8_t y_line[VIDEO_FRAME_MAX_W];
+    const uint32_t dw = video_frame_decim_w(desc);
+    const uint32_t dh = video_frame_decim_h(desc);
+    fsp_err_t err = FSP_SUCCESS;
+    for (uint32_t d0 = 0U; (d0 < dh) && (FSP_SUCCESS == err); d0 += CAM_STORE_BAND_ROWS)
+    {
+        const uint32_t n = ((dh - d0) < CAM_STORE_BAND_ROWS) ? (dh - d0) : (uint32_t)CAM_STORE_BAND_ROWS;
+        for (uint32_t r = 0U; r < n; r++)
+        {
+            const uint32_t src_row = (d0 + r) * (uint32_t)VIDEO_FRAME_DECIM_Y;
+            cam_uyvy_to_y_line(&p_uyvy[src_row * w * 2U], y_line, w);
+            uint8_t *dst = &s_d_band[r * dw];
+            for (uint32_t x = 0U; x < dw; x++)
+            {
+                dst[x] = y_line[x * (uint32_t)VIDEO_FRAME_DECIM_X];
+            }
+        }
+        err = hyperram_b_write(s_d_band, (void *)(hyperram_base + VIDEO_FRAME_Y_OFFSET + d0 * dw), n * dw);
+    }
+    (void)h;
+    return err;
+#endif
+}
+
+void cam_capture(void)
+{
+    fsp_err_t err = FSP_SUCCESS;
+
+    /* CEU が全画素を上書きするので事前の memset は不要 */
+    err = cam_capture_start(g_image_qvga_sram);
+    assert(FSP_SUCCESS == err);
+
+    // xprintf("[Camera Capture] Start.\n");
+
+    (void)cam_capture_wait(portMAX_DELAY);
 
     // xprintf("[Camera Capture] end\n");
     /* Process image here if capture was successful. */
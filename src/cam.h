@@ -4,16 +4,129 @@
 #include "hal_data.h"
 #include "r_ceu.h"
 #include "sccb_if.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "video_frame_buffer.h"
 
-#define VGA_WIDTH (320)
-#define VGA_HEIGHT (240)
+/* 取り込みバッファは全モードの最大画素数で確保する(実サイズは cam_frame_desc()) */
 #define BYTE_PER_PIXEL (2)
+#define CAM_FRAME_BYTES (VIDEO_FRAME_MAX_PIXELS * BYTE_PER_PIXEL)
 
-extern uint8_t g_image_qvga_sram[VGA_WIDTH * VGA_HEIGHT * BYTE_PER_PIXEL] /* BSP_ALIGN_VARIABLE(8)*/;
+/*
+ * 取り込みモード(実行中に切り替え可能)．
+ * - QVGA   : 1280x960 全画角 -> 320x240(既定)．
+ * - WIN256 : 中央 512x512 -> 256x256．画角を絞って VTS を詰め，フレームレートを上げる．
+ * - CENTER : 中央 640x480 -> 320x240．QVGA の2倍の細かさ(遠くの対象向け，VGA 相当の解像度)．
+ * VGA 全体(640x480 UYVY)はピンポンの SRAM バッファに収まらないため，中央切り出しで代用する．
+ */
+typedef enum
+{
+    CAM_MODE_QVGA = 0,
+    CAM_MODE_WIN256,
+    CAM_MODE_CENTER,
+    CAM_MODE_COUNT
+} cam_mode_t;
+
+#ifndef CAM_MODE_DEFAULT
+#define CAM_MODE_DEFAULT (CAM_MODE_QVGA)
+#endif
+
+/*
+ * ピンポン(ダブルバッファ)キャプチャ．
+ * - FRAME_END 割り込みで登録タスクへ通知(ビジーウェイトなし)．
+ * - 完了したバッファを HyperRAM へ書き出す間に，もう一方へ次フレームを取り込む．
+ * - 0(既定)は従来の「キャプチャ→書き出し→待機」の直列動作．
+ * - 1 にすると CAM_FRAME_BYTES(150KB)の SRAM バッファがもう1面増える．RAM は 512KB で，
+ *   スレッドスタック(Thread0/1 各 64KB)と FreeRTOS ヒープを引くと既定構成には入らない．
+ *   有効にするときは Thread0/Thread1 のスタックを削ってリンカマップで RAM を確認すること．
+ */
+#ifndef CAM_PINGPONG_ENABLE
+#define CAM_PINGPONG_ENABLE (0)
+#endif
+
+extern uint8_t g_image_qvga_sram[CAM_FRAME_BYTES] /* BSP_ALIGN_VARIABLE(8)*/;
+#if CAM_PINGPONG_ENABLE
+extern uint8_t g_image_qvga_sram_b[CAM_FRAME_BYTES];
+#endif
 
 extern void g_ceu0_user_callback(capture_callback_args_t *p_args);
 void cam_init(camera_dev_t cam);
 void cam_capture(void);
 void cam_close(void);
 
+/*
+ * モード切替
+ * - cam_set_mode(): CEU を閉じ，SCCB で差分レジスタを書き，新しいサイズで CEU を開き直す．
+ *   取り込み中に呼ばないこと(Thread0 がフレームの切れ目で呼ぶ)．失敗時は false(モードは不定)．
+ * - cam_request_mode(): 任意のタスクから切替を要求する．Thread0 が次のフレーム境界で適用する．
+ * - cam_apply_pending_mode(): 要求があれば cam_set_mode() する．切り替えたら true．
+ * - cam_frame_desc(): 現在のモードで取り込まれるフレームのディスクリプタ．
+ */
+bool cam_set_mode(cam_mode_t mode);
+void cam_request_mode(cam_mode_t mode);
+bool cam_apply_pending_mode(void);
+cam_mode_t cam_get_mode(void);
+const video_frame_desc_t *cam_frame_desc(void);
+/* "qvga" / "win256" / "center" -> mode．不明なら CAM_MODE_COUNT */
+cam_mode_t cam_mode_from_name(const char *name);
+const char *cam_mode_name(cam_mode_t mode);
+
+/* 非同期キャプチャ
+ * - cam_capture_notify_set(): FRAME_END/エラー時に通知するタスク(NULLで解除)．
+ * - cam_capture_start(): p_buffer への取り込みを開始して即 return．
+ * - cam_capture_wait(): 完了(またはエラー/タイムアウト)まで待つ．正常完了で true．
+ *   通知タスク未登録ならスピン待ち(従来互換)．
+ * - cam_capture_restart(): wait が false のあとの取り直し．タイムアウト(取り込み中のまま)なら
+ *   CEU を閉じて開き直してから start する．
+ * - start/wait は登録したタスク自身から呼ぶこと．
+ */
+void cam_capture_notify_set(TaskHandle_t task);
+fsp_err_t cam_capture_start(uint8_t *p_buffer);
+bool cam_capture_wait(TickType_t timeout);
+fsp_err_t cam_capture_restart(uint8_t *p_buffer);
+uint32_t cam_frame_end_cycles(void); // 直近の FRAME_END 時刻(DWT, latency_trace 用)
+
+/* 取り込んだ UYVY(サイズは desc)を VIDEO_FRAME_FORMAT に変換して HyperRAM(base)へ書き出す */
+fsp_err_t cam_store_frame_hyperram(const uint8_t *p_uyvy, uint32_t hyperram_base, const video_frame_desc_t *desc);
+
+/*
+ * 帯(バンド)ストリーミング：CEU_EVENT_HD を数えて，SRAM に着地済みの行数を公開する．
+ * - CAM_BAND_LINES 行ごと(とFRAME_END)に登録タスクへ通知．
+ * - HD 到着直後の行はまだ CRAM→SRAM 転送中の可能性があるので CAM_BAND_HD_LAG 行遅らせて数える．
+ * - ピンポン必須(フレーム終了後も1フレーム期間はSRAMバッファが保持されるため)．
+ */
+#ifndef CAM_BAND_STREAM_ENABLE
+#define CAM_BAND_STREAM_ENABLE (0)
+#endif
+
+#ifndef CAM_BAND_LINES
+#define CAM_BAND_LINES (16)
+#endif
+
+#ifndef CAM_BAND_HD_LAG
+#define CAM_BAND_HD_LAG (2)
+#endif
+
+#if CAM_BAND_STREAM_ENABLE && !CAM_PINGPONG_ENABLE
+#error CAM_BAND_STREAM_ENABLE requires CAM_PINGPONG_ENABLE
+#endif
+
+#if CAM_BAND_STREAM_ENABLE
+/* 取り込み中フレームの情報(Thread0 が取り込み開始前に登録) */
+typedef struct
+{
+    const uint8_t *p_buffer; // CEU の書き込み先 SRAM バッファ
+    uint32_t hyperram_base;  // このフレームの HyperRAM 書き出し先
+    uint32_t frame_seq;      // 書き出し完了時に g_video_frame_seq が取る値
+    uint32_t gen;            // cam_band_frame_begin() ごとに +1
+    video_frame_desc_t desc; // 取り込みサイズ(開始時のモード)
+} cam_band_frame_t;
+
+void cam_band_notify_set(TaskHandle_t task);
+void cam_band_frame_begin(const uint8_t *p_buffer, uint32_t hyperram_base, uint32_t frame_seq);
+bool cam_band_frame_get(cam_band_frame_t *p_frame); // 未登録なら false
+/* gen のフレームで着地済みの行数．バッファが再利用されて無効なら -1 */
+int32_t cam_band_lines_ready(uint32_t gen);
+#endif
+
 #endif
\ No newline at end of file
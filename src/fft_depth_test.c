@@ -1,6 +1,8 @@
 #include "fft_depth_test.h"
 #include "putchar_ra8usb.h"
 #include "verify_mode.h"
+#include "binlog.h"
+#include "prof.h"
 #include <math.h>
 #include <string.h>
 
@@ -34,7 +36,6 @@ static bool g_fft_print_phases_once_done = false;
 
 #if FFT_DIAG_LOG
 static bool g_fft_print_build_caps_once = false;
-static bool g_fft_print_fft256_path_once = false;
 #endif
 
 static inline void fft_verify_delay_ms(uint32_t ms)
@@ -63,20 +64,28 @@ static inline void fft_verify_delay_ms(uint32_t ms)
 #define FFT_ALIGN16
 #endif
 
-/* 三角関数テーブル(事前計算で高速化) */
-#define MAX_FFT_SIZE 256
-static float cos_table[MAX_FFT_SIZE / 2];
-static float sin_table[MAX_FFT_SIZE / 2];
-static bool trig_table_initialized = false;
-static int trig_table_N = 0;
+#define MAX_FFT_SIZE FFT_PLAN_MAX_N
+#define FFT_PLAN_MAX_LOG2 (8)
 
-/* Precomputed bit-reversal indices for current trig_table_N. */
-static uint16_t bitrev_table[MAX_FFT_SIZE];
-static int bitrev_table_N = 0;
+#if ((1 << FFT_PLAN_MAX_LOG2) != MAX_FFT_SIZE)
+#error "FFT_PLAN_MAX_LOG2 must match FFT_PLAN_MAX_N"
+#endif
+
+/*
+ * FFT計画(fft_plan_t)のテーブル．サイズ・方向ごとに一度だけ構築し，以後はSRAM上のものを使い回す．
+ * - radix-2: 段ごとの回転係数を連続配置(halfStep=h の段は [h-1, 2h-1))．サイズNは N-1 要素で，
+ *   プール内のオフセットは N-1-log2(N)．方向(順/逆)の符号は込み．
+ * - ビット反転表は方向で共通．サイズNはプール内オフセット N-2 から N 要素．
+ */
+#define FFT_PLAN_TW_POOL (2 * MAX_FFT_SIZE - 2 - FFT_PLAN_MAX_LOG2)
+#define FFT_PLAN_BITREV_POOL (2 * MAX_FFT_SIZE - 2)
 
-/* Per-stage twiddle buffers (contiguous), sized for MAX_FFT_SIZE. */
-static float twiddle_stage_real[MAX_FFT_SIZE / 2];
-static float twiddle_stage_imag[MAX_FFT_SIZE / 2];
+static float g_plan_tw_real[2][FFT_PLAN_TW_POOL];
+static float g_plan_tw_imag[2][FFT_PLAN_TW_POOL];
+static uint16_t g_plan_bitrev[FFT_PLAN_BITREV_POOL];
+static uint32_t g_plan_bitrev_built = 0u; /* bit log2n */
+
+static fft_plan_t g_plans[2][FFT_PLAN_MAX_LOG2 + 1];
 
 /* Interleaved complex scratch for CMSIS CFFT: [re0, im0, re1, im1, ...] */
 static FFT_ALIGN16 float g_cfft_io[2 * MAX_FFT_SIZE];
@@ -84,8 +93,7 @@ static FFT_ALIGN16 float g_cfft_io[2 * MAX_FFT_SIZE];
 /* Optional float16 CFFT scratch/instance (requires CMSIS float16 support). */
 #if defined(ARM_FLOAT16_SUPPORTED)
 static FFT_ALIGN16 float16_t g_cfft_io_f16[2 * MAX_FFT_SIZE];
-static arm_cfft_instance_f16 g_cfft_inst_f16;
-static int g_cfft_inst_f16_N = 0;
+static arm_cfft_instance_f16 g_plan_cfft_f16;
 #endif
 
 /*
@@ -97,61 +105,18 @@ static int g_cfft_inst_f16_N = 0;
 #define FFT_USE_CFFT_F16_256 (0)
 #endif
 
-static arm_cfft_instance_f32 g_cfft_inst_f32;
-static int g_cfft_inst_N = 0;
-
-static inline const arm_cfft_instance_f32 *fft_get_cfft_instance_f32(int N)
-{
-    if (!((N == 128) || (N == 256)))
-    {
-        return NULL;
-    }
-
-    if (g_cfft_inst_N != N)
-    {
-        /* For MVE, CMSIS recommends using arm_cfft_init_f32 rather than const structs. */
-        arm_status st = arm_cfft_init_f32(&g_cfft_inst_f32, (uint16_t)N);
-        if (st != ARM_MATH_SUCCESS)
-        {
-            g_cfft_inst_N = 0;
-            return NULL;
-        }
-        g_cfft_inst_N = N;
-    }
-
-    return &g_cfft_inst_f32;
-}
-
-#if defined(ARM_FLOAT16_SUPPORTED)
-static inline const arm_cfft_instance_f16 *fft_get_cfft_instance_f16(int N)
-{
-    if (!(N == 256))
-    {
-        return NULL;
-    }
-
-    if (g_cfft_inst_f16_N != N)
-    {
-        arm_status st = arm_cfft_init_f16(&g_cfft_inst_f16, (uint16_t)N);
-        if (st != ARM_MATH_SUCCESS)
-        {
-            g_cfft_inst_f16_N = 0;
-            return NULL;
-        }
-        g_cfft_inst_f16_N = N;
-    }
-
-    return &g_cfft_inst_f16;
-}
+/*
+ * Smallest size that uses arm_cfft_f32 (CMSIS mixed radix-8/4/2, MVE-optimized).
+ * Smaller sizes, or sizes CMSIS rejects, use the in-tree radix-2 kernel.
+ */
+#ifndef FFT_PLAN_CMSIS_MIN_N
+#define FFT_PLAN_CMSIS_MIN_N (16)
 #endif
 
-static inline void fft_1d_cmsis_cfft_f32(float *real, float *imag, int N, bool is_inverse)
+static arm_cfft_instance_f32 g_plan_cfft_f32[FFT_PLAN_MAX_LOG2 + 1];
+
+static inline void fft_1d_cmsis_cfft_f32(const arm_cfft_instance_f32 *S, float *real, float *imag, int N, bool is_inverse)
 {
-    const arm_cfft_instance_f32 *S = fft_get_cfft_instance_f32(N);
-    if (!S)
-    {
-        return;
-    }
 
 #if USE_HELIUM_MVE
     int i;
@@ -208,13 +173,8 @@ static inline void fft_1d_cmsis_cfft_f32(float *real, float *imag, int N, bool i
  * - Run CFFT f16
  * - Unpack interleaved f16 directly into split f32
  */
-static inline bool fft_1d_cmsis_cfft_f16(float *real, float *imag, int N, bool is_inverse)
+static inline void fft_1d_cmsis_cfft_f16(const arm_cfft_instance_f16 *S, float *real, float *imag, int N, bool is_inverse)
 {
-    const arm_cfft_instance_f16 *S = fft_get_cfft_instance_f16(N);
-    if (!S)
-    {
-        return false;
-    }
 
     /* Pack directly into interleaved f16 to avoid extra f32 scratch traffic. */
 #if USE_HELIUM_MVE && defined(ARM_MATH_MVE_FLOAT16)
@@ -284,8 +244,6 @@ static inline bool fft_1d_cmsis_cfft_f16(float *real, float *imag, int N, bool i
         imag[i] = (float)g_cfft_io_f16[2 * i + 1];
     }
 #endif
-
-    return true;
 }
 #endif
 
@@ -730,41 +688,6 @@ static inline uint32_t fft_cycles_to_us(uint32_t cycles_or_ticks)
     return ms * 1000u;
 }
 
-/* 三角関数テーブルの初期化 */
-static void init_trig_tables(int N)
-{
-    if (trig_table_initialized && (trig_table_N == N) && (N <= MAX_FFT_SIZE))
-    {
-        return;
-    }
-
-    if ((N <= 0) || (N > MAX_FFT_SIZE))
-    {
-        return;
-    }
-
-    /* Require power-of-two sizes. */
-    if ((N & (N - 1)) != 0)
-    {
-        return;
-    }
-
-    const float two_pi_over_N = 2.0f * (float)M_PI / (float)N;
-
-    for (int i = 0; i < N / 2; i++)
-    {
-        float angle = two_pi_over_N * (float)i;
-        cos_table[i] = cosf(angle);
-        sin_table[i] = sinf(angle);
-    }
-
-    trig_table_initialized = true;
-    trig_table_N = N;
-
-    /* Also build bit-reversal table for this N (used by fft_1d_mve). */
-    bitrev_table_N = 0;
-}
-
 /* ビット反転インデックス計算 */
 static int bit_reverse(int i, int log2n)
 {
@@ -788,86 +711,134 @@ static inline int fft_log2_pow2_u32(uint32_t n)
     return log2n;
 }
 
-static void init_bitrev_table(int N)
+/* radix-2 計画用テーブル(回転係数・ビット反転)の構築 */
+static void fft_plan_build_radix2_tables(fft_plan_t *plan)
 {
-    if ((N <= 0) || (N > MAX_FFT_SIZE))
+    const int N = plan->N;
+    const int dir = plan->is_inverse ? 1 : 0;
+    float *tw_real = &g_plan_tw_real[dir][N - 1 - plan->log2n];
+    float *tw_imag = &g_plan_tw_imag[dir][N - 1 - plan->log2n];
+    uint16_t *bitrev = &g_plan_bitrev[N - 2];
+
+    const float two_pi_over_N = 2.0f * (float)M_PI / (float)N;
+    for (int half_step = 1; half_step < N; half_step *= 2)
     {
-        return;
+        const int table_step = N / (2 * half_step);
+        for (int m = 0; m < half_step; m++)
+        {
+            const float angle = two_pi_over_N * (float)(m * table_step);
+            const float s = sinf(angle);
+            tw_real[half_step - 1 + m] = cosf(angle);
+            tw_imag[half_step - 1 + m] = plan->is_inverse ? s : -s;
+        }
     }
-    if (bitrev_table_N == N)
+
+    if ((g_plan_bitrev_built & (1u << plan->log2n)) == 0u)
     {
-        return;
+        for (int i = 0; i < N; i++)
+        {
+            bitrev[i] = (uint16_t)bit_reverse(i, plan->log2n);
+        }
+        g_plan_bitrev_built |= (1u << plan->log2n);
     }
 
-    int log2n = fft_log2_pow2_u32((uint32_t)N);
-    for (int i = 0; i < N; i++)
+    plan->tw_real = tw_real;
+    plan->tw_imag = tw_imag;
+    plan->bitrev = bitrev;
+}
+
+static const char *fft_kernel_name(fft_kernel_t k)
+{
+    switch (k)
     {
-        bitrev_table[i] = (uint16_t)bit_reverse(i, log2n);
+    case FFT_KERNEL_RADIX2:
+        return "radix2";
+    case FFT_KERNEL_CMSIS_F32:
+        return "cmsis_f32";
+    case FFT_KERNEL_CMSIS_F16:
+        return "cmsis_f16";
+    default:
+        return "none";
     }
-    bitrev_table_N = N;
 }
 
-/* 1D FFT (Danielson-Lanczos法，MVE最適化版) */
-void fft_1d_mve(float *real, float *imag, int N, bool is_inverse)
+/*
+ * サイズN・方向ごとの計画を返す(初回のみ構築，以後はキャッシュ)．
+ * N は 2..FFT_PLAN_MAX_N の2のべき乗．それ以外は NULL．
+ * 構築はロックしないので，同じサイズを初めて使うのは1スレッドからにすること．
+ */
+const fft_plan_t *fft_plan_get(int N, bool is_inverse)
 {
-    /* Hot sizes: use CMSIS-DSP CFFT (math-correct + MVE-optimized). */
-    if ((N == 128) || (N == 256))
+    if ((N < 2) || (N > MAX_FFT_SIZE) || ((N & (N - 1)) != 0))
     {
-        if (N == 256)
-        {
-#if defined(ARM_FLOAT16_SUPPORTED) && FFT_USE_CFFT_F16_256
-            bool used_f16 = fft_1d_cmsis_cfft_f16(real, imag, N, is_inverse);
+        return NULL;
+    }
 
-#if FFT_DIAG_LOG
-            if (!g_fft_print_fft256_path_once)
-            {
-                g_fft_print_fft256_path_once = true;
-#if USE_HELIUM_MVE && defined(ARM_MATH_MVE_FLOAT16)
-                const int cap_fft_f16_pack_mve = 1;
-#else
-                const int cap_fft_f16_pack_mve = 0;
-#endif
-                FFT_LOG("[FFT] fft256: path=%s pack_mve=%d\n", used_f16 ? "f16" : "f32_fallback", cap_fft_f16_pack_mve);
-            }
-#endif
+    const int log2n = fft_log2_pow2_u32((uint32_t)N);
+    fft_plan_t *plan = &g_plans[is_inverse ? 1 : 0][log2n];
+    if (plan->kernel != FFT_KERNEL_NONE)
+    {
+        return plan;
+    }
 
-            if (used_f16)
-            {
-                return;
-            }
-#else
-#if FFT_DIAG_LOG
-            if (!g_fft_print_fft256_path_once)
-            {
-                g_fft_print_fft256_path_once = true;
-                FFT_LOG("[FFT] fft256: path=f32 (f16_disabled_or_unavailable)\n");
-            }
-#endif
-#endif
-        }
+    plan->N = N;
+    plan->log2n = log2n;
+    plan->is_inverse = is_inverse;
+    plan->tw_real = NULL;
+    plan->tw_imag = NULL;
+    plan->bitrev = NULL;
+    plan->cfft = NULL;
 
-        fft_1d_cmsis_cfft_f32(real, imag, N, is_inverse);
-        return;
+#if defined(ARM_FLOAT16_SUPPORTED) && FFT_USE_CFFT_F16_256
+    if ((N == 256) && (arm_cfft_init_f16(&g_plan_cfft_f16, (uint16_t)N) == ARM_MATH_SUCCESS))
+    {
+        plan->cfft = &g_plan_cfft_f16;
+        plan->kernel = FFT_KERNEL_CMSIS_F16;
     }
+#endif
 
-    // 三角関数テーブル初期化
-    init_trig_tables(N);
-
-    if ((N <= 0) || (N > MAX_FFT_SIZE))
+    if ((plan->kernel == FFT_KERNEL_NONE) && (N >= FFT_PLAN_CMSIS_MIN_N))
     {
-        return;
+        /* For MVE, CMSIS recommends using arm_cfft_init_f32 rather than const structs. */
+        if (arm_cfft_init_f32(&g_plan_cfft_f32[log2n], (uint16_t)N) == ARM_MATH_SUCCESS)
+        {
+            plan->cfft = &g_plan_cfft_f32[log2n];
+            plan->kernel = FFT_KERNEL_CMSIS_F32;
+        }
     }
-    if ((N & (N - 1)) != 0)
+
+    if (plan->kernel == FFT_KERNEL_NONE)
     {
-        return;
+        fft_plan_build_radix2_tables(plan);
+        plan->kernel = FFT_KERNEL_RADIX2;
     }
 
-    init_bitrev_table(N);
+#if FFT_DIAG_LOG
+    FFT_LOG("[FFT] plan N=%d %s kernel=%s\n", N, is_inverse ? "inv" : "fwd", fft_kernel_name(plan->kernel));
+#else
+    (void)fft_kernel_name;
+#endif
+
+    return plan;
+}
+
+bool fft_plan2d_init(fft_plan2d_t *plan, int rows, int cols, bool is_inverse)
+{
+    plan->row = fft_plan_get(cols, is_inverse);
+    plan->col = fft_plan_get(rows, is_inverse);
+    return (plan->row != NULL) && (plan->col != NULL);
+}
+
+/* 1D FFT (Danielson-Lanczos法，MVE最適化版．回転係数/ビット反転は計画のテーブル) */
+static void fft_exec_radix2(const fft_plan_t *plan, float *real, float *imag)
+{
+    const int N = plan->N;
+    const uint16_t *bitrev = plan->bitrev;
 
     // ビット反転並び替え
     for (int i = 0; i < N; i++)
     {
-        int j = (int)bitrev_table[i];
+        int j = (int)bitrev[i];
         if (i < j)
         {
             // 実数部交換
@@ -886,15 +857,8 @@ void fft_1d_mve(float *real, float *imag, int N, bool is_inverse)
     for (int step = 2; step <= N; step *= 2)
     {
         int halfStep = step / 2;
-        int tableStep = N / step;
-
-        /* Build contiguous twiddle arrays for this stage (twiddles depend only on m). */
-        for (int m = 0; m < halfStep; m++)
-        {
-            int index = m * tableStep; /* Always < N/2 for radix-2 stages. */
-            twiddle_stage_real[m] = cos_table[index];
-            twiddle_stage_imag[m] = is_inverse ? sin_table[index] : -sin_table[index];
-        }
+        const float *twiddle_stage_real = &plan->tw_real[halfStep - 1];
+        const float *twiddle_stage_imag = &plan->tw_imag[halfStep - 1];
 
         for (int k = 0; k < N; k += step)
         {
@@ -966,7 +930,7 @@ void fft_1d_mve(float *real, float *imag, int N, bool is_inverse)
     }
 
     // 逆FFTの場合はスケーリング
-    if (is_inverse)
+    if (plan->is_inverse)
     {
         float scale = 1.0f / (float)N;
 #if USE_HELIUM_MVE
@@ -1000,15 +964,77 @@ void fft_1d_mve(float *real, float *imag, int N, bool is_inverse)
     }
 }
 
+/*
+ * count 本の1D FFTを一括実行(i本目は real/imag の i*stride から N 要素)．
+ * カーネル分岐は1回だけ．
+ */
+void fft_plan_execute_batch(const fft_plan_t *plan, float *real, float *imag, int count, int stride)
+{
+    if (!plan)
+    {
+        return;
+    }
+
+    switch (plan->kernel)
+    {
+    case FFT_KERNEL_CMSIS_F32:
+        for (int i = 0; i < count; i++)
+        {
+            fft_1d_cmsis_cfft_f32((const arm_cfft_instance_f32 *)plan->cfft,
+                                  &real[i * stride], &imag[i * stride], plan->N, plan->is_inverse);
+        }
+        break;
+#if defined(ARM_FLOAT16_SUPPORTED)
+    case FFT_KERNEL_CMSIS_F16:
+        for (int i = 0; i < count; i++)
+        {
+            fft_1d_cmsis_cfft_f16((const arm_cfft_instance_f16 *)plan->cfft,
+                                  &real[i * stride], &imag[i * stride], plan->N, plan->is_inverse);
+        }
+        break;
+#endif
+    case FFT_KERNEL_RADIX2:
+        for (int i = 0; i < count; i++)
+        {
+            fft_exec_radix2(plan, &real[i * stride], &imag[i * stride]);
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void fft_plan_execute(const fft_plan_t *plan, float *real, float *imag)
+{
+    fft_plan_execute_batch(plan, real, imag, 1, 0);
+}
+
+/* 互換用: サイズ・方向から計画を引いて実行 */
+void fft_1d_mve(float *real, float *imag, int N, bool is_inverse)
+{
+    fft_plan_execute(fft_plan_get(N, is_inverse), real, imag);
+}
+
 /* 2D FFT (行→列の順に1D FFTを適用) */
-void fft_2d(float *real, float *imag, int rows, int cols, bool is_inverse)
+void fft_2d(const fft_plan2d_t *plan, float *real, float *imag)
 {
-    // 行方向にFFT
-    for (int r = 0; r < rows; r++)
+    if (!plan || !plan->row || !plan->col)
     {
-        fft_1d_mve(&real[r * cols], &imag[r * cols], cols, is_inverse);
+        xprintf("[FFT] ERROR: invalid plan\n");
+        return;
+    }
+    const int rows = plan->col->N;
+    const int cols = plan->row->N;
+
+    if (rows > FFT_TEST_SIZE)
+    {
+        xprintf("[FFT] ERROR: rows exceed column buffer (%d)\n", FFT_TEST_SIZE);
+        return;
     }
 
+    // 行方向にFFT(全行を一括実行)
+    fft_plan_execute_batch(plan->row, real, imag, rows, cols);
+
     // 列方向にFFT(スタティックバッファ使用)
     for (int c = 0; c < cols; c++)
     {
@@ -1020,7 +1046,7 @@ void fft_2d(float *real, float *imag, int rows, int cols, bool is_inverse)
         }
 
         // 列にFFT適用
-        fft_1d_mve(g_fft_col_real, g_fft_col_imag, rows, is_inverse);
+        fft_plan_execute(plan->col, g_fft_col_real, g_fft_col_imag);
 
         // 結果を戻す
         for (int r = 0; r < rows; r++)
@@ -1033,12 +1059,20 @@ void fft_2d(float *real, float *imag, int rows, int cols, bool is_inverse)
 
 /* HyperRAMベース2D FFT/IFFT(メモリ効率版) */
 void fft_2d_hyperram(
+    const fft_plan2d_t *plan,
     uint32_t hyperram_input_real_offset,
     uint32_t hyperram_input_imag_offset,
     uint32_t hyperram_output_real_offset,
-    uint32_t hyperram_output_imag_offset,
-    int rows, int cols, bool is_inverse)
+    uint32_t hyperram_output_imag_offset)
 {
+    if (!plan || !plan->row || !plan->col)
+    {
+        xprintf("[FFT] ERROR: invalid plan\n");
+        return;
+    }
+    const int rows = plan->col->N;
+    const int cols = plan->row->N;
+
     // RAM上に1行/1列分の作業バッファのみ確保(最大256要素)
     static float work_real[256];
     static float work_imag[256];
@@ -1061,7 +1095,7 @@ void fft_2d_hyperram(
         hyperram_b_read(work_imag, (void *)row_offset_imag, (uint32_t)(cols) * sizeof(float));
 
         // 行方向1D FFT実行
-        fft_1d_mve(work_real, work_imag, cols, is_inverse);
+        fft_plan_execute(plan->row, work_real, work_imag);
 
         // HyperRAMに結果を書き戻し
         uint32_t out_row_offset_real = hyperram_output_real_offset + (uint32_t)(r * cols) * sizeof(float);
@@ -1110,7 +1144,7 @@ void fft_2d_hyperram(
     // 列ごとにFFT実行(転置済みなので連続メモリアクセス)
     for (int c = 0; c < cols; c++)
     {
-        fft_1d_mve(&transposed_real[c * rows], &transposed_imag[c * rows], rows, is_inverse);
+        fft_plan_execute(plan->col, &transposed_real[c * rows], &transposed_imag[c * rows]);
 
         if ((c + 1) % 10 == 0 || c == cols - 1)
         {
@@ -1141,12 +1175,21 @@ void fft_2d_hyperram(
 
 /* ブロック処理版2D FFT (32×32ブロック単位で処理) */
 void fft_2d_hyperram_blocked(
+    const fft_plan2d_t *plan,
     uint32_t hyperram_input_real_offset,
     uint32_t hyperram_input_imag_offset,
     uint32_t hyperram_output_real_offset,
-    uint32_t hyperram_output_imag_offset,
-    int rows, int cols, bool is_inverse)
+    uint32_t hyperram_output_imag_offset)
 {
+    if (!plan || !plan->row || !plan->col)
+    {
+        xprintf("[FFT] ERROR: invalid plan\n");
+        return;
+    }
+    const int rows = plan->col->N;
+    const int cols = plan->row->N;
+    const bool is_inverse = plan->row->is_inverse;
+
     const int BLOCK_SIZE = 32;
     static float block_real[32 * 32]; // 4KB
     static float block_imag[32 * 32]; // 4KB
@@ -1178,7 +1221,7 @@ void fft_2d_hyperram_blocked(
         hyperram_b_read(row_imag, (void *)in_row_offset_imag, (uint32_t)cols * sizeof(float));
 
         fft_sanitize_complex_vec(row_real, row_imag, cols, &san);
-        fft_1d_mve(row_real, row_imag, cols, is_inverse);
+        fft_plan_execute(plan->row, row_real, row_imag);
         fft_sanitize_complex_vec(row_real, row_imag, cols, &san);
 
         hyperram_b_write(row_real, (void *)out_row_offset_real, (uint32_t)cols * sizeof(float));
@@ -1205,6 +1248,13 @@ void fft_2d_hyperram_blocked(
             int start_col = block_c * BLOCK_SIZE;
             int block_height = (start_row + BLOCK_SIZE > rows) ? (rows - start_row) : BLOCK_SIZE;
             int block_width = (start_col + BLOCK_SIZE > cols) ? (cols - start_col) : BLOCK_SIZE;
+            // 列FFTはブロック高さ単位(プランはサイズ別キャッシュから取得)
+            const fft_plan_t *blk_plan = fft_plan_get(block_height, is_inverse);
+            if (!blk_plan)
+            {
+                xprintf("[FFT-Blocked] ERROR: no plan for block height %d\n", block_height);
+                return;
+            }
 
             // ブロックをRAMに読み込み
             for (int r = 0; r < block_height; r++)
@@ -1234,7 +1284,7 @@ void fft_2d_hyperram_blocked(
 
                 // 列FFT実行
                 fft_sanitize_complex_vec(work_real, work_imag, block_height, &san);
-                fft_1d_mve(work_real, work_imag, block_height, is_inverse);
+                fft_plan_execute(blk_plan, work_real, work_imag);
                 fft_sanitize_complex_vec(work_real, work_imag, block_height, &san);
 
                 // 結果を戻す
@@ -1335,14 +1385,23 @@ static void hyperram_transpose_tiled(
  * 行FFT(cols点)の後，HyperRAM上で転置して列FFT(rows点)を行FFTとして実行．
  */
 void fft_2d_hyperram_full(
+    const fft_plan2d_t *plan,
     uint32_t hyperram_input_real_offset,
     uint32_t hyperram_input_imag_offset,
     uint32_t hyperram_output_real_offset,
     uint32_t hyperram_output_imag_offset,
     uint32_t hyperram_tmp_real_offset,
-    uint32_t hyperram_tmp_imag_offset,
-    int rows, int cols, bool is_inverse)
+    uint32_t hyperram_tmp_imag_offset)
 {
+    if (!plan || !plan->row || !plan->col)
+    {
+        xprintf("[FFT] ERROR: invalid plan\n");
+        return;
+    }
+    const int rows = plan->col->N;
+    const int cols = plan->row->N;
+    const bool is_inverse = plan->row->is_inverse;
+
     static float row_real[256];
     static float row_imag[256];
     fft_sanitize_stats_t san = {0u, 0u};
@@ -1376,7 +1435,7 @@ void fft_2d_hyperram_full(
         hyperram_b_read(row_imag, (void *)in_row_imag, (uint32_t)cols * sizeof(float));
 
         fft_sanitize_complex_vec(row_real, row_imag, cols, &san);
-        fft_1d_mve(row_real, row_imag, cols, is_inverse);
+        fft_plan_execute(plan->row, row_real, row_imag);
         fft_sanitize_complex_vec(row_real, row_imag, cols, &san);
 
         hyperram_b_write(row_real, (void *)out_row_real, (uint32_t)cols * sizeof(float));
@@ -1406,7 +1465,7 @@ void fft_2d_hyperram_full(
         hyperram_b_read(row_imag, (void *)tmp_row_imag, (uint32_t)rows * sizeof(float));
 
         fft_sanitize_complex_vec(row_real, row_imag, rows, &san);
-        fft_1d_mve(row_real, row_imag, rows, is_inverse);
+        fft_plan_execute(plan->col, row_real, row_imag);
         fft_sanitize_complex_vec(row_real, row_imag, rows, &san);
 
         hyperram_b_write(row_real, (void *)tmp_row_real, (uint32_t)rows * sizeof(float));
@@ -1425,6 +1484,13 @@ void fft_2d_hyperram_full(
         rows);
     g_fft_full_last_cycles.xpose2_cycles = (uint32_t)(fft_cycles_now() - t_phase);
 
+    if (g_fft_timing_use_dwt)
+    {
+        prof_record(PROF_SPAN_FFT_ROWS, g_fft_full_last_cycles.row_fft_cycles);
+        prof_record(PROF_SPAN_FFT_XPOSE, g_fft_full_last_cycles.xpose1_cycles + g_fft_full_last_cycles.xpose2_cycles);
+        prof_record(PROF_SPAN_FFT_COLS, g_fft_full_last_cycles.col_fft_cycles);
+    }
+
     if ((san.nonfinite != 0u) || (san.clipped != 0u))
     {
         xprintf("[SAN] %s nf=%u clip=%u\n",
@@ -1436,12 +1502,20 @@ void fft_2d_hyperram_full(
 
 /* ROW処理のみ実行(デバッグ用) */
 void fft_2d_hyperram_row_only(
+    const fft_plan2d_t *plan,
     uint32_t hyperram_input_real_offset,
     uint32_t hyperram_input_imag_offset,
     uint32_t hyperram_output_real_offset,
-    uint32_t hyperram_output_imag_offset,
-    int rows, int cols, bool is_inverse)
+    uint32_t hyperram_output_imag_offset)
 {
+    if (!plan || !plan->row || !plan->col)
+    {
+        xprintf("[FFT] ERROR: invalid plan\n");
+        return;
+    }
+    const int rows = plan->col->N;
+    const int cols = plan->row->N;
+
     static float work_real[256];
     static float work_imag[256];
 
@@ -1460,7 +1534,7 @@ void fft_2d_hyperram_row_only(
         hyperram_b_read(work_real, (void *)row_offset_real, (uint32_t)(cols) * sizeof(float));
         hyperram_b_read(work_imag, (void *)row_offset_imag, (uint32_t)(cols) * sizeof(float));
 
-        fft_1d_mve(work_real, work_imag, cols, is_inverse);
+        fft_plan_execute(plan->row, work_real, work_imag);
 
         uint32_t out_row_offset_real = hyperram_output_real_offset + (uint32_t)(r * cols) * sizeof(float);
         uint32_t out_row_offset_imag = hyperram_output_imag_offset + (uint32_t)(r * cols) * sizeof(float);
@@ -1478,12 +1552,20 @@ void fft_2d_hyperram_row_only(
 
 /* COL処理のみ実行(デバッグ用)- 転置方式 */
 void fft_2d_hyperram_col_only(
+    const fft_plan2d_t *plan,
     uint32_t hyperram_input_real_offset,
     uint32_t hyperram_input_imag_offset,
     uint32_t hyperram_output_real_offset,
-    uint32_t hyperram_output_imag_offset,
-    int rows, int cols, bool is_inverse)
+    uint32_t hyperram_output_imag_offset)
 {
+    if (!plan || !plan->row || !plan->col)
+    {
+        xprintf("[FFT] ERROR: invalid plan\n");
+        return;
+    }
+    const int rows = plan->col->N;
+    const int cols = plan->row->N;
+
     (void)hyperram_input_real_offset;
     (void)hyperram_input_imag_offset;
 
@@ -1530,7 +1612,7 @@ void fft_2d_hyperram_col_only(
     // 列ごとにFFT実行(転置済みなので連続メモリアクセス)
     for (int c = 0; c < cols; c++)
     {
-        fft_1d_mve(&transposed_real[c * rows], &transposed_imag[c * rows], rows, is_inverse);
+        fft_plan_execute(plan->col, &transposed_real[c * rows], &transposed_imag[c * rows]);
 
         if ((c + 1) % 10 == 0 || c == cols - 1)
         {
@@ -1561,6 +1643,384 @@ void fft_2d_hyperram_col_only(
     xprintf("[FFT-HyperRAM] COL processing complete!\n");
 }
 
+/*
+ * ブロック浮動小数点(BFP)固定小数点2D FFT．
+ * - HyperRAM上の平面は int16 複素数(re,im インターリーブ，rows x cols)．
+ * - 値 = v * 2^exp．exp は行パスでは行ごと，列パスでは列ごとに1つ持つ．
+ * - 各1D FFTは q31 に正規化(最大値を FFT_BFP_Q31_BITS ビット)してから arm_cfft_q31 で実行し，
+ *   結果を再び q15 に丸めて指数を更新する(q31 CFFT は内部で 1/N スケーリング)．
+ */
+#ifndef FFT_BFP_STRIP_W
+#define FFT_BFP_STRIP_W (16) // 列パスで一度に読む列数(HyperRAMアクセス1回 = 4*W bytes)
+#endif
+
+/* q31 入力の最大ビット長(1ビットのガード)． */
+#define FFT_BFP_Q31_BITS (30)
+
+static arm_cfft_instance_q31 g_plan_cfft_q31[FFT_PLAN_MAX_LOG2 + 1];
+static uint32_t g_plan_cfft_q31_built = 0u; /* bit log2n */
+static FFT_ALIGN16 q31_t g_cfft_io_q31[2 * MAX_FFT_SIZE];
+
+/* q31 CFFT instance, built once per size like fft_plan_get(). */
+static inline const arm_cfft_instance_q31 *fft_get_cfft_instance_q31(int N)
+{
+    if (!((N == 128) || (N == 256)))
+    {
+        return NULL;
+    }
+
+    const int log2n = fft_log2_pow2_u32((uint32_t)N);
+    if ((g_plan_cfft_q31_built & (1u << log2n)) == 0u)
+    {
+        arm_status st = arm_cfft_init_q31(&g_plan_cfft_q31[log2n], (uint16_t)N);
+        if (st != ARM_MATH_SUCCESS)
+        {
+            return NULL;
+        }
+        g_plan_cfft_q31_built |= (1u << log2n);
+    }
+
+    return &g_plan_cfft_q31[log2n];
+}
+
+static inline int fft_bfp_bitlen_u32(uint32_t v)
+{
+    if (v == 0U)
+    {
+        return 0;
+    }
+#if defined(__GNUC__)
+    return 32 - __builtin_clz(v);
+#else
+    return 32 - (int)__CLZ(v);
+#endif
+}
+
+static inline int8_t fft_bfp_clamp_exp(int e)
+{
+    if (e < (FFT_BFP_EXP_ZERO + 1))
+    {
+        e = FFT_BFP_EXP_ZERO + 1;
+    }
+    if (e > 127)
+    {
+        e = 127;
+    }
+    return (int8_t)e;
+}
+
+static inline int32_t fft_bfp_shift_s32(int32_t v, int sh)
+{
+    if (sh >= 0)
+    {
+        return (int32_t)((uint32_t)v << sh);
+    }
+    return (sh <= -31) ? ((v < 0) ? -1 : 0) : (v >> -sh);
+}
+
+static uint32_t fft_bfp_maxabs_q15(const q15_t *v, int n)
+{
+    uint32_t m = 0U;
+    int i = 0;
+#if USE_HELIUM_MVE
+    uint16_t m16 = 0U;
+    for (; i + 7 < n; i += 8)
+    {
+        m16 = vmaxavq_s16(m16, vld1q_s16(&v[i]));
+    }
+    m = (uint32_t)m16;
+#endif
+    for (; i < n; i++)
+    {
+        uint32_t a = (v[i] < 0) ? (uint32_t)(-(int32_t)v[i]) : (uint32_t)v[i];
+        if (a > m)
+        {
+            m = a;
+        }
+    }
+    return m;
+}
+
+static uint32_t fft_bfp_maxabs_q31(const q31_t *v, int n)
+{
+    uint32_t m = 0U;
+    int i = 0;
+#if USE_HELIUM_MVE
+    for (; i + 3 < n; i += 4)
+    {
+        m = vmaxavq_s32(m, vld1q_s32(&v[i]));
+    }
+#endif
+    for (; i < n; i++)
+    {
+        uint32_t a = (v[i] < 0) ? ((uint32_t)0 - (uint32_t)v[i]) : (uint32_t)v[i];
+        if (a > m)
+        {
+            m = a;
+        }
+    }
+    return m;
+}
+
+/* dst = src << ls (q15 -> q31, ls >= 0) */
+static void fft_bfp_q15_to_q31(const q15_t *src, q31_t *dst, int n, int ls)
+{
+    int i = 0;
+#if USE_HELIUM_MVE
+    const int32x4_t v_ls = vdupq_n_s32(ls);
+    for (; i + 3 < n; i += 4)
+    {
+        vst1q_s32(&dst[i], vshlq_s32(vldrhq_s32(&src[i]), v_ls));
+    }
+#endif
+    for (; i < n; i++)
+    {
+        dst[i] = (q31_t)((uint32_t)(int32_t)src[i] << ls);
+    }
+}
+
+/*
+ * q31 -> q15 を最大値基準で丸める．戻り値は指数の増分(dst * 2^ret = src)．
+ * 全要素0なら dst=0 で FFT_BFP_EXP_ZERO を返す．
+ */
+static int fft_bfp_q31_to_q15(const q31_t *src, q15_t *dst, int n)
+{
+    const uint32_t m = fft_bfp_maxabs_q31(src, n);
+    if (m == 0U)
+    {
+        memset(dst, 0, (size_t)n * sizeof(q15_t));
+        return FFT_BFP_EXP_ZERO;
+    }
+
+    const int sh = fft_bfp_bitlen_u32(m) - 15;
+    int i = 0;
+#if USE_HELIUM_MVE
+    {
+        /* vrshlq: negative shift = rounding right shift. */
+        const int32x4_t v_sh = vdupq_n_s32(-sh);
+        const int32x4_t v_hi = vdupq_n_s32(32767);
+        const int32x4_t v_lo = vdupq_n_s32(-32768);
+        for (; i + 3 < n; i += 4)
+        {
+            int32x4_t v = vrshlq_s32(vld1q_s32(&src[i]), v_sh);
+            v = vminq_s32(vmaxq_s32(v, v_lo), v_hi);
+            vstrhq_s32(&dst[i], v);
+        }
+    }
+#endif
+    for (; i < n; i++)
+    {
+        int32_t v;
+        if (sh > 0)
+        {
+            /* Round half up without overflowing near INT32_MAX. */
+            v = ((src[i] >> (sh - 1)) + 1) >> 1;
+        }
+        else
+        {
+            v = (int32_t)((uint32_t)src[i] << -sh);
+        }
+        if (v > 32767)
+        {
+            v = 32767;
+        }
+        dst[i] = (q15_t)v;
+    }
+    return sh;
+}
+
+void fft_bfp16_rows_hyperram(uint32_t plane_offset, int rows, int cols,
+                             const int8_t *exp_in, int8_t *exp_out, bool is_inverse)
+{
+    static FFT_ALIGN16 q15_t row16[2 * MAX_FFT_SIZE];
+
+    const arm_cfft_instance_q31 *S = fft_get_cfft_instance_q31(cols);
+    if (!S || (rows <= 0))
+    {
+        xprintf("[FFT-BFP] ERROR: unsupported size %dx%d\n", rows, cols);
+        return;
+    }
+
+    const int log2n = fft_log2_pow2_u32((uint32_t)cols);
+    const uint32_t row_bytes = (uint32_t)cols * 2U * (uint32_t)sizeof(q15_t);
+
+    for (int r = 0; r < rows; r++)
+    {
+        const int e_in = exp_in ? (int)exp_in[r] : 0;
+        if (e_in == FFT_BFP_EXP_ZERO)
+        {
+            exp_out[r] = FFT_BFP_EXP_ZERO;
+            continue;
+        }
+
+        const uint32_t row_off = plane_offset + (uint32_t)r * row_bytes;
+        hyperram_b_read(row16, (void *)row_off, row_bytes);
+
+        const uint32_t m = fft_bfp_maxabs_q15(row16, 2 * cols);
+        if (m == 0U)
+        {
+            exp_out[r] = FFT_BFP_EXP_ZERO;
+            continue;
+        }
+
+        const int ls = FFT_BFP_Q31_BITS - fft_bfp_bitlen_u32(m);
+        fft_bfp_q15_to_q31(row16, g_cfft_io_q31, 2 * cols, ls);
+        arm_cfft_q31(S, g_cfft_io_q31, is_inverse ? 1U : 0U, 1U);
+
+        const int sh = fft_bfp_q31_to_q15(g_cfft_io_q31, row16, 2 * cols);
+        exp_out[r] = (sh == FFT_BFP_EXP_ZERO) ? (int8_t)FFT_BFP_EXP_ZERO
+                                              : fft_bfp_clamp_exp(e_in - ls + (is_inverse ? 0 : log2n) + sh);
+
+        hyperram_b_write(row16, (void *)row_off, row_bytes);
+    }
+}
+
+/*
+ * 列パス共通部．HyperRAMからFFT_BFP_STRIP_W列ずつ短冊で読み，列FFTを実行．
+ * - col_exp != NULL: 結果をBFP int16で書き戻し，列ごとの指数を col_exp に返す．
+ * - col_exp == NULL: 結果の実部に gain を掛けて float 平面(out_f32_offset, 行ピッチ out_f32_stride 要素)へ書き出す．
+ */
+static void fft_bfp16_cols_core(uint32_t plane_offset, int rows, int cols,
+                                const int8_t *row_exp, int8_t *col_exp,
+                                uint32_t out_f32_offset, uint32_t out_f32_stride, float gain,
+                                bool is_inverse)
+{
+    enum
+    {
+        W = FFT_BFP_STRIP_W
+    };
+    static FFT_ALIGN16 q15_t strip[MAX_FFT_SIZE * 2 * W];
+    static FFT_ALIGN16 float strip_f32[MAX_FFT_SIZE * W];
+
+    const arm_cfft_instance_q31 *S = fft_get_cfft_instance_q31(rows);
+    if (!S || (cols <= 0))
+    {
+        xprintf("[FFT-BFP] ERROR: unsupported size %dx%d\n", rows, cols);
+        return;
+    }
+
+    const int log2n = fft_log2_pow2_u32((uint32_t)rows);
+    const uint32_t row_bytes = (uint32_t)cols * 2U * (uint32_t)sizeof(q15_t);
+
+    for (int x0 = 0; x0 < cols; x0 += W)
+    {
+        const int w = ((x0 + W) > cols) ? (cols - x0) : W;
+        const uint32_t chunk_bytes = (uint32_t)w * 2U * (uint32_t)sizeof(q15_t);
+
+        for (int r = 0; r < rows; r++)
+        {
+            if (row_exp[r] == FFT_BFP_EXP_ZERO)
+            {
+                memset(&strip[r * 2 * W], 0, chunk_bytes);
+                continue;
+            }
+            hyperram_b_read(&strip[r * 2 * W],
+                            (void *)(plane_offset + (uint32_t)r * row_bytes + (uint32_t)x0 * 2U * (uint32_t)sizeof(q15_t)),
+                            chunk_bytes);
+        }
+
+        for (int c = 0; c < w; c++)
+        {
+            /* Column block exponent: top bit of max(|v| * 2^row_exp) over all rows. */
+            int e_top = INT32_MIN;
+            for (int r = 0; r < rows; r++)
+            {
+                const q15_t re = strip[(r * W + c) * 2 + 0];
+                const q15_t im = strip[(r * W + c) * 2 + 1];
+                const uint32_t a_re = (re < 0) ? (uint32_t)(-(int32_t)re) : (uint32_t)re;
+                const uint32_t a_im = (im < 0) ? (uint32_t)(-(int32_t)im) : (uint32_t)im;
+                const uint32_t a = (a_re > a_im) ? a_re : a_im;
+                if (a != 0U)
+                {
+                    const int e = (int)row_exp[r] + fft_bfp_bitlen_u32(a);
+                    if (e > e_top)
+                    {
+                        e_top = e;
+                    }
+                }
+            }
+
+            if (e_top == INT32_MIN)
+            {
+                if (col_exp)
+                {
+                    col_exp[x0 + c] = FFT_BFP_EXP_ZERO;
+                }
+                else
+                {
+                    for (int r = 0; r < rows; r++)
+                    {
+                        strip_f32[r * W + c] = 0.0f;
+                    }
+                }
+                continue;
+            }
+
+            /* Align every row to e_top so the column max lands on FFT_BFP_Q31_BITS. */
+            for (int r = 0; r < rows; r++)
+            {
+                const int sh = FFT_BFP_Q31_BITS - e_top + (int)row_exp[r];
+                g_cfft_io_q31[2 * r + 0] = fft_bfp_shift_s32((int32_t)strip[(r * W + c) * 2 + 0], sh);
+                g_cfft_io_q31[2 * r + 1] = fft_bfp_shift_s32((int32_t)strip[(r * W + c) * 2 + 1], sh);
+            }
+
+            arm_cfft_q31(S, g_cfft_io_q31, is_inverse ? 1U : 0U, 1U);
+
+            const int e_fft = e_top - FFT_BFP_Q31_BITS + (is_inverse ? 0 : log2n);
+            if (col_exp)
+            {
+                static FFT_ALIGN16 q15_t col16[2 * MAX_FFT_SIZE];
+                const int sh = fft_bfp_q31_to_q15(g_cfft_io_q31, col16, 2 * rows);
+                col_exp[x0 + c] = (sh == FFT_BFP_EXP_ZERO) ? (int8_t)FFT_BFP_EXP_ZERO
+                                                           : fft_bfp_clamp_exp(e_fft + sh);
+                for (int r = 0; r < rows; r++)
+                {
+                    strip[(r * W + c) * 2 + 0] = col16[2 * r + 0];
+                    strip[(r * W + c) * 2 + 1] = col16[2 * r + 1];
+                }
+            }
+            else
+            {
+                const float scale = gain * ldexpf(1.0f, e_fft);
+                for (int r = 0; r < rows; r++)
+                {
+                    strip_f32[r * W + c] = (float)g_cfft_io_q31[2 * r] * scale;
+                }
+            }
+        }
+
+        for (int r = 0; r < rows; r++)
+        {
+            if (col_exp)
+            {
+                hyperram_b_write(&strip[r * 2 * W],
+                                 (void *)(plane_offset + (uint32_t)r * row_bytes + (uint32_t)x0 * 2U * (uint32_t)sizeof(q15_t)),
+                                 chunk_bytes);
+            }
+            else
+            {
+                hyperram_b_write(&strip_f32[r * W],
+                                 (void *)(out_f32_offset + ((uint32_t)r * out_f32_stride + (uint32_t)x0) * (uint32_t)sizeof(float)),
+                                 (uint32_t)w * (uint32_t)sizeof(float));
+            }
+        }
+    }
+}
+
+void fft_bfp16_cols_hyperram(uint32_t plane_offset, int rows, int cols,
+                             const int8_t *row_exp, int8_t *col_exp, bool is_inverse)
+{
+    fft_bfp16_cols_core(plane_offset, rows, cols, row_exp, col_exp, 0U, 0U, 0.0f, is_inverse);
+}
+
+void fft_bfp16_cols_to_real_f32_hyperram(uint32_t plane_offset, int rows, int cols,
+                                         const int8_t *row_exp,
+                                         uint32_t out_f32_offset, uint32_t out_f32_stride, float gain,
+                                         bool is_inverse)
+{
+    fft_bfp16_cols_core(plane_offset, rows, cols, row_exp, NULL, out_f32_offset, out_f32_stride, gain, is_inverse);
+}
+
 /* 行列表示(デバッグ用) */
 void fft_print_matrix(const char *label, float *data, int rows, int cols, int max_display)
 {
@@ -1588,6 +2048,14 @@ void fft_print_matrix(const char *label, float *data, int rows, int cols, int ma
     }
 }
 
+/* テスト用：正方2Dプラン(1D プランはキャッシュ済みなので毎回 init しても軽い) */
+static const fft_plan2d_t *fft_test_plan2d(int n, bool is_inverse)
+{
+    static fft_plan2d_t s_plan[2];
+    fft_plan2d_t *p = &s_plan[is_inverse ? 1 : 0];
+    return fft_plan2d_init(p, n, n, is_inverse) ? p : NULL;
+}
+
 /* RMSE計算(精度評価) */
 float fft_calculate_rmse(float *data1, float *data2, int size)
 {
@@ -1635,7 +2103,7 @@ void fft_test_impulse(void)
 
     // 2D FFT
     uint32_t start = xTaskGetTickCount();
-    fft_2d(real, imag, FFT_TEST_SIZE, FFT_TEST_SIZE, false);
+    fft_2d(fft_test_plan2d(FFT_TEST_SIZE, false), real, imag);
     uint32_t end = xTaskGetTickCount();
 
     xprintf("[FFT] Forward FFT completed in %u ms\n", end - start);
@@ -1675,7 +2143,7 @@ void fft_test_sine_wave(void)
 
     // 2D FFT
     uint32_t start = xTaskGetTickCount();
-    fft_2d(real, imag, FFT_TEST_SIZE, FFT_TEST_SIZE, false);
+    fft_2d(fft_test_plan2d(FFT_TEST_SIZE, false), real, imag);
     uint32_t end = xTaskGetTickCount();
 
     xprintf("[FFT] Forward FFT completed in %u ms\n", end - start);
@@ -1727,13 +2195,13 @@ void fft_test_round_trip(void)
 
     // Forward FFT
     uint32_t start = xTaskGetTickCount();
-    fft_2d(real, imag, FFT_TEST_SIZE, FFT_TEST_SIZE, false);
+    fft_2d(fft_test_plan2d(FFT_TEST_SIZE, false), real, imag);
     uint32_t mid = xTaskGetTickCount();
 
     xprintf("[FFT] Forward FFT completed in %u ms\n", mid - start);
 
     // Inverse FFT
-    fft_2d(real, imag, FFT_TEST_SIZE, FFT_TEST_SIZE, true);
+    fft_2d(fft_test_plan2d(FFT_TEST_SIZE, true), real, imag);
     uint32_t end = xTaskGetTickCount();
 
     xprintf("[FFT] Inverse FFT completed in %u ms\n", end - mid);
@@ -1819,21 +2287,21 @@ void fft_test_hyperram_round_trip(void)
         // Forward FFT(HyperRAM経由，転置方式)
         uint32_t start = xTaskGetTickCount();
         fft_2d_hyperram(
+            fft_test_plan2d(FFT_TEST_SIZE, false),
             FFT_REAL_OFFSET,
             FFT_IMAG_OFFSET,
             FFT_REAL_OFFSET, // in-place変換
-            FFT_IMAG_OFFSET,
-            FFT_TEST_SIZE, FFT_TEST_SIZE, false);
+            FFT_IMAG_OFFSET);
         uint32_t mid = xTaskGetTickCount();
         forward_times[iter] = mid - start;
 
         // Inverse FFT(HyperRAM経由，転置方式)
         fft_2d_hyperram(
+            fft_test_plan2d(FFT_TEST_SIZE, true),
             FFT_REAL_OFFSET,
             FFT_IMAG_OFFSET,
             FFT_REAL_OFFSET,
-            FFT_IMAG_OFFSET,
-            FFT_TEST_SIZE, FFT_TEST_SIZE, true);
+            FFT_IMAG_OFFSET);
         uint32_t end = xTaskGetTickCount();
         inverse_times[iter] = end - mid;
 
@@ -1841,8 +2309,8 @@ void fft_test_hyperram_round_trip(void)
         hyperram_b_read(output_real, (void *)FFT_REAL_OFFSET, FFT_TEST_POINTS * sizeof(float));
         rmse_values[iter] = fft_calculate_rmse(output_real, input_real, FFT_TEST_POINTS);
 
-        xprintf("  Forward: %d ms, \nInverse: %d ms, RMSE: %.6f\n",
-                forward_times[iter], inverse_times[iter], rmse_values[iter]);
+        BINLOG3("  Forward: %d ms, Inverse: %d ms, RMSE: %.6f\n",
+                forward_times[iter], inverse_times[iter], BINLOG_F(rmse_values[iter]));
     }
 
     // 統計計算
@@ -2158,15 +2626,15 @@ void fft_test_hyperram_128x128(void)
 
 #if defined(APP_MODE_FFT_VERIFY_USE_FFT128_FULL) && (APP_MODE_FFT_VERIFY_USE_FFT128_FULL != 0)
         // FULL版(真の128x128スペクトル)
-        fft_2d_hyperram_full(INPUT_REAL_OFFSET, INPUT_IMAG_OFFSET,
+        fft_2d_hyperram_full(fft_test_plan2d(FFT_SIZE, false),
+                             INPUT_REAL_OFFSET, INPUT_IMAG_OFFSET,
                              OUTPUT_REAL_OFFSET, OUTPUT_IMAG_OFFSET,
-                             TMP_REAL_OFFSET, TMP_IMAG_OFFSET,
-                             FFT_SIZE, FFT_SIZE, false);
+                             TMP_REAL_OFFSET, TMP_IMAG_OFFSET);
 #else
         // ブロック処理版FFT
-        fft_2d_hyperram_blocked(INPUT_REAL_OFFSET, INPUT_IMAG_OFFSET,
-                                OUTPUT_REAL_OFFSET, OUTPUT_IMAG_OFFSET,
-                                FFT_SIZE, FFT_SIZE, false);
+        fft_2d_hyperram_blocked(fft_test_plan2d(FFT_SIZE, false),
+                                INPUT_REAL_OFFSET, INPUT_IMAG_OFFSET,
+                                OUTPUT_REAL_OFFSET, OUTPUT_IMAG_OFFSET);
 #endif
 
         uint32_t tf_us = fft_cycles_to_us((uint32_t)(fft_cycles_now() - t0));
@@ -2210,14 +2678,14 @@ void fft_test_hyperram_128x128(void)
         t0 = fft_cycles_now();
 
 #if defined(APP_MODE_FFT_VERIFY_USE_FFT128_FULL) && (APP_MODE_FFT_VERIFY_USE_FFT128_FULL != 0)
-        fft_2d_hyperram_full(OUTPUT_REAL_OFFSET, OUTPUT_IMAG_OFFSET,
+        fft_2d_hyperram_full(fft_test_plan2d(FFT_SIZE, true),
+                             OUTPUT_REAL_OFFSET, OUTPUT_IMAG_OFFSET,
                              WORK_REAL_OFFSET, WORK_IMAG_OFFSET,
-                             TMP_REAL_OFFSET, TMP_IMAG_OFFSET,
-                             FFT_SIZE, FFT_SIZE, true);
+                             TMP_REAL_OFFSET, TMP_IMAG_OFFSET);
 #else
-        fft_2d_hyperram_blocked(OUTPUT_REAL_OFFSET, OUTPUT_IMAG_OFFSET,
-                                WORK_REAL_OFFSET, WORK_IMAG_OFFSET,
-                                FFT_SIZE, FFT_SIZE, true);
+        fft_2d_hyperram_blocked(fft_test_plan2d(FFT_SIZE, true),
+                                OUTPUT_REAL_OFFSET, OUTPUT_IMAG_OFFSET,
+                                WORK_REAL_OFFSET, WORK_IMAG_OFFSET);
 #endif
 
         uint32_t ti_us = fft_cycles_to_us((uint32_t)(fft_cycles_now() - t0));
@@ -2617,10 +3085,10 @@ void fft_test_hyperram_256x256(void)
 
         fft_timing_init_once();
         uint32_t t0 = fft_cycles_now();
-        fft_2d_hyperram_full(INPUT_REAL_OFFSET, INPUT_IMAG_OFFSET,
+        fft_2d_hyperram_full(fft_test_plan2d(FFT_SIZE, false),
+                             INPUT_REAL_OFFSET, INPUT_IMAG_OFFSET,
                              OUTPUT_REAL_OFFSET, OUTPUT_IMAG_OFFSET,
-                             TMP_REAL_OFFSET, TMP_IMAG_OFFSET,
-                             FFT_SIZE, FFT_SIZE, false);
+                             TMP_REAL_OFFSET, TMP_IMAG_OFFSET);
         uint32_t tf_cycles = (uint32_t)(fft_cycles_now() - t0);
         uint32_t tf_us = fft_cycles_to_us(tf_cycles);
         FFT_LOG("[FFT-256] Forward FFT complete (%d us)\n", (unsigned long)tf_us);
@@ -2662,10 +3130,10 @@ void fft_test_hyperram_256x256(void)
 
         FFT_VLOG("[FFT-256] Starting inverse FFT...\n");
         t0 = fft_cycles_now();
-        fft_2d_hyperram_full(OUTPUT_REAL_OFFSET, OUTPUT_IMAG_OFFSET,
+        fft_2d_hyperram_full(fft_test_plan2d(FFT_SIZE, true),
+                             OUTPUT_REAL_OFFSET, OUTPUT_IMAG_OFFSET,
                              WORK_REAL_OFFSET, WORK_IMAG_OFFSET,
-                             TMP_REAL_OFFSET, TMP_IMAG_OFFSET,
-                             FFT_SIZE, FFT_SIZE, true);
+                             TMP_REAL_OFFSET, TMP_IMAG_OFFSET);
         uint32_t ti_cycles = (uint32_t)(fft_cycles_now() - t0);
         uint32_t ti_us = fft_cycles_to_us(ti_cycles);
         FFT_LOG("[FFT-256] Inverse FFT complete (%d us)\n", (unsigned long)ti_us);
@@ -30,27 +30,70 @@ void fft_test_hyperram_round_trip(void); // HyperRAMベースFFT→IFFT往復テ
 void fft_test_hyperram_128x128(void);    // 128×128大規模FFT→IFFTテスト(ブロック処理)
 void fft_test_hyperram_256x256(void);    // 256×256大規模FFT→IFFTテスト(FULL版)
 
-/* 1D FFT/IFFT (MVE最適化版) */
+/*
+ * FFT プラン
+ * - サイズ×方向ごとに1回だけ作成し，以後はキャッシュを返す(fft_plan_get)．
+ * - twiddle / bit-reversal 表は SRAM に事前計算．カーネルは作成時に選択:
+ *   CMSIS f32 CFFT(radix-8/4/2 混合)，N=256 で f16 有効時は CMSIS f16，
+ *   それ以外は radix-2(MVE)．
+ * - 作成は初回のみ非スレッドセーフ(起動時に1タスクから作成すること)．
+ */
+#define FFT_PLAN_MAX_N (256)
+
+typedef enum
+{
+    FFT_KERNEL_NONE = 0,
+    FFT_KERNEL_RADIX2,
+    FFT_KERNEL_CMSIS_F32,
+    FFT_KERNEL_CMSIS_F16,
+} fft_kernel_t;
+
+typedef struct
+{
+    int N;
+    int log2n;
+    bool is_inverse;
+    fft_kernel_t kernel;
+    const float *tw_real;    // radix-2 用 twiddle(段ごとに連結)
+    const float *tw_imag;
+    const uint16_t *bitrev;  // radix-2 用 bit-reversal 表(N要素)
+    const void *cfft;        // CMSIS インスタンス
+} fft_plan_t;
+
+/* 2D プラン：行FFT(cols点)と列FFT(rows点) */
+typedef struct
+{
+    const fft_plan_t *row;
+    const fft_plan_t *col;
+} fft_plan2d_t;
+
+const fft_plan_t *fft_plan_get(int N, bool is_inverse); // 非対応サイズは NULL
+bool fft_plan2d_init(fft_plan2d_t *plan, int rows, int cols, bool is_inverse);
+void fft_plan_execute(const fft_plan_t *plan, float *real, float *imag);
+/* count 本の連続した行(先頭間隔 stride 要素)を一括変換 */
+void fft_plan_execute_batch(const fft_plan_t *plan, float *real, float *imag, int count, int stride);
+
+/* 1D FFT/IFFT (互換ラッパ：fft_plan_get + fft_plan_execute) */
 void fft_1d_mve(float *real, float *imag, int N, bool is_inverse);
 
-/* 2D FFT/IFFT */
-void fft_2d(float *real, float *imag, int rows, int cols, bool is_inverse);
+/* 2D FFT/IFFT(rows/cols/方向はプランから取得) */
+void fft_2d(const fft_plan2d_t *plan, float *real, float *imag);
 
 /* HyperRAMベース2D FFT/IFFT(メモリ効率版) */
 void fft_2d_hyperram(
+    const fft_plan2d_t *plan,
     uint32_t hyperram_input_real_offset,
     uint32_t hyperram_input_imag_offset,
     uint32_t hyperram_output_real_offset,
-    uint32_t hyperram_output_imag_offset,
-    int rows, int cols, bool is_inverse);
+    uint32_t hyperram_output_imag_offset);
 
 /* HyperRAMベース2D FFT/IFFT(32x32ブロック処理：128x128で実績あり) */
 void fft_2d_hyperram_blocked(
+    const fft_plan2d_t *plan,
     uint32_t hyperram_input_real_offset,
     uint32_t hyperram_input_imag_offset,
     uint32_t hyperram_output_real_offset,
-    uint32_t hyperram_output_imag_offset,
-    int rows, int cols, bool is_inverse);
+    uint32_t hyperram_output_imag_offset);
 
 /*
  * HyperRAMベース「真の」2D FFT/IFFT(rows点×cols点)．
@@ -59,29 +102,50 @@ void fft_2d_hyperram_blocked(
  *   例: 128x128なら tmp_real/tmp_imag それぞれ64KB．
  */
 void fft_2d_hyperram_full(
+    const fft_plan2d_t *plan,
     uint32_t hyperram_input_real_offset,
     uint32_t hyperram_input_imag_offset,
     uint32_t hyperram_output_real_offset,
     uint32_t hyperram_output_imag_offset,
     uint32_t hyperram_tmp_real_offset,
-    uint32_t hyperram_tmp_imag_offset,
-    int rows, int cols, bool is_inverse);
+    uint32_t hyperram_tmp_imag_offset);
 
 /* デバッグ用：ROW処理のみ */
 void fft_2d_hyperram_row_only(
+    const fft_plan2d_t *plan,
     uint32_t hyperram_input_real_offset,
     uint32_t hyperram_input_imag_offset,
     uint32_t hyperram_output_real_offset,
-    uint32_t hyperram_output_imag_offset,
-    int rows, int cols, bool is_inverse);
+    uint32_t hyperram_output_imag_offset);
 
 /* デバッグ用：COL処理のみ */
 void fft_2d_hyperram_col_only(
+    const fft_plan2d_t *plan,
     uint32_t hyperram_input_real_offset,
     uint32_t hyperram_input_imag_offset,
     uint32_t hyperram_output_real_offset,
-    uint32_t hyperram_output_imag_offset,
-    int rows, int cols, bool is_inverse);
+    uint32_t hyperram_output_imag_offset);
+
+/*
+ * ブロック浮動小数点(BFP)固定小数点2D FFT(arm_cfft_q31)．
+ * - 平面は int16 複素数(re,im インターリーブ)．値 = v * 2^exp．
+ * - 行パスは行ごと，列パスは列ごとに指数を持つ．全0の行/列は FFT_BFP_EXP_ZERO．
+ * - 2D FFT = rows(exp_in=NULL は全行 exp=0) → cols．逆変換も同様で，
+ *   最後の列パスを *_to_real_f32 にすると実部を float 平面で受け取れる．
+ * - 対応サイズは 128/256(CMSIS q31 CFFT)．
+ */
+#define FFT_BFP_EXP_ZERO (-128)
+
+void fft_bfp16_rows_hyperram(uint32_t plane_offset, int rows, int cols,
+                             const int8_t *exp_in, int8_t *exp_out, bool is_inverse);
+
+void fft_bfp16_cols_hyperram(uint32_t plane_offset, int rows, int cols,
+                             const int8_t *row_exp, int8_t *col_exp, bool is_inverse);
+
+void fft_bfp16_cols_to_real_f32_hyperram(uint32_t plane_offset, int rows, int cols,
+                                         const int8_t *row_exp,
+                                         uint32_t out_f32_offset, uint32_t out_f32_stride, float gain,
+                                         bool is_inverse);
 
 /* ユーティリティ */
 void fft_print_matrix(const char *label, float *data, int rows, int cols, int max_display);
@@ -16,10 +16,6 @@
 #define HLAC_MVE_PAIR_COUNT (20)
 #endif
 
-#ifndef HLAC_MAX_IMAGE_W
-#define HLAC_MAX_IMAGE_W (320U)
-#endif
-
 /* Offsets order must match matlab/extract_hlac_features.m:
  * 1: (-1,-1) 2: (-1,0) 3: (-1,1) 4: (0,-1) 5: (0,1) 6:(1,-1) 7:(1,0) 8:(1,1)
  */
@@ -287,84 +283,78 @@ static inline uint64_t hlac_sumprod_u8_u8_mve(const uint8_t *a, const uint8_t *b
 }
 #endif
 
-void hlac25_compute_from_u8_hyperram(uint32_t img_addr, uint32_t width, uint32_t height, float out25[25])
-{
-    if (!out25 || width == 0U || height == 0U || width > HLAC_MAX_IMAGE_W)
-    {
-        return;
-    }
-
-    hlac25_init_pairs_once();
-
-    memset(out25, 0, 25U * sizeof(float));
-
-    const float inv255 = 1.0f / 255.0f;
-    const float inv255_2 = inv255 * inv255;
-    const float inv255_3 = inv255_2 * inv255;
+/* All-zero row used as the out-of-image neighbour (top/bottom padding). */
+static const uint8_t s_zero_row[HLAC_MAX_IMAGE_W] = {0};
 
-    uint8_t prev[HLAC_MAX_IMAGE_W];
-    uint8_t cur[HLAC_MAX_IMAGE_W];
-    uint8_t next[HLAC_MAX_IMAGE_W];
-
-    memset(prev, 0, width);
-    memset(cur, 0, width);
-    memset(next, 0, width);
+static inline void hlac25_acc_clear(hlac25_acc_t *acc)
+{
+    memset(acc, 0, sizeof(*acc));
+}
 
-    /* Preload cur (y=0) and next (y=1). */
-    (void)hyperram_b_read(cur, (void *)(img_addr + 0U), width);
-    if (height > 1U)
+/* Accumulate one image row (cur) given its vertical neighbours (prev/next).
+ * Pixels outside [0, width) are treated as zero, so passing a sub-slice of a
+ * wider row computes the row as if it were an independent ROI.
+ */
+static void hlac25_accumulate_row(hlac25_acc_t *acc,
+                                  const uint8_t *prev,
+                                  const uint8_t *cur,
+                                  const uint8_t *next,
+                                  uint32_t width)
+{
+    /* 0th/1st order terms: accumulate in integer domain (faster; avoid float in inner loop). */
+#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE > 0)
+    acc->acc0_center += hlac_sum_u8_mve(cur, width);
+    acc->acc1_down += hlac_sumprod_u8_u8_mve(cur, next, width);
+    if (width > 1U)
     {
-        (void)hyperram_b_read(next, (void *)(img_addr + width), width);
+        acc->acc1_right += hlac_sumprod_u8_u8_mve(cur, &cur[1], width - 1U);
+        acc->acc1_rd += hlac_sumprod_u8_u8_mve(cur, &next[1], width - 1U);
+        acc->acc1_ru += hlac_sumprod_u8_u8_mve(cur, &prev[1], width - 1U);
     }
-
-    const uint32_t count = width * height;
-
-    uint32_t acc0_center = 0U;
-    uint64_t acc1_right = 0ULL;
-    uint64_t acc1_down = 0ULL;
-    uint64_t acc1_rd = 0ULL;
-    uint64_t acc1_ru = 0ULL;
-    uint64_t acc2[20];
-    memset(acc2, 0, sizeof(acc2));
-
-    int8_t pair_i_all[20];
-    int8_t pair_j_all[20];
-    for (int p = 0; p < 20; p++)
+#else
+    acc->acc0_center += hlac_sum_u8_scalar(cur, width);
+    acc->acc1_down += hlac_sumprod_u8_u8_scalar(cur, next, width);
+    if (width > 1U)
     {
-        pair_i_all[p] = s_pair_idx[p][0];
-        pair_j_all[p] = s_pair_idx[p][1];
+        acc->acc1_right += hlac_sumprod_u8_u8_scalar(cur, &cur[1], width - 1U);
+        acc->acc1_rd += hlac_sumprod_u8_u8_scalar(cur, &next[1], width - 1U);
+        acc->acc1_ru += hlac_sumprod_u8_u8_scalar(cur, &prev[1], width - 1U);
     }
+#endif
 
-    for (uint32_t y = 0; y < height; y++)
+    uint64_t *acc2 = acc->acc2;
+
+    /* 2nd order terms: compute in integer domain (center*ni*nj) then scale once at the end. */
+    if (width == 1U)
     {
-        /* 0th/1st order terms: accumulate in integer domain (faster; avoid float in inner loop). */
-#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE > 0)
-        acc0_center += hlac_sum_u8_mve(cur, width);
-        acc1_down += hlac_sumprod_u8_u8_mve(cur, next, width);
-        if (width > 1U)
-        {
-            acc1_right += hlac_sumprod_u8_u8_mve(cur, &cur[1], width - 1U);
-            acc1_rd += hlac_sumprod_u8_u8_mve(cur, &next[1], width - 1U);
-            acc1_ru += hlac_sumprod_u8_u8_mve(cur, &prev[1], width - 1U);
-        }
-#else
-        acc0_center += hlac_sum_u8_scalar(cur, width);
-        acc1_down += hlac_sumprod_u8_u8_scalar(cur, next, width);
-        if (width > 1U)
+        uint8_t neigh_u8[8] = {0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U};
+        neigh_u8[1] = prev[0];
+        neigh_u8[6] = next[0];
+        uint64_t c = (uint64_t)cur[0];
+        for (int p = 0; p < 20; p++)
         {
-            acc1_right += hlac_sumprod_u8_u8_scalar(cur, &cur[1], width - 1U);
-            acc1_rd += hlac_sumprod_u8_u8_scalar(cur, &next[1], width - 1U);
-            acc1_ru += hlac_sumprod_u8_u8_scalar(cur, &prev[1], width - 1U);
+            int i = (int)s_pair_idx[p][0];
+            int j = (int)s_pair_idx[p][1];
+            acc2[p] += c * (uint64_t)neigh_u8[i] * (uint64_t)neigh_u8[j];
         }
-#endif
+        return;
+    }
 
-        /* 2nd order terms: compute in integer domain (center*ni*nj) then scale once at the end. */
-        if (width == 1U)
+    if (width == 2U)
+    {
+        for (uint32_t x = 0; x < 2U; x++)
         {
-            uint8_t neigh_u8[8] = {0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U};
-            neigh_u8[1] = prev[0];
-            neigh_u8[6] = next[0];
-            uint64_t c = (uint64_t)cur[0];
+            uint8_t neigh_u8[8];
+            neigh_u8[0] = (x == 0U) ? 0U : prev[x - 1U];
+            neigh_u8[1] = prev[x];
+            neigh_u8[2] = (x + 1U >= width) ? 0U : prev[x + 1U];
+            neigh_u8[3] = (x == 0U) ? 0U : cur[x - 1U];
+            neigh_u8[4] = (x + 1U >= width) ? 0U : cur[x + 1U];
+            neigh_u8[5] = (x == 0U) ? 0U : next[x - 1U];
+            neigh_u8[6] = next[x];
+            neigh_u8[7] = (x + 1U >= width) ? 0U : next[x + 1U];
+
+            uint64_t c = (uint64_t)cur[x];
             for (int p = 0; p < 20; p++)
             {
                 int i = (int)s_pair_idx[p][0];
@@ -372,193 +362,176 @@ void hlac25_compute_from_u8_hyperram(uint32_t img_addr, uint32_t width, uint32_t
                 acc2[p] += c * (uint64_t)neigh_u8[i] * (uint64_t)neigh_u8[j];
             }
         }
-        else if (width == 2U)
+        return;
+    }
+
+    /* x = 0 (left edge) */
+    {
+        uint8_t neigh_u8[8];
+        neigh_u8[0] = 0U;
+        neigh_u8[1] = prev[0];
+        neigh_u8[2] = prev[1];
+        neigh_u8[3] = 0U;
+        neigh_u8[4] = cur[1];
+        neigh_u8[5] = 0U;
+        neigh_u8[6] = next[0];
+        neigh_u8[7] = next[1];
+        uint64_t c = (uint64_t)cur[0];
+        for (int p = 0; p < 20; p++)
         {
-            for (uint32_t x = 0; x < 2U; x++)
-            {
-                uint8_t neigh_u8[8];
-                neigh_u8[0] = (x == 0U) ? 0U : prev[x - 1U];
-                neigh_u8[1] = prev[x];
-                neigh_u8[2] = (x + 1U >= width) ? 0U : prev[x + 1U];
-                neigh_u8[3] = (x == 0U) ? 0U : cur[x - 1U];
-                neigh_u8[4] = (x + 1U >= width) ? 0U : cur[x + 1U];
-                neigh_u8[5] = (x == 0U) ? 0U : next[x - 1U];
-                neigh_u8[6] = next[x];
-                neigh_u8[7] = (x + 1U >= width) ? 0U : next[x + 1U];
-
-                uint64_t c = (uint64_t)cur[x];
-                for (int p = 0; p < 20; p++)
-                {
-                    int i = (int)s_pair_idx[p][0];
-                    int j = (int)s_pair_idx[p][1];
-                    acc2[p] += c * (uint64_t)neigh_u8[i] * (uint64_t)neigh_u8[j];
-                }
-            }
+            int i = (int)s_pair_idx[p][0];
+            int j = (int)s_pair_idx[p][1];
+            acc2[p] += c * (uint64_t)neigh_u8[i] * (uint64_t)neigh_u8[j];
         }
-        else
-        {
-            /* x = 0 (left edge) */
-            {
-                uint8_t neigh_u8[8];
-                neigh_u8[0] = 0U;
-                neigh_u8[1] = prev[0];
-                neigh_u8[2] = prev[1];
-                neigh_u8[3] = 0U;
-                neigh_u8[4] = cur[1];
-                neigh_u8[5] = 0U;
-                neigh_u8[6] = next[0];
-                neigh_u8[7] = next[1];
-                uint64_t c = (uint64_t)cur[0];
-                for (int p = 0; p < 20; p++)
-                {
-                    int i = (int)s_pair_idx[p][0];
-                    int j = (int)s_pair_idx[p][1];
-                    acc2[p] += c * (uint64_t)neigh_u8[i] * (uint64_t)neigh_u8[j];
-                }
-            }
+    }
 
-            uint32_t vec_end = 1U;
+    uint32_t vec_end = 1U;
 #if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE > 0)
-            /* MVE block path for 2nd-order pairs over the inner region. */
-            if (width >= 3U)
-            {
-                const uint32_t inner_start = 1U;
-                const uint32_t inner_end_inclusive = width - 2U;
-                const uint32_t inner_len = inner_end_inclusive - inner_start + 1U;
-                const uint32_t blocks = inner_len / 16U;
-                vec_end = inner_start + blocks * 16U;
+    /* MVE block path for 2nd-order pairs over the inner region. */
+    {
+        const uint32_t inner_start = 1U;
+        const uint32_t inner_end_inclusive = width - 2U;
+        const uint32_t inner_len = inner_end_inclusive - inner_start + 1U;
+        const uint32_t blocks = inner_len / 16U;
+        vec_end = inner_start + blocks * 16U;
 
-                for (uint32_t x = inner_start; x < vec_end; x += 16U)
-                {
-                    const uint8x16_t vc = vld1q_u8(&cur[x]);
-                    const uint8x16_t n0 = vld1q_u8(&prev[x - 1U]);
-                    const uint8x16_t n1 = vld1q_u8(&prev[x]);
-                    const uint8x16_t n2 = vld1q_u8(&prev[x + 1U]);
-                    const uint8x16_t n3 = vld1q_u8(&cur[x - 1U]);
-                    const uint8x16_t n4 = vld1q_u8(&cur[x + 1U]);
-                    const uint8x16_t n5 = vld1q_u8(&next[x - 1U]);
-                    const uint8x16_t n6 = vld1q_u8(&next[x]);
-                    const uint8x16_t n7 = vld1q_u8(&next[x + 1U]);
-
-                    const uint8x16_t neighv[8] = {n0, n1, n2, n3, n4, n5, n6, n7};
-
-                    /* Precompute u16 neighbors and (center*neighbor) for reuse across all pairs. */
-                    const uint16x8_t c_lo = vmovlbq_u8(vc);
-                    const uint16x8_t c_hi = vmovltq_u8(vc);
-                    uint16x8_t n_lo16[8];
-                    uint16x8_t n_hi16[8];
-                    uint16x8_t ca_lo16[8];
-                    uint16x8_t ca_hi16[8];
-                    for (int k = 0; k < 8; k++)
-                    {
-                        n_lo16[k] = vmovlbq_u8(neighv[k]);
-                        n_hi16[k] = vmovltq_u8(neighv[k]);
-                        ca_lo16[k] = vmulq_u16(c_lo, n_lo16[k]);
-                        ca_hi16[k] = vmulq_u16(c_hi, n_hi16[k]);
-                    }
-
-                    int p_max = HLAC_MVE_PAIR_COUNT;
-                    if (p_max > 20)
-                    {
-                        p_max = 20;
-                    }
-                    for (int p = 0; p < p_max; p++)
-                    {
-                        const int ii = (int)pair_i_all[p];
-                        const int jj = (int)pair_j_all[p];
-                        /* acc2 += (center*neigh[ii]) * neigh[jj] */
-                        acc2[p] += hlac_sumprod_u16_u16_to_u64(ca_lo16[ii & 7], ca_hi16[ii & 7], n_lo16[jj & 7], n_hi16[jj & 7]);
-                    }
-                }
+        for (uint32_t x = inner_start; x < vec_end; x += 16U)
+        {
+            const uint8x16_t vc = vld1q_u8(&cur[x]);
+            const uint8x16_t n0 = vld1q_u8(&prev[x - 1U]);
+            const uint8x16_t n1 = vld1q_u8(&prev[x]);
+            const uint8x16_t n2 = vld1q_u8(&prev[x + 1U]);
+            const uint8x16_t n3 = vld1q_u8(&cur[x - 1U]);
+            const uint8x16_t n4 = vld1q_u8(&cur[x + 1U]);
+            const uint8x16_t n5 = vld1q_u8(&next[x - 1U]);
+            const uint8x16_t n6 = vld1q_u8(&next[x]);
+            const uint8x16_t n7 = vld1q_u8(&next[x + 1U]);
+
+            const uint8x16_t neighv[8] = {n0, n1, n2, n3, n4, n5, n6, n7};
+
+            /* Precompute u16 neighbors and (center*neighbor) for reuse across all pairs. */
+            const uint16x8_t c_lo = vmovlbq_u8(vc);
+            const uint16x8_t c_hi = vmovltq_u8(vc);
+            uint16x8_t n_lo16[8];
+            uint16x8_t n_hi16[8];
+            uint16x8_t ca_lo16[8];
+            uint16x8_t ca_hi16[8];
+            for (int k = 0; k < 8; k++)
+            {
+                n_lo16[k] = vmovlbq_u8(neighv[k]);
+                n_hi16[k] = vmovltq_u8(neighv[k]);
+                ca_lo16[k] = vmulq_u16(c_lo, n_lo16[k]);
+                ca_hi16[k] = vmulq_u16(c_hi, n_hi16[k]);
             }
-#endif
 
-            /* x = 1..width-2 (no bounds checks).
-             * If MVE covered some leading blocks, skip computing those pairs here to avoid double counting.
-             */
-            for (uint32_t x = 1U; x + 1U < width; x++)
+            int p_max = HLAC_MVE_PAIR_COUNT;
+            if (p_max > 20)
             {
-                uint8_t neigh_u8[8];
-                neigh_u8[0] = prev[x - 1U];
-                neigh_u8[1] = prev[x];
-                neigh_u8[2] = prev[x + 1U];
-                neigh_u8[3] = cur[x - 1U];
-                neigh_u8[4] = cur[x + 1U];
-                neigh_u8[5] = next[x - 1U];
-                neigh_u8[6] = next[x];
-                neigh_u8[7] = next[x + 1U];
-                uint64_t c = (uint64_t)cur[x];
-
-                int p_start = 0;
-#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE > 0)
-                if (x < vec_end)
-                {
-                    /* MVE already computed the first HLAC_MVE_PAIR_COUNT pairs for these pixels. */
-                    p_start = HLAC_MVE_PAIR_COUNT;
-                    if (p_start > 20)
-                    {
-                        p_start = 20;
-                    }
-                }
-#endif
-                for (int p = p_start; p < 20; p++)
-                {
-                    int i = (int)s_pair_idx[p][0];
-                    int j = (int)s_pair_idx[p][1];
-                    acc2[p] += c * (uint64_t)neigh_u8[i] * (uint64_t)neigh_u8[j];
-                }
+                p_max = 20;
             }
-
-            /* x = width-1 (right edge) */
+            for (int p = 0; p < p_max; p++)
             {
-                uint32_t x = width - 1U;
-                uint8_t neigh_u8[8];
-                neigh_u8[0] = prev[x - 1U];
-                neigh_u8[1] = prev[x];
-                neigh_u8[2] = 0U;
-                neigh_u8[3] = cur[x - 1U];
-                neigh_u8[4] = 0U;
-                neigh_u8[5] = next[x - 1U];
-                neigh_u8[6] = next[x];
-                neigh_u8[7] = 0U;
-                uint64_t c = (uint64_t)cur[x];
-                for (int p = 0; p < 20; p++)
-                {
-                    int i = (int)s_pair_idx[p][0];
-                    int j = (int)s_pair_idx[p][1];
-                    acc2[p] += c * (uint64_t)neigh_u8[i] * (uint64_t)neigh_u8[j];
-                }
+                const int ii = (int)s_pair_idx[p][0];
+                const int jj = (int)s_pair_idx[p][1];
+                /* acc2 += (center*neigh[ii]) * neigh[jj] */
+                acc2[p] += hlac_sumprod_u16_u16_to_u64(ca_lo16[ii & 7], ca_hi16[ii & 7], n_lo16[jj & 7], n_hi16[jj & 7]);
             }
         }
+    }
+#endif
 
-        /* Advance ring buffers. */
-        memcpy(prev, cur, width);
-        memcpy(cur, next, width);
-        if (y + 2U < height)
+    /* x = 1..width-2 (no bounds checks).
+     * If MVE covered some leading blocks, skip computing those pairs here to avoid double counting.
+     */
+    for (uint32_t x = 1U; x + 1U < width; x++)
+    {
+        uint8_t neigh_u8[8];
+        neigh_u8[0] = prev[x - 1U];
+        neigh_u8[1] = prev[x];
+        neigh_u8[2] = prev[x + 1U];
+        neigh_u8[3] = cur[x - 1U];
+        neigh_u8[4] = cur[x + 1U];
+        neigh_u8[5] = next[x - 1U];
+        neigh_u8[6] = next[x];
+        neigh_u8[7] = next[x + 1U];
+        uint64_t c = (uint64_t)cur[x];
+
+        int p_start = 0;
+        if (x < vec_end)
         {
-            (void)hyperram_b_read(next, (void *)(img_addr + (y + 2U) * width), width);
+            /* MVE already computed the first HLAC_MVE_PAIR_COUNT pairs for these pixels. */
+            p_start = HLAC_MVE_PAIR_COUNT;
+            if (p_start > 20)
+            {
+                p_start = 20;
+            }
         }
-        else
+        for (int p = p_start; p < 20; p++)
         {
-            memset(next, 0, width);
+            int i = (int)s_pair_idx[p][0];
+            int j = (int)s_pair_idx[p][1];
+            acc2[p] += c * (uint64_t)neigh_u8[i] * (uint64_t)neigh_u8[j];
         }
     }
 
-    if (count != 0U)
+    /* x = width-1 (right edge) */
     {
-        const float inv_count = 1.0f / (float)count;
-        out25[0] = (float)acc0_center * inv255 * inv_count;
-        out25[1] = (float)acc1_right * inv255_2 * inv_count;
-        out25[2] = (float)acc1_down * inv255_2 * inv_count;
-        out25[3] = (float)acc1_rd * inv255_2 * inv_count;
-        out25[4] = (float)acc1_ru * inv255_2 * inv_count;
+        uint32_t x = width - 1U;
+        uint8_t neigh_u8[8];
+        neigh_u8[0] = prev[x - 1U];
+        neigh_u8[1] = prev[x];
+        neigh_u8[2] = 0U;
+        neigh_u8[3] = cur[x - 1U];
+        neigh_u8[4] = 0U;
+        neigh_u8[5] = next[x - 1U];
+        neigh_u8[6] = next[x];
+        neigh_u8[7] = 0U;
+        uint64_t c = (uint64_t)cur[x];
         for (int p = 0; p < 20; p++)
         {
-            out25[5 + p] = (float)acc2[p] * inv255_3 * inv_count;
+            int i = (int)s_pair_idx[p][0];
+            int j = (int)s_pair_idx[p][1];
+            acc2[p] += c * (uint64_t)neigh_u8[i] * (uint64_t)neigh_u8[j];
         }
     }
 }
 
+/* Normalize integer accumulators to the MATLAB feature scale (mean over count pixels, [0,1] intensity). */
+static void hlac25_acc_to_features(const hlac25_acc_t *acc, uint32_t count, float out25[25])
+{
+    memset(out25, 0, 25U * sizeof(float));
+    if (count == 0U)
+    {
+        return;
+    }
+
+    const float inv255 = 1.0f / 255.0f;
+    const float inv255_2 = inv255 * inv255;
+    const float inv255_3 = inv255_2 * inv255;
+    const float inv_count = 1.0f / (float)count;
+
+    out25[0] = (float)acc->acc0_center * inv255 * inv_count;
+    out25[1] = (float)acc->acc1_right * inv255_2 * inv_count;
+    out25[2] = (float)acc->acc1_down * inv255_2 * inv_count;
+    out25[3] = (float)acc->acc1_rd * inv255_2 * inv_count;
+    out25[4] = (float)acc->acc1_ru * inv255_2 * inv_count;
+    for (int p = 0; p < 20; p++)
+    {
+        out25[5 + p] = (float)acc->acc2[p] * inv255_3 * inv_count;
+    }
+}
+
+void hlac25_compute_from_u8_hyperram(uint32_t img_addr, uint32_t width, uint32_t height, float out25[25])
+{
+    if (!out25 || width == 0U || height == 0U || width > HLAC_MAX_IMAGE_W)
+    {
+        return;
+    }
+
+    /* Full image == ROI covering the whole image. */
+    hlac25_compute_from_u8_hyperram_roi(img_addr, width, 0U, 0U, width, height, out25);
+}
+
 void hlac25_compute_from_u8_hyperram_roi(uint32_t img_addr, uint32_t img_stride,
                                          uint32_t x0, uint32_t y0,
                                          uint32_t block_w, uint32_t block_h,
@@ -567,8 +540,8 @@ void hlac25_compute_from_u8_hyperram_roi(uint32_t img_addr, uint32_t img_stride,
     /* ROI-based HLAC extraction: extract features from a rectangular block
      * within a larger image in HyperRAM.
      *
-     * Similar to hlac25_compute_from_u8_hyperram but loads only the specified
-     * rectangular region and computes HLAC over that sub-image.
+     * Loads only the specified rectangular region (one row at a time) and
+     * computes HLAC over that sub-image, with zero padding at the ROI border.
      */
 
     if (!out25 || block_w == 0U || block_h == 0U || block_w > HLAC_MAX_IMAGE_W)
@@ -577,116 +550,39 @@ void hlac25_compute_from_u8_hyperram_roi(uint32_t img_addr, uint32_t img_stride,
     }
 
     hlac25_init_pairs_once();
-    memset(out25, 0, 25U * sizeof(float));
 
-    const float inv255 = 1.0f / 255.0f;
-    const float inv255_2 = inv255 * inv255;
-    const float inv255_3 = inv255_2 * inv255;
-
-    uint8_t prev[HLAC_MAX_IMAGE_W];
-    uint8_t cur[HLAC_MAX_IMAGE_W];
-    uint8_t next[HLAC_MAX_IMAGE_W];
+    uint8_t buf0[HLAC_MAX_IMAGE_W];
+    uint8_t buf1[HLAC_MAX_IMAGE_W];
+    uint8_t buf2[HLAC_MAX_IMAGE_W];
+    uint8_t *prev = buf0;
+    uint8_t *cur = buf1;
+    uint8_t *next = buf2;
 
     memset(prev, 0, block_w);
-    memset(cur, 0, block_w);
     memset(next, 0, block_w);
 
     /* Preload cur (y=y0) and next (y=y0+1). */
-    uint32_t y_img = y0;
-    (void)hyperram_b_read(cur, (void *)(img_addr + y_img * img_stride + x0), block_w);
+    (void)hyperram_b_read(cur, (void *)(uintptr_t)(img_addr + y0 * img_stride + x0), block_w);
     if (block_h > 1U)
     {
-        y_img = y0 + 1U;
-        (void)hyperram_b_read(next, (void *)(img_addr + y_img * img_stride + x0), block_w);
+        (void)hyperram_b_read(next, (void *)(uintptr_t)(img_addr + (y0 + 1U) * img_stride + x0), block_w);
     }
 
-    const uint32_t count = block_w * block_h;
-
-    uint32_t acc0_center = 0U;
-    uint64_t acc1_right = 0ULL;
-    uint64_t acc1_down = 0ULL;
-    uint64_t acc1_rd = 0ULL;
-    uint64_t acc1_ru = 0ULL;
-    uint64_t acc2[20];
-    memset(acc2, 0, sizeof(acc2));
-
-    int8_t pair_i_all[20];
-    int8_t pair_j_all[20];
-    for (int p = 0; p < 20; p++)
-    {
-        pair_i_all[p] = s_pair_idx[p][0];
-        pair_j_all[p] = s_pair_idx[p][1];
-    }
+    hlac25_acc_t acc;
+    hlac25_acc_clear(&acc);
 
     for (uint32_t ry = 0; ry < block_h; ry++)
     {
-        /* 0th/1st order: same as full-image version, applied to cur/next window. */
-#if defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE > 0)
-        acc0_center += hlac_sum_u8_mve(cur, block_w);
-        acc1_down += hlac_sumprod_u8_u8_mve(cur, next, block_w);
-        if (block_w > 1U)
-        {
-            acc1_right += hlac_sumprod_u8_u8_mve(cur, &cur[1], block_w - 1U);
-            acc1_rd += hlac_sumprod_u8_u8_mve(cur, &next[1], block_w - 1U);
-            acc1_ru += hlac_sumprod_u8_u8_mve(cur, &prev[1], block_w - 1U);
-        }
-#else
-        acc0_center += hlac_sum_u8_scalar(cur, block_w);
-        acc1_down += hlac_sumprod_u8_u8_scalar(cur, next, block_w);
-        if (block_w > 1U)
-        {
-            acc1_right += hlac_sumprod_u8_u8_scalar(cur, &cur[1], block_w - 1U);
-            acc1_rd += hlac_sumprod_u8_u8_scalar(cur, &next[1], block_w - 1U);
-            acc1_ru += hlac_sumprod_u8_u8_scalar(cur, &prev[1], block_w - 1U);
-        }
-#endif
+        hlac25_accumulate_row(&acc, prev, cur, next, block_w);
 
-        /* 2nd order terms: same logic as full-image version. */
-        if (block_w == 1U)
-        {
-            uint8_t neigh_u8[8] = {0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U};
-            neigh_u8[1] = prev[0];
-            neigh_u8[6] = next[0];
-            uint64_t c = (uint64_t)cur[0];
-            for (int p = 0; p < 20; p++)
-            {
-                int i = (int)s_pair_idx[p][0];
-                int j = (int)s_pair_idx[p][1];
-                acc2[p] += c * (uint64_t)neigh_u8[i] * (uint64_t)neigh_u8[j];
-            }
-        }
-        else
-        {
-            /* For brevity, use scalar path for ROI (can be optimized with MVE later). */
-            for (uint32_t x = 0; x < block_w; x++)
-            {
-                uint8_t neigh_u8[8];
-                neigh_u8[0] = (x == 0U) ? 0U : prev[x - 1U];
-                neigh_u8[1] = prev[x];
-                neigh_u8[2] = (x + 1U >= block_w) ? 0U : prev[x + 1U];
-                neigh_u8[3] = (x == 0U) ? 0U : cur[x - 1U];
-                neigh_u8[4] = (x + 1U >= block_w) ? 0U : cur[x + 1U];
-                neigh_u8[5] = (x == 0U) ? 0U : next[x - 1U];
-                neigh_u8[6] = next[x];
-                neigh_u8[7] = (x + 1U >= block_w) ? 0U : next[x + 1U];
-
-                uint64_t c = (uint64_t)cur[x];
-                for (int p = 0; p < 20; p++)
-                {
-                    int i = (int)s_pair_idx[p][0];
-                    int j = (int)s_pair_idx[p][1];
-                    acc2[p] += c * (uint64_t)neigh_u8[i] * (uint64_t)neigh_u8[j];
-                }
-            }
-        }
-
-        /* Advance ring buffers. */
-        memcpy(prev, cur, block_w);
-        memcpy(cur, next, block_w);
+        /* Rotate line buffers: prev<-cur, cur<-next, next<-new. */
+        uint8_t *tmp = prev;
+        prev = cur;
+        cur = next;
+        next = tmp;
         if (ry + 2U < block_h)
         {
-            y_img = y0 + ry + 2U;
-            (void)hyperram_b_read(next, (void *)(img_addr + y_img * img_stride + x0), block_w);
+            (void)hyperram_b_read(next, (void *)(uintptr_t)(img_addr + (y0 + ry + 2U) * img_stride + x0), block_w);
         }
         else
         {
@@ -694,42 +590,139 @@ void hlac25_compute_from_u8_hyperram_roi(uint32_t img_addr, uint32_t img_stride,
         }
     }
 
-    if (count != 0U)
+    hlac25_acc_to_features(&acc, block_w * block_h, out25);
+}
+
+int hlac25_stream_init(hlac25_stream_t *s,
+                       uint32_t width, uint32_t height,
+                       uint32_t block_cols, uint32_t block_rows)
+{
+    if (!s || width == 0U || height == 0U || width > HLAC_MAX_IMAGE_W)
     {
-        const float inv_count = 1.0f / (float)count;
-        out25[0] = (float)acc0_center * inv255 * inv_count;
-        out25[1] = (float)acc1_right * inv255_2 * inv_count;
-        out25[2] = (float)acc1_down * inv255_2 * inv_count;
-        out25[3] = (float)acc1_rd * inv255_2 * inv_count;
-        out25[4] = (float)acc1_ru * inv255_2 * inv_count;
-        for (int p = 0; p < 20; p++)
-        {
-            out25[5 + p] = (float)acc2[p] * inv255_3 * inv_count;
-        }
+        return -1;
+    }
+    if (block_cols == 0U || block_rows == 0U || (block_cols * block_rows) > HLAC_STREAM_MAX_BLOCKS)
+    {
+        return -1;
     }
+    if ((width / block_cols) == 0U || (height / block_rows) == 0U)
+    {
+        return -1;
+    }
+
+    hlac25_init_pairs_once();
+
+    s->width = width;
+    s->height = height;
+    s->block_cols = block_cols;
+    s->block_rows = block_rows;
+    s->block_w = width / block_cols;
+    s->block_h = height / block_rows;
+    s->rows_pushed = 0U;
+    s->finished = 0U;
+    s->prev = s->line[0];
+    s->cur = s->line[1];
+    s->next = s->line[2];
+    memset(s->line, 0, sizeof(s->line));
+    for (uint32_t i = 0; i < (block_cols * block_rows); i++)
+    {
+        hlac25_acc_clear(&s->acc[i]);
+    }
+    return 0;
 }
 
-int hlac_lda_predict_ex(const float feats25[25],
-                        float *out_best_score,
-                        float *out_best_prob,
-                        int compute_softmax_prob)
+/* Accumulate image row r (held in s->cur) into the block(s) it belongs to.
+ * Block borders are zero padded, matching hlac25_compute_from_u8_hyperram_roi().
+ */
+static void hlac25_stream_process_row(hlac25_stream_t *s, uint32_t r)
 {
-    if (!feats25)
+    const uint32_t br = r / s->block_h;
+    if (br >= s->block_rows)
     {
-        return -1;
+        return; /* remainder rows (height % block_rows) are ignored, as in the ROI path */
+    }
+    const uint32_t ry = r - br * s->block_h;
+    const uint8_t *p = (ry == 0U) ? s_zero_row : s->prev;
+    const uint8_t *n = ((ry + 1U) >= s->block_h) ? s_zero_row : s->next;
+
+    for (uint32_t bc = 0; bc < s->block_cols; bc++)
+    {
+        const uint32_t x0 = bc * s->block_w;
+        hlac25_accumulate_row(&s->acc[br * s->block_cols + bc], p + x0, s->cur + x0, n + x0, s->block_w);
+    }
+}
+
+void hlac25_stream_push_row(hlac25_stream_t *s, const uint8_t *row)
+{
+    if (!s || !row || s->finished || s->rows_pushed >= s->height)
+    {
+        return;
     }
 
+    if (s->rows_pushed == 0U)
+    {
+        memcpy(s->cur, row, s->width);
+        s->rows_pushed = 1U;
+        return;
+    }
+
+    /* Row (rows_pushed-1) now has both neighbours available. */
+    memcpy(s->next, row, s->width);
+    hlac25_stream_process_row(s, s->rows_pushed - 1U);
+
+    uint8_t *tmp = s->prev;
+    s->prev = s->cur;
+    s->cur = s->next;
+    s->next = tmp;
+    s->rows_pushed++;
+}
+
+void hlac25_stream_finish(hlac25_stream_t *s)
+{
+    if (!s || s->finished || s->rows_pushed == 0U)
+    {
+        return;
+    }
+
+    /* Last pushed row: bottom neighbour is zero padding. */
+    memset(s->next, 0, s->width);
+    hlac25_stream_process_row(s, s->rows_pushed - 1U);
+    s->finished = 1U;
+}
+
+void hlac25_stream_get_features(const hlac25_stream_t *s, uint32_t block_index, float out25[25])
+{
+    if (!s || !out25 || block_index >= (s->block_cols * s->block_rows))
+    {
+        return;
+    }
+
+    hlac25_acc_to_features(&s->acc[block_index], s->block_w * s->block_h, out25);
+}
+
+uint32_t hlac25_stream_block_sum(const hlac25_stream_t *s, uint32_t block_index)
+{
+    if (!s || block_index >= (s->block_cols * s->block_rows))
+    {
+        return 0U;
+    }
+
+    return s->acc[block_index].acc0_center;
+}
+
+/* LDA scores for all classes. Returns the class count used (0 on error). */
+static uint32_t hlac_lda_scores(const float feats25[25], float scores[HLAC_MAX_CLASSES], int *out_best)
+{
     uint32_t C = g_hlac_lda_num_classes;
     if (C == 0U)
     {
-        return -1;
+        return 0U;
     }
     if (C > HLAC_MAX_CLASSES)
     {
         C = HLAC_MAX_CLASSES;
     }
 
-    float scores[HLAC_MAX_CLASSES];
     int best = 0;
     float best_score = -INFINITY;
 
@@ -757,6 +750,29 @@ int hlac_lda_predict_ex(const float feats25[25],
         }
     }
 
+    *out_best = best;
+    return C;
+}
+
+int hlac_lda_predict_ex(const float feats25[25],
+                        float *out_best_score,
+                        float *out_best_prob,
+                        int compute_softmax_prob)
+{
+    if (!feats25)
+    {
+        return -1;
+    }
+
+    float scores[HLAC_MAX_CLASSES];
+    int best = 0;
+    const uint32_t C = hlac_lda_scores(feats25, scores, &best);
+    if (C == 0U)
+    {
+        return -1;
+    }
+    const float best_score = scores[best];
+
     if (out_best_score)
     {
         *out_best_score = best_score;
@@ -785,6 +801,44 @@ int hlac_lda_predict_ex(const float feats25[25],
     return best;
 }
 
+int hlac_lda_predict_probs(const float feats25[25],
+                           float out_probs[HLAC_MAX_CLASSES],
+                           float *out_best_score)
+{
+    if (!feats25 || !out_probs)
+    {
+        return -1;
+    }
+
+    float scores[HLAC_MAX_CLASSES];
+    int best = 0;
+    const uint32_t C = hlac_lda_scores(feats25, scores, &best);
+    if (C == 0U)
+    {
+        return -1;
+    }
+    const float best_score = scores[best];
+
+    if (out_best_score)
+    {
+        *out_best_score = best_score;
+    }
+
+    float sum_exp = 0.0f;
+    for (uint32_t c = 0; c < C; c++)
+    {
+        out_probs[c] = expf(scores[c] - best_score);
+        sum_exp += out_probs[c];
+    }
+    const float inv = (sum_exp > 0.0f) ? (1.0f / sum_exp) : 0.0f;
+    for (uint32_t c = 0; c < (uint32_t)HLAC_MAX_CLASSES; c++)
+    {
+        out_probs[c] = (c < C) ? (out_probs[c] * inv) : 0.0f;
+    }
+
+    return best;
+}
+
 int hlac_lda_predict(const float feats25[25], float *out_best_score)
 {
     return hlac_lda_predict_ex(feats25, out_best_score, NULL, 0);
@@ -2,6 +2,17 @@
 
 #include <stdint.h>
 
+#include "hlac_lda_model.h"
+
+#ifndef HLAC_MAX_IMAGE_W
+#define HLAC_MAX_IMAGE_W (320U)
+#endif
+
+/* Upper bound of block_cols*block_rows for the streaming accumulator (4x4 grid by default). */
+#ifndef HLAC_STREAM_MAX_BLOCKS
+#define HLAC_STREAM_MAX_BLOCKS (16U)
+#endif
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -35,6 +46,60 @@ extern "C"
                                              uint32_t block_w, uint32_t block_h,
                                              float out25[25]);
 
+    /* Integer HLAC accumulators for one image (or one block). */
+    typedef struct
+    {
+        uint32_t acc0_center;
+        uint64_t acc1_right;
+        uint64_t acc1_down;
+        uint64_t acc1_rd;
+        uint64_t acc1_ru;
+        uint64_t acc2[20];
+    } hlac25_acc_t;
+
+    /* Streaming HLAC: feed u8 rows from SRAM top-to-bottom instead of reading
+     * the image back from HyperRAM. Keeps a 3-row window internally and
+     * accumulates every block of a block_cols x block_rows grid in one pass
+     * (use 1x1 for the full image).
+     *
+     * Results are identical to hlac25_compute_from_u8_hyperram() (1x1) and
+     * hlac25_compute_from_u8_hyperram_roi() (per block, zero-padded borders).
+     * The context is ~4KB; keep it static rather than on a task stack.
+     */
+    typedef struct
+    {
+        uint32_t width;
+        uint32_t height;
+        uint32_t block_cols;
+        uint32_t block_rows;
+        uint32_t block_w;
+        uint32_t block_h;
+        uint32_t rows_pushed;
+        uint32_t finished;
+        uint8_t *prev;
+        uint8_t *cur;
+        uint8_t *next;
+        uint8_t line[3][HLAC_MAX_IMAGE_W];
+        hlac25_acc_t acc[HLAC_STREAM_MAX_BLOCKS];
+    } hlac25_stream_t;
+
+    /* Returns 0 on success, -1 on invalid size/grid. */
+    int hlac25_stream_init(hlac25_stream_t *s,
+                           uint32_t width, uint32_t height,
+                           uint32_t block_cols, uint32_t block_rows);
+
+    /* Push the next image row (width bytes). Rows beyond height are ignored. */
+    void hlac25_stream_push_row(hlac25_stream_t *s, const uint8_t *row);
+
+    /* Flush the last row (bottom zero padding). Call once after the last push. */
+    void hlac25_stream_finish(hlac25_stream_t *s);
+
+    /* Features of block (row-major index br*block_cols+bc) after finish. */
+    void hlac25_stream_get_features(const hlac25_stream_t *s, uint32_t block_index, float out25[25]);
+
+    /* Order-0 sum (sum of pixel values) of a block after finish: a cheap energy measure. */
+    uint32_t hlac25_stream_block_sum(const hlac25_stream_t *s, uint32_t block_index);
+
     /* LDA predict: returns label in [0..num_classes-1], or -1 on error.
      * If out_best_score is non-NULL, stores the best score.
      */
@@ -54,6 +119,15 @@ extern "C"
                             float *out_best_prob,
                             int compute_softmax_prob);
 
+    /* Softmax probabilities of all classes (one expf per class).
+     *
+     * out_probs has HLAC_MAX_CLASSES entries; classes >= g_hlac_lda_num_classes are 0.
+     * Returns the best label, or -1 on error.
+     */
+    int hlac_lda_predict_probs(const float feats25[25],
+                               float out_probs[HLAC_MAX_CLASSES],
+                               float *out_best_score);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,96 @@
+#include "hlac_temporal.h"
+
+#include <string.h>
+#include <math.h>
+
+void hlac_temporal_init(hlac_temporal_t *t, uint32_t num_classes)
+{
+    if (!t)
+    {
+        return;
+    }
+    memset(t, 0, sizeof(*t));
+    t->num_classes = (num_classes > HLAC_MAX_CLASSES) ? HLAC_MAX_CLASSES : num_classes;
+    t->last_decision = -1;
+}
+
+void hlac_temporal_add(hlac_temporal_t *t, const float probs[HLAC_MAX_CLASSES])
+{
+    if (!t || !probs)
+    {
+        return;
+    }
+    for (uint32_t c = 0; c < t->num_classes; c++)
+    {
+        t->frame[c] += probs[c];
+    }
+    t->blocks++;
+}
+
+int hlac_temporal_end_frame(hlac_temporal_t *t)
+{
+    if (!t || (t->num_classes == 0U))
+    {
+        return -1;
+    }
+
+    if (t->since_decision < 0xFFFFFFFFU)
+    {
+        t->since_decision++;
+    }
+
+    if (t->blocks == 0U)
+    {
+        return -1;
+    }
+
+    /* 現フレーム: ブロック平均の log を減衰付きで積算 */
+    const float inv_blocks = 1.0f / (float)t->blocks;
+    float top = -INFINITY;
+    for (uint32_t c = 0; c < t->num_classes; c++)
+    {
+        const float p = fmaxf(t->frame[c] * inv_blocks, HLAC_TEMPORAL_PROB_FLOOR);
+        t->evidence[c] = HLAC_TEMPORAL_DECAY * t->evidence[c] + logf(p);
+        t->frame[c] = 0.0f;
+        top = fmaxf(top, t->evidence[c]);
+    }
+    t->blocks = 0U;
+
+    /* 1位から CAP 以上離れたクラスは引き上げる(切替時に古い履歴を打ち消す量を制限) */
+    int best = 0;
+    float e1 = -INFINITY;
+    float e2 = -INFINITY;
+    for (uint32_t c = 0; c < t->num_classes; c++)
+    {
+        float e = t->evidence[c];
+        if (e < (top - HLAC_TEMPORAL_CAP))
+        {
+            e = top - HLAC_TEMPORAL_CAP;
+            t->evidence[c] = e;
+        }
+        if (e > e1)
+        {
+            e2 = e1;
+            e1 = e;
+            best = (int)c;
+        }
+        else if (e > e2)
+        {
+            e2 = e;
+        }
+    }
+    t->margin = (t->num_classes > 1U) ? (e1 - e2) : HLAC_TEMPORAL_CAP;
+
+    if (t->margin < HLAC_TEMPORAL_MARGIN)
+    {
+        return -1;
+    }
+    if ((best == t->last_decision) && (t->since_decision < (uint32_t)HLAC_TEMPORAL_REPEAT_FRAMES))
+    {
+        return -1;
+    }
+
+    t->last_decision = best;
+    t->since_decision = 0U;
+    return best;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "hlac_lda_model.h"
+
+/*
+ * Temporal smoothing of HLAC/LDA predictions (motor decisions).
+ *
+ * - 1フレーム分の証拠 = ブロックごとの softmax 確率ベクトルの平均(確率で重み付けした投票)．
+ * - クラスごとに log(確率) を decay で減衰させながら積算する(逐次確率比検定と同じ形)．
+ *   1位と2位の差(margin, 対数尤度比)が HLAC_TEMPORAL_MARGIN を超えた時点で判定を出す．
+ * - 1位から HLAC_TEMPORAL_CAP 以上離れたクラスは引き上げる(古い履歴が切替を遅らせない)．
+ * - 連続一致カウント方式と違い，1フレームだけのノイズで安定度がリセットされず，
+ *   確信度の高いフレームが続けば 1〜2 フレームで判定が出る．
+ * - 同じクラスの再判定は HLAC_TEMPORAL_REPEAT_FRAMES ごと(モータのホールドを延長するため)．
+ *   クラスが変わったときは待たない．
+ * - 連続一致カウント方式との比較は script/hlac_temporal_sim.sh(bench/hlac_temporal_sim.c)．
+ *
+ * 既定は OFF(MOTOR_PRED_STABLE_COUNT の連続一致カウント)．シミュレーションでは誤認識の確信度が
+ * 低いと仮定したとき(lower)だけ K=3 に勝ち，正解/誤りで確信度が同じ(equal)だと K=2 より悪い．
+ * 実機で記録した hlac_lda_predict_probs の出力で DECAY/MARGIN/CAP を調整してから有効にすること．
+ */
+
+#ifndef HLAC_TEMPORAL_ENABLE
+#define HLAC_TEMPORAL_ENABLE (0)
+#endif
+
+/* 1フレーム古くなるごとの重み(0..1)．実効窓 ~ 1/(1-decay) フレーム */
+#ifndef HLAC_TEMPORAL_DECAY
+#define HLAC_TEMPORAL_DECAY (0.5f)
+#endif
+
+/* 判定に必要な margin(log 尤度比，1位 - 2位) */
+#ifndef HLAC_TEMPORAL_MARGIN
+#define HLAC_TEMPORAL_MARGIN (2.0f)
+#endif
+
+/* 1位との差の上限．MARGIN 以下にすると判定が出なくなる */
+#ifndef HLAC_TEMPORAL_CAP
+#define HLAC_TEMPORAL_CAP (2.5f)
+#endif
+
+/* log(0) を避ける確率の下限 */
+#ifndef HLAC_TEMPORAL_PROB_FLOOR
+#define HLAC_TEMPORAL_PROB_FLOOR (1.0e-3f)
+#endif
+
+/* 同じクラスを再判定するまでのフレーム数 */
+#ifndef HLAC_TEMPORAL_REPEAT_FRAMES
+#define HLAC_TEMPORAL_REPEAT_FRAMES (3U)
+#endif
+
+typedef struct
+{
+    uint32_t num_classes;
+    uint32_t blocks; // 現フレームに加えたブロック数
+    int last_decision;
+    uint32_t since_decision; // 最後の判定からのフレーム数
+    float margin;            // 直近の margin
+    float frame[HLAC_MAX_CLASSES];
+    float evidence[HLAC_MAX_CLASSES]; // 減衰付き log 確率の積算
+} hlac_temporal_t;
+
+void hlac_temporal_init(hlac_temporal_t *t, uint32_t num_classes);
+
+/* 1ブロック分の確率ベクトル(hlac_lda_predict_probs の出力)を現フレームに加える */
+void hlac_temporal_add(hlac_temporal_t *t, const float probs[HLAC_MAX_CLASSES]);
+
+/*
+ * 現フレームを確定して証拠を更新する．
+ * 戻り値: 判定を出すクラス(モータへ post する)，出さないときは -1．
+ * 有効なブロックが無かったフレームは証拠に入れない．
+ */
+int hlac_temporal_end_frame(hlac_temporal_t *t);
@@ -8,7 +8,9 @@
 #include <string.h>
 #include <stdint.h>
 #include "verify_mode.h"
+#include "prof.h"
 #include "FreeRTOS.h"
+#include "task.h"
 #include "semphr.h"
 
 /*
@@ -99,6 +101,87 @@ static volatile uint32_t g_hyperram_wv_chunks_mismatched = 0;
 static volatile uint32_t g_hyperram_wv_chunks_retry_ok = 0;
 static volatile uint32_t g_hyperram_wv_chunks_safe_fallback_used = 0;
 
+/* Per-caller bus accounting (hyperram_caller_stats_get). */
+static TaskHandle_t g_hyperram_caller_task[HYPERRAM_CALLER_COUNT];
+static hyperram_caller_stats_t g_hyperram_caller_stats[HYPERRAM_CALLER_COUNT];
+
+static inline uint32_t hyperram_cyc_now(void)
+{
+#if HYPERRAM_STATS_ENABLE || PROF_ENABLE
+    return DWT->CYCCNT;
+#else
+    return 0U;
+#endif
+}
+
+static inline hyperram_caller_t hyperram_current_caller(void)
+{
+#if HYPERRAM_STATS_ENABLE
+    const TaskHandle_t me = xTaskGetCurrentTaskHandle();
+    for (uint32_t i = 1U; i < (uint32_t)HYPERRAM_CALLER_COUNT; i++)
+    {
+        if (g_hyperram_caller_task[i] == me)
+        {
+            return (hyperram_caller_t)i;
+        }
+    }
+#endif
+    return HYPERRAM_CALLER_OTHER;
+}
+
+/* Call with the mutex held (OTHER may be shared by several tasks). */
+static inline void hyperram_stats_account(hyperram_caller_t caller, bool is_write, uint32_t bytes,
+                                          uint32_t wait_cyc, uint32_t hold_cyc)
+{
+#if HYPERRAM_STATS_ENABLE
+    hyperram_caller_stats_t *st = &g_hyperram_caller_stats[caller];
+    if (is_write)
+    {
+        st->write_transactions++;
+        st->write_bytes += bytes;
+    }
+    else
+    {
+        st->read_transactions++;
+        st->read_bytes += bytes;
+    }
+    st->wait_cycles += wait_cyc;
+    st->hold_cycles += hold_cyc;
+    if (wait_cyc > st->max_wait_cycles)
+    {
+        st->max_wait_cycles = wait_cyc;
+    }
+    if (hold_cyc > st->max_hold_cycles)
+    {
+        st->max_hold_cycles = hold_cyc;
+    }
+#else
+    (void)caller;
+    (void)is_write;
+    (void)bytes;
+    (void)wait_cyc;
+    (void)hold_cyc;
+#endif
+}
+
+/* Mutex not taken: only the caller's own task writes its entry (OTHER is best-effort). */
+static inline void hyperram_stats_timeout(hyperram_caller_t caller, uint32_t wait_cyc)
+{
+#if HYPERRAM_STATS_ENABLE
+    hyperram_caller_stats_t *st = &g_hyperram_caller_stats[caller];
+    st->timeouts++;
+    st->wait_cycles += wait_cyc;
+    if (wait_cyc > st->max_wait_cycles)
+    {
+        st->max_wait_cycles = wait_cyc;
+    }
+#else
+    (void)caller;
+    (void)wait_cyc;
+#endif
+    prof_count(PROF_CTR_HYPERRAM_TIMEOUTS, 1U);
+}
+
 #if HYPERRAM_WRITE_VERIFY && HYPERRAM_UNSAFE_RW_CROSS_16B
 static bool hyperram_wv_safe_rewrite_verify(const uint8_t *src,
                                             volatile uint8_t *dst8,
@@ -399,6 +482,12 @@ fsp_err_t hyperram_init(void)
         xprintf("[HyperRAM] Mutex-based thread-safe access initialized\n");
     }
 
+#if HYPERRAM_STATS_ENABLE
+    /* Wait/hold accounting uses the cycle counter (enable without resetting). */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+
 #if defined(APP_MODE_FFT_VERIFY) && (APP_MODE_FFT_VERIFY != 0)
     xprintf("[HyperRAM] mmap RW chunk=%dB cross16=%d\n",
             (int)HYPERRAM_RW_CHUNK_SIZE,
@@ -477,10 +566,16 @@ fsp_err_t hyperram_b_write_timed(const void *p_src, void *p_dest, uint32_t total
     }
 
     /* Mutex acquire: caller-controlled wait. */
+    const hyperram_caller_t caller = hyperram_current_caller();
+    const uint32_t t_wait = hyperram_cyc_now();
     if (xSemaphoreTake(g_hyperram_mutex, wait_ticks) != pdTRUE)
     {
+        hyperram_stats_timeout(caller, hyperram_cyc_now() - t_wait);
         return FSP_ERR_TIMEOUT;
     }
+    const uint32_t t_hold = hyperram_cyc_now();
+    const uint32_t wait_cyc = t_hold - t_wait;
+    prof_record(PROF_SPAN_HYPERRAM_WAIT, wait_cyc);
 
     // 排他制御下で書き込み実行
     const uint8_t *src_p8 = (const uint8_t *)p_src;
@@ -736,6 +831,14 @@ fsp_err_t hyperram_b_write_timed(const void *p_src, void *p_dest, uint32_t total
     (void)verify_failed_chunks;
 #endif
 
+    const uint32_t hold_cyc = hyperram_cyc_now() - t_hold;
+    prof_record(PROF_SPAN_HYPERRAM_WRITE, hold_cyc);
+    prof_count(PROF_CTR_HYPERRAM_WRITE_BYTES, total_length);
+    hyperram_stats_account(caller, true, total_length, wait_cyc, hold_cyc);
+#if HYPERRAM_WRITE_VERIFY && HYPERRAM_STATS_ENABLE
+    g_hyperram_caller_stats[caller].wv_retries += verify_retries_used;
+#endif
+
     // ミューテックス解放
     xSemaphoreGive(g_hyperram_mutex);
     return err;
@@ -781,6 +884,37 @@ uint32_t hyperram_write_verify_retries(void)
     return (uint32_t)HYPERRAM_WRITE_VERIFY_RETRIES;
 }
 
+void hyperram_register_caller(hyperram_caller_t caller)
+{
+    if (((uint32_t)caller == 0U) || ((uint32_t)caller >= (uint32_t)HYPERRAM_CALLER_COUNT))
+    {
+        return;
+    }
+    g_hyperram_caller_task[caller] = xTaskGetCurrentTaskHandle();
+}
+
+void hyperram_caller_stats_get(hyperram_caller_t caller, hyperram_caller_stats_t *p_stats)
+{
+    if ((p_stats == NULL) || ((uint32_t)caller >= (uint32_t)HYPERRAM_CALLER_COUNT))
+    {
+        return;
+    }
+    /* Unlocked copy (diagnostics): a transaction finishing meanwhile may be half counted. */
+    *p_stats = g_hyperram_caller_stats[caller];
+}
+
+void hyperram_caller_stats_reset(void)
+{
+    /* Best-effort reset; ok if a transfer is in-flight (diagnostics only). */
+    memset(g_hyperram_caller_stats, 0, sizeof(g_hyperram_caller_stats));
+}
+
+const char *hyperram_caller_name(hyperram_caller_t caller)
+{
+    static const char *const s_names[HYPERRAM_CALLER_COUNT] = {"other", "capture", "compute", "stream"};
+    return ((uint32_t)caller < (uint32_t)HYPERRAM_CALLER_COUNT) ? s_names[caller] : "?";
+}
+
 fsp_err_t hyperram_b_read(void *p_dest, const void *p_src, uint32_t total_length)
 {
     /* Preserve legacy behavior: block up to 5 seconds. */
@@ -798,10 +932,16 @@ fsp_err_t hyperram_b_read_timed(void *p_dest, const void *p_src, uint32_t total_
     }
 
     /* Mutex acquire: caller-controlled wait. */
+    const hyperram_caller_t caller = hyperram_current_caller();
+    const uint32_t t_wait = hyperram_cyc_now();
     if (xSemaphoreTake(g_hyperram_mutex, wait_ticks) != pdTRUE)
     {
+        hyperram_stats_timeout(caller, hyperram_cyc_now() - t_wait);
         return FSP_ERR_TIMEOUT;
     }
+    const uint32_t t_hold = hyperram_cyc_now();
+    const uint32_t wait_cyc = t_hold - t_wait;
+    prof_record(PROF_SPAN_HYPERRAM_WAIT, wait_cyc);
 
     // 排他制御下で読み込み実行
     uint8_t *dest_p8 = (uint8_t *)p_dest;
@@ -864,6 +1004,11 @@ fsp_err_t hyperram_b_read_timed(void *p_dest, const void *p_src, uint32_t total_
     __DSB();
     __ISB();
 
+    const uint32_t hold_cyc = hyperram_cyc_now() - t_hold;
+    prof_record(PROF_SPAN_HYPERRAM_READ, hold_cyc);
+    prof_count(PROF_CTR_HYPERRAM_READ_BYTES, total_length);
+    hyperram_stats_account(caller, false, total_length, wait_cyc, hold_cyc);
+
     // ミューテックス解放
     xSemaphoreGive(g_hyperram_mutex);
     return err;
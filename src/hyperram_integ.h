@@ -29,6 +29,23 @@ extern "C"
 
 #define HYPERRAM_SIZE (8 * 1024 * 1024U) /* 8MB */
 
+/*
+ * Per-caller bus accounting (hyperram_caller_stats_get).
+ * Costs two DWT reads and a handle lookup per hyperram_b_read/write call.
+ */
+#ifndef HYPERRAM_STATS_ENABLE
+#define HYPERRAM_STATS_ENABLE (1)
+#endif
+
+/* 1: Thread1 sends the per-caller stats as a UDP packet while streaming (matlab/hyperram_bus_stats.m). */
+#ifndef HYPERRAM_STATS_UDP_ENABLE
+#define HYPERRAM_STATS_UDP_ENABLE (1)
+#endif
+
+#ifndef HYPERRAM_STATS_UDP_PERIOD_MS
+#define HYPERRAM_STATS_UDP_PERIOD_MS (1000U)
+#endif
+
     extern volatile uint8_t g_hyperram_addr_remap_shift;
     void hyperram_set_addr_remap_shift(uint8_t shift);
     uint8_t hyperram_get_addr_remap_shift(void);
@@ -76,6 +93,57 @@ extern "C"
     uint32_t hyperram_write_verify_is_enabled(void);
     uint32_t hyperram_write_verify_retries(void);
 
+    /*
+     * Per-caller accounting.
+     * A task registers itself once (hyperram_register_caller); calls from unregistered
+     * tasks are counted as HYPERRAM_CALLER_OTHER. Each registered caller's counters are
+     * only written by its own task, so no extra locking is needed. Cycles are DWT->CYCCNT.
+     */
+    typedef enum
+    {
+        HYPERRAM_CALLER_OTHER = 0,
+        HYPERRAM_CALLER_CAPTURE, /* Thread0: camera / synthetic frame writes */
+        HYPERRAM_CALLER_COMPUTE, /* Thread3: PQ128 / FC / HLAC row streaming */
+        HYPERRAM_CALLER_STREAM,  /* lwIP tcpip_thread: UDP chunk reads (zero-wait retries) */
+        HYPERRAM_CALLER_COUNT
+    } hyperram_caller_t;
+
+    typedef struct
+    {
+        uint32_t read_transactions;
+        uint32_t write_transactions;
+        uint64_t read_bytes;
+        uint64_t write_bytes;
+        uint64_t wait_cycles; /* mutex wait, including waits that ended in FSP_ERR_TIMEOUT */
+        uint64_t hold_cycles; /* mutex held: transfer + write verify */
+        uint32_t max_wait_cycles;
+        uint32_t max_hold_cycles;
+        uint32_t timeouts;   /* FSP_ERR_TIMEOUT returned to this caller */
+        uint32_t wv_retries; /* write verify retries on this caller's writes */
+    } hyperram_caller_stats_t;
+
+    void hyperram_register_caller(hyperram_caller_t caller);
+    void hyperram_caller_stats_get(hyperram_caller_t caller, hyperram_caller_stats_t *p_stats);
+    void hyperram_caller_stats_reset(void);
+    const char *hyperram_caller_name(hyperram_caller_t caller);
+
+/* UDP パケット(Thread1 → ホスト，ポートは映像と同じ) */
+#define HYPERRAM_STATS_UDP_MAGIC (0x314D5248U) // "HRM1"
+
+    typedef struct
+    {
+        uint32_t magic;
+        uint32_t cpu_hz; // DWT クロック(SystemCoreClock)
+        uint32_t uptime_ms;
+        uint16_t caller_count; // HYPERRAM_CALLER_COUNT
+        uint16_t word_count;   // caller ごとの uint32 の数
+    } hyperram_stats_udp_header_t;
+    /*
+     * 続いて caller ごとに read_tx, write_tx, read_bytes(lo,hi), write_bytes(lo,hi),
+     * wait_cycles(lo,hi), hold_cycles(lo,hi), max_wait, max_hold, timeouts, wv_retries(uint32)
+     */
+#define HYPERRAM_STATS_UDP_WORDS (14U)
+
     /*
      * 4-byte fixed access (diagnostics).
      * addr is a logical HyperRAM byte offset (same addressing as hyperram_b_read/write).
@@ -0,0 +1,124 @@
+#include "latency_trace.h"
+#include "xprintf.h"
+
+#if LATENCY_TRACE_ENABLE
+
+extern uint32_t SystemCoreClock;
+
+static latency_trace_record_t s_ring[LATENCY_TRACE_DEPTH];
+static volatile uint32_t s_newest_seq = 0U; // 最後に開いたレコードの seq(0 = なし)
+
+void latency_trace_init(void)
+{
+    /* Other timing helpers may reset CYCCNT at their init; do not touch it here. */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+void latency_trace_open(uint32_t frame_seq)
+{
+    if (frame_seq == 0U)
+    {
+        return;
+    }
+
+    latency_trace_record_t *r = &s_ring[frame_seq & (LATENCY_TRACE_DEPTH - 1U)];
+
+    /* Invalidate first so late stamps for the previous owner are dropped. */
+    r->frame_seq = 0U;
+    __DMB();
+    for (uint32_t i = 0U; i < (uint32_t)LATENCY_STAGE_COUNT; i++)
+    {
+        r->cyc[i] = 0U;
+    }
+    __DMB();
+    r->frame_seq = frame_seq;
+
+    if ((int32_t)(frame_seq - s_newest_seq) > 0)
+    {
+        s_newest_seq = frame_seq;
+    }
+}
+
+void latency_trace_stamp_at(uint32_t frame_seq, latency_stage_t stage, uint32_t cyc)
+{
+    if ((frame_seq == 0U) || ((uint32_t)stage >= (uint32_t)LATENCY_STAGE_COUNT))
+    {
+        return;
+    }
+
+    latency_trace_record_t *r = &s_ring[frame_seq & (LATENCY_TRACE_DEPTH - 1U)];
+    if ((r->frame_seq != frame_seq) || (r->cyc[stage] != 0U))
+    {
+        return;
+    }
+    r->cyc[stage] = (cyc != 0U) ? cyc : 1U;
+}
+
+uint32_t latency_trace_read(latency_trace_record_t *out, uint32_t max, uint32_t *cursor)
+{
+    const uint32_t newest = s_newest_seq;
+    if ((out == NULL) || (cursor == NULL) || (newest <= (uint32_t)LATENCY_TRACE_SETTLE_FRAMES))
+    {
+        return 0U;
+    }
+
+    const uint32_t last = newest - (uint32_t)LATENCY_TRACE_SETTLE_FRAMES;
+    /* Oldest seq still guaranteed to be in the ring. */
+    const uint32_t oldest = (newest > (uint32_t)LATENCY_TRACE_DEPTH) ? (newest - (uint32_t)LATENCY_TRACE_DEPTH + 1U) : 1U;
+
+    uint32_t seq = *cursor + 1U;
+    if ((int32_t)(seq - oldest) < 0)
+    {
+        seq = oldest;
+    }
+
+    uint32_t n = 0U;
+    for (; ((int32_t)(last - seq) >= 0) && (n < max); seq++)
+    {
+        const latency_trace_record_t *r = &s_ring[seq & (LATENCY_TRACE_DEPTH - 1U)];
+        if (r->frame_seq != seq)
+        {
+            continue; // dropped capture (timeout) or already reused
+        }
+        out[n] = *r;
+        __DMB();
+        if (r->frame_seq == seq)
+        {
+            n++;
+        }
+    }
+    *cursor = seq - 1U;
+    return n;
+}
+
+static int32_t latency_trace_delta_us(const latency_trace_record_t *r, uint32_t stage)
+{
+    const uint32_t hz = SystemCoreClock;
+    if ((r->cyc[stage] == 0U) || (r->cyc[LATENCY_STAGE_CEU_FRAME_END] == 0U) || (hz == 0U))
+    {
+        return -1;
+    }
+    const uint32_t d = r->cyc[stage] - r->cyc[LATENCY_STAGE_CEU_FRAME_END];
+    return (int32_t)(((uint64_t)d * 1000000ULL) / (uint64_t)hz);
+}
+
+void latency_trace_log_cdc(void)
+{
+    static uint32_t s_cursor = 0U;
+    latency_trace_record_t recs[4];
+
+    const uint32_t n = latency_trace_read(recs, (uint32_t)(sizeof(recs) / sizeof(recs[0])), &s_cursor);
+    for (uint32_t i = 0U; i < n; i++)
+    {
+        /* [LAT] seq,pub,pq,hlac,lda,post,gpt,udp0,udp1 (us from FRAME_END, -1 = not reached) */
+        xprintf("[LAT] %lu", (unsigned long)recs[i].frame_seq);
+        for (uint32_t s = 1U; s < (uint32_t)LATENCY_STAGE_COUNT; s++)
+        {
+            xprintf(",%ld", (long)latency_trace_delta_us(&recs[i], s));
+        }
+        xprintf("\n");
+    }
+}
+
+#endif
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hal_data.h"
+
+/*
+ * Photon-to-actuation latency trace.
+ *
+ * - One record per captured frame (keyed by the capture seq = g_video_frame_seq),
+ *   opened by Thread0 when the capture into its buffer starts.
+ * - Each pipeline stage stamps DWT->CYCCNT once (first stamp wins, so frames that are
+ *   re-sent over UDP keep their first chunk time).
+ * - Records live in a small SRAM ring (LATENCY_TRACE_DEPTH). A record is "settled"
+ *   once LATENCY_TRACE_SETTLE_FRAMES newer frames have been opened; settled records
+ *   are drained over UDP (Thread1) and/or CDC (Thread0).
+ * - Stamps are single 32-bit stores: safe from ISRs and any task. A stamp racing with
+ *   the slot being reused may land in the newer record (ring is deep enough to make
+ *   this rare; the host script drops out-of-order stamps).
+ */
+
+#ifndef LATENCY_TRACE_ENABLE
+#define LATENCY_TRACE_ENABLE (1)
+#endif
+
+/* Ring depth (power of two). */
+#ifndef LATENCY_TRACE_DEPTH
+#define LATENCY_TRACE_DEPTH (32U)
+#endif
+
+/* Frames to wait before a record is considered complete (late stages may never fire). */
+#ifndef LATENCY_TRACE_SETTLE_FRAMES
+#define LATENCY_TRACE_SETTLE_FRAMES (4U)
+#endif
+
+/* 1: Thread1 sends settled records as a UDP packet after each streamed frame. */
+#ifndef LATENCY_TRACE_UDP_ENABLE
+#define LATENCY_TRACE_UDP_ENABLE (1)
+#endif
+
+/* 1: Thread0 prints settled records over CDC ("[LAT] ..." lines). */
+#ifndef LATENCY_TRACE_CDC_ENABLE
+#define LATENCY_TRACE_CDC_ENABLE (0)
+#endif
+
+#if (LATENCY_TRACE_DEPTH & (LATENCY_TRACE_DEPTH - 1U))
+#error LATENCY_TRACE_DEPTH must be power-of-two.
+#endif
+
+#if (LATENCY_TRACE_SETTLE_FRAMES >= LATENCY_TRACE_DEPTH)
+#error LATENCY_TRACE_SETTLE_FRAMES must be smaller than LATENCY_TRACE_DEPTH.
+#endif
+
+typedef enum
+{
+    LATENCY_STAGE_CEU_FRAME_END = 0, // CEU FRAME_END 割り込み(各 stage の基準)
+    LATENCY_STAGE_HYPERRAM_PUBLISH,  // HyperRAM 書き出し完了 → g_video_frame_seq 公開
+    LATENCY_STAGE_PQ_DONE,           // p/q(PQ128 または HLAC true256 の |P|+|Q|)完了
+    LATENCY_STAGE_HLAC_DONE,         // HLAC 特徴量完了
+    LATENCY_STAGE_LDA_DECISION,      // LDA 判定(pred 確定)
+    LATENCY_STAGE_MOTOR_POST,        // motor_control_post_pred
+    LATENCY_STAGE_GPT_APPLIED,       // モータタスクが GPT デューティを更新
+    LATENCY_STAGE_UDP_FIRST,         // このフレームの最初の UDP チャンク送信
+    LATENCY_STAGE_UDP_LAST,          // 最後の UDP チャンク送信
+    LATENCY_STAGE_COUNT
+} latency_stage_t;
+
+typedef struct
+{
+    uint32_t frame_seq;
+    uint32_t cyc[LATENCY_STAGE_COUNT]; // DWT->CYCCNT(0 = 未到達)
+} latency_trace_record_t;
+
+/* UDP パケット(Thread1 → ホスト，ポートは映像と同じ) */
+#define LATENCY_TRACE_UDP_MAGIC (0x4C545231U) // "LTR1"
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t cpu_hz;      // DWT クロック(SystemCoreClock)
+    uint16_t stage_count; // LATENCY_STAGE_COUNT
+    uint16_t record_count;
+} latency_trace_udp_header_t;
+
+#if LATENCY_TRACE_ENABLE
+
+/* DWT サイクルカウンタを有効化(CYCCNT はリセットしない)．複数回呼んでよい． */
+void latency_trace_init(void);
+
+static inline uint32_t latency_trace_now(void)
+{
+    uint32_t cyc = DWT->CYCCNT;
+    return (cyc != 0U) ? cyc : 1U; // 0 は「未到達」用に予約
+}
+
+/* 取り込み開始時にレコードを開く(古い内容を捨てる) */
+void latency_trace_open(uint32_t frame_seq);
+
+/* stage を記録(開いていない seq / 記録済みの stage は無視) */
+void latency_trace_stamp_at(uint32_t frame_seq, latency_stage_t stage, uint32_t cyc);
+
+static inline void latency_trace_stamp(uint32_t frame_seq, latency_stage_t stage)
+{
+    latency_trace_stamp_at(frame_seq, stage, latency_trace_now());
+}
+
+/*
+ * *cursor より新しい確定済みレコードを最大 max 件コピーし，*cursor を進める．
+ * 戻り値はコピー件数．cursor は呼び出し側ごとに持つ(初期値 0)．
+ */
+uint32_t latency_trace_read(latency_trace_record_t *out, uint32_t max, uint32_t *cursor);
+
+/* 確定済みレコードを CDC に出力(1行/フレーム，stage ごとの FRAME_END からの経過 us) */
+void latency_trace_log_cdc(void);
+
+#else
+
+static inline void latency_trace_init(void)
+{
+}
+
+static inline uint32_t latency_trace_now(void)
+{
+    return 0U;
+}
+
+static inline void latency_trace_open(uint32_t frame_seq)
+{
+    (void)frame_seq;
+}
+
+static inline void latency_trace_stamp_at(uint32_t frame_seq, latency_stage_t stage, uint32_t cyc)
+{
+    (void)frame_seq;
+    (void)stage;
+    (void)cyc;
+}
+
+static inline void latency_trace_stamp(uint32_t frame_seq, latency_stage_t stage)
+{
+    (void)frame_seq;
+    (void)stage;
+}
+
+static inline uint32_t latency_trace_read(latency_trace_record_t *out, uint32_t max, uint32_t *cursor)
+{
+    (void)out;
+    (void)max;
+    (void)cursor;
+    return 0U;
+}
+
+static inline void latency_trace_log_cdc(void)
+{
+}
+
+#endif
@@ -15,6 +15,10 @@
 #include "video_frame_buffer.h"
 #include "verify_mode.h"
 #include "motor_control.h"
+#include "latency_trace.h"
+#include "prof.h"
+#include "binlog.h"
+#include "synth_frame.h"
 
 /* Published HyperRAM base offset for the most recently written camera frame. */
 volatile uint32_t g_video_frame_base_offset = (uint32_t)VIDEO_FRAME_BASE_OFFSET_DEFAULT;
@@ -22,6 +26,30 @@ volatile uint32_t g_video_frame_base_offset = (uint32_t)VIDEO_FRAME_BASE_OFFSET_
 /* Published monotonic sequence for the most recently written camera frame. */
 volatile uint32_t g_video_frame_seq = 0;
 
+/* Descriptor of the published frame (size/format/mode). Written before g_video_frame_seq. */
+volatile video_frame_desc_t g_video_frame_desc = {0U};
+
+/* Seqlock generation for (desc, base, seq); odd while video_frame_publish() is writing. */
+volatile uint32_t g_video_frame_pub_gen = 0;
+
+/*
+ * (desc, base, seq) を1組として公開する．書き手は Thread0 だけ．
+ * 奇数の間は読み手(video_frame_snapshot)が取り直す．ストア数個なのでクリティカル区間で囲み，
+ * 優先度の高い読み手が奇数のまま回り続けることもないようにする．
+ */
+static void video_frame_publish(const video_frame_desc_t *desc, uint32_t base, uint32_t seq)
+{
+    taskENTER_CRITICAL();
+    g_video_frame_pub_gen++;
+    __DMB();
+    g_video_frame_desc = *desc;
+    g_video_frame_base_offset = base;
+    g_video_frame_seq = seq;
+    __DMB();
+    g_video_frame_pub_gen++;
+    taskEXIT_CRITICAL();
+}
+
 // #define VGA_WIDTH (256)
 // #define VGA_HEIGHT (256)
 // #define BYTE_PER_PIXEL (2)
@@ -29,11 +57,32 @@ volatile uint32_t g_video_frame_seq = 0;
 /*
  * Camera capture pacing (ms).
  * NOTE: This is the dominant contributor to the perceived “shutter interval”.
+ * ピンポンでも既定は周期付き．0(センサ律速)にすると VIDEO_FRAME_BASE_OFFSET_STEP=0 では
+ * 同じ HyperRAM スロットを毎フレーム上書きするので，Thread3/Thread1 が読んでいる途中の
+ * 画素が書き換わる(seqlock が守るのは desc/base/seq だけ)．
  */
 #ifndef CAMERA_CAPTURE_INTERVAL_MS
 #define CAMERA_CAPTURE_INTERVAL_MS (100)
 #endif
 
+/* ピンポンキャプチャ：1フレーム待ちのタイムアウト(ms) */
+#ifndef CAM_CAPTURE_TIMEOUT_MS
+#define CAM_CAPTURE_TIMEOUT_MS (500)
+#endif
+
+/* ピンポンキャプチャ統計(fps / Thread0 待ち率 / flush時間)のログ周期[frame]．0で無効 */
+#ifndef CAM_STATS_LOG_PERIOD
+#define CAM_STATS_LOG_PERIOD (100U)
+#endif
+
+#if CAM_SYNTH_ENABLE && ((SYNTH_FRAME_W > VIDEO_FRAME_MAX_W) || (SYNTH_FRAME_H > VIDEO_FRAME_MAX_H) || \
+                         ((SYNTH_FRAME_W * SYNTH_FRAME_H) > VIDEO_FRAME_MAX_PIXELS) || ((SYNTH_FRAME_W % 4U) != 0U))
+#error "SYNTH_FRAME_W/H must fit VIDEO_FRAME_MAX_W/H/PIXELS (and W must be a multiple of 4)"
+#endif
+#if CAM_SYNTH_ENABLE && CAM_BAND_STREAM_ENABLE
+#error "CAM_SYNTH_ENABLE does not feed the band stream; set CAM_BAND_STREAM_ENABLE=0"
+#endif
+
 #define RAM_DATA_LENGTH (64U) //
 // void putchar_ra8usb(uint8_t c);
 
@@ -183,6 +232,17 @@ void mypwm_init()
     // fsp_err_t err = R_GPT_DutyCycleSet(&g_timer1_ctrl, duty_cycle_counts, GPT_IO_PIN_GTIOCB);
     // assert(FSP_SUCCESS == err);
 }
+/* 起動(スケジューラ開始)から最初のフレーム公開までの時間を1回だけ出す */
+static void boot_log_first_frame(void)
+{
+    static bool s_logged = false;
+    if (!s_logged)
+    {
+        s_logged = true;
+        xprintf("[BOOT] first frame %dms\n", (int)((uint32_t)xTaskGetTickCount() * portTICK_PERIOD_MS));
+    }
+}
+
 /* Main Thread entry function */
 /* pvParameters contains TaskHandle_t */
 
@@ -201,15 +261,33 @@ void main_thread0_entry(void *pvParameters)
         vTaskDelay(pdMS_TO_TICKS(1000));
     }
 #endif
+    latency_trace_init();
+    prof_init();
+    hyperram_register_caller(HYPERRAM_CALLER_CAPTURE);
+    (void)binlog_register_thread("T0");
+
     // init DVP camera
     mypwm_init();
     motor_control_start();
+#if CAM_SYNTH_ENABLE
+    /* 合成フレーム：カメラは初期化しない */
+    {
+        const video_frame_desc_t synth_desc =
+            video_frame_desc_make(SYNTH_FRAME_W, SYNTH_FRAME_H, (uint32_t)CAM_MODE_QVGA);
+        video_frame_publish(&synth_desc, g_video_frame_base_offset, g_video_frame_seq);
+    }
+    xprintf("[SYNTH] %dx%d pattern=%s interval=%dms\n", (int)SYNTH_FRAME_W, (int)SYNTH_FRAME_H,
+            synth_pattern_name(synth_frame_get_pattern()), (int)SYNTH_FRAME_INTERVAL_MS);
+#else
+    const TickType_t boot_cam_t0 = xTaskGetTickCount();
     cam_init(DEV_OV5642);
-    xprintf("Camera Ready\n");
+    video_frame_publish(cam_frame_desc(), g_video_frame_base_offset, g_video_frame_seq);
+    xprintf("Camera Ready (%dms)\n", (int)((uint32_t)(xTaskGetTickCount() - boot_cam_t0) * portTICK_PERIOD_MS));
     // capture from camera
     vTaskDelay(pdMS_TO_TICKS(200));
     cam_capture();
     // cam_close();
+#endif
 
     ospi_b_dma_sent = false;
     // xprintf("!srt\n");
@@ -232,35 +310,243 @@ void main_thread0_entry(void *pvParameters)
 
     uint32_t next_write_base = video_frame_align_u32((uint32_t)VIDEO_FRAME_BASE_OFFSET_DEFAULT);
 
+#if CAM_SYNTH_ENABLE
+    /*
+     * 合成フレーム：cam_capture() の代わりに synth_frame_render() で取り込みバッファを埋め，
+     * 以降はカメラと同じ変換・公開手順(desc → base → seq)をたどる．
+     */
+    const video_frame_desc_t desc = video_frame_desc_make(SYNTH_FRAME_W, SYNTH_FRAME_H, (uint32_t)CAM_MODE_QVGA);
+    uint32_t frame_index = 0U;
+    uint32_t st_frames = 0U;
+    TickType_t st_t0 = xTaskGetTickCount();
+    TickType_t st_render = 0;
+    TickType_t st_store = 0;
+    TickType_t last_start = xTaskGetTickCount();
+
     while (1)
     {
-        // カメラキャプチャ実行
-        cam_capture();
+        const uint32_t frame_seq = g_video_frame_seq + 1U;
+        latency_trace_open(frame_seq);
+
+        const TickType_t t0 = xTaskGetTickCount();
+        synth_frame_render(image_p8, SYNTH_FRAME_W, SYNTH_FRAME_H, frame_index++);
+        latency_trace_stamp(frame_seq, LATENCY_STAGE_CEU_FRAME_END);
+        const TickType_t t1 = xTaskGetTickCount();
+
+        err = cam_store_frame_hyperram(image_p8, next_write_base, &desc);
+        if (FSP_SUCCESS != err)
+        {
+            xprintf("[OSPI] HyperRAM write error!\n");
+        }
+        else
+        {
+            video_frame_publish(&desc, next_write_base, frame_seq);
+            latency_trace_stamp(frame_seq, LATENCY_STAGE_HYPERRAM_PUBLISH);
+            boot_log_first_frame();
+            next_write_base = video_frame_next_base_u32(next_write_base, (uint32_t)CAM_FRAME_BYTES);
+        }
+        st_render += (TickType_t)(t1 - t0);
+        st_store += (TickType_t)(xTaskGetTickCount() - t1);
+        st_frames++;
 
-        // HyperRAMに書き込み(動画ストリーミング用)
-        const uint32_t frame_bytes = (uint32_t)(VGA_WIDTH * VGA_HEIGHT * BYTE_PER_PIXEL);
+#if (CAM_STATS_LOG_PERIOD > 0U)
+        if (st_frames >= (uint32_t)CAM_STATS_LOG_PERIOD)
+        {
+            const uint32_t span_ms = (uint32_t)(xTaskGetTickCount() - st_t0) * portTICK_PERIOD_MS;
+            if (span_ms > 0U)
+            {
+                const uint32_t fps_x100 = (st_frames * 100000U) / span_ms;
+                xprintf("[SYNTH] fps=%d.%02d render=%dms store=%dms pattern=%s\n",
+                        (int)(fps_x100 / 100U), (int)(fps_x100 % 100U),
+                        (int)(((uint32_t)st_render * portTICK_PERIOD_MS) / st_frames),
+                        (int)(((uint32_t)st_store * portTICK_PERIOD_MS) / st_frames),
+                        synth_pattern_name(synth_frame_get_pattern()));
+            }
+            st_frames = 0U;
+            st_render = 0;
+            st_store = 0;
+            st_t0 = xTaskGetTickCount();
+        }
+#endif
+#if LATENCY_TRACE_CDC_ENABLE
+        latency_trace_log_cdc();
+#endif
+
+#if (SYNTH_FRAME_INTERVAL_MS > 0)
+        vTaskDelayUntil(&last_start, pdMS_TO_TICKS(SYNTH_FRAME_INTERVAL_MS));
+#else
+        /* 周期指定なし：同優先度以下のスレッドへ1 tick だけ譲る */
+        (void)last_start;
+        vTaskDelay(1);
+#endif
+    }
+#elif CAM_PINGPONG_ENABLE
+    /*
+     * ピンポンキャプチャ：
+     *   wait(buf[cur]) → start(buf[cur^1]) → flush(buf[cur]) → wait ...
+     * CEU が次フレームを取り込んでいる間に前フレームを HyperRAM へ書き出す．
+     * 待ちはタスク通知でブロックするので，その間 CPU は他スレッドに回る．
+     */
+    uint8_t *const cam_buf[2] = {g_image_qvga_sram, g_image_qvga_sram_b};
+    uint32_t buf_base[2] = {0U, 0U}; // 各バッファの HyperRAM 書き出し先
+    uint32_t buf_seq[2] = {0U, 0U};  // 書き出し完了時に公開する seq
+    video_frame_desc_t buf_desc[2];  // 各バッファを取り込んだときのモード
+    uint32_t cur = 0U;
+    uint32_t capture_seq = g_video_frame_seq;
+
+    uint32_t st_frames = 0U;
+    uint32_t st_errors = 0U;
+    uint32_t fail_run = 0U; // 連続して取り込めなかった回数
+    TickType_t st_t0 = xTaskGetTickCount();
+    TickType_t st_wait = 0;
+    TickType_t st_flush = 0;
+    TickType_t last_start = xTaskGetTickCount();
+
+    cam_capture_notify_set(xTaskGetCurrentTaskHandle());
+    buf_base[cur] = next_write_base;
+    buf_seq[cur] = ++capture_seq;
+    buf_desc[cur] = *cam_frame_desc();
+#if CAM_BAND_STREAM_ENABLE
+    cam_band_frame_begin(cam_buf[cur], buf_base[cur], buf_seq[cur]);
+#endif
+    latency_trace_open(buf_seq[cur]);
+    (void)cam_capture_start(cam_buf[cur]);
+
+    while (1)
+    {
+        const TickType_t tw0 = xTaskGetTickCount();
+        const bool ok = cam_capture_wait(pdMS_TO_TICKS(CAM_CAPTURE_TIMEOUT_MS));
+        const TickType_t tw1 = xTaskGetTickCount();
+        st_wait += (TickType_t)(tw1 - tw0);
 
-        err = hyperram_b_write(image_p8, (void *)next_write_base, frame_bytes);
+        if (!ok)
+        {
+            /* エラー/タイムアウト：同じバッファへ取り直す(モード切替要求があればここで適用) */
+            st_errors++;
+            fail_run++;
+            (void)cam_apply_pending_mode();
+            buf_desc[cur] = *cam_frame_desc();
+#if CAM_BAND_STREAM_ENABLE
+            cam_band_frame_begin(cam_buf[cur], buf_base[cur], buf_seq[cur]);
+#endif
+            latency_trace_open(buf_seq[cur]);
+            const fsp_err_t restart_err = cam_capture_restart(cam_buf[cur]);
+            /* 続けて失敗している間は 1, 2, 4, 8, ... 回目だけ出す */
+            if ((FSP_SUCCESS != restart_err) || ((fail_run & (fail_run - 1U)) == 0U))
+            {
+                xprintf("[Camera] capture failed %u times in a row, restart err=%d\n", (unsigned)fail_run,
+                        (int)restart_err);
+            }
+            last_start = xTaskGetTickCount();
+            continue;
+        }
+        fail_run = 0U;
+
+        const uint32_t done = cur;
+        latency_trace_stamp_at(buf_seq[done], LATENCY_STAGE_CEU_FRAME_END, cam_frame_end_cycles());
+        cur ^= 1U;
+        next_write_base = video_frame_next_base_u32(next_write_base, (uint32_t)CAM_FRAME_BYTES);
+        buf_base[cur] = next_write_base;
+        buf_seq[cur] = ++capture_seq;
+
+        /* モード切替はフレームの切れ目(CEU 停止中)でだけ行う．取り込み済みの done は元のサイズのまま */
+        (void)cam_apply_pending_mode();
+        buf_desc[cur] = *cam_frame_desc();
+
+#if (CAMERA_CAPTURE_INTERVAL_MS > 0)
+        /* フレーム間隔指定時は次の取り込み開始を周期に合わせる(HyperRAM競合の軽減) */
+        vTaskDelayUntil(&last_start, pdMS_TO_TICKS(CAMERA_CAPTURE_INTERVAL_MS));
+#endif
+#if CAM_BAND_STREAM_ENABLE
+        cam_band_frame_begin(cam_buf[cur], buf_base[cur], buf_seq[cur]);
+#endif
+        latency_trace_open(buf_seq[cur]);
+        (void)cam_capture_start(cam_buf[cur]);
+        last_start = xTaskGetTickCount();
+
+        // HyperRAMに書き込み(次フレームの取り込みと並行，VIDEO_FRAME_FORMAT に変換)
+        err = cam_store_frame_hyperram(cam_buf[done], buf_base[done], &buf_desc[done]);
         if (FSP_SUCCESS != err)
         {
             xprintf("[OSPI] HyperRAM write error!\n");
         }
         else
         {
-            /* Publish the base where this frame now lives. */
-            g_video_frame_base_offset = next_write_base;
+            /* Publish the base (and size) where this frame now lives, and its completion
+             * (lets consumers avoid mid-write reads).
+             * seq はキャプチャ開始時に割り当て済み(帯ストリーミングの p/q と一致させる)．
+             */
+            video_frame_publish(&buf_desc[done], buf_base[done], buf_seq[done]);
+            latency_trace_stamp(buf_seq[done], LATENCY_STAGE_HYPERRAM_PUBLISH);
+            boot_log_first_frame();
+        }
+        st_flush += (TickType_t)(xTaskGetTickCount() - last_start);
+        st_frames++;
+
+#if (CAM_STATS_LOG_PERIOD > 0U)
+        if (st_frames >= (uint32_t)CAM_STATS_LOG_PERIOD)
+        {
+            const uint32_t span_ms = (uint32_t)(xTaskGetTickCount() - st_t0) * portTICK_PERIOD_MS;
+            if (span_ms > 0U)
+            {
+                const uint32_t fps_x100 = (st_frames * 100000U) / span_ms;
+                const uint32_t wait_pct = ((uint32_t)st_wait * portTICK_PERIOD_MS * 100U) / span_ms;
+                xprintf("[CAM] fps=%d.%02d wait(idle)=%d%% flush=%dms/frame err=%d\n",
+                        (int)(fps_x100 / 100U), (int)(fps_x100 % 100U),
+                        (int)wait_pct,
+                        (int)(((uint32_t)st_flush * portTICK_PERIOD_MS) / st_frames),
+                        (int)st_errors);
+            }
+            st_frames = 0U;
+            st_errors = 0U;
+            st_wait = 0;
+            st_flush = 0;
+            st_t0 = xTaskGetTickCount();
+        }
+#endif
+#if LATENCY_TRACE_CDC_ENABLE
+        latency_trace_log_cdc();
+#endif
+    }
+#else
+    while (1)
+    {
+        // カメラキャプチャ実行(モード切替要求があれば取り込み前に適用)
+        (void)cam_apply_pending_mode();
+        const video_frame_desc_t desc = *cam_frame_desc();
+        const uint32_t frame_seq = g_video_frame_seq + 1U;
+        latency_trace_open(frame_seq);
+        cam_capture();
+        latency_trace_stamp_at(frame_seq, LATENCY_STAGE_CEU_FRAME_END, cam_frame_end_cycles());
 
-            /* Publish frame completion (lets consumers avoid mid-write reads). */
-            g_video_frame_seq++;
+        // HyperRAMに書き込み(動画ストリーミング用，VIDEO_FRAME_FORMAT に変換)
+        err = cam_store_frame_hyperram(image_p8, next_write_base, &desc);
+        if (FSP_SUCCESS != err)
+        {
+            xprintf("[OSPI] HyperRAM write error!\n");
+        }
+        else
+        {
+            /* Publish the base (and size) where this frame now lives, and its completion
+             * (lets consumers avoid mid-write reads).
+             */
+            video_frame_publish(&desc, next_write_base, frame_seq);
+            latency_trace_stamp(frame_seq, LATENCY_STAGE_HYPERRAM_PUBLISH);
+            boot_log_first_frame();
 
             /* Advance the write base for the next frame (optional). */
-            next_write_base = video_frame_next_base_u32(next_write_base, frame_bytes);
+            next_write_base = video_frame_next_base_u32(next_write_base, (uint32_t)CAM_FRAME_BYTES);
         }
 
+#if LATENCY_TRACE_CDC_ENABLE
+        latency_trace_log_cdc();
+#endif
+
         // フレーム間隔：動画ストリーミングのフレームレートに合わせる
         // 500msに変更してHyperRAM競合を軽減
         vTaskDelay(pdMS_TO_TICKS(CAMERA_CAPTURE_INTERVAL_MS));
     }
+#endif
 
     ////////////////////////////
     // xprintf("[OSPI] write end\n");
@@ -4,6 +4,10 @@
 #include "hyperram_integ.h"
 #include "video_frame_buffer.h"
 #include "verify_mode.h"
+#include "latency_trace.h"
+#include "prof.h"
+#include "cam.h"
+#include "synth_frame.h"
 
 #include "lwip/tcpip.h"
 #include "lwip/netif.h"
@@ -17,6 +21,7 @@
 #endif
 
 #include <stdint.h>
+#include <string.h>
 
 #include "ra/fsp/src/bsp/mcu/all/bsp_io.h"
 
@@ -85,6 +90,7 @@ static inline void reorder_grayscale_4px(uint8_t *buf, uint32_t n)
 #endif
 }
 
+#if (VIDEO_FRAME_FORMAT == VIDEO_FRAME_FMT_UYVY)
 static void extract_y_from_yuv422(const uint8_t *yuv, uint8_t *y_out, uint32_t y_bytes, yuv422_order_t order)
 {
     /* y_bytes must be even: 2 pixels at a time */
@@ -125,12 +131,11 @@ static void extract_y_from_yuv422(const uint8_t *yuv, uint8_t *y_out, uint32_t y
 
     reorder_grayscale_4px(y_out, y_bytes);
 }
+#endif
 
 #define UDP_PORT_DEST 9000
-#define FRAME_SIZE (320 * 240 * 2)    // YUV422 = 2 bytes/pixel
-#define MONO_OFFSET FRAME_SIZE        // モノクロ画像オフセット
-#define GRADIENT_OFFSET FRAME_SIZE    // p,q勾配マップオフセット(MONO_OFFSETと同じ位置)
-#define DEPTH_OFFSET (FRAME_SIZE * 2) // 深度マップオフセット(8bit grayscale: 320×240 = 76,800バイト)
+#define GRADIENT_OFFSET VIDEO_FRAME_GRADIENT_OFFSET // p,q勾配マップオフセット(Thread3 と共有)
+#define DEPTH_OFFSET VIDEO_FRAME_DEPTH_OFFSET       // 深度マップオフセット(8bit grayscale: width×height)
 
 /*
  * UDP pacing:
@@ -146,20 +151,35 @@ static void extract_y_from_yuv422(const uint8_t *yuv, uint8_t *y_out, uint32_t y
 #define UDP_FRAME_INTERVAL_MS 5
 #endif
 
+/*
+ * チャンクヘッダーにフレーム番号(frame_seq)を載せる．
+ * 1: 28 bytes ヘッダー(magic 0x12345679)．受信側はフレーム番号ごとに複数フレームを
+ *    並行して組み立てられるので，chunk 0 の順序入れ替え/欠落で前後のフレームを壊さない．
+ * 0: 従来の 24 bytes ヘッダー(magic 0x12345678)
+ */
+#ifndef UDP_PHOTO_HEADER_SEQ
+#define UDP_PHOTO_HEADER_SEQ 1
+#endif
+
+#if UDP_PHOTO_HEADER_SEQ
+#define UDP_PHOTO_MAGIC (0x12345679U)
+#else
+#define UDP_PHOTO_MAGIC (0x12345678U)
+#endif
+
 // ---- Optional debug: select what to stream in video mode ----
 // 0: normal grayscale (Y)
 // 1: stream p (dx) from Thread3 PQ128 buffer
 // 2: stream q (dy) from Thread3 PQ128 buffer
-// 3: stream depth (u8 320x240) from Thread3 FC output
+// 3: stream depth (u8 width x height) from Thread3 FC output
 #ifndef UDP_VIDEO_SOURCE
-#define UDP_VIDEO_SOURCE 3 // default: depth (u8 320x240)
+#define UDP_VIDEO_SOURCE 3 // default: depth (u8 width x height)
 #endif
 
+/* PQ128 の ROI はフレーム中央(原点はフレームのディスクリプタから求める) */
 #define PQ128_SIZE (128)
-#define PQ128_X0 ((320 - PQ128_SIZE) / 2)
-#define PQ128_Y0 ((240 - PQ128_SIZE) / 2)
 #define PQ128_PLANE_BYTES ((uint32_t)(PQ128_SIZE * PQ128_SIZE * (uint32_t)sizeof(int16_t)))
-#define PQ128_P_OFFSET (FRAME_SIZE) /* same as GRADIENT_OFFSET in Thread3 */
+#define PQ128_P_OFFSET (GRADIENT_OFFSET) /* same as GRADIENT_OFFSET in Thread3 */
 #define PQ128_Q_OFFSET (PQ128_P_OFFSET + PQ128_PLANE_BYTES)
 
 static inline uint8_t pq16_to_u8(int16_t v)
@@ -173,7 +193,7 @@ static inline uint8_t pq16_to_u8(int16_t v)
     return (uint8_t)x;
 }
 
-static void fill_pq_debug_chunk(uint8_t *out, uint32_t out_bytes, uint32_t pixel_base)
+static void fill_pq_debug_chunk(uint8_t *out, uint32_t out_bytes, uint32_t pixel_base, const video_frame_desc_t *desc)
 {
     // If PQ isn't ready, paint mid-gray.
     uint32_t seq = g_pq128_seq;
@@ -184,29 +204,33 @@ static void fill_pq_debug_chunk(uint8_t *out, uint32_t out_bytes, uint32_t pixel
         return;
     }
 
+    const uint32_t w = (uint32_t)desc->width;
+    const uint32_t h = (uint32_t)desc->height;
+    const uint32_t x0 = (w - (uint32_t)PQ128_SIZE) / 2U;
+    const uint32_t y0 = (h - (uint32_t)PQ128_SIZE) / 2U;
     int16_t row_buf[PQ128_SIZE];
     int cached_ry = -1;
 
     for (uint32_t i = 0; i < out_bytes; i++)
     {
         uint32_t pix = pixel_base + i;
-        uint32_t x = pix % 320U;
-        uint32_t y = pix / 320U;
-        if (y >= 240U)
+        uint32_t x = pix % w;
+        uint32_t y = pix / w;
+        if (y >= h)
         {
             out[i] = 128;
             continue;
         }
 
-        if (x < (uint32_t)PQ128_X0 || x >= (uint32_t)(PQ128_X0 + PQ128_SIZE) ||
-            y < (uint32_t)PQ128_Y0 || y >= (uint32_t)(PQ128_Y0 + PQ128_SIZE))
+        if (x < x0 || x >= (x0 + (uint32_t)PQ128_SIZE) ||
+            y < y0 || y >= (y0 + (uint32_t)PQ128_SIZE))
         {
             out[i] = 128;
             continue;
         }
 
-        int rx = (int)x - PQ128_X0;
-        int ry = (int)y - PQ128_Y0;
+        int rx = (int)(x - x0);
+        int ry = (int)(y - y0);
         if (ry != cached_ry)
         {
             uint32_t row_off = (uint32_t)ry * (uint32_t)PQ128_SIZE * (uint32_t)sizeof(int16_t);
@@ -222,11 +246,14 @@ static void fill_pq_debug_chunk(uint8_t *out, uint32_t out_bytes, uint32_t pixel
 // UDP写真データチャンクヘッダー
 typedef struct __attribute__((packed))
 {
-    uint32_t magic_number;    // マジックナンバー (0x12345678)
+    uint32_t magic_number;    // マジックナンバー (UDP_PHOTO_MAGIC)
     uint32_t total_size;      // 写真データの総サイズ
     uint32_t chunk_index;     // 現在のチャンクインデックス (0から開始)
     uint32_t total_chunks;    // 総チャンク数
     uint32_t chunk_offset;    // このチャンクのオフセット(バイト)
+#if UDP_PHOTO_HEADER_SEQ
+    uint32_t frame_seq; // 送信フレーム番号(フレームごとに +1，写真モードは 0)
+#endif
     uint16_t chunk_data_size; // このチャンクのデータサイズ
     uint16_t checksum;        // ヘッダーのチェックサム
 } udp_photo_header_t;
@@ -256,8 +283,9 @@ typedef struct
     uint32_t frame_interval_ms; // フレーム間の待機時間
     bool is_frame_complete;
 
-    /* HyperRAM base offset for the current video frame (snapshotted). */
+    /* HyperRAM base offset and size of the current video frame (snapshotted together). */
     uint32_t frame_base_offset;
+    video_frame_desc_t frame_desc;
 
     /*
      * For depth streaming, keep the last completed depth buffer snapshot.
@@ -266,9 +294,26 @@ typedef struct
     uint32_t depth_base_offset;
     uint32_t depth_seq_snapshot;
     uint32_t depth_size_snapshot;
+
+    /* Source frame seq of the frame being streamed (latency trace). */
+    uint32_t trace_seq;
 } udp_send_ctx_t;
 static void udp_send_timer_cb(void *arg);
 
+/* 公開中フレームの base とディスクリプタを取り，送信サイズ(グレースケール w*h)を合わせる */
+static void udp_snapshot_video_frame(udp_send_ctx_t *ctx)
+{
+    video_frame_desc_t d;
+    uint32_t base;
+    (void)video_frame_snapshot(&base, &d);
+    ctx->frame_base_offset = base;
+    if ((d.width != 0U) && (d.height != 0U))
+    {
+        ctx->frame_desc = d;
+        ctx->photo_size = (uint32_t)d.width * (uint32_t)d.height;
+    }
+}
+
 // ヘッダーチェックサム計算
 static uint16_t calc_header_checksum(udp_photo_header_t *header)
 {
@@ -306,6 +351,30 @@ static void udp_rx_cb(void *arg, struct udp_pcb *upcb, struct pbuf *p,
         return;
     }
 
+#if CAM_SYNTH_ENABLE && SYNTH_UPLOAD_ENABLE
+    /* 合成フレームのアップロード("SYNF" チャンク)：数が多いのでログを出さずに取り込む */
+    if (p->tot_len >= SYNTH_UPLOAD_HEADER_BYTES)
+    {
+        static uint8_t s_synth_pkt[1500];
+        const u16_t n = pbuf_copy_partial(p, s_synth_pkt,
+                                          (p->tot_len < sizeof(s_synth_pkt)) ? p->tot_len : (u16_t)sizeof(s_synth_pkt), 0);
+        if ((n >= SYNTH_UPLOAD_HEADER_BYTES) && (memcmp(s_synth_pkt, "SYNF", 4) == 0))
+        {
+            const int rc = synth_frame_upload(s_synth_pkt, n);
+            if (rc < 0)
+            {
+                xprintf("[SYNTH] upload rejected len=%u\n", n);
+            }
+            else if (rc > 0)
+            {
+                xprintf("[SYNTH] upload frame complete\n");
+            }
+            pbuf_free(p);
+            return;
+        }
+    }
+#endif
+
     char head[65] = {0};
     u16_t cpy = (p->tot_len < 64) ? p->tot_len : 64;
     /* p->payload は線形とは限らないが，ここでは小さく読むだけなので p->payload を直接 */
@@ -314,8 +383,218 @@ static void udp_rx_cb(void *arg, struct udp_pcb *upcb, struct pbuf *p,
     xprintf("[UDP RX] %s:%u len=%u data=\"%s\"\n",
             ip4addr_ntoa(ip_2_ip4(addr)), port, p->tot_len, head);
 
+    /* "CAM MODE <qvga|win256|center>": Thread0 が次のフレーム境界で切り替える */
+    if (strncmp(head, "CAM MODE ", 9) == 0)
+    {
+        const cam_mode_t mode = cam_mode_from_name(&head[9]);
+        if (mode != CAM_MODE_COUNT)
+        {
+            cam_request_mode(mode);
+        }
+        else
+        {
+            xprintf("[UDP RX] unknown camera mode\n");
+        }
+    }
+#if CAM_SYNTH_ENABLE
+    /* "SYNTH <gradient|sphere|checker|upload>": 次のフレームから合成パターンを切り替える */
+    else if (strncmp(head, "SYNTH ", 6) == 0)
+    {
+        const synth_pattern_t pattern = synth_pattern_from_name(&head[6]);
+        if (pattern != SYNTH_PATTERN_COUNT)
+        {
+            synth_frame_set_pattern(pattern);
+        }
+        else
+        {
+            xprintf("[UDP RX] unknown synth pattern\n");
+        }
+    }
+#endif
+    /* "PROF RESET": プロファイラと HyperRAM の呼び出し元統計の累積値を 0 に戻す */
+    else if (strncmp(head, "PROF RESET", 10) == 0)
+    {
+        prof_reset();
+        hyperram_caller_stats_reset();
+    }
+
+    pbuf_free(p);
+}
+
+#if LATENCY_TRACE_ENABLE && LATENCY_TRACE_UDP_ENABLE
+/*
+ * 確定済みの遅延トレースを1パケットで送る(映像と同じ宛先，magic で区別)．
+ * 受信側: matlab/latency_trace_histogram.m
+ */
+#ifndef LATENCY_TRACE_UDP_MAX_RECORDS
+#define LATENCY_TRACE_UDP_MAX_RECORDS (8U)
+#endif
+
+static void udp_send_latency_trace(udp_send_ctx_t *ctx)
+{
+    static uint32_t s_cursor = 0U;
+    latency_trace_record_t recs[LATENCY_TRACE_UDP_MAX_RECORDS];
+
+    const uint32_t n = latency_trace_read(recs, (uint32_t)LATENCY_TRACE_UDP_MAX_RECORDS, &s_cursor);
+    if (n == 0U)
+    {
+        return;
+    }
+
+    latency_trace_udp_header_t hdr;
+    hdr.magic = LATENCY_TRACE_UDP_MAGIC;
+    hdr.cpu_hz = SystemCoreClock;
+    hdr.stage_count = (uint16_t)LATENCY_STAGE_COUNT;
+    hdr.record_count = (uint16_t)n;
+
+    const size_t body = (size_t)n * sizeof(latency_trace_record_t);
+    struct pbuf *p = pbuf_alloc(PBUF_TRANSPORT, (u16_t)(sizeof(hdr) + body), PBUF_RAM);
+    if (!p)
+    {
+        return; // 次フレームでまとめて送る分は失われる(ホスト側で欠番扱い)
+    }
+    memcpy(p->payload, &hdr, sizeof(hdr));
+    memcpy((uint8_t *)p->payload + sizeof(hdr), recs, body);
+    (void)udp_sendto(ctx->pcb, p, &ctx->dest_ip, ctx->port);
+    pbuf_free(p);
+}
+#else
+#undef LATENCY_TRACE_UDP_ENABLE
+#define LATENCY_TRACE_UDP_ENABLE (0)
+#endif
+
+#if PROF_ENABLE && PROF_UDP_ENABLE
+/*
+ * プロファイラのスナップショットを PROF_UDP_PERIOD_MS ごとに送る(映像と同じ宛先，magic で区別)．
+ * 1パケット PROF_UDP_SPANS_PER_PACKET 個の span に分け，同じ snap_seq を付ける．
+ * 受信側: matlab/prof_telemetry_plot.m
+ */
+static void udp_send_prof_snapshot(udp_send_ctx_t *ctx)
+{
+    static TickType_t s_last_tick = 0;
+    static uint32_t s_snap_seq = 0U;
+    static prof_span_stats_t s_spans[PROF_SPAN_COUNT]; // tcpip_thread のスタックに載せない
+    uint32_t counters[PROF_CTR_COUNT];
+
+    const TickType_t now = xTaskGetTickCount();
+    if ((s_snap_seq != 0U) && ((TickType_t)(now - s_last_tick) < pdMS_TO_TICKS(PROF_UDP_PERIOD_MS)))
+    {
+        return;
+    }
+    s_last_tick = now;
+    s_snap_seq++;
+
+    prof_snapshot(s_spans, counters);
+
+    prof_udp_header_t hdr;
+    hdr.magic = PROF_UDP_MAGIC;
+    hdr.cpu_hz = SystemCoreClock;
+    hdr.snap_seq = s_snap_seq;
+    hdr.uptime_ms = (uint32_t)now * (uint32_t)portTICK_PERIOD_MS;
+    hdr.span_count = (uint8_t)PROF_SPAN_COUNT;
+    hdr.counter_count = (uint8_t)PROF_CTR_COUNT;
+    hdr.hist_buckets = (uint8_t)PROF_HIST_BUCKETS;
+    hdr.hist_shift = (uint8_t)PROF_HIST_SHIFT;
+    hdr.reserved = 0U;
+
+    const size_t rec_bytes = (5U + (size_t)PROF_HIST_BUCKETS) * sizeof(uint32_t);
+    for (uint32_t first = 0U; first < (uint32_t)PROF_SPAN_COUNT; first += (uint32_t)PROF_UDP_SPANS_PER_PACKET)
+    {
+        const uint32_t left = (uint32_t)PROF_SPAN_COUNT - first;
+        const uint32_t n = (left < (uint32_t)PROF_UDP_SPANS_PER_PACKET) ? left : (uint32_t)PROF_UDP_SPANS_PER_PACKET;
+        hdr.first_span = (uint8_t)first;
+        hdr.n_spans = (uint8_t)n;
+
+        const size_t len = sizeof(hdr) + sizeof(counters) + (size_t)n * rec_bytes;
+        struct pbuf *p = pbuf_alloc(PBUF_TRANSPORT, (u16_t)len, PBUF_RAM);
+        if (!p)
+        {
+            return; // 値は累積なので，欠けた分は次の周期で埋まる
+        }
+        uint8_t *w = (uint8_t *)p->payload;
+        memcpy(w, &hdr, sizeof(hdr));
+        w += sizeof(hdr);
+        memcpy(w, counters, sizeof(counters));
+        w += sizeof(counters);
+        for (uint32_t i = 0U; i < n; i++)
+        {
+            const prof_span_stats_t *sp = &s_spans[first + i];
+            const uint32_t head[5] = {sp->count, sp->min, sp->max, (uint32_t)sp->sum, (uint32_t)(sp->sum >> 32)};
+            memcpy(w, head, sizeof(head));
+            w += sizeof(head);
+            memcpy(w, sp->hist, sizeof(sp->hist));
+            w += sizeof(sp->hist);
+        }
+        (void)udp_sendto(ctx->pcb, p, &ctx->dest_ip, ctx->port);
+        pbuf_free(p);
+    }
+}
+#else
+#undef PROF_UDP_ENABLE
+#define PROF_UDP_ENABLE (0)
+#endif
+
+#if HYPERRAM_STATS_ENABLE && HYPERRAM_STATS_UDP_ENABLE
+/*
+ * HyperRAM の呼び出し元ごとの統計を HYPERRAM_STATS_UDP_PERIOD_MS ごとに送る(映像と同じ宛先，magic で区別)．
+ * 受信側: matlab/hyperram_bus_stats.m
+ */
+static void udp_send_hyperram_stats(udp_send_ctx_t *ctx)
+{
+    static TickType_t s_last_tick = 0;
+    static bool s_sent = false;
+
+    const TickType_t now = xTaskGetTickCount();
+    if (s_sent && ((TickType_t)(now - s_last_tick) < pdMS_TO_TICKS(HYPERRAM_STATS_UDP_PERIOD_MS)))
+    {
+        return;
+    }
+    s_last_tick = now;
+    s_sent = true;
+
+    hyperram_stats_udp_header_t hdr;
+    hdr.magic = HYPERRAM_STATS_UDP_MAGIC;
+    hdr.cpu_hz = SystemCoreClock;
+    hdr.uptime_ms = (uint32_t)now * (uint32_t)portTICK_PERIOD_MS;
+    hdr.caller_count = (uint16_t)HYPERRAM_CALLER_COUNT;
+    hdr.word_count = (uint16_t)HYPERRAM_STATS_UDP_WORDS;
+
+    uint32_t body[HYPERRAM_CALLER_COUNT][HYPERRAM_STATS_UDP_WORDS];
+    for (uint32_t c = 0U; c < (uint32_t)HYPERRAM_CALLER_COUNT; c++)
+    {
+        hyperram_caller_stats_t st;
+        hyperram_caller_stats_get((hyperram_caller_t)c, &st);
+        uint32_t *w = body[c];
+        w[0] = st.read_transactions;
+        w[1] = st.write_transactions;
+        w[2] = (uint32_t)st.read_bytes;
+        w[3] = (uint32_t)(st.read_bytes >> 32);
+        w[4] = (uint32_t)st.write_bytes;
+        w[5] = (uint32_t)(st.write_bytes >> 32);
+        w[6] = (uint32_t)st.wait_cycles;
+        w[7] = (uint32_t)(st.wait_cycles >> 32);
+        w[8] = (uint32_t)st.hold_cycles;
+        w[9] = (uint32_t)(st.hold_cycles >> 32);
+        w[10] = st.max_wait_cycles;
+        w[11] = st.max_hold_cycles;
+        w[12] = st.timeouts;
+        w[13] = st.wv_retries;
+    }
+
+    struct pbuf *p = pbuf_alloc(PBUF_TRANSPORT, (u16_t)(sizeof(hdr) + sizeof(body)), PBUF_RAM);
+    if (!p)
+    {
+        return; // 値は累積なので次の周期で送れればよい
+    }
+    memcpy(p->payload, &hdr, sizeof(hdr));
+    memcpy((uint8_t *)p->payload + sizeof(hdr), body, sizeof(body));
+    (void)udp_sendto(ctx->pcb, p, &ctx->dest_ip, ctx->port);
     pbuf_free(p);
 }
+#else
+#undef HYPERRAM_STATS_UDP_ENABLE
+#define HYPERRAM_STATS_UDP_ENABLE (0)
+#endif
 
 /* ====== 送信タイマ(tcpip_thread 上で実行) ====== */
 static void udp_send_timer_cb(void *arg)
@@ -329,6 +608,8 @@ static void udp_send_timer_cb(void *arg)
 
     if (ctx->is_video_mode || ctx->is_photo_mode)
     {
+        const uint32_t prof_t0 = prof_now();
+
         /* Snapshot base at the start of each frame to avoid mid-frame base changes. */
         if (ctx->is_video_mode && (ctx->sent_bytes == 0U))
         {
@@ -347,10 +628,25 @@ static void udp_send_timer_cb(void *arg)
                         ctx->photo_size = sz;
                     }
                 }
+                /* Ask Thread3 to export the next image for the following frame. */
+                g_depth_export_request = 1U;
             }
             else
             {
-                ctx->frame_base_offset = (uint32_t)g_video_frame_base_offset;
+                udp_snapshot_video_frame(ctx);
+            }
+
+            if (UDP_VIDEO_SOURCE == 3)
+            {
+                ctx->trace_seq = ctx->depth_seq_snapshot;
+            }
+            else if (UDP_VIDEO_SOURCE == 1 || UDP_VIDEO_SOURCE == 2)
+            {
+                ctx->trace_seq = (uint32_t)g_pq128_seq;
+            }
+            else
+            {
+                ctx->trace_seq = (uint32_t)g_video_frame_seq;
             }
         }
 
@@ -376,6 +672,7 @@ static void udp_send_timer_cb(void *arg)
         if (!p)
         {
             // pbuf確保失敗時は短い間隔でリトライ(間隔0でも安全)
+            prof_count(PROF_CTR_UDP_RESCHEDULES, 1U);
             sys_timeout((ctx->interval_ms > 0) ? ctx->interval_ms : 1, udp_send_timer_cb, ctx);
             return;
         }
@@ -384,11 +681,14 @@ static void udp_send_timer_cb(void *arg)
         {
             // ヘッダーを作成
             udp_photo_header_t header;
-            header.magic_number = 0x12345678;
+            header.magic_number = UDP_PHOTO_MAGIC;
             header.total_size = ctx->photo_size;
             header.chunk_index = ctx->sent_bytes / ctx->chunk_size;
             header.total_chunks = (ctx->photo_size + ctx->chunk_size - 1) / ctx->chunk_size;
             header.chunk_offset = ctx->sent_bytes;
+#if UDP_PHOTO_HEADER_SEQ
+            header.frame_seq = ctx->current_frame;
+#endif
             header.chunk_data_size = (uint16_t)send_size;
             header.checksum = calc_header_checksum(&header);
 
@@ -419,8 +719,8 @@ static void udp_send_timer_cb(void *arg)
              */
             if (UDP_VIDEO_SOURCE == 1 || UDP_VIDEO_SOURCE == 2)
             {
-                /* Stream PQ128 debug view as a 320x240 grayscale image. */
-                fill_pq_debug_chunk(dest_ptr, (uint32_t)send_size, (uint32_t)ctx->sent_bytes);
+                /* Stream PQ128 debug view as a grayscale image of the frame size. */
+                fill_pq_debug_chunk(dest_ptr, (uint32_t)send_size, (uint32_t)ctx->sent_bytes, &ctx->frame_desc);
             }
             else if (UDP_VIDEO_SOURCE == 3)
             {
@@ -438,6 +738,7 @@ static void udp_send_timer_cb(void *arg)
                     if (FSP_SUCCESS != derr)
                     {
                         pbuf_free(p);
+                        prof_count(PROF_CTR_UDP_RESCHEDULES, 1U);
                         if (FSP_ERR_TIMEOUT != derr)
                         {
                             xprintf("[UDP] Depth read error: %d\n", derr);
@@ -449,10 +750,41 @@ static void udp_send_timer_cb(void *arg)
             }
             else
             {
+#if (VIDEO_FRAME_FORMAT == VIDEO_FRAME_FMT_UYVY)
                 fsp_err_t read_err = hyperram_b_read_timed(yuv_buffer, (void *)(base + yuv_offset), yuv_read_size, 0);
+#elif (VIDEO_FRAME_FORMAT == VIDEO_FRAME_FMT_Y8)
+                /* Y 平面は Thread0 で並べ替え済み(UYVY_SWAP_Y + 4px)：そのまま送る */
+                (void)yuv_offset;
+                fsp_err_t read_err = hyperram_b_read_timed(dest_ptr,
+                                                           (void *)(base + VIDEO_FRAME_Y_OFFSET + (uint32_t)ctx->sent_bytes),
+                                                           (uint32_t)send_size,
+                                                           0);
+#else
+                /* 間引き Y 平面：最近傍で元のサイズに戻して送る(受信側の形式は不変) */
+                (void)yuv_offset;
+                const uint32_t fw = (uint32_t)ctx->frame_desc.width;
+                const uint32_t dw = video_frame_decim_w(&ctx->frame_desc);
+                fsp_err_t read_err = FSP_SUCCESS;
+                uint32_t cached_row = 0xFFFFFFFFU;
+                for (uint32_t i = 0U; (i < (uint32_t)send_size) && (FSP_SUCCESS == read_err); i++)
+                {
+                    const uint32_t pix = (uint32_t)ctx->sent_bytes + i;
+                    const uint32_t drow = (pix / fw) / (uint32_t)VIDEO_FRAME_DECIM_Y;
+                    if (drow != cached_row)
+                    {
+                        read_err = hyperram_b_read_timed(yuv_buffer,
+                                                         (void *)(base + VIDEO_FRAME_Y_OFFSET + drow * dw),
+                                                         dw,
+                                                         0);
+                        cached_row = drow;
+                    }
+                    dest_ptr[i] = yuv_buffer[(pix % fw) / (uint32_t)VIDEO_FRAME_DECIM_X];
+                }
+#endif
                 if (FSP_SUCCESS != read_err)
                 {
                     pbuf_free(p);
+                    prof_count(PROF_CTR_UDP_RESCHEDULES, 1U);
                     if (FSP_ERR_TIMEOUT != read_err)
                     {
                         xprintf("[UDP] HyperRAM read error: %d\n", read_err);
@@ -461,14 +793,30 @@ static void udp_send_timer_cb(void *arg)
                     return;
                 }
 
+#if (VIDEO_FRAME_FORMAT == VIDEO_FRAME_FMT_UYVY)
                 extract_y_from_yuv422(yuv_buffer, dest_ptr, (uint32_t)send_size, g_yuv422_order_fixed);
+#endif
             }
 
             err_t e = udp_sendto(ctx->pcb, p, &ctx->dest_ip, ctx->port);
             pbuf_free(p);
+            prof_span_end(PROF_SPAN_UDP_CHUNK, prof_t0);
 
             if (e == ERR_OK)
             {
+                prof_count(PROF_CTR_UDP_CHUNKS, 1U);
+                prof_count(PROF_CTR_UDP_BYTES, (uint32_t)send_size);
+                if (ctx->is_video_mode)
+                {
+                    if (ctx->sent_bytes == 0U)
+                    {
+                        latency_trace_stamp(ctx->trace_seq, LATENCY_STAGE_UDP_FIRST);
+                    }
+                    if ((ctx->sent_bytes + send_size) >= ctx->photo_size)
+                    {
+                        latency_trace_stamp(ctx->trace_seq, LATENCY_STAGE_UDP_LAST);
+                    }
+                }
                 ctx->sent_bytes += send_size;
                 // ログ出力を大幅に削減(パフォーマンス向上)
                 if ((ctx->sent_bytes / ctx->chunk_size) % 100 == 0)
@@ -479,6 +827,10 @@ static void udp_send_timer_cb(void *arg)
                     }
                 }
             }
+            else
+            {
+                prof_count(PROF_CTR_UDP_SEND_ERRORS, 1U);
+            }
             // ログ出力を最小限に抑制(高速化)
             // 動画モードではログをほぼ出力しない
         }
@@ -524,6 +876,15 @@ static void udp_send_timer_cb(void *arg)
         {
             // 現在のフレーム完了
             ctx->current_frame++;
+#if LATENCY_TRACE_UDP_ENABLE
+            udp_send_latency_trace(ctx);
+#endif
+#if PROF_UDP_ENABLE
+            udp_send_prof_snapshot(ctx);
+#endif
+#if HYPERRAM_STATS_UDP_ENABLE
+            udp_send_hyperram_stats(ctx);
+#endif
             ctx->is_frame_complete = true;
 
             // total_frames == UINT32_MAX (0xFFFFFFFF) なら無制限ループ
@@ -551,7 +912,7 @@ static void udp_send_timer_cb(void *arg)
                 }
                 else
                 {
-                    ctx->frame_base_offset = (uint32_t)g_video_frame_base_offset;
+                    udp_snapshot_video_frame(ctx);
                 }
                 should_continue = true;
                 next_interval = ctx->frame_interval_ms; // フレーム間は長めの間隔
@@ -612,6 +973,9 @@ static void udp_send_timer_cb(void *arg)
 /* ====== netif ステータスコールバック(tcpip_thread から呼ばれる) ====== */
 static void netif_status_cb(struct netif *n)
 {
+    /* UDP の送信タイマも tcpip_thread で動くので，ここで HyperRAM の呼び出し元として登録 */
+    hyperram_register_caller(HYPERRAM_CALLER_STREAM);
+
     if (!ip4_addr_isany_val(*netif_ip4_addr(n)))
     {
         if (g_ip_ready_sem)
@@ -762,7 +1126,8 @@ void main_thread1_entry(void *pvParameters)
         ctx->is_video_mode = true;
         ctx->is_photo_mode = false;
         ctx->photo_data = (uint8_t *)HYPERRAM_BASE_ADDR; // 使用しない(hyperram_b_readで直接指定)
-        ctx->photo_size = 320 * 240;                     // グレースケール: 320x240x1 = 76,800 bytes
+        ctx->photo_size = 320 * 240;                     // グレースケール: 既定 320x240x1(フレーム先頭で w*h に合わせる)
+        ctx->frame_desc = video_frame_desc_make(320U, 240U, (uint32_t)CAM_MODE_QVGA);
         ctx->sent_bytes = 0;
         ctx->chunk_size = 512; // 512バイトずつ送信
 
@@ -771,7 +1136,7 @@ void main_thread1_entry(void *pvParameters)
         ctx->total_frames = UINT32_MAX; // 無制限フレーム送信
         ctx->frame_interval_ms = UDP_FRAME_INTERVAL_MS;
         ctx->is_frame_complete = false;
-        ctx->frame_base_offset = (uint32_t)g_video_frame_base_offset;
+        udp_snapshot_video_frame(ctx);
 
         xprintf("[VIDEO] Starting grayscale transmission (Y component):\n %d bytes/frame, %d chunks/frame\n",
                 ctx->photo_size, (ctx->photo_size + ctx->chunk_size - 1) / ctx->chunk_size);
@@ -2,6 +2,7 @@
 /* Main Thread2 entry function */
 
 #include "usb_cdc.h"
+#include "binlog.h"
 /* New Thread entry function */
 
 uint32_t g_usb_read_data;
@@ -82,6 +83,31 @@ void usb_cdc_rtos_callback(usb_event_info_t *event, usb_hdl_t handle, usb_onoff_
     }
 }
 
+/* binlog のレコードを確認する間隔(テキストログが無いときの待ち時間) */
+#ifndef BINLOG_DRAIN_PERIOD_MS
+#define BINLOG_DRAIN_PERIOD_MS (10U)
+#endif
+
+static void usb_cdc_write_blocking(const char *buf, uint32_t len)
+{
+    if (len == 0U)
+    {
+        return;
+    }
+
+    fsp_err_t err = g_usb_on_usb.write(&g_basic0_ctrl, (uint8_t *)buf, len, USB_CLASS_PCDC);
+    if (FSP_SUCCESS != err)
+    {
+        __BKPT(0);
+    }
+
+    /* Wait for the USB Write to complete */
+    if (xSemaphoreTake(g_usb_write_complete_binary_semaphore, portMAX_DELAY) == pdTRUE)
+    {
+        __NOP(); // The write has completed
+    }
+}
+
 /* pvParameters contains TaskHandle_t */
 void main_thread2_entry(void *pvParameters)
 {
@@ -107,22 +133,19 @@ void main_thread2_entry(void *pvParameters)
     char recvMsg[256];
     while (1)
     {
-        if (xQueueReceive(xQueueMes, recvMsg, portMAX_DELAY))
+#if BINLOG_ENABLE
+        const TickType_t wait = pdMS_TO_TICKS(BINLOG_DRAIN_PERIOD_MS);
+#else
+        const TickType_t wait = portMAX_DELAY;
+#endif
+        if (xQueueReceive(xQueueMes, recvMsg, wait))
         {
-
-            err = g_usb_on_usb.write(&g_basic0_ctrl, (uint8_t *)recvMsg, strlen(recvMsg), USB_CLASS_PCDC);
-            if (FSP_SUCCESS != err)
-            {
-                __BKPT(0);
-            }
-
-            /* Wait for the USB Write to complete */
-            if (xSemaphoreTake(g_usb_write_complete_binary_semaphore, portMAX_DELAY) == pdTRUE)
-            {
-                __NOP(); // The write has completed
-            }
+            usb_cdc_write_blocking(recvMsg, (uint32_t)strlen(recvMsg));
         }
 
+        /* Deferred binary log: format here, one record per line. */
+        (void)binlog_drain(usb_cdc_write_blocking, 16U);
+
         // vTaskDelay(1000 / portTICK_PERIOD_MS); // Delay
     }
 }
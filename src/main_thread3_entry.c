@@ -8,6 +8,10 @@
 #include "FreeRTOS.h"
 #include "task.h"
 #include "video_frame_buffer.h"
+#include "cam.h"
+#include "latency_trace.h"
+#include "prof.h"
+#include "binlog.h"
 #include <string.h>
 #include <math.h>
 
@@ -63,6 +67,23 @@ static FC128_UNUSED inline uint8_t max_u8(uint8_t a, uint8_t b)
 #define USE_MVE_FOR_GAUSS_SEIDEL 0
 #endif
 
+// ---- Optional PQ128 ref/fast kernel benchmark ----
+/* 1: every PQ128_BENCH_PERIOD frames, run both PQ128 kernels, compare p/q and log timings.
+ * Needs the DWT cycle counter, so this forces FC128_TIMING_ENABLE.
+ */
+#ifndef PQ128_BENCH_ENABLE
+#define PQ128_BENCH_ENABLE (0)
+#endif
+
+#ifndef PQ128_BENCH_PERIOD
+#define PQ128_BENCH_PERIOD (30U)
+#endif
+
+#if PQ128_BENCH_ENABLE
+#undef FC128_TIMING_ENABLE
+#define FC128_TIMING_ENABLE (1)
+#endif
+
 // ---- Optional FC128 per-phase cycle timing (DWT->CYCCNT) ----
 #ifndef FC128_TIMING_ENABLE
 #define FC128_TIMING_ENABLE (0)
@@ -92,7 +113,7 @@ static inline FC128_UNUSED void fc128_dwt_init_once(void)
 
 static inline FC128_UNUSED uint32_t fc128_dwt_now(void)
 {
-#if FC128_TIMING_ENABLE
+#if FC128_TIMING_ENABLE || PROF_ENABLE
     return DWT->CYCCNT;
 #else
     return 0U;
@@ -113,13 +134,24 @@ static inline uint32_t fc128_cyc_to_us(uint32_t cyc)
 }
 #endif
 
-#define FRAME_WIDTH 320
-#define FRAME_HEIGHT 240
-#define FRAME_SIZE (FRAME_WIDTH * FRAME_HEIGHT * 2) // YUV422 = 2 bytes/pixel
-#define GRADIENT_OFFSET FRAME_SIZE                  // p,q勾配マップを配置(2チャンネル×8bit)
-#define DEPTH_OFFSET (FRAME_SIZE * 2)               // 深度マップ(8bit grayscale: 320×240 = 76,800バイト)
+/*
+ * フレームサイズ．
+ * - *_MAX: 行バッファ等の容量(全取り込みモードの最大，コンパイル時定数)．
+ * - FRAME_WIDTH/HEIGHT: 処理中フレームの実サイズ．フレームごとに公開ディスクリプタから s_frame へ取る．
+ *   実行時の値なので配列サイズや #if には使わないこと．
+ */
+#define FRAME_WIDTH_MAX ((int)VIDEO_FRAME_MAX_W)
+#define FRAME_HEIGHT_MAX ((int)VIDEO_FRAME_MAX_H)
+
+static video_frame_desc_t s_frame;
+
+#define FRAME_WIDTH ((int)s_frame.width)
+#define FRAME_HEIGHT ((int)s_frame.height)
+#define GRADIENT_OFFSET VIDEO_FRAME_GRADIENT_OFFSET // p,q勾配マップを配置(2チャンネル×8bit)
+#define DEPTH_OFFSET VIDEO_FRAME_DEPTH_OFFSET       // 深度マップ(8bit grayscale: width×height)
 
 #define DEPTH_BYTES ((uint32_t)(FRAME_WIDTH * FRAME_HEIGHT))
+#define DEPTH_BYTES_MAX ((uint32_t)(FRAME_WIDTH_MAX * FRAME_HEIGHT_MAX))
 
 /* Align scratch to 16 bytes (matches base alignment granularity). */
 #define ALIGN16_U32(x) (((uint32_t)(x) + 15U) & ~15U)
@@ -197,9 +229,15 @@ static inline uint32_t fc128_cyc_to_us(uint32_t cyc)
 #endif
 
 #include "motor_control.h"
+#include "hlac_temporal.h"
 
 /* Motor command gating for noisy frames.
  *
+ * HLAC_TEMPORAL_ENABLE=1: decisions come from hlac_temporal (decayed,
+ * probability-weighted history, posted once the posterior margin is large enough).
+ * Off until tuned on logged probabilities (see hlac_temporal.h).
+ *
+ * HLAC_TEMPORAL_ENABLE=0 (default):
  * - When HLAC inference is unstable (motion blur / rotation), skip posting pred.
  * - Require N consecutive identical preds before posting.
  * - Optionally require best_score >= threshold.
@@ -314,17 +352,37 @@ static inline uint32_t fc128_cyc_to_us(uint32_t cyc)
 #endif
 
 /* Width may exceed the frame; left/right will be zero-padded. */
-#if (PQ128_BUILD_WARNINGS && (PQ128_SRC_W > FRAME_WIDTH))
+#if (PQ128_BUILD_WARNINGS && (PQ128_SRC_W > VIDEO_FRAME_MAX_W))
 #warning "PQ128_SRC_W exceeds frame width; left/right will be zero-padded"
 #endif
 
 /* Height may exceed the frame; out-of-frame rows are zero-padded. */
-#if (PQ128_BUILD_WARNINGS && (PQ128_SRC_H > FRAME_HEIGHT))
+#if (PQ128_BUILD_WARNINGS && (PQ128_SRC_H > VIDEO_FRAME_MAX_H))
 #warning "PQ128_SRC_H exceeds frame height; top/bottom will be zero-padded"
 #endif
 
-#define PQ128_X0 ((FRAME_WIDTH - PQ128_SRC_W) / 2)
-#define PQ128_Y0 ((FRAME_HEIGHT - PQ128_SRC_H) / 2)
+/* ROI はフレーム中央．間引き形式では原点を間引き格子へ切り捨てる(格子外の画素は保存されていない) */
+#if (VIDEO_FRAME_FORMAT == VIDEO_FRAME_FMT_Y8_DECIM)
+#define PQ128_ROI_LATTICE_X ((int)VIDEO_FRAME_DECIM_X)
+#define PQ128_ROI_LATTICE_Y ((int)VIDEO_FRAME_DECIM_Y)
+#else
+#define PQ128_ROI_LATTICE_X (1)
+#define PQ128_ROI_LATTICE_Y (1)
+#endif
+
+static inline int pq128_roi_origin(int frame_extent, int src_extent, int lattice)
+{
+    const int o = (frame_extent - src_extent) / 2;
+    int r = o % lattice;
+    if (r < 0)
+    {
+        r += lattice;
+    }
+    return o - r;
+}
+
+#define PQ128_X0 pq128_roi_origin(FRAME_WIDTH, PQ128_SRC_W, PQ128_ROI_LATTICE_X)
+#define PQ128_Y0 pq128_roi_origin(FRAME_HEIGHT, PQ128_SRC_H, PQ128_ROI_LATTICE_Y)
 #define PQ128_PLANE_BYTES ((uint32_t)(PQ128_SIZE * PQ128_SIZE * (int)sizeof(int16_t)))
 
 /* Force p/q to 0 in an outer border of N pixels.
@@ -471,6 +529,26 @@ static float g_light_ts;
 #define PQ128_SAT_TH (245)
 #endif
 
+/* 1: single-pass PQ128 kernel (line ring + weight LUTs + MVE rows), 0: reference per-pixel loop.
+ * Both produce the same planes (see PQ128_BENCH_ENABLE).
+ */
+#ifndef PQ128_FAST_KERNEL
+#define PQ128_FAST_KERNEL (1)
+#endif
+
+/* 1: 帯ストリーミング(cam.h の CAM_BAND_STREAM_ENABLE)．CEU が SRAM に書いた行を
+ * そのまま読み，着地した帯から順に p/q を計算する(フレームの HyperRAM 往復なし)．
+ * p/q はフレーム終了の数行後に揃う．HLAC true256 / FC128 tiled では無効．
+ */
+#ifndef PQ128_STREAM_CAPTURE
+#define PQ128_STREAM_CAPTURE (CAM_BAND_STREAM_ENABLE)
+#endif
+
+/* 帯ストリーミング：次の帯を待つタイムアウト(ms)．超えたらそのフレームは破棄 */
+#ifndef PQ128_STREAM_TIMEOUT_MS
+#define PQ128_STREAM_TIMEOUT_MS (200)
+#endif
+
 /* Remove per-pixel division by using a reciprocal LUT (recommended for speed). */
 #ifndef PQ128_USE_RECIP_LUT
 /* NOTE:
@@ -643,6 +721,8 @@ volatile uint32_t g_pq128_base_offset = 0;
 volatile uint32_t g_depth_seq = 0;
 volatile uint32_t g_depth_base_offset = 0;
 volatile uint32_t g_depth_size_bytes = 0;
+/* Set by the depth streamer when it wants a fresh image; start with 1 so the first frame is exported. */
+volatile uint32_t g_depth_export_request = 1U;
 
 #ifndef HLAC_ENABLE
 /* 1: Export |P|+|Q| into the DEPTH_OFFSET buffer instead of FC reconstructed depth.
@@ -686,6 +766,48 @@ volatile uint32_t g_depth_size_bytes = 0;
 #ifndef HLAC_BLOCK_COLS
 #define HLAC_BLOCK_COLS (4)
 #endif
+
+/*
+ * Cascaded block inference.
+ * - Blocks are evaluated in HLAC_CASCADE_ORDER and the loop stops as soon as the
+ *   leading class cannot be overturned by the remaining blocks (same pred as
+ *   evaluating every block).
+ * - Blocks whose mean |P|+|Q| is below HLAC_CASCADE_BG_MEAN_U8 are background:
+ *   no LDA and no vote.
+ */
+#ifndef HLAC_CASCADE_ENABLE
+#define HLAC_CASCADE_ENABLE (1)
+#endif
+
+/*
+ * The early exit is off while HLAC_TEMPORAL_ENABLE is on: the temporal evidence is the mean of
+ * the per-block probabilities, and averaging only the blocks seen before the exit would bias it
+ * toward the leader. Background skipping and the evaluation order still apply.
+ */
+#if HLAC_CASCADE_ENABLE && !HLAC_TEMPORAL_ENABLE
+#define HLAC_CASCADE_EARLY_EXIT (1)
+#else
+#define HLAC_CASCADE_EARLY_EXIT (0)
+#endif
+
+/* 0: raster, 1: center first, 2: previous-frame confidence (ties: center first). */
+#ifndef HLAC_CASCADE_ORDER
+#define HLAC_CASCADE_ORDER (2)
+#endif
+
+/* Background pre-filter threshold on the block mean |P|+|Q| (u8). 0 = off. */
+#ifndef HLAC_CASCADE_BG_MEAN_U8
+#define HLAC_CASCADE_BG_MEAN_U8 (0U)
+#endif
+
+/* Log blocks evaluated / time saved every N frames via binlog (0 = off). */
+#ifndef HLAC_CASCADE_REPORT_FRAMES
+#define HLAC_CASCADE_REPORT_FRAMES (300U)
+#endif
+
+#if ((HLAC_BLOCK_ROWS * HLAC_BLOCK_COLS) > 255)
+#error HLAC block grid is too large for the cascade order table.
+#endif
 #endif
 
 /*
@@ -710,6 +832,30 @@ volatile uint32_t g_depth_size_bytes = 0;
 #define HLAC_MAX_CLASSES (10)
 #endif
 
+/*
+ * Fused |P|+|Q| -> HLAC streaming.
+ * 1: each |P|+|Q| row is pushed straight into SRAM HLAC accumulators (full and block grid),
+ *    so inference no longer reads the image back from HyperRAM.
+ * 0: legacy path (export to DEPTH_OFFSET, then read back row by row).
+ */
+#ifndef HLAC_FUSED_STREAM
+#define HLAC_FUSED_STREAM (1)
+#endif
+#if !HLAC_LDA_INFER_ENABLE
+#undef HLAC_FUSED_STREAM
+#define HLAC_FUSED_STREAM (0)
+#endif
+
+/*
+ * In fused mode, when to still write the |P|+|Q| image to DEPTH_OFFSET for the UDP debug view.
+ * 0: never (inference only)
+ * 1: only when the streamer asked for one (g_depth_export_request)
+ * 2: every frame
+ */
+#ifndef HLAC_FUSED_DEBUG_EXPORT
+#define HLAC_FUSED_DEBUG_EXPORT (1)
+#endif
+
 #ifndef HLAC_PQ_MAG_SHIFT
 /* |P|+|Q| is typically ~[0..510]; shift by 1 maps roughly to [0..255]. */
 #define HLAC_PQ_MAG_SHIFT (1)
@@ -772,10 +918,11 @@ volatile uint32_t g_depth_size_bytes = 0;
 
 /*
  * IMPORTANT:
- * Do NOT overlap scratch with the exported 320x240 depth buffer.
- * Depth occupies [DEPTH_OFFSET, DEPTH_OFFSET + DEPTH_BYTES).
+ * Do NOT overlap scratch with the exported depth buffer.
+ * Depth occupies [DEPTH_OFFSET, DEPTH_OFFSET + DEPTH_BYTES) and DEPTH_BYTES <= DEPTH_BYTES_MAX,
+ * so the scratch layout does not move when the capture mode changes.
  */
-#define FC128_OFFSET_BASE ALIGN16_U32(DEPTH_OFFSET + DEPTH_BYTES)
+#define FC128_OFFSET_BASE ALIGN16_U32(DEPTH_OFFSET + DEPTH_BYTES_MAX)
 
 #define FC128_P_REAL (FC128_OFFSET_BASE + 0U * FC128_PLANE_BYTES)
 #define FC128_P_IMAG (FC128_OFFSET_BASE + 1U * FC128_PLANE_BYTES)
@@ -799,8 +946,56 @@ volatile uint32_t g_depth_size_bytes = 0;
 /* Total FC scratch footprint relative to frame_base_offset. */
 #define FC128_SCRATCH_END (FC128_OFFSET_BASE + 14U * FC128_PLANE_BYTES)
 
+/*
+ * Full-frame tiled FC (overlap-add):
+ * - The frame is covered by overlapping FC_RESULT_N x FC_RESULT_N tiles in PQ128 sample space
+ *   ((FRAME_WIDTH/strideX) x (FRAME_HEIGHT/strideY) samples).
+ * - Each tile reuses the PQ128 planes and the FC scratch above, so scratch does not grow with tile count.
+ * - Tile Z is DC-matched to the already blended overlap, then accumulated with linear ramps
+ *   (sum(w*z), sum(w)) into two grid-sized float planes.
+ * - The normalized result is upsampled to 320x240 and exported full-frame.
+ * HLAC mode returns before FC, so this only takes effect with HLAC_ENABLE=0.
+ */
+#ifndef FC128_TILED_ENABLE
+#define FC128_TILED_ENABLE (0)
+#endif
+#if HLAC_ENABLE
+#undef FC128_TILED_ENABLE
+#define FC128_TILED_ENABLE (0)
+#endif
+
+/* Minimum overlap between neighbouring tiles [samples]. Tiles are spread evenly, so the actual overlap can be larger. */
+#ifndef FC128_TILE_OVERLAP
+#define FC128_TILE_OVERLAP (32)
+#endif
+
+#if (FC128_TILE_OVERLAP < 1) || (FC128_TILE_OVERLAP >= FC_RESULT_N)
+#error "FC128_TILE_OVERLAP must be in [1, FC_RESULT_N)"
+#endif
+
+#if FC128_TILED_ENABLE && (PQ128_SIZE != FC_RESULT_N)
+#error "FC128_TILED_ENABLE requires PQ128_SIZE == FC_RESULT_N"
+#endif
+
+#define FC128_TILE_GRID_W (FRAME_WIDTH / PQ128_SAMPLE_STRIDE_X)
+#define FC128_TILE_GRID_H (FRAME_HEIGHT / PQ128_SAMPLE_STRIDE_Y)
+#define FC128_TILE_GRID_W_MAX (FRAME_WIDTH_MAX / PQ128_SAMPLE_STRIDE_X)
+#define FC128_TILE_GRID_H_MAX (FRAME_HEIGHT_MAX / PQ128_SAMPLE_STRIDE_Y)
+#define FC128_TILE_MAX_PER_AXIS (8)
+
+/* Scratch is sized for the largest mode (the grid row pitch is FC128_TILE_GRID_W of the current frame). */
+#define FC128_TILE_GRID_BYTES ((uint32_t)(FC128_TILE_GRID_W_MAX * FC128_TILE_GRID_H_MAX * (uint32_t)sizeof(float)))
+#define FC128_TILE_ACC_OFFSET ALIGN16_U32(FC128_SCRATCH_END)
+#define FC128_TILE_WSUM_OFFSET (FC128_TILE_ACC_OFFSET + ALIGN16_U32(FC128_TILE_GRID_BYTES))
+#define FC128_TILE_Z_OFFSET (FC128_TILE_WSUM_OFFSET + ALIGN16_U32(FC128_TILE_GRID_BYTES))
+#define FC128_TILE_SCRATCH_END (FC128_TILE_Z_OFFSET + (uint32_t)(FRAME_WIDTH_MAX * FRAME_HEIGHT_MAX * (uint32_t)sizeof(float)))
+
 /* Total scratch footprint relative to frame_base_offset. */
+#if FC128_TILED_ENABLE
+#define FC128_TOTAL_SCRATCH_END (FC128_TILE_SCRATCH_END)
+#else
 #define FC128_TOTAL_SCRATCH_END (FC128_SCRATCH_END)
+#endif
 
 static void fc128_layout_check_once(uint32_t frame_base_offset)
 {
@@ -856,6 +1051,25 @@ static void fc128_layout_check_once(uint32_t frame_base_offset)
 #define FC128_PACKED_DIRECT_ZHAT (1)
 #endif
 
+/* Fixed-point FC (arm_cfft_q31 + block floating point, int16 complex HyperRAM planes).
+ * 0: float path above. 1: fixed-point path; only the final Z is written as float.
+ * Fixed planes reuse the Z_HAT/TMP float slots (N*N*4 bytes each), so the layout does not grow.
+ */
+#ifndef FC128_FIXED_POINT
+#define FC128_FIXED_POINT (0)
+#endif
+
+/* Every N solves, also run the float path and log RMSE(fixed - float). 0 disables.
+ * The exported depth of a verify frame comes from the float path.
+ */
+#ifndef FC128_FIXED_VERIFY_PERIOD
+#define FC128_FIXED_VERIFY_PERIOD (0U)
+#endif
+
+#define FC128_FX_SPEC (FC128_Z_HAT_REAL) // C = FFT2(P + jQ), BFP int16 complex
+#define FC128_FX_ZHAT (FC128_TMP_REAL)   // Z_hat, BFP int16 complex
+#define FC128_FX_VERIFY_Z (FC128_P_HAT_REAL)
+
 static FC128_UNUSED void fc128_unpack_pq_hats_from_packed(uint32_t frame_base_offset)
 {
     float c_re_row[FC_FFT_N];
@@ -1465,16 +1679,24 @@ static FC128_UNUSED void fc128_compute_zhat(uint32_t frame_base_offset)
     }
 }
 
-static void fc128_export_depth_u8_320x240(uint32_t frame_base_offset)
+/* Map a float Z plane (z_w x z_h, row pitch z_stride floats, z_w multiple of 4) to the u8 depth canvas.
+ * The plane is centered in 320x240; the rest is FC128_EXPORT_BG_U8.
+ */
+static void fc128_export_depth_u8_plane(uint32_t frame_base_offset,
+                                        uint32_t z_offset,
+                                        uint32_t z_stride,
+                                        int z_w,
+                                        int z_h)
 {
-    /* Export placement: keep the 128x128 depth image centered in 320x240,
+    /* Export placement: keep the depth image centered in 320x240,
      * independent from PQ128 sampling region (which may extend beyond the frame
      * when strides are large and we zero-pad).
      */
-    const int export_x0 = (FRAME_WIDTH - FC_RESULT_N) / 2;
-    const int export_y0 = (FRAME_HEIGHT - FC_RESULT_N) / 2;
+    const int export_x0 = (FRAME_WIDTH - z_w) / 2;
+    const int export_y0 = (FRAME_HEIGHT - z_h) / 2;
+    const uint32_t row_bytes = (uint32_t)z_w * (uint32_t)sizeof(float);
 
-    float row_z[FC_RESULT_N];
+    float row_z[FRAME_WIDTH_MAX];
 
 #if FC128_EXPORT_FIXED_SCALE
     /* z_ref is applied to the fixed-scale mapping to stabilize the output.
@@ -1504,17 +1726,16 @@ static void fc128_export_depth_u8_320x240(uint32_t frame_base_offset)
     float z_min = FLT_MAX;
     float z_max = -FLT_MAX;
 
-    for (int y = 0; y < FC_RESULT_N; y++)
+    for (int y = 0; y < z_h; y++)
     {
-        /* Read center crop from the FC_FFT_N x FC_FFT_N Z plane. */
-        const uint32_t base = (uint32_t)((y + FC_PAD_Y0) * FC_FFT_N + FC_PAD_X0) * (uint32_t)sizeof(float);
-        (void)hyperram_b_read(row_z, (void *)(frame_base_offset + FC128_Z_REAL + base), (uint32_t)sizeof(row_z));
+        const uint32_t base = (uint32_t)y * z_stride * (uint32_t)sizeof(float);
+        (void)hyperram_b_read(row_z, (void *)(frame_base_offset + z_offset + base), row_bytes);
 
 #if USE_HELIUM_MVE
         // MVE版: 4要素単位でロードし，スカラーでmin/max更新(ツールチェーン互換)
         {
             int x;
-            for (x = 0; x < FC_RESULT_N - 3; x += 4)
+            for (x = 0; x < z_w - 3; x += 4)
             {
                 float32x4_t vz = vld1q_f32(&row_z[x]);
                 float t[4];
@@ -1527,7 +1748,7 @@ static void fc128_export_depth_u8_320x240(uint32_t frame_base_offset)
                         z_max = t[i];
                 }
             }
-            for (; x < FC_RESULT_N; x++)
+            for (; x < z_w; x++)
             {
                 float v0 = row_z[x];
                 if (v0 < z_min)
@@ -1537,7 +1758,7 @@ static void fc128_export_depth_u8_320x240(uint32_t frame_base_offset)
             }
         }
 #else
-        for (int x = 0; x < FC_RESULT_N; x++)
+        for (int x = 0; x < z_w; x++)
         {
             float v0 = row_z[x];
             if (v0 < z_min)
@@ -1586,16 +1807,16 @@ static void fc128_export_depth_u8_320x240(uint32_t frame_base_offset)
     const float inv_range = 1.0f / range;
 #endif
 
-    uint8_t line[FRAME_WIDTH];
+    uint8_t line[FRAME_WIDTH_MAX];
     for (int y = 0; y < FRAME_HEIGHT; y++)
     {
-        memset(line, (int)FC128_EXPORT_BG_U8, sizeof(line));
+        memset(line, (int)FC128_EXPORT_BG_U8, (size_t)FRAME_WIDTH);
 
-        if (y >= export_y0 && y < (export_y0 + FC_RESULT_N))
+        if (y >= export_y0 && y < (export_y0 + z_h))
         {
             int ry = y - export_y0;
-            const uint32_t base = (uint32_t)((ry + FC_PAD_Y0) * FC_FFT_N + FC_PAD_X0) * (uint32_t)sizeof(float);
-            (void)hyperram_b_read(row_z, (void *)(frame_base_offset + FC128_Z_REAL + base), (uint32_t)sizeof(row_z));
+            const uint32_t base = (uint32_t)ry * z_stride * (uint32_t)sizeof(float);
+            (void)hyperram_b_read(row_z, (void *)(frame_base_offset + z_offset + base), row_bytes);
 
 #if USE_HELIUM_MVE
             {
@@ -1620,7 +1841,7 @@ static void fc128_export_depth_u8_320x240(uint32_t frame_base_offset)
                 const bool use_contrast = (FC128_EXPORT_CONTRAST_Q15 != 32768);
                 float32x4_t va = vdupq_n_f32((float)FC128_EXPORT_CONTRAST_Q15 / 32768.0f);
 
-                for (int x = 0; x < FC_RESULT_N; x += 4)
+                for (int x = 0; x < z_w; x += 4)
                 {
                     float32x4_t vz = vld1q_f32(&row_z[x]);
 #if FC128_EXPORT_FIXED_SCALE
@@ -1695,7 +1916,7 @@ static void fc128_export_depth_u8_320x240(uint32_t frame_base_offset)
                 }
             }
 #else
-            for (int x = 0; x < FC_RESULT_N; x++)
+            for (int x = 0; x < z_w; x++)
             {
 #if FC128_EXPORT_FIXED_SCALE
                 const float z = row_z[x];
@@ -1751,7 +1972,7 @@ static void fc128_export_depth_u8_320x240(uint32_t frame_base_offset)
 #endif
         }
 
-        (void)hyperram_b_write(line, (void *)(frame_base_offset + DEPTH_OFFSET + (uint32_t)y * (uint32_t)FRAME_WIDTH), (uint32_t)sizeof(line));
+        (void)hyperram_b_write(line, (void *)(frame_base_offset + DEPTH_OFFSET + (uint32_t)y * (uint32_t)FRAME_WIDTH), (uint32_t)FRAME_WIDTH);
     }
 
 #if FC128_EXPORT_FIXED_SCALE
@@ -1809,6 +2030,16 @@ static void fc128_export_depth_u8_320x240(uint32_t frame_base_offset)
 #endif
 }
 
+static FC128_UNUSED void fc128_export_depth_u8_320x240(uint32_t frame_base_offset)
+{
+    /* Center crop of the FC_FFT_N x FC_FFT_N Z plane. */
+    fc128_export_depth_u8_plane(frame_base_offset,
+                                (uint32_t)FC128_Z_REAL + (uint32_t)(FC_PAD_Y0 * FC_FFT_N + FC_PAD_X0) * (uint32_t)sizeof(float),
+                                (uint32_t)FC_FFT_N,
+                                FC_RESULT_N,
+                                FC_RESULT_N);
+}
+
 #if HLAC_ENABLE
 /* Optional: compute a true 256x256 |P|+|Q| map directly from the Y image.
  * - No stride duplication (unlike hlac_export_pq_mag_u8_roi).
@@ -1836,9 +2067,9 @@ static void fc128_export_depth_u8_320x240(uint32_t frame_base_offset)
 /* Forward declarations (definitions appear later in this file). */
 static FC128_UNUSED void load_y_line_from_hyperram_or_zero(uint32_t frame_base_offset,
                                                            int requested_row,
-                                                           uint8_t yuv_line[FRAME_WIDTH * 2],
-                                                           uint8_t y_line[FRAME_WIDTH]);
-static inline uint8_t pq128_get_y_or_zero(const uint8_t y_line[FRAME_WIDTH], int x);
+                                                           uint8_t yuv_line[FRAME_WIDTH_MAX * 2],
+                                                           uint8_t y_line[FRAME_WIDTH_MAX]);
+static inline uint8_t pq128_get_y_or_zero(const uint8_t y_line[FRAME_WIDTH_MAX], int x);
 #endif
 
 static inline uint8_t hlac_pq_mag_u8(int16_t p, int16_t q)
@@ -1857,10 +2088,12 @@ static inline uint8_t hlac_pq_mag_u8(int16_t p, int16_t q)
     return (uint8_t)mag;
 }
 
-static void hlac_export_pq_mag_u8_roi(uint32_t frame_base_offset)
+#if !HLAC_PQ_MAG_TRUE_256
+static void hlac_export_pq_mag_u8_roi(uint32_t frame_base_offset, hlac25_stream_t *hs, bool write_image)
 {
     /* Export a compact u8 image covering exactly the sampled PQ ROI.
      * Output size: PQ128_SRC_W x PQ128_SRC_H (e.g. 256x128 when strideX=2, strideY=1).
+     * hs != NULL: also feed each row to the HLAC stream (fused mode).
      */
     uint8_t line[PQ128_SRC_W];
     int16_t p_row[PQ128_SIZE];
@@ -1901,28 +2134,37 @@ static void hlac_export_pq_mag_u8_roi(uint32_t frame_base_offset)
             }
         }
 
-        (void)hyperram_b_write(line,
-                               (void *)(frame_base_offset + (uint32_t)DEPTH_OFFSET + (uint32_t)y * (uint32_t)PQ128_SRC_W),
-                               (uint32_t)sizeof(line));
+        if (hs)
+        {
+            hlac25_stream_push_row(hs, line);
+        }
+        if (write_image)
+        {
+            (void)hyperram_b_write(line,
+                                   (void *)(frame_base_offset + (uint32_t)DEPTH_OFFSET + (uint32_t)y * (uint32_t)PQ128_SRC_W),
+                                   (uint32_t)sizeof(line));
+        }
     }
 }
+#endif /* !HLAC_PQ_MAG_TRUE_256 */
 
 #if HLAC_PQ_MAG_TRUE_256
-static void hlac_export_pq_mag_u8_true256_from_y(uint32_t frame_base_offset)
+static void hlac_export_pq_mag_u8_true256_from_y(uint32_t frame_base_offset, hlac25_stream_t *hs, bool write_image)
 {
-    uint8_t yuv_tmp[FRAME_WIDTH * 2];
-    uint8_t y_buf0[FRAME_WIDTH];
-    uint8_t y_buf1[FRAME_WIDTH];
-    uint8_t y_buf2[FRAME_WIDTH];
+    uint8_t yuv_tmp[FRAME_WIDTH_MAX * 2];
+    uint8_t y_buf0[FRAME_WIDTH_MAX];
+    uint8_t y_buf1[FRAME_WIDTH_MAX];
+    uint8_t y_buf2[FRAME_WIDTH_MAX];
     uint8_t *y_prev = y_buf0;
     uint8_t *y_curr = y_buf1;
     uint8_t *y_next = y_buf2;
     uint8_t line[HLAC_PQ_MAG_TRUE_W];
 
-    /* This ROI is fully inside the frame horizontally for FRAME_WIDTH=320.
-     * Use direct indexing for speed.
+    /* QVGA: the ROI (+1 px) is fully inside the frame horizontally -> direct indexing for speed.
+     * 256-wide modes: the edge columns fall outside and are zero-padded.
      */
     const int src_x0 = HLAC_PQ_MAG_TRUE_X0;
+    const bool x_inside = (src_x0 >= 1) && ((src_x0 + HLAC_PQ_MAG_TRUE_W + 1) <= FRAME_WIDTH);
 
     /* Prime 3-line window. Out-of-frame rows are zero-filled. */
     const int src_y0 = HLAC_PQ_MAG_TRUE_Y0;
@@ -1938,19 +2180,26 @@ static void hlac_export_pq_mag_u8_true256_from_y(uint32_t frame_base_offset)
         {
             const int x = src_x0 + ox;
 
-            const int raw_xm1 = (int)y_curr[x - 1];
-            const int raw_xp1 = (int)y_curr[x + 1];
-            const int raw_ym1 = (int)y_prev[x];
-            const int raw_yp1 = (int)y_next[x];
+            const int raw_xm1 = x_inside ? (int)y_curr[x - 1] : (int)pq128_get_y_or_zero(y_curr, x - 1);
+            const int raw_xp1 = x_inside ? (int)y_curr[x + 1] : (int)pq128_get_y_or_zero(y_curr, x + 1);
+            const int raw_ym1 = x_inside ? (int)y_prev[x] : (int)pq128_get_y_or_zero(y_prev, x);
+            const int raw_yp1 = x_inside ? (int)y_next[x] : (int)pq128_get_y_or_zero(y_next, x);
 
             const int16_t p = (int16_t)(raw_xp1 - raw_xm1);
             const int16_t q = (int16_t)(raw_yp1 - raw_ym1);
             line[ox] = hlac_pq_mag_u8(p, q);
         }
 
-        (void)hyperram_b_write(line,
-                               (void *)(frame_base_offset + (uint32_t)DEPTH_OFFSET + (uint32_t)oy * (uint32_t)HLAC_PQ_MAG_TRUE_W),
-                               (uint32_t)sizeof(line));
+        if (hs)
+        {
+            hlac25_stream_push_row(hs, line);
+        }
+        if (write_image)
+        {
+            (void)hyperram_b_write(line,
+                                   (void *)(frame_base_offset + (uint32_t)DEPTH_OFFSET + (uint32_t)oy * (uint32_t)HLAC_PQ_MAG_TRUE_W),
+                                   (uint32_t)sizeof(line));
+        }
 
         /* Slide window: prev<-curr, curr<-next, next<-new. */
         if (oy + 1 < HLAC_PQ_MAG_TRUE_H)
@@ -1966,296 +2215,327 @@ static void hlac_export_pq_mag_u8_true256_from_y(uint32_t frame_base_offset)
 #endif
 #endif
 
-static void fc128_compute_depth_and_store(uint32_t frame_base_offset, uint32_t frame_seq)
+/* Cycle stamps of one FC solve (all 0 unless FC128_TIMING_ENABLE or PROF_ENABLE). */
+typedef struct
 {
-    g_depth_seq = 0;
-    g_depth_size_bytes = 0;
-
-#if HLAC_ENABLE
-    /* In HLAC mode, reuse the depth export slot to record |P|+|Q| (u8).
-     * This avoids the heavy FC FFT pipeline.
-     */
-#if HLAC_PQ_MAG_TRUE_256
-    const uint32_t out_bytes = (uint32_t)HLAC_PQ_MAG_TRUE_W * (uint32_t)HLAC_PQ_MAG_TRUE_H;
+    uint32_t t_start;
+    uint32_t t_build;
+    uint32_t t_fft_p;
+    uint32_t t_fft_q;
+    uint32_t t_zhat;
+    uint32_t t_ifft;
+} fc128_solve_stamps_t;
+
+#if FC128_FIXED_POINT
+/* Z_hat fixed point: C/conj(Cn) pair alignment guard bits, and 1/(k^2+l^2) in Q(FC128_FX_RECIP_SHIFT). */
+#define FC128_FX_ZHAT_GUARD (10)
+#define FC128_FX_RECIP_SHIFT (28)
+
+static inline int fc128_fx_bitlen_u64(uint64_t v)
+{
+    if (v == 0U)
+    {
+        return 0;
+    }
+#if defined(__GNUC__)
+    return 64 - __builtin_clzll(v);
 #else
-    const uint32_t out_bytes = (uint32_t)PQ128_SRC_W * (uint32_t)PQ128_SRC_H;
+    const uint32_t hi = (uint32_t)(v >> 32);
+    return (hi != 0U) ? (64 - (int)__CLZ(hi)) : (32 - (int)__CLZ((uint32_t)v));
 #endif
-    if ((frame_base_offset + (uint32_t)DEPTH_OFFSET + out_bytes) > (uint32_t)HYPERRAM_SIZE)
+}
+
+static inline int32_t fc128_fx_shift_s32(int32_t v, int sh)
+{
+    if (sh >= 0)
     {
-        return;
+        return (int32_t)((uint32_t)v << sh);
     }
+    return (sh <= -31) ? ((v < 0) ? -1 : 0) : (v >> -sh);
+}
 
-#if HLAC_PQ_MAG_TRUE_256
-    hlac_export_pq_mag_u8_true256_from_y(frame_base_offset);
-#else
-    if ((frame_base_offset + (uint32_t)PQ128_Q_OFFSET + (uint32_t)PQ128_PLANE_BYTES) > (uint32_t)HYPERRAM_SIZE)
+/* Round z * 2^-sh to int16 (sh may be negative). */
+static inline int16_t fc128_fx_narrow_s64(int64_t z, int sh)
+{
+    int64_t v;
+    if (sh <= 0)
     {
-        return;
+        v = z * ((int64_t)1 << -sh);
     }
-    hlac_export_pq_mag_u8_roi(frame_base_offset);
-#endif
+    else if (sh >= 63)
+    {
+        v = 0;
+    }
+    else
+    {
+        v = ((z >> (sh - 1)) + 1) >> 1;
+    }
+    if (v > 32767)
+    {
+        v = 32767;
+    }
+    if (v < -32768)
+    {
+        v = -32768;
+    }
+    return (int16_t)v;
+}
 
-#if HLAC_LDA_INFER_ENABLE
+/* Packed P + jQ as int16 complex (exp 0); zero-padded rows are only marked in row_exp. */
+static void fc128_fx_build_packed_plane(uint32_t frame_base_offset, int8_t *row_exp)
+{
+    int16_t p_row_i16[FC_RESULT_N];
+    int16_t q_row_i16[FC_RESULT_N];
+    static int16_t row16[2 * FC_FFT_N];
+    const uint32_t row_bytes = (uint32_t)FC_FFT_N * 2U * (uint32_t)sizeof(int16_t);
 
-#if HLAC_INFER_BLOCK_MODE
-    /* Block-wise HLAC inference with majority voting. */
+    memset(row16, 0, sizeof(row16));
+
+    for (int y = 0; y < FC_FFT_N; y++)
     {
-        uint32_t img_w = 0U;
-        uint32_t img_h = 0U;
-#if HLAC_PQ_MAG_TRUE_256
-        img_w = HLAC_PQ_MAG_TRUE_W;
-        img_h = HLAC_PQ_MAG_TRUE_H;
-#else
-        img_w = PQ128_SRC_W;
-        img_h = PQ128_SRC_H;
-#endif
+        const bool in_center = (y >= FC_PAD_Y0) && (y < (FC_PAD_Y0 + FC_RESULT_N));
+        if (!in_center)
+        {
+            row_exp[y] = FFT_BFP_EXP_ZERO;
+            continue;
+        }
 
-        uint32_t block_cols = HLAC_BLOCK_COLS;
-        uint32_t block_rows = HLAC_BLOCK_ROWS;
-        uint32_t block_w = img_w / block_cols;
-        uint32_t block_h = img_h / block_rows;
+        const int ry = y - FC_PAD_Y0;
+        uint32_t row_i16_off = (uint32_t)ry * (uint32_t)FC_RESULT_N * (uint32_t)sizeof(int16_t);
+        (void)hyperram_b_read(p_row_i16, (void *)(frame_base_offset + PQ128_P_OFFSET + row_i16_off), (uint32_t)sizeof(p_row_i16));
+        (void)hyperram_b_read(q_row_i16, (void *)(frame_base_offset + PQ128_Q_OFFSET + row_i16_off), (uint32_t)sizeof(q_row_i16));
 
-        uint32_t C = HLAC_MAX_CLASSES;
+        int x = 0;
+#if USE_HELIUM_MVE
+        for (; x + 7 < FC_RESULT_N; x += 8)
+        {
+            int16x8x2_t pq;
+            pq.val[0] = vld1q_s16(&p_row_i16[x]);
+            pq.val[1] = vld1q_s16(&q_row_i16[x]);
+            vst2q_s16(&row16[2 * (FC_PAD_X0 + x)], pq);
+        }
+#endif
+        for (; x < FC_RESULT_N; x++)
+        {
+            row16[2 * (FC_PAD_X0 + x) + 0] = p_row_i16[x];
+            row16[2 * (FC_PAD_X0 + x) + 1] = q_row_i16[x];
+        }
 
-        int class_votes[HLAC_MAX_CLASSES];
-        memset(class_votes, 0, sizeof(class_votes));
+        row_exp[y] = 0;
+        (void)hyperram_b_write(row16, (void *)(frame_base_offset + FC128_FX_SPEC + (uint32_t)y * row_bytes), row_bytes);
+    }
+}
 
-        /* Store per-block prediction for grid display. */
-        int block_grid[HLAC_BLOCK_ROWS][HLAC_BLOCK_COLS];
+/* Fixed-point counterpart of fc128_build_zhat_from_packed_spectrum().
+ * In: FC128_FX_SPEC with per-column exponents. Out: FC128_FX_ZHAT with per-row exponents.
+ * The constant N/(2*pi) of Z_hat is left out here and applied when converting Z to float.
+ */
+static void fc128_fx_build_zhat(uint32_t frame_base_offset, const int8_t *col_exp, int8_t *row_exp)
+{
+    static int16_t c_y[2 * FC_FFT_N];
+    static int16_t c_yn[2 * FC_FFT_N];
+    static int16_t z16[2 * FC_FFT_N];
+    static int64_t z_re[FC_FFT_N];
+    static int64_t z_im[FC_FFT_N];
+    static int16_t z_e[FC_FFT_N];
+    static uint32_t recip[(FC_FFT_N / 2) + 1];
+    const uint32_t row_bytes = (uint32_t)FC_FFT_N * 2U * (uint32_t)sizeof(int16_t);
 
-        for (uint32_t br = 0; br < block_rows; br++)
+    for (int y = 0; y < FC_FFT_N; y++)
+    {
+        int y_neg = (y == 0) ? 0 : (FC_FFT_N - y);
+        (void)hyperram_b_read(c_y, (void *)(frame_base_offset + FC128_FX_SPEC + (uint32_t)y * row_bytes), row_bytes);
+        if (y_neg == y)
         {
-            for (uint32_t bc = 0; bc < block_cols; bc++)
-            {
-                uint32_t x0 = bc * block_w;
-                uint32_t y0 = br * block_h;
-                float feats[25];
+            memcpy(c_yn, c_y, sizeof(c_yn));
+        }
+        else
+        {
+            (void)hyperram_b_read(c_yn, (void *)(frame_base_offset + FC128_FX_SPEC + (uint32_t)y_neg * row_bytes), row_bytes);
+        }
 
-                hlac25_compute_from_u8_hyperram_roi(frame_base_offset + (uint32_t)DEPTH_OFFSET,
-                                                    img_w, x0, y0, block_w, block_h, feats);
+        const int32_t ll = (y < (FC_FFT_N / 2)) ? y : (y - FC_FFT_N);
+        for (int k = 0; k <= (FC_FFT_N / 2); k++)
+        {
+            const uint32_t d = (uint32_t)(k * k) + (uint32_t)(ll * ll);
+            recip[k] = (d != 0U) ? (((1UL << FC128_FX_RECIP_SHIFT) + (d >> 1)) / d) : 0U;
+        }
 
-                float block_score = 0.0f;
-#if HLAC_INFER_SOFTMAX_ENABLE
-                float block_prob = 0.0f;
-                int block_pred = hlac_lda_predict_ex(feats, &block_score, &block_prob, 1);
-#else
-                int block_pred = hlac_lda_predict_ex(feats, &block_score, NULL, 0);
-#endif
+        int e_top = INT32_MIN;
+        for (int x = 0; x < FC_FFT_N; x++)
+        {
+            const int x_neg = (x == 0) ? 0 : (FC_FFT_N - x);
+            const int32_t kk = (x < (FC_FFT_N / 2)) ? x : (x - FC_FFT_N);
+            const uint32_t r = recip[(kk < 0) ? -kk : kk];
+            const int e_a = (int)col_exp[x];
+            const int e_b = (int)col_exp[x_neg];
+
+            z_re[x] = 0;
+            z_im[x] = 0;
+            z_e[x] = FFT_BFP_EXP_ZERO;
+            if ((r == 0U) || ((e_a == FFT_BFP_EXP_ZERO) && (e_b == FFT_BFP_EXP_ZERO)))
+            {
+                continue;
+            }
 
-                block_grid[br][bc] = block_pred;
-                if (block_pred >= 0 && block_pred < (int)C)
+            /* Align C(u,v) and C(-u,-v) to a common exponent. */
+            const int e_p = (e_a > e_b) ? e_a : e_b;
+            const int sa = FC128_FX_ZHAT_GUARD - (e_p - e_a);
+            const int sb = FC128_FX_ZHAT_GUARD - (e_p - e_b);
+            const int32_t c_re = fc128_fx_shift_s32(c_y[2 * x + 0], sa);
+            const int32_t c_im = fc128_fx_shift_s32(c_y[2 * x + 1], sa);
+            const int32_t cn_re = fc128_fx_shift_s32(c_yn[2 * x_neg + 0], sb);
+            const int32_t cn_im = fc128_fx_shift_s32(c_yn[2 * x_neg + 1], sb);
+
+            /* 2*P_hat and 2*Q_hat (the 1/2 goes into the exponent). */
+            const int32_t p_re = c_re + cn_re;
+            const int32_t p_im = c_im - cn_im;
+            const int32_t q_re = c_im + cn_im;
+            const int32_t q_im = cn_re - c_re;
+
+            /* Z_hat = -j*(N/2pi)*(k*P_hat + l*Q_hat)/(k^2 + l^2) */
+            z_re[x] = ((int64_t)kk * p_im + (int64_t)ll * q_im) * (int64_t)r;
+            z_im[x] = -(((int64_t)kk * p_re + (int64_t)ll * q_re) * (int64_t)r);
+            z_e[x] = (int16_t)(e_p - FC128_FX_ZHAT_GUARD - 1 - FC128_FX_RECIP_SHIFT);
+
+            const uint64_t a_re = (z_re[x] < 0) ? (uint64_t)(-z_re[x]) : (uint64_t)z_re[x];
+            const uint64_t a_im = (z_im[x] < 0) ? (uint64_t)(-z_im[x]) : (uint64_t)z_im[x];
+            const uint64_t a = (a_re > a_im) ? a_re : a_im;
+            if (a != 0U)
+            {
+                const int e = (int)z_e[x] + fc128_fx_bitlen_u64(a);
+                if (e > e_top)
                 {
-                    class_votes[block_pred]++;
+                    e_top = e;
                 }
             }
         }
 
-        /* Find class with most votes (majority voting). */
-        int pred = -1;
-        int max_votes = 0;
-        for (uint32_t c = 0; c < C; c++)
+        if (e_top == INT32_MIN)
         {
-            if (class_votes[c] > max_votes)
+            row_exp[y] = FFT_BFP_EXP_ZERO;
+            continue;
+        }
+
+        /* One exponent per output row: the row max lands on 15 bits. */
+        const int e_row = e_top - 15;
+        for (int x = 0; x < FC_FFT_N; x++)
+        {
+            if (z_e[x] == FFT_BFP_EXP_ZERO)
             {
-                max_votes = class_votes[c];
-                pred = (int)c;
+                z16[2 * x + 0] = 0;
+                z16[2 * x + 1] = 0;
+                continue;
             }
+            const int sh = e_row - (int)z_e[x];
+            z16[2 * x + 0] = fc128_fx_narrow_s64(z_re[x], sh);
+            z16[2 * x + 1] = fc128_fx_narrow_s64(z_im[x], sh);
         }
 
-        /* Estimate best_score and best_prob from voting statistics. */
-        float best_score = (max_votes > 0) ? ((float)max_votes / (float)(block_rows * block_cols)) : 0.0f;
-        float best_prob = best_score; /* Simplified: use voting fraction as confidence. */
+        row_exp[y] = (int8_t)((e_row < -127) ? -127 : ((e_row > 127) ? 127 : e_row));
+        (void)hyperram_b_write(z16, (void *)(frame_base_offset + FC128_FX_ZHAT + (uint32_t)y * row_bytes), row_bytes);
+    }
+}
+
+/* Fixed-point FC core: PQ128 p/q planes -> float Z plane at z_offset (FC_FFT_N x FC_FFT_N). */
+static void fc128_solve_z_from_pq_fixed(uint32_t frame_base_offset, uint32_t z_offset, fc128_solve_stamps_t *st)
+{
+    static int8_t s_row_exp[FC_FFT_N];
+    static int8_t s_col_exp[FC_FFT_N];
+    const uint32_t spec = frame_base_offset + (uint32_t)FC128_FX_SPEC;
+    const uint32_t zhat = frame_base_offset + (uint32_t)FC128_FX_ZHAT;
+
+    st->t_start = fc128_dwt_now();
+
+    fc128_fx_build_packed_plane(frame_base_offset, s_row_exp);
+
+    st->t_build = fc128_dwt_now();
+
+    /* FFT2(P + jQ): rows keep per-row exponents, columns leave per-column exponents. */
+    fft_bfp16_rows_hyperram(spec, FC_FFT_N, FC_FFT_N, s_row_exp, s_row_exp, false);
+    fft_bfp16_cols_hyperram(spec, FC_FFT_N, FC_FFT_N, s_row_exp, s_col_exp, false);
+
+    st->t_fft_p = fc128_dwt_now();
+    st->t_fft_q = st->t_fft_p;
+
+    fc128_fx_build_zhat(frame_base_offset, s_col_exp, s_row_exp);
+
+    st->t_zhat = fc128_dwt_now();
+
+    /* IFFT2(Z_hat): real part to float with the N/(2*pi) factor dropped in fc128_fx_build_zhat(). */
+    fft_bfp16_rows_hyperram(zhat, FC_FFT_N, FC_FFT_N, s_row_exp, s_row_exp, true);
+    fft_bfp16_cols_to_real_f32_hyperram(zhat, FC_FFT_N, FC_FFT_N, s_row_exp,
+                                        frame_base_offset + z_offset, (uint32_t)FC_FFT_N,
+                                        (float)FC_FFT_N / 6.2831853071795864769f, true);
+
+    st->t_ifft = fc128_dwt_now();
+}
+
+#if FC128_FIXED_VERIFY_PERIOD
+/* RMSE of the fixed-point Z against the float Z over the exported FC_RESULT_N crop. */
+static void fc128_fx_log_rmse(uint32_t frame_base_offset, uint32_t ref_offset, uint32_t fx_offset)
+{
+    float ref_row[FC_RESULT_N];
+    float fx_row[FC_RESULT_N];
+    double se = 0.0;
+    double sref = 0.0;
+    float max_abs = 0.0f;
 
+    for (int y = 0; y < FC_RESULT_N; y++)
+    {
+        const uint32_t off = (uint32_t)((FC_PAD_Y0 + y) * FC_FFT_N + FC_PAD_X0) * (uint32_t)sizeof(float);
+        (void)hyperram_b_read(ref_row, (void *)(frame_base_offset + ref_offset + off), (uint32_t)sizeof(ref_row));
+        (void)hyperram_b_read(fx_row, (void *)(frame_base_offset + fx_offset + off), (uint32_t)sizeof(fx_row));
+        for (int x = 0; x < FC_RESULT_N; x++)
         {
-            static int s_last_pred = -9999;
-            static int s_stable_pred = -9999;
-            static uint32_t s_stable_count = 0U;
-            bool do_print = false;
-            if (HLAC_UART_LOG_ON_CHANGE)
-            {
-                if (pred != s_last_pred)
-                {
-                    do_print = true;
-                }
-            }
-            if (!do_print && (HLAC_UART_LOG_PERIOD > 0U))
+            const float d = fx_row[x] - ref_row[x];
+            se += (double)d * (double)d;
+            sref += (double)ref_row[x] * (double)ref_row[x];
+            if (fabsf(d) > max_abs)
             {
-                if ((frame_seq % HLAC_UART_LOG_PERIOD) == 0U)
-                {
-                    do_print = true;
-                }
-            }
-            if (do_print)
-            {
-                /* ANSI: move cursor up (block_rows+1) lines to overwrite previous grid in-place.
-                 * ESC[<N>A = cursor up N lines.  Works in TeraTerm/PuTTY/VSCode with ANSI enabled.
-                 * s_grid_printed tracks whether we have already drawn the grid once.
-                 */
-                static bool s_grid_printed = false;
-                if (s_grid_printed)
-                {
-                    /* +1 for the header line */
-                    xprintf("\033[%dA\r", (int)(block_rows + 1));
-                }
-
-                xprintf("--- pred=%d votes=%d/%lu conf=%.2f ---\n",
-                        pred, max_votes, (unsigned long)(block_rows * block_cols), best_prob);
-                for (uint32_t br = 0; br < block_rows; br++)
-                {
-                    xprintf("|");
-                    for (uint32_t bc = 0; bc < block_cols; bc++)
-                    {
-                        int bp = block_grid[br][bc];
-                        if (bp == pred)
-                        {
-                            xprintf("[%d]", bp); /* winner highlighted with brackets */
-                        }
-                        else
-                        {
-                            xprintf(" %d ", bp);
-                        }
-                    }
-                    xprintf("|\n");
-                }
-                s_grid_printed = true;
-                s_last_pred = pred;
-            }
-
-            /* Motor command update: only post when pred is stable (same logic as full-frame mode). */
-            bool pass_prob = true;
-#if HLAC_INFER_SOFTMAX_ENABLE
-            pass_prob = (best_prob >= (float)HLAC_INFER_MIN_BEST_PROB);
-#endif
-            if ((best_score >= (float)MOTOR_PRED_MIN_BEST_SCORE) && pass_prob && pred >= 0)
-            {
-                if (pred == s_stable_pred)
-                {
-                    if (s_stable_count < 0xFFFFFFFFU)
-                    {
-                        s_stable_count++;
-                    }
-                }
-                else
-                {
-                    s_stable_pred = pred;
-                    s_stable_count = 1U;
-                }
-
-                if (s_stable_count >= (uint32_t)MOTOR_PRED_STABLE_COUNT)
-                {
-                    motor_control_post_pred(pred);
-                    s_stable_count = 0U;
-                }
+                max_abs = fabsf(d);
             }
         }
     }
 
-#else
-    /* Traditional full-frame HLAC inference. */
-    float feats[25];
-    hlac25_compute_from_u8_hyperram(frame_base_offset + (uint32_t)DEPTH_OFFSET,
-#if HLAC_PQ_MAG_TRUE_256
-                                    (uint32_t)HLAC_PQ_MAG_TRUE_W,
-                                    (uint32_t)HLAC_PQ_MAG_TRUE_H,
-#else
-                                    (uint32_t)PQ128_SRC_W,
-                                    (uint32_t)PQ128_SRC_H,
-#endif
-                                    feats);
-    float best_score = 0.0f;
-#if HLAC_INFER_SOFTMAX_ENABLE
-    float best_prob = 0.0f;
-    int pred = hlac_lda_predict_ex(feats, &best_score, &best_prob, 1);
-#else
-    int pred = hlac_lda_predict_ex(feats, &best_score, NULL, 0);
+    const double n = (double)FC_RESULT_N * (double)FC_RESULT_N;
+    const float rmse = (float)sqrt(se / n);
+    const float ref_rms = (float)sqrt(sref / n);
+    BINLOG4("[FC-FX] rmse=%.6f ref_rms=%.6f rel=%.6f max_abs=%.6f\n",
+            BINLOG_F(rmse), BINLOG_F(ref_rms), BINLOG_F((ref_rms > 0.0f) ? (rmse / ref_rms) : 0.0f), BINLOG_F(max_abs));
+}
 #endif
-    {
-        static int s_last_pred = -9999;
-        static int s_stable_pred = -9999;
-        static uint32_t s_stable_count = 0U;
-        bool do_print = false;
-        if (HLAC_UART_LOG_ON_CHANGE)
-        {
-            if (pred != s_last_pred)
-            {
-                do_print = true;
-            }
-        }
-        if (!do_print && (HLAC_UART_LOG_PERIOD > 0U))
-        {
-            if ((frame_seq % HLAC_UART_LOG_PERIOD) == 0U)
-            {
-                do_print = true;
-            }
-        }
-        if (do_print)
-        {
-#if HLAC_INFER_SOFTMAX_ENABLE
-            xprintf("pred=%d prob=%.3f\n", pred, best_prob);
-#else
-            xprintf("pred=%d\n", pred);
 #endif
-            s_last_pred = pred;
-        }
 
-        /* Motor command update: only post when pred is stable. */
-        bool pass_prob = true;
-#if HLAC_INFER_SOFTMAX_ENABLE
-        pass_prob = (best_prob >= (float)HLAC_INFER_MIN_BEST_PROB);
-#endif
-        if ((best_score >= (float)MOTOR_PRED_MIN_BEST_SCORE) && pass_prob)
+/* Float FC core: PQ128 p/q planes -> Z plane (FC128_Z_REAL, result in the FC_PAD_X0/FC_PAD_Y0 crop).
+ * Returns false (Z untouched) when no FFT plan exists for FC_FFT_N.
+ */
+static FC128_UNUSED bool fc128_solve_z_from_pq_float(uint32_t frame_base_offset, fc128_solve_stamps_t *st)
+{
+    /* FFT plans are built once (twiddle/bitrev/CMSIS instance cached per size). */
+    static fft_plan2d_t s_plan_fwd;
+    static fft_plan2d_t s_plan_inv;
+    static int8_t s_plan_state = 0; // 0: 未作成, 1: 作成済み, -1: 作れない(ログは1回だけ)
+    if (s_plan_state == 0)
+    {
+        const bool ok = fft_plan2d_init(&s_plan_fwd, FC_FFT_N, FC_FFT_N, false) &&
+                        fft_plan2d_init(&s_plan_inv, FC_FFT_N, FC_FFT_N, true);
+        s_plan_state = ok ? 1 : -1;
+        if (!ok)
         {
-            if (pred == s_stable_pred)
-            {
-                if (s_stable_count < 0xFFFFFFFFU)
-                {
-                    s_stable_count++;
-                }
-            }
-            else
-            {
-                s_stable_pred = pred;
-                s_stable_count = 1U;
-            }
-
-            if (s_stable_count >= (uint32_t)MOTOR_PRED_STABLE_COUNT)
-            {
-                motor_control_post_pred(pred);
-                s_stable_count = 0U;
-            }
+            xprintf("[FC] ERROR: no FFT plan for N=%d, FC disabled\n", (int)FC_FFT_N);
         }
     }
-#endif
-
-    __DMB();
-    g_depth_size_bytes = out_bytes;
-    __DMB();
-    g_depth_base_offset = frame_base_offset;
-    __DMB();
-    g_depth_seq = frame_seq;
-    return;
-#endif
-#endif
-
-#if FC128_TIMING_ENABLE
-    fc128_dwt_init_once();
-    uint32_t t0 = fc128_dwt_now();
-    uint32_t t_fft_p = t0;
-    uint32_t t_fft_q = t0;
-#endif
-
-    fc128_layout_check_once(frame_base_offset);
-    if ((frame_base_offset + (uint32_t)FC128_TOTAL_SCRATCH_END) > (uint32_t)HYPERRAM_SIZE)
+    if (s_plan_state < 0)
     {
-        /* Avoid corrupting memory if configuration/layout is invalid. */
-        return;
+        return false;
     }
 
+    st->t_start = fc128_dwt_now();
+
     fc128_build_float_planes_from_pq(frame_base_offset);
 
-#if FC128_TIMING_ENABLE
-    uint32_t t_build = fc128_dwt_now();
-#endif
+    st->t_build = fc128_dwt_now();
 
     /* FFT(P) and FFT(Q)
      * - Packed path: FFT(P + jQ) once.
@@ -2265,18 +2545,16 @@ static void fc128_compute_depth_and_store(uint32_t frame_base_offset, uint32_t f
      */
 #if FC128_USE_PACKED_PQ_FFT
     fft_2d_hyperram_full(
+        &s_plan_fwd,
         frame_base_offset + FC128_P_REAL,
         frame_base_offset + FC128_Q_REAL,
         frame_base_offset + FC128_Z_HAT_REAL,
         frame_base_offset + FC128_Z_HAT_IMAG,
         frame_base_offset + FC128_TMP_REAL,
-        frame_base_offset + FC128_TMP_IMAG,
-        FC_FFT_N, FC_FFT_N, false);
+        frame_base_offset + FC128_TMP_IMAG);
 
-#if FC128_TIMING_ENABLE
-    t_fft_p = fc128_dwt_now();
-    t_fft_q = t_fft_p; /* Packed path runs only one forward FFT */
-#endif
+    st->t_fft_p = fc128_dwt_now();
+    st->t_fft_q = st->t_fft_p; /* Packed path runs only one forward FFT */
 
 #if FC128_PACKED_DIRECT_ZHAT
     fc128_build_zhat_from_packed_spectrum(frame_base_offset);
@@ -2287,1041 +2565,2868 @@ static void fc128_compute_depth_and_store(uint32_t frame_base_offset, uint32_t f
 
 #else
     fft_2d_hyperram_full(
+        &s_plan_fwd,
         frame_base_offset + FC128_P_REAL,
         frame_base_offset + FC128_P_IMAG,
         frame_base_offset + FC128_P_HAT_REAL,
         frame_base_offset + FC128_P_HAT_IMAG,
         frame_base_offset + FC128_TMP_REAL,
-        frame_base_offset + FC128_TMP_IMAG,
-        FC_FFT_N, FC_FFT_N, false);
+        frame_base_offset + FC128_TMP_IMAG);
 
-#if FC128_TIMING_ENABLE
-    t_fft_p = fc128_dwt_now();
-#endif
+    st->t_fft_p = fc128_dwt_now();
 
     fft_2d_hyperram_full(
+        &s_plan_fwd,
         frame_base_offset + FC128_Q_REAL,
         frame_base_offset + FC128_Q_IMAG,
         frame_base_offset + FC128_Q_HAT_REAL,
         frame_base_offset + FC128_Q_HAT_IMAG,
         frame_base_offset + FC128_TMP_REAL,
-        frame_base_offset + FC128_TMP_IMAG,
-        FC_FFT_N, FC_FFT_N, false);
+        frame_base_offset + FC128_TMP_IMAG);
 
-#if FC128_TIMING_ENABLE
-    t_fft_q = fc128_dwt_now();
-#endif
+    st->t_fft_q = fc128_dwt_now();
 
     fc128_compute_zhat(frame_base_offset);
 #endif
 
-#if FC128_TIMING_ENABLE
-    uint32_t t_zhat = fc128_dwt_now();
-#endif
+    st->t_zhat = fc128_dwt_now();
 
     /* IFFT(Z_hat) -> Z */
     fft_2d_hyperram_full(
+        &s_plan_inv,
         frame_base_offset + FC128_Z_HAT_REAL,
         frame_base_offset + FC128_Z_HAT_IMAG,
         frame_base_offset + FC128_Z_REAL,
         frame_base_offset + FC128_Z_IMAG,
         frame_base_offset + FC128_TMP_REAL,
-        frame_base_offset + FC128_TMP_IMAG,
-        FC_FFT_N, FC_FFT_N, true);
-
-#if FC128_TIMING_ENABLE
-    uint32_t t_ifft = fc128_dwt_now();
-#endif
-
-    fc128_export_depth_u8_320x240(frame_base_offset);
+        frame_base_offset + FC128_TMP_IMAG);
 
-#if FC128_TIMING_ENABLE
-    uint32_t t_export = fc128_dwt_now();
+    st->t_ifft = fc128_dwt_now();
+    return true;
+}
 
-    if ((FC128_TIMING_LOG_PERIOD != 0U) && ((frame_seq % (uint32_t)FC128_TIMING_LOG_PERIOD) == 0U))
+/* FC core: PQ128 p/q planes -> Z plane (FC128_Z_REAL, result in the FC_PAD_X0/FC_PAD_Y0 crop).
+ * Returns false when Z was not produced (the caller skips export/publish).
+ */
+static bool fc128_solve_z_from_pq(uint32_t frame_base_offset, fc128_solve_stamps_t *st)
+{
+#if FC128_FIXED_POINT
+#if FC128_FIXED_VERIFY_PERIOD
+    static uint32_t s_verify_count = 0U;
+    if (++s_verify_count >= (uint32_t)FC128_FIXED_VERIFY_PERIOD)
     {
-        uint32_t c_build = (uint32_t)(t_build - t0);
-        uint32_t c_fft_p = (uint32_t)(t_fft_p - t_build);
-        uint32_t c_fft_q = (uint32_t)(t_fft_q - t_fft_p);
-        uint32_t c_zhat = (uint32_t)(t_zhat - t_fft_q);
-        uint32_t c_ifft = (uint32_t)(t_ifft - t_zhat);
-        uint32_t c_export = (uint32_t)(t_export - t_ifft);
-        uint32_t c_total = (uint32_t)(t_export - t0);
-
-        xprintf("[FC128] cyc build=%lu fftP=%lu fftQ=%lu zhat=%lu ifft=%lu export=%lu total=%lu\n",
-                (unsigned long)c_build,
-                (unsigned long)c_fft_p,
-                (unsigned long)c_fft_q,
-                (unsigned long)c_zhat,
-                (unsigned long)c_ifft,
-                (unsigned long)c_export,
-                (unsigned long)c_total);
-
-        xprintf("[FC128] us  build=%lu fftP=%lu fftQ=%lu zhat=%lu ifft=%lu export=%lu total=%lu (core=%lu Hz)\n",
-                (unsigned long)fc128_cyc_to_us(c_build),
-                (unsigned long)fc128_cyc_to_us(c_fft_p),
-                (unsigned long)fc128_cyc_to_us(c_fft_q),
-                (unsigned long)fc128_cyc_to_us(c_zhat),
-                (unsigned long)fc128_cyc_to_us(c_ifft),
-                (unsigned long)fc128_cyc_to_us(c_export),
-                (unsigned long)fc128_cyc_to_us(c_total),
-                (unsigned long)SystemCoreClock);
+        s_verify_count = 0U;
+        /* float の plan が無ければ比較は飛ばして固定小数点だけで解く */
+        if (fc128_solve_z_from_pq_float(frame_base_offset, st))
+        {
+            fc128_solve_z_from_pq_fixed(frame_base_offset, (uint32_t)FC128_FX_VERIFY_Z, st);
+            fc128_fx_log_rmse(frame_base_offset, (uint32_t)FC128_Z_REAL, (uint32_t)FC128_FX_VERIFY_Z);
+            return true;
+        }
+    }
+#endif
+    fc128_solve_z_from_pq_fixed(frame_base_offset, (uint32_t)FC128_Z_REAL, st);
+#else
+    if (!fc128_solve_z_from_pq_float(frame_base_offset, st))
+    {
+        return false;
     }
 #endif
 
-    __DMB();
-    g_depth_size_bytes = (uint32_t)DEPTH_BYTES;
-    __DMB();
-    g_depth_base_offset = frame_base_offset;
-    __DMB();
-    g_depth_seq = frame_seq;
+    prof_record(PROF_SPAN_FC_BUILD, st->t_build - st->t_start);
+    prof_record(PROF_SPAN_FC_FFT, st->t_fft_q - st->t_build);
+    prof_record(PROF_SPAN_FC_ZHAT, st->t_zhat - st->t_fft_q);
+    prof_record(PROF_SPAN_FC_IFFT, st->t_ifft - st->t_zhat);
+    return true;
 }
 
-static inline void reorder_grayscale_4px_line(uint8_t *buf, uint32_t n)
-{
-    /* Swap [0..1] with [2..3] within each 4px group (matches Thread1 grayscale send fix). */
-    uint32_t i = 0;
+#if FC128_TILED_ENABLE
+/* Defined after the PQ128 kernels (needs pq128_compute_tile_fast). */
+static void fc128_compute_depth_tiled(uint32_t frame_base_offset, uint32_t frame_seq);
+#endif
 
-#if USE_HELIUM_MVE
-    /* Vectorize by treating each 4px group as one 32-bit word:
-     * [a0 a1 a2 a3] -> [a2 a3 a0 a1] == rotate-by-16 within 32-bit.
-     * Process 4 groups (16 bytes) per loop.
-     */
-    for (; (i + 3U) < n && (((uintptr_t)(&buf[i])) & 3U); i += 4U)
+#if HLAC_ENABLE && HLAC_LDA_INFER_ENABLE && HLAC_INFER_BLOCK_MODE
+/* block_grid markers (grid display) */
+#define HLAC_BLOCK_BACKGROUND (-2)
+#define HLAC_BLOCK_SKIPPED (-3)
+
+#define HLAC_BLOCK_COUNT ((uint32_t)HLAC_BLOCK_ROWS * (uint32_t)HLAC_BLOCK_COLS)
+
+/* Best-class probability of each block in the last frame it was evaluated. */
+static float s_hlac_block_conf[HLAC_BLOCK_COUNT];
+
+/* Evaluation order: most informative blocks first. */
+static void hlac_cascade_order(uint8_t order[HLAC_BLOCK_COUNT])
+{
+    uint32_t dist[HLAC_BLOCK_COUNT];
+    for (uint32_t i = 0; i < HLAC_BLOCK_COUNT; i++)
     {
-        uint8_t a0 = buf[i];
-        uint8_t a1 = buf[i + 1U];
-        buf[i] = buf[i + 2U];
-        buf[i + 1U] = buf[i + 3U];
-        buf[i + 2U] = a0;
-        buf[i + 3U] = a1;
+        /* squared distance from the grid center in half-block units */
+        const int32_t dx = 2 * (int32_t)(i % (uint32_t)HLAC_BLOCK_COLS) + 1 - (int32_t)HLAC_BLOCK_COLS;
+        const int32_t dy = 2 * (int32_t)(i / (uint32_t)HLAC_BLOCK_COLS) + 1 - (int32_t)HLAC_BLOCK_ROWS;
+        dist[i] = (uint32_t)(dx * dx + dy * dy);
+        order[i] = (uint8_t)i;
     }
-
-    for (; (i + 15U) < n; i += 16U)
+#if HLAC_CASCADE_ENABLE && (HLAC_CASCADE_ORDER != 0)
+    /* insertion sort: conf desc (ORDER=2), then center distance, then raster */
+    for (uint32_t i = 1U; i < HLAC_BLOCK_COUNT; i++)
     {
-        uint32x4_t v = vld1q_u32((const uint32_t *)&buf[i]);
-        uint32x4_t hi = vshrq_n_u32(v, 16);
-        uint32x4_t lo = vshlq_n_u32(v, 16);
-        uint32x4_t r = vorrq_u32(hi, lo);
-        vst1q_u32((uint32_t *)&buf[i], r);
+        const uint8_t v = order[i];
+        uint32_t j = i;
+        while (j > 0U)
+        {
+            const uint8_t u = order[j - 1U];
+            bool before = (dist[v] < dist[u]);
+#if HLAC_CASCADE_ORDER == 2
+            if (s_hlac_block_conf[v] > s_hlac_block_conf[u])
+            {
+                before = true;
+            }
+            else if (s_hlac_block_conf[v] < s_hlac_block_conf[u])
+            {
+                before = false;
+            }
+#endif
+            if (!before)
+            {
+                break;
+            }
+            order[j] = u;
+            j--;
+        }
+        order[j] = v;
     }
+#else
+    (void)dist;
 #endif
+}
 
-    for (; i + 3U < n; i += 4U)
+/* true when the leader cannot be overturned by `remaining` more votes. */
+static FC128_UNUSED bool hlac_cascade_decided(const int votes[HLAC_MAX_CLASSES], uint32_t num_classes, uint32_t remaining)
+{
+    int v1 = 0;
+    int v2 = 0;
+    for (uint32_t c = 0; c < num_classes; c++)
     {
-        uint8_t a0 = buf[i];
-        uint8_t a1 = buf[i + 1U];
-        buf[i] = buf[i + 2U];
-        buf[i + 1U] = buf[i + 3U];
-        buf[i + 2U] = a0;
-        buf[i + 3U] = a1;
+        if (votes[c] > v1)
+        {
+            v2 = v1;
+            v1 = votes[c];
+        }
+        else if (votes[c] > v2)
+        {
+            v2 = votes[c];
+        }
     }
+    return v1 > (v2 + (int)remaining);
 }
 
-static void extract_y_line_uyvy_swap_y(const uint8_t *yuv, uint8_t *y_out, uint32_t width)
+#if HLAC_CASCADE_ENABLE && (HLAC_CASCADE_REPORT_FRAMES > 0U)
+extern uint32_t SystemCoreClock;
+
+typedef struct
 {
-    /* UYVY: [U0 Y0 V0 Y1] but swap Y: output (Y1,Y0) to match current tuned grayscale view. */
-    uint32_t x = 0;
+    uint32_t frames;
+    uint32_t evaluated;  // blocks that ran LDA
+    uint32_t background; // blocks rejected by the energy pre-filter
+    uint64_t loop_cyc;   // whole block loop
+    uint64_t eval_cyc;   // featurize + LDA of evaluated blocks
+} hlac_cascade_stats_t;
 
-#if USE_HELIUM_MVE
-    /* 16 pixels = 32 bytes per iteration.
-     * Input layout per 2 pixels (4 bytes): [U0 Y0 V0 Y1]
-     * Output swaps Y within the pair: [Y1 Y0]
-     */
-    for (; (x + 15U) < width; x += 16U)
-    {
-        const uint8x16_t yuv_low = vld1q_u8(&yuv[x * 2U]);
-        const uint8x16_t yuv_high = vld1q_u8(&yuv[x * 2U + 16U]);
-
-        uint8_t tmp[16];
-        tmp[0] = yuv_low[3];
-        tmp[1] = yuv_low[1];
-        tmp[2] = yuv_low[7];
-        tmp[3] = yuv_low[5];
-        tmp[4] = yuv_low[11];
-        tmp[5] = yuv_low[9];
-        tmp[6] = yuv_low[15];
-        tmp[7] = yuv_low[13];
-        tmp[8] = yuv_high[3];
-        tmp[9] = yuv_high[1];
-        tmp[10] = yuv_high[7];
-        tmp[11] = yuv_high[5];
-        tmp[12] = yuv_high[11];
-        tmp[13] = yuv_high[9];
-        tmp[14] = yuv_high[15];
-        tmp[15] = yuv_high[13];
-
-        vst1q_u8(&y_out[x], vld1q_u8(tmp));
-    }
-#endif
+static hlac_cascade_stats_t s_hlac_cascade_stats;
 
-    for (; x < width; x += 2U)
-    {
-        uint32_t yuv_idx = x * 2U;
-        y_out[x] = yuv[yuv_idx + 3U];
-        y_out[x + 1U] = yuv[yuv_idx + 1U];
-    }
-    reorder_grayscale_4px_line(y_out, width);
+static uint32_t hlac_cascade_cyc_to_us(uint64_t cyc)
+{
+    const uint32_t hz = SystemCoreClock;
+    return (hz > 0U) ? (uint32_t)((cyc * 1000000ULL) / (uint64_t)hz) : 0U;
 }
 
-#if PQ128_USE_CHROMA_EDGEMASK
-static void extract_chroma_mag_line_uyvy_reorder(const uint8_t *yuv, uint8_t *c_out, uint32_t width)
+static void hlac_cascade_account(uint32_t evaluated, uint32_t background, uint32_t loop_cyc, uint32_t eval_cyc)
 {
-    /* UYVY: [U0 Y0 V0 Y1] per 2 pixels.
-     * Compute a simple chroma magnitude proxy per pixel:
-     *   C = |U-128| + |V-128|  (clamped to 0..255)
-     * Duplicate to both pixels of the pair, then apply the same 4px reorder
-     * as the grayscale path so indexing matches y_out.
-     */
-    for (uint32_t x = 0; x < width; x += 2U)
+    hlac_cascade_stats_t *st = &s_hlac_cascade_stats;
+    st->frames++;
+    st->evaluated += evaluated;
+    st->background += background;
+    st->loop_cyc += loop_cyc;
+    st->eval_cyc += eval_cyc;
+    if (st->frames < (uint32_t)HLAC_CASCADE_REPORT_FRAMES)
     {
-        uint32_t idx = x * 2U;
-        int u = (int)yuv[idx + 0U];
-        int v = (int)yuv[idx + 2U];
-        int du = u - 128;
-        int dv = v - 128;
-        if (du < 0)
-        {
-            du = -du;
-        }
-        if (dv < 0)
-        {
-            dv = -dv;
-        }
-        int c = du + dv;
-        if (c > 255)
-        {
-            c = 255;
-        }
-        c_out[x] = (uint8_t)c;
-        if ((x + 1U) < width)
-        {
-            c_out[x + 1U] = (uint8_t)c;
-        }
+        return;
     }
-    reorder_grayscale_4px_line(c_out, width);
+
+    /* Saved time is estimated from the mean cost of an evaluated block. */
+    const float n = (float)st->frames;
+    const uint64_t per_block = (st->evaluated > 0U) ? (st->eval_cyc / st->evaluated) : 0U;
+    const uint64_t full_cyc = per_block * (uint64_t)HLAC_BLOCK_COUNT * (uint64_t)st->frames;
+    const uint64_t saved_cyc = (full_cyc > st->loop_cyc) ? (full_cyc - st->loop_cyc) : 0U;
+    BINLOG4("[CASCADE] blocks eval=%.2f bg=%.2f of %u, loop=%uus/frame\n",
+            BINLOG_F((float)st->evaluated / n), BINLOG_F((float)st->background / n),
+            HLAC_BLOCK_COUNT, hlac_cascade_cyc_to_us(st->loop_cyc / st->frames));
+    BINLOG2("[CASCADE] saved~%uus/frame (all blocks~%uus)\n",
+            hlac_cascade_cyc_to_us(saved_cyc / st->frames), hlac_cascade_cyc_to_us(full_cyc / st->frames));
+    memset(st, 0, sizeof(*st));
 }
 #endif
+#endif
 
-static inline int clamp_i32(int v, int lo, int hi)
+#if HLAC_ENABLE && HLAC_LDA_INFER_ENABLE && HLAC_TEMPORAL_ENABLE
+static hlac_temporal_t s_hlac_temporal;
+
+/* Lazy init: the class count comes from the linked model. */
+static void hlac_temporal_frame_begin(void)
 {
-    if (v < lo)
-    {
-        return lo;
-    }
-    if (v > hi)
+    if (s_hlac_temporal.num_classes == 0U)
     {
-        return hi;
+        hlac_temporal_init(&s_hlac_temporal, g_hlac_lda_num_classes);
     }
-    return v;
 }
+#endif
 
-/* Compute Q15 weight based on saturation proximity (1.0 .. 0.0). */
-static inline int32_t pq128_sat_weight_q15(int i0, int i1)
+static void fc128_compute_depth_and_store(uint32_t frame_base_offset, uint32_t frame_seq)
 {
-    int mx = (i0 > i1) ? i0 : i1;
-    if (mx >= PQ128_SAT_TH)
-    {
-        return 0;
-    }
+    g_depth_seq = 0;
+    g_depth_size_bytes = 0;
 
-#if PQ128_USE_SAT_SOFTMASK
-    if (mx <= PQ128_SAT_SOFT_START)
-    {
-        return (1 << 15);
-    }
-    int span = (PQ128_SAT_TH - PQ128_SAT_SOFT_START);
-    if (span <= 0)
-    {
-        return (1 << 15);
-    }
-    int num = (PQ128_SAT_TH - mx);
-    int32_t w = (int32_t)(((int64_t)num << 15) / (int64_t)span);
-    w = clamp_i32((int)w, 0, (1 << 15));
-#if PQ128_SAT_SOFT_POWER2
-    /* Quadratic falloff: w <- w^2 (Q15) */
-    w = (int32_t)(((int64_t)w * (int64_t)w + (1 << 14)) >> 15);
-#endif
-    return w;
+#if HLAC_ENABLE
+    /* In HLAC mode, reuse the depth export slot to record |P|+|Q| (u8).
+     * This avoids the heavy FC FFT pipeline.
+     */
+#if HLAC_PQ_MAG_TRUE_256
+    const uint32_t out_bytes = (uint32_t)HLAC_PQ_MAG_TRUE_W * (uint32_t)HLAC_PQ_MAG_TRUE_H;
 #else
-    return (1 << 15);
+    const uint32_t out_bytes = (uint32_t)PQ128_SRC_W * (uint32_t)PQ128_SRC_H;
 #endif
-}
-
-#if PQ128_USE_DARK_SOFTMASK
-static inline int32_t pq128_dark_weight_q15(int i0, int i1)
-{
-    /* Use average intensity as a simple SNR proxy. */
-    int avg = (i0 + i1) >> 1;
-
-    if (avg <= PQ128_DARK_TH)
-    {
-        return 0;
-    }
-    if (avg >= PQ128_DARK_SOFT_END)
-    {
-        return (1 << 15);
-    }
-
-    int span = (PQ128_DARK_SOFT_END - PQ128_DARK_TH);
-    if (span <= 0)
+    if ((frame_base_offset + (uint32_t)DEPTH_OFFSET + out_bytes) > (uint32_t)HYPERRAM_SIZE)
     {
-        return 0;
+        return;
     }
-    int num = (avg - PQ128_DARK_TH);
-    int32_t w = (int32_t)(((int64_t)num << 15) / (int64_t)span);
-    w = clamp_i32((int)w, 0, (1 << 15));
 
-#if PQ128_DARK_SOFT_POWER2
-    w = (int32_t)(((int64_t)w * (int64_t)w + (1 << 14)) >> 15);
+#if HLAC_FUSED_STREAM
+    /* Rows go straight into SRAM accumulators; the HyperRAM copy is only for the debug stream. */
+    static hlac25_stream_t s_hlac_stream;
+    hlac25_stream_t *hs = &s_hlac_stream;
+#if HLAC_FUSED_DEBUG_EXPORT == 0
+    const bool export_image = false;
+#elif HLAC_FUSED_DEBUG_EXPORT == 1
+    const bool export_image = (g_depth_export_request != 0U);
+#else
+    const bool export_image = true;
 #endif
-    return w;
-}
+#if HLAC_PQ_MAG_TRUE_256
+    const uint32_t hs_w = (uint32_t)HLAC_PQ_MAG_TRUE_W;
+    const uint32_t hs_h = (uint32_t)HLAC_PQ_MAG_TRUE_H;
+#else
+    const uint32_t hs_w = (uint32_t)PQ128_SRC_W;
+    const uint32_t hs_h = (uint32_t)PQ128_SRC_H;
 #endif
-
-#if PQ128_USE_CHROMA_EDGEMASK
-static inline int32_t pq128_chroma_edge_weight_q15(int edge)
-{
-    if (edge <= PQ128_CHROMA_EDGE_START)
-    {
-        return (1 << 15);
-    }
-    if (edge >= PQ128_CHROMA_EDGE_TH)
-    {
-        return 0;
-    }
-    int span = (PQ128_CHROMA_EDGE_TH - PQ128_CHROMA_EDGE_START);
-    if (span <= 0)
+#if HLAC_INFER_BLOCK_MODE
+    const int hs_ok = hlac25_stream_init(hs, hs_w, hs_h, (uint32_t)HLAC_BLOCK_COLS, (uint32_t)HLAC_BLOCK_ROWS);
+#else
+    const int hs_ok = hlac25_stream_init(hs, hs_w, hs_h, 1U, 1U);
+#endif
+    if (hs_ok != 0)
     {
-        return 0;
+        return;
     }
-    int num = (PQ128_CHROMA_EDGE_TH - edge);
-    int32_t w = (int32_t)(((int64_t)num << 15) / (int64_t)span);
-    w = clamp_i32((int)w, 0, (1 << 15));
-#if PQ128_CHROMA_EDGE_POWER2
-    w = (int32_t)(((int64_t)w * (int64_t)w + (1 << 14)) >> 15);
-#endif
-    return w;
-}
+#else
+    hlac25_stream_t *hs = NULL;
+    const bool export_image = true;
 #endif
 
-#if PQ128_COMPUTE_DEFOCUS_PLANES
-/* Simple horizontal blur: [1 2 1]/4. Border pixels are copied. */
-static inline void pq128_blur121_u8_line(const uint8_t in_u8[FRAME_WIDTH], uint8_t out_u8[FRAME_WIDTH])
-{
-    out_u8[0] = in_u8[0];
-    out_u8[FRAME_WIDTH - 1] = in_u8[FRAME_WIDTH - 1];
-    for (int x = 1; x < FRAME_WIDTH - 1; x++)
+#if HLAC_PQ_MAG_TRUE_256
+    hlac_export_pq_mag_u8_true256_from_y(frame_base_offset, hs, export_image);
+#else
+    if ((frame_base_offset + (uint32_t)PQ128_Q_OFFSET + (uint32_t)PQ128_PLANE_BYTES) > (uint32_t)HYPERRAM_SIZE)
     {
-        int v = (int)in_u8[x - 1] + ((int)in_u8[x] << 1) + (int)in_u8[x + 1];
-        v = (v + 2) >> 2;
-        out_u8[x] = (uint8_t)v;
+        return;
     }
-}
-
-#endif /* PQ128_COMPUTE_DEFOCUS_PLANES */
+    hlac_export_pq_mag_u8_roi(frame_base_offset, hs, export_image);
+#endif
+    latency_trace_stamp(frame_seq, LATENCY_STAGE_PQ_DONE);
+#if HLAC_FUSED_STREAM
+    hlac25_stream_finish(hs);
+    latency_trace_stamp(frame_seq, LATENCY_STAGE_HLAC_DONE);
+#endif
 
-#if PQ128_USE_FOCUS_SOFTMASK
+#if HLAC_LDA_INFER_ENABLE
 
-static inline int32_t pq128_focus_weight_q15(int focus)
-{
-    if (focus <= PQ128_FOCUS_TH)
-    {
-        return 0;
-    }
-    if (focus >= PQ128_FOCUS_SOFT_END)
+#if HLAC_INFER_BLOCK_MODE
+    /* Block-wise HLAC inference with majority voting (cascaded, see HLAC_CASCADE_ENABLE). */
     {
-        return (1 << 15);
-    }
+        uint32_t img_w = 0U;
+        uint32_t img_h = 0U;
+#if HLAC_PQ_MAG_TRUE_256
+        img_w = HLAC_PQ_MAG_TRUE_W;
+        img_h = HLAC_PQ_MAG_TRUE_H;
+#else
+        img_w = PQ128_SRC_W;
+        img_h = PQ128_SRC_H;
+#endif
 
-    int span = (PQ128_FOCUS_SOFT_END - PQ128_FOCUS_TH);
-    if (span <= 0)
-    {
-        return (1 << 15);
-    }
-    int num = (focus - PQ128_FOCUS_TH);
-    int32_t w = (int32_t)(((int64_t)num << 15) / (int64_t)span);
-    w = clamp_i32((int)w, 0, (1 << 15));
+        uint32_t block_cols = HLAC_BLOCK_COLS;
+        uint32_t block_rows = HLAC_BLOCK_ROWS;
+        uint32_t block_w = img_w / block_cols;
+        uint32_t block_h = img_h / block_rows;
 
-#if PQ128_FOCUS_POWER2
-    w = (int32_t)(((int64_t)w * (int64_t)w + (1 << 14)) >> 15);
-#endif
-    return w;
-}
+        uint32_t C = HLAC_MAX_CLASSES;
+
+        int class_votes[HLAC_MAX_CLASSES];
+        memset(class_votes, 0, sizeof(class_votes));
+#if HLAC_TEMPORAL_ENABLE
+        hlac_temporal_frame_begin();
 #endif
 
-/* Forward declaration: Sobel is defined later (MVE/non-MVE variants share signature). */
-static void apply_sobel_filter(uint8_t y_prev[FRAME_WIDTH],
-                               uint8_t y_curr[FRAME_WIDTH],
-                               uint8_t y_next[FRAME_WIDTH],
-                               uint8_t edge_out[FRAME_WIDTH]);
+        /* Store per-block prediction for grid display. */
+        int block_grid[HLAC_BLOCK_ROWS][HLAC_BLOCK_COLS];
 
-#if (PQ128_USE_INTENSITY_KNEE || PQ128_USE_INTENSITY_GAMMA)
-static void pq128_init_intensity_lut(uint8_t out_u8[256])
-{
-    for (int i = 0; i < 256; i++)
-    {
-        int y = i;
+        uint8_t order[HLAC_BLOCK_COUNT];
+        hlac_cascade_order(order);
+        const uint32_t n_blocks = block_rows * block_cols;
+        uint32_t evaluated = 0U;
+        uint32_t background = 0U;
+#if HLAC_CASCADE_ENABLE && (HLAC_CASCADE_REPORT_FRAMES > 0U)
+        uint32_t eval_cyc = 0U;
+        const uint32_t loop_t0 = DWT->CYCCNT;
+#endif
+        for (uint32_t i = 0; i < n_blocks; i++)
+        {
+            block_grid[i / block_cols][i % block_cols] = HLAC_BLOCK_SKIPPED;
+        }
 
-#if PQ128_USE_INTENSITY_GAMMA
+        for (uint32_t i = 0; i < n_blocks; i++)
         {
-            float x = (float)y * (1.0f / 255.0f);
-            float yg = powf(x, (float)PQ128_INTENSITY_GAMMA);
-            int yi = (int)(yg * 255.0f + 0.5f);
-            if (yi < 0)
+#if HLAC_CASCADE_EARLY_EXIT
+            /* Early exit: the remaining blocks cannot change the majority. */
+            if (hlac_cascade_decided(class_votes, C, n_blocks - i))
             {
-                yi = 0;
+                break;
             }
-            if (yi > 255)
+#endif
+            const uint32_t bi = order[i];
+            const uint32_t br = bi / block_cols;
+            const uint32_t bc = bi % block_cols;
+            uint32_t x0 = bc * block_w;
+            uint32_t y0 = br * block_h;
+            float feats[25];
+#if HLAC_CASCADE_ENABLE && (HLAC_CASCADE_REPORT_FRAMES > 0U)
+            const uint32_t blk_t0 = DWT->CYCCNT;
+#endif
+            const uint32_t prof_t0 = prof_now();
+
+#if HLAC_FUSED_STREAM
+            (void)x0;
+            (void)y0;
+#if HLAC_CASCADE_ENABLE && (HLAC_CASCADE_BG_MEAN_U8 > 0U)
+            /* Pre-filter on the order-0 sum before converting features. */
+            if (hlac25_stream_block_sum(hs, bi) < ((uint32_t)HLAC_CASCADE_BG_MEAN_U8 * block_w * block_h))
             {
-                yi = 255;
+                block_grid[br][bc] = HLAC_BLOCK_BACKGROUND;
+                s_hlac_block_conf[bi] = 0.0f;
+                background++;
+                continue;
             }
-            y = yi;
-        }
 #endif
+            hlac25_stream_get_features(hs, bi, feats);
+#else
+            hlac25_compute_from_u8_hyperram_roi(frame_base_offset + (uint32_t)DEPTH_OFFSET,
+                                                img_w, x0, y0, block_w, block_h, feats);
+#if HLAC_CASCADE_ENABLE && (HLAC_CASCADE_BG_MEAN_U8 > 0U)
+            /* feats[0] = mean |P|+|Q| / 255 (features are already paid for; only LDA is skipped) */
+            if ((feats[0] * 255.0f) < (float)HLAC_CASCADE_BG_MEAN_U8)
+            {
+                block_grid[br][bc] = HLAC_BLOCK_BACKGROUND;
+                s_hlac_block_conf[bi] = 0.0f;
+                background++;
+                continue;
+            }
+#endif
+#endif
+            prof_span_end(PROF_SPAN_HLAC, prof_t0);
 
-#if PQ128_USE_INTENSITY_KNEE
-        if (y > PQ128_KNEE_START)
+            const uint32_t prof_lda_t0 = prof_now();
+            float block_score = 0.0f;
+#if HLAC_TEMPORAL_ENABLE
+            float block_probs[HLAC_MAX_CLASSES];
+            int block_pred = hlac_lda_predict_probs(feats, block_probs, &block_score);
+            if (block_pred >= 0)
+            {
+                hlac_temporal_add(&s_hlac_temporal, block_probs);
+            }
+            s_hlac_block_conf[bi] = (block_pred >= 0) ? block_probs[block_pred] : 0.0f;
+#elif HLAC_INFER_SOFTMAX_ENABLE
+            float block_prob = 0.0f;
+            int block_pred = hlac_lda_predict_ex(feats, &block_score, &block_prob, 1);
+            s_hlac_block_conf[bi] = block_prob;
+#else
+            int block_pred = hlac_lda_predict_ex(feats, &block_score, NULL, 0);
+#endif
+            prof_span_end(PROF_SPAN_LDA, prof_lda_t0);
+
+            block_grid[br][bc] = block_pred;
+            if (block_pred >= 0 && block_pred < (int)C)
+            {
+                class_votes[block_pred]++;
+            }
+            evaluated++;
+#if HLAC_CASCADE_ENABLE && (HLAC_CASCADE_REPORT_FRAMES > 0U)
+            eval_cyc += DWT->CYCCNT - blk_t0;
+#endif
+        }
+#if HLAC_CASCADE_ENABLE && (HLAC_CASCADE_REPORT_FRAMES > 0U)
+        hlac_cascade_account(evaluated, background, DWT->CYCCNT - loop_t0, eval_cyc);
+#endif
+
+        /* Block mode interleaves HLAC and LDA per block: HLAC_DONE == voting start. */
+        latency_trace_stamp(frame_seq, LATENCY_STAGE_HLAC_DONE);
+
+        /* Find class with most votes (majority voting). */
+        int pred = -1;
+        int max_votes = 0;
+        for (uint32_t c = 0; c < C; c++)
         {
-            y = PQ128_KNEE_START + ((y - PQ128_KNEE_START) >> PQ128_KNEE_SHIFT);
-            if (y > 255)
+            if (class_votes[c] > max_votes)
             {
-                y = 255;
+                max_votes = class_votes[c];
+                pred = (int)c;
             }
         }
+#if HLAC_TEMPORAL_ENABLE
+        const int decision = hlac_temporal_end_frame(&s_hlac_temporal);
+#endif
+        latency_trace_stamp(frame_seq, LATENCY_STAGE_LDA_DECISION);
+
+        /*
+         * Estimate best_score and best_prob from voting statistics.
+         * 分母は実際に見たブロック数(評価 + 背景)．早期終了で飛ばしたブロックを分母に入れると
+         * 全会一致でも evaluated / n_blocks に下がり，MOTOR_PRED_MIN_BEST_SCORE などの足切りで落ちる．
+         * 早期終了しなければ従来どおり n_blocks で割るのと同じ．
+         */
+        const uint32_t examined = evaluated + background;
+        float best_score = ((max_votes > 0) && (examined > 0U)) ? ((float)max_votes / (float)examined) : 0.0f;
+        float best_prob = best_score; /* Simplified: use voting fraction as confidence. */
+
+        {
+            static int s_last_pred = -9999;
+#if !HLAC_TEMPORAL_ENABLE
+            static int s_stable_pred = -9999;
+            static uint32_t s_stable_count = 0U;
 #endif
+            bool do_print = false;
+            if (HLAC_UART_LOG_ON_CHANGE)
+            {
+                if (pred != s_last_pred)
+                {
+                    do_print = true;
+                }
+            }
+            if (!do_print && (HLAC_UART_LOG_PERIOD > 0U))
+            {
+                if ((frame_seq % HLAC_UART_LOG_PERIOD) == 0U)
+                {
+                    do_print = true;
+                }
+            }
+            if (do_print)
+            {
+                /* ANSI: move cursor up (block_rows+1) lines to overwrite previous grid in-place.
+                 * ESC[<N>A = cursor up N lines.  Works in TeraTerm/PuTTY/VSCode with ANSI enabled.
+                 * s_grid_printed tracks whether we have already drawn the grid once.
+                 */
+                static bool s_grid_printed = false;
+                if (s_grid_printed)
+                {
+                    /* +1 for the header line */
+                    xprintf("\033[%dA\r", (int)(block_rows + 1));
+                }
 
-        out_u8[i] = (uint8_t)y;
-    }
-}
+                xprintf("--- pred=%d votes=%d/%lu conf=%.2f ---\n",
+                        pred, max_votes, (unsigned long)(block_rows * block_cols), best_prob);
+                for (uint32_t br = 0; br < block_rows; br++)
+                {
+                    xprintf("|");
+                    for (uint32_t bc = 0; bc < block_cols; bc++)
+                    {
+                        int bp = block_grid[br][bc];
+                        if (bp == pred)
+                        {
+                            xprintf("[%d]", bp); /* winner highlighted with brackets */
+                        }
+                        else if (bp == HLAC_BLOCK_BACKGROUND)
+                        {
+                            xprintf(" . ");
+                        }
+                        else if (bp == HLAC_BLOCK_SKIPPED)
+                        {
+                            xprintf(" - "); /* not evaluated (vote already decided) */
+                        }
+                        else
+                        {
+                            xprintf(" %d ", bp);
+                        }
+                    }
+                    xprintf("|\n");
+                }
+                s_grid_printed = true;
+                s_last_pred = pred;
+            }
+
+#if HLAC_TEMPORAL_ENABLE
+            if (decision >= 0)
+            {
+                motor_control_post_pred_frame(decision, frame_seq);
+            }
+#else
+            /* Motor command update: only post when pred is stable (same logic as full-frame mode). */
+            bool pass_prob = true;
+#if HLAC_INFER_SOFTMAX_ENABLE
+            pass_prob = (best_prob >= (float)HLAC_INFER_MIN_BEST_PROB);
 #endif
+            if ((best_score >= (float)MOTOR_PRED_MIN_BEST_SCORE) && pass_prob && pred >= 0)
+            {
+                if (pred == s_stable_pred)
+                {
+                    if (s_stable_count < 0xFFFFFFFFU)
+                    {
+                        s_stable_count++;
+                    }
+                }
+                else
+                {
+                    s_stable_pred = pred;
+                    s_stable_count = 1U;
+                }
 
-#if (PQ128_PQ_MODE == 2)
-static inline int pq128_floor_log2_u32(uint32_t x)
-{
-    if (x == 0U)
-    {
-        return 0;
+                if (s_stable_count >= (uint32_t)MOTOR_PRED_STABLE_COUNT)
+                {
+                    motor_control_post_pred_frame(pred, frame_seq);
+                    s_stable_count = 0U;
+                }
+            }
+#endif
+        }
     }
-#if defined(__GNUC__)
-    return 31 - __builtin_clz(x);
+
 #else
-    return 31 - (int)__CLZ(x);
+    /* Traditional full-frame HLAC inference. */
+    float feats[25];
+    const uint32_t prof_t0 = prof_now();
+#if HLAC_FUSED_STREAM
+    hlac25_stream_get_features(hs, 0U, feats);
+#else
+    hlac25_compute_from_u8_hyperram(frame_base_offset + (uint32_t)DEPTH_OFFSET,
+#if HLAC_PQ_MAG_TRUE_256
+                                    (uint32_t)HLAC_PQ_MAG_TRUE_W,
+                                    (uint32_t)HLAC_PQ_MAG_TRUE_H,
+#else
+                                    (uint32_t)PQ128_SRC_W,
+                                    (uint32_t)PQ128_SRC_H,
 #endif
-}
+                                    feats);
+    latency_trace_stamp(frame_seq, LATENCY_STAGE_HLAC_DONE);
 #endif
+    prof_span_end(PROF_SPAN_HLAC, prof_t0);
 
-#if (PQ128_PQ_MODE == 3)
-static inline int16_t pq128_lightmodel_pq_i16(int intensity_u8, int32_t ratio_q15)
-{
-    /* p_q15 ~= (I/255) * ratio_q15 */
-    int32_t pq_q15 = (int32_t)(((int64_t)intensity_u8 * (int64_t)ratio_q15 + 127) / 255);
-    int32_t v = (int32_t)(((int64_t)pq_q15 * (int64_t)PQ128_LIGHTMODEL_SCALE + (1 << 14)) >> 15);
-    return (int16_t)clamp_i32((int)v, -32768, 32767);
-}
-
-static void pq128_lightmodel_ratios_q15(int32_t *rp_out_q15, int32_t *rq_out_q15)
-{
-    float ps = g_light_ps;
-    float qs = g_light_qs;
-    float ts = g_light_ts;
-    if (fabsf(ts) < 1.0e-6f)
+    const uint32_t prof_lda_t0 = prof_now();
+    float best_score = 0.0f;
+#if HLAC_TEMPORAL_ENABLE
+    float probs[HLAC_MAX_CLASSES];
+    int pred = hlac_lda_predict_probs(feats, probs, &best_score);
+    const float best_prob = (pred >= 0) ? probs[pred] : 0.0f;
+    (void)best_prob;
+    hlac_temporal_frame_begin();
+    if (pred >= 0)
     {
-        ts = (ts < 0.0f) ? -1.0f : 1.0f;
+        hlac_temporal_add(&s_hlac_temporal, probs);
     }
-    float rp = ps / ts;
-    float rq = qs / ts;
-
-    int32_t rp_q15 = (int32_t)(rp * 32768.0f);
-    int32_t rq_q15 = (int32_t)(rq * 32768.0f);
-    /* Clamp ratios to keep p/q within sane range. */
-    rp_q15 = clamp_i32((int)rp_q15, -(1 << 15), (1 << 15));
-    rq_q15 = clamp_i32((int)rq_q15, -(1 << 15), (1 << 15));
-    *rp_out_q15 = rp_q15;
-    *rq_out_q15 = rq_q15;
-}
+    const int decision = hlac_temporal_end_frame(&s_hlac_temporal);
+#elif HLAC_INFER_SOFTMAX_ENABLE
+    float best_prob = 0.0f;
+    int pred = hlac_lda_predict_ex(feats, &best_score, &best_prob, 1);
+#else
+    int pred = hlac_lda_predict_ex(feats, &best_score, NULL, 0);
 #endif
-
-#if PQ128_USE_TAPER && (PQ128_TAPER_WIDTH > 0)
-static void pq128_init_taper_lut_q15(uint16_t out_q15[PQ128_SIZE])
-{
-    /* Raised-cosine ramp from 0 at the very edge to 1 at distance >= PQ128_TAPER_WIDTH. */
-    const int W = PQ128_TAPER_WIDTH;
-    const float pi = 3.14159265358979323846f;
-
-    for (int i = 0; i < PQ128_SIZE; i++)
+    prof_span_end(PROF_SPAN_LDA, prof_lda_t0);
+    latency_trace_stamp(frame_seq, LATENCY_STAGE_LDA_DECISION);
     {
-        int d = i;
-        int d2 = (PQ128_SIZE - 1) - i;
-        if (d2 < d)
+        static int s_last_pred = -9999;
+#if !HLAC_TEMPORAL_ENABLE
+        static int s_stable_pred = -9999;
+        static uint32_t s_stable_count = 0U;
+#endif
+        bool do_print = false;
+        if (HLAC_UART_LOG_ON_CHANGE)
         {
-            d = d2;
+            if (pred != s_last_pred)
+            {
+                do_print = true;
+            }
         }
-
-        if (d >= W)
+        if (!do_print && (HLAC_UART_LOG_PERIOD > 0U))
         {
-            out_q15[i] = (uint16_t)(1U << 15);
-            continue;
+            if ((frame_seq % HLAC_UART_LOG_PERIOD) == 0U)
+            {
+                do_print = true;
+            }
+        }
+        if (do_print)
+        {
+#if HLAC_INFER_SOFTMAX_ENABLE
+            BINLOG2("pred=%d prob=%.3f\n", pred, BINLOG_F(best_prob));
+#else
+            BINLOG1("pred=%d\n", pred);
+#endif
+            s_last_pred = pred;
         }
 
-        float t = (float)d / (float)W; /* [0..1) */
-        float w = 0.5f - 0.5f * cosf(pi * t);
-        int32_t q15 = (int32_t)(w * 32768.0f + 0.5f);
-        if (q15 < 0)
+#if HLAC_TEMPORAL_ENABLE
+        if (decision >= 0)
         {
-            q15 = 0;
+            motor_control_post_pred_frame(decision, frame_seq);
         }
-        if (q15 > (1 << 15))
+#else
+        /* Motor command update: only post when pred is stable. */
+        bool pass_prob = true;
+#if HLAC_INFER_SOFTMAX_ENABLE
+        pass_prob = (best_prob >= (float)HLAC_INFER_MIN_BEST_PROB);
+#endif
+        if ((best_score >= (float)MOTOR_PRED_MIN_BEST_SCORE) && pass_prob)
         {
-            q15 = (1 << 15);
+            if (pred == s_stable_pred)
+            {
+                if (s_stable_count < 0xFFFFFFFFU)
+                {
+                    s_stable_count++;
+                }
+            }
+            else
+            {
+                s_stable_pred = pred;
+                s_stable_count = 1U;
+            }
+
+            if (s_stable_count >= (uint32_t)MOTOR_PRED_STABLE_COUNT)
+            {
+                motor_control_post_pred_frame(pred, frame_seq);
+                s_stable_count = 0U;
+            }
         }
-        out_q15[i] = (uint16_t)q15;
+#endif
     }
-}
 #endif
 
-static fsp_err_t load_y_line_from_hyperram_base(uint32_t frame_base_offset,
-                                                int requested_row,
-                                                uint8_t yuv_line[FRAME_WIDTH * 2],
-                                                uint8_t y_line[FRAME_WIDTH])
-{
-    int row = clamp_i32(requested_row, 0, FRAME_HEIGHT - 1);
-    uint32_t offset = frame_base_offset + (uint32_t)row * (uint32_t)FRAME_WIDTH * 2U;
-    fsp_err_t err = hyperram_b_read(yuv_line, (void *)offset, FRAME_WIDTH * 2);
-    if (FSP_SUCCESS != err)
+    if (!export_image)
     {
-        return err;
+        return;
     }
+#if HLAC_FUSED_STREAM
+    g_depth_export_request = 0U;
+#endif
+    __DMB();
+    g_depth_size_bytes = out_bytes;
+    __DMB();
+    g_depth_base_offset = frame_base_offset;
+    __DMB();
+    g_depth_seq = frame_seq;
+    return;
+#endif
+#endif
 
-    extract_y_line_uyvy_swap_y(yuv_line, y_line, (uint32_t)FRAME_WIDTH);
-    return FSP_SUCCESS;
+#if FC128_TILED_ENABLE
+    fc128_compute_depth_tiled(frame_base_offset, frame_seq);
+#else
+    fc128_dwt_init_once();
+
+    fc128_layout_check_once(frame_base_offset);
+    if ((frame_base_offset + (uint32_t)FC128_TOTAL_SCRATCH_END) > (uint32_t)HYPERRAM_SIZE)
+    {
+        /* Avoid corrupting memory if configuration/layout is invalid. */
+        return;
+    }
+
+    fc128_solve_stamps_t st;
+    if (!fc128_solve_z_from_pq(frame_base_offset, &st))
+    {
+        return;
+    }
+
+    fc128_export_depth_u8_320x240(frame_base_offset);
+    prof_span_end(PROF_SPAN_FC_EXPORT, st.t_ifft);
+
+#if FC128_TIMING_ENABLE
+    uint32_t t_export = fc128_dwt_now();
+
+    if ((FC128_TIMING_LOG_PERIOD != 0U) && ((frame_seq % (uint32_t)FC128_TIMING_LOG_PERIOD) == 0U))
+    {
+        uint32_t c_build = (uint32_t)(st.t_build - st.t_start);
+        uint32_t c_fft_p = (uint32_t)(st.t_fft_p - st.t_build);
+        uint32_t c_fft_q = (uint32_t)(st.t_fft_q - st.t_fft_p);
+        uint32_t c_zhat = (uint32_t)(st.t_zhat - st.t_fft_q);
+        uint32_t c_ifft = (uint32_t)(st.t_ifft - st.t_zhat);
+        uint32_t c_export = (uint32_t)(t_export - st.t_ifft);
+        uint32_t c_total = (uint32_t)(t_export - st.t_start);
+
+        xprintf("[FC128] cyc build=%lu fftP=%lu fftQ=%lu zhat=%lu ifft=%lu export=%lu total=%lu\n",
+                (unsigned long)c_build,
+                (unsigned long)c_fft_p,
+                (unsigned long)c_fft_q,
+                (unsigned long)c_zhat,
+                (unsigned long)c_ifft,
+                (unsigned long)c_export,
+                (unsigned long)c_total);
+
+        xprintf("[FC128] us  build=%lu fftP=%lu fftQ=%lu zhat=%lu ifft=%lu export=%lu total=%lu (core=%lu Hz)\n",
+                (unsigned long)fc128_cyc_to_us(c_build),
+                (unsigned long)fc128_cyc_to_us(c_fft_p),
+                (unsigned long)fc128_cyc_to_us(c_fft_q),
+                (unsigned long)fc128_cyc_to_us(c_zhat),
+                (unsigned long)fc128_cyc_to_us(c_ifft),
+                (unsigned long)fc128_cyc_to_us(c_export),
+                (unsigned long)fc128_cyc_to_us(c_total),
+                (unsigned long)SystemCoreClock);
+    }
+#endif
+
+    __DMB();
+    g_depth_size_bytes = (uint32_t)DEPTH_BYTES;
+    __DMB();
+    g_depth_base_offset = frame_base_offset;
+    __DMB();
+    g_depth_seq = frame_seq;
+#endif
+}
+
+static inline void reorder_grayscale_4px_line(uint8_t *buf, uint32_t n)
+{
+    /* Swap [0..1] with [2..3] within each 4px group (matches Thread1 grayscale send fix). */
+    uint32_t i = 0;
+
+#if USE_HELIUM_MVE
+    /* Vectorize by treating each 4px group as one 32-bit word:
+     * [a0 a1 a2 a3] -> [a2 a3 a0 a1] == rotate-by-16 within 32-bit.
+     * Process 4 groups (16 bytes) per loop.
+     */
+    for (; (i + 3U) < n && (((uintptr_t)(&buf[i])) & 3U); i += 4U)
+    {
+        uint8_t a0 = buf[i];
+        uint8_t a1 = buf[i + 1U];
+        buf[i] = buf[i + 2U];
+        buf[i + 1U] = buf[i + 3U];
+        buf[i + 2U] = a0;
+        buf[i + 3U] = a1;
+    }
+
+    for (; (i + 15U) < n; i += 16U)
+    {
+        uint32x4_t v = vld1q_u32((const uint32_t *)&buf[i]);
+        uint32x4_t hi = vshrq_n_u32(v, 16);
+        uint32x4_t lo = vshlq_n_u32(v, 16);
+        uint32x4_t r = vorrq_u32(hi, lo);
+        vst1q_u32((uint32_t *)&buf[i], r);
+    }
+#endif
+
+    for (; i + 3U < n; i += 4U)
+    {
+        uint8_t a0 = buf[i];
+        uint8_t a1 = buf[i + 1U];
+        buf[i] = buf[i + 2U];
+        buf[i + 1U] = buf[i + 3U];
+        buf[i + 2U] = a0;
+        buf[i + 3U] = a1;
+    }
+}
+
+static void extract_y_line_uyvy_swap_y(const uint8_t *yuv, uint8_t *y_out, uint32_t width)
+{
+    /* UYVY: [U0 Y0 V0 Y1] but swap Y: output (Y1,Y0) to match current tuned grayscale view. */
+    uint32_t x = 0;
+
+#if USE_HELIUM_MVE
+    /* 16 pixels = 32 bytes per iteration.
+     * Input layout per 2 pixels (4 bytes): [U0 Y0 V0 Y1]
+     * Output swaps Y within the pair: [Y1 Y0]
+     */
+    for (; (x + 15U) < width; x += 16U)
+    {
+        const uint8x16_t yuv_low = vld1q_u8(&yuv[x * 2U]);
+        const uint8x16_t yuv_high = vld1q_u8(&yuv[x * 2U + 16U]);
+
+        uint8_t tmp[16];
+        tmp[0] = yuv_low[3];
+        tmp[1] = yuv_low[1];
+        tmp[2] = yuv_low[7];
+        tmp[3] = yuv_low[5];
+        tmp[4] = yuv_low[11];
+        tmp[5] = yuv_low[9];
+        tmp[6] = yuv_low[15];
+        tmp[7] = yuv_low[13];
+        tmp[8] = yuv_high[3];
+        tmp[9] = yuv_high[1];
+        tmp[10] = yuv_high[7];
+        tmp[11] = yuv_high[5];
+        tmp[12] = yuv_high[11];
+        tmp[13] = yuv_high[9];
+        tmp[14] = yuv_high[15];
+        tmp[15] = yuv_high[13];
+
+        vst1q_u8(&y_out[x], vld1q_u8(tmp));
+    }
+#endif
+
+    for (; x < width; x += 2U)
+    {
+        uint32_t yuv_idx = x * 2U;
+        y_out[x] = yuv[yuv_idx + 3U];
+        y_out[x + 1U] = yuv[yuv_idx + 1U];
+    }
+    reorder_grayscale_4px_line(y_out, width);
 }
 
 #if PQ128_USE_CHROMA_EDGEMASK
-static fsp_err_t load_yc_line_from_hyperram_base(uint32_t frame_base_offset,
-                                                 int requested_row,
-                                                 uint8_t yuv_line[FRAME_WIDTH * 2],
-                                                 uint8_t y_line[FRAME_WIDTH],
-                                                 uint8_t c_line[FRAME_WIDTH])
+static void extract_chroma_mag_line_uyvy_reorder(const uint8_t *yuv, uint8_t *c_out, uint32_t width)
 {
-    int row = clamp_i32(requested_row, 0, FRAME_HEIGHT - 1);
-    uint32_t offset = frame_base_offset + (uint32_t)row * (uint32_t)FRAME_WIDTH * 2U;
-    fsp_err_t err = hyperram_b_read(yuv_line, (void *)offset, FRAME_WIDTH * 2);
-    if (FSP_SUCCESS != err)
+    /* UYVY: [U0 Y0 V0 Y1] per 2 pixels.
+     * Compute a simple chroma magnitude proxy per pixel:
+     *   C = |U-128| + |V-128|  (clamped to 0..255)
+     * Duplicate to both pixels of the pair, then apply the same 4px reorder
+     * as the grayscale path so indexing matches y_out.
+     */
+    for (uint32_t x = 0; x < width; x += 2U)
     {
-        return err;
+        uint32_t idx = x * 2U;
+        int u = (int)yuv[idx + 0U];
+        int v = (int)yuv[idx + 2U];
+        int du = u - 128;
+        int dv = v - 128;
+        if (du < 0)
+        {
+            du = -du;
+        }
+        if (dv < 0)
+        {
+            dv = -dv;
+        }
+        int c = du + dv;
+        if (c > 255)
+        {
+            c = 255;
+        }
+        c_out[x] = (uint8_t)c;
+        if ((x + 1U) < width)
+        {
+            c_out[x + 1U] = (uint8_t)c;
+        }
     }
+    reorder_grayscale_4px_line(c_out, width);
+}
+#endif
 
-    extract_y_line_uyvy_swap_y(yuv_line, y_line, (uint32_t)FRAME_WIDTH);
-    extract_chroma_mag_line_uyvy_reorder(yuv_line, c_line, (uint32_t)FRAME_WIDTH);
-    return FSP_SUCCESS;
+static inline int clamp_i32(int v, int lo, int hi)
+{
+    if (v < lo)
+    {
+        return lo;
+    }
+    if (v > hi)
+    {
+        return hi;
+    }
+    return v;
 }
 
-static void load_yc_line_from_hyperram_or_zero(uint32_t frame_base_offset,
-                                               int requested_row,
-                                               uint8_t yuv_line[FRAME_WIDTH * 2],
-                                               uint8_t y_line[FRAME_WIDTH],
-                                               uint8_t c_line[FRAME_WIDTH])
+/* Compute Q15 weight based on saturation proximity (1.0 .. 0.0). */
+static inline int32_t pq128_sat_weight_q15(int i0, int i1)
 {
-    if ((requested_row < 0) || (requested_row >= FRAME_HEIGHT))
+    int mx = (i0 > i1) ? i0 : i1;
+    if (mx >= PQ128_SAT_TH)
     {
-        memset(y_line, 0, FRAME_WIDTH);
-        memset(c_line, 0, FRAME_WIDTH);
-        return;
+        return 0;
     }
-    (void)load_yc_line_from_hyperram_base(frame_base_offset, requested_row, yuv_line, y_line, c_line);
+
+#if PQ128_USE_SAT_SOFTMASK
+    if (mx <= PQ128_SAT_SOFT_START)
+    {
+        return (1 << 15);
+    }
+    int span = (PQ128_SAT_TH - PQ128_SAT_SOFT_START);
+    if (span <= 0)
+    {
+        return (1 << 15);
+    }
+    int num = (PQ128_SAT_TH - mx);
+    int32_t w = (int32_t)(((int64_t)num << 15) / (int64_t)span);
+    w = clamp_i32((int)w, 0, (1 << 15));
+#if PQ128_SAT_SOFT_POWER2
+    /* Quadratic falloff: w <- w^2 (Q15) */
+    w = (int32_t)(((int64_t)w * (int64_t)w + (1 << 14)) >> 15);
+#endif
+    return w;
+#else
+    return (1 << 15);
+#endif
 }
 
-static inline uint8_t pq128_get_c_or_zero(const uint8_t c_line[FRAME_WIDTH], int x)
-{
-    if ((x < 0) || (x >= FRAME_WIDTH))
-    {
-        return 0;
-    }
-    return c_line[x];
-}
+#if PQ128_USE_DARK_SOFTMASK
+static inline int32_t pq128_dark_weight_q15(int i0, int i1)
+{
+    /* Use average intensity as a simple SNR proxy. */
+    int avg = (i0 + i1) >> 1;
+
+    if (avg <= PQ128_DARK_TH)
+    {
+        return 0;
+    }
+    if (avg >= PQ128_DARK_SOFT_END)
+    {
+        return (1 << 15);
+    }
+
+    int span = (PQ128_DARK_SOFT_END - PQ128_DARK_TH);
+    if (span <= 0)
+    {
+        return 0;
+    }
+    int num = (avg - PQ128_DARK_TH);
+    int32_t w = (int32_t)(((int64_t)num << 15) / (int64_t)span);
+    w = clamp_i32((int)w, 0, (1 << 15));
+
+#if PQ128_DARK_SOFT_POWER2
+    w = (int32_t)(((int64_t)w * (int64_t)w + (1 << 14)) >> 15);
+#endif
+    return w;
+}
+#endif
+
+#if PQ128_USE_CHROMA_EDGEMASK
+static inline int32_t pq128_chroma_edge_weight_q15(int edge)
+{
+    if (edge <= PQ128_CHROMA_EDGE_START)
+    {
+        return (1 << 15);
+    }
+    if (edge >= PQ128_CHROMA_EDGE_TH)
+    {
+        return 0;
+    }
+    int span = (PQ128_CHROMA_EDGE_TH - PQ128_CHROMA_EDGE_START);
+    if (span <= 0)
+    {
+        return 0;
+    }
+    int num = (PQ128_CHROMA_EDGE_TH - edge);
+    int32_t w = (int32_t)(((int64_t)num << 15) / (int64_t)span);
+    w = clamp_i32((int)w, 0, (1 << 15));
+#if PQ128_CHROMA_EDGE_POWER2
+    w = (int32_t)(((int64_t)w * (int64_t)w + (1 << 14)) >> 15);
+#endif
+    return w;
+}
+#endif
+
+#if PQ128_USE_FOCUS_SOFTMASK
+/* Simple horizontal blur: [1 2 1]/4. Border pixels are copied. */
+static inline void pq128_blur121_u8_line(const uint8_t in_u8[FRAME_WIDTH_MAX], uint8_t out_u8[FRAME_WIDTH_MAX])
+{
+    out_u8[0] = in_u8[0];
+    out_u8[FRAME_WIDTH - 1] = in_u8[FRAME_WIDTH - 1];
+    for (int x = 1; x < FRAME_WIDTH - 1; x++)
+    {
+        int v = (int)in_u8[x - 1] + ((int)in_u8[x] << 1) + (int)in_u8[x + 1];
+        v = (v + 2) >> 2;
+        out_u8[x] = (uint8_t)v;
+    }
+}
+
+#endif /* PQ128_USE_FOCUS_SOFTMASK */
+
+#if PQ128_USE_FOCUS_SOFTMASK
+
+static inline int32_t pq128_focus_weight_q15(int focus)
+{
+    if (focus <= PQ128_FOCUS_TH)
+    {
+        return 0;
+    }
+    if (focus >= PQ128_FOCUS_SOFT_END)
+    {
+        return (1 << 15);
+    }
+
+    int span = (PQ128_FOCUS_SOFT_END - PQ128_FOCUS_TH);
+    if (span <= 0)
+    {
+        return (1 << 15);
+    }
+    int num = (focus - PQ128_FOCUS_TH);
+    int32_t w = (int32_t)(((int64_t)num << 15) / (int64_t)span);
+    w = clamp_i32((int)w, 0, (1 << 15));
+
+#if PQ128_FOCUS_POWER2
+    w = (int32_t)(((int64_t)w * (int64_t)w + (1 << 14)) >> 15);
+#endif
+    return w;
+}
+#endif
+
+/* Forward declaration: Sobel is defined later (MVE/non-MVE variants share signature). */
+static void apply_sobel_filter(uint8_t y_prev[FRAME_WIDTH_MAX],
+                               uint8_t y_curr[FRAME_WIDTH_MAX],
+                               uint8_t y_next[FRAME_WIDTH_MAX],
+                               uint8_t edge_out[FRAME_WIDTH_MAX]);
+
+#if (PQ128_USE_INTENSITY_KNEE || PQ128_USE_INTENSITY_GAMMA)
+static void pq128_init_intensity_lut(uint8_t out_u8[256])
+{
+    for (int i = 0; i < 256; i++)
+    {
+        int y = i;
+
+#if PQ128_USE_INTENSITY_GAMMA
+        {
+            float x = (float)y * (1.0f / 255.0f);
+            float yg = powf(x, (float)PQ128_INTENSITY_GAMMA);
+            int yi = (int)(yg * 255.0f + 0.5f);
+            if (yi < 0)
+            {
+                yi = 0;
+            }
+            if (yi > 255)
+            {
+                yi = 255;
+            }
+            y = yi;
+        }
+#endif
+
+#if PQ128_USE_INTENSITY_KNEE
+        if (y > PQ128_KNEE_START)
+        {
+            y = PQ128_KNEE_START + ((y - PQ128_KNEE_START) >> PQ128_KNEE_SHIFT);
+            if (y > 255)
+            {
+                y = 255;
+            }
+        }
+#endif
+
+        out_u8[i] = (uint8_t)y;
+    }
+}
+#endif
+
+#if (PQ128_PQ_MODE == 2)
+static inline int pq128_floor_log2_u32(uint32_t x)
+{
+    if (x == 0U)
+    {
+        return 0;
+    }
+#if defined(__GNUC__)
+    return 31 - __builtin_clz(x);
+#else
+    return 31 - (int)__CLZ(x);
+#endif
+}
+#endif
+
+#if (PQ128_PQ_MODE == 3)
+static inline int16_t pq128_lightmodel_pq_i16(int intensity_u8, int32_t ratio_q15)
+{
+    /* p_q15 ~= (I/255) * ratio_q15 */
+    int32_t pq_q15 = (int32_t)(((int64_t)intensity_u8 * (int64_t)ratio_q15 + 127) / 255);
+    int32_t v = (int32_t)(((int64_t)pq_q15 * (int64_t)PQ128_LIGHTMODEL_SCALE + (1 << 14)) >> 15);
+    return (int16_t)clamp_i32((int)v, -32768, 32767);
+}
+
+static void pq128_lightmodel_ratios_q15(int32_t *rp_out_q15, int32_t *rq_out_q15)
+{
+    float ps = g_light_ps;
+    float qs = g_light_qs;
+    float ts = g_light_ts;
+    if (fabsf(ts) < 1.0e-6f)
+    {
+        ts = (ts < 0.0f) ? -1.0f : 1.0f;
+    }
+    float rp = ps / ts;
+    float rq = qs / ts;
+
+    int32_t rp_q15 = (int32_t)(rp * 32768.0f);
+    int32_t rq_q15 = (int32_t)(rq * 32768.0f);
+    /* Clamp ratios to keep p/q within sane range. */
+    rp_q15 = clamp_i32((int)rp_q15, -(1 << 15), (1 << 15));
+    rq_q15 = clamp_i32((int)rq_q15, -(1 << 15), (1 << 15));
+    *rp_out_q15 = rp_q15;
+    *rq_out_q15 = rq_q15;
+}
+#endif
+
+#if PQ128_USE_TAPER && (PQ128_TAPER_WIDTH > 0)
+static void pq128_init_taper_lut_q15(uint16_t out_q15[PQ128_SIZE])
+{
+    /* Raised-cosine ramp from 0 at the very edge to 1 at distance >= PQ128_TAPER_WIDTH. */
+    const int W = PQ128_TAPER_WIDTH;
+    const float pi = 3.14159265358979323846f;
+
+    for (int i = 0; i < PQ128_SIZE; i++)
+    {
+        int d = i;
+        int d2 = (PQ128_SIZE - 1) - i;
+        if (d2 < d)
+        {
+            d = d2;
+        }
+
+        if (d >= W)
+        {
+            out_q15[i] = (uint16_t)(1U << 15);
+            continue;
+        }
+
+        float t = (float)d / (float)W; /* [0..1) */
+        float w = 0.5f - 0.5f * cosf(pi * t);
+        int32_t q15 = (int32_t)(w * 32768.0f + 0.5f);
+        if (q15 < 0)
+        {
+            q15 = 0;
+        }
+        if (q15 > (1 << 15))
+        {
+            q15 = (1 << 15);
+        }
+        out_q15[i] = (uint16_t)q15;
+    }
+}
+#endif
+
+/* HyperRAM のフレーム格納形式(VIDEO_FRAME_FORMAT)と PQ128 設定の整合チェック */
+#if (VIDEO_FRAME_FORMAT == VIDEO_FRAME_FMT_Y8) && PQ128_USE_CHROMA_EDGEMASK && !VIDEO_FRAME_STORE_CHROMA
+#error PQ128_USE_CHROMA_EDGEMASK with VIDEO_FRAME_FMT_Y8 requires VIDEO_FRAME_STORE_CHROMA=1.
+#endif
+
+#if (VIDEO_FRAME_FORMAT == VIDEO_FRAME_FMT_Y8_DECIM)
+#if (PQ128_SAMPLE_STRIDE_X != VIDEO_FRAME_DECIM_X) || (PQ128_SAMPLE_STRIDE_Y != VIDEO_FRAME_DECIM_Y)
+#error VIDEO_FRAME_FMT_Y8_DECIM requires PQ128_SAMPLE_STRIDE_X/Y == VIDEO_FRAME_DECIM_X/Y.
+#endif
+/* 全解像度の近傍を使う経路は間引き形式では使えない */
+#if HLAC_PQ_MAG_TRUE_256 || PQ128_USE_CHROMA_EDGEMASK || PQ128_USE_FOCUS_SOFTMASK || FC128_TILED_ENABLE
+#error VIDEO_FRAME_FMT_Y8_DECIM is incompatible with HLAC_PQ_MAG_TRUE_256/PQ128_USE_CHROMA_EDGEMASK/PQ128_USE_FOCUS_SOFTMASK/FC128_TILED_ENABLE.
+#endif
+#endif
+
+/*
+ * フレーム1行を Y(SWAP_Y + 4px並べ替え済み)とクロマ強度(c_line != NULL のとき)で取得．
+ * - UYVY     : 1行(2B/px)を読んで分解．
+ * - Y8       : Y 行をそのまま読む．クロマは水平1/2平面を画素ペアに複製．
+ * - Y8_DECIM : 間引き行(row / DY)を読み，最近傍で全幅に戻す(PQ128 の格子上では元画素と一致)．
+ * yuv_line は作業領域(FRAME_WIDTH_MAX*2 バイト)．行の長さは処理中フレーム(s_frame)に従う．
+ */
+static fsp_err_t video_frame_load_yc_line(uint32_t frame_base_offset,
+                                          int row,
+                                          uint8_t yuv_line[FRAME_WIDTH_MAX * 2],
+                                          uint8_t y_line[FRAME_WIDTH_MAX],
+                                          uint8_t *c_line)
+{
+#if (VIDEO_FRAME_FORMAT == VIDEO_FRAME_FMT_UYVY)
+    uint32_t offset = frame_base_offset + (uint32_t)row * (uint32_t)FRAME_WIDTH * 2U;
+    fsp_err_t err = hyperram_b_read(yuv_line, (void *)offset, (uint32_t)FRAME_WIDTH * 2U);
+    if (FSP_SUCCESS != err)
+    {
+        return err;
+    }
+
+    extract_y_line_uyvy_swap_y(yuv_line, y_line, (uint32_t)FRAME_WIDTH);
+#if PQ128_USE_CHROMA_EDGEMASK
+    if (c_line != NULL)
+    {
+        extract_chroma_mag_line_uyvy_reorder(yuv_line, c_line, (uint32_t)FRAME_WIDTH);
+    }
+#else
+    (void)c_line;
+#endif
+    return FSP_SUCCESS;
+#elif (VIDEO_FRAME_FORMAT == VIDEO_FRAME_FMT_Y8)
+    (void)yuv_line;
+    fsp_err_t err = hyperram_b_read(y_line,
+                                    (void *)(frame_base_offset + VIDEO_FRAME_Y_OFFSET +
+                                             (uint32_t)row * (uint32_t)FRAME_WIDTH),
+                                    (uint32_t)FRAME_WIDTH);
+#if VIDEO_FRAME_STORE_CHROMA
+    if ((FSP_SUCCESS == err) && (c_line != NULL))
+    {
+        /* c_line の後半を読み込み先に使い，前から複製(上書きは読み済みの位置のみ) */
+        const uint32_t c_w = video_frame_c_width(&s_frame);
+        uint8_t *half = &c_line[c_w];
+        err = hyperram_b_read(half,
+                              (void *)(frame_base_offset + video_frame_c_offset(&s_frame) + (uint32_t)row * c_w),
+                              c_w);
+        for (uint32_t k = 0U; (FSP_SUCCESS == err) && (k < c_w); k++)
+        {
+            const uint8_t c = half[k];
+            c_line[2U * k] = c;
+            c_line[2U * k + 1U] = c;
+        }
+    }
+#else
+    (void)c_line;
+#endif
+    return err;
+#else /* VIDEO_FRAME_FMT_Y8_DECIM */
+    (void)c_line;
+    const uint32_t drow = (uint32_t)row / (uint32_t)VIDEO_FRAME_DECIM_Y;
+    const uint32_t dw = video_frame_decim_w(&s_frame);
+    fsp_err_t err = hyperram_b_read(yuv_line,
+                                    (void *)(frame_base_offset + VIDEO_FRAME_Y_OFFSET + drow * dw),
+                                    dw);
+    if (FSP_SUCCESS != err)
+    {
+        return err;
+    }
+    for (uint32_t x = 0U; x < (uint32_t)FRAME_WIDTH; x++)
+    {
+        y_line[x] = yuv_line[x / (uint32_t)VIDEO_FRAME_DECIM_X];
+    }
+    return FSP_SUCCESS;
+#endif
+}
+
+static fsp_err_t load_y_line_from_hyperram_base(uint32_t frame_base_offset,
+                                                int requested_row,
+                                                uint8_t yuv_line[FRAME_WIDTH_MAX * 2],
+                                                uint8_t y_line[FRAME_WIDTH_MAX])
+{
+    int row = clamp_i32(requested_row, 0, FRAME_HEIGHT - 1);
+    return video_frame_load_yc_line(frame_base_offset, row, yuv_line, y_line, NULL);
+}
+
+#if PQ128_USE_CHROMA_EDGEMASK
+static fsp_err_t load_yc_line_from_hyperram_base(uint32_t frame_base_offset,
+                                                 int requested_row,
+                                                 uint8_t yuv_line[FRAME_WIDTH_MAX * 2],
+                                                 uint8_t y_line[FRAME_WIDTH_MAX],
+                                                 uint8_t c_line[FRAME_WIDTH_MAX])
+{
+    int row = clamp_i32(requested_row, 0, FRAME_HEIGHT - 1);
+    return video_frame_load_yc_line(frame_base_offset, row, yuv_line, y_line, c_line);
+}
+
+static void load_yc_line_from_hyperram_or_zero(uint32_t frame_base_offset,
+                                               int requested_row,
+                                               uint8_t yuv_line[FRAME_WIDTH_MAX * 2],
+                                               uint8_t y_line[FRAME_WIDTH_MAX],
+                                               uint8_t c_line[FRAME_WIDTH_MAX])
+{
+    if ((requested_row < 0) || (requested_row >= FRAME_HEIGHT))
+    {
+        memset(y_line, 0, FRAME_WIDTH);
+        memset(c_line, 0, FRAME_WIDTH);
+        return;
+    }
+    (void)load_yc_line_from_hyperram_base(frame_base_offset, requested_row, yuv_line, y_line, c_line);
+}
+
+static inline uint8_t pq128_get_c_or_zero(const uint8_t c_line[FRAME_WIDTH_MAX], int x)
+{
+    if ((x < 0) || (x >= FRAME_WIDTH))
+    {
+        return 0;
+    }
+    return c_line[x];
+}
+#endif
+
+static FC128_UNUSED void load_y_line_from_hyperram_or_zero(uint32_t frame_base_offset,
+                                                           int requested_row,
+                                                           uint8_t yuv_line[FRAME_WIDTH_MAX * 2],
+                                                           uint8_t y_line[FRAME_WIDTH_MAX])
+{
+    if ((requested_row < 0) || (requested_row >= FRAME_HEIGHT))
+    {
+        memset(y_line, 0, FRAME_WIDTH);
+        return;
+    }
+    (void)load_y_line_from_hyperram_base(frame_base_offset, requested_row, yuv_line, y_line);
+}
+
+static inline uint8_t pq128_get_y_or_zero(const uint8_t y_line[FRAME_WIDTH_MAX], int x)
+{
+    if ((x < 0) || (x >= FRAME_WIDTH))
+    {
+        return 0;
+    }
+    return y_line[x];
+}
+
+/* Reference implementation (kept for PQ128_FAST_KERNEL=0 and PQ128_BENCH_ENABLE). */
+static FC128_UNUSED void pq128_compute_and_store_ref(uint32_t frame_base_offset, uint32_t frame_seq)
+{
+    uint8_t yuv_tmp[FRAME_WIDTH_MAX * 2];
+    uint8_t y_prev[FRAME_WIDTH_MAX];
+    uint8_t y_curr[FRAME_WIDTH_MAX];
+    uint8_t y_next[FRAME_WIDTH_MAX];
+#if PQ128_USE_FOCUS_SOFTMASK
+    uint8_t y_prev_blur[FRAME_WIDTH_MAX];
+    uint8_t y_curr_blur[FRAME_WIDTH_MAX];
+    uint8_t y_next_blur[FRAME_WIDTH_MAX];
+    uint8_t y_blur_tmp[FRAME_WIDTH_MAX];
+    uint8_t edge_orig[FRAME_WIDTH_MAX];
+    uint8_t edge_blur[FRAME_WIDTH_MAX];
+    uint8_t focus_line[FRAME_WIDTH_MAX];
+#if PQ128_STORE_FOCUS_PLANE
+    uint8_t focus_row[PQ128_SIZE];
+#endif
+#if PQ128_STORE_EDGE_PLANE
+    uint8_t edge_row[PQ128_SIZE];
+#endif
+#if PQ128_STORE_EDGE_BLUR_PLANE
+    uint8_t edge_blur_row[PQ128_SIZE];
+#endif
+#if PQ128_STORE_SATMASK_PLANE
+    uint8_t satmask_row[PQ128_SIZE];
+#endif
+#endif
+#if PQ128_USE_CHROMA_EDGEMASK
+    uint8_t c_prev[FRAME_WIDTH_MAX];
+    uint8_t c_curr[FRAME_WIDTH_MAX];
+    uint8_t c_next[FRAME_WIDTH_MAX];
+#endif
+    int16_t p_row[PQ128_SIZE];
+    int16_t q_row[PQ128_SIZE];
+
+    /* Mark as in-progress (consumer should wait for a non-zero stable seq). */
+    g_pq128_seq = 0;
+
+    /* Prime 3-line window.
+     * Sliding-window fast path is valid only when stride_y==1.
+     */
+#if (PQ128_SAMPLE_STRIDE_Y == 1)
+#if PQ128_USE_CHROMA_EDGEMASK
+    load_yc_line_from_hyperram_or_zero(frame_base_offset, PQ128_Y0 - 1, yuv_tmp, y_prev, c_prev);
+    load_yc_line_from_hyperram_or_zero(frame_base_offset, PQ128_Y0 + 0, yuv_tmp, y_curr, c_curr);
+    load_yc_line_from_hyperram_or_zero(frame_base_offset, PQ128_Y0 + 1, yuv_tmp, y_next, c_next);
+#else
+    load_y_line_from_hyperram_or_zero(frame_base_offset, PQ128_Y0 - 1, yuv_tmp, y_prev);
+    load_y_line_from_hyperram_or_zero(frame_base_offset, PQ128_Y0 + 0, yuv_tmp, y_curr);
+    load_y_line_from_hyperram_or_zero(frame_base_offset, PQ128_Y0 + 1, yuv_tmp, y_next);
+#endif
+#endif
+
+    /*
+     * p,q generation (selected by PQ128_PQ_MODE).
+     * Default is contrast-invariant (reduces albedo/brightness bias):
+     *   p = (I(x+1)-I(x-1)) / (I(x+1)+I(x-1)+eps)
+     *   q = (I(y+1)-I(y-1)) / (I(y+1)+I(y-1)+eps)
+     * Strong-approx modes can be used for extra speed.
+     */
+
+#if (PQ128_PQ_MODE == 0) && PQ128_USE_RECIP_LUT
+    /* Q15 reciprocal LUT for v = (num * PQ128_NORM_SCALE) / den.
+     * recip_q15[den] = (PQ128_NORM_SCALE<<15)/den
+     */
+    static bool s_recip_inited = false;
+    static uint32_t s_recip_q15[PQ128_DEN_MAX + 1];
+    if (!s_recip_inited)
+    {
+        s_recip_q15[0] = 0U;
+        for (int d = 1; d <= (int)PQ128_DEN_MAX; d++)
+        {
+            s_recip_q15[d] = (((uint32_t)PQ128_NORM_SCALE) << 15) / (uint32_t)d;
+        }
+        s_recip_inited = true;
+    }
+#endif
+
+#if (PQ128_USE_INTENSITY_KNEE || PQ128_USE_INTENSITY_GAMMA)
+    static bool s_intensity_lut_inited = false;
+    static uint8_t s_intensity_u8[256];
+    if (!s_intensity_lut_inited)
+    {
+        pq128_init_intensity_lut(s_intensity_u8);
+        s_intensity_lut_inited = true;
+    }
+#endif
+
+#if PQ128_USE_TAPER && (PQ128_TAPER_WIDTH > 0)
+    static bool s_taper_inited = false;
+    static uint16_t s_taper_q15[PQ128_SIZE];
+    if (!s_taper_inited)
+    {
+        pq128_init_taper_lut_q15(s_taper_q15);
+        s_taper_inited = true;
+    }
+#endif
+
+#if (PQ128_PQ_MODE == 3)
+    int32_t rp_q15 = 0;
+    int32_t rq_q15 = 0;
+    pq128_lightmodel_ratios_q15(&rp_q15, &rq_q15);
+#endif
+
+    for (int ry = 0; ry < PQ128_SIZE; ry++)
+    {
+#if (PQ128_SAMPLE_STRIDE_Y != 1)
+        int src_y = PQ128_Y0 + ry * PQ128_SAMPLE_STRIDE_Y;
+#if PQ128_USE_CHROMA_EDGEMASK
+        load_yc_line_from_hyperram_or_zero(frame_base_offset, src_y - PQ128_SAMPLE_STRIDE_Y, yuv_tmp, y_prev, c_prev);
+        load_yc_line_from_hyperram_or_zero(frame_base_offset, src_y, yuv_tmp, y_curr, c_curr);
+        load_yc_line_from_hyperram_or_zero(frame_base_offset, src_y + PQ128_SAMPLE_STRIDE_Y, yuv_tmp, y_next, c_next);
+#else
+        load_y_line_from_hyperram_or_zero(frame_base_offset, src_y - PQ128_SAMPLE_STRIDE_Y, yuv_tmp, y_prev);
+        load_y_line_from_hyperram_or_zero(frame_base_offset, src_y, yuv_tmp, y_curr);
+        load_y_line_from_hyperram_or_zero(frame_base_offset, src_y + PQ128_SAMPLE_STRIDE_Y, yuv_tmp, y_next);
+#endif
+#endif
+
+#if PQ128_USE_FOCUS_SOFTMASK
+        /* Focus cue: edge(original) - edge(blurred). */
+        pq128_blur121_u8_line(y_prev, y_prev_blur);
+        pq128_blur121_u8_line(y_curr, y_curr_blur);
+        pq128_blur121_u8_line(y_next, y_next_blur);
+
+#if (PQ128_FOCUS_BLUR_PASSES > 1)
+        for (int pass = 1; pass < PQ128_FOCUS_BLUR_PASSES; pass++)
+        {
+            pq128_blur121_u8_line(y_prev_blur, y_blur_tmp);
+            memcpy(y_prev_blur, y_blur_tmp, FRAME_WIDTH);
+
+            pq128_blur121_u8_line(y_curr_blur, y_blur_tmp);
+            memcpy(y_curr_blur, y_blur_tmp, FRAME_WIDTH);
+
+            pq128_blur121_u8_line(y_next_blur, y_blur_tmp);
+            memcpy(y_next_blur, y_blur_tmp, FRAME_WIDTH);
+        }
+#endif
+
+        apply_sobel_filter(y_prev, y_curr, y_next, edge_orig);
+        apply_sobel_filter(y_prev_blur, y_curr_blur, y_next_blur, edge_blur);
+
+        for (int x0 = 0; x0 < FRAME_WIDTH; x0++)
+        {
+            int d = (int)edge_orig[x0] - (int)edge_blur[x0];
+            focus_line[x0] = (uint8_t)((d > 0) ? d : 0);
+        }
+#endif
+
+#if PQ128_USE_TAPER && (PQ128_TAPER_WIDTH > 0)
+        int32_t wy_q15 = (int32_t)s_taper_q15[ry];
+#endif
+        /* Compute p,q within ROI. Outer border is set to 0 (see PQ128_BORDER_ZERO_N). */
+        for (int rx = 0; rx < PQ128_SIZE; rx++)
+        {
+            if ((ry < PQ128_BORDER_ZERO_N) || (ry >= (PQ128_SIZE - PQ128_BORDER_ZERO_N)) ||
+                (rx < PQ128_BORDER_ZERO_N) || (rx >= (PQ128_SIZE - PQ128_BORDER_ZERO_N)))
+            {
+                p_row[rx] = 0;
+                q_row[rx] = 0;
+#if PQ128_USE_FOCUS_SOFTMASK && PQ128_STORE_FOCUS_PLANE
+                focus_row[rx] = 0;
+#endif
+#if PQ128_USE_FOCUS_SOFTMASK && PQ128_STORE_EDGE_PLANE
+                edge_row[rx] = 0;
+#endif
+#if PQ128_USE_FOCUS_SOFTMASK && PQ128_STORE_EDGE_BLUR_PLANE
+                edge_blur_row[rx] = 0;
+#endif
+#if PQ128_USE_FOCUS_SOFTMASK && PQ128_STORE_SATMASK_PLANE
+                satmask_row[rx] = 0;
+#endif
+                continue;
+            }
+
+            int x = PQ128_X0 + rx * PQ128_SAMPLE_STRIDE_X;
+
+#if PQ128_USE_FOCUS_SOFTMASK && PQ128_STORE_FOCUS_PLANE
+            focus_row[rx] = pq128_get_y_or_zero(focus_line, x);
+#endif
+#if PQ128_USE_FOCUS_SOFTMASK && PQ128_STORE_EDGE_PLANE
+            edge_row[rx] = pq128_get_y_or_zero(edge_orig, x);
+#endif
+#if PQ128_USE_FOCUS_SOFTMASK && PQ128_STORE_EDGE_BLUR_PLANE
+            edge_blur_row[rx] = pq128_get_y_or_zero(edge_blur, x);
+#endif
+
+#if PQ128_USE_FOCUS_SOFTMASK && PQ128_STORE_SATMASK_PLANE
+            {
+                const int raw_c = (int)pq128_get_y_or_zero(y_curr, x);
+                const int raw_xm1_m = (int)pq128_get_y_or_zero(y_curr, x - PQ128_SAMPLE_STRIDE_X);
+                const int raw_xp1_m = (int)pq128_get_y_or_zero(y_curr, x + PQ128_SAMPLE_STRIDE_X);
+                const int raw_ym1_m = (int)pq128_get_y_or_zero(y_prev, x);
+                const int raw_yp1_m = (int)pq128_get_y_or_zero(y_next, x);
+
+                const int hi = (int)PQ128_SATMASK_HI_TH;
+                const int lo = (int)PQ128_SATMASK_LO_TH;
+
+                const bool sat = (raw_c >= hi) || (raw_xm1_m >= hi) || (raw_xp1_m >= hi) || (raw_ym1_m >= hi) || (raw_yp1_m >= hi);
+                const bool dark = (raw_c <= lo) || (raw_xm1_m <= lo) || (raw_xp1_m <= lo) || (raw_ym1_m <= lo) || (raw_yp1_m <= lo);
+
+                satmask_row[rx] = (uint8_t)((!sat && !dark) ? 255 : 0);
+            }
+#endif
+            int raw_xm1 = (int)pq128_get_y_or_zero(y_curr, x - PQ128_SAMPLE_STRIDE_X);
+            int raw_xp1 = (int)pq128_get_y_or_zero(y_curr, x + PQ128_SAMPLE_STRIDE_X);
+            int raw_ym1 = (int)pq128_get_y_or_zero(y_prev, x);
+            int raw_yp1 = (int)pq128_get_y_or_zero(y_next, x);
+
+#if (PQ128_USE_INTENSITY_KNEE || PQ128_USE_INTENSITY_GAMMA)
+            int i_xm1 = (int)s_intensity_u8[(uint8_t)raw_xm1];
+            int i_xp1 = (int)s_intensity_u8[(uint8_t)raw_xp1];
+            int i_ym1 = (int)s_intensity_u8[(uint8_t)raw_ym1];
+            int i_yp1 = (int)s_intensity_u8[(uint8_t)raw_yp1];
+#else
+            int i_xm1 = raw_xm1;
+            int i_xp1 = raw_xp1;
+            int i_ym1 = raw_ym1;
+            int i_yp1 = raw_yp1;
+#endif
+
+            /* Saturation detection should use raw intensity (before knee). */
+            int32_t w_p_q15 = pq128_sat_weight_q15(raw_xm1, raw_xp1);
+            int32_t w_q_q15 = pq128_sat_weight_q15(raw_ym1, raw_yp1);
+
+#if PQ128_USE_DARK_SOFTMASK
+            {
+                int32_t wd_p_q15 = pq128_dark_weight_q15(raw_xm1, raw_xp1);
+                int32_t wd_q_q15 = pq128_dark_weight_q15(raw_ym1, raw_yp1);
+                w_p_q15 = (int32_t)(((int64_t)w_p_q15 * (int64_t)wd_p_q15 + (1 << 14)) >> 15);
+                w_q_q15 = (int32_t)(((int64_t)w_q_q15 * (int64_t)wd_q_q15 + (1 << 14)) >> 15);
+            }
+#endif
+
+#if PQ128_USE_CHROMA_EDGEMASK
+            {
+                int c_xm1 = (int)pq128_get_c_or_zero(c_curr, x - PQ128_SAMPLE_STRIDE_X);
+                int c_xp1 = (int)pq128_get_c_or_zero(c_curr, x + PQ128_SAMPLE_STRIDE_X);
+                int c_ym1 = (int)pq128_get_c_or_zero(c_prev, x);
+                int c_yp1 = (int)pq128_get_c_or_zero(c_next, x);
+
+                int dc_p = c_xp1 - c_xm1;
+                if (dc_p < 0)
+                {
+                    dc_p = -dc_p;
+                }
+                int dc_q = c_yp1 - c_ym1;
+                if (dc_q < 0)
+                {
+                    dc_q = -dc_q;
+                }
+
+                int32_t w_cp_q15 = pq128_chroma_edge_weight_q15(dc_p);
+                int32_t w_cq_q15 = pq128_chroma_edge_weight_q15(dc_q);
+                w_p_q15 = (int32_t)(((int64_t)w_p_q15 * (int64_t)w_cp_q15 + (1 << 14)) >> 15);
+                w_q_q15 = (int32_t)(((int64_t)w_q_q15 * (int64_t)w_cq_q15 + (1 << 14)) >> 15);
+            }
+#endif
+
+#if PQ128_USE_TAPER && (PQ128_TAPER_WIDTH > 0)
+            int32_t wx_q15 = (int32_t)s_taper_q15[rx];
+            int32_t w_taper_q15 = (int32_t)(((int64_t)wx_q15 * (int64_t)wy_q15 + (1 << 14)) >> 15);
+            w_p_q15 = (int32_t)(((int64_t)w_p_q15 * (int64_t)w_taper_q15 + (1 << 14)) >> 15);
+            w_q_q15 = (int32_t)(((int64_t)w_q_q15 * (int64_t)w_taper_q15 + (1 << 14)) >> 15);
+#endif
+
+#if PQ128_USE_FOCUS_SOFTMASK
+            {
+                int focus = (int)pq128_get_y_or_zero(focus_line, x);
+                int32_t w_f_q15 = pq128_focus_weight_q15(focus);
+                w_p_q15 = (int32_t)(((int64_t)w_p_q15 * (int64_t)w_f_q15 + (1 << 14)) >> 15);
+                w_q_q15 = (int32_t)(((int64_t)w_q_q15 * (int64_t)w_f_q15 + (1 << 14)) >> 15);
+            }
+#endif
+
+            if (w_p_q15 == 0)
+            {
+                p_row[rx] = 0;
+            }
+            else
+            {
+#if (PQ128_PQ_MODE == 3)
+                int raw_c = (int)pq128_get_y_or_zero(y_curr, x);
+#if (PQ128_USE_INTENSITY_KNEE || PQ128_USE_INTENSITY_GAMMA)
+                int i_c = (int)s_intensity_u8[(uint8_t)raw_c];
+#else
+                int i_c = raw_c;
+#endif
+                int32_t v = (int32_t)pq128_lightmodel_pq_i16(i_c, rp_q15);
+#else
+                int num = i_xp1 - i_xm1;
+                int den = i_xp1 + i_xm1 + PQ128_NORM_EPS;
+                if (den < 0)
+                {
+                    den = 0;
+                }
+                if (den > (int)PQ128_DEN_MAX)
+                {
+                    den = (int)PQ128_DEN_MAX;
+                }
+
+                int32_t v;
+#if (PQ128_PQ_MODE == 1)
+                (void)den;
+                v = (int32_t)((int32_t)num * (int32_t)PQ128_DIFF_SCALE);
+#elif (PQ128_PQ_MODE == 2)
+                if (den <= 0)
+                {
+                    v = 0;
+                }
+                else
+                {
+                    int sh = pq128_floor_log2_u32((uint32_t)den);
+                    v = (int32_t)(((int64_t)num * (int64_t)PQ128_NORM_SCALE) >> sh);
+                }
+#else
+#if PQ128_USE_RECIP_LUT
+                uint32_t recip = s_recip_q15[den];
+                v = (int32_t)(((int64_t)num * (int64_t)recip + (1 << 14)) >> 15);
+#else
+                v = (int32_t)((num * PQ128_NORM_SCALE) / den);
+#endif
+#endif
+#endif
+
+#if PQ128_APPLY_STRIDE_COMPENSATION
+                if (PQ128_SAMPLE_STRIDE_X > 1)
+                {
+                    v /= PQ128_SAMPLE_STRIDE_X;
+                }
+#endif
+
+#if PQ128_FLIP_P
+                v = -v;
+#endif
+
+                /* Apply saturation attenuation weight. */
+                v = (int32_t)(((int64_t)v * (int64_t)w_p_q15 + (1 << 14)) >> 15);
+                p_row[rx] = (int16_t)clamp_i32((int)v, -32768, 32767);
+            }
+
+            if (w_q_q15 == 0)
+            {
+                q_row[rx] = 0;
+            }
+            else
+            {
+#if (PQ128_PQ_MODE == 3)
+                int raw_c = (int)pq128_get_y_or_zero(y_curr, x);
+#if (PQ128_USE_INTENSITY_KNEE || PQ128_USE_INTENSITY_GAMMA)
+                int i_c = (int)s_intensity_u8[(uint8_t)raw_c];
+#else
+                int i_c = raw_c;
+#endif
+                int32_t v = (int32_t)pq128_lightmodel_pq_i16(i_c, rq_q15);
+#else
+                int num = i_yp1 - i_ym1;
+                int den = i_yp1 + i_ym1 + PQ128_NORM_EPS;
+                if (den < 0)
+                {
+                    den = 0;
+                }
+                if (den > (int)PQ128_DEN_MAX)
+                {
+                    den = (int)PQ128_DEN_MAX;
+                }
+
+                int32_t v;
+#if (PQ128_PQ_MODE == 1)
+                (void)den;
+                v = (int32_t)((int32_t)num * (int32_t)PQ128_DIFF_SCALE);
+#elif (PQ128_PQ_MODE == 2)
+                if (den <= 0)
+                {
+                    v = 0;
+                }
+                else
+                {
+                    int sh = pq128_floor_log2_u32((uint32_t)den);
+                    v = (int32_t)(((int64_t)num * (int64_t)PQ128_NORM_SCALE) >> sh);
+                }
+#else
+#if PQ128_USE_RECIP_LUT
+                uint32_t recip = s_recip_q15[den];
+                v = (int32_t)(((int64_t)num * (int64_t)recip + (1 << 14)) >> 15);
+#else
+                v = (int32_t)((num * PQ128_NORM_SCALE) / den);
+#endif
+#endif
+#endif
+
+#if PQ128_APPLY_STRIDE_COMPENSATION
+                if (PQ128_SAMPLE_STRIDE_Y > 1)
+                {
+                    v /= PQ128_SAMPLE_STRIDE_Y;
+                }
+#endif
+
+#if PQ128_FLIP_Q
+                v = -v;
+#endif
+
+                /* Apply saturation attenuation weight. */
+                v = (int32_t)(((int64_t)v * (int64_t)w_q_q15 + (1 << 14)) >> 15);
+                q_row[rx] = (int16_t)clamp_i32((int)v, -32768, 32767);
+            }
+        }
+
+        uint32_t row_off = (uint32_t)ry * (uint32_t)PQ128_SIZE * (uint32_t)sizeof(int16_t);
+        (void)hyperram_b_write(p_row, (void *)(frame_base_offset + PQ128_P_OFFSET + row_off), (uint32_t)PQ128_SIZE * (uint32_t)sizeof(int16_t));
+        (void)hyperram_b_write(q_row, (void *)(frame_base_offset + PQ128_Q_OFFSET + row_off), (uint32_t)PQ128_SIZE * (uint32_t)sizeof(int16_t));
+
+#if PQ128_USE_FOCUS_SOFTMASK && PQ128_STORE_FOCUS_PLANE
+        (void)hyperram_b_write(focus_row,
+                               (void *)(frame_base_offset + PQ128_FOCUS_OFFSET + (uint32_t)ry * (uint32_t)PQ128_SIZE),
+                               (uint32_t)PQ128_SIZE);
+#endif
+
+#if PQ128_USE_FOCUS_SOFTMASK && PQ128_STORE_EDGE_PLANE
+        (void)hyperram_b_write(edge_row,
+                               (void *)(frame_base_offset + PQ128_EDGE_OFFSET + (uint32_t)ry * (uint32_t)PQ128_SIZE),
+                               (uint32_t)PQ128_SIZE);
+#endif
+
+#if PQ128_USE_FOCUS_SOFTMASK && PQ128_STORE_EDGE_BLUR_PLANE
+        (void)hyperram_b_write(edge_blur_row,
+                               (void *)(frame_base_offset + PQ128_EDGE_BLUR_OFFSET + (uint32_t)ry * (uint32_t)PQ128_SIZE),
+                               (uint32_t)PQ128_SIZE);
 #endif
 
-static FC128_UNUSED void load_y_line_from_hyperram_or_zero(uint32_t frame_base_offset,
-                                                           int requested_row,
-                                                           uint8_t yuv_line[FRAME_WIDTH * 2],
-                                                           uint8_t y_line[FRAME_WIDTH])
-{
-    if ((requested_row < 0) || (requested_row >= FRAME_HEIGHT))
-    {
-        memset(y_line, 0, FRAME_WIDTH);
-        return;
-    }
-    (void)load_y_line_from_hyperram_base(frame_base_offset, requested_row, yuv_line, y_line);
-}
+#if PQ128_USE_FOCUS_SOFTMASK && PQ128_STORE_SATMASK_PLANE
+        (void)hyperram_b_write(satmask_row,
+                               (void *)(frame_base_offset + PQ128_SATMASK_OFFSET + (uint32_t)ry * (uint32_t)PQ128_SIZE),
+                               (uint32_t)PQ128_SIZE);
+#endif
 
-static inline uint8_t pq128_get_y_or_zero(const uint8_t y_line[FRAME_WIDTH], int x)
-{
-    if ((x < 0) || (x >= FRAME_WIDTH))
-    {
-        return 0;
+#if (PQ128_SAMPLE_STRIDE_Y == 1)
+        /* Slide window: prev <- curr, curr <- next, next <- load(row+2). */
+        memcpy(y_prev, y_curr, FRAME_WIDTH);
+        memcpy(y_curr, y_next, FRAME_WIDTH);
+#if PQ128_USE_CHROMA_EDGEMASK
+        memcpy(c_prev, c_curr, FRAME_WIDTH);
+        memcpy(c_curr, c_next, FRAME_WIDTH);
+        load_yc_line_from_hyperram_or_zero(frame_base_offset, PQ128_Y0 + ry + 2, yuv_tmp, y_next, c_next);
+#else
+        load_y_line_from_hyperram_or_zero(frame_base_offset, PQ128_Y0 + ry + 2, yuv_tmp, y_next);
+#endif
+#endif
     }
-    return y_line[x];
+
+    __DMB();
+    g_pq128_base_offset = frame_base_offset;
+    __DMB();
+    g_pq128_seq = frame_seq;
+    latency_trace_stamp(frame_seq, LATENCY_STAGE_PQ_DONE);
 }
 
-static void pq128_compute_and_store(uint32_t frame_base_offset, uint32_t frame_seq)
-{
-    uint8_t yuv_tmp[FRAME_WIDTH * 2];
-    uint8_t y_prev[FRAME_WIDTH];
-    uint8_t y_curr[FRAME_WIDTH];
-    uint8_t y_next[FRAME_WIDTH];
-#if PQ128_USE_FOCUS_SOFTMASK
-    uint8_t y_prev_blur[FRAME_WIDTH];
-    uint8_t y_curr_blur[FRAME_WIDTH];
-    uint8_t y_next_blur[FRAME_WIDTH];
-    uint8_t y_blur_tmp[FRAME_WIDTH];
-    uint8_t edge_orig[FRAME_WIDTH];
-    uint8_t edge_blur[FRAME_WIDTH];
-    uint8_t focus_line[FRAME_WIDTH];
-#if PQ128_STORE_FOCUS_PLANE
-    uint8_t focus_row[PQ128_SIZE];
+/* ---- PQ128 fast kernel ----
+ * Produces the same p/q/focus/edge/satmask planes as pq128_compute_and_store_ref(),
+ * restructured for speed:
+ * - Each source line is fetched from HyperRAM once into a 3-slot ring (pointer rotation, no memcpy).
+ *   This also holds for stride_y>1, since output rows and vertical taps share the same stride.
+ * - Per line, the ROI samples (raw, intensity LUT, chroma) and the optional blur are computed once
+ *   instead of once per use as prev/curr/next.
+ * - Soft masks are 256-entry Q15 LUTs; light-model p/q are per-frame LUTs.
+ * - PQ_MODE 0: reciprocal LUT + one correction step (exact truncating divide).
+ * - Row math runs on 4-lane MVE vectors; the scalar fallback uses the same arithmetic.
+ */
+#define PQ128_LINE_SPAN (PQ128_SIZE + 2) /* sampled line incl. rx=-1 and rx=PQ128_SIZE taps */
+
+#define PQ128_FAST_HAS_INTENSITY_LUT (PQ128_USE_INTENSITY_KNEE || PQ128_USE_INTENSITY_GAMMA)
+
+/* Reciprocal for PQ_MODE 0: R = ceil(2^19/den) fits uint16 when den >= 9, and
+ * q = (n*R)>>19 is at most one above n/den while n = |num|*scale < 2^19, so one correction
+ * step gives the exact truncating divide (1KB LUT instead of the legacy 2KB Q15 one).
+ * PQ128_USE_RECIP_LUT keeps the legacy rounded Q15 reciprocal instead.
+ */
+#define PQ128_RECIP_SHIFT (19)
+#if (PQ128_NORM_EPS >= 9) && ((255 * PQ128_NORM_SCALE) < (1 << PQ128_RECIP_SHIFT)) && !PQ128_USE_RECIP_LUT
+#define PQ128_FAST_RECIP_OK (1)
+#else
+#define PQ128_FAST_RECIP_OK (0)
 #endif
-#if PQ128_STORE_EDGE_PLANE
-    uint8_t edge_row[PQ128_SIZE];
+
+/* Upper bound of |v| before weighting; keeps v*w_q15 inside int32 on the vector path. */
+#if (PQ128_PQ_MODE == 1)
+#define PQ128_FAST_VMAX (255 * PQ128_DIFF_SCALE)
+#elif (PQ128_PQ_MODE == 3)
+#define PQ128_FAST_VMAX (32767)
+#else
+#define PQ128_FAST_VMAX (255 * PQ128_NORM_SCALE)
 #endif
-#if PQ128_STORE_EDGE_BLUR_PLANE
-    uint8_t edge_blur_row[PQ128_SIZE];
+
+#if (PQ128_SAMPLE_STRIDE_X == 1)
+#define PQ128_STRIDE_X_SHIFT (0)
+#elif (PQ128_SAMPLE_STRIDE_X == 2)
+#define PQ128_STRIDE_X_SHIFT (1)
+#elif (PQ128_SAMPLE_STRIDE_X == 4)
+#define PQ128_STRIDE_X_SHIFT (2)
+#else
+#define PQ128_STRIDE_X_SHIFT (-1)
 #endif
-#if PQ128_STORE_SATMASK_PLANE
-    uint8_t satmask_row[PQ128_SIZE];
+
+#if (PQ128_SAMPLE_STRIDE_Y == 1)
+#define PQ128_STRIDE_Y_SHIFT (0)
+#elif (PQ128_SAMPLE_STRIDE_Y == 2)
+#define PQ128_STRIDE_Y_SHIFT (1)
+#elif (PQ128_SAMPLE_STRIDE_Y == 4)
+#define PQ128_STRIDE_Y_SHIFT (2)
+#else
+#define PQ128_STRIDE_Y_SHIFT (-1)
+#endif
+
+/* Vector path needs pow2 strides (shift-based truncating divide) and bounded magnitudes. */
+#if USE_HELIUM_MVE && (PQ128_STRIDE_X_SHIFT >= 0) && (PQ128_STRIDE_Y_SHIFT >= 0) && \
+    (PQ128_FAST_VMAX < 65535) && ((PQ128_SIZE % 16) == 0) &&                            \
+    ((PQ128_PQ_MODE != 0) || PQ128_FAST_RECIP_OK)
+#define PQ128_FAST_USE_MVE (1)
+#else
+#define PQ128_FAST_USE_MVE (0)
 #endif
+
+typedef struct
+{
+    uint8_t raw[PQ128_LINE_SPAN];
+#if PQ128_FAST_HAS_INTENSITY_LUT
+    uint8_t inten[PQ128_LINE_SPAN];
 #endif
 #if PQ128_USE_CHROMA_EDGEMASK
-    uint8_t c_prev[FRAME_WIDTH];
-    uint8_t c_curr[FRAME_WIDTH];
-    uint8_t c_next[FRAME_WIDTH];
+    uint8_t chroma[PQ128_LINE_SPAN];
 #endif
-    int16_t p_row[PQ128_SIZE];
-    int16_t q_row[PQ128_SIZE];
+#if PQ128_USE_FOCUS_SOFTMASK
+    uint8_t y[FRAME_WIDTH_MAX];
+    uint8_t y_blur[FRAME_WIDTH_MAX];
+#endif
+} pq128_line_t;
 
-    /* Mark as in-progress (consumer should wait for a non-zero stable seq). */
-    g_pq128_seq = 0;
+#if PQ128_FAST_HAS_INTENSITY_LUT
+#define PQ128_LINE_INTEN(l) ((l)->inten)
+#else
+#define PQ128_LINE_INTEN(l) ((l)->raw)
+#endif
 
-    /* Prime 3-line window.
-     * Sliding-window fast path is valid only when stride_y==1.
-     */
-#if (PQ128_SAMPLE_STRIDE_Y == 1)
+typedef struct
+{
+    uint16_t w_sat_q15[256]; /* by max(i0,i1) */
+#if PQ128_USE_DARK_SOFTMASK
+    uint16_t w_dark_q15[256]; /* by (i0+i1)>>1 */
+#endif
 #if PQ128_USE_CHROMA_EDGEMASK
-    load_yc_line_from_hyperram_or_zero(frame_base_offset, PQ128_Y0 - 1, yuv_tmp, y_prev, c_prev);
-    load_yc_line_from_hyperram_or_zero(frame_base_offset, PQ128_Y0 + 0, yuv_tmp, y_curr, c_curr);
-    load_yc_line_from_hyperram_or_zero(frame_base_offset, PQ128_Y0 + 1, yuv_tmp, y_next, c_next);
-#else
-    load_y_line_from_hyperram_or_zero(frame_base_offset, PQ128_Y0 - 1, yuv_tmp, y_prev);
-    load_y_line_from_hyperram_or_zero(frame_base_offset, PQ128_Y0 + 0, yuv_tmp, y_curr);
-    load_y_line_from_hyperram_or_zero(frame_base_offset, PQ128_Y0 + 1, yuv_tmp, y_next);
+    uint16_t w_chroma_q15[256]; /* by |c1-c0| */
+#endif
+#if PQ128_USE_FOCUS_SOFTMASK
+    uint16_t w_focus_q15[256]; /* by focus */
+#endif
+#if PQ128_FAST_HAS_INTENSITY_LUT
+    uint8_t intensity_u8[256];
+#endif
+#if PQ128_USE_TAPER && (PQ128_TAPER_WIDTH > 0)
+    uint16_t taper_q15[PQ128_SIZE];
+#endif
+#if (PQ128_PQ_MODE == 0) && PQ128_FAST_RECIP_OK
+    uint16_t recip_u16[PQ128_DEN_MAX + 1];
+#elif (PQ128_PQ_MODE == 0) && PQ128_USE_RECIP_LUT
+    uint32_t recip_q15[PQ128_DEN_MAX + 1];
 #endif
+#if (PQ128_PQ_MODE == 3)
+    int16_t light_p[256]; /* rebuilt per frame from the current light direction */
+    int16_t light_q[256];
 #endif
+} pq128_fast_tables_t;
 
-    /*
-     * p,q generation (selected by PQ128_PQ_MODE).
-     * Default is contrast-invariant (reduces albedo/brightness bias):
-     *   p = (I(x+1)-I(x-1)) / (I(x+1)+I(x-1)+eps)
-     *   q = (I(y+1)-I(y-1)) / (I(y+1)+I(y-1)+eps)
-     * Strong-approx modes can be used for extra speed.
-     */
+static pq128_fast_tables_t s_pq128_tab;
+static bool s_pq128_tab_inited = false;
 
-#if (PQ128_PQ_MODE == 0) && PQ128_USE_RECIP_LUT
-    /* Q15 reciprocal LUT for v = (num * PQ128_NORM_SCALE) / den.
-     * recip_q15[den] = (PQ128_NORM_SCALE<<15)/den
-     */
-    static bool s_recip_inited = false;
-    static uint32_t s_recip_q15[PQ128_DEN_MAX + 1];
-    if (!s_recip_inited)
+static void pq128_fast_init_tables_once(void)
+{
+    if (s_pq128_tab_inited)
     {
-        s_recip_q15[0] = 0U;
-        for (int d = 1; d <= (int)PQ128_DEN_MAX; d++)
-        {
-            s_recip_q15[d] = (((uint32_t)PQ128_NORM_SCALE) << 15) / (uint32_t)d;
-        }
-        s_recip_inited = true;
+        return;
     }
-#endif
 
-#if (PQ128_USE_INTENSITY_KNEE || PQ128_USE_INTENSITY_GAMMA)
-    static bool s_intensity_lut_inited = false;
-    static uint8_t s_intensity_u8[256];
-    if (!s_intensity_lut_inited)
+    for (int i = 0; i < 256; i++)
     {
-        pq128_init_intensity_lut(s_intensity_u8);
-        s_intensity_lut_inited = true;
+        s_pq128_tab.w_sat_q15[i] = (uint16_t)pq128_sat_weight_q15(i, i);
+#if PQ128_USE_DARK_SOFTMASK
+        s_pq128_tab.w_dark_q15[i] = (uint16_t)pq128_dark_weight_q15(i, i);
+#endif
+#if PQ128_USE_CHROMA_EDGEMASK
+        s_pq128_tab.w_chroma_q15[i] = (uint16_t)pq128_chroma_edge_weight_q15(i);
+#endif
+#if PQ128_USE_FOCUS_SOFTMASK
+        s_pq128_tab.w_focus_q15[i] = (uint16_t)pq128_focus_weight_q15(i);
+#endif
     }
+#if PQ128_FAST_HAS_INTENSITY_LUT
+    pq128_init_intensity_lut(s_pq128_tab.intensity_u8);
 #endif
-
 #if PQ128_USE_TAPER && (PQ128_TAPER_WIDTH > 0)
-    static bool s_taper_inited = false;
-    static uint16_t s_taper_q15[PQ128_SIZE];
-    if (!s_taper_inited)
+    pq128_init_taper_lut_q15(s_pq128_tab.taper_q15);
+#endif
+#if (PQ128_PQ_MODE == 0) && PQ128_FAST_RECIP_OK
+    /* den >= PQ128_NORM_EPS always, so entries below it are never read. */
+    for (uint32_t d = 0U; d <= (uint32_t)PQ128_DEN_MAX; d++)
     {
-        pq128_init_taper_lut_q15(s_taper_q15);
-        s_taper_inited = true;
+        uint32_t r = (d < (uint32_t)PQ128_NORM_EPS) ? 0U : (((1UL << PQ128_RECIP_SHIFT) + d - 1U) / d);
+        s_pq128_tab.recip_u16[d] = (uint16_t)r;
     }
-#endif
-
-#if (PQ128_PQ_MODE == 3)
-    int32_t rp_q15 = 0;
-    int32_t rq_q15 = 0;
-    pq128_lightmodel_ratios_q15(&rp_q15, &rq_q15);
-#endif
-
-    for (int ry = 0; ry < PQ128_SIZE; ry++)
+#elif (PQ128_PQ_MODE == 0) && PQ128_USE_RECIP_LUT
+    s_pq128_tab.recip_q15[0] = 0U;
+    for (uint32_t d = 1U; d <= (uint32_t)PQ128_DEN_MAX; d++)
     {
-#if (PQ128_SAMPLE_STRIDE_Y != 1)
-        int src_y = PQ128_Y0 + ry * PQ128_SAMPLE_STRIDE_Y;
-#if PQ128_USE_CHROMA_EDGEMASK
-        load_yc_line_from_hyperram_or_zero(frame_base_offset, src_y - PQ128_SAMPLE_STRIDE_Y, yuv_tmp, y_prev, c_prev);
-        load_yc_line_from_hyperram_or_zero(frame_base_offset, src_y, yuv_tmp, y_curr, c_curr);
-        load_yc_line_from_hyperram_or_zero(frame_base_offset, src_y + PQ128_SAMPLE_STRIDE_Y, yuv_tmp, y_next, c_next);
-#else
-        load_y_line_from_hyperram_or_zero(frame_base_offset, src_y - PQ128_SAMPLE_STRIDE_Y, yuv_tmp, y_prev);
-        load_y_line_from_hyperram_or_zero(frame_base_offset, src_y, yuv_tmp, y_curr);
-        load_y_line_from_hyperram_or_zero(frame_base_offset, src_y + PQ128_SAMPLE_STRIDE_Y, yuv_tmp, y_next);
-#endif
+        s_pq128_tab.recip_q15[d] = (((uint32_t)PQ128_NORM_SCALE) << 15) / d;
+    }
 #endif
 
-#if PQ128_USE_FOCUS_SOFTMASK
-        /* Focus cue: edge(original) - edge(blurred). */
-        pq128_blur121_u8_line(y_prev, y_prev_blur);
-        pq128_blur121_u8_line(y_curr, y_curr_blur);
-        pq128_blur121_u8_line(y_next, y_next_blur);
+    s_pq128_tab_inited = true;
+}
 
-#if (PQ128_FOCUS_BLUR_PASSES > 1)
-        for (int pass = 1; pass < PQ128_FOCUS_BLUR_PASSES; pass++)
-        {
-            pq128_blur121_u8_line(y_prev_blur, y_blur_tmp);
-            memcpy(y_prev_blur, y_blur_tmp, FRAME_WIDTH);
+#if PQ128_STREAM_CAPTURE
 
-            pq128_blur121_u8_line(y_curr_blur, y_blur_tmp);
-            memcpy(y_curr_blur, y_blur_tmp, FRAME_WIDTH);
+/* 帯ストリーミング中の行ソース(sram==NULL なら HyperRAM から読む) */
+typedef struct
+{
+    const uint8_t *sram; /* CEU の書き込み先 SRAM バッファ */
+    uint32_t gen;        /* cam_band_frame_t.gen */
+    bool aborted;        /* バッファ再利用/タイムアウトで中断 */
+} pq128_stream_src_t;
 
-            pq128_blur121_u8_line(y_next_blur, y_blur_tmp);
-            memcpy(y_next_blur, y_blur_tmp, FRAME_WIDTH);
+static pq128_stream_src_t s_pq128_stream = {NULL, 0U, false};
+
+/* requested_row が SRAM に着地するまで帯通知で待つ．不可なら false */
+static bool pq128_stream_wait_row(int requested_row)
+{
+    while (!s_pq128_stream.aborted)
+    {
+        const int32_t lines = cam_band_lines_ready(s_pq128_stream.gen);
+        if (lines < 0)
+        {
+            s_pq128_stream.aborted = true;
+            break;
+        }
+        if (lines > requested_row)
+        {
+            return true;
+        }
+        if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(PQ128_STREAM_TIMEOUT_MS)) == 0U)
+        {
+            s_pq128_stream.aborted = true;
         }
+    }
+    return false;
+}
 #endif
 
-        apply_sobel_filter(y_prev, y_curr, y_next, edge_orig);
-        apply_sobel_filter(y_prev_blur, y_curr_blur, y_next_blur, edge_blur);
+/* Fetch one source row into a ring slot: UYVY -> Y (and chroma), ROI samples, intensity LUT, blur. */
+static void pq128_fast_load_line(uint32_t frame_base_offset,
+                                 int src_x0,
+                                 int requested_row,
+                                 uint8_t yuv_tmp[FRAME_WIDTH_MAX * 2],
+                                 pq128_line_t *l)
+{
+    if ((requested_row < 0) || (requested_row >= FRAME_HEIGHT))
+    {
+        memset(l, 0, sizeof(*l));
+        return;
+    }
 
-        for (int x0 = 0; x0 < FRAME_WIDTH; x0++)
-        {
-            int d = (int)edge_orig[x0] - (int)edge_blur[x0];
-            focus_line[x0] = (uint8_t)((d > 0) ? d : 0);
-        }
+#if PQ128_USE_FOCUS_SOFTMASK
+    uint8_t *y_line = l->y;
+#else
+    uint8_t y_line[FRAME_WIDTH_MAX];
 #endif
 
-#if PQ128_USE_TAPER && (PQ128_TAPER_WIDTH > 0)
-        int32_t wy_q15 = (int32_t)s_taper_q15[ry];
+#if PQ128_USE_CHROMA_EDGEMASK
+    uint8_t c_line[FRAME_WIDTH_MAX];
+    uint8_t *c_out = c_line;
+#else
+    uint8_t *c_out = NULL;
 #endif
-        /* Compute p,q within ROI. Outer border is set to 0 (see PQ128_BORDER_ZERO_N). */
-        for (int rx = 0; rx < PQ128_SIZE; rx++)
+
+#if PQ128_STREAM_CAPTURE
+    if (s_pq128_stream.sram != NULL)
+    {
+        /* CEU の SRAM バッファから直接(HyperRAM 往復なし，常に UYVY) */
+        if (!pq128_stream_wait_row(requested_row))
         {
-            if ((ry < PQ128_BORDER_ZERO_N) || (ry >= (PQ128_SIZE - PQ128_BORDER_ZERO_N)) ||
-                (rx < PQ128_BORDER_ZERO_N) || (rx >= (PQ128_SIZE - PQ128_BORDER_ZERO_N)))
-            {
-                p_row[rx] = 0;
-                q_row[rx] = 0;
-#if PQ128_USE_FOCUS_SOFTMASK && PQ128_STORE_FOCUS_PLANE
-                focus_row[rx] = 0;
-#endif
-#if PQ128_USE_FOCUS_SOFTMASK && PQ128_STORE_EDGE_PLANE
-                edge_row[rx] = 0;
-#endif
-#if PQ128_USE_FOCUS_SOFTMASK && PQ128_STORE_EDGE_BLUR_PLANE
-                edge_blur_row[rx] = 0;
+            memset(l, 0, sizeof(*l));
+            return;
+        }
+        const uint8_t *yuv = s_pq128_stream.sram + (uint32_t)requested_row * (uint32_t)FRAME_WIDTH * 2U;
+        extract_y_line_uyvy_swap_y(yuv, y_line, (uint32_t)FRAME_WIDTH);
+#if PQ128_USE_CHROMA_EDGEMASK
+        extract_chroma_mag_line_uyvy_reorder(yuv, c_out, (uint32_t)FRAME_WIDTH);
 #endif
-#if PQ128_USE_FOCUS_SOFTMASK && PQ128_STORE_SATMASK_PLANE
-                satmask_row[rx] = 0;
+    }
+    else
 #endif
-                continue;
-            }
-
-            int x = PQ128_X0 + rx * PQ128_SAMPLE_STRIDE_X;
+    {
+        (void)video_frame_load_yc_line(frame_base_offset, requested_row, yuv_tmp, y_line, c_out);
+    }
 
-#if PQ128_USE_FOCUS_SOFTMASK && PQ128_STORE_FOCUS_PLANE
-            focus_row[rx] = pq128_get_y_or_zero(focus_line, x);
-#endif
-#if PQ128_USE_FOCUS_SOFTMASK && PQ128_STORE_EDGE_PLANE
-            edge_row[rx] = pq128_get_y_or_zero(edge_orig, x);
+    for (int s = 0; s < PQ128_LINE_SPAN; s++)
+    {
+        const int x = src_x0 + (s - 1) * PQ128_SAMPLE_STRIDE_X;
+        const uint8_t v = pq128_get_y_or_zero(y_line, x);
+        l->raw[s] = v;
+#if PQ128_FAST_HAS_INTENSITY_LUT
+        l->inten[s] = s_pq128_tab.intensity_u8[v];
 #endif
-#if PQ128_USE_FOCUS_SOFTMASK && PQ128_STORE_EDGE_BLUR_PLANE
-            edge_blur_row[rx] = pq128_get_y_or_zero(edge_blur, x);
+#if PQ128_USE_CHROMA_EDGEMASK
+        l->chroma[s] = pq128_get_c_or_zero(c_line, x);
 #endif
+    }
 
-#if PQ128_USE_FOCUS_SOFTMASK && PQ128_STORE_SATMASK_PLANE
-            {
-                const int raw_c = (int)pq128_get_y_or_zero(y_curr, x);
-                const int raw_xm1_m = (int)pq128_get_y_or_zero(y_curr, x - PQ128_SAMPLE_STRIDE_X);
-                const int raw_xp1_m = (int)pq128_get_y_or_zero(y_curr, x + PQ128_SAMPLE_STRIDE_X);
-                const int raw_ym1_m = (int)pq128_get_y_or_zero(y_prev, x);
-                const int raw_yp1_m = (int)pq128_get_y_or_zero(y_next, x);
-
-                const int hi = (int)PQ128_SATMASK_HI_TH;
-                const int lo = (int)PQ128_SATMASK_LO_TH;
+#if PQ128_USE_FOCUS_SOFTMASK
+    pq128_blur121_u8_line(l->y, l->y_blur);
+#if (PQ128_FOCUS_BLUR_PASSES > 1)
+    uint8_t blur_tmp[FRAME_WIDTH_MAX];
+    for (int pass = 1; pass < PQ128_FOCUS_BLUR_PASSES; pass++)
+    {
+        pq128_blur121_u8_line(l->y_blur, blur_tmp);
+        memcpy(l->y_blur, blur_tmp, FRAME_WIDTH);
+    }
+#endif
+#endif
+}
 
-                const bool sat = (raw_c >= hi) || (raw_xm1_m >= hi) || (raw_xp1_m >= hi) || (raw_ym1_m >= hi) || (raw_yp1_m >= hi);
-                const bool dark = (raw_c <= lo) || (raw_xm1_m <= lo) || (raw_xp1_m <= lo) || (raw_ym1_m <= lo) || (raw_yp1_m <= lo);
+static inline int32_t pq128_q15_mul(int32_t w, int32_t w2_q15)
+{
+    return (int32_t)(((int64_t)w * (int64_t)w2_q15 + (1 << 14)) >> 15);
+}
 
-                satmask_row[rx] = (uint8_t)((!sat && !dark) ? 255 : 0);
-            }
+/* Shared tail of p/q: stride compensation, flip, weight, int16 clamp (matches the reference). */
+static inline int16_t pq128_fast_finish(int32_t v, int32_t w_q15, int stride, int flip)
+{
+#if PQ128_APPLY_STRIDE_COMPENSATION
+    if (stride > 1)
+    {
+        v /= stride;
+    }
+#else
+    (void)stride;
 #endif
-            int raw_xm1 = (int)pq128_get_y_or_zero(y_curr, x - PQ128_SAMPLE_STRIDE_X);
-            int raw_xp1 = (int)pq128_get_y_or_zero(y_curr, x + PQ128_SAMPLE_STRIDE_X);
-            int raw_ym1 = (int)pq128_get_y_or_zero(y_prev, x);
-            int raw_yp1 = (int)pq128_get_y_or_zero(y_next, x);
+    if (flip)
+    {
+        v = -v;
+    }
+    v = pq128_q15_mul(v, w_q15);
+    return (int16_t)clamp_i32((int)v, -32768, 32767);
+}
 
-#if (PQ128_USE_INTENSITY_KNEE || PQ128_USE_INTENSITY_GAMMA)
-            int i_xm1 = (int)s_intensity_u8[(uint8_t)raw_xm1];
-            int i_xp1 = (int)s_intensity_u8[(uint8_t)raw_xp1];
-            int i_ym1 = (int)s_intensity_u8[(uint8_t)raw_ym1];
-            int i_yp1 = (int)s_intensity_u8[(uint8_t)raw_yp1];
+#if (PQ128_PQ_MODE != 3)
+static inline int32_t pq128_fast_grad(int i0, int i1)
+{
+    int num = i1 - i0;
+    int den = clamp_i32(i1 + i0 + PQ128_NORM_EPS, 0, (int)PQ128_DEN_MAX);
+#if (PQ128_PQ_MODE == 1)
+    (void)den;
+    return (int32_t)num * (int32_t)PQ128_DIFF_SCALE;
+#elif (PQ128_PQ_MODE == 2)
+    if (den <= 0)
+    {
+        return 0;
+    }
+    return (int32_t)(((int64_t)num * (int64_t)PQ128_NORM_SCALE) >> pq128_floor_log2_u32((uint32_t)den));
 #else
-            int i_xm1 = raw_xm1;
-            int i_xp1 = raw_xp1;
-            int i_ym1 = raw_ym1;
-            int i_yp1 = raw_yp1;
+    if (den <= 0)
+    {
+        return 0;
+    }
+#if PQ128_FAST_RECIP_OK
+    uint32_t n = (uint32_t)((num < 0) ? -num : num) * (uint32_t)PQ128_NORM_SCALE;
+    uint32_t q = (uint32_t)(((uint64_t)n * (uint64_t)s_pq128_tab.recip_u16[den]) >> PQ128_RECIP_SHIFT);
+    if ((q * (uint32_t)den) > n)
+    {
+        q--;
+    }
+    return (num < 0) ? -(int32_t)q : (int32_t)q;
+#elif PQ128_USE_RECIP_LUT
+    return (int32_t)(((int64_t)num * (int64_t)s_pq128_tab.recip_q15[den] + (1 << 14)) >> 15);
+#else
+    return (int32_t)((num * PQ128_NORM_SCALE) / den);
+#endif
+#endif
+}
 #endif
 
-            /* Saturation detection should use raw intensity (before knee). */
-            int32_t w_p_q15 = pq128_sat_weight_q15(raw_xm1, raw_xp1);
-            int32_t w_q_q15 = pq128_sat_weight_q15(raw_ym1, raw_yp1);
+/* Scalar p/q for rx in [rx_begin, PQ128_SIZE). */
+static void pq128_fast_pq_row_scalar(const pq128_line_t *lp,
+                                     const pq128_line_t *lc,
+                                     const pq128_line_t *ln,
+                                     const uint8_t *focus_s,
+                                     const uint16_t *taper_row_q15,
+                                     int rx_begin,
+                                     int16_t *p_row,
+                                     int16_t *q_row)
+{
+    (void)focus_s;
+    (void)taper_row_q15;
+
+    for (int rx = rx_begin; rx < PQ128_SIZE; rx++)
+    {
+        const int raw_xm1 = (int)lc->raw[rx];
+        const int raw_xp1 = (int)lc->raw[rx + 2];
+        const int raw_ym1 = (int)lp->raw[rx + 1];
+        const int raw_yp1 = (int)ln->raw[rx + 1];
 
+        int32_t w_p_q15 = (int32_t)s_pq128_tab.w_sat_q15[(raw_xm1 > raw_xp1) ? raw_xm1 : raw_xp1];
+        int32_t w_q_q15 = (int32_t)s_pq128_tab.w_sat_q15[(raw_ym1 > raw_yp1) ? raw_ym1 : raw_yp1];
 #if PQ128_USE_DARK_SOFTMASK
-            {
-                int32_t wd_p_q15 = pq128_dark_weight_q15(raw_xm1, raw_xp1);
-                int32_t wd_q_q15 = pq128_dark_weight_q15(raw_ym1, raw_yp1);
-                w_p_q15 = (int32_t)(((int64_t)w_p_q15 * (int64_t)wd_p_q15 + (1 << 14)) >> 15);
-                w_q_q15 = (int32_t)(((int64_t)w_q_q15 * (int64_t)wd_q_q15 + (1 << 14)) >> 15);
-            }
+        w_p_q15 = pq128_q15_mul(w_p_q15, (int32_t)s_pq128_tab.w_dark_q15[(raw_xm1 + raw_xp1) >> 1]);
+        w_q_q15 = pq128_q15_mul(w_q_q15, (int32_t)s_pq128_tab.w_dark_q15[(raw_ym1 + raw_yp1) >> 1]);
 #endif
-
 #if PQ128_USE_CHROMA_EDGEMASK
-            {
-                int c_xm1 = (int)pq128_get_c_or_zero(c_curr, x - PQ128_SAMPLE_STRIDE_X);
-                int c_xp1 = (int)pq128_get_c_or_zero(c_curr, x + PQ128_SAMPLE_STRIDE_X);
-                int c_ym1 = (int)pq128_get_c_or_zero(c_prev, x);
-                int c_yp1 = (int)pq128_get_c_or_zero(c_next, x);
-
-                int dc_p = c_xp1 - c_xm1;
-                if (dc_p < 0)
-                {
-                    dc_p = -dc_p;
-                }
-                int dc_q = c_yp1 - c_ym1;
-                if (dc_q < 0)
-                {
-                    dc_q = -dc_q;
-                }
-
-                int32_t w_cp_q15 = pq128_chroma_edge_weight_q15(dc_p);
-                int32_t w_cq_q15 = pq128_chroma_edge_weight_q15(dc_q);
-                w_p_q15 = (int32_t)(((int64_t)w_p_q15 * (int64_t)w_cp_q15 + (1 << 14)) >> 15);
-                w_q_q15 = (int32_t)(((int64_t)w_q_q15 * (int64_t)w_cq_q15 + (1 << 14)) >> 15);
-            }
+        {
+            int dc_p = (int)lc->chroma[rx + 2] - (int)lc->chroma[rx];
+            int dc_q = (int)ln->chroma[rx + 1] - (int)lp->chroma[rx + 1];
+            dc_p = (dc_p < 0) ? -dc_p : dc_p;
+            dc_q = (dc_q < 0) ? -dc_q : dc_q;
+            w_p_q15 = pq128_q15_mul(w_p_q15, (int32_t)s_pq128_tab.w_chroma_q15[dc_p]);
+            w_q_q15 = pq128_q15_mul(w_q_q15, (int32_t)s_pq128_tab.w_chroma_q15[dc_q]);
+        }
 #endif
-
 #if PQ128_USE_TAPER && (PQ128_TAPER_WIDTH > 0)
-            int32_t wx_q15 = (int32_t)s_taper_q15[rx];
-            int32_t w_taper_q15 = (int32_t)(((int64_t)wx_q15 * (int64_t)wy_q15 + (1 << 14)) >> 15);
-            w_p_q15 = (int32_t)(((int64_t)w_p_q15 * (int64_t)w_taper_q15 + (1 << 14)) >> 15);
-            w_q_q15 = (int32_t)(((int64_t)w_q_q15 * (int64_t)w_taper_q15 + (1 << 14)) >> 15);
+        w_p_q15 = pq128_q15_mul(w_p_q15, (int32_t)taper_row_q15[rx]);
+        w_q_q15 = pq128_q15_mul(w_q_q15, (int32_t)taper_row_q15[rx]);
 #endif
-
 #if PQ128_USE_FOCUS_SOFTMASK
-            {
-                int focus = (int)pq128_get_y_or_zero(focus_line, x);
-                int32_t w_f_q15 = pq128_focus_weight_q15(focus);
-                w_p_q15 = (int32_t)(((int64_t)w_p_q15 * (int64_t)w_f_q15 + (1 << 14)) >> 15);
-                w_q_q15 = (int32_t)(((int64_t)w_q_q15 * (int64_t)w_f_q15 + (1 << 14)) >> 15);
-            }
+        {
+            const int32_t w_f_q15 = (int32_t)s_pq128_tab.w_focus_q15[focus_s[rx]];
+            w_p_q15 = pq128_q15_mul(w_p_q15, w_f_q15);
+            w_q_q15 = pq128_q15_mul(w_q_q15, w_f_q15);
+        }
 #endif
 
-            if (w_p_q15 == 0)
-            {
-                p_row[rx] = 0;
-            }
-            else
-            {
 #if (PQ128_PQ_MODE == 3)
-                int raw_c = (int)pq128_get_y_or_zero(y_curr, x);
-#if (PQ128_USE_INTENSITY_KNEE || PQ128_USE_INTENSITY_GAMMA)
-                int i_c = (int)s_intensity_u8[(uint8_t)raw_c];
+        const int i_c = (int)PQ128_LINE_INTEN(lc)[rx + 1];
+        const int32_t vp = (int32_t)s_pq128_tab.light_p[i_c];
+        const int32_t vq = (int32_t)s_pq128_tab.light_q[i_c];
 #else
-                int i_c = raw_c;
+        const int32_t vp = pq128_fast_grad((int)PQ128_LINE_INTEN(lc)[rx], (int)PQ128_LINE_INTEN(lc)[rx + 2]);
+        const int32_t vq = pq128_fast_grad((int)PQ128_LINE_INTEN(lp)[rx + 1], (int)PQ128_LINE_INTEN(ln)[rx + 1]);
 #endif
-                int32_t v = (int32_t)pq128_lightmodel_pq_i16(i_c, rp_q15);
-#else
-                int num = i_xp1 - i_xm1;
-                int den = i_xp1 + i_xm1 + PQ128_NORM_EPS;
-                if (den < 0)
-                {
-                    den = 0;
-                }
-                if (den > (int)PQ128_DEN_MAX)
-                {
-                    den = (int)PQ128_DEN_MAX;
-                }
+        p_row[rx] = pq128_fast_finish(vp, w_p_q15, PQ128_SAMPLE_STRIDE_X, PQ128_FLIP_P);
+        q_row[rx] = pq128_fast_finish(vq, w_q_q15, PQ128_SAMPLE_STRIDE_Y, PQ128_FLIP_Q);
+    }
+}
 
-                int32_t v;
+#if PQ128_FAST_USE_MVE
+static inline uint32x4_t pq128_q15_mul_u32x4(uint32x4_t w, uint32x4_t w2_q15)
+{
+    return vshrq_n_u32(vaddq_n_u32(vmulq_u32(w, w2_q15), 1U << 14), 15);
+}
+
+#if (PQ128_PQ_MODE != 3)
+static inline int32x4_t pq128_grad_s32x4(uint32x4_t i0, uint32x4_t i1)
+{
+    const int32x4_t a = vreinterpretq_s32_u32(i0);
+    const int32x4_t b = vreinterpretq_s32_u32(i1);
+    const int32x4_t num = vsubq_s32(b, a);
+    int32x4_t den = vaddq_n_s32(vaddq_s32(a, b), PQ128_NORM_EPS);
+    den = vminq_s32(vmaxq_s32(den, vdupq_n_s32(0)), vdupq_n_s32((int32_t)PQ128_DEN_MAX));
 #if (PQ128_PQ_MODE == 1)
-                (void)den;
-                v = (int32_t)((int32_t)num * (int32_t)PQ128_DIFF_SCALE);
+    (void)den;
+    return vmulq_n_s32(num, (int32_t)PQ128_DIFF_SCALE);
 #elif (PQ128_PQ_MODE == 2)
-                if (den <= 0)
-                {
-                    v = 0;
-                }
-                else
-                {
-                    int sh = pq128_floor_log2_u32((uint32_t)den);
-                    v = (int32_t)(((int64_t)num * (int64_t)PQ128_NORM_SCALE) >> sh);
-                }
+    /* v = (num*scale) >> floor(log2(den)); den==0 -> 0 */
+    const int32x4_t sh = vsubq_s32(vdupq_n_s32(31), vclzq_s32(den));
+    int32x4_t v = vshlq_s32(vmulq_n_s32(num, (int32_t)PQ128_NORM_SCALE), vnegq_s32(sh));
+    return vdupq_m_n_s32(v, 0, vcmpeqq_n_s32(den, 0));
 #else
-#if PQ128_USE_RECIP_LUT
-                uint32_t recip = s_recip_q15[den];
-                v = (int32_t)(((int64_t)num * (int64_t)recip + (1 << 14)) >> 15);
-#else
-                v = (int32_t)((num * PQ128_NORM_SCALE) / den);
-#endif
+    /* Exact truncating divide: q = (n*R)>>19 == vmulh(n, R<<13), then correct the possible +1. */
+    const uint32x4_t uden = vreinterpretq_u32_s32(den);
+    const uint32x4_t n = vmulq_n_u32(vreinterpretq_u32_s32(vabsq_s32(num)), (uint32_t)PQ128_NORM_SCALE);
+    const uint32x4_t r = vldrhq_gather_shifted_offset_u32(s_pq128_tab.recip_u16, uden);
+    uint32x4_t q = vmulhq_u32(n, vshlq_n_u32(r, 32 - PQ128_RECIP_SHIFT));
+    q = vsubq_m_n_u32(q, q, 1U, vcmphiq_u32(vmulq_u32(q, uden), n));
+    const int32x4_t qs = vreinterpretq_s32_u32(q);
+    return vpselq_s32(vnegq_s32(qs), qs, vcmpltq_n_s32(num, 0));
 #endif
+}
 #endif
 
+static inline int32x4_t pq128_finish_s32x4(int32x4_t v, uint32x4_t w_q15, int stride_shift, int flip)
+{
 #if PQ128_APPLY_STRIDE_COMPENSATION
-                if (PQ128_SAMPLE_STRIDE_X > 1)
-                {
-                    v /= PQ128_SAMPLE_STRIDE_X;
-                }
+    /* C-style truncating divide by 2^shift. */
+    if (stride_shift == 1)
+    {
+        v = vshrq_n_s32(vaddq_s32(v, vandq_s32(vshrq_n_s32(v, 31), vdupq_n_s32(1))), 1);
+    }
+    else if (stride_shift == 2)
+    {
+        v = vshrq_n_s32(vaddq_s32(v, vandq_s32(vshrq_n_s32(v, 31), vdupq_n_s32(3))), 2);
+    }
+#else
+    (void)stride_shift;
 #endif
+    if (flip)
+    {
+        v = vnegq_s32(v);
+    }
+    v = vshrq_n_s32(vaddq_n_s32(vmulq_s32(v, vreinterpretq_s32_u32(w_q15)), 1 << 14), 15);
+    return vminq_s32(vmaxq_s32(v, vdupq_n_s32(-32768)), vdupq_n_s32(32767));
+}
 
-#if PQ128_FLIP_P
-                v = -v;
-#endif
+static void pq128_fast_pq_row_mve(const pq128_line_t *lp,
+                                  const pq128_line_t *lc,
+                                  const pq128_line_t *ln,
+                                  const uint8_t *focus_s,
+                                  const uint16_t *taper_row_q15,
+                                  int16_t *p_row,
+                                  int16_t *q_row)
+{
+    (void)focus_s;
+    (void)taper_row_q15;
 
-                /* Apply saturation attenuation weight. */
-                v = (int32_t)(((int64_t)v * (int64_t)w_p_q15 + (1 << 14)) >> 15);
-                p_row[rx] = (int16_t)clamp_i32((int)v, -32768, 32767);
-            }
+    for (int rx = 0; rx < PQ128_SIZE; rx += 4)
+    {
+        const uint32x4_t raw_xm1 = vldrbq_u32(&lc->raw[rx]);
+        const uint32x4_t raw_xp1 = vldrbq_u32(&lc->raw[rx + 2]);
+        const uint32x4_t raw_ym1 = vldrbq_u32(&lp->raw[rx + 1]);
+        const uint32x4_t raw_yp1 = vldrbq_u32(&ln->raw[rx + 1]);
+
+        uint32x4_t w_p = vldrhq_gather_shifted_offset_u32(s_pq128_tab.w_sat_q15, vmaxq_u32(raw_xm1, raw_xp1));
+        uint32x4_t w_q = vldrhq_gather_shifted_offset_u32(s_pq128_tab.w_sat_q15, vmaxq_u32(raw_ym1, raw_yp1));
+#if PQ128_USE_DARK_SOFTMASK
+        w_p = pq128_q15_mul_u32x4(w_p, vldrhq_gather_shifted_offset_u32(s_pq128_tab.w_dark_q15,
+                                                                        vshrq_n_u32(vaddq_u32(raw_xm1, raw_xp1), 1)));
+        w_q = pq128_q15_mul_u32x4(w_q, vldrhq_gather_shifted_offset_u32(s_pq128_tab.w_dark_q15,
+                                                                        vshrq_n_u32(vaddq_u32(raw_ym1, raw_yp1), 1)));
+#endif
+#if PQ128_USE_CHROMA_EDGEMASK
+        {
+            const uint32x4_t dc_p = vabdq_u32(vldrbq_u32(&lc->chroma[rx + 2]), vldrbq_u32(&lc->chroma[rx]));
+            const uint32x4_t dc_q = vabdq_u32(vldrbq_u32(&ln->chroma[rx + 1]), vldrbq_u32(&lp->chroma[rx + 1]));
+            w_p = pq128_q15_mul_u32x4(w_p, vldrhq_gather_shifted_offset_u32(s_pq128_tab.w_chroma_q15, dc_p));
+            w_q = pq128_q15_mul_u32x4(w_q, vldrhq_gather_shifted_offset_u32(s_pq128_tab.w_chroma_q15, dc_q));
+        }
+#endif
+#if PQ128_USE_TAPER && (PQ128_TAPER_WIDTH > 0)
+        {
+            const uint32x4_t w_t = vldrhq_u32(&taper_row_q15[rx]);
+            w_p = pq128_q15_mul_u32x4(w_p, w_t);
+            w_q = pq128_q15_mul_u32x4(w_q, w_t);
+        }
+#endif
+#if PQ128_USE_FOCUS_SOFTMASK
+        {
+            const uint32x4_t w_f = vldrhq_gather_shifted_offset_u32(s_pq128_tab.w_focus_q15, vldrbq_u32(&focus_s[rx]));
+            w_p = pq128_q15_mul_u32x4(w_p, w_f);
+            w_q = pq128_q15_mul_u32x4(w_q, w_f);
+        }
+#endif
 
-            if (w_q_q15 == 0)
-            {
-                q_row[rx] = 0;
-            }
-            else
-            {
 #if (PQ128_PQ_MODE == 3)
-                int raw_c = (int)pq128_get_y_or_zero(y_curr, x);
-#if PQ128_USE_INTENSITY_KNEE
-                int i_c = (int)s_knee_u8[(uint8_t)raw_c];
+        const uint32x4_t i_c = vldrbq_u32(&PQ128_LINE_INTEN(lc)[rx + 1]);
+        const int32x4_t vp = vldrhq_gather_shifted_offset_s32(s_pq128_tab.light_p, i_c);
+        const int32x4_t vq = vldrhq_gather_shifted_offset_s32(s_pq128_tab.light_q, i_c);
 #else
-                int i_c = raw_c;
+        const int32x4_t vp = pq128_grad_s32x4(vldrbq_u32(&PQ128_LINE_INTEN(lc)[rx]),
+                                              vldrbq_u32(&PQ128_LINE_INTEN(lc)[rx + 2]));
+        const int32x4_t vq = pq128_grad_s32x4(vldrbq_u32(&PQ128_LINE_INTEN(lp)[rx + 1]),
+                                              vldrbq_u32(&PQ128_LINE_INTEN(ln)[rx + 1]));
 #endif
-                int32_t v = (int32_t)pq128_lightmodel_pq_i16(i_c, rq_q15);
-#else
-                int num = i_yp1 - i_ym1;
-                int den = i_yp1 + i_ym1 + PQ128_NORM_EPS;
-                if (den < 0)
-                {
-                    den = 0;
-                }
-                if (den > (int)PQ128_DEN_MAX)
-                {
-                    den = (int)PQ128_DEN_MAX;
-                }
+        vstrhq_s32(&p_row[rx], pq128_finish_s32x4(vp, w_p, PQ128_STRIDE_X_SHIFT, PQ128_FLIP_P));
+        vstrhq_s32(&q_row[rx], pq128_finish_s32x4(vq, w_q, PQ128_STRIDE_Y_SHIFT, PQ128_FLIP_Q));
+    }
+}
+#endif /* PQ128_FAST_USE_MVE */
 
-                int32_t v;
-#if (PQ128_PQ_MODE == 1)
-                (void)den;
-                v = (int32_t)((int32_t)num * (int32_t)PQ128_DIFF_SCALE);
-#elif (PQ128_PQ_MODE == 2)
-                if (den <= 0)
-                {
-                    v = 0;
-                }
-                else
-                {
-                    int sh = pq128_floor_log2_u32((uint32_t)den);
-                    v = (int32_t)(((int64_t)num * (int64_t)PQ128_NORM_SCALE) >> sh);
-                }
+#if PQ128_USE_FOCUS_SOFTMASK && PQ128_STORE_SATMASK_PLANE
+/* 255 where the 5-tap neighbourhood is neither saturated nor dark, else 0. */
+static void pq128_fast_satmask_row(const pq128_line_t *lp,
+                                   const pq128_line_t *lc,
+                                   const pq128_line_t *ln,
+                                   uint8_t *satmask_row)
+{
+    int rx = 0;
+#if USE_HELIUM_MVE
+    for (; (rx + 16) <= PQ128_SIZE; rx += 16)
+    {
+        const uint8x16_t c = vld1q_u8(&lc->raw[rx + 1]);
+        const uint8x16_t xm = vld1q_u8(&lc->raw[rx]);
+        const uint8x16_t xp = vld1q_u8(&lc->raw[rx + 2]);
+        const uint8x16_t ym = vld1q_u8(&lp->raw[rx + 1]);
+        const uint8x16_t yp = vld1q_u8(&ln->raw[rx + 1]);
+        const uint8x16_t mx = vmaxq_u8(vmaxq_u8(vmaxq_u8(c, xm), vmaxq_u8(xp, ym)), yp);
+        const uint8x16_t mn = vminq_u8(vminq_u8(vminq_u8(c, xm), vminq_u8(xp, ym)), yp);
+        const mve_pred16_t ok = (mve_pred16_t)(vcmphiq_n_u8(mn, (uint8_t)PQ128_SATMASK_LO_TH) &
+                                               (mve_pred16_t)~vcmpcsq_n_u8(mx, (uint8_t)PQ128_SATMASK_HI_TH));
+        vst1q_u8(&satmask_row[rx], vpselq_u8(vdupq_n_u8(255), vdupq_n_u8(0), ok));
+    }
+#endif
+    for (; rx < PQ128_SIZE; rx++)
+    {
+        const int v[5] = {lc->raw[rx + 1], lc->raw[rx], lc->raw[rx + 2], lp->raw[rx + 1], ln->raw[rx + 1]};
+        bool sat = false;
+        bool dark = false;
+        for (int k = 0; k < 5; k++)
+        {
+            sat = sat || (v[k] >= (int)PQ128_SATMASK_HI_TH);
+            dark = dark || (v[k] <= (int)PQ128_SATMASK_LO_TH);
+        }
+        satmask_row[rx] = (uint8_t)((!sat && !dark) ? 255 : 0);
+    }
+}
+#endif
+
+/* Fast kernel body for an arbitrary ROI origin (source pixels); writes the PQ128 planes only. */
+static void pq128_compute_tile_fast(uint32_t frame_base_offset, int src_x0, int src_y0)
+{
+    static pq128_line_t s_ring[3];
+    uint8_t yuv_tmp[FRAME_WIDTH_MAX * 2];
+    int16_t p_row[PQ128_SIZE];
+    int16_t q_row[PQ128_SIZE];
+#if PQ128_USE_FOCUS_SOFTMASK
+    uint8_t edge_orig[FRAME_WIDTH_MAX];
+    uint8_t edge_blur[FRAME_WIDTH_MAX];
+    uint8_t focus_row[PQ128_SIZE];
+#if PQ128_STORE_EDGE_PLANE
+    uint8_t edge_row[PQ128_SIZE];
+#endif
+#if PQ128_STORE_EDGE_BLUR_PLANE
+    uint8_t edge_blur_row[PQ128_SIZE];
+#endif
+#if PQ128_STORE_SATMASK_PLANE
+    uint8_t satmask_row[PQ128_SIZE];
+#endif
+    const uint8_t *focus_s = focus_row;
 #else
-#if PQ128_USE_RECIP_LUT
-                uint32_t recip = s_recip_q15[den];
-                v = (int32_t)(((int64_t)num * (int64_t)recip + (1 << 14)) >> 15);
+    const uint8_t *focus_s = NULL;
+#endif
+#if PQ128_USE_TAPER && (PQ128_TAPER_WIDTH > 0)
+    uint16_t taper_row_q15[PQ128_SIZE];
 #else
-                v = (int32_t)((num * PQ128_NORM_SCALE) / den);
+    const uint16_t *taper_row_q15 = NULL;
+#endif
+
+    pq128_fast_init_tables_once();
+
+#if (PQ128_PQ_MODE == 3)
+    {
+        int32_t rp_q15 = 0;
+        int32_t rq_q15 = 0;
+        pq128_lightmodel_ratios_q15(&rp_q15, &rq_q15);
+        for (int i = 0; i < 256; i++)
+        {
+            s_pq128_tab.light_p[i] = pq128_lightmodel_pq_i16(i, rp_q15);
+            s_pq128_tab.light_q[i] = pq128_lightmodel_pq_i16(i, rq_q15);
+        }
+    }
+#endif
+
+    const uint32_t prof_tile_t0 = prof_now();
+    pq128_line_t *lp = &s_ring[0];
+    pq128_line_t *lc = &s_ring[1];
+    pq128_line_t *ln = &s_ring[2];
+    pq128_fast_load_line(frame_base_offset, src_x0, src_y0 - PQ128_SAMPLE_STRIDE_Y, yuv_tmp, lp);
+    pq128_fast_load_line(frame_base_offset, src_x0, src_y0, yuv_tmp, lc);
+    pq128_fast_load_line(frame_base_offset, src_x0, src_y0 + PQ128_SAMPLE_STRIDE_Y, yuv_tmp, ln);
+
+    for (int ry = 0; ry < PQ128_SIZE; ry++)
+    {
+        const uint32_t prof_row_t0 = prof_now();
+#if PQ128_USE_FOCUS_SOFTMASK
+        /* Focus cue: edge(original) - edge(blurred); blur was done once per line at load. */
+        apply_sobel_filter(lp->y, lc->y, ln->y, edge_orig);
+        apply_sobel_filter(lp->y_blur, lc->y_blur, ln->y_blur, edge_blur);
+        for (int rx = 0; rx < PQ128_SIZE; rx++)
+        {
+            const int x = src_x0 + rx * PQ128_SAMPLE_STRIDE_X;
+            const int eo = (int)pq128_get_y_or_zero(edge_orig, x);
+            const int eb = (int)pq128_get_y_or_zero(edge_blur, x);
+            focus_row[rx] = (uint8_t)((eo > eb) ? (eo - eb) : 0);
+#if PQ128_STORE_EDGE_PLANE
+            edge_row[rx] = (uint8_t)eo;
+#endif
+#if PQ128_STORE_EDGE_BLUR_PLANE
+            edge_blur_row[rx] = (uint8_t)eb;
 #endif
+        }
+#if PQ128_STORE_SATMASK_PLANE
+        pq128_fast_satmask_row(lp, lc, ln, satmask_row);
 #endif
 #endif
 
-#if PQ128_APPLY_STRIDE_COMPENSATION
-                if (PQ128_SAMPLE_STRIDE_Y > 1)
-                {
-                    v /= PQ128_SAMPLE_STRIDE_Y;
-                }
+#if PQ128_USE_TAPER && (PQ128_TAPER_WIDTH > 0)
+        {
+            const int32_t wy_q15 = (int32_t)s_pq128_tab.taper_q15[ry];
+            for (int rx = 0; rx < PQ128_SIZE; rx++)
+            {
+                taper_row_q15[rx] = (uint16_t)pq128_q15_mul((int32_t)s_pq128_tab.taper_q15[rx], wy_q15);
+            }
+        }
 #endif
 
-#if PQ128_FLIP_Q
-                v = -v;
+#if PQ128_FAST_USE_MVE
+        pq128_fast_pq_row_mve(lp, lc, ln, focus_s, taper_row_q15, p_row, q_row);
+#else
+        pq128_fast_pq_row_scalar(lp, lc, ln, focus_s, taper_row_q15, 0, p_row, q_row);
 #endif
 
-                /* Apply saturation attenuation weight. */
-                v = (int32_t)(((int64_t)v * (int64_t)w_q_q15 + (1 << 14)) >> 15);
-                q_row[rx] = (int16_t)clamp_i32((int)v, -32768, 32767);
+#if (PQ128_BORDER_ZERO_N > 0)
+        {
+            const bool row_border = (ry < PQ128_BORDER_ZERO_N) || (ry >= (PQ128_SIZE - PQ128_BORDER_ZERO_N));
+            for (int rx = 0; rx < PQ128_SIZE; rx++)
+            {
+                if (row_border || (rx < PQ128_BORDER_ZERO_N) || (rx >= (PQ128_SIZE - PQ128_BORDER_ZERO_N)))
+                {
+                    p_row[rx] = 0;
+                    q_row[rx] = 0;
+#if PQ128_USE_FOCUS_SOFTMASK && PQ128_STORE_FOCUS_PLANE
+                    focus_row[rx] = 0;
+#endif
+#if PQ128_USE_FOCUS_SOFTMASK && PQ128_STORE_EDGE_PLANE
+                    edge_row[rx] = 0;
+#endif
+#if PQ128_USE_FOCUS_SOFTMASK && PQ128_STORE_EDGE_BLUR_PLANE
+                    edge_blur_row[rx] = 0;
+#endif
+#if PQ128_USE_FOCUS_SOFTMASK && PQ128_STORE_SATMASK_PLANE
+                    satmask_row[rx] = 0;
+#endif
+                }
             }
         }
+#endif
 
         uint32_t row_off = (uint32_t)ry * (uint32_t)PQ128_SIZE * (uint32_t)sizeof(int16_t);
-        (void)hyperram_b_write(p_row, (void *)(frame_base_offset + PQ128_P_OFFSET + row_off), (uint32_t)PQ128_SIZE * (uint32_t)sizeof(int16_t));
-        (void)hyperram_b_write(q_row, (void *)(frame_base_offset + PQ128_Q_OFFSET + row_off), (uint32_t)PQ128_SIZE * (uint32_t)sizeof(int16_t));
-
+        (void)hyperram_b_write(p_row, (void *)(frame_base_offset + PQ128_P_OFFSET + row_off), (uint32_t)sizeof(p_row));
+        (void)hyperram_b_write(q_row, (void *)(frame_base_offset + PQ128_Q_OFFSET + row_off), (uint32_t)sizeof(q_row));
 #if PQ128_USE_FOCUS_SOFTMASK && PQ128_STORE_FOCUS_PLANE
         (void)hyperram_b_write(focus_row,
                                (void *)(frame_base_offset + PQ128_FOCUS_OFFSET + (uint32_t)ry * (uint32_t)PQ128_SIZE),
                                (uint32_t)PQ128_SIZE);
 #endif
-
 #if PQ128_USE_FOCUS_SOFTMASK && PQ128_STORE_EDGE_PLANE
         (void)hyperram_b_write(edge_row,
                                (void *)(frame_base_offset + PQ128_EDGE_OFFSET + (uint32_t)ry * (uint32_t)PQ128_SIZE),
                                (uint32_t)PQ128_SIZE);
 #endif
-
 #if PQ128_USE_FOCUS_SOFTMASK && PQ128_STORE_EDGE_BLUR_PLANE
         (void)hyperram_b_write(edge_blur_row,
                                (void *)(frame_base_offset + PQ128_EDGE_BLUR_OFFSET + (uint32_t)ry * (uint32_t)PQ128_SIZE),
                                (uint32_t)PQ128_SIZE);
 #endif
-
 #if PQ128_USE_FOCUS_SOFTMASK && PQ128_STORE_SATMASK_PLANE
         (void)hyperram_b_write(satmask_row,
                                (void *)(frame_base_offset + PQ128_SATMASK_OFFSET + (uint32_t)ry * (uint32_t)PQ128_SIZE),
                                (uint32_t)PQ128_SIZE);
 #endif
 
-#if (PQ128_SAMPLE_STRIDE_Y == 1)
-        /* Slide window: prev <- curr, curr <- next, next <- load(row+2). */
-        memcpy(y_prev, y_curr, FRAME_WIDTH);
-        memcpy(y_curr, y_next, FRAME_WIDTH);
-#if PQ128_USE_CHROMA_EDGEMASK
-        memcpy(c_prev, c_curr, FRAME_WIDTH);
-        memcpy(c_curr, c_next, FRAME_WIDTH);
-        load_yc_line_from_hyperram_or_zero(frame_base_offset, PQ128_Y0 + ry + 2, yuv_tmp, y_next, c_next);
+        /* Rotate ring: prev <- curr, curr <- next, next <- load(row of ry+2). */
+        if ((ry + 1) < PQ128_SIZE)
+        {
+            pq128_line_t *tmp = lp;
+            lp = lc;
+            lc = ln;
+            ln = tmp;
+            pq128_fast_load_line(frame_base_offset, src_x0, src_y0 + (ry + 2) * PQ128_SAMPLE_STRIDE_Y, yuv_tmp, ln);
+        }
+        prof_span_end(PROF_SPAN_PQ128_ROW, prof_row_t0);
+    }
+    prof_span_end(PROF_SPAN_PQ128_TILE, prof_tile_t0);
+}
+
+static FC128_UNUSED void pq128_compute_and_store_fast(uint32_t frame_base_offset, uint32_t frame_seq)
+{
+    g_pq128_seq = 0;
+
+    pq128_compute_tile_fast(frame_base_offset, PQ128_X0, PQ128_Y0);
+
+    __DMB();
+    g_pq128_base_offset = frame_base_offset;
+    __DMB();
+    g_pq128_seq = frame_seq;
+    latency_trace_stamp(frame_seq, LATENCY_STAGE_PQ_DONE);
+}
+
+#if PQ128_STREAM_CAPTURE
+/*
+ * 帯ストリーミング版：取り込み中(または直前)のフレームに合流し，帯が着地するたびに
+ * PQ128 の3行窓を進める．p/q を公開できたら true と対象フレームを返す．
+ */
+static bool pq128_compute_and_store_stream(cam_band_frame_t *out_frame)
+{
+    static uint32_t s_last_gen = 0U;
+    cam_band_frame_t fr;
+
+    while (!cam_band_frame_get(&fr) || (fr.gen == s_last_gen))
+    {
+        (void)ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(PQ128_STREAM_TIMEOUT_MS));
+    }
+    s_last_gen = fr.gen;
+
+    g_pq128_seq = 0;
+
+    /* 行の長さ/行数は取り込み開始時のモードに従う(SRAM バッファは常に UYVY) */
+    s_frame = fr.desc;
+    s_pq128_stream.sram = fr.p_buffer;
+    s_pq128_stream.gen = fr.gen;
+    s_pq128_stream.aborted = false;
+    pq128_compute_tile_fast(fr.hyperram_base, PQ128_X0, PQ128_Y0);
+    s_pq128_stream.sram = NULL;
+
+    /* 計算中に SRAM バッファが次の取り込みで再利用されていたら破棄 */
+    if (s_pq128_stream.aborted || (cam_band_lines_ready(fr.gen) < 0))
+    {
+        return false;
+    }
+
+    __DMB();
+    g_pq128_base_offset = fr.hyperram_base;
+    __DMB();
+    g_pq128_seq = fr.frame_seq;
+    latency_trace_stamp(fr.frame_seq, LATENCY_STAGE_PQ_DONE);
+
+    *out_frame = fr;
+    return true;
+}
+#endif
+
+#if PQ128_BENCH_ENABLE
+/* Per-row checksums of the p/q planes (read back from HyperRAM, outside the timed region). */
+static void pq128_bench_row_sums(uint32_t frame_base_offset, uint32_t sums[PQ128_SIZE])
+{
+    int16_t p_row[PQ128_SIZE];
+    int16_t q_row[PQ128_SIZE];
+    for (int ry = 0; ry < PQ128_SIZE; ry++)
+    {
+        uint32_t row_off = (uint32_t)ry * (uint32_t)PQ128_SIZE * (uint32_t)sizeof(int16_t);
+        (void)hyperram_b_read(p_row, (void *)(frame_base_offset + PQ128_P_OFFSET + row_off), (uint32_t)sizeof(p_row));
+        (void)hyperram_b_read(q_row, (void *)(frame_base_offset + PQ128_Q_OFFSET + row_off), (uint32_t)sizeof(q_row));
+        uint32_t h = 2166136261U; /* FNV-1a over the raw int16 values */
+        for (int rx = 0; rx < PQ128_SIZE; rx++)
+        {
+            h = (h ^ (uint16_t)p_row[rx]) * 16777619U;
+            h = (h ^ (uint16_t)q_row[rx]) * 16777619U;
+        }
+        sums[ry] = h;
+    }
+}
+#endif
+
+static FC128_UNUSED void pq128_compute_and_store(uint32_t frame_base_offset, uint32_t frame_seq)
+{
+#if PQ128_BENCH_ENABLE
+    if ((frame_seq % PQ128_BENCH_PERIOD) == 0U)
+    {
+        static uint32_t s_ref_sums[PQ128_SIZE];
+        static uint32_t s_fast_sums[PQ128_SIZE];
+
+        fc128_dwt_init_once();
+        uint32_t t0 = fc128_dwt_now();
+        pq128_compute_and_store_ref(frame_base_offset, frame_seq);
+        uint32_t t1 = fc128_dwt_now();
+        pq128_bench_row_sums(frame_base_offset, s_ref_sums);
+
+        uint32_t t2 = fc128_dwt_now();
+        pq128_compute_and_store_fast(frame_base_offset, frame_seq);
+        uint32_t t3 = fc128_dwt_now();
+        pq128_bench_row_sums(frame_base_offset, s_fast_sums);
+
+        uint32_t mismatch_rows = 0U;
+        for (int ry = 0; ry < PQ128_SIZE; ry++)
+        {
+            mismatch_rows += (s_ref_sums[ry] != s_fast_sums[ry]) ? 1U : 0U;
+        }
+
+        const uint32_t ref_cyc = t1 - t0;
+        const uint32_t fast_cyc = t3 - t2;
+        const uint32_t speedup_x100 = (fast_cyc != 0U) ? (uint32_t)(((uint64_t)ref_cyc * 100ULL) / fast_cyc) : 0U;
+        xprintf("[PQ128 bench] mode=%d mve=%d ref=%lu us fast=%lu us speedup=%lu.%02lux mismatch_rows=%lu/%d\n",
+                (int)PQ128_PQ_MODE, (int)PQ128_FAST_USE_MVE,
+                (unsigned long)fc128_cyc_to_us(ref_cyc), (unsigned long)fc128_cyc_to_us(fast_cyc),
+                (unsigned long)(speedup_x100 / 100U), (unsigned long)(speedup_x100 % 100U),
+                (unsigned long)mismatch_rows, (int)PQ128_SIZE);
+        return;
+    }
+#endif
+
+#if PQ128_FAST_KERNEL
+    pq128_compute_and_store_fast(frame_base_offset, frame_seq);
 #else
-        load_y_line_from_hyperram_or_zero(frame_base_offset, PQ128_Y0 + ry + 2, yuv_tmp, y_next);
+    pq128_compute_and_store_ref(frame_base_offset, frame_seq);
+#endif
+}
+
+#if FC128_TILED_ENABLE
+/* Evenly spread tile origins along one axis of length grid (tile size FC_RESULT_N). Returns tile count. */
+static int fc128_tile_origins(int grid, int origins[FC128_TILE_MAX_PER_AXIS])
+{
+    const int n_tile = FC_RESULT_N;
+    if (grid <= n_tile)
+    {
+        /* Single centered tile; out-of-grid samples are zero-padded by the PQ128 loader. */
+        origins[0] = (grid - n_tile) / 2;
+        return 1;
+    }
+
+    const int step = n_tile - FC128_TILE_OVERLAP;
+    int count = 1 + ((grid - n_tile) + step - 1) / step;
+    if (count > FC128_TILE_MAX_PER_AXIS)
+    {
+        count = FC128_TILE_MAX_PER_AXIS;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        origins[i] = (i * (grid - n_tile)) / (count - 1);
+    }
+    return count;
+}
+
+/* Overlap-add window along one axis: 1 inside, linear ramp over the overlap with each neighbour. */
+static void fc128_tile_axis_weights(const int origins[FC128_TILE_MAX_PER_AXIS], int count, int i, float w[FC_RESULT_N])
+{
+    const int n_tile = FC_RESULT_N;
+    const int ov_lo = (i > 0) ? (origins[i - 1] + n_tile - origins[i]) : 0;
+    const int ov_hi = (i < (count - 1)) ? (origins[i] + n_tile - origins[i + 1]) : 0;
+
+    for (int k = 0; k < n_tile; k++)
+    {
+        float v = 1.0f;
+        if ((ov_lo > 0) && (k < ov_lo))
+        {
+            float r = ((float)k + 0.5f) / (float)ov_lo;
+            v = (r < v) ? r : v;
+        }
+        if ((ov_hi > 0) && (k >= (n_tile - ov_hi)))
+        {
+            float r = ((float)(n_tile - k) - 0.5f) / (float)ov_hi;
+            v = (r < v) ? r : v;
+        }
+        w[k] = v;
+    }
+}
+
+/* Blend one solved tile (FC128_Z_REAL crop) into the grid accumulators at sample origin (ox, oy). */
+static void fc128_tile_blend(uint32_t frame_base_offset,
+                             int ox,
+                             int oy,
+                             const float wx[FC_RESULT_N],
+                             const float wy[FC_RESULT_N])
+{
+    float z_row[FC_RESULT_N];
+    float acc_row[FC_RESULT_N];
+    float wsum_row[FC_RESULT_N];
+
+    /* Clip the tile to the grid. */
+    const int tx0 = (ox < 0) ? -ox : 0;
+    const int tx1 = ((ox + FC_RESULT_N) > FC128_TILE_GRID_W) ? (FC128_TILE_GRID_W - ox) : FC_RESULT_N;
+    const int ty0 = (oy < 0) ? -oy : 0;
+    const int ty1 = ((oy + FC_RESULT_N) > FC128_TILE_GRID_H) ? (FC128_TILE_GRID_H - oy) : FC_RESULT_N;
+    if ((tx1 <= tx0) || (ty1 <= ty0))
+    {
+        return;
+    }
+    const int span = tx1 - tx0;
+    const uint32_t span_bytes = (uint32_t)span * (uint32_t)sizeof(float);
+
+    /* FC output has an arbitrary DC; match it to what is already blended in the overlap. */
+    double diff_sum = 0.0;
+    uint32_t diff_n = 0U;
+    for (int ty = ty0; ty < ty1; ty++)
+    {
+        const uint32_t z_off = (uint32_t)((ty + FC_PAD_Y0) * FC_FFT_N + FC_PAD_X0 + tx0) * (uint32_t)sizeof(float);
+        const uint32_t g_off = (uint32_t)((oy + ty) * FC128_TILE_GRID_W + ox + tx0) * (uint32_t)sizeof(float);
+        (void)hyperram_b_read(wsum_row, (void *)(frame_base_offset + FC128_TILE_WSUM_OFFSET + g_off), span_bytes);
+
+        bool any = false;
+        for (int i = 0; i < span; i++)
+        {
+            any = any || (wsum_row[i] > 0.0f);
+        }
+        if (!any)
+        {
+            continue;
+        }
+
+        (void)hyperram_b_read(z_row, (void *)(frame_base_offset + FC128_Z_REAL + z_off), span_bytes);
+        (void)hyperram_b_read(acc_row, (void *)(frame_base_offset + FC128_TILE_ACC_OFFSET + g_off), span_bytes);
+        for (int i = 0; i < span; i++)
+        {
+            if (wsum_row[i] > 0.0f)
+            {
+                diff_sum += (double)(acc_row[i] / wsum_row[i] - z_row[i]);
+                diff_n++;
+            }
+        }
+    }
+    const float dc = (diff_n != 0U) ? (float)(diff_sum / (double)diff_n) : 0.0f;
+
+    for (int ty = ty0; ty < ty1; ty++)
+    {
+        const uint32_t z_off = (uint32_t)((ty + FC_PAD_Y0) * FC_FFT_N + FC_PAD_X0 + tx0) * (uint32_t)sizeof(float);
+        const uint32_t g_off = (uint32_t)((oy + ty) * FC128_TILE_GRID_W + ox + tx0) * (uint32_t)sizeof(float);
+        (void)hyperram_b_read(z_row, (void *)(frame_base_offset + FC128_Z_REAL + z_off), span_bytes);
+        (void)hyperram_b_read(acc_row, (void *)(frame_base_offset + FC128_TILE_ACC_OFFSET + g_off), span_bytes);
+        (void)hyperram_b_read(wsum_row, (void *)(frame_base_offset + FC128_TILE_WSUM_OFFSET + g_off), span_bytes);
+
+        const float w_y = wy[ty];
+        for (int i = 0; i < span; i++)
+        {
+            const float w = wx[tx0 + i] * w_y;
+            acc_row[i] += w * (z_row[i] + dc);
+            wsum_row[i] += w;
+        }
+
+        (void)hyperram_b_write(acc_row, (void *)(frame_base_offset + FC128_TILE_ACC_OFFSET + g_off), span_bytes);
+        (void)hyperram_b_write(wsum_row, (void *)(frame_base_offset + FC128_TILE_WSUM_OFFSET + g_off), span_bytes);
+    }
+}
+
+/* acc/wsum (grid) -> 320x240 float Z (nearest upsample by the PQ128 stride). */
+static void fc128_tile_normalize_to_frame(uint32_t frame_base_offset)
+{
+    float acc_row[FC128_TILE_GRID_W_MAX];
+    float wsum_row[FC128_TILE_GRID_W_MAX];
+    float z_grid[FC128_TILE_GRID_W_MAX];
+    float z_frame[FRAME_WIDTH_MAX];
+    const uint32_t grid_row_bytes = (uint32_t)FC128_TILE_GRID_W * (uint32_t)sizeof(float);
+    const uint32_t z_row_bytes = (uint32_t)FRAME_WIDTH * (uint32_t)sizeof(float);
+    int loaded_gy = -1;
+
+    for (int y = 0; y < FRAME_HEIGHT; y++)
+    {
+        int gy = y / PQ128_SAMPLE_STRIDE_Y;
+        if (gy >= FC128_TILE_GRID_H)
+        {
+            gy = FC128_TILE_GRID_H - 1;
+        }
+
+        if (gy != loaded_gy)
+        {
+            const uint32_t g_off = (uint32_t)gy * (uint32_t)FC128_TILE_GRID_W * (uint32_t)sizeof(float);
+            (void)hyperram_b_read(acc_row, (void *)(frame_base_offset + FC128_TILE_ACC_OFFSET + g_off), grid_row_bytes);
+            (void)hyperram_b_read(wsum_row, (void *)(frame_base_offset + FC128_TILE_WSUM_OFFSET + g_off), grid_row_bytes);
+            for (int gx = 0; gx < FC128_TILE_GRID_W; gx++)
+            {
+                z_grid[gx] = (wsum_row[gx] > 0.0f) ? (acc_row[gx] / wsum_row[gx]) : 0.0f;
+            }
+            for (int x = 0; x < FRAME_WIDTH; x++)
+            {
+                int gx = x / PQ128_SAMPLE_STRIDE_X;
+                if (gx >= FC128_TILE_GRID_W)
+                {
+                    gx = FC128_TILE_GRID_W - 1;
+                }
+                z_frame[x] = z_grid[gx];
+            }
+            loaded_gy = gy;
+        }
+
+        (void)hyperram_b_write(z_frame,
+                               (void *)(frame_base_offset + FC128_TILE_Z_OFFSET + (uint32_t)y * z_row_bytes),
+                               z_row_bytes);
+    }
+}
+
+static void fc128_compute_depth_tiled(uint32_t frame_base_offset, uint32_t frame_seq)
+{
+    fc128_dwt_init_once();
+
+    fc128_layout_check_once(frame_base_offset);
+    if ((frame_base_offset + (uint32_t)FC128_TOTAL_SCRATCH_END) > (uint32_t)HYPERRAM_SIZE)
+    {
+        return;
+    }
+
+    int org_x[FC128_TILE_MAX_PER_AXIS];
+    int org_y[FC128_TILE_MAX_PER_AXIS];
+    const int n_x = fc128_tile_origins(FC128_TILE_GRID_W, org_x);
+    const int n_y = fc128_tile_origins(FC128_TILE_GRID_H, org_y);
+
+    const uint32_t t_start = fc128_dwt_now();
+
+    /* Clear accumulators. */
+    {
+        float zero_row[FC128_TILE_GRID_W_MAX];
+        const uint32_t grid_row_bytes = (uint32_t)FC128_TILE_GRID_W * (uint32_t)sizeof(float);
+        memset(zero_row, 0, sizeof(zero_row));
+        for (int gy = 0; gy < FC128_TILE_GRID_H; gy++)
+        {
+            const uint32_t g_off = (uint32_t)gy * grid_row_bytes;
+            (void)hyperram_b_write(zero_row, (void *)(frame_base_offset + FC128_TILE_ACC_OFFSET + g_off), grid_row_bytes);
+            (void)hyperram_b_write(zero_row, (void *)(frame_base_offset + FC128_TILE_WSUM_OFFSET + g_off), grid_row_bytes);
+        }
+    }
+
+#if FC128_TIMING_ENABLE
+    const bool do_log = (FC128_TIMING_LOG_PERIOD != 0U) && ((frame_seq % (uint32_t)FC128_TIMING_LOG_PERIOD) == 0U);
 #endif
+
+    float wx[FC_RESULT_N];
+    float wy[FC_RESULT_N];
+    for (int ty = 0; ty < n_y; ty++)
+    {
+        fc128_tile_axis_weights(org_y, n_y, ty, wy);
+        for (int tx = 0; tx < n_x; tx++)
+        {
+            fc128_tile_axis_weights(org_x, n_x, tx, wx);
+
+            const uint32_t t0 = fc128_dwt_now();
+            pq128_compute_tile_fast(frame_base_offset,
+                                    org_x[tx] * PQ128_SAMPLE_STRIDE_X,
+                                    org_y[ty] * PQ128_SAMPLE_STRIDE_Y);
+            fc128_solve_stamps_t st;
+            if (!fc128_solve_z_from_pq(frame_base_offset, &st))
+            {
+                return;
+            }
+            fc128_tile_blend(frame_base_offset, org_x[tx], org_y[ty], wx, wy);
+            const uint32_t t1 = fc128_dwt_now();
+
+#if FC128_TIMING_ENABLE
+            if (do_log)
+            {
+                xprintf("[FC128 tile %d/%d] org=(%d,%d) us pq=%lu fc=%lu blend=%lu total=%lu\n",
+                        ty * n_x + tx + 1, n_x * n_y,
+                        org_x[tx], org_y[ty],
+                        (unsigned long)fc128_cyc_to_us(st.t_start - t0),
+                        (unsigned long)fc128_cyc_to_us(st.t_ifft - st.t_start),
+                        (unsigned long)fc128_cyc_to_us(t1 - st.t_ifft),
+                        (unsigned long)fc128_cyc_to_us(t1 - t0));
+            }
+#else
+            (void)t0;
+            (void)t1;
+            (void)st;
 #endif
+        }
+    }
+
+    const uint32_t t_tiles = fc128_dwt_now();
+
+    fc128_tile_normalize_to_frame(frame_base_offset);
+    fc128_export_depth_u8_plane(frame_base_offset, (uint32_t)FC128_TILE_Z_OFFSET, (uint32_t)FRAME_WIDTH, FRAME_WIDTH, FRAME_HEIGHT);
+
+    const uint32_t t_export = fc128_dwt_now();
+    prof_record(PROF_SPAN_FC_EXPORT, t_export - t_tiles);
+
+#if FC128_TIMING_ENABLE
+    if (do_log)
+    {
+        xprintf("[FC128 tiled] grid=%dx%d tiles=%dx%d us tiles=%lu export=%lu total=%lu\n",
+                (int)FC128_TILE_GRID_W, (int)FC128_TILE_GRID_H, n_x, n_y,
+                (unsigned long)fc128_cyc_to_us(t_tiles - t_start),
+                (unsigned long)fc128_cyc_to_us(t_export - t_tiles),
+                (unsigned long)fc128_cyc_to_us(t_export - t_start));
     }
+#else
+    (void)frame_seq;
+    (void)t_start;
+    (void)t_tiles;
+    (void)t_export;
+#endif
 
     __DMB();
-    g_pq128_base_offset = frame_base_offset;
+    g_depth_size_bytes = (uint32_t)DEPTH_BYTES;
     __DMB();
-    g_pq128_seq = frame_seq;
+    g_depth_base_offset = frame_base_offset;
+    __DMB();
+    g_depth_seq = frame_seq;
 }
+#endif /* FC128_TILED_ENABLE */
 
 #if USE_DEPTH_METHOD == 1
-#define MG_WORK_OFFSET (DEPTH_OFFSET + FRAME_WIDTH * FRAME_HEIGHT)
+#define MG_WORK_OFFSET (DEPTH_OFFSET + DEPTH_BYTES_MAX)
 #define MG_MAX_LEVELS 6
 
 typedef struct
@@ -3592,8 +5697,8 @@ static inline int clamp_frame_row(int row)
 }
 
 static FC128_UNUSED fsp_err_t load_y_line_from_hyperram(int requested_row,
-                                                        uint8_t yuv_line[FRAME_WIDTH * 2],
-                                                        uint8_t y_line[FRAME_WIDTH],
+                                                        uint8_t yuv_line[FRAME_WIDTH_MAX * 2],
+                                                        uint8_t y_line[FRAME_WIDTH_MAX],
                                                         int *loaded_row_out)
 {
     int row = clamp_frame_row(requested_row);
@@ -3619,10 +5724,10 @@ static FC128_UNUSED fsp_err_t load_y_line_from_hyperram(int requested_row,
     return FSP_SUCCESS;
 }
 
-static FC128_UNUSED void duplicate_line_buffer(uint8_t dst_yuv[FRAME_WIDTH * 2],
-                                               uint8_t dst_y[FRAME_WIDTH],
-                                               const uint8_t src_yuv[FRAME_WIDTH * 2],
-                                               const uint8_t src_y[FRAME_WIDTH])
+static FC128_UNUSED void duplicate_line_buffer(uint8_t dst_yuv[FRAME_WIDTH_MAX * 2],
+                                               uint8_t dst_y[FRAME_WIDTH_MAX],
+                                               const uint8_t src_yuv[FRAME_WIDTH_MAX * 2],
+                                               const uint8_t src_y[FRAME_WIDTH_MAX])
 {
     memcpy(dst_yuv, src_yuv, FRAME_WIDTH * 2);
     memcpy(dst_y, src_y, FRAME_WIDTH);
@@ -3635,10 +5740,10 @@ static FC128_UNUSED void duplicate_line_buffer(uint8_t dst_yuv[FRAME_WIDTH * 2],
 
 #if USE_HELIUM_MVE
 // Helium MVE版 - シンプルで安全な実装(スカラー計算 + ベクトル後処理)
-static FC128_UNUSED void apply_sobel_filter(uint8_t y_prev[FRAME_WIDTH],
-                                            uint8_t y_curr[FRAME_WIDTH],
-                                            uint8_t y_next[FRAME_WIDTH],
-                                            uint8_t edge_out[FRAME_WIDTH])
+static FC128_UNUSED void apply_sobel_filter(uint8_t y_prev[FRAME_WIDTH_MAX],
+                                            uint8_t y_curr[FRAME_WIDTH_MAX],
+                                            uint8_t y_next[FRAME_WIDTH_MAX],
+                                            uint8_t edge_out[FRAME_WIDTH_MAX])
 {
     // 境界ピクセルは中央ピクセルの値をそのまま使う
     edge_out[0] = y_curr[0];
@@ -3726,10 +5831,10 @@ static FC128_UNUSED void apply_sobel_filter(uint8_t y_prev[FRAME_WIDTH],
 
 #else
 // 標準版 - Helium MVEなし
-static FC128_UNUSED void apply_sobel_filter(uint8_t y_prev[FRAME_WIDTH],
-                                            uint8_t y_curr[FRAME_WIDTH],
-                                            uint8_t y_next[FRAME_WIDTH],
-                                            uint8_t edge_out[FRAME_WIDTH])
+static FC128_UNUSED void apply_sobel_filter(uint8_t y_prev[FRAME_WIDTH_MAX],
+                                            uint8_t y_curr[FRAME_WIDTH_MAX],
+                                            uint8_t y_next[FRAME_WIDTH_MAX],
+                                            uint8_t edge_out[FRAME_WIDTH_MAX])
 {
     const int sobel_x[9] = {-1, 0, 1, -2, 0, 2, -1, 0, 1};
     const int sobel_y[9] = {-1, -2, -1, 0, 0, 0, 1, 2, 1};
@@ -3780,8 +5885,8 @@ static FC128_UNUSED void apply_sobel_filter(uint8_t y_prev[FRAME_WIDTH],
  *
  * 簡易推定: I(x,y) ≈ (1 - p*Gx - q*Gy) として，ローカル勾配から推定
  */
-static FC128_UNUSED void compute_pq_gradients(uint8_t y_prev[FRAME_WIDTH], uint8_t y_curr[FRAME_WIDTH],
-                                              uint8_t y_next[FRAME_WIDTH], uint8_t pq_out[FRAME_WIDTH * 2])
+static FC128_UNUSED void compute_pq_gradients(uint8_t y_prev[FRAME_WIDTH_MAX], uint8_t y_curr[FRAME_WIDTH_MAX],
+                                              uint8_t y_next[FRAME_WIDTH_MAX], uint8_t pq_out[FRAME_WIDTH_MAX * 2])
 {
     // 最初と最後のピクセルは0に設定
     pq_out[0] = 0;                   // q[0]
@@ -3935,7 +6040,7 @@ static FC128_UNUSED void compute_pq_gradients(uint8_t y_prev[FRAME_WIDTH], uint8
  */
 #if USE_HELIUM_MVE
 // Helium MVE版 - 真のベクトル命令による高速化
-static FC128_UNUSED void reconstruct_depth_simple(uint8_t pq_data[FRAME_WIDTH * 2], uint8_t depth_line[FRAME_WIDTH])
+static FC128_UNUSED void reconstruct_depth_simple(uint8_t pq_data[FRAME_WIDTH_MAX * 2], uint8_t depth_line[FRAME_WIDTH_MAX])
 {
     float z = 0.0f;           // 深度の累積値
     const float scale = 2.0f; // スケーリングファクタ
@@ -4034,7 +6139,7 @@ static FC128_UNUSED void reconstruct_depth_simple(uint8_t pq_data[FRAME_WIDTH *
 }
 #else
 // 標準版(MVEなし)
-static FC128_UNUSED void reconstruct_depth_simple(uint8_t pq_data[FRAME_WIDTH * 2], uint8_t depth_line[FRAME_WIDTH])
+static FC128_UNUSED void reconstruct_depth_simple(uint8_t pq_data[FRAME_WIDTH_MAX * 2], uint8_t depth_line[FRAME_WIDTH_MAX])
 {
     // p勾配を符号付きに戻す(0〜254 → -127〜+127)
     float z = 0.0f;           // 深度の累積値
@@ -4063,7 +6168,7 @@ static FC128_UNUSED void reconstruct_depth_simple(uint8_t pq_data[FRAME_WIDTH *
 #if USE_SIMPLE_DIRECT_P
 /* HyperRAMから直接p勾配をストリーミングして行積分する簡易版．
  * USE_SIMPLE_DIRECT_P=0で従来のSRAMバッファ経由に戻せる． */
-static FC128_UNUSED void reconstruct_depth_simple_direct(uint32_t gradient_line_offset, uint8_t depth_line[FRAME_WIDTH])
+static FC128_UNUSED void reconstruct_depth_simple_direct(uint32_t gradient_line_offset, uint8_t depth_line[FRAME_WIDTH_MAX])
 {
     float z = 0.0f;
     const float scale = 2.0f;
@@ -4131,7 +6236,7 @@ static FC128_UNUSED void reconstruct_depth_simple_direct(uint32_t gradient_line_
  * 必要なエンコード:
  *   block(2)=Y1=edge[x+3], block(4)=Y0=edge[x+2], block(6)=Y3=edge[x+1], block(8)=Y2=edge[x]
  */
-static FC128_UNUSED void edge_to_yuv422(uint8_t edge_line[FRAME_WIDTH], uint8_t yuv_line[FRAME_WIDTH * 2])
+static FC128_UNUSED void edge_to_yuv422(uint8_t edge_line[FRAME_WIDTH_MAX], uint8_t yuv_line[FRAME_WIDTH_MAX * 2])
 {
     // 4ピクセル(8バイト)単位で処理
     for (int x = 0; x < FRAME_WIDTH; x += 4)
@@ -4249,10 +6354,10 @@ static void mg_compute_divergence_to_hyperram(const mg_level_t *level)
     const uint32_t pq_row_bytes = FRAME_WIDTH * 2;
     const uint32_t rhs_row_bytes = (uint32_t)width * sizeof(float);
 
-    uint8_t pq_prev[FRAME_WIDTH * 2];
-    uint8_t pq_curr[FRAME_WIDTH * 2];
-    uint8_t pq_next[FRAME_WIDTH * 2];
-    float div_row[FRAME_WIDTH];
+    uint8_t pq_prev[FRAME_WIDTH_MAX * 2];
+    uint8_t pq_curr[FRAME_WIDTH_MAX * 2];
+    uint8_t pq_next[FRAME_WIDTH_MAX * 2];
+    float div_row[FRAME_WIDTH_MAX];
 
     hyperram_b_read(pq_curr, (void *)GRADIENT_OFFSET, pq_row_bytes);
     memcpy(pq_prev, pq_curr, pq_row_bytes);
@@ -4390,10 +6495,10 @@ static void mg_gauss_seidel(const mg_level_t *level, int iterations)
     }
 
     const uint32_t row_bytes = (uint32_t)width * sizeof(float);
-    float row_prev[FRAME_WIDTH];
-    float row_curr[FRAME_WIDTH];
-    float row_next[FRAME_WIDTH];
-    float rhs_curr[FRAME_WIDTH];
+    float row_prev[FRAME_WIDTH_MAX];
+    float row_curr[FRAME_WIDTH_MAX];
+    float row_next[FRAME_WIDTH_MAX];
+    float rhs_curr[FRAME_WIDTH_MAX];
 
     for (int iter = 0; iter < iterations; iter++)
     {
@@ -4510,11 +6615,11 @@ static void mg_compute_residual(const mg_level_t *level, uint32_t residual_offse
     const int height = level->height;
     const uint32_t row_bytes = (uint32_t)width * sizeof(float);
 
-    float row_prev[FRAME_WIDTH];
-    float row_curr[FRAME_WIDTH];
-    float row_next[FRAME_WIDTH];
-    float rhs_curr[FRAME_WIDTH];
-    float res_row[FRAME_WIDTH];
+    float row_prev[FRAME_WIDTH_MAX];
+    float row_curr[FRAME_WIDTH_MAX];
+    float row_next[FRAME_WIDTH_MAX];
+    float rhs_curr[FRAME_WIDTH_MAX];
+    float res_row[FRAME_WIDTH_MAX];
 
     if (height == 0)
     {
@@ -4627,10 +6732,10 @@ static void mg_restrict_residual(const mg_level_t *fine, const mg_level_t *coars
     const uint32_t fine_row_bytes = (uint32_t)fine_w * sizeof(float);
     const uint32_t coarse_row_bytes = (uint32_t)coarse_w * sizeof(float);
 
-    float row_above[FRAME_WIDTH];
-    float row_center[FRAME_WIDTH];
-    float row_below[FRAME_WIDTH];
-    float coarse_row[FRAME_WIDTH];
+    float row_above[FRAME_WIDTH_MAX];
+    float row_center[FRAME_WIDTH_MAX];
+    float row_below[FRAME_WIDTH_MAX];
+    float coarse_row[FRAME_WIDTH_MAX];
 
     if (fine_h == 0)
     {
@@ -4800,9 +6905,9 @@ static void mg_prolong_correction(const mg_level_t *coarse, const mg_level_t *fi
     const uint32_t coarse_row_bytes = (uint32_t)coarse_w * sizeof(float);
     const uint32_t fine_row_bytes = (uint32_t)fine_w * sizeof(float);
 
-    float coarse_row[FRAME_WIDTH];
-    float fine_row_even[FRAME_WIDTH];
-    float fine_row_odd[FRAME_WIDTH];
+    float coarse_row[FRAME_WIDTH_MAX];
+    float fine_row_even[FRAME_WIDTH_MAX];
+    float fine_row_odd[FRAME_WIDTH_MAX];
 
     for (int cy = 0; cy < coarse_h; cy++)
     {
@@ -4924,18 +7029,18 @@ static void mg_vcycle(int level_index)
     {
         if (level->width == 80)
         {
-            xprintf("[MG] Coarsest level: %dx%d, %d iterations\n", level->width, level->height, coarse_iter);
+            BINLOG3("[MG] Coarsest level: %dx%d, %d iterations\n", level->width, level->height, coarse_iter);
         }
         mg_gauss_seidel(level, coarse_iter);
 
         // デバッグ: 最粗レベルの解をチェック
         if (level->width == 80)
         {
-            float test_row[FRAME_WIDTH];
+            float test_row[FRAME_WIDTH_MAX];
             hyperram_b_read(test_row,
                             (void *)(level->z_offset + (uint32_t)level->width * (uint32_t)sizeof(float)),
                             (uint32_t)level->width * (uint32_t)sizeof(float));
-            xprintf("[MG] After coarse solve: z[1,40]=%.6f\n", test_row[40]);
+            BINLOG1("[MG] After coarse solve: z[1,40]=%.6f\n", BINLOG_F(test_row[40]));
         }
         return;
     }
@@ -4962,8 +7067,8 @@ static void mg_export_depth_map(const mg_level_t *level, float *z_min_out, float
     const int height = level->height;
     const uint32_t row_bytes = (uint32_t)width * sizeof(float);
 
-    float row_buffer[FRAME_WIDTH];
-    uint8_t depth_row[FRAME_WIDTH];
+    float row_buffer[FRAME_WIDTH_MAX];
+    uint8_t depth_row[FRAME_WIDTH_MAX];
     float z_min = 1e9f;
     float z_max = -1e9f;
 
@@ -5132,6 +7237,10 @@ static FC128_UNUSED void reconstruct_depth_multigrid(void)
 void main_thread3_entry(void *pvParameters)
 {
     FSP_PARAMETER_NOT_USED(pvParameters);
+    (void)binlog_register_thread("T3");
+    hyperram_register_caller(HYPERRAM_CALLER_COMPUTE);
+    /* 最初のフレームが公開されるまでの既定(QVGA)．以後はフレームごとに取り直す */
+    s_frame = video_frame_desc_make(320U, 240U, (uint32_t)CAM_MODE_QVGA);
 
 #if APP_MODE_FFT_VERIFY
     /* Ensure printf output works even though thread0 is idle. */
@@ -5206,24 +7315,50 @@ void main_thread3_entry(void *pvParameters)
 
 #if HLAC_ENABLE && HLAC_PQ_MAG_TRUE_256
     xprintf("[Thread3] HLAC true256: exporting |P|+|Q|\n as 256x256 directly from Y (skip PQ128)\n");
+#elif ENABLE_FC128_DEPTH && FC128_TILED_ENABLE
+    xprintf("[Thread3] FC128 tiled: %dx%d grid, %d-sample tiles (overlap>=%d), full-frame depth\n",
+            (int)FC128_TILE_GRID_W, (int)FC128_TILE_GRID_H, (int)FC_RESULT_N, (int)FC128_TILE_OVERLAP);
 #else
     xprintf("[Thread3] PQ128 mode: generating p/q (int16) in HyperRAM\n");
     xprintf("[Thread3] ROI: %dx%d at (%d,%d) from Y (UYVY_SWAP_Y + 4px reorder)\n",
             (int)PQ128_SIZE, (int)PQ128_SIZE, (int)PQ128_X0, (int)PQ128_Y0);
 #endif
 
+#if PQ128_STREAM_CAPTURE && !(HLAC_ENABLE && HLAC_PQ_MAG_TRUE_256) && !(ENABLE_FC128_DEPTH && FC128_TILED_ENABLE)
+    xprintf("[Thread3] PQ128 band streaming from CEU SRAM (%d lines/band)\n", (int)CAM_BAND_LINES);
+    cam_band_notify_set(xTaskGetCurrentTaskHandle());
+    while (1)
+    {
+        cam_band_frame_t fr;
+        if (!pq128_compute_and_store_stream(&fr))
+        {
+            continue;
+        }
+
+#if ENABLE_FC128_DEPTH
+        /* 後段はフレーム本体も読むことがあるので HyperRAM への書き出し完了を待つ */
+        while ((int32_t)(g_video_frame_seq - fr.frame_seq) < 0)
+        {
+            vTaskDelay(pdMS_TO_TICKS(1));
+        }
+        fc128_compute_depth_and_store(fr.hyperram_base, fr.frame_seq);
+#endif
+    }
+#endif
+
     uint32_t last_seq = 0;
     while (1)
     {
-        uint32_t seq = g_video_frame_seq;
+        uint32_t frame_base;
+        video_frame_desc_t desc;
+        uint32_t seq = video_frame_snapshot(&frame_base, &desc);
         if (seq == 0 || seq == last_seq)
         {
             vTaskDelay(pdMS_TO_TICKS(10));
             continue;
         }
-
-        uint32_t frame_base = (uint32_t)g_video_frame_base_offset;
-#if !(HLAC_ENABLE && HLAC_PQ_MAG_TRUE_256)
+        s_frame = desc;
+#if !(HLAC_ENABLE && HLAC_PQ_MAG_TRUE_256) && !(ENABLE_FC128_DEPTH && FC128_TILED_ENABLE)
         pq128_compute_and_store(frame_base, seq);
 #endif
 
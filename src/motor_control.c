@@ -5,8 +5,11 @@
 #include "FreeRTOS.h"
 #include "task.h"
 #include "queue.h"
+#include "timers.h"
 
 #include "r_gpt.h"
+#include "latency_trace.h"
+#include "binlog.h"
 
 #include <string.h>
 
@@ -29,8 +32,9 @@
 #define MOTOR_CONTROL_TASK_PRIORITY (tskIDLE_PRIORITY + 2U)
 #endif
 
-#ifndef MOTOR_CONTROL_UPDATE_PERIOD_MS
-#define MOTOR_CONTROL_UPDATE_PERIOD_MS (20U)
+/* Max wait when queueing a start/reset command to the FreeRTOS timer task. */
+#ifndef MOTOR_TIMER_CMD_WAIT_MS
+#define MOTOR_TIMER_CMD_WAIT_MS (5U)
 #endif
 
 #ifndef MOTOR_CMD_HOLD_MS
@@ -75,6 +79,16 @@
 #define MOTOR_PRED_WATCHDOG_MS (0U)
 #endif
 
+/* Post-to-apply latency: samples kept per class (pred / stop) for percentiles. */
+#ifndef MOTOR_LATENCY_SAMPLES
+#define MOTOR_LATENCY_SAMPLES (128U)
+#endif
+
+/* Log latency percentiles via binlog every N ms (0 = off). */
+#ifndef MOTOR_LATENCY_REPORT_MS
+#define MOTOR_LATENCY_REPORT_MS (10000U)
+#endif
+
 /* Special pred meaning: repeat the previous action. */
 #ifndef MOTOR_REPEAT_LAST_PRED
 #define MOTOR_REPEAT_LAST_PRED (2)
@@ -91,9 +105,24 @@ typedef struct st_motor_pred_rule
 typedef struct st_motor_pred_msg
 {
     int pred;
-    TickType_t post_tick;
+    bool preempt;       /* STOP-class: bypasses the hold */
+    uint32_t order;     /* post order (older normal preds are dropped after a STOP) */
+    uint32_t post_cyc;  /* DWT->CYCCNT at post */
+    uint32_t frame_seq; /* latency trace (0 = untraced) */
 } motor_pred_msg_t;
 
+/* Task notification bits. */
+#define MOTOR_EVT_PRED (1UL << 0)     /* new pred in s_pred_queue */
+#define MOTOR_EVT_PREEMPT (1UL << 1)  /* new pred in s_preempt_queue */
+#define MOTOR_EVT_EXPIRE (1UL << 2)   /* hold timer */
+#define MOTOR_EVT_WATCHDOG (1UL << 3) /* pred watchdog timer */
+
+typedef struct st_motor_latency_ring
+{
+    uint32_t count;
+    uint32_t us[MOTOR_LATENCY_SAMPLES];
+} motor_latency_ring_t;
+
 /*
  * pred -> action mapping (edit here).
  *
@@ -115,11 +144,18 @@ static const motor_pred_rule_t g_pred_rules[] = {
     {3, 3, MOTOR_ACTION_ROTATE_RIGHT, MOTOR_DEFAULT_SPEED_PERMILLE},
 };
 
-static QueueHandle_t s_pred_queue;
+static QueueHandle_t s_pred_queue;    /* normal preds (1-deep, latest wins) */
+static QueueHandle_t s_preempt_queue; /* STOP-class preds (1-deep) */
 static TaskHandle_t s_task;
+static TimerHandle_t s_hold_timer;
+static TimerHandle_t s_watchdog_timer;
+static uint32_t s_post_order = 0U;
+static motor_latency_ring_t s_latency[2]; /* [0] = pred, [1] = stop */
 static uint32_t s_period0 = 0;
 static uint32_t s_period1 = 0;
 
+extern uint32_t SystemCoreClock;
+
 #if MOTOR_FILTER_DUPLICATE_PRED
 static int s_last_posted_pred = INT_MIN;
 #endif
@@ -137,6 +173,17 @@ static motor_pred_rule_t const *motor_rule_for_pred(int pred)
     return NULL;
 }
 
+/* STOP に解決される pred(未定義 pred を含む)はホールドを待たずに適用する． */
+static bool motor_pred_preempts(int pred)
+{
+    if (pred == (int)MOTOR_REPEAT_LAST_PRED)
+    {
+        return false;
+    }
+    const motor_pred_rule_t *rule = motor_rule_for_pred(pred);
+    return (rule == NULL) || (rule->action == MOTOR_ACTION_STOP);
+}
+
 static uint32_t duty_counts_from_permille(uint32_t period_counts, uint16_t permille)
 {
     if (permille >= 1000U)
@@ -213,124 +260,202 @@ static void motor_apply_action(motor_action_t action, uint16_t speed_permille)
     }
 }
 
+static uint32_t motor_cycles_to_us(uint32_t cycles)
+{
+    const uint32_t hz_khz = SystemCoreClock / 1000U;
+    return (hz_khz > 0U) ? (uint32_t)(((uint64_t)cycles * 1000ULL) / hz_khz) : 0U;
+}
+
+static void motor_latency_record(const motor_pred_msg_t *msg)
+{
+    motor_latency_ring_t *r = &s_latency[msg->preempt ? 1 : 0];
+    r->us[r->count % (uint32_t)MOTOR_LATENCY_SAMPLES] = motor_cycles_to_us(DWT->CYCCNT - msg->post_cyc);
+    r->count++;
+}
+
+static void motor_timer_cb(TimerHandle_t timer)
+{
+    const uint32_t evt = (uint32_t)(uintptr_t)pvTimerGetTimerID(timer);
+    (void)xTaskNotify(s_task, evt, eSetBits);
+}
+
+/* One-shot timer を (再)スタート．コマンドキューに積めなければ安全側(停止)に倒す． */
+static bool motor_timer_restart(TimerHandle_t timer)
+{
+    if (timer == NULL)
+    {
+        return true;
+    }
+    return xTimerReset(timer, pdMS_TO_TICKS(MOTOR_TIMER_CMD_WAIT_MS)) == pdPASS;
+}
+
+#if MOTOR_LATENCY_REPORT_MS > 0U
+static void motor_latency_report(void)
+{
+    static const char *const names[2] = {"pred", "stop"};
+    for (uint32_t c = 0U; c < 2U; c++)
+    {
+        motor_latency_stats_t st;
+        if (motor_control_latency_stats(c != 0U, &st) && (st.samples > 0U))
+        {
+            BINLOG4("[MOTOR] %s p50=%uus p95=%uus p99=%uus\n", names[c], st.p50_us, st.p95_us, st.p99_us);
+            BINLOG3("[MOTOR] %s max=%uus n=%u\n", names[c], st.max_us, st.samples);
+        }
+    }
+}
+#endif
+
 static void motor_control_task(void *pvParameters)
 {
     FSP_PARAMETER_NOT_USED(pvParameters);
 
-    int pred = -1;
     bool active = false;
     bool pred_locked = false;
     TickType_t expire_tick = 0;
 
     TickType_t last_pred_tick = 0;
+    uint32_t last_order = 0U;
 
     bool last_valid = false;
     motor_action_t last_action = MOTOR_ACTION_STOP;
     uint16_t last_speed_permille = 0U;
 
+    (void)binlog_register_thread("MOT");
+
+#if MOTOR_LATENCY_REPORT_MS > 0U
+    const TickType_t wait_ticks = pdMS_TO_TICKS(MOTOR_LATENCY_REPORT_MS);
+    TickType_t report_tick = xTaskGetTickCount();
+#else
+    const TickType_t wait_ticks = portMAX_DELAY;
+#endif
+
     for (;;)
     {
-        /* Defer pred updates while an action is active.
-         * Keep the latest pred in the 1-deep queue by peeking (do not consume).
-         * We still block briefly to avoid busy looping.
-         */
-        if (pred_locked)
+        /* ポーリングしない: post / タイマ満了の通知で起きる */
+        uint32_t events = 0U;
+        (void)xTaskNotifyWait(0U, UINT32_MAX, &events, wait_ticks);
+        const TickType_t now = xTaskGetTickCount();
+
+        motor_pred_msg_t rx_msg;
+        bool have_msg = false;
+
+        /* STOP 系はホールド中でも即座に割り込む */
+        if (((events & MOTOR_EVT_PREEMPT) != 0U) && (xQueueReceive(s_preempt_queue, &rx_msg, 0) == pdTRUE))
+        {
+            have_msg = true;
+        }
+
+        if ((events & (MOTOR_EVT_PRED | MOTOR_EVT_PREEMPT)) != 0U)
         {
-            motor_pred_msg_t peek_msg;
-            if (xQueuePeek(s_pred_queue, &peek_msg, pdMS_TO_TICKS(MOTOR_CONTROL_UPDATE_PERIOD_MS)) == pdTRUE)
+            last_pred_tick = now;
+            if (!motor_timer_restart(s_watchdog_timer))
             {
-                last_pred_tick = peek_msg.post_tick;
+                motor_stop_all();
+                active = false;
+                pred_locked = false;
             }
         }
-        else
+
+        if ((MOTOR_PRED_WATCHDOG_MS > 0U) && ((events & MOTOR_EVT_WATCHDOG) != 0U) && active &&
+            ((now - last_pred_tick) >= pdMS_TO_TICKS(MOTOR_PRED_WATCHDOG_MS)))
         {
-            motor_pred_msg_t rx_msg;
-            if (xQueueReceive(s_pred_queue, &rx_msg, pdMS_TO_TICKS(MOTOR_CONTROL_UPDATE_PERIOD_MS)) == pdTRUE)
+            motor_stop_all();
+            active = false;
+            pred_locked = false;
+        }
+
+        /* 満了の判定は tick でも確認する(直前に再スタートしたホールドの古い通知を無視) */
+        if (((events & MOTOR_EVT_EXPIRE) != 0U) && active && ((int32_t)(now - expire_tick) >= 0))
+        {
+            if (MOTOR_FORCE_STOP_AFTER_HOLD)
             {
-                pred = rx_msg.pred;
-                last_pred_tick = rx_msg.post_tick;
+                motor_stop_all();
+            }
+            active = false;
+            pred_locked = false;
+        }
 
-                motor_action_t action = MOTOR_ACTION_STOP;
-                uint16_t speed_permille = 0U;
+        /* ホールド中は通常 pred を 1-deep キューに残したまま(満了時に拾う) */
+        if (!have_msg && !pred_locked && (xQueueReceive(s_pred_queue, &rx_msg, 0) == pdTRUE))
+        {
+            have_msg = true;
+        }
 
-                if (pred == (int)MOTOR_REPEAT_LAST_PRED)
-                {
-                    if (last_valid)
-                    {
-                        action = last_action;
-                        speed_permille = last_speed_permille;
-                    }
-                    else
-                    {
-                        action = MOTOR_ACTION_STOP;
-                        speed_permille = 0U;
-                    }
-                }
-                else
-                {
-                    const motor_pred_rule_t *rule = motor_rule_for_pred(pred);
-                    if (rule)
-                    {
-                        action = rule->action;
-                        speed_permille = rule->speed_permille;
-                    }
-                    else
-                    {
-                        action = MOTOR_ACTION_STOP;
-                        speed_permille = 0U;
-                    }
-                }
+        /* STOP より前に投げられた通常 pred は捨てる */
+        if (have_msg && ((int32_t)(rx_msg.order - last_order) > 0))
+        {
+            const int pred = rx_msg.pred;
+            last_order = rx_msg.order;
+
+            motor_action_t action = MOTOR_ACTION_STOP;
+            uint16_t speed_permille = 0U;
 
-                if (action == MOTOR_ACTION_STOP)
+            if (pred == (int)MOTOR_REPEAT_LAST_PRED)
+            {
+                if (last_valid)
                 {
-                    motor_stop_all();
-                    active = false;
-                    pred_locked = false;
-                    last_valid = true;
-                    last_action = MOTOR_ACTION_STOP;
-                    last_speed_permille = 0U;
+                    action = last_action;
+                    speed_permille = last_speed_permille;
                 }
-                else
+            }
+            else
+            {
+                const motor_pred_rule_t *rule = motor_rule_for_pred(pred);
+                if (rule)
                 {
-                    motor_apply_action(action, speed_permille);
-                    active = true;
-                    pred_locked = (MOTOR_LOCK_PRED_DURING_ACTIVE ? active : false);
-                    if (MOTOR_CMD_HOLD_MS > 0U)
-                    {
-                        expire_tick = xTaskGetTickCount() + pdMS_TO_TICKS(MOTOR_CMD_HOLD_MS);
-                    }
-
-                    last_valid = true;
-                    last_action = action;
-                    last_speed_permille = speed_permille;
+                    action = rule->action;
+                    speed_permille = rule->speed_permille;
                 }
             }
-        }
 
-        if ((MOTOR_PRED_WATCHDOG_MS > 0U) && active)
-        {
-            TickType_t now = xTaskGetTickCount();
-            if ((last_pred_tick != 0) && ((now - last_pred_tick) > pdMS_TO_TICKS(MOTOR_PRED_WATCHDOG_MS)))
+            if (action == MOTOR_ACTION_STOP)
             {
                 motor_stop_all();
+                latency_trace_stamp(rx_msg.frame_seq, LATENCY_STAGE_GPT_APPLIED);
+                motor_latency_record(&rx_msg);
                 active = false;
                 pred_locked = false;
+                last_valid = true;
+                last_action = MOTOR_ACTION_STOP;
+                last_speed_permille = 0U;
             }
-        }
-
-        if (active)
-        {
-            TickType_t now = xTaskGetTickCount();
-            if ((MOTOR_CMD_HOLD_MS > 0U) && ((int32_t)(now - expire_tick) >= 0))
+            else
             {
-                if (MOTOR_FORCE_STOP_AFTER_HOLD)
+                motor_apply_action(action, speed_permille);
+                latency_trace_stamp(rx_msg.frame_seq, LATENCY_STAGE_GPT_APPLIED);
+                motor_latency_record(&rx_msg);
+                active = true;
+                pred_locked = (MOTOR_LOCK_PRED_DURING_ACTIVE ? active : false);
+                if (MOTOR_CMD_HOLD_MS > 0U)
                 {
-                    motor_stop_all();
+                    expire_tick = xTaskGetTickCount() + pdMS_TO_TICKS(MOTOR_CMD_HOLD_MS);
+                    if (!motor_timer_restart(s_hold_timer))
+                    {
+                        motor_stop_all();
+                        active = false;
+                        pred_locked = false;
+                    }
                 }
-                active = false;
-                pred_locked = false;
+
+                last_valid = true;
+                last_action = action;
+                last_speed_permille = speed_permille;
             }
         }
+
+        /* 1 回の起床で 1 コマンド．残っている pred は次の周回で拾う */
+        if (!pred_locked && (uxQueueMessagesWaiting(s_pred_queue) > 0U))
+        {
+            (void)xTaskNotify(xTaskGetCurrentTaskHandle(), MOTOR_EVT_PRED, eSetBits);
+        }
+
+#if MOTOR_LATENCY_REPORT_MS > 0U
+        if ((now - report_tick) >= wait_ticks)
+        {
+            report_tick = now;
+            motor_latency_report();
+        }
+#endif
     }
 }
 
@@ -355,12 +480,37 @@ void motor_control_start(void)
         s_period1 = info.period_counts;
     }
 
+    /* post_cyc uses the DWT cycle counter (enable without resetting). */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
     s_pred_queue = xQueueCreate(1, sizeof(motor_pred_msg_t));
-    if (!s_pred_queue)
+    s_preempt_queue = xQueueCreate(1, sizeof(motor_pred_msg_t));
+    if (!s_pred_queue || !s_preempt_queue)
     {
         return;
     }
 
+    /* Hold / watchdog run on one-shot software timers that notify the task. */
+    if (MOTOR_CMD_HOLD_MS > 0U)
+    {
+        s_hold_timer = xTimerCreate("motor_hold", pdMS_TO_TICKS(MOTOR_CMD_HOLD_MS), pdFALSE,
+                                    (void *)(uintptr_t)MOTOR_EVT_EXPIRE, motor_timer_cb);
+        if (!s_hold_timer)
+        {
+            return;
+        }
+    }
+    if (MOTOR_PRED_WATCHDOG_MS > 0U)
+    {
+        s_watchdog_timer = xTimerCreate("motor_wdt", pdMS_TO_TICKS(MOTOR_PRED_WATCHDOG_MS), pdFALSE,
+                                        (void *)(uintptr_t)MOTOR_EVT_WATCHDOG, motor_timer_cb);
+        if (!s_watchdog_timer)
+        {
+            return;
+        }
+    }
+
     /* Safe default at boot. */
     motor_stop_all();
 
@@ -374,25 +524,96 @@ void motor_control_start(void)
 
 void motor_control_post_pred(int pred)
 {
-    if (!s_pred_queue)
+    motor_control_post_pred_frame(pred, 0U);
+}
+
+static void motor_post_locked(const motor_pred_msg_t *msg)
+{
+    latency_trace_stamp(msg->frame_seq, LATENCY_STAGE_MOTOR_POST);
+    if (msg->preempt)
+    {
+        (void)xQueueOverwrite(s_preempt_queue, msg);
+    }
+    else
+    {
+        (void)xQueueOverwrite(s_pred_queue, msg);
+    }
+}
+
+void motor_control_post_pred_frame(int pred, uint32_t frame_seq)
+{
+    if (!s_pred_queue || !s_task)
     {
         return;
     }
 
     motor_pred_msg_t msg;
     msg.pred = pred;
-    msg.post_tick = xTaskGetTickCount();
+    msg.preempt = motor_pred_preempts(pred);
+    msg.frame_seq = frame_seq;
 
+    bool posted = true;
+    taskENTER_CRITICAL();
 #if MOTOR_FILTER_DUPLICATE_PRED
     /* Optional: event-driven mode (ignore consecutive identical preds). */
-    taskENTER_CRITICAL();
-    if (pred != s_last_posted_pred)
+    posted = (pred != s_last_posted_pred);
+    s_last_posted_pred = pred;
+#endif
+    if (posted)
     {
-        s_last_posted_pred = pred;
-        (void)xQueueOverwrite(s_pred_queue, &msg);
+        msg.order = ++s_post_order;
+        msg.post_cyc = DWT->CYCCNT;
+        motor_post_locked(&msg);
     }
     taskEXIT_CRITICAL();
-#else
-    (void)xQueueOverwrite(s_pred_queue, &msg);
-#endif
+
+    /* The motor task has a higher priority than the producers: this switches to it right away. */
+    if (posted)
+    {
+        (void)xTaskNotify(s_task, msg.preempt ? MOTOR_EVT_PREEMPT : MOTOR_EVT_PRED, eSetBits);
+    }
+}
+
+bool motor_control_latency_stats(bool preempt, motor_latency_stats_t *out)
+{
+    static uint32_t s_sorted[MOTOR_LATENCY_SAMPLES];
+    const motor_latency_ring_t *r = &s_latency[preempt ? 1 : 0];
+
+    if (out == NULL)
+    {
+        return false;
+    }
+    memset(out, 0, sizeof(*out));
+
+    /* 呼び出し元は 1 つ(モータタスクのレポート)を想定: s_sorted は共有 */
+    taskENTER_CRITICAL();
+    const uint32_t n = (r->count < (uint32_t)MOTOR_LATENCY_SAMPLES) ? r->count : (uint32_t)MOTOR_LATENCY_SAMPLES;
+    memcpy(s_sorted, r->us, n * sizeof(s_sorted[0]));
+    out->total = r->count;
+    taskEXIT_CRITICAL();
+
+    out->samples = n;
+    if (n == 0U)
+    {
+        return true;
+    }
+
+    /* insertion sort (n <= MOTOR_LATENCY_SAMPLES) */
+    for (uint32_t i = 1U; i < n; i++)
+    {
+        const uint32_t v = s_sorted[i];
+        uint32_t j = i;
+        while ((j > 0U) && (s_sorted[j - 1U] > v))
+        {
+            s_sorted[j] = s_sorted[j - 1U];
+            j--;
+        }
+        s_sorted[j] = v;
+    }
+
+    out->p50_us = s_sorted[((n - 1U) * 50U) / 100U];
+    out->p95_us = s_sorted[((n - 1U) * 95U) / 100U];
+    out->p99_us = s_sorted[((n - 1U) * 99U) / 100U];
+    out->max_us = s_sorted[n - 1U];
+    return true;
 }
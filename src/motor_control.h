@@ -13,6 +13,10 @@ extern "C"
      * This module is intentionally small:
      * - One FreeRTOS task owns all GPT updates.
      * - Producer (HLAC) only posts pred values (optionally filtered before posting).
+     * - The task is event-driven: posts wake it with a task notification, and the
+     *   hold / watchdog windows run on one-shot software timers (no polling).
+     * - Preds that resolve to STOP (including unknown preds) pre-empt an active hold
+     *   and are applied as soon as the scheduler runs the task.
      */
 
     typedef enum e_motor_action
@@ -26,6 +30,17 @@ extern "C"
         MOTOR_ACTION_ROTATE_RIGHT,
     } motor_action_t;
 
+    /** Post-to-apply latency over the most recent applied commands. */
+    typedef struct st_motor_latency_stats
+    {
+        uint32_t total;   /* commands applied since boot */
+        uint32_t samples; /* samples used below (<= MOTOR_LATENCY_SAMPLES) */
+        uint32_t p50_us;
+        uint32_t p95_us;
+        uint32_t p99_us;
+        uint32_t max_us;
+    } motor_latency_stats_t;
+
     /** Start the motor control task.
      *
      * Call this after PWM (GPT0/GPT1) have been opened and started.
@@ -35,9 +50,24 @@ extern "C"
     /** Post a new pred label to the motor control task.
      *
      * This is non-blocking. The motor task always uses the latest pred.
+     * Normal preds posted during a hold are deferred until it expires
+     * (MOTOR_LOCK_PRED_DURING_ACTIVE); STOP preds are applied immediately.
      */
     void motor_control_post_pred(int pred);
 
+    /** Same as motor_control_post_pred(), tagged with the source frame seq.
+     *
+     * The seq is carried to the motor task for latency tracing (0 = untraced).
+     */
+    void motor_control_post_pred_frame(int pred, uint32_t frame_seq);
+
+    /** Post-to-apply latency percentiles.
+     *
+     * preempt selects the STOP class (true) or normal preds (false).
+     * Deferred preds include the time they waited for the hold to expire.
+     */
+    bool motor_control_latency_stats(bool preempt, motor_latency_stats_t *out);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,113 @@
+#include "prof.h"
+
+#include <string.h>
+
+#if PROF_ENABLE
+
+prof_span_stats_t g_prof_spans[PROF_SPAN_COUNT];
+volatile uint32_t g_prof_counters[PROF_CTR_COUNT];
+
+/* matlab/prof_telemetry_plot.m と同じ並び */
+static const char *const s_span_names[PROF_SPAN_COUNT] = {
+    "pq128.row",
+    "pq128.tile",
+    "hyperram.read",
+    "hyperram.write",
+    "hyperram.wait",
+    "fft.rows",
+    "fft.xpose",
+    "fft.cols",
+    "fc.build",
+    "fc.fft",
+    "fc.zhat",
+    "fc.ifft",
+    "fc.export",
+    "hlac",
+    "lda",
+    "udp.chunk",
+};
+
+static const char *const s_counter_names[PROF_CTR_COUNT] = {
+    "hyperram.read_bytes",
+    "hyperram.write_bytes",
+    "hyperram.timeouts",
+    "udp.chunks",
+    "udp.bytes",
+    "udp.reschedules",
+    "udp.send_errors",
+};
+
+void prof_init(void)
+{
+    /* Other timing helpers may reset CYCCNT at their init; do not touch it here. */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+static inline uint32_t prof_bucket(uint32_t cycles)
+{
+    const uint32_t bits = (cycles != 0U) ? (32U - (uint32_t)__builtin_clz(cycles)) : 0U;
+    if (bits <= (uint32_t)PROF_HIST_SHIFT)
+    {
+        return 0U;
+    }
+    const uint32_t b = bits - (uint32_t)PROF_HIST_SHIFT;
+    return (b < (uint32_t)PROF_HIST_BUCKETS) ? b : ((uint32_t)PROF_HIST_BUCKETS - 1U);
+}
+
+void prof_record(prof_span_t span, uint32_t cycles)
+{
+    if ((uint32_t)span >= (uint32_t)PROF_SPAN_COUNT)
+    {
+        return;
+    }
+
+    prof_span_stats_t *s = &g_prof_spans[span];
+    if ((s->count == 0U) || (cycles < s->min))
+    {
+        s->min = cycles;
+    }
+    if (cycles > s->max)
+    {
+        s->max = cycles;
+    }
+    s->sum += cycles;
+    s->hist[prof_bucket(cycles)]++;
+    s->count++;
+}
+
+void prof_snapshot(prof_span_stats_t spans[PROF_SPAN_COUNT], uint32_t counters[PROF_CTR_COUNT])
+{
+    if (spans != NULL)
+    {
+        memcpy(spans, g_prof_spans, sizeof(g_prof_spans));
+    }
+    if (counters != NULL)
+    {
+        for (uint32_t i = 0U; i < (uint32_t)PROF_CTR_COUNT; i++)
+        {
+            counters[i] = g_prof_counters[i];
+        }
+    }
+}
+
+void prof_reset(void)
+{
+    memset(g_prof_spans, 0, sizeof(g_prof_spans));
+    for (uint32_t i = 0U; i < (uint32_t)PROF_CTR_COUNT; i++)
+    {
+        g_prof_counters[i] = 0U;
+    }
+}
+
+const char *prof_span_name(prof_span_t span)
+{
+    return ((uint32_t)span < (uint32_t)PROF_SPAN_COUNT) ? s_span_names[span] : "?";
+}
+
+const char *prof_counter_name(prof_counter_t ctr)
+{
+    return ((uint32_t)ctr < (uint32_t)PROF_CTR_COUNT) ? s_counter_names[ctr] : "?";
+}
+
+#endif
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hal_data.h"
+
+/*
+ * Always-on per-stage profiler.
+ *
+ * - Span: DWT サイクルで測る区間．count / sum / min / max と log2 ヒストグラムを持つ．
+ *   prof_now() で始点を取り，prof_span_end() で記録する(1回あたり数十サイクル)．
+ * - Counter: バイト数・回数などの 32bit 累積値(周回する．ホストは差分を取る)．
+ * - 値は起動(または prof_reset())からの累積．Thread1 が PROF_UDP_PERIOD_MS ごとに
+ *   "PRF1" パケットでスナップショットを送る．受信側: matlab/prof_telemetry_plot.m
+ * - 更新はロックなしの read-modify-write．同じ span / counter を複数タスクが同時に
+ *   更新すると稀に1サンプル落ちる(統計用なので許容)．HyperRAM の span / counter は
+ *   g_hyperram_mutex の内側で更新するので落ちない(取得できなかった timeouts を除く)．
+ * - 名前表(prof.c)とホストツールの並びは enum と同じ順にすること．
+ */
+
+#ifndef PROF_ENABLE
+#define PROF_ENABLE (1)
+#endif
+
+/* ヒストグラム: bucket 0 = 2^PROF_HIST_SHIFT 未満，bucket k = [2^(k+SHIFT-1), 2^(k+SHIFT))，最後は上限なし */
+#ifndef PROF_HIST_BUCKETS
+#define PROF_HIST_BUCKETS (24U)
+#endif
+
+#ifndef PROF_HIST_SHIFT
+#define PROF_HIST_SHIFT (8U)
+#endif
+
+/* 1: Thread1 が映像ストリーム中に定期的にスナップショットを送る */
+#ifndef PROF_UDP_ENABLE
+#define PROF_UDP_ENABLE (1)
+#endif
+
+#ifndef PROF_UDP_PERIOD_MS
+#define PROF_UDP_PERIOD_MS (1000U)
+#endif
+
+/* 1パケットに載せる span 数(8 で約 1KB) */
+#ifndef PROF_UDP_SPANS_PER_PACKET
+#define PROF_UDP_SPANS_PER_PACKET (8U)
+#endif
+
+#if (PROF_HIST_BUCKETS < 2U) || ((PROF_HIST_BUCKETS + PROF_HIST_SHIFT) > 33U)
+#error PROF_HIST_BUCKETS / PROF_HIST_SHIFT out of range.
+#endif
+
+typedef enum
+{
+    PROF_SPAN_PQ128_ROW = 0,  // PQ128 1行(Sobel + p/q + HyperRAM 書き出し，帯ストリーム時は帯待ちを含む)
+    PROF_SPAN_PQ128_TILE,     // PQ128 1タイル(128 行)
+    PROF_SPAN_HYPERRAM_READ,  // hyperram_b_read*: 転送(ミューテックス保持中)
+    PROF_SPAN_HYPERRAM_WRITE, // hyperram_b_write*: 転送 + write verify
+    PROF_SPAN_HYPERRAM_WAIT,  // ミューテックス待ち(取得できたもの)
+    PROF_SPAN_FFT_ROWS,       // fft_depth_test: 行 FFT
+    PROF_SPAN_FFT_XPOSE,      // 転置(2回分の合計)
+    PROF_SPAN_FFT_COLS,       // 列 FFT
+    PROF_SPAN_FC_BUILD,       // FC: p/q 平面の組み立て
+    PROF_SPAN_FC_FFT,         // FC: FFT2(P), FFT2(Q)
+    PROF_SPAN_FC_ZHAT,        // FC: Z_hat
+    PROF_SPAN_FC_IFFT,        // FC: IFFT2
+    PROF_SPAN_FC_EXPORT,      // FC: 深度 u8 書き出し
+    PROF_SPAN_HLAC,           // HLAC 特徴量(ブロックモードは1ブロック，それ以外は1フレーム)
+    PROF_SPAN_LDA,            // LDA 推論1回
+    PROF_SPAN_UDP_CHUNK,      // UDP 1チャンク(HyperRAM 読み出し + udp_sendto)
+    PROF_SPAN_COUNT
+} prof_span_t;
+
+typedef enum
+{
+    PROF_CTR_HYPERRAM_READ_BYTES = 0,
+    PROF_CTR_HYPERRAM_WRITE_BYTES,
+    PROF_CTR_HYPERRAM_TIMEOUTS, // FSP_ERR_TIMEOUT(ミューテックス待ちの打ち切り)
+    PROF_CTR_UDP_CHUNKS,        // 送信できたチャンク
+    PROF_CTR_UDP_BYTES,         // 送信できたペイロード(ヘッダ除く)
+    PROF_CTR_UDP_RESCHEDULES,   // HyperRAM 使用中 / pbuf 不足で送り直したチャンク
+    PROF_CTR_UDP_SEND_ERRORS,   // udp_sendto != ERR_OK
+    PROF_CTR_COUNT
+} prof_counter_t;
+
+typedef struct
+{
+    uint32_t count;
+    uint32_t min; // count == 0 のときは 0
+    uint32_t max;
+    uint64_t sum;
+    uint32_t hist[PROF_HIST_BUCKETS];
+} prof_span_stats_t;
+
+/* UDP パケット(Thread1 → ホスト，ポートは映像と同じ) */
+#define PROF_UDP_MAGIC (0x31465250U) // "PRF1"
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t cpu_hz;       // DWT クロック(SystemCoreClock)
+    uint32_t snap_seq;     // スナップショット番号(1つのスナップショットを複数パケットに分ける)
+    uint32_t uptime_ms;
+    uint8_t span_count;    // PROF_SPAN_COUNT
+    uint8_t first_span;    // このパケットの先頭 span
+    uint8_t n_spans;       // このパケットの span 数
+    uint8_t counter_count; // PROF_CTR_COUNT
+    uint8_t hist_buckets;  // PROF_HIST_BUCKETS
+    uint8_t hist_shift;    // PROF_HIST_SHIFT
+    uint16_t reserved;
+} prof_udp_header_t;
+/* 続いて counters[counter_count](uint32)，span ごとに count,min,max,sum_lo,sum_hi,hist[hist_buckets](uint32) */
+
+#if PROF_ENABLE
+
+extern prof_span_stats_t g_prof_spans[PROF_SPAN_COUNT];
+extern volatile uint32_t g_prof_counters[PROF_CTR_COUNT];
+
+/* DWT サイクルカウンタを有効化(CYCCNT はリセットしない)．複数回呼んでよい． */
+void prof_init(void);
+
+static inline uint32_t prof_now(void)
+{
+    return DWT->CYCCNT;
+}
+
+void prof_record(prof_span_t span, uint32_t cycles);
+
+static inline void prof_span_end(prof_span_t span, uint32_t t0)
+{
+    prof_record(span, prof_now() - t0);
+}
+
+static inline void prof_count(prof_counter_t ctr, uint32_t n)
+{
+    g_prof_counters[ctr] += n;
+}
+
+/* 全 span / counter をコピー(どちらも NULL 可)．更新中の span は多少ずれてよい． */
+void prof_snapshot(prof_span_stats_t spans[PROF_SPAN_COUNT], uint32_t counters[PROF_CTR_COUNT]);
+
+/* Best-effort reset (a concurrent update may survive it). */
+void prof_reset(void);
+
+const char *prof_span_name(prof_span_t span);
+const char *prof_counter_name(prof_counter_t ctr);
+
+#else
+
+static inline void prof_init(void)
+{
+}
+
+static inline uint32_t prof_now(void)
+{
+    return 0U;
+}
+
+static inline void prof_record(prof_span_t span, uint32_t cycles)
+{
+    (void)span;
+    (void)cycles;
+}
+
+static inline void prof_span_end(prof_span_t span, uint32_t t0)
+{
+    (void)span;
+    (void)t0;
+}
+
+static inline void prof_count(prof_counter_t ctr, uint32_t n)
+{
+    (void)ctr;
+    (void)n;
+}
+
+static inline void prof_reset(void)
+{
+}
+
+#endif
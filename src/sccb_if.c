@@ -1,6 +1,9 @@
 
+#include <string.h>
 #include "hal_data.h"
 #include "sccb_if.h"
+#include "FreeRTOS.h"
+#include "task.h"
 
 #define NEED_XPRINTF_MESSAGE (1)
 
@@ -186,7 +189,8 @@ static const cam_reg_value_t ov3640_init_reg_tbl[] = {
 
 static const cam_reg_value_t ov5642_init_reg_tbl[] = {
     {0x31, 0x03, 0x93},
-    {0x30, 0x08, 0x82},
+    {0x30, 0x08, 0x82},    // software reset
+    SCCB_TBL_DELAY_MS(5), // リセット完了待ち
     {0x30, 0x17, 0x7f},
     {0x30, 0x18, 0xfc},
     {0x38, 0x10, 0xc2},
@@ -883,42 +887,242 @@ int32_t reg_write(uint32_t addr, // Camera's hw address
     return num_bytes_read;
 }
 
+/*
+ * テーブル駆動の書き込みエンジン
+ *   タスク: 表の先頭(または待ちエントリの次)から1件目の書き込みを開始して通知待ち
+ *   ISR   : TX_COMPLETE ごとに次のエントリを探して書き込みを開始(ソフトウェア待ちなし)
+ *           待ちエントリ/終端/エラー/ソフトリセットでタスクへ通知
+ */
+typedef struct
+{
+    const cam_reg_value_t *tbl;
+    uint32_t idx;     // 送信中(チェーン停止後は停止位置)のエントリ
+    uint32_t written; // 書き込み完了数
+    bool diff_only;
+    volatile bool active;
+    volatile bool failed;
+    volatile bool reset; // ソフトリセットを書いた(控えはタスク側で消す)
+    TaskHandle_t task;
+    uint8_t buf[3]; // 送信中の {reg_high, reg_low, val}
+} sccb_job_t;
+
+static sccb_job_t s_job;
+static uint32_t s_cam_addr = 0U;
+static uint16_t s_reset_reg = 0xFFFFU; // 書くと全レジスタが既定値に戻るレジスタ
+static uint8_t s_reset_mask = 0U;
+
+/* 書いた値の控え: bit31=有効, bit23..8=レジスタ, bit7..0=値(開番地法) */
+static uint32_t s_shadow[SCCB_SHADOW_SLOTS];
+
+static inline bool sccb_tbl_is_end(const cam_reg_value_t *e)
+{
+    return (e->reg_high == 0xFFU) && (e->reg_low == 0xFFU) && (e->val == 0xFFU);
+}
+
+static inline bool sccb_tbl_is_delay(const cam_reg_value_t *e)
+{
+    return (e->reg_high == 0xFEU) && (e->reg_low == 0xFEU);
+}
+
+static inline uint16_t sccb_tbl_reg(const cam_reg_value_t *e)
+{
+    return (uint16_t)(((uint16_t)e->reg_high << 8) | e->reg_low);
+}
+
+static uint32_t *sccb_shadow_slot(uint16_t reg, bool insert)
+{
+    uint32_t h = ((uint32_t)reg * 0x9E37U) & (SCCB_SHADOW_SLOTS - 1U);
+    for (uint32_t n = 0U; n < (uint32_t)SCCB_SHADOW_PROBE_MAX; n++)
+    {
+        uint32_t *slot = &s_shadow[h];
+        if ((*slot & 0x80000000U) == 0U)
+        {
+            return insert ? slot : NULL;
+        }
+        if (((*slot >> 8) & 0xFFFFU) == (uint32_t)reg)
+        {
+            return slot;
+        }
+        h = (h + 1U) & (SCCB_SHADOW_SLOTS - 1U);
+    }
+    return NULL; // 探索上限まで空きなし(そのレジスタは控えず毎回書く)
+}
+
+static inline bool sccb_is_reset_write(uint16_t reg, uint8_t val)
+{
+    return (reg == s_reset_reg) && ((val & s_reset_mask) != 0U);
+}
+
+/* ISR から呼ぶ: 探索は SCCB_SHADOW_PROBE_MAX 回まで．リセット時の全消去はタスク側 */
+static void sccb_shadow_store(uint16_t reg, uint8_t val)
+{
+    uint32_t *slot = sccb_shadow_slot(reg, true);
+    if (slot != NULL)
+    {
+        *slot = 0x80000000U | ((uint32_t)reg << 8) | val;
+    }
+}
+
+static bool sccb_shadow_same(uint16_t reg, uint8_t val)
+{
+    if (reg == s_reset_reg)
+    {
+        return false;
+    }
+    const uint32_t *slot = sccb_shadow_slot(reg, false);
+    return (slot != NULL) && ((*slot & 0xFFU) == (uint32_t)val);
+}
+
+/* idx 以降で次に送るエントリ(または待ち/終端)の位置 */
+static uint32_t sccb_job_seek(const sccb_job_t *job, uint32_t idx)
+{
+    while (job->diff_only)
+    {
+        const cam_reg_value_t *e = &job->tbl[idx];
+        if (sccb_tbl_is_end(e) || sccb_tbl_is_delay(e) || !sccb_shadow_same(sccb_tbl_reg(e), e->val))
+        {
+            break;
+        }
+        idx++;
+    }
+    return idx;
+}
+
+static bool sccb_job_start_write(sccb_job_t *job)
+{
+    const cam_reg_value_t *e = &job->tbl[job->idx];
+    job->buf[0] = e->reg_high;
+    job->buf[1] = e->reg_low;
+    job->buf[2] = e->val;
+    g_i2c_callback_event = I2C_MASTER_EVENT_ABORTED;
+    return FSP_SUCCESS == R_IIC_MASTER_Write(&g_i2c_master1_ctrl, job->buf, 3U, false);
+}
+
+static void sccb_job_finish_from_isr(sccb_job_t *job)
+{
+    job->active = false;
+    if (job->task != NULL)
+    {
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(job->task, &woken);
+        portYIELD_FROM_ISR(woken);
+    }
+}
+
+static void sccb_job_on_event(sccb_job_t *job, i2c_master_event_t event)
+{
+    if (I2C_MASTER_EVENT_TX_COMPLETE != event)
+    {
+        job->failed = true;
+        sccb_job_finish_from_isr(job);
+        return;
+    }
+
+    const cam_reg_value_t *e = &job->tbl[job->idx];
+    job->written++;
+    if (sccb_is_reset_write(sccb_tbl_reg(e), e->val))
+    {
+        /* 控えが無効になったのでチェーンを止め，消去と以降の差分判定はタスクに任せる */
+        job->reset = true;
+        job->idx++;
+        sccb_job_finish_from_isr(job);
+        return;
+    }
+    sccb_shadow_store(sccb_tbl_reg(e), e->val);
+
+    job->idx = sccb_job_seek(job, job->idx + 1U);
+    e = &job->tbl[job->idx];
+    if (sccb_tbl_is_end(e) || sccb_tbl_is_delay(e))
+    {
+        sccb_job_finish_from_isr(job);
+        return;
+    }
+    if (!sccb_job_start_write(job))
+    {
+        job->failed = true;
+        sccb_job_finish_from_isr(job);
+    }
+}
+
 void g_i2c_callback(i2c_master_callback_args_t *p_args)
 {
     g_i2c_callback_event = p_args->event;
 
-    // switch (g_i2c_callback_event)
-    // {
-    // case I2C_MASTER_EVENT_ABORTED:
-    //     g_flag = 1;
-    //     break;
-    // case I2C_MASTER_EVENT_RX_COMPLETE:
-    //     g_flag = 2;
-    //     break;
-    // case I2C_MASTER_EVENT_TX_COMPLETE:
-    //     g_flag = 3;
-    //     break;
-    // case I2C_MASTER_EVENT_START:
-    //     g_flag = 4;
-    //     break;
-    // case I2C_MASTER_EVENT_BYTE_ACK:
-    //     g_flag = 5;
-    //     break;
-    // default:
-    //     g_flag = 0;
-    //     break;
-    // }
+    if (s_job.active)
+    {
+        sccb_job_on_event(&s_job, p_args->event);
+    }
 }
 
-void sccb_init(camera_dev_t cam)
+int32_t sccb_write_table(const cam_reg_value_t *tbl, bool diff_only)
 {
-    uint8_t sccb_dat[3];
+    sccb_job_t *job = &s_job;
+    if ((tbl == NULL) || job->active)
+    {
+        return -1;
+    }
+
+    (void)R_IIC_MASTER_SlaveAddressSet(&g_i2c_master1_ctrl, s_cam_addr, I2C_MASTER_ADDR_MODE_7BIT);
 
+    job->tbl = tbl;
+    job->written = 0U;
+    job->diff_only = diff_only;
+    job->task = xTaskGetCurrentTaskHandle();
+
+    uint32_t idx = 0U;
+    while (1)
+    {
+        idx = sccb_job_seek(job, idx);
+        const cam_reg_value_t *e = &tbl[idx];
+        if (sccb_tbl_is_end(e))
+        {
+            break;
+        }
+        if (sccb_tbl_is_delay(e))
+        {
+            vTaskDelay(pdMS_TO_TICKS((uint32_t)e->val));
+            idx++;
+            continue;
+        }
+
+        /* ここから次の待ち/終端までは ISR が連続で書く */
+        (void)ulTaskNotifyTake(pdTRUE, 0);
+        job->idx = idx;
+        job->failed = false;
+        job->reset = false;
+        job->active = true;
+        if (!sccb_job_start_write(job))
+        {
+            job->active = false;
+            job->failed = true;
+        }
+        else if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(SCCB_CHAIN_TIMEOUT_MS)) == 0U)
+        {
+            job->active = false;
+            (void)R_IIC_MASTER_Abort(&g_i2c_master1_ctrl);
+            job->failed = true;
+        }
+        if (job->failed)
+        {
+            xprintf("[SCCB] write fail at #%d (reg=0x%04X)\n", (int)job->idx, (unsigned)sccb_tbl_reg(&tbl[job->idx]));
+            return -1;
+        }
+        if (job->reset)
+        {
+            job->reset = false;
+            memset(s_shadow, 0, sizeof(s_shadow));
+        }
+        idx = job->idx;
+    }
+    return (int32_t)job->written;
+}
+
+void sccb_init(camera_dev_t cam)
+{
     if (cam == DEV_NONE)
         return;
 
-    const cam_reg_value_t *reg_tbl;
-    uint32_t cam_addr = 0x00;
+    const cam_reg_value_t *reg_tbl = NULL;
     fsp_err_t err;
 
     switch (cam)
@@ -927,11 +1131,15 @@ void sccb_init(camera_dev_t cam)
         break;
     case DEV_OV5642:
         reg_tbl = ov5642_init_reg_tbl;
-        cam_addr = (0x78 >> 1U); // OV5642
+        s_cam_addr = (0x78 >> 1U); // OV5642
+        s_reset_reg = 0x3008U;     // SYSTEM CTROL0 bit7: software reset
+        s_reset_mask = 0x80U;
         break;
     case DEV_OV3640:
         reg_tbl = ov3640_init_reg_tbl;
-        cam_addr = (0x78 >> 1U); // OV3640
+        s_cam_addr = (0x78 >> 1U); // OV3640
+        s_reset_reg = 0x3012U;     // bit7: software reset
+        s_reset_mask = 0x80U;
         break;
     default:
         // return;
@@ -944,21 +1152,15 @@ void sccb_init(camera_dev_t cam)
 
     assert(FSP_SUCCESS == err);
 
-    uint16_t i = 0;
-    while (1)
+    memset(s_shadow, 0, sizeof(s_shadow));
+
+    const TickType_t t0 = xTaskGetTickCount();
+    const int32_t n = sccb_write_table(reg_tbl, false);
+    if (n < 0)
     {
-        sccb_dat[0] = reg_tbl[i].reg_high;
-        sccb_dat[1] = reg_tbl[i].reg_low;
-        sccb_dat[2] = reg_tbl[i].val;
-        if (reg_tbl[i].reg_high == 0xFF &&
-            reg_tbl[i].reg_low == 0xFF &&
-            reg_tbl[i].val == 0xFF)
-        {
-            // 終了マーカーに達したら抜ける
-            xprintf("[Camera] Init End.\n");
-            break;
-        }
-        reg_write(cam_addr, sccb_dat, 3);
-        i++;
+        vTaskSuspend(NULL);
     }
+    // 終了マーカーに達したら抜ける
+    xprintf("[Camera] Init End. %d regs %dms\n", (int)n,
+            (int)((uint32_t)(xTaskGetTickCount() - t0) * portTICK_PERIOD_MS));
 }
@@ -11,6 +11,37 @@ typedef struct
     uint8_t val;      // 書き込みたい値
 } cam_reg_value_t;
 
+/*
+ * レジスタ表の特殊エントリ
+ *   {0xFF, 0xFF, 0xFF} : 終端
+ *   {0xFE, 0xFE, ms}   : ここで ms だけ待つ(ソフトリセット直後など，必要な所だけ)
+ */
+#define SCCB_TBL_END {0xFF, 0xFF, 0xFF}
+#define SCCB_TBL_DELAY_MS(ms) {0xFE, 0xFE, (uint8_t)(ms)}
+
+/* 1 チェーン(待ち/終端までの連続書き込み)の完了待ちタイムアウト */
+#ifndef SCCB_CHAIN_TIMEOUT_MS
+#define SCCB_CHAIN_TIMEOUT_MS (2000U)
+#endif
+
+/* 書き込んだ値を覚えておくレジスタ数(power of two)．差分書き込みに使う． */
+#ifndef SCCB_SHADOW_SLOTS
+#define SCCB_SHADOW_SLOTS (1024U)
+#endif
+
+#if (SCCB_SHADOW_SLOTS & (SCCB_SHADOW_SLOTS - 1U))
+#error SCCB_SHADOW_SLOTS must be power-of-two.
+#endif
+
+/* 控えの探索回数の上限(IIC 割り込み内の処理時間を抑える)．溢れたレジスタは毎回書く． */
+#ifndef SCCB_SHADOW_PROBE_MAX
+#define SCCB_SHADOW_PROBE_MAX (16U)
+#endif
+
+#if (SCCB_SHADOW_PROBE_MAX == 0U) || (SCCB_SHADOW_PROBE_MAX > SCCB_SHADOW_SLOTS)
+#error SCCB_SHADOW_PROBE_MAX must be 1..SCCB_SHADOW_SLOTS.
+#endif
+
 typedef enum
 {
     DEV_NONE = 0,
@@ -21,6 +52,15 @@ typedef enum
 // init
 void sccb_init(camera_dev_t cam);
 
+/*
+ * レジスタ表を書き込む(sccb_init 後)．
+ * 1 レジスタごとの完了は IIC コールバックが受けて次の書き込みを即座に開始し，
+ * タスクは待ちエントリ/終端でだけ起こされる．
+ * diff_only=true なら，前回書いた値と同じレジスタは飛ばす(モード切替用)．
+ * 戻り値: 実際に書いたレジスタ数．失敗で -1．
+ */
+int32_t sccb_write_table(const cam_reg_value_t *tbl, bool diff_only);
+
 // init CLK of camera (init before init SCCB)
 void cam_clk_init(void);
 // I2C write
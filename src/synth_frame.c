@@ -0,0 +1,323 @@
+#include "synth_frame.h"
+
+#include <string.h>
+#include <math.h>
+
+#include "video_frame_buffer.h"
+
+#if SYNTH_UPLOAD_ENABLE && ((SYNTH_UPLOAD_HYPERRAM_OFFSET + SYNTH_UPLOAD_MAX_BYTES) > VIDEO_FRAME_BASE_OFFSET_DEFAULT)
+#error "SYNTH_UPLOAD_HYPERRAM_OFFSET overlaps the video frame region"
+#endif
+
+static volatile synth_pattern_t s_pattern = SYNTH_PATTERN_DEFAULT;
+
+static const char *const s_pattern_names[SYNTH_PATTERN_COUNT] = {
+    "gradient",
+    "sphere",
+    "checker",
+    "upload",
+};
+
+#if SYNTH_UPLOAD_ENABLE
+/*
+ * アップロード画像(行優先 Y8)は HyperRAM の SYNTH_UPLOAD_HYPERRAM_OFFSET に置き，描画時に1行ずつ読む
+ * (SRAM に1枚持つと 80KB)．受信中の再アップロードはティアリングを許容する．
+ */
+static uint8_t s_upload_row[SYNTH_UPLOAD_MAX_W];
+static volatile uint16_t s_upload_w = 0U;
+static volatile uint16_t s_upload_h = 0U;
+static volatile bool s_upload_ready = false;
+#endif
+
+void synth_frame_set_pattern(synth_pattern_t pattern)
+{
+    if ((uint32_t)pattern < (uint32_t)SYNTH_PATTERN_COUNT)
+    {
+        s_pattern = pattern;
+    }
+}
+
+synth_pattern_t synth_frame_get_pattern(void)
+{
+    return s_pattern;
+}
+
+synth_pattern_t synth_pattern_from_name(const char *name)
+{
+    for (uint32_t i = 0U; i < (uint32_t)SYNTH_PATTERN_COUNT; i++)
+    {
+        const char *a = s_pattern_names[i];
+        const char *b = name;
+        while ((*a != '\0') && (*a == (char)(((*b >= 'A') && (*b <= 'Z')) ? (*b + ('a' - 'A')) : *b)))
+        {
+            a++;
+            b++;
+        }
+        if ((*a == '\0') && ((*b == '\0') || (*b == ' ') || (*b == '\r') || (*b == '\n')))
+        {
+            return (synth_pattern_t)i;
+        }
+    }
+    return SYNTH_PATTERN_COUNT;
+}
+
+const char *synth_pattern_name(synth_pattern_t pattern)
+{
+    return ((uint32_t)pattern < (uint32_t)SYNTH_PATTERN_COUNT) ? s_pattern_names[pattern] : "?";
+}
+
+static inline uint8_t synth_clamp_u8(float v)
+{
+    if (v <= 0.0f)
+    {
+        return 0U;
+    }
+    if (v >= 255.0f)
+    {
+        return 255U;
+    }
+    return (uint8_t)(v + 0.5f);
+}
+
+/* 球の中心と半径(px) */
+static void synth_sphere_geometry(uint32_t w, uint32_t h, float *cx, float *cy, float *r)
+{
+    const uint32_t s = (w < h) ? w : h;
+    *cx = 0.5f * (float)w;
+    *cy = 0.5f * (float)h;
+    *r = (float)s * (float)SYNTH_SPHERE_RADIUS_PCT / 100.0f;
+    if (*r < 1.0f)
+    {
+        *r = 1.0f;
+    }
+}
+
+static void synth_row_sphere(uint8_t *line, uint32_t y, uint32_t w, uint32_t h)
+{
+    float cx, cy, r;
+    synth_sphere_geometry(w, h, &cx, &cy, &r);
+
+    float lx = SYNTH_LIGHT_X;
+    float ly = SYNTH_LIGHT_Y;
+    float lz = SYNTH_LIGHT_Z;
+    const float lm = sqrtf(lx * lx + ly * ly + lz * lz);
+    if (lm > 0.0f)
+    {
+        lx /= lm;
+        ly /= lm;
+        lz /= lm;
+    }
+    else
+    {
+        lx = 0.0f;
+        ly = 0.0f;
+        lz = 1.0f;
+    }
+
+    const float inv_r = 1.0f / r;
+    const float ny = ((float)y + 0.5f - cy) * inv_r;
+    for (uint32_t x = 0U; x < w; x++)
+    {
+        const float nx = ((float)x + 0.5f - cx) * inv_r;
+        const float d2 = nx * nx + ny * ny;
+        if (d2 >= 1.0f)
+        {
+            line[x] = (uint8_t)SYNTH_BACKGROUND;
+            continue;
+        }
+        /* Lambert: I = albedo * max(0, n.l) */
+        const float nz = sqrtf(1.0f - d2);
+        const float shade = nx * lx + ny * ly + nz * lz;
+        line[x] = synth_clamp_u8((shade > 0.0f) ? ((float)SYNTH_SPHERE_ALBEDO * shade) : 0.0f);
+    }
+}
+
+static void synth_row_upload(uint8_t *line, uint32_t y, uint32_t w, uint32_t h)
+{
+#if SYNTH_UPLOAD_ENABLE
+    const uint32_t uw = (uint32_t)s_upload_w;
+    const uint32_t uh = (uint32_t)s_upload_h;
+    if (s_upload_ready && (uw != 0U) && (uh != 0U))
+    {
+        /* 最近傍で出力サイズへ合わせる */
+        const uint32_t src_off = (uint32_t)SYNTH_UPLOAD_HYPERRAM_OFFSET + ((y * uh) / h) * uw;
+        uint8_t *src = (uw == w) ? line : s_upload_row;
+        if (FSP_SUCCESS == hyperram_b_read(src, (void *)(uintptr_t)src_off, uw))
+        {
+            if (uw != w)
+            {
+                for (uint32_t x = 0U; x < w; x++)
+                {
+                    line[x] = src[(x * uw) / w];
+                }
+            }
+            return;
+        }
+    }
+#else
+    (void)y;
+    (void)h;
+#endif
+    /* まだ1枚も届いていない */
+    memset(line, (int)SYNTH_BACKGROUND, w);
+}
+
+static void synth_render_row(uint8_t *line, uint32_t y, uint32_t w, uint32_t h, uint32_t frame_index,
+                             synth_pattern_t pattern)
+{
+    switch (pattern)
+    {
+    case SYNTH_PATTERN_GRADIENT:
+        /* 0..255 の横ランプ，1px/frame で右から左へ流れる */
+        for (uint32_t x = 0U; x < w; x++)
+        {
+            line[x] = (uint8_t)((((x + frame_index) % w) * 256U) / w);
+        }
+        break;
+    case SYNTH_PATTERN_CHECKER:
+    {
+        const uint32_t cy = y / (uint32_t)SYNTH_CHECKER_CELL;
+        for (uint32_t x = 0U; x < w; x++)
+        {
+            const uint32_t cx = (x + frame_index) / (uint32_t)SYNTH_CHECKER_CELL;
+            line[x] = (((cx + cy) & 1U) != 0U) ? 200U : 56U;
+        }
+        break;
+    }
+    case SYNTH_PATTERN_UPLOAD:
+        synth_row_upload(line, y, w, h);
+        break;
+    case SYNTH_PATTERN_SPHERE:
+    default:
+        synth_row_sphere(line, y, w, h);
+        break;
+    }
+}
+
+void synth_frame_render_y(uint8_t *y, uint32_t w, uint32_t h, uint32_t frame_index)
+{
+    const synth_pattern_t pattern = s_pattern;
+    for (uint32_t r = 0U; r < h; r++)
+    {
+        synth_render_row(&y[r * w], r, w, h, frame_index, pattern);
+    }
+}
+
+void synth_frame_render(uint8_t *p_uyvy, uint32_t w, uint32_t h, uint32_t frame_index)
+{
+    const synth_pattern_t pattern = s_pattern;
+    for (uint32_t r = 0U; r < h; r++)
+    {
+        uint8_t *row = &p_uyvy[r * w * 2U];
+
+        /*
+         * 行の後半へ Y を生成してから左詰めで展開する(作業バッファ不要)．
+         * 4画素組 x の書き込み [2x, 2x+8) は，まだ読んでいない Y[x+4..] (= row[w+x+4..]) に届かない．
+         */
+        uint8_t *line = &row[w];
+        synth_render_row(line, r, w, h, frame_index, pattern);
+        for (uint32_t x = 0U; (x + 3U) < w; x += 4U)
+        {
+            const uint8_t y0 = line[x + 0U];
+            const uint8_t y1 = line[x + 1U];
+            const uint8_t y2 = line[x + 2U];
+            const uint8_t y3 = line[x + 3U];
+            uint8_t *p = &row[x * 2U];
+            p[0] = 128U;
+            p[1] = y3;
+            p[2] = 128U;
+            p[3] = y2;
+            p[4] = 128U;
+            p[5] = y1;
+            p[6] = 128U;
+            p[7] = y0;
+        }
+    }
+}
+
+bool synth_frame_depth_truth(uint8_t *depth, uint32_t w, uint32_t h, uint32_t frame_index)
+{
+    (void)frame_index;
+    if (s_pattern != SYNTH_PATTERN_SPHERE)
+    {
+        return false;
+    }
+
+    float cx, cy, r;
+    synth_sphere_geometry(w, h, &cx, &cy, &r);
+    const float inv_r = 1.0f / r;
+    for (uint32_t y = 0U; y < h; y++)
+    {
+        const float ny = ((float)y + 0.5f - cy) * inv_r;
+        for (uint32_t x = 0U; x < w; x++)
+        {
+            const float nx = ((float)x + 0.5f - cx) * inv_r;
+            const float d2 = nx * nx + ny * ny;
+            depth[y * w + x] = (d2 < 1.0f) ? synth_clamp_u8(255.0f * sqrtf(1.0f - d2)) : 0U;
+        }
+    }
+    return true;
+}
+
+static inline uint32_t synth_rd_u16(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8);
+}
+
+static inline uint32_t synth_rd_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+int synth_frame_upload(const uint8_t *data, uint32_t len)
+{
+#if SYNTH_UPLOAD_ENABLE
+    if (!data || (len < SYNTH_UPLOAD_HEADER_BYTES) || (synth_rd_u32(data) != SYNTH_UPLOAD_MAGIC))
+    {
+        return -1;
+    }
+
+    const uint32_t w = synth_rd_u16(&data[4]);
+    const uint32_t h = synth_rd_u16(&data[6]);
+    const uint32_t offset = synth_rd_u32(&data[8]);
+    const uint32_t n = len - SYNTH_UPLOAD_HEADER_BYTES;
+    const uint32_t total = w * h;
+    if ((w == 0U) || (h == 0U) || (w > (uint32_t)SYNTH_UPLOAD_MAX_W) || (total > (uint32_t)SYNTH_UPLOAD_MAX_BYTES) ||
+        (offset > total) || (n > (total - offset)))
+    {
+        return -1;
+    }
+
+    if (offset == 0U)
+    {
+        /* 新しい1枚の先頭．サイズが変わるなら完成までは表示しない */
+        if ((w != (uint32_t)s_upload_w) || (h != (uint32_t)s_upload_h))
+        {
+            s_upload_ready = false;
+            s_upload_w = (uint16_t)w;
+            s_upload_h = (uint16_t)h;
+        }
+    }
+    else if ((w != (uint32_t)s_upload_w) || (h != (uint32_t)s_upload_h))
+    {
+        return -1; // 先頭を取りこぼした別サイズの画像
+    }
+
+    if (FSP_SUCCESS != hyperram_b_write_timed(&data[SYNTH_UPLOAD_HEADER_BYTES],
+                                              (void *)(uintptr_t)((uint32_t)SYNTH_UPLOAD_HYPERRAM_OFFSET + offset), n,
+                                              pdMS_TO_TICKS(SYNTH_UPLOAD_WRITE_WAIT_MS)))
+    {
+        return -1;
+    }
+    if ((offset + n) == total)
+    {
+        s_upload_ready = true;
+        return 1;
+    }
+    return 0;
+#else
+    (void)data;
+    (void)len;
+    return -1;
+#endif
+}
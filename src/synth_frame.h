@@ -0,0 +1,141 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Synthetic frame source (camera replacement for pipeline load tests).
+ *
+ * - CAM_SYNTH_ENABLE=1 にすると Thread0 は OV5642 を初期化せず，ここで生成したフレームを
+ *   実カメラと同じ経路(cam_store_frame_hyperram → g_video_frame_seq 公開)で流す．
+ *   Thread3(PQ128/depth/HLAC) と Thread1(UDP) は変更なしでそのまま動く．
+ * - パターン: グラデーション(横スクロール)，Lambert 球(既知の深度)，市松(1px/frame で移動)，
+ *   UDP でアップロードした Y8 画像(録画したシーンの再生など)．
+ * - 深度の正解は synth_frame_depth_truth() で同じ座標系のまま取れる(精度評価用)．
+ *   ホストでの照合は script/depth_bench.sh(synth_sphere 行)．
+ * - アップロード画像は SRAM ではなく HyperRAM に置く(hyperram_b_read/write．ホストは bench/host のシム)．
+ */
+
+#ifndef CAM_SYNTH_ENABLE
+#define CAM_SYNTH_ENABLE (0)
+#endif
+
+/* フレーム周期(ms)．0: 生成と書き出しが終わったら即次(1 tick だけ譲る) */
+#ifndef SYNTH_FRAME_INTERVAL_MS
+#define SYNTH_FRAME_INTERVAL_MS (33)
+#endif
+
+/* 生成するフレームサイズ(VIDEO_FRAME_MAX_W/H 以下) */
+#ifndef SYNTH_FRAME_W
+#define SYNTH_FRAME_W (320U)
+#endif
+
+#ifndef SYNTH_FRAME_H
+#define SYNTH_FRAME_H (240U)
+#endif
+
+/* 起動時のパターン(synth_pattern_t) */
+#ifndef SYNTH_PATTERN_DEFAULT
+#define SYNTH_PATTERN_DEFAULT (SYNTH_PATTERN_SPHERE)
+#endif
+
+/* 球の半径(短辺に対する%)，反射率，背景輝度 */
+#ifndef SYNTH_SPHERE_RADIUS_PCT
+#define SYNTH_SPHERE_RADIUS_PCT (40U)
+#endif
+
+#ifndef SYNTH_SPHERE_ALBEDO
+#define SYNTH_SPHERE_ALBEDO (220.0f)
+#endif
+
+#ifndef SYNTH_BACKGROUND
+#define SYNTH_BACKGROUND (40U)
+#endif
+
+/* 光源方向(正規化前)．既定は Thread3 の初期値と同じ正面光 */
+#ifndef SYNTH_LIGHT_X
+#define SYNTH_LIGHT_X (0.0f)
+#endif
+
+#ifndef SYNTH_LIGHT_Y
+#define SYNTH_LIGHT_Y (0.0f)
+#endif
+
+#ifndef SYNTH_LIGHT_Z
+#define SYNTH_LIGHT_Z (1.0f)
+#endif
+
+/* 市松の1マス(px) */
+#ifndef SYNTH_CHECKER_CELL
+#define SYNTH_CHECKER_CELL (32U)
+#endif
+
+/* UDP アップロード受け付け(0 で無効) */
+#ifndef SYNTH_UPLOAD_ENABLE
+#define SYNTH_UPLOAD_ENABLE (1)
+#endif
+
+/* アップロード画像の最大画素数(w*h)と最大幅(描画時の1行バッファ) */
+#ifndef SYNTH_UPLOAD_MAX_BYTES
+#define SYNTH_UPLOAD_MAX_BYTES (320U * 256U)
+#endif
+
+#ifndef SYNTH_UPLOAD_MAX_W
+#define SYNTH_UPLOAD_MAX_W (320U)
+#endif
+
+/* アップロード画像の置き場所(HyperRAM オフセット)．既定はフレーム領域の直前 */
+#ifndef SYNTH_UPLOAD_HYPERRAM_OFFSET
+#define SYNTH_UPLOAD_HYPERRAM_OFFSET (VIDEO_FRAME_BASE_OFFSET_DEFAULT - SYNTH_UPLOAD_MAX_BYTES)
+#endif
+
+/* UDP 受信側(tcpip スレッド)が HyperRAM のミューテックスを待つ上限(ms)．取れなければそのチャンクは捨てる */
+#ifndef SYNTH_UPLOAD_WRITE_WAIT_MS
+#define SYNTH_UPLOAD_WRITE_WAIT_MS (10U)
+#endif
+
+/*
+ * アップロードパケット(little-endian):
+ *   "SYNF" | u16 width | u16 height | u32 offset | Y8 payload ...
+ * offset は行優先 Y8 画像内のバイト位置．offset+len == width*height で1枚完成．
+ */
+#define SYNTH_UPLOAD_MAGIC (0x464E5953U) /* "SYNF" */
+#define SYNTH_UPLOAD_HEADER_BYTES (12U)
+
+typedef enum
+{
+    SYNTH_PATTERN_GRADIENT = 0,
+    SYNTH_PATTERN_SPHERE,
+    SYNTH_PATTERN_CHECKER,
+    SYNTH_PATTERN_UPLOAD,
+    SYNTH_PATTERN_COUNT
+} synth_pattern_t;
+
+/* 次のフレームから切り替わる(UDP コールバックから呼んでよい) */
+void synth_frame_set_pattern(synth_pattern_t pattern);
+synth_pattern_t synth_frame_get_pattern(void);
+
+/* "gradient" / "sphere" / "checker" / "upload" -> pattern．不明なら SYNTH_PATTERN_COUNT */
+synth_pattern_t synth_pattern_from_name(const char *name);
+const char *synth_pattern_name(synth_pattern_t pattern);
+
+/* 現在のパターンで1フレーム分の輝度を行優先 Y8(w*h)で生成する */
+void synth_frame_render_y(uint8_t *y, uint32_t w, uint32_t h, uint32_t frame_index);
+
+/*
+ * 同じフレームをカメラ取り込みバッファと同じ並び(CEU の UYVY，4画素ごとに逆順)で生成する．
+ * cam_store_frame_hyperram() にそのまま渡せる．w は4の倍数．色差は 128(無彩色)．
+ */
+void synth_frame_render(uint8_t *p_uyvy, uint32_t w, uint32_t h, uint32_t frame_index);
+
+/*
+ * 現在のパターンの深度の正解(8bit，大きいほど手前)を w*h で書く．
+ * 球: 255*z/R(背景 0)．それ以外のパターンは正解が無いので何も書かず false．
+ */
+bool synth_frame_depth_truth(uint8_t *depth, uint32_t w, uint32_t h, uint32_t frame_index);
+
+/*
+ * アップロードパケット1個(ヘッダ込み)を取り込む(HyperRAM へ書くのでタスク文脈から呼ぶ)．
+ * 戻り値: 1 = 1枚完成(以後 SYNTH_PATTERN_UPLOAD で使われる)，0 = 受理，-1 = 不正/書き込み失敗．
+ */
+int synth_frame_upload(const uint8_t *data, uint32_t len);
@@ -29,6 +29,144 @@
 #error VIDEO_FRAME_BASE_OFFSET_ALIGN must be power-of-two.
 #endif
 
+/*
+ * HyperRAM 上のフレーム格納形式．
+ * Thread0 が SRAM 上で1回だけ変換してから書き出す(読み手は行ごとの分解が不要)．
+ * - UYVY     : 従来．UYVY 2B/px をそのまま．
+ * - Y8       : Y 平面 1B/px(SWAP_Y + 4px並べ替え済み = Thread1/3 の Y と同じ並び)．
+ *              VIDEO_FRAME_STORE_CHROMA=1 でクロマ強度 |U-128|+|V-128| を水平1/2で追加．
+ * - Y8_DECIM : Y8 を VIDEO_FRAME_DECIM_X/Y で間引いた平面(PQ128 の格子だけを保持)．
+ * どの形式でもフレーム領域のサイズ(2B/px)は変えないので，後ろの p/q・深度オフセットは不変．
+ */
+#define VIDEO_FRAME_FMT_UYVY (0)
+#define VIDEO_FRAME_FMT_Y8 (1)
+#define VIDEO_FRAME_FMT_Y8_DECIM (2)
+
+#ifndef VIDEO_FRAME_FORMAT
+#define VIDEO_FRAME_FORMAT (VIDEO_FRAME_FMT_UYVY)
+#endif
+
+#ifndef VIDEO_FRAME_STORE_CHROMA
+#define VIDEO_FRAME_STORE_CHROMA (0)
+#endif
+
+/* 間引き間隔(PQ128_SAMPLE_STRIDE_X/Y と一致させる) */
+#ifndef VIDEO_FRAME_DECIM_X
+#define VIDEO_FRAME_DECIM_X (2)
+#endif
+
+#ifndef VIDEO_FRAME_DECIM_Y
+#define VIDEO_FRAME_DECIM_Y (2)
+#endif
+
+/*
+ * 取り込みサイズの上限(HyperRAM スロットの容量．SRAM の取り込みバッファは VIDEO_FRAME_MAX_PIXELS)．
+ * 実際のサイズは取り込みモードごとに変わるので，フレームと一緒に公開する
+ * video_frame_desc_t から取ること．
+ */
+#ifndef VIDEO_FRAME_MAX_W
+#define VIDEO_FRAME_MAX_W (320U)
+#endif
+
+#ifndef VIDEO_FRAME_MAX_H
+#define VIDEO_FRAME_MAX_H (256U)
+#endif
+
+/*
+ * 1フレームの画素数の上限(全モードの width*height の最大: QVGA/CENTER 320x240 > WIN256 256x256)．
+ * SRAM の取り込みバッファはこれで確保する．MAX_W * MAX_H で取ると 10KB 余分になり，
+ * ピンポンでは2面分効く(RAM は 512KB しかない)．
+ */
+#ifndef VIDEO_FRAME_MAX_PIXELS
+#define VIDEO_FRAME_MAX_PIXELS (320U * 240U)
+#endif
+
+/* HyperRAM 上のフレーム基準の配置(スロットは最大サイズで固定，モードが変わっても動かない) */
+#define VIDEO_FRAME_SLOT_BYTES (VIDEO_FRAME_MAX_W * VIDEO_FRAME_MAX_H * 2U)
+#define VIDEO_FRAME_GRADIENT_OFFSET (VIDEO_FRAME_SLOT_BYTES)     // Thread3: p/q 平面
+#define VIDEO_FRAME_DEPTH_OFFSET (VIDEO_FRAME_SLOT_BYTES * 2U)   // Thread3: 8bit 深度/デバッグ画像
+#define VIDEO_FRAME_Y_OFFSET (0U)
+
+#if (VIDEO_FRAME_MAX_W % 16U) != 0U
+#error VIDEO_FRAME_MAX_W must be a multiple of 16.
+#endif
+
+#if (VIDEO_FRAME_FORMAT != VIDEO_FRAME_FMT_UYVY) && (VIDEO_FRAME_FORMAT != VIDEO_FRAME_FMT_Y8) && \
+    (VIDEO_FRAME_FORMAT != VIDEO_FRAME_FMT_Y8_DECIM)
+#error Unknown VIDEO_FRAME_FORMAT
+#endif
+
+#if (VIDEO_FRAME_FORMAT == VIDEO_FRAME_FMT_Y8_DECIM) && VIDEO_FRAME_STORE_CHROMA
+#error VIDEO_FRAME_STORE_CHROMA is only supported with VIDEO_FRAME_FMT_Y8.
+#endif
+
+/*
+ * フレームディスクリプタ．Thread0 が各フレームと一緒に公開し，
+ * 後段(PQ128/HLAC/FC/UDP)は固定マクロではなくこれを見る．
+ */
+typedef struct
+{
+    uint16_t width;  // 画素
+    uint16_t height; // 行
+    uint32_t stride; // HyperRAM 上の主平面 1 行のバイト数(UYVY=2*width, Y8=width, Y8_DECIM=width/DECIM_X)
+    uint8_t format;  // VIDEO_FRAME_FMT_*
+    uint8_t mode;    // 取り込みモード(cam_mode_t)
+    uint16_t reserved;
+} video_frame_desc_t;
+
+static inline video_frame_desc_t video_frame_desc_make(uint32_t width, uint32_t height, uint32_t mode)
+{
+    video_frame_desc_t d;
+    d.width = (uint16_t)width;
+    d.height = (uint16_t)height;
+#if (VIDEO_FRAME_FORMAT == VIDEO_FRAME_FMT_UYVY)
+    d.stride = width * 2U;
+#elif (VIDEO_FRAME_FORMAT == VIDEO_FRAME_FMT_Y8)
+    d.stride = width;
+#else
+    d.stride = width / (uint32_t)VIDEO_FRAME_DECIM_X;
+#endif
+    d.format = (uint8_t)VIDEO_FRAME_FORMAT;
+    d.mode = (uint8_t)mode;
+    d.reserved = 0U;
+    return d;
+}
+
+/* クロマ強度平面(Y8 + VIDEO_FRAME_STORE_CHROMA): 水平1/2，Y 平面の直後 */
+static inline uint32_t video_frame_c_width(const video_frame_desc_t *d)
+{
+    return (uint32_t)d->width / 2U;
+}
+
+static inline uint32_t video_frame_c_offset(const video_frame_desc_t *d)
+{
+    return VIDEO_FRAME_Y_OFFSET + (uint32_t)d->width * (uint32_t)d->height;
+}
+
+/* 間引き平面(Y8_DECIM) */
+static inline uint32_t video_frame_decim_w(const video_frame_desc_t *d)
+{
+    return (uint32_t)d->width / (uint32_t)VIDEO_FRAME_DECIM_X;
+}
+
+static inline uint32_t video_frame_decim_h(const video_frame_desc_t *d)
+{
+    return (uint32_t)d->height / (uint32_t)VIDEO_FRAME_DECIM_Y;
+}
+
+/* フレームが HyperRAM 上で占めるバイト数(<= VIDEO_FRAME_SLOT_BYTES) */
+static inline uint32_t video_frame_stored_bytes(const video_frame_desc_t *d)
+{
+#if (VIDEO_FRAME_FORMAT == VIDEO_FRAME_FMT_UYVY)
+    return (uint32_t)d->width * (uint32_t)d->height * 2U;
+#elif (VIDEO_FRAME_FORMAT == VIDEO_FRAME_FMT_Y8)
+    return (uint32_t)d->width * (uint32_t)d->height +
+           (VIDEO_FRAME_STORE_CHROMA ? (video_frame_c_width(d) * (uint32_t)d->height) : 0U);
+#else
+    return video_frame_decim_w(d) * video_frame_decim_h(d);
+#endif
+}
+
 extern volatile uint32_t g_video_frame_base_offset;
 
 /* Monotonic sequence for the most recently written frame.
@@ -37,6 +175,14 @@ extern volatile uint32_t g_video_frame_base_offset;
  */
 extern volatile uint32_t g_video_frame_seq;
 
+/* Descriptor of the frame published with g_video_frame_seq (written before the seq). */
+extern volatile video_frame_desc_t g_video_frame_desc;
+
+/* Seqlock over (desc, base, seq): odd while Thread0 is publishing, even otherwise.
+ * Read the three together with video_frame_snapshot().
+ */
+extern volatile uint32_t g_video_frame_pub_gen;
+
 /* PQ128 debug outputs generated by Thread3 (optional).
  * When g_pq128_seq == g_video_frame_seq used for computation, the p/q planes are ready.
  */
@@ -51,11 +197,41 @@ extern volatile uint32_t g_pq128_base_offset;
 extern volatile uint32_t g_depth_seq;
 extern volatile uint32_t g_depth_base_offset;
 /* Total byte size of the published depth/output buffer.
- * - Typical depth: 320*240 (76800)
+ * - Typical depth: width*height of the source frame (QVGA: 76800)
  * - HLAC |P|+|Q| ROI (example): 256*128 (32768)
  */
 extern volatile uint32_t g_depth_size_bytes;
 
+/* Demand flag for the depth/debug image (HLAC fused mode).
+ * The depth streamer sets it to 1 when it starts a new frame; Thread3 clears it after publishing.
+ * While 0, Thread3 may skip the HyperRAM export and only run inference.
+ */
+extern volatile uint32_t g_depth_export_request;
+
+/*
+ * 公開中フレームの (seq, base, desc) をまとめて取る．
+ * 公開中(g_video_frame_pub_gen が奇数)か，読んでいる間に公開があったら取り直す
+ * (モード切替をまたいだ desc と base の組み合わせを避ける)．
+ */
+static inline uint32_t video_frame_snapshot(uint32_t *base, video_frame_desc_t *desc)
+{
+    uint32_t gen;
+    uint32_t seq;
+    do
+    {
+        gen = g_video_frame_pub_gen;
+        seq = g_video_frame_seq;
+        *base = g_video_frame_base_offset;
+        desc->width = g_video_frame_desc.width;
+        desc->height = g_video_frame_desc.height;
+        desc->stride = g_video_frame_desc.stride;
+        desc->format = g_video_frame_desc.format;
+        desc->mode = g_video_frame_desc.mode;
+        desc->reserved = 0U;
+    } while (((gen & 1U) != 0U) || (gen != g_video_frame_pub_gen));
+    return seq;
+}
+
 static inline uint32_t video_frame_align_u32(uint32_t x)
 {
     return x & ~(VIDEO_FRAME_BASE_OFFSET_ALIGN - 1U);